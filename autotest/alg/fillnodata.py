@@ -0,0 +1,213 @@
+#!/usr/bin/env python
+###############################################################################
+# $Id$
+#
+# Project:  GDAL/OGR Test Suite
+# Purpose:  Test FillNodata() algorithm.
+# Author:   agent <agent at local>
+#
+###############################################################################
+# Copyright (c) 2026, agent <agent at local>
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+###############################################################################
+
+import struct
+import sys
+
+sys.path.append('../pymod')
+
+import gdaltest
+
+from osgeo import gdal
+
+###############################################################################
+# Create a 1024x600 raster with zero valued holes, and its validity mask.
+# The raster is processed in strips of 256 lines, and the holes cross the
+# strip boundaries, so that the state of the column passes is carried from
+# one strip to the next one.
+
+
+def fillnodata_create_datasets():
+
+    xsize = 1024
+    ysize = 600
+    src_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1,
+                                                gdal.GDT_Float32)
+    mask_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize)
+    values = []
+    mask = []
+    for y in range(ysize):
+        for x in range(xsize):
+            if (x - 300) ** 2 + (y - 256) ** 2 < 60 ** 2 or \
+               (x >= 700 and x < 710 and y >= 100 and y < 560) or \
+               (x - 900) ** 2 + (y - 512) ** 2 < 30 ** 2:
+                values.append(0)
+                mask.append(0)
+            else:
+                values.append(100 + x // 8 + y // 4 + (x * 7 + y * 13) % 11)
+                mask.append(255)
+    src_ds.GetRasterBand(1).WriteRaster(
+        0, 0, xsize, ysize, struct.pack('f' * (xsize * ysize), *values))
+    mask_ds.GetRasterBand(1).WriteRaster(
+        0, 0, xsize, ysize, struct.pack('B' * (xsize * ysize), *mask))
+    return (src_ds, mask_ds, values, mask)
+
+###############################################################################
+# Check that all holes are filled with values in the range of the valid
+# ones, and that valid pixels are unchanged.
+
+
+def fillnodata_check(ds, values, mask):
+
+    xsize = ds.RasterXSize
+    ysize = ds.RasterYSize
+    got = struct.unpack('f' * (xsize * ysize),
+                        ds.GetRasterBand(1).ReadRaster())
+    min_val = min([values[i] for i in range(len(values)) if mask[i]])
+    max_val = max([values[i] for i in range(len(values)) if mask[i]])
+    for i in range(xsize * ysize):
+        if mask[i]:
+            if got[i] != values[i]:
+                print(i % xsize, i // xsize, got[i], values[i])
+                return False
+        elif got[i] < min_val or got[i] > max_val:
+            print(i % xsize, i // xsize, got[i])
+            return False
+    return True
+
+###############################################################################
+# Test the default algorithm, with several threads.
+
+
+def fillnodata_1():
+
+    results = []
+    for num_threads in ['1', '4']:
+        (ds, mask_ds, values, mask) = fillnodata_create_datasets()
+        with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+            ret = gdal.FillNodata(ds.GetRasterBand(1),
+                                  mask_ds.GetRasterBand(1),
+                                  0, 0, ['TEMP_FILE_DRIVER=MEM'])
+        if ret != 0:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        if not fillnodata_check(ds, values, mask):
+            gdaltest.post_reason('fail')
+            return 'fail'
+        # Same result as the previous line by line implementation
+        cs = ds.GetRasterBand(1).Checksum()
+        if cs != 48301:
+            gdaltest.post_reason('fail')
+            print(cs)
+            return 'fail'
+        results.append(ds.GetRasterBand(1).ReadRaster())
+
+    if results[0] != results[1]:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test ALGORITHM=PYRAMID.
+
+
+def fillnodata_2():
+
+    results = []
+    for num_threads in ['1', '4']:
+        (ds, mask_ds, values, mask) = fillnodata_create_datasets()
+        with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+            ret = gdal.FillNodata(ds.GetRasterBand(1),
+                                  mask_ds.GetRasterBand(1),
+                                  0, 0, ['ALGORITHM=PYRAMID',
+                                         'TEMP_FILE_DRIVER=MEM'])
+        if ret != 0:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        if not fillnodata_check(ds, values, mask):
+            gdaltest.post_reason('fail')
+            return 'fail'
+        results.append(ds.GetRasterBand(1).ReadRaster())
+
+    if results[0] != results[1]:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # A small maximum search distance leaves the center of the hole unfilled
+    (ds, mask_ds, values, mask) = fillnodata_create_datasets()
+    gdal.FillNodata(ds.GetRasterBand(1), mask_ds.GetRasterBand(1),
+                    2, 0, ['ALGORITHM=PYRAMID'])
+    (val,) = struct.unpack('f', ds.GetRasterBand(1).ReadRaster(300, 256, 1, 1))
+    if val != values[256 * 1024 + 300]:
+        gdaltest.post_reason('fail')
+        print(val)
+        return 'fail'
+
+    with gdaltest.error_handler():
+        ret = gdal.FillNodata(ds.GetRasterBand(1), mask_ds.GetRasterBand(1),
+                              0, 0, ['ALGORITHM=INVALID'])
+    if ret == 0:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that a valid value of 65535 does not stop the search for a closer
+# pixel in the same quadrant.
+
+
+def fillnodata_3():
+
+    ds = gdal.GetDriverByName('MEM').Create('', 21, 21, 1, gdal.GDT_Float32)
+    mask_ds = gdal.GetDriverByName('MEM').Create('', 21, 21)
+    ds.GetRasterBand(1).WriteRaster(10, 2, 1, 1, struct.pack('f', 65535))
+    mask_ds.GetRasterBand(1).WriteRaster(10, 2, 1, 1, struct.pack('B', 255))
+    ds.GetRasterBand(1).WriteRaster(9, 9, 1, 1, struct.pack('f', 100))
+    mask_ds.GetRasterBand(1).WriteRaster(9, 9, 1, 1, struct.pack('B', 255))
+
+    ret = gdal.FillNodata(ds.GetRasterBand(1), mask_ds.GetRasterBand(1),
+                          0, 0, ['TEMP_FILE_DRIVER=MEM'])
+    if ret != 0:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    (val,) = struct.unpack('f', ds.GetRasterBand(1).ReadRaster(10, 10, 1, 1))
+    if val != 100:
+        gdaltest.post_reason('fail')
+        print(val)
+        return 'fail'
+
+    return 'success'
+
+
+gdaltest_list = [
+    fillnodata_1,
+    fillnodata_2,
+    fillnodata_3
+]
+
+if __name__ == '__main__':
+
+    gdaltest.setup_run('fillnodata')
+
+    gdaltest.run_tests(gdaltest_list)
+
+    gdaltest.summarize()
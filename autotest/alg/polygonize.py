@@ -210,13 +210,107 @@ def polygonize_4():
 
     return 'success' if tr else 'fail'
 
+###############################################################################
+# Test a raster processed in several strips, with a polygon whose parts only
+# merge near the bottom, and a square across a strip boundary, with and
+# without worker threads.
+
+
+def polygonize_5():
+
+    # 600x1000 pixels are read as strips of 436 lines (lines 0-435, 436-871
+    # and 872-999).
+    xsize = 600
+    ysize = 1000
+    square_x = [460, 510, 560]
+    square_y = list(range(35, ysize, 50))
+    data = bytearray(xsize * ysize)
+    for y in range(ysize):
+        for x in range(xsize):
+            if y < 950 and (100 <= x < 110 or 400 <= x < 410):
+                data[y * xsize + x] = 1
+            elif 940 <= y < 950 and 100 <= x < 410:
+                data[y * xsize + x] = 1
+            elif x >= 460 and (x - 460) % 50 < 2 and (y - 35) % 50 < 2:
+                data[y * xsize + x] = 2
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize)
+    src_ds.GetRasterBand(1).WriteRaster(0, 0, xsize, ysize, bytes(data))
+    src_band = src_ds.GetRasterBand(1)
+
+    # The U shape, the background inside it, and the background outside it
+    # whose holes are the squares.
+    u_area = 2 * 10 * 950 + 290 * 10
+    inside_area = 290 * 940
+    squares_area = 4 * len(square_x) * len(square_y)
+    outside_area = xsize * ysize - u_area - inside_area - squares_area
+
+    results = []
+    for num_threads in ['1', '4']:
+        mem_ds = ogr.GetDriverByName('Memory').CreateDataSource('out')
+        mem_layer = mem_ds.CreateLayer('poly', None, ogr.wkbPolygon)
+        mem_layer.CreateField(ogr.FieldDefn('DN', ogr.OFTInteger))
+
+        with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+            result = gdal.Polygonize(src_band, None, mem_layer, 0)
+        if result != 0:
+            gdaltest.post_reason('Polygonize failed')
+            return 'fail'
+
+        expected_feature_number = 3 + len(square_x) * len(square_y)
+        if mem_layer.GetFeatureCount() != expected_feature_number:
+            gdaltest.post_reason('GetFeatureCount() returned %d instead of %d' % (mem_layer.GetFeatureCount(), expected_feature_number))
+            return 'fail'
+
+        results.append([(f.GetField('DN'), f.GetGeometryRef().ExportToWkt())
+                        for f in mem_layer])
+
+        mem_layer.SetAttributeFilter('dn = 1')
+        feat_read = mem_layer.GetNextFeature()
+        if ogrtest.check_feature_geometry(feat_read, 'POLYGON ((100 0,100 950,410 950,410 0,400 0,400 940,110 940,110 0,100 0))') != 0:
+            print(feat_read.GetGeometryRef().ExportToWkt())
+            return 'fail'
+
+        mem_layer.SetAttributeFilter('dn = 2')
+        envelopes = sorted([f.GetGeometryRef().GetEnvelope()
+                            for f in mem_layer
+                            if f.GetGeometryRef().GetArea() == 4])
+        expected_envelopes = sorted([(x, x + 2, y, y + 2)
+                                     for x in square_x for y in square_y])
+        if envelopes != expected_envelopes:
+            gdaltest.post_reason('Bad squares')
+            print(envelopes)
+            return 'fail'
+
+        mem_layer.SetAttributeFilter('dn = 0')
+        backgrounds = sorted([(f.GetGeometryRef().GetArea(),
+                               f.GetGeometryRef().GetGeometryCount(),
+                               f.GetGeometryRef().GetEnvelope())
+                              for f in mem_layer])
+        expected_backgrounds = sorted([
+            (inside_area, 1, (110, 400, 0, 940)),
+            (outside_area, 1 + len(square_x) * len(square_y),
+             (0, xsize, 0, ysize))])
+        if backgrounds != expected_backgrounds:
+            gdaltest.post_reason('Bad backgrounds')
+            print(backgrounds)
+            return 'fail'
+
+    # Features are written in the same order whatever the number of threads.
+    if results[0] != results[1]:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
 
 gdaltest_list = [
     polygonize_1,
     polygonize_1_float,
     polygonize_2,
     polygonize_3,
-    polygonize_4
+    polygonize_4,
+    polygonize_5
 ]
 
 if __name__ == '__main__':
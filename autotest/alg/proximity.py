@@ -28,6 +28,8 @@
 # DEALINGS IN THE SOFTWARE.
 ###############################################################################
 
+import math
+import struct
 import sys
 
 sys.path.append('../pymod')
@@ -137,11 +139,111 @@ def proximity_3():
         return 'fail'
     return 'success'
 
+###############################################################################
+# Test exact algorithm against brute force, with non square pixels, and on
+# several strips with outputs needing a temporary work band
+
+
+def proximity_4():
+
+    xsize = 53
+    ysize = 37
+    targets = [(3, 2), (40, 5), (20, 18), (7, 30), (50, 36), (27, 35)]
+    src_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize)
+    src_ds.SetGeoTransform([0, 2.5, 0, 0, 0, -1])
+    for (x, y) in targets:
+        src_ds.GetRasterBand(1).WriteRaster(x, y, 1, 1, struct.pack('B', 1))
+
+    for (distunits, xres, yres) in [('PIXEL', 1, 1), ('GEO', 2.5, 1)]:
+        expected = []
+        for y in range(ysize):
+            for x in range(xsize):
+                d = min([math.sqrt(((tx - x) * xres) ** 2 +
+                                   ((ty - y) * yres) ** 2)
+                         for (tx, ty) in targets])
+                expected.append(d if d <= 20 else -1)
+
+        for num_threads in ['1', '4']:
+            dst_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1,
+                                                        gdal.GDT_Float32)
+            with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+                ret = gdal.ComputeProximity(src_ds.GetRasterBand(1),
+                                            dst_ds.GetRasterBand(1),
+                                            options=['ALGORITHM=EXACT',
+                                                     'DISTUNITS=' + distunits,
+                                                     'MAXDIST=20',
+                                                     'NODATA=-1'])
+            if ret != 0:
+                gdaltest.post_reason('fail')
+                return 'fail'
+            got = struct.unpack('f' * (xsize * ysize),
+                                dst_ds.GetRasterBand(1).ReadRaster())
+            for i in range(xsize * ysize):
+                if abs(got[i] - expected[i]) > 1e-4:
+                    gdaltest.post_reason('fail')
+                    print(distunits, num_threads, i % xsize, i // xsize,
+                          got[i], expected[i])
+                    return 'fail'
+
+    # 2048x200 pixels are processed as strips of 128 lines. Byte and UInt16
+    # outputs need a temporary work band.
+    xsize = 2048
+    ysize = 200
+    targets = [(100, 20), (600, 180), (1100, 100), (1600, 10), (2000, 150),
+               (350, 130), (1350, 60), (1850, 190)]
+    src_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize)
+    for (x, y) in targets:
+        src_ds.GetRasterBand(1).WriteRaster(x, y, 1, 1, struct.pack('B', 1))
+
+    dist = []
+    for y in range(ysize):
+        dist += [math.sqrt(min(d2)) for d2 in zip(
+            *[[(tx - x) ** 2 + (ty - y) ** 2 for x in range(xsize)]
+              for (tx, ty) in targets])]
+
+    for (datatype, fmt, options, nodata) in [
+            (gdal.GDT_Byte, 'B', ['MAXDIST=100', 'NODATA=255'], 255),
+            (gdal.GDT_UInt16, 'H', [], None)]:
+        expected = [int(math.floor(d + 0.5)) if nodata is None or d <= 100
+                    else nodata for d in dist]
+        for num_threads in ['1', '4']:
+            dst_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1,
+                                                        datatype)
+            with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+                ret = gdal.ComputeProximity(src_ds.GetRasterBand(1),
+                                            dst_ds.GetRasterBand(1),
+                                            options=['ALGORITHM=EXACT'] +
+                                            options)
+            if ret != 0:
+                gdaltest.post_reason('fail')
+                return 'fail'
+            got = list(struct.unpack(fmt * (xsize * ysize),
+                                     dst_ds.GetRasterBand(1).ReadRaster()))
+            if got != expected:
+                i = [got[k] == expected[k] for k in range(len(got))].index(False)
+                gdaltest.post_reason('fail')
+                print(datatype, num_threads, i % xsize, i // xsize,
+                      got[i], expected[i])
+                return 'fail'
+
+    dst_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1,
+                                                gdal.GDT_Float32)
+    with gdaltest.error_handler():
+        ret = gdal.ComputeProximity(src_ds.GetRasterBand(1),
+                                    dst_ds.GetRasterBand(1),
+                                    options=['ALGORITHM=INVALID'])
+    if ret == 0:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
 
 gdaltest_list = [
     proximity_1,
     proximity_2,
-    proximity_3
+    proximity_3,
+    proximity_4
 ]
 
 if __name__ == '__main__':
@@ -84,9 +84,78 @@ def transformgeoloc_1():
 
     return 'success'
 
+###############################################################################
+# Test that the QUADTREE inverse method is consistent with the backmap one.
+
+
+def transformgeoloc_2():
+
+    try:
+        import numpy
+    except ImportError:
+        return 'skip'
+
+    geoloc_ds = gdal.GetDriverByName('GTiff').Create(
+        '/vsimem/transformgeoloc_2_geoloc.tif', 300, 200, 2, gdal.GDT_Float64)
+    j, i = numpy.mgrid[0:200, 0:300]
+    geoloc_ds.GetRasterBand(1).WriteArray(-117.0 + 0.01 * i + 0.002 * j)
+    geoloc_ds.GetRasterBand(2).WriteArray(45.0 - 0.01 * j + 0.001 * i)
+    geoloc_ds = None
+
+    ds = gdal.GetDriverByName('MEM').Create('', 300, 200)
+    ds.SetMetadata(['LINE_OFFSET=0', 'LINE_STEP=1',
+                    'PIXEL_OFFSET=0', 'PIXEL_STEP=1',
+                    'SRS=' + osr.GetUserInputAsWKT('WGS84'),
+                    'X_BAND=1',
+                    'X_DATASET=/vsimem/transformgeoloc_2_geoloc.tif',
+                    'Y_BAND=2',
+                    'Y_DATASET=/vsimem/transformgeoloc_2_geoloc.tif'],
+                   'GEOLOCATION')
+
+    tr_backmap = gdal.Transformer(ds, None, [])
+    with gdaltest.config_option('GDAL_GEOLOC_INVERSE_METHOD', 'QUADTREE'):
+        tr_quadtree = gdal.Transformer(ds, None, [])
+
+    ret = 'success'
+    for (x, y) in [(10.3, 20.7), (150.5, 100.5), (250.0, 180.25)]:
+        (_, geo_backmap) = tr_backmap.TransformPoint(0, x, y)
+        (_, geo_quadtree) = tr_quadtree.TransformPoint(0, x, y)
+        if abs(geo_backmap[0] - geo_quadtree[0]) > 1e-10 or \
+           abs(geo_backmap[1] - geo_quadtree[1]) > 1e-10:
+            gdaltest.post_reason('fail')
+            print(geo_backmap, geo_quadtree)
+            ret = 'fail'
+
+        (success, pl_backmap) = tr_backmap.TransformPoint(
+            1, geo_backmap[0], geo_backmap[1])
+        (success2, pl_quadtree) = tr_quadtree.TransformPoint(
+            1, geo_backmap[0], geo_backmap[1])
+        if not success or not success2 or \
+           abs(pl_backmap[0] - pl_quadtree[0]) > 1 or \
+           abs(pl_backmap[1] - pl_quadtree[1]) > 1 or \
+           abs(pl_quadtree[0] - (x + 0.5)) > 1e-6 or \
+           abs(pl_quadtree[1] - (y + 0.5)) > 1e-6:
+            gdaltest.post_reason('fail')
+            print(x, y, pl_backmap, pl_quadtree)
+            ret = 'fail'
+
+    # Outside of the geolocation arrays
+    (success, _) = tr_quadtree.TransformPoint(1, 0.0, 0.0)
+    if success:
+        gdaltest.post_reason('fail')
+        ret = 'fail'
+
+    tr_backmap = None
+    tr_quadtree = None
+    ds = None
+    gdal.Unlink('/vsimem/transformgeoloc_2_geoloc.tif')
+
+    return ret
+
 
 gdaltest_list = [
     transformgeoloc_1,
+    transformgeoloc_2,
 ]
 
 if __name__ == '__main__':
@@ -1948,6 +1948,300 @@ def warp_56():
     return 'success'
 
 
+###############################################################################
+# Test the 2D approximation mode of the approximate transformer
+# (GDAL_APPROX_TRANSFORMER_2D_ROWS)
+
+
+def warp_57():
+
+    src_ds = gdal.Open('../gcore/data/byte.tif')
+
+    ref_ds = gdal.Warp('', src_ds, format='MEM', dstSRS='EPSG:4326',
+                       width=200, height=200)
+
+    class DebugHandler:
+        def __init__(self):
+            self.used_2d = False
+
+        def handler(self, eErrClass, err_no, msg):
+            # pylint: disable=unused-argument
+            if msg.find('using 2D tiles') >= 0:
+                self.used_2d = True
+
+    handler = DebugHandler()
+    gdal.PushErrorHandler(handler.handler)
+    with gdaltest.config_options({'GDAL_APPROX_TRANSFORMER_2D_ROWS': '32',
+                                  'CPL_DEBUG': 'ON'}):
+        out_ds = gdal.Warp('', src_ds, format='MEM', dstSRS='EPSG:4326',
+                           width=200, height=200)
+    gdal.PopErrorHandler()
+
+    if not handler.used_2d:
+        gdaltest.post_reason('2D approximation not used')
+        return 'fail'
+
+    if out_ds.GetGeoTransform() != ref_ds.GetGeoTransform():
+        gdaltest.post_reason('fail')
+        print(out_ds.GetGeoTransform())
+        return 'fail'
+
+    # Nearest neighbour sampling of a source position that differs by less
+    # than the error threshold can pick a neighbouring pixel, so only expect
+    # the result to be close to the 1D approximation.
+    stats = out_ds.GetRasterBand(1).ComputeStatistics(False)
+    ref_stats = ref_ds.GetRasterBand(1).ComputeStatistics(False)
+    if abs(stats[2] - ref_stats[2]) > 1:
+        gdaltest.post_reason('fail')
+        print(stats, ref_stats)
+        return 'fail'
+
+    return 'success'
+
+
+###############################################################################
+# Test the sum and median resampling methods against values computed here
+
+
+def warp_58():
+
+    import math
+    import struct
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 40, 40)
+    src_ds.SetGeoTransform([0, 1, 0, 0, 0, -1])
+    data = [(7 * i + 3 * (i // 40)) % 251 for i in range(40 * 40)]
+    # Make the first 4x4 block of the source nodata
+    for j in range(4):
+        for i in range(4):
+            data[j * 40 + i] = 0
+    src_ds.GetRasterBand(1).WriteRaster(0, 0, 40, 40,
+                                        struct.pack('B' * 40 * 40, *data))
+    src_ds.GetRasterBand(1).SetNoDataValue(0)
+
+    for method in ['sum', 'med']:
+        out_ds = gdal.Warp('', src_ds, format='MEM', width=10, height=10,
+                           resampleAlg=method, outputType=gdal.GDT_UInt16,
+                           dstNodata=65535)
+        got = struct.unpack('H' * 100,
+                            out_ds.GetRasterBand(1).ReadRaster())
+        for y in range(10):
+            for x in range(10):
+                vals = [data[(4 * y + j) * 40 + 4 * x + i]
+                        for j in range(4) for i in range(4)]
+                vals = sorted([v for v in vals if v != 0])
+                if not vals:
+                    expected = 65535
+                elif method == 'sum':
+                    expected = sum(vals)
+                else:
+                    expected = vals[int(math.ceil(0.5 * len(vals) - 1))]
+                if got[y * 10 + x] != expected:
+                    gdaltest.post_reason('fail')
+                    print(method, x, y, got[y * 10 + x], expected)
+                    return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that the chunk processing order does not change the result, with a
+# rotated source whose source windows overlap a lot between chunks.
+
+
+def warp_59():
+
+    import struct
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 200, 200, 3)
+    src_ds.SetGeoTransform([0, 0.7, 0.7, 0, 0.7, -0.7])
+    for i in range(3):
+        # Some 0 (nodata) values
+        data = [(7 * x + 3 * y + 50 * i) % 251 for y in range(200)
+                for x in range(200)]
+        src_ds.GetRasterBand(i + 1).WriteRaster(
+            0, 0, 200, 200, struct.pack('B' * 200 * 200, *data))
+
+    ref_cs = None
+    for options in [['CHUNK_ORDER=DESTINATION'],
+                    ['CHUNK_ORDER=SOURCE'],
+                    ['CHUNK_ORDER=AUTO'],
+                    ['CHUNK_ORDER=SOURCE', 'CHUNKS_IN_FLIGHT=4']]:
+        out_ds = gdal.Warp('', src_ds, format='MEM',
+                           resampleAlg='bilinear', srcNodata=0,
+                           warpMemoryLimit=0.02, warpOptions=options,
+                           multithread='CHUNKS_IN_FLIGHT=4' in options)
+        cs = [out_ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+        if ref_cs is None:
+            ref_cs = cs
+        elif cs != ref_cs:
+            gdaltest.post_reason('fail')
+            print(options, cs, ref_cs)
+            return 'fail'
+
+    return 'success'
+
+
+###############################################################################
+# Test that the chunk pipeline of ChunkAndWarpMulti() gives the same result
+# as ChunkAndWarpImage(), for various numbers of chunks in flight.
+
+
+def warp_60():
+
+    import struct
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 300, 200, 2,
+                                                gdal.GDT_UInt16)
+    src_ds.SetGeoTransform([0, 0.6, 0.3, 0, 0.3, -0.6])
+    for i in range(2):
+        data = [(13 * x + 7 * y * y + 1000 * i) % 4099
+                for y in range(200) for x in range(300)]
+        src_ds.GetRasterBand(i + 1).WriteRaster(
+            0, 0, 300, 200, struct.pack('H' * 300 * 200, *data))
+
+    ref_data = None
+    for (multithread, options) in [(False, []),
+                                   (True, ['CHUNKS_IN_FLIGHT=2']),
+                                   (True, []),
+                                   (True, ['CHUNKS_IN_FLIGHT=5'])]:
+        out_ds = gdal.Warp('/vsimem/warp_60.tif', src_ds,
+                           creationOptions=['TILED=YES', 'BLOCKXSIZE=32',
+                                            'BLOCKYSIZE=32'],
+                           resampleAlg='cubic', srcNodata=0,
+                           warpMemoryLimit=0.02, warpOptions=options,
+                           multithread=multithread)
+        data = [out_ds.GetRasterBand(i + 1).ReadRaster() for i in range(2)]
+        out_ds = None
+        gdal.Unlink('/vsimem/warp_60.tif')
+        if ref_data is None:
+            ref_data = data
+        elif data != ref_data:
+            gdaltest.post_reason('fail')
+            print(multithread, options)
+            return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that ChunkAndWarpMulti() stops when the progress callback interrupts
+# it.
+
+
+def warp_61():
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 300, 200)
+    src_ds.SetGeoTransform([0, 0.6, 0.3, 0, 0.3, -0.6])
+    src_ds.GetRasterBand(1).Fill(1)
+
+    for options in [[], ['CHUNKS_IN_FLIGHT=5']]:
+        calls = [0]
+
+        def my_progress(pct, msg, user_data):
+            # pylint: disable=unused-argument
+            calls[0] += 1
+            return pct < 0.3
+
+        with gdaltest.error_handler():
+            out_ds = gdal.Warp('', src_ds, format='MEM',
+                               warpMemoryLimit=0.02, warpOptions=options,
+                               multithread=True, callback=my_progress)
+        if out_ds is not None:
+            gdaltest.post_reason('fail')
+            print(options)
+            return 'fail'
+        if calls[0] == 0:
+            gdaltest.post_reason('fail')
+            print(options)
+            return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that the AVX2 bilinear and cubic kernels give the same results as the
+# scalar code, including for the destination pixels near the source edges
+# and outside of the source. GDAL_USE_AVX2=NO is only honoured by DEBUG
+# builds, otherwise both runs use the same code.
+
+
+def warp_62():
+
+    import struct
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 41, 29, 2)
+    src_ds.SetGeoTransform([0, 1, 0, 0, 0, -1])
+    data = [(3 * x * x + 17 * y) % 251 for y in range(29) for x in range(41)]
+    src_ds.GetRasterBand(1).WriteRaster(
+        0, 0, 41, 29, struct.pack('B' * 41 * 29, *data))
+    alpha = [0 if (x + y) % 11 == 0 else 255 - (x * y) % 64
+             for y in range(29) for x in range(41)]
+    src_ds.GetRasterBand(2).WriteRaster(
+        0, 0, 41, 29, struct.pack('B' * 41 * 29, *alpha))
+    single_band_ds = gdal.Translate('', src_ds, format='MEM', bandList=[1])
+
+    for resample in ['bilinear', 'cubic']:
+        for (masks, ds, options, tolerance) in [
+                ('none', single_band_ds, {}, 1),
+                ('nodata', single_band_ds, {'srcNodata': 0}, 0),
+                ('alpha', src_ds, {'srcAlpha': True}, 0)]:
+            results = []
+            for use_avx2 in ['NO', 'YES']:
+                with gdaltest.config_option('GDAL_USE_AVX2', use_avx2):
+                    out_ds = gdal.Warp('', ds, format='MEM',
+                                       outputBounds=[-3.3, -32.1, 44.2, 2.7],
+                                       width=67, height=47, errorThreshold=0,
+                                       resampleAlg=resample, **options)
+                results.append(struct.unpack(
+                    'B' * 67 * 47, out_ds.GetRasterBand(1).ReadRaster()))
+                out_ds = None
+            max_diff = max(abs(a - b) for (a, b) in zip(*results))
+            if max_diff > tolerance:
+                gdaltest.post_reason('fail')
+                print(resample, masks, max_diff)
+                return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that the sum resampling method ignores the source overviews
+
+
+def warp_63():
+
+    import struct
+
+    src_ds = gdal.GetDriverByName('GTiff').Create('/vsimem/warp_63.tif',
+                                                  64, 64)
+    src_ds.SetGeoTransform([0, 1, 0, 0, 0, -1])
+    data = [(5 * x + 3 * y) % 17 for y in range(64) for x in range(64)]
+    src_ds.GetRasterBand(1).WriteRaster(
+        0, 0, 64, 64, struct.pack('B' * 64 * 64, *data))
+    src_ds.BuildOverviews('AVERAGE', [2, 4])
+
+    for ovr in [None, '0']:
+        options = '-of MEM -ts 16 16 -r sum -ot UInt16'
+        if ovr is not None:
+            options += ' -ovr ' + ovr
+        gdal.ErrorReset()
+        with gdaltest.error_handler():
+            out_ds = gdal.Warp('', src_ds, options=options)
+        if (gdal.GetLastErrorMsg() != '') != (ovr is not None):
+            gdaltest.post_reason('fail')
+            print(ovr, gdal.GetLastErrorMsg())
+            return 'fail'
+        got = struct.unpack('H' * 16 * 16,
+                            out_ds.GetRasterBand(1).ReadRaster())
+        if sum(got) != sum(data):
+            gdaltest.post_reason('fail')
+            print(ovr, sum(got), sum(data))
+            return 'fail'
+        out_ds = None
+
+    src_ds = None
+    gdal.Unlink('/vsimem/warp_63.tif')
+
+    return 'success'
+
+
 gdaltest_list = [
     warp_1,
     warp_1_short,
@@ -2021,7 +2315,14 @@ gdaltest_list = [
     warp_53,
     warp_54,
     warp_55,
-    warp_56
+    warp_56,
+    warp_57,
+    warp_58,
+    warp_59,
+    warp_60,
+    warp_61,
+    warp_62,
+    warp_63
 ]
 # gdaltest_list = [ warp_55 ]
 
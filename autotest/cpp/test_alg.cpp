@@ -30,9 +30,15 @@
 #include "gdal_unit_test.h"
 
 #include "cpl_conv.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
 
 #include "gdal_alg.h"
 #include "gdalwarper.h"
+#include "ogr_srs_api.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace tut
 {
@@ -266,5 +272,298 @@ namespace tut
         GDALDestroyWarpOptions(psOptions);
     }
 
+    // GDALCreateGridTransformer()
+    template<>
+    template<>
+    void object::test<8>()
+    {
+        const double adfSrcGT[6] = { 2, 0.5, 0.1, 49, 0.05, -0.5 };
+        const double adfDstGT[6] = { 2, 0.25, 0, 49, 0, -0.25 };
+        void* hBase = GDALCreateGenImgProjTransformer3( nullptr, adfSrcGT,
+                                                        nullptr, adfDstGT );
+        ensure( hBase != nullptr );
+
+        void* hGrid = GDALCreateGridTransformer( GDALGenImgProjTransform,
+                                                 hBase, 100, 80, 16, 0.01 );
+        ensure( hGrid != nullptr );
+
+        for( int i = 0; i < 10; i++ )
+        {
+            double x = 0.5 + i * 9.9;
+            double y = 0.5 + i * 7.9;
+            double z = 0;
+            double xRef = x;
+            double yRef = y;
+            int bSuccess = FALSE;
+            ensure( GDALGridTransform( hGrid, TRUE, 1, &x, &y, &z,
+                                       &bSuccess ) );
+            ensure( bSuccess );
+            GDALGenImgProjTransform( hBase, TRUE, 1, &xRef, &yRef, &z,
+                                     &bSuccess );
+            ensure_distance( x, xRef, 1e-8 );
+            ensure_distance( y, yRef, 1e-8 );
+        }
+
+        // The serialized grid does not need the base transformer.
+        CPLXMLNode* psTree = GDALSerializeTransformer( GDALGridTransform,
+                                                       hGrid );
+        ensure( psTree != nullptr );
+        GDALTransformerFunc pfnFunc = nullptr;
+        void* hDeserialized = nullptr;
+        ensure_equals( GDALDeserializeTransformer( psTree, &pfnFunc,
+                                                   &hDeserialized ),
+                       CE_None );
+        CPLDestroyXMLNode( psTree );
+        ensure( pfnFunc == GDALGridTransform );
+
+        double x = 50.5;
+        double y = 40.5;
+        double z = 0;
+        double xRef = x;
+        double yRef = y;
+        int bSuccess = FALSE;
+        ensure( pfnFunc( hDeserialized, TRUE, 1, &x, &y, &z, &bSuccess ) );
+        ensure( bSuccess );
+        GDALGenImgProjTransform( hBase, TRUE, 1, &xRef, &yRef, &z,
+                                 &bSuccess );
+        ensure_distance( x, xRef, 1e-8 );
+        ensure_distance( y, yRef, 1e-8 );
+
+        // Outside of the grid, and no base transformer.
+        x = 150.5;
+        ensure( pfnFunc( hDeserialized, TRUE, 1, &x, &y, &z, &bSuccess ) );
+        ensure( !bSuccess );
+
+        GDALDestroyTransformer( hDeserialized );
+        GDALDestroyGridTransformer( hGrid );
+        GDALDestroyGenImgProjTransformer( hBase );
+    }
+
+    // Counts the points going through GDALGenImgProjTransform(), to check
+    // whether a grid was computed or taken from a cache.
+    static int nGridBaseCalls = 0;
+
+    static int CountingGenImgProjTransform( void *pTransformArg, int bDstToSrc,
+                                            int nPointCount,
+                                            double *x, double *y, double *z,
+                                            int *panSuccess )
+    {
+        nGridBaseCalls += nPointCount;
+        return GDALGenImgProjTransform( pTransformArg, bDstToSrc, nPointCount,
+                                        x, y, z, panSuccess );
+    }
+
+    // Create grid transformers with 16 configurations not used elsewhere,
+    // to evict the previous ones from the process-wide cache.
+    static void EvictGridTransformerCache( void* hBase )
+    {
+        for( int i = 0; i < 16; i++ )
+        {
+            void* hGrid = GDALCreateGridTransformer( GDALGenImgProjTransform,
+                                                     hBase, 201 + i, 10, 16,
+                                                     0 );
+            ensure( hGrid != nullptr );
+            GDALDestroyGridTransformer( hGrid );
+        }
+    }
+
+    // GDALCreateGridTransformer() with a non-linear reprojection
+    template<>
+    template<>
+    void object::test<9>()
+    {
+        OGRSpatialReferenceH hSrcSRS = OSRNewSpatialReference(nullptr);
+        OSRSetWellKnownGeogCS( hSrcSRS, "WGS84" );
+        OGRSpatialReferenceH hDstSRS = OSRNewSpatialReference(nullptr);
+        OSRSetWellKnownGeogCS( hDstSRS, "WGS84" );
+        OSRSetUTM( hDstSRS, 31, TRUE );
+        char* pszSrcWKT = nullptr;
+        char* pszDstWKT = nullptr;
+        OSRExportToWkt( hSrcSRS, &pszSrcWKT );
+        OSRExportToWkt( hDstSRS, &pszDstWKT );
+        OSRDestroySpatialReference( hSrcSRS );
+        OSRDestroySpatialReference( hDstSRS );
+
+        // Up to 9 degrees away from the central meridian of the zone.
+        const double adfSrcGT[6] = { -6, 0.02, 0, 62, 0, -0.02 };
+        const double adfDstGT[6] = { 0, 2000, 0, 6500000, 0, -2000 };
+        void* hBase = GDALCreateGenImgProjTransformer3( pszSrcWKT, adfSrcGT,
+                                                        pszDstWKT, adfDstGT );
+        CPLFree( pszSrcWKT );
+        CPLFree( pszDstWKT );
+        ensure( hBase != nullptr );
+
+        const double dfMaxError = 0.01;
+        void* hGrid = GDALCreateGridTransformer( GDALGenImgProjTransform,
+                                                 hBase, 500, 500, 64,
+                                                 dfMaxError );
+        ensure( hGrid != nullptr );
+
+        // Cells over the threshold are refined, not the whole grid.
+        CPLXMLNode* psTree = GDALSerializeTransformer( GDALGridTransform,
+                                                       hGrid );
+        ensure( psTree != nullptr );
+        ensure_equals( atoi(CPLGetXMLValue(psTree, "Step", "0")), 64 );
+        ensure( CPLGetXMLNode(psTree, "SubGrids.SubGrid") != nullptr );
+        GDALTransformerFunc pfnFunc = nullptr;
+        void* hDeserialized = nullptr;
+        ensure_equals( GDALDeserializeTransformer( psTree, &pfnFunc,
+                                                   &hDeserialized ),
+                       CE_None );
+        CPLDestroyXMLNode( psTree );
+
+        double dfError = 0;
+        for( double y = 0.25; y <= 500; y += 4.9 )
+        {
+            for( double x = 0.25; x <= 500; x += 3.7 )
+            {
+                double xGrid = x;
+                double yGrid = y;
+                double xDeserialized = x;
+                double yDeserialized = y;
+                double xRef = x;
+                double yRef = y;
+                double z = 0;
+                int bSuccess = FALSE;
+                ensure( GDALGridTransform( hGrid, TRUE, 1, &xGrid, &yGrid,
+                                           &z, &bSuccess ) );
+                ensure( bSuccess );
+                ensure( pfnFunc( hDeserialized, TRUE, 1, &xDeserialized,
+                                 &yDeserialized, &z, &bSuccess ) );
+                ensure( bSuccess );
+                ensure_equals( xDeserialized, xGrid );
+                ensure_equals( yDeserialized, yGrid );
+                GDALGenImgProjTransform( hBase, TRUE, 1, &xRef, &yRef, &z,
+                                         &bSuccess );
+                ensure( bSuccess );
+                dfError = std::max(dfError,
+                                   fabs(xGrid - xRef) + fabs(yGrid - yRef));
+            }
+        }
+        ensure( dfError <= dfMaxError );
+
+        GDALDestroyTransformer( hDeserialized );
+        GDALDestroyGridTransformer( hGrid );
+        GDALDestroyGenImgProjTransformer( hBase );
+    }
+
+    // GDALCreateGridTransformer(): process-wide cache of grids
+    template<>
+    template<>
+    void object::test<10>()
+    {
+        const double adfSrcGT[6] = { 3, 0.5, 0.1, 47, 0.05, -0.5 };
+        const double adfDstGT[6] = { 3, 0.25, 0, 47, 0, -0.25 };
+        void* hBase = GDALCreateGenImgProjTransformer3( nullptr, adfSrcGT,
+                                                        nullptr, adfDstGT );
+        ensure( hBase != nullptr );
+
+        nGridBaseCalls = 0;
+        void* hGrid = GDALCreateGridTransformer( CountingGenImgProjTransform,
+                                                 hBase, 100, 80, 16, 0 );
+        ensure( hGrid != nullptr );
+        ensure( nGridBaseCalls > 0 );
+        GDALDestroyGridTransformer( hGrid );
+
+        // Same configuration: the grid comes from the cache.
+        nGridBaseCalls = 0;
+        hGrid = GDALCreateGridTransformer( CountingGenImgProjTransform,
+                                           hBase, 100, 80, 16, 0 );
+        ensure( hGrid != nullptr );
+        ensure_equals( nGridBaseCalls, 0 );
+        double x = 50.5;
+        double y = 40.5;
+        double z = 0;
+        double xRef = x;
+        double yRef = y;
+        int bSuccess = FALSE;
+        ensure( GDALGridTransform( hGrid, TRUE, 1, &x, &y, &z, &bSuccess ) );
+        ensure( bSuccess );
+        GDALGenImgProjTransform( hBase, TRUE, 1, &xRef, &yRef, &z,
+                                 &bSuccess );
+        ensure_distance( x, xRef, 1e-8 );
+        ensure_distance( y, yRef, 1e-8 );
+        GDALDestroyGridTransformer( hGrid );
+
+        // Other grid parameters: not in the cache.
+        nGridBaseCalls = 0;
+        hGrid = GDALCreateGridTransformer( CountingGenImgProjTransform,
+                                           hBase, 100, 80, 8, 0 );
+        ensure( hGrid != nullptr );
+        ensure( nGridBaseCalls > 0 );
+        GDALDestroyGridTransformer( hGrid );
+
+        // Least recently used grids are evicted.
+        EvictGridTransformerCache( hBase );
+        nGridBaseCalls = 0;
+        hGrid = GDALCreateGridTransformer( CountingGenImgProjTransform,
+                                           hBase, 100, 80, 16, 0 );
+        ensure( hGrid != nullptr );
+        ensure( nGridBaseCalls > 0 );
+        GDALDestroyGridTransformer( hGrid );
+
+        GDALDestroyGenImgProjTransformer( hBase );
+    }
+
+    // GDALCreateGridTransformer(): GDAL_GRID_TRANSFORMER_CACHE_DIR
+    template<>
+    template<>
+    void object::test<11>()
+    {
+        const double adfSrcGT[6] = { 4, 0.5, 0.1, 46, 0.05, -0.5 };
+        const double adfDstGT[6] = { 4, 0.25, 0, 46, 0, -0.25 };
+        void* hBase = GDALCreateGenImgProjTransformer3( nullptr, adfSrcGT,
+                                                        nullptr, adfDstGT );
+        ensure( hBase != nullptr );
+
+        const char* pszCacheDir = "/vsimem/test_alg_grid_cache";
+        VSIMkdir( pszCacheDir, 0755 );
+        CPLSetConfigOption( "GDAL_GRID_TRANSFORMER_CACHE_DIR", pszCacheDir );
+
+        nGridBaseCalls = 0;
+        void* hGrid = GDALCreateGridTransformer( CountingGenImgProjTransform,
+                                                 hBase, 100, 80, 16, 0 );
+        ensure( hGrid != nullptr );
+        ensure( nGridBaseCalls > 0 );
+        GDALDestroyGridTransformer( hGrid );
+
+        char** papszFiles = VSIReadDir( pszCacheDir );
+        ensure_equals( CSLCount(papszFiles), 1 );
+        ensure( EQUAL(CPLGetExtension(papszFiles[0]), "xml") );
+        CSLDestroy( papszFiles );
+
+        // Evict the grid from the process-wide cache, so that it is read
+        // from the cache directory.
+        CPLSetConfigOption( "GDAL_GRID_TRANSFORMER_CACHE_DIR", nullptr );
+        EvictGridTransformerCache( hBase );
+        CPLSetConfigOption( "GDAL_GRID_TRANSFORMER_CACHE_DIR", pszCacheDir );
+
+        nGridBaseCalls = 0;
+        hGrid = GDALCreateGridTransformer( CountingGenImgProjTransform,
+                                           hBase, 100, 80, 16, 0 );
+        ensure( hGrid != nullptr );
+        ensure_equals( nGridBaseCalls, 0 );
+        for( int i = 0; i < 10; i++ )
+        {
+            double x = 0.5 + i * 9.9;
+            double y = 0.5 + i * 7.9;
+            double z = 0;
+            double xRef = x;
+            double yRef = y;
+            int bSuccess = FALSE;
+            ensure( GDALGridTransform( hGrid, TRUE, 1, &x, &y, &z,
+                                       &bSuccess ) );
+            ensure( bSuccess );
+            GDALGenImgProjTransform( hBase, TRUE, 1, &xRef, &yRef, &z,
+                                     &bSuccess );
+            ensure_distance( x, xRef, 1e-8 );
+            ensure_distance( y, yRef, 1e-8 );
+        }
+        GDALDestroyGridTransformer( hGrid );
+
+        CPLSetConfigOption( "GDAL_GRID_TRANSFORMER_CACHE_DIR", nullptr );
+        VSIRmdirRecursive( pszCacheDir );
+        GDALDestroyGenImgProjTransformer( hBase );
+    }
 
 } // namespace tut
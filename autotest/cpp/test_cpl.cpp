@@ -39,6 +39,8 @@
 #include "cpl_json_streaming_parser.h"
 #include "cpl_mem_cache.h"
 #include "cpl_http.h"
+#include "cpl_worker_thread_pool.h"
+#include "cpl_atomic_ops.h"
 
 #include <fstream>
 #include <string>
@@ -2443,4 +2445,121 @@ namespace tut
         ensure_equals(cpl::down_cast<Derived*>(static_cast<Base*>(nullptr)), static_cast<Derived*>(nullptr));
     }
 
+    // Test CPLWorkerThreadPool job queues and nested jobs
+    struct TestNestedJobData
+    {
+        CPLWorkerThreadPool* poPool;
+        int*                 pnCounter;
+    };
+
+    static void TestNestedJobInnerFunc(void* pData)
+    {
+        CPLAtomicInc(static_cast<int*>(pData));
+    }
+
+    static void TestNestedJobOuterFunc(void* pData)
+    {
+        TestNestedJobData* psData = static_cast<TestNestedJobData*>(pData);
+        auto poQueue = psData->poPool->CreateJobQueue();
+        for( int i = 0; i < 10; i++ )
+            poQueue->SubmitJob(TestNestedJobInnerFunc, psData->pnCounter);
+        poQueue->WaitCompletion();
+        // All the inner jobs of this queue must be finished
+        CPLAtomicInc(psData->pnCounter);
+    }
+
+    template<>
+    template<>
+    void object::test<35>()
+    {
+        // A single thread pool would dead-lock if a waiting job did not
+        // run the queued jobs itself.
+        for( int nThreads = 1; nThreads <= 4; nThreads *= 2 )
+        {
+            CPLWorkerThreadPool oPool;
+            ensure( oPool.Setup(nThreads, nullptr, nullptr) );
+
+            int nCounter = 0;
+            TestNestedJobData sData;
+            sData.poPool = &oPool;
+            sData.pnCounter = &nCounter;
+            for( int i = 0; i < 20; i++ )
+                ensure( oPool.SubmitJob(TestNestedJobOuterFunc, &sData) );
+            oPool.WaitCompletion();
+            ensure_equals( nCounter, 20 * 11 );
+
+            // Job queues are independent from the other jobs
+            int nCounter2 = 0;
+            {
+                auto poQueue = oPool.CreateJobQueue();
+                std::vector<void*> apData(100, &nCounter);
+                ensure( oPool.SubmitJobs(TestNestedJobInnerFunc, apData) );
+                for( int i = 0; i < 100; i++ )
+                {
+                    ensure( poQueue->SubmitJob(TestNestedJobInnerFunc,
+                                               &nCounter2) );
+                }
+                poQueue->WaitCompletion();
+                ensure_equals( nCounter2, 100 );
+            }
+            oPool.WaitCompletion();
+            ensure_equals( nCounter, 20 * 11 + 100 );
+        }
+    }
+
+    // Test CPLJobQueue limit on the number of jobs running at once
+    struct TestLimitedJobData
+    {
+        int nRunning;
+        int nMaxRunning;
+        int nDone;
+    };
+
+    static void TestLimitedJobFunc(void* pData)
+    {
+        TestLimitedJobData* psData = static_cast<TestLimitedJobData*>(pData);
+        const int nRunning = CPLAtomicInc(&psData->nRunning);
+        int nMaxRunning = psData->nMaxRunning;
+        while( nRunning > nMaxRunning &&
+               !CPLAtomicCompareAndExchange(&psData->nMaxRunning,
+                                            nMaxRunning, nRunning) )
+        {
+            nMaxRunning = psData->nMaxRunning;
+        }
+        CPLSleep(0.001);
+        CPLAtomicDec(&psData->nRunning);
+        CPLAtomicInc(&psData->nDone);
+    }
+
+    template<>
+    template<>
+    void object::test<36>()
+    {
+        CPLWorkerThreadPool oPool;
+        ensure( oPool.Setup(4, nullptr, nullptr) );
+
+        TestLimitedJobData sData;
+        sData.nRunning = 0;
+        sData.nMaxRunning = 0;
+        sData.nDone = 0;
+        auto poQueue = oPool.CreateJobQueue(2);
+        ensure_equals( poQueue->GetMaxRunningJobs(), 2 );
+        std::vector<void*> apData(50, &sData);
+        ensure( poQueue->SubmitJobs(TestLimitedJobFunc, apData) );
+
+        // Wait for jobs one at a time
+        int nEvents = 0;
+        while( sData.nDone < 10 )
+        {
+            poQueue->WaitEvent();
+            nEvents ++;
+        }
+        ensure( nEvents <= 10 );
+
+        poQueue->WaitCompletion();
+        ensure_equals( sData.nDone, 50 );
+        ensure( sData.nMaxRunning >= 1 );
+        ensure( sData.nMaxRunning <= 2 );
+    }
+
 } // namespace tut
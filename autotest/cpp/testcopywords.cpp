@@ -30,7 +30,9 @@
 #include "cpl_conv.h"
 #include "gdal.h"
 
+#include <cstring>
 #include <iostream>
+#include <limits>
 
 GByte* pIn;
 GByte* pOut;
@@ -569,18 +571,73 @@ template<> void CheckPacked<GUInt16,GInt16>(GDALDataType eIn, GDALDataType eOut)
     }
 }
 
+// Check that converting a packed buffer, which may use SIMD code paths, gives
+// the same results as converting each word individually.
+template<class Tin, class Tout>
+void CheckPackedSpecialValues(GDALDataType eIn, GDALDataType eOut)
+{
+    const double adfVal[] = { 0.0, -0.0, 0.5, -0.5, 0.49999997, 1.5, -1.5,
+                              2.5, 254.5, 255.0, 255.49, 255.5, 256.0,
+                              -32767.5, -32768.5, -32769.0, 32766.5, 32767.5,
+                              65534.5, 65535.5, 65536.0, 2147483520.0,
+                              2147483647.5, 2147483648.0, -2147483520.0,
+                              -2147483648.5, -2147483649.0, 4294967040.0,
+                              4294967294.5, 4294967295.5, 4294967296.0,
+                              3.4028234663852886e+38, 3.4028235e+38, -3.4028235e+38,
+                              1e300, -1e300,
+                              std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity(),
+                              std::numeric_limits<double>::quiet_NaN() };
+    const int nVals = static_cast<int>(sizeof(adfVal) / sizeof(adfVal[0]));
+    const int N = 64+7;
+    Tin arrayIn[N];
+    Tout arrayOut[N];
+    for(int i=0;i<N;i++)
+    {
+        GDALCopyWords(&adfVal[i % nVals], GDT_Float64, 0,
+                      &arrayIn[i], eIn, 0, 1);
+    }
+    GDALCopyWords(arrayIn, eIn, GDALGetDataTypeSizeBytes(eIn),
+                  arrayOut, eOut, GDALGetDataTypeSizeBytes(eOut),
+                  N);
+    for(int i=0;i<N;i++)
+    {
+        Tout expected;
+        GDALCopyWords(&arrayIn[i], eIn, 0, &expected, eOut, 0, 1);
+        const bool bBothNaN = CPLIsNan(static_cast<double>(expected)) &&
+                              CPLIsNan(static_cast<double>(arrayOut[i]));
+        if( !bBothNaN && memcmp(&expected, &arrayOut[i], sizeof(Tout)) != 0 )
+        {
+            std::cout << "Packed conversion mismatch " <<
+                         GDALGetDataTypeName(eIn) << " -> " <<
+                         GDALGetDataTypeName(eOut) << " for " <<
+                         static_cast<double>(arrayIn[i]) << ": got " <<
+                         static_cast<double>(arrayOut[i]) << " expected " <<
+                         static_cast<double>(expected) << std::endl;
+            bErr = TRUE;
+        }
+    }
+}
+
 template<class Tin> 
 void CheckPacked(GDALDataType eIn, GDALDataType eOut)
 {
     switch(eOut)
     {
-        case GDT_Byte: CheckPacked<Tin, GByte>(eIn, eOut); break;
-        case GDT_UInt16: CheckPacked<Tin, GUInt16>(eIn, eOut); break;
-        case GDT_Int16: CheckPacked<Tin, GInt16>(eIn, eOut); break;
-        case GDT_UInt32: CheckPacked<Tin, GUInt32>(eIn, eOut); break;
-        case GDT_Int32: CheckPacked<Tin, GInt32>(eIn, eOut); break;
-        case GDT_Float32: CheckPacked<Tin, float>(eIn, eOut); break;
-        case GDT_Float64: CheckPacked<Tin, double>(eIn, eOut); break;
+        case GDT_Byte: CheckPacked<Tin, GByte>(eIn, eOut);
+            CheckPackedSpecialValues<Tin, GByte>(eIn, eOut); break;
+        case GDT_UInt16: CheckPacked<Tin, GUInt16>(eIn, eOut);
+            CheckPackedSpecialValues<Tin, GUInt16>(eIn, eOut); break;
+        case GDT_Int16: CheckPacked<Tin, GInt16>(eIn, eOut);
+            CheckPackedSpecialValues<Tin, GInt16>(eIn, eOut); break;
+        case GDT_UInt32: CheckPacked<Tin, GUInt32>(eIn, eOut);
+            CheckPackedSpecialValues<Tin, GUInt32>(eIn, eOut); break;
+        case GDT_Int32: CheckPacked<Tin, GInt32>(eIn, eOut);
+            CheckPackedSpecialValues<Tin, GInt32>(eIn, eOut); break;
+        case GDT_Float32: CheckPacked<Tin, float>(eIn, eOut);
+            CheckPackedSpecialValues<Tin, float>(eIn, eOut); break;
+        case GDT_Float64: CheckPacked<Tin, double>(eIn, eOut);
+            CheckPackedSpecialValues<Tin, double>(eIn, eOut); break;
         default:
             CPLAssert(false);
     }
@@ -605,6 +662,46 @@ static void CheckPacked(GDALDataType eIn, GDALDataType eOut)
 }
 
 
+// Packed Float32 -> Int16 conversions go through GDALCopy4Words() /
+// GDALCopy8Words() (or the AVX2 kernels). Since GDAL 2.4 they follow the
+// scalar GDALCopyWord(): NaN gives 0, and rounding is done before clamping,
+// so 0.49999997f + 0.5f rounds to 1.0f and gives 1.
+static void CheckPackedFloat32ToInt16()
+{
+    const float afIn[] = { std::numeric_limits<float>::quiet_NaN(),
+                           0.49999997f, -0.49999997f, 0.5f, -0.5f,
+                           1.5f, -1.5f, 32766.5f, 32767.5f, -32768.5f,
+                           -32769.0f, 1e10f, -1e10f,
+                           std::numeric_limits<float>::infinity(),
+                           -std::numeric_limits<float>::infinity(),
+                           2.0f };
+    const GInt16 anExpected[] = { 0, 1, -1, 1, -1, 2, -2, 32767, 32767,
+                                  -32768, -32768, 32767, -32768, 32767,
+                                  -32768, 2 };
+    const int N = static_cast<int>(sizeof(afIn) / sizeof(afIn[0]));
+    for( int k = 0; k < 2; k++ )
+    {
+        // Also exercise the SSE2 code path on AVX2 capable machines.
+        if( k == 1 )
+            CPLSetConfigOption("GDAL_USE_AVX2", "NO");
+        GInt16 anOut[N];
+        GDALCopyWords(afIn, GDT_Float32, sizeof(float),
+                      anOut, GDT_Int16, sizeof(GInt16), N);
+        for( int i = 0; i < N; i++ )
+        {
+            if( anOut[i] != anExpected[i] )
+            {
+                std::cout << "Packed Float32 -> Int16 failed for " <<
+                             afIn[i] << ": got " << anOut[i] <<
+                             " expected " << anExpected[i] << std::endl;
+                bErr = TRUE;
+            }
+        }
+    }
+    CPLSetConfigOption("GDAL_USE_AVX2", nullptr);
+}
+
+
 int main(int /* argc */, char* /* argv */ [])
 {
     pIn = (GByte*)malloc(256);
@@ -711,6 +808,7 @@ int main(int /* argc */, char* /* argv */ [])
             CheckPacked(eIn, eOut);
         }
     }
+    CheckPackedFloat32ToInt16();
 
     if (bErr == FALSE)
         printf("success !\n");
@@ -114,5 +114,45 @@ int main(int /* argc */, char* /* argv */ [])
     }
     CPLSetConfigOption("GDAL_USE_SSSE3", nullptr);
 
+    // Packed conversions between non-complex types, which may use the AVX2
+    // kernels. GDAL_USE_AVX2=NO is only honoured by DEBUG builds.
+    for(int k=0;k<2;k++)
+    {
+        if( k == 1 )
+        {
+            printf("Disabling AVX2\n");
+            CPLSetConfigOption("GDAL_USE_AVX2", "NO");
+        }
+
+        for(intype=GDT_Byte; intype<=GDT_Float64;intype++)
+        {
+            for(outtype=GDT_Byte;outtype<=GDT_Float64;outtype++)
+            {
+                if( intype == outtype )
+                    continue;
+
+                start = clock();
+
+                for(i=0;i<1000;i++)
+                    GDALCopyWords(in,
+                                  (GDALDataType)intype,
+                                  GDALGetDataTypeSizeBytes((GDALDataType)intype),
+                                  out,
+                                  (GDALDataType)outtype,
+                                  GDALGetDataTypeSizeBytes((GDALDataType)outtype),
+                                  256 * 256);
+
+                end = clock();
+
+                printf("%s -> %s (packed, %s) : %.2f s\n",
+                       GDALGetDataTypeName((GDALDataType)intype),
+                       GDALGetDataTypeName((GDALDataType)outtype),
+                       k == 0 ? "AVX2 if available" : "no AVX2",
+                       (end - start) * 1.0 / CLOCKS_PER_SEC);
+            }
+        }
+    }
+    CPLSetConfigOption("GDAL_USE_AVX2", nullptr);
+
     return 0;
 }
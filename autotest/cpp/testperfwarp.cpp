@@ -0,0 +1,486 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Test performance of GDALWarpKernel::PerformWarp().
+ * Author:   agent <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+// Runs GDALWarpKernel::PerformWarp() on synthetic MEM datasets, for each
+// combination of resampling method, data type and source/destination mask
+// configuration, and reports throughput and the time spent in the
+// transformer. If GDAL is built with -DGWK_PROFILING, the time spent in
+// fetching source pixels (GWKGetPixelRow()) and in writing destination
+// pixels (GWKSetPixelValue*()) is also reported. The remaining time
+// corresponds to resampling and to the specialized kernels that access
+// the buffers directly.
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "gdal.h"
+#include "gdal_alg.h"
+#include "gdal_alg_priv.h"
+#include "gdalwarper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+/************************************************************************/
+/*                          TimingTransformer()                         */
+/************************************************************************/
+
+struct TimingTransformerInfo
+{
+    GDALTransformerFunc pfnTransformer;
+    void               *pTransformerArg;
+    double              dfTime;
+    GUIntBig            nPoints;
+};
+
+int TimingTransformer( void *pTransformerArg, int bDstToSrc, int nPointCount,
+                       double *x, double *y, double *z, int *panSuccess )
+{
+    TimingTransformerInfo* psInfo =
+        static_cast<TimingTransformerInfo*>(pTransformerArg);
+    const auto oStart = std::chrono::steady_clock::now();
+    const int nRet = psInfo->pfnTransformer(psInfo->pTransformerArg,
+                                            bDstToSrc, nPointCount,
+                                            x, y, z, panSuccess);
+    psInfo->dfTime += std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - oStart).count();
+    psInfo->nPoints += nPointCount;
+    return nRet;
+}
+
+/************************************************************************/
+/*                              Options                                 */
+/************************************************************************/
+
+enum MaskConfig
+{
+    MASK_NONE,
+    MASK_UNIFIED_SRC_VALID,
+    MASK_BAND_SRC_VALID,
+    MASK_SRC_DST_DENSITY
+};
+
+// Indexed by GDALResampleAlg, with the same names as gdalwarp -r.
+const char* const apszResampleNames[] = {
+    "near", "bilinear", "cubic", "cubicspline", "lanczos", "average",
+    "mode", nullptr /* reserved */, "max", "min", "med", "q1", "q3", "sum" };
+constexpr int nResampleCount =
+    static_cast<int>(sizeof(apszResampleNames) / sizeof(apszResampleNames[0]));
+
+const char* const apszMaskNames[] = { "none", "unified", "band", "density" };
+
+struct Options
+{
+    int    nSrcXSize = 1024;
+    int    nSrcYSize = 1024;
+    int    nBands = 1;
+    double dfScale = 1.3;
+    int    nLoops = 3;
+    std::vector<GDALResampleAlg> aeResample;
+    std::vector<GDALDataType> aeDataType;
+    std::vector<MaskConfig> aeMask;
+};
+
+void Usage()
+{
+    printf("Usage: testperfwarp [-src_size xsize ysize] [-bands n]\n"
+           "                    [-scale src_to_dst_pixel_ratio] [-loops n]\n"
+           "                    [-r resampling]* [-ot datatype]*\n"
+           "                    [-mask none|unified|band|density]*\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                         CreateSourceDataset()                        */
+/************************************************************************/
+
+GDALDatasetH CreateSourceDataset( const Options& sOptions,
+                                  GDALDataType eDT )
+{
+    GDALDatasetH hDS = GDALCreate(GDALGetDriverByName("MEM"), "",
+                                  sOptions.nSrcXSize, sOptions.nSrcYSize,
+                                  sOptions.nBands, eDT, nullptr);
+    if( hDS == nullptr )
+        return nullptr;
+    double adfGT[6] = { 0, 1, 0, 0, 0, -1 };
+    GDALSetGeoTransform(hDS, adfGT);
+
+    // Smooth pattern with some pseudo-random noise, so that mode and
+    // quantiles have something to chew on.
+    std::vector<double> adfLine(sOptions.nSrcXSize);
+    unsigned nSeed = 1;
+    for( int iBand = 0; iBand < sOptions.nBands; iBand++ )
+    {
+        GDALRasterBandH hBand = GDALGetRasterBand(hDS, iBand + 1);
+        for( int iY = 0; iY < sOptions.nSrcYSize; iY++ )
+        {
+            for( int iX = 0; iX < sOptions.nSrcXSize; iX++ )
+            {
+                nSeed = nSeed * 1103515245U + 12345U;
+                adfLine[iX] = ((iX + iY + 40 * iBand) % 200) +
+                              static_cast<double>((nSeed >> 16) % 50);
+            }
+            if( GDALRasterIO(hBand, GF_Write, 0, iY,
+                             sOptions.nSrcXSize, 1,
+                             &adfLine[0], sOptions.nSrcXSize, 1,
+                             GDT_Float64, 0, 0) != CE_None )
+            {
+                GDALClose(hDS);
+                return nullptr;
+            }
+        }
+    }
+    return hDS;
+}
+
+/************************************************************************/
+/*                              RunOne()                                */
+/************************************************************************/
+
+bool RunOne( const Options& sOptions, GDALDatasetH hSrcDS,
+             GDALResampleAlg eResample, GDALDataType eDT,
+             MaskConfig eMask )
+{
+    const int nSrcXSize = sOptions.nSrcXSize;
+    const int nSrcYSize = sOptions.nSrcYSize;
+    const int nBands = sOptions.nBands;
+    const int nDstXSize = std::max(1,
+        static_cast<int>(nSrcXSize / sOptions.dfScale));
+    const int nDstYSize = std::max(1,
+        static_cast<int>(nSrcYSize / sOptions.dfScale));
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDT);
+    const size_t nSrcPixels = static_cast<size_t>(nSrcXSize) * nSrcYSize;
+    const size_t nDstPixels = static_cast<size_t>(nDstXSize) * nDstYSize;
+
+    // Destination grid slightly shifted so that it is not aligned with the
+    // source grid.
+    GDALDatasetH hDstDS = GDALCreate(GDALGetDriverByName("MEM"), "",
+                                     nDstXSize, nDstYSize, nBands, eDT,
+                                     nullptr);
+    if( hDstDS == nullptr )
+        return false;
+    double adfDstGT[6] = { 0.3, sOptions.dfScale, 0,
+                           -0.3, 0, -sOptions.dfScale };
+    GDALSetGeoTransform(hDstDS, adfDstGT);
+
+    TimingTransformerInfo sTimingInfo;
+    sTimingInfo.pfnTransformer = GDALGenImgProjTransform;
+    sTimingInfo.pTransformerArg =
+        GDALCreateGenImgProjTransformer2(hSrcDS, hDstDS, nullptr);
+    sTimingInfo.dfTime = 0;
+    sTimingInfo.nPoints = 0;
+    if( sTimingInfo.pTransformerArg == nullptr )
+    {
+        GDALClose(hDstDS);
+        return false;
+    }
+
+    // The kernel works on in-memory buffers: read the source dataset once.
+    std::vector<std::vector<GByte>> aabySrc(nBands);
+    std::vector<std::vector<GByte>> aabyDst(nBands);
+    std::vector<GByte*> apabySrc(nBands);
+    std::vector<GByte*> apabyDst(nBands);
+    for( int iBand = 0; iBand < nBands; iBand++ )
+    {
+        aabySrc[iBand].resize(nSrcPixels * nDTSize);
+        aabyDst[iBand].resize(nDstPixels * nDTSize);
+        apabySrc[iBand] = &aabySrc[iBand][0];
+        apabyDst[iBand] = &aabyDst[iBand][0];
+        CPL_IGNORE_RET_VAL(GDALRasterIO(
+            GDALGetRasterBand(hSrcDS, iBand + 1), GF_Read,
+            0, 0, nSrcXSize, nSrcYSize, apabySrc[iBand],
+            nSrcXSize, nSrcYSize, eDT, 0, 0));
+    }
+
+    // About 10% of invalid source pixels, and 20% of partially transparent
+    // ones.
+    const size_t nSrcMaskWords = (nSrcPixels + 31) / 32;
+    std::vector<GUInt32> anUnifiedSrcValid(nSrcMaskWords, 0);
+    std::vector<std::vector<GUInt32>> aanBandSrcValid(
+        nBands, std::vector<GUInt32>(nSrcMaskWords, 0));
+    std::vector<GUInt32*> apanBandSrcValid(nBands);
+    std::vector<float> afSrcDensity(nSrcPixels);
+    unsigned nSeed = 1;
+    for( size_t i = 0; i < nSrcPixels; i++ )
+    {
+        nSeed = nSeed * 1103515245U + 12345U;
+        const unsigned nRand = (nSeed >> 16) % 100;
+        if( nRand >= 10 )
+            anUnifiedSrcValid[i >> 5] |= 1U << (i & 31);
+        for( int iBand = 0; iBand < nBands; iBand++ )
+        {
+            if( (nRand + 7 * iBand) % 100 >= 10 )
+                aanBandSrcValid[iBand][i >> 5] |= 1U << (i & 31);
+        }
+        afSrcDensity[i] = nRand < 10 ? 0.0f : nRand < 30 ? 0.5f : 1.0f;
+    }
+    for( int iBand = 0; iBand < nBands; iBand++ )
+        apanBandSrcValid[iBand] = &aanBandSrcValid[iBand][0];
+    std::vector<GUInt32> anDstValid((nDstPixels + 31) / 32);
+    std::vector<float> afDstDensity(nDstPixels);
+
+    char** papszWarpOptions = CSLSetNameValue(nullptr, "NUM_THREADS", "1");
+
+    double dfTotalTime = 0;
+    GWKProfilingCounters sCounters;
+    GWKResetProfilingCounters();
+    bool bOK = true;
+    for( int iLoop = 0; bOK && iLoop < sOptions.nLoops; iLoop++ )
+    {
+        for( int iBand = 0; iBand < nBands; iBand++ )
+            std::fill(aabyDst[iBand].begin(), aabyDst[iBand].end(), 0);
+        std::fill(anDstValid.begin(), anDstValid.end(), 0);
+        std::fill(afDstDensity.begin(), afDstDensity.end(), 0.0f);
+
+        GDALWarpKernel oWK;
+        oWK.papszWarpOptions = papszWarpOptions;
+        oWK.eResample = eResample;
+        oWK.eWorkingDataType = eDT;
+        oWK.nBands = nBands;
+        oWK.nSrcXSize = nSrcXSize;
+        oWK.nSrcYSize = nSrcYSize;
+        oWK.papabySrcImage = &apabySrc[0];
+        oWK.nDstXSize = nDstXSize;
+        oWK.nDstYSize = nDstYSize;
+        oWK.papabyDstImage = &apabyDst[0];
+        if( eMask == MASK_UNIFIED_SRC_VALID )
+        {
+            oWK.panUnifiedSrcValid = &anUnifiedSrcValid[0];
+            oWK.panDstValid = &anDstValid[0];
+        }
+        else if( eMask == MASK_BAND_SRC_VALID )
+        {
+            oWK.papanBandSrcValid = &apanBandSrcValid[0];
+            oWK.panDstValid = &anDstValid[0];
+        }
+        else if( eMask == MASK_SRC_DST_DENSITY )
+        {
+            oWK.pafUnifiedSrcDensity = &afSrcDensity[0];
+            oWK.pafDstDensity = &afDstDensity[0];
+        }
+        oWK.pfnTransformer = TimingTransformer;
+        oWK.pTransformerArg = &sTimingInfo;
+        oWK.pfnProgress = GDALDummyProgress;
+
+        const auto oStart = std::chrono::steady_clock::now();
+        bOK = oWK.PerformWarp() == CE_None;
+        dfTotalTime += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - oStart).count();
+
+        // Owned by us.
+        oWK.papszWarpOptions = nullptr;
+    }
+    const bool bHasCounters = GWKGetProfilingCounters(&sCounters) != FALSE;
+
+    if( bOK )
+    {
+        const double dfPct = dfTotalTime > 0 ? 100.0 / dfTotalTime : 0.0;
+        printf("%-11s %-8s %-8s: %7.3f s, %8.2f Mpixels/s, "
+               "transform %5.1f%%",
+               apszResampleNames[eResample],
+               GDALGetDataTypeName(eDT), apszMaskNames[eMask],
+               dfTotalTime / sOptions.nLoops,
+               dfTotalTime > 0 ? static_cast<double>(nDstPixels) * nBands *
+                                 sOptions.nLoops / dfTotalTime / 1e6 : 0.0,
+               sTimingInfo.dfTime * dfPct);
+        if( bHasCounters )
+        {
+            const double dfOther = dfTotalTime - sTimingInfo.dfTime -
+                sCounters.dfGetPixelRowTime - sCounters.dfSetPixelTime;
+            printf(", fetch %5.1f%%, write %5.1f%%, other %5.1f%%",
+                   sCounters.dfGetPixelRowTime * dfPct,
+                   sCounters.dfSetPixelTime * dfPct,
+                   dfOther * dfPct);
+        }
+        printf("\n");
+    }
+    else
+    {
+        printf("%-11s %-8s %-8s: failed\n",
+               apszResampleNames[eResample],
+               GDALGetDataTypeName(eDT), apszMaskNames[eMask]);
+    }
+
+    CSLDestroy(papszWarpOptions);
+    GDALDestroyGenImgProjTransformer(sTimingInfo.pTransformerArg);
+    GDALClose(hDstDS);
+    return bOK;
+}
+
+} // namespace
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main( int argc, char* argv[] )
+{
+    argc = GDALGeneralCmdLineProcessor(argc, &argv, 0);
+    if( argc < 1 )
+        exit(-argc);
+
+    Options sOptions;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-src_size") && i + 2 < argc )
+        {
+            sOptions.nSrcXSize = atoi(argv[++i]);
+            sOptions.nSrcYSize = atoi(argv[++i]);
+        }
+        else if( EQUAL(argv[i], "-bands") && i + 1 < argc )
+            sOptions.nBands = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-scale") && i + 1 < argc )
+            sOptions.dfScale = CPLAtof(argv[++i]);
+        else if( EQUAL(argv[i], "-loops") && i + 1 < argc )
+            sOptions.nLoops = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-r") && i + 1 < argc )
+        {
+            const char* pszMethod = argv[++i];
+            int j = 0;
+            for( ; j < nResampleCount; j++ )
+            {
+                if( apszResampleNames[j] != nullptr &&
+                    EQUAL(pszMethod, apszResampleNames[j]) )
+                    break;
+            }
+            if( j == nResampleCount )
+            {
+                fprintf(stderr, "Unknown resampling method: %s\n", pszMethod);
+                Usage();
+            }
+            sOptions.aeResample.push_back(static_cast<GDALResampleAlg>(j));
+        }
+        else if( EQUAL(argv[i], "-ot") && i + 1 < argc )
+        {
+            const GDALDataType eDT = GDALGetDataTypeByName(argv[++i]);
+            if( eDT == GDT_Unknown )
+            {
+                fprintf(stderr, "Unknown data type: %s\n", argv[i]);
+                Usage();
+            }
+            sOptions.aeDataType.push_back(eDT);
+        }
+        else if( EQUAL(argv[i], "-mask") && i + 1 < argc )
+        {
+            ++i;
+            int j = MASK_NONE;
+            for( ; j <= MASK_SRC_DST_DENSITY; j++ )
+            {
+                if( EQUAL(argv[i], apszMaskNames[j]) )
+                    break;
+            }
+            if( j > MASK_SRC_DST_DENSITY )
+            {
+                fprintf(stderr, "Unknown mask configuration: %s\n", argv[i]);
+                Usage();
+            }
+            sOptions.aeMask.push_back(static_cast<MaskConfig>(j));
+        }
+        else
+        {
+            Usage();
+        }
+    }
+    if( sOptions.nSrcXSize <= 0 || sOptions.nSrcYSize <= 0 ||
+        sOptions.nBands <= 0 || sOptions.dfScale <= 0 ||
+        sOptions.nLoops <= 0 )
+    {
+        Usage();
+    }
+
+    if( sOptions.aeResample.empty() )
+    {
+        for( int j = 0; j < nResampleCount; j++ )
+        {
+            if( apszResampleNames[j] == nullptr )
+                continue;
+            sOptions.aeResample.push_back(static_cast<GDALResampleAlg>(j));
+        }
+    }
+    if( sOptions.aeDataType.empty() )
+    {
+        sOptions.aeDataType.push_back(GDT_Byte);
+        sOptions.aeDataType.push_back(GDT_Int16);
+        sOptions.aeDataType.push_back(GDT_UInt16);
+        sOptions.aeDataType.push_back(GDT_Float32);
+        sOptions.aeDataType.push_back(GDT_Float64);
+    }
+    if( sOptions.aeMask.empty() )
+    {
+        for( int j = MASK_NONE; j <= MASK_SRC_DST_DENSITY; j++ )
+            sOptions.aeMask.push_back(static_cast<MaskConfig>(j));
+    }
+
+    GDALAllRegister();
+
+    printf("Source %dx%d, %d band(s), destination %dx%d, %d loop(s)\n",
+           sOptions.nSrcXSize, sOptions.nSrcYSize, sOptions.nBands,
+           std::max(1, static_cast<int>(sOptions.nSrcXSize /
+                                        sOptions.dfScale)),
+           std::max(1, static_cast<int>(sOptions.nSrcYSize /
+                                        sOptions.dfScale)),
+           sOptions.nLoops);
+    {
+        GWKProfilingCounters sCounters;
+        if( !GWKGetProfilingCounters(&sCounters) )
+        {
+            printf("GDAL not built with -DGWK_PROFILING: no fetch/write "
+                   "time breakdown\n");
+        }
+    }
+
+    int nRet = 0;
+    for( GDALDataType eDT : sOptions.aeDataType )
+    {
+        GDALDatasetH hSrcDS = CreateSourceDataset(sOptions, eDT);
+        if( hSrcDS == nullptr )
+        {
+            nRet = 1;
+            continue;
+        }
+        for( GDALResampleAlg eResample : sOptions.aeResample )
+        {
+            for( MaskConfig eMask : sOptions.aeMask )
+            {
+                if( !RunOne(sOptions, hSrcDS, eResample, eDT, eMask) )
+                    nRet = 1;
+            }
+        }
+        GDALClose(hSrcDS);
+    }
+
+    CSLDestroy(argv);
+    GDALDestroyDriverManager();
+
+    return nRet;
+}
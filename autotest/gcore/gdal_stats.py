@@ -801,6 +801,61 @@ def stats_nodata_almost_max_float32():
 
     return 'success'
 
+###############################################################################
+# Test that multi-threaded statistics and histogram computation give the same
+# results as the single-threaded code path
+
+
+def stats_multithreaded():
+
+    # Blocks of 32x32 pixels, so that the 501 buckets histogram is
+    # small enough to be computed in worker threads, and 80 blocks.
+    xsize = 300
+    ysize = 250
+    for (dt, fmt, nodata) in [(gdal.GDT_Byte, 'B', 0),
+                              (gdal.GDT_Int16, 'h', -32768),
+                              (gdal.GDT_UInt32, 'I', None),
+                              (gdal.GDT_Float32, 'f', -9999),
+                              (gdal.GDT_Float64, 'd', None)]:
+        ds = gdal.GetDriverByName('GTiff').Create(
+            '/vsimem/stats_multithreaded.tif', xsize, ysize, 1, dt,
+            options=['TILED=YES', 'BLOCKXSIZE=32', 'BLOCKYSIZE=32'])
+        values = [((i * 7919) % 251) - (0 if dt in (gdal.GDT_Byte, gdal.GDT_UInt32) else 100)
+                  for i in range(xsize * ysize)]
+        if nodata is not None:
+            for i in range(0, xsize * ysize, 13):
+                values[i] = nodata
+            ds.GetRasterBand(1).SetNoDataValue(nodata)
+        ds.GetRasterBand(1).WriteRaster(0, 0, xsize, ysize,
+                                        struct.pack(fmt * (xsize * ysize), *values))
+        ds = None
+
+        res = []
+        for num_threads in ['1', '4']:
+            with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+                ds = gdal.Open('/vsimem/stats_multithreaded.tif')
+                stats = ds.GetRasterBand(1).ComputeStatistics(False)
+                hist = ds.GetRasterBand(1).GetHistogram(-200.5, 300.5, 501,
+                                                        approx_ok=0)
+                ds = None
+            res.append((stats, hist))
+
+        gdal.GetDriverByName('GTiff').Delete('/vsimem/stats_multithreaded.tif')
+
+        (stats_st, hist_st), (stats_mt, hist_mt) = res
+        if stats_st[0] != stats_mt[0] or stats_st[1] != stats_mt[1] or \
+           abs(stats_st[2] - stats_mt[2]) > 1e-10 * abs(stats_st[2]) or \
+           abs(stats_st[3] - stats_mt[3]) > 1e-10 * stats_st[3]:
+            gdaltest.post_reason('did not get expected stats')
+            print(dt, stats_st, stats_mt)
+            return 'fail'
+        if hist_st != hist_mt:
+            gdaltest.post_reason('did not get expected histogram')
+            print(dt)
+            return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # Run tests
 
@@ -829,6 +884,7 @@ gdaltest_list = [
     stats_byte_partial_tiles,
     stats_uint16,
     stats_nodata_almost_max_float32,
+    stats_multithreaded,
 ]
 
 if __name__ == '__main__':
@@ -36,7 +36,9 @@ from osgeo import osr
 from osgeo import gdal
 import shutil
 import array
+import random
 import stat
+import struct
 
 sys.path.append('../pymod')
 
@@ -2231,6 +2233,115 @@ def tiff_ovr_54():
 
     return 'success'
 
+###############################################################################
+# Test that multi-threaded overview computation gives the same result as
+# the single-threaded one
+
+
+def tiff_ovr_55():
+
+    src_ds = gdal.Open('../gdrivers/data/small_world.tif')
+
+    for interleave in ['BAND', 'PIXEL']:
+        for resampling in ['NEAREST', 'AVERAGE', 'GAUSS', 'CUBIC']:
+            cs = []
+            for num_threads in ['1', '4']:
+                filename = '/vsimem/tiff_ovr_55.tif'
+                gdal.GetDriverByName('GTiff').CreateCopy(filename, src_ds)
+                gdal.SetConfigOption('COMPRESS_OVERVIEW', 'DEFLATE')
+                gdal.SetConfigOption('INTERLEAVE_OVERVIEW', interleave)
+                gdal.SetConfigOption('GDAL_NUM_THREADS', num_threads)
+                ds = gdal.Open(filename)
+                ret = ds.BuildOverviews(resampling, [2, 4, 8])
+                ds = None
+                gdal.SetConfigOption('COMPRESS_OVERVIEW', None)
+                gdal.SetConfigOption('INTERLEAVE_OVERVIEW', None)
+                gdal.SetConfigOption('GDAL_NUM_THREADS', None)
+                if ret != 0:
+                    gdaltest.post_reason('fail')
+                    print(interleave, resampling, num_threads)
+                    return 'fail'
+
+                ds = gdal.Open(filename)
+                cs.append([[ds.GetRasterBand(i + 1).GetOverview(j).Checksum()
+                            for j in range(3)] for i in range(3)])
+                ds = None
+                gdal.GetDriverByName('GTiff').Delete(filename)
+
+            if cs[0] != cs[1]:
+                gdaltest.post_reason('fail')
+                print(interleave, resampling)
+                print(cs)
+                return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test the optimized code paths of AVERAGE (regular factors of 2 and more,
+# without nodata) and of MODE on Byte data, against a direct computation.
+
+
+def tiff_ovr_56():
+
+    random.seed(0)
+    xsize = 72
+    ysize = 36
+    for (dt, fmt, values) in [
+            (gdal.GDT_Byte, 'B', [0, 1, 2, 127, 128, 254, 255]),
+            (gdal.GDT_UInt16, 'H', [0, 1, 2, 32767, 32768, 65534, 65535]),
+            (gdal.GDT_Float32, 'f', [0.0, 0.1, -1.5, 12345.678, 1e10])]:
+        data = [random.choice(values) for i in range(xsize * ysize)]
+        # Round-trip through the data type
+        data = list(struct.unpack('<' + fmt * len(data),
+                                  struct.pack('<' + fmt * len(data), *data)))
+        for (resampling, factor) in [('AVERAGE', 2), ('AVERAGE', 4),
+                                     ('MODE', 2), ('MODE', 3)]:
+            if resampling == 'MODE' and dt != gdal.GDT_Byte:
+                continue
+            filename = '/vsimem/tiff_ovr_56.tif'
+            ds = gdal.GetDriverByName('GTiff').Create(filename, xsize, ysize,
+                                                      1, dt)
+            ds.GetRasterBand(1).WriteRaster(
+                0, 0, xsize, ysize,
+                struct.pack('<' + fmt * len(data), *data))
+            ds.BuildOverviews(resampling, [factor])
+            ovr = ds.GetRasterBand(1).GetOverview(0)
+            ovr_xsize = ovr.XSize
+            ovr_ysize = ovr.YSize
+            got = struct.unpack('<' + fmt * (ovr_xsize * ovr_ysize),
+                                ovr.ReadRaster())
+            ds = None
+            gdal.GetDriverByName('GTiff').Delete(filename)
+
+            for y in range(ovr_ysize):
+                for x in range(ovr_xsize):
+                    window = [data[(y * factor + j) * xsize + x * factor + i]
+                              for j in range(factor) for i in range(factor)]
+                    if resampling == 'MODE':
+                        counts = {}
+                        expected = None
+                        for v in window:
+                            counts[v] = counts.get(v, 0) + 1
+                            if expected is None or \
+                               counts[v] > counts[expected]:
+                                expected = v
+                    elif dt == gdal.GDT_Float32:
+                        total = 0.0
+                        for v in window:
+                            total += v
+                        expected = struct.unpack(
+                            '<f', struct.pack('<f', total / len(window)))[0]
+                    else:
+                        expected = (sum(window) + len(window) // 2) // \
+                            len(window)
+                    if got[y * ovr_xsize + x] != expected:
+                        gdaltest.post_reason('fail')
+                        print(dt, resampling, factor, x, y, window)
+                        print(got[y * ovr_xsize + x], expected)
+                        return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # Cleanup
 
@@ -2354,7 +2465,9 @@ gdaltest_list.append(tiff_ovr_restore_endianness)
 gdaltest_list += [tiff_ovr_51,
                   tiff_ovr_52,
                   tiff_ovr_53,
-                  tiff_ovr_54]
+                  tiff_ovr_54,
+                  tiff_ovr_55,
+                  tiff_ovr_56]
 
 if __name__ == '__main__':
 
@@ -3760,6 +3760,56 @@ def tiff_read_1bit_2bands():
     return 'success'
 
 ###############################################################################
+# Test multi-threaded decoding of blocks with GDAL_NUM_THREADS
+
+
+def tiff_read_multi_threaded():
+
+    src_ds = gdal.Open('data/rgbsmall.tif')
+    for options in [['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16'],
+                    ['BLOCKYSIZE=3'],
+                    ['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16',
+                     'INTERLEAVE=BAND'],
+                    ['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16',
+                     'COMPRESS=JPEG', 'PHOTOMETRIC=YCBCR']]:
+        if 'COMPRESS=JPEG' not in options:
+            options = options + ['COMPRESS=DEFLATE']
+        elif gdal.GetDriverByName('GTiff').GetMetadataItem(
+                'DMD_CREATIONOPTIONLIST').find('JPEG') == -1:
+            continue
+        gdal.GetDriverByName('GTiff').CreateCopy(
+            '/vsimem/tiff_read_multi_threaded.tif', src_ds, options=options)
+
+        ds = gdal.Open('/vsimem/tiff_read_multi_threaded.tif')
+        ref_data = ds.ReadRaster()
+        ref_data_band2 = ds.GetRasterBand(2).ReadRaster(1, 2, 45, 47)
+        ds = None
+
+        with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+            ds = gdal.Open('/vsimem/tiff_read_multi_threaded.tif')
+            data_band2 = ds.GetRasterBand(2).ReadRaster(1, 2, 45, 47)
+            data = ds.ReadRaster()
+            ds = None
+        if data != ref_data or data_band2 != ref_data_band2:
+            gdaltest.post_reason('fail')
+            print(options)
+            return 'fail'
+
+        ds = gdal.OpenEx('/vsimem/tiff_read_multi_threaded.tif',
+                         open_options=['NUM_THREADS=4'])
+        data = ds.ReadRaster()
+        data_band2 = ds.GetRasterBand(2).ReadRaster(1, 2, 45, 47)
+        ds = None
+        if data != ref_data or data_band2 != ref_data_band2:
+            gdaltest.post_reason('fail')
+            print(options)
+            return 'fail'
+
+        gdal.Unlink('/vsimem/tiff_read_multi_threaded.tif')
+
+    return 'success'
+
+###############################################################################
 
 
 for item in init_list:
@@ -3888,6 +3938,7 @@ gdaltest_list.append((tiff_read_zstd))
 gdaltest_list.append((tiff_read_zstd_corrupted))
 gdaltest_list.append((tiff_read_zstd_corrupted2))
 gdaltest_list.append((tiff_read_1bit_2bands))
+gdaltest_list.append((tiff_read_multi_threaded))
 
 gdaltest_list.append((tiff_read_online_1))
 gdaltest_list.append((tiff_read_online_2))
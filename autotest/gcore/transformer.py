@@ -933,6 +933,150 @@ def transformer_17():
         return 'fail'
     return 'success'
 
+###############################################################################
+# Test RPC DEM spanning several tiles of the DEM cache, shared by several
+# transformers, and batch evaluation of the RPC polynomials
+
+
+def transformer_18():
+
+    ds = gdal.Open('data/rpc.vrt')
+
+    ds_dem = gdal.GetDriverByName('GTiff').Create('/vsimem/transformer_18_dem.tif', 600, 600, 1, gdal.GDT_Byte)
+    sr = osr.SpatialReference()
+    sr.ImportFromEPSG(4326)
+    ds_dem.SetProjection(sr.ExportToWkt())
+    ds_dem.SetGeoTransform([125.647968621436, 2e-6, 0, 39.869926216038, 0, -2e-6])
+    import random
+    random.seed(0)
+    data = ''.join([chr(40 + int(10 * random.random())) for _ in range(600 * 600)])
+    ds_dem.GetRasterBand(1).WriteRaster(0, 0, 600, 600, data)
+    ds_dem = None
+
+    points = [(125.6481 + 0.0009 * i / 9, 39.8690 + 0.0008 * j / 9)
+              for j in range(10) for i in range(10)]
+
+    with gdaltest.config_option('GDAL_RPC_DEM_CACHE_MAX', '1'):
+        tr1 = gdal.Transformer(ds, None, ['METHOD=RPC', 'RPC_DEM=/vsimem/transformer_18_dem.tif'])
+        tr2 = gdal.Transformer(ds, None, ['METHOD=RPC', 'RPC_DEM=/vsimem/transformer_18_dem.tif'])
+
+    (pnts, success) = tr1.TransformPoints(1, points)
+    for i, (x, y) in enumerate(points):
+        (success2, pnt) = tr2.TransformPoint(1, x, y, 0)
+        if not success[i] or not success2 or \
+           abs(pnt[0] - pnts[i][0]) > 1e-8 or \
+           abs(pnt[1] - pnts[i][1]) > 1e-8:
+            gdaltest.post_reason('fail')
+            print(i, pnt, pnts[i])
+            return 'fail'
+
+    tr1 = None
+    tr2 = None
+    gdal.Unlink('/vsimem/transformer_18_dem.tif')
+
+    # Batches going through the shared DEM cache against the reference
+    # coordinates of transformer_5
+    ds_dem = gdal.GetDriverByName('GTiff').Create('/vsimem/transformer_18_dem.tif', 100, 100, 1)
+    sr = osr.SpatialReference()
+    sr.ImportFromEPSG(32652)
+    ds_dem.SetProjection(sr.ExportToWkt())
+    ds_dem.SetGeoTransform([213300, 200, 0, 4418700, 0, -200])
+    ds_dem.GetRasterBand(1).Fill(15)
+    ds_dem = None
+
+    for (method, ref) in [('bilinear', (125.64828521533849, 39.869345204440144)),
+                          ('cubic', (125.64828521533849, 39.869345204440144)),
+                          ('near', (125.64828521503811, 39.869345204874911))]:
+        with gdaltest.config_option('GDAL_RPC_DEM_CACHE_MAX', '1'):
+            tr1 = gdal.Transformer(ds, None, ['METHOD=RPC', 'RPC_HEIGHT_SCALE=2', 'RPC_DEM=/vsimem/transformer_18_dem.tif', 'RPC_DEMINTERPOLATION=' + method])
+            tr2 = gdal.Transformer(ds, None, ['METHOD=RPC', 'RPC_HEIGHT_SCALE=2', 'RPC_DEM=/vsimem/transformer_18_dem.tif', 'RPC_DEMINTERPOLATION=' + method])
+
+        for tr in (tr1, tr2):
+            (pnts, success) = tr.TransformPoints(0, [(20.5, 10.5, 0), (10.5, 5.5, 0), (20.5, 10.5, 0)])
+            for i in (0, 2):
+                if not success[i] or \
+                   abs(pnts[i][0] - ref[0]) > 0.000001 or \
+                   abs(pnts[i][1] - ref[1]) > 0.000001:
+                    gdaltest.post_reason('got wrong forward transform result')
+                    print(method, i, success[i], pnts[i])
+                    return 'fail'
+
+            (pnts, success) = tr.TransformPoints(1, pnts)
+            for i in (0, 2):
+                if not success[i] or \
+                   abs(pnts[i][0] - 20.5) > 0.05 or \
+                   abs(pnts[i][1] - 10.5) > 0.05:
+                    gdaltest.post_reason('got wrong reverse transform result')
+                    print(method, i, success[i], pnts[i])
+                    return 'fail'
+            if not success[1] or \
+               abs(pnts[1][0] - 10.5) > 0.05 or \
+               abs(pnts[1][1] - 5.5) > 0.05:
+                gdaltest.post_reason('got wrong reverse transform result')
+                print(method, success[1], pnts[1])
+                return 'fail'
+
+        tr1 = None
+        tr2 = None
+
+    gdal.Unlink('/vsimem/transformer_18_dem.tif')
+
+    return 'success'
+
+###############################################################################
+# Test the LOCAL method of the TPS transformer
+
+
+def transformer_19():
+
+    import math
+    import random
+    random.seed(0)
+    gcps = []
+    for _ in range(1000):
+        pixel = random.random() * 1000
+        line = random.random() * 800
+        x = 440000 + 30 * pixel + 200 * math.sin(pixel / 50) + 3 * line
+        y = 3750000 - 30 * line + 100 * math.cos(line / 40)
+        gcps.append(gdal.GCP(x, y, 0, pixel, line))
+    ds = gdal.GetDriverByName('MEM').Create('', 1000, 800)
+    sr = osr.SpatialReference()
+    sr.ImportFromEPSG(32611)
+    ds.SetGCPs(gcps, sr.ExportToWkt())
+
+    tr_full = gdal.Transformer(ds, None, ['METHOD=GCP_TPS'])
+    tr_local = gdal.Transformer(ds, None, ['METHOD=GCP_TPS',
+                                           'TPS_METHOD=LOCAL',
+                                           'TPS_LOCAL_POINTS=50'])
+
+    # Exact at the control points
+    for gcp in gcps[0:100]:
+        (success, pnt) = tr_local.TransformPoint(0, gcp.GCPPixel, gcp.GCPLine)
+        if not success or abs(pnt[0] - gcp.GCPX) > 1e-2 or \
+           abs(pnt[1] - gcp.GCPY) > 1e-2:
+            gdaltest.post_reason('fail')
+            print(gcp, pnt)
+            return 'fail'
+        (success, pnt) = tr_local.TransformPoint(1, gcp.GCPX, gcp.GCPY)
+        if not success or abs(pnt[0] - gcp.GCPPixel) > 1e-2 or \
+           abs(pnt[1] - gcp.GCPLine) > 1e-2:
+            gdaltest.post_reason('fail')
+            print(gcp, pnt)
+            return 'fail'
+
+    # Close to the global spline between them
+    for (pixel, line) in [(10.5, 20.5), (500.25, 400.75), (990.0, 790.0)]:
+        (_, pnt_full) = tr_full.TransformPoint(0, pixel, line)
+        (_, pnt_local) = tr_local.TransformPoint(0, pixel, line)
+        if abs(pnt_full[0] - pnt_local[0]) > 30 or \
+           abs(pnt_full[1] - pnt_local[1]) > 30:
+            gdaltest.post_reason('fail')
+            print(pixel, line, pnt_full, pnt_local)
+            return 'fail'
+
+    return 'success'
+
+
 
 gdaltest_list = [
     transformer_1,
@@ -951,7 +1095,9 @@ gdaltest_list = [
     transformer_14,
     transformer_15,
     transformer_16,
-    transformer_17
+    transformer_17,
+    transformer_18,
+    transformer_19
 ]
 
 disabled_gdaltest_list = [
@@ -182,11 +182,63 @@ def derived_test3():
 
     return 'success'
 
+###############################################################################
+# Test terrain products
+
+
+def derived_test4():
+
+    src_ds = gdal.Open('data/n43.dt0')
+    for name, open_options, options in [
+            ('HILLSHADE', ['SCALE=111120', 'Z_FACTOR=30'],
+             {'scale': 111120, 'zFactor': 30}),
+            ('MULTIDIRECTIONAL_HILLSHADE', ['COMPUTE_EDGES=YES'],
+             {'multiDirectional': True, 'computeEdges': True}),
+            ('SLOPE', ['ALG=ZevenbergenThorne', 'SLOPE_FORMAT=PERCENT'],
+             {'alg': 'ZevenbergenThorne', 'slopeFormat': 'percent'}),
+            ('ASPECT', ['ZERO_FOR_FLAT=YES'], {'zeroForFlat': True})]:
+        processing = 'aspect' if name == 'ASPECT' else \
+                     'slope' if name == 'SLOPE' else 'hillshade'
+        ref_ds = gdal.DEMProcessing('', src_ds, processing, format='MEM',
+                                    **options)
+        ds = gdal.OpenEx('DERIVED_SUBDATASET:%s:data/n43.dt0' % name,
+                         open_options=open_options)
+        if ds is None:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        if ds.GetRasterBand(1).DataType != ref_ds.GetRasterBand(1).DataType:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        if ds.GetGeoTransform() != src_ds.GetGeoTransform():
+            gdaltest.post_reason('fail')
+            return 'fail'
+        cs = ds.GetRasterBand(1).Checksum()
+        ref_cs = ref_ds.GetRasterBand(1).Checksum()
+        if cs != ref_cs:
+            gdaltest.post_reason('fail')
+            print(name, cs, ref_cs)
+            return 'fail'
+
+    for name, open_options in [('SLOPE', ['SLOPE_FORMAT=invalid']),
+                               ('SLOPE', ['ALG=invalid']),
+                               ('SLOPE', ['COMBINED=YES']),
+                               ('ASPECT', ['BAND=2'])]:
+        with gdaltest.error_handler():
+            ds = gdal.OpenEx('DERIVED_SUBDATASET:%s:data/n43.dt0' % name,
+                             open_options=open_options)
+        if ds is not None:
+            gdaltest.post_reason('fail')
+            print(name, open_options)
+            return 'fail'
+
+    return 'success'
+
 
 gdaltest_list = [
     derived_test1,
     derived_test2,
-    derived_test3
+    derived_test3,
+    derived_test4
 ]
 
 if __name__ == '__main__':
@@ -610,6 +610,174 @@ def test_gdaldem_lib_nodata():
 
     return 'success'
 
+###############################################################################
+# Test the strip based processing, single and multi-threaded, on a raster
+# of several strips
+
+
+def test_gdaldem_lib_multithreaded():
+
+    import math
+
+    # 600x1200 pixels are processed as 3 strips of 436 lines.
+    xsize = 600
+    ysize = 1200
+    data = []
+    for j in range(ysize):
+        for i in range(xsize):
+            data.append(500 + 200 * math.sin(j * 0.01) * math.cos(i * 0.013) +
+                        (i * 7 + j * 13) % 5)
+
+    # Checksums of the outputs of the line by line implementation that
+    # preceded the strip based one.
+    for typ, fmt, expected in [
+            (gdal.GDT_Int16, 'h', [17002, 3179, 57468, 14791, 63082]),
+            (gdal.GDT_Float32, 'f', [54600, 28809, 28771, 27978, 20392])]:
+        src_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1, typ)
+        src_ds.SetGeoTransform([0, 2, 0, 0, 0, -2])
+        src_ds.GetRasterBand(1).SetNoDataValue(0)
+        src_ds.GetRasterBand(1).WriteRaster(
+            0, 0, xsize, ysize,
+            struct.pack(fmt * (xsize * ysize),
+                        *[int(v) if fmt == 'h' else v for v in data]))
+        src_ds.GetRasterBand(1).WriteRaster(
+            10, ysize // 2, 1, 1, struct.pack(fmt, 0))
+
+        for (mode, options), expected_cs in zip(
+                [('hillshade', {}),
+                 ('hillshade', {'alg': 'ZevenbergenThorne'}),
+                 ('hillshade', {'computeEdges': True}),
+                 ('slope', {}),
+                 ('TPI', {})], expected):
+            for num_threads in ['1', '4']:
+                with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+                    cs = gdal.DEMProcessing(
+                        '', src_ds, mode, format='MEM',
+                        **options).GetRasterBand(1).Checksum()
+                if cs != expected_cs:
+                    gdaltest.post_reason('Bad checksum')
+                    print(typ, mode, options, num_threads, cs, expected_cs)
+                    return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test on-the-fly computation with the VRT output format
+
+
+def test_gdaldem_lib_vrt():
+
+    src_ds = gdal.Open('../gdrivers/data/n43.dt0')
+    for mode, options in [('hillshade', {'scale': 111120, 'zFactor': 30}),
+                          ('hillshade', {'multiDirectional': True}),
+                          ('hillshade', {'alg': 'ZevenbergenThorne',
+                                         'computeEdges': True}),
+                          ('slope', {'slopeFormat': 'percent'}),
+                          ('aspect', {'trigonometric': True})]:
+        ref_cs = gdal.DEMProcessing(
+            '', src_ds, mode, format='MEM',
+            **options).GetRasterBand(1).Checksum()
+
+        # Dataset computed on the fly
+        ds = gdal.DEMProcessing('', src_ds, mode, format='VRT', **options)
+        if ds.GetRasterBand(1).GetBlockSize() != [121, 121]:
+            gdaltest.post_reason('Bad block size')
+            print(ds.GetRasterBand(1).GetBlockSize())
+            return 'fail'
+        cs = ds.GetRasterBand(1).Checksum()
+        ds = None
+        if cs != ref_cs:
+            gdaltest.post_reason('Bad checksum')
+            print(mode, options, cs, ref_cs)
+            return 'fail'
+
+        # VRT file referencing the DERIVED_SUBDATASET
+        gdal.DEMProcessing('tmp/test_gdaldem_lib_vrt.vrt', src_ds, mode,
+                           format='VRT', **options)
+        ds = gdal.Open('tmp/test_gdaldem_lib_vrt.vrt')
+        cs = ds.GetRasterBand(1).Checksum()
+        ds = None
+        if cs != ref_cs:
+            gdaltest.post_reason('Bad checksum')
+            print(mode, options, cs, ref_cs)
+            return 'fail'
+
+    gdal.Unlink('tmp/test_gdaldem_lib_vrt.vrt')
+
+    with gdaltest.error_handler():
+        ds = gdal.DEMProcessing('', src_ds, 'TPI', format='VRT')
+    if ds is not None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that the tiled on-the-fly computation matches the strip based one,
+# with -compute_edges and a source nodata value
+
+
+def test_gdaldem_lib_tiled_compute_edges_nodata():
+
+    xsize = 600
+    ysize = 300
+    data = [20 + (i * 3 + j * 7) % 50 for j in range(ysize) for i in range(xsize)]
+    # Values extrapolated at the left and right edges of those lines are
+    # equal to the nodata value.
+    for j in range(50, 60):
+        data[j * xsize] = data[j * xsize + xsize - 1] = 5
+        data[j * xsize + 1] = data[j * xsize + xsize - 2] = 10
+    data[200 * xsize + 300] = 0
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1,
+                                                gdal.GDT_Float32)
+    src_ds.SetGeoTransform([0, 1, 0, 0, 0, -1])
+    src_ds.GetRasterBand(1).SetNoDataValue(0)
+    src_ds.GetRasterBand(1).WriteRaster(
+        0, 0, xsize, ysize, struct.pack('f' * (xsize * ysize), *data))
+
+    # Strips
+    ref_ds = gdal.DEMProcessing('', src_ds, 'hillshade', format='MEM',
+                                computeEdges=True)
+    ref_data = ref_ds.GetRasterBand(1).ReadRaster()
+    # Output of the line by line implementation that preceded the strip
+    # based one.
+    cs = ref_ds.GetRasterBand(1).Checksum()
+    if cs != 39527:
+        gdaltest.post_reason('Bad checksum')
+        print(cs)
+        return 'fail'
+    val = struct.unpack('B', ref_ds.GetRasterBand(1).ReadRaster(0, 55, 1, 1))[0]
+    if val != 186:
+        gdaltest.post_reason('Bad value')
+        print(val)
+        return 'fail'
+    ref_ds = None
+
+    # Tiles computed on the fly
+    ds = gdal.DEMProcessing('', src_ds, 'hillshade', format='VRT',
+                            computeEdges=True)
+    if ds.GetRasterBand(1).GetBlockSize() != [256, 256]:
+        gdaltest.post_reason('Bad block size')
+        print(ds.GetRasterBand(1).GetBlockSize())
+        return 'fail'
+    if ds.GetRasterBand(1).ReadRaster() != ref_data:
+        gdaltest.post_reason('Tiled output differs from strip output')
+        return 'fail'
+    ds = None
+
+    # Tiles written with CreateCopy()
+    ds = gdal.DEMProcessing('/vsimem/test_gdaldem_lib_tiled.tif', src_ds,
+                            'hillshade', format='GTiff', computeEdges=True,
+                            creationOptions=['TILED=YES', 'COMPRESS=DEFLATE'])
+    if ds.GetRasterBand(1).ReadRaster() != ref_data:
+        gdaltest.post_reason('Tiled output differs from strip output')
+        return 'fail'
+    ds = None
+    gdal.Unlink('/vsimem/test_gdaldem_lib_tiled.tif')
+
+    return 'success'
+
 
 gdaltest_list = [
     test_gdaldem_lib_hillshade,
@@ -629,7 +797,10 @@ gdaltest_list = [
     test_gdaldem_lib_roughness,
     test_gdaldem_lib_slope_ZevenbergenThorne,
     test_gdaldem_lib_aspect_ZevenbergenThorne,
-    test_gdaldem_lib_nodata
+    test_gdaldem_lib_nodata,
+    test_gdaldem_lib_multithreaded,
+    test_gdaldem_lib_vrt,
+    test_gdaldem_lib_tiled_compute_edges_nodata
 ]
 
 
@@ -235,6 +235,19 @@ int  CPL_DLL GDALApproxTransform(
     void *pTransformArg, int bDstToSrc, int nPointCount,
     double *x, double *y, double *z, int *panSuccess );
 
+/* Grid transformer, interpolating a cached grid of another transformer */
+void CPL_DLL *
+GDALCreateGridTransformer( GDALTransformerFunc pfnBaseTransformer,
+                           void *pBaseTransformArg,
+                           int nDstXSize, int nDstYSize,
+                           int nStep, double dfMaxError );
+void CPL_DLL GDALGridTransformerOwnsSubtransformer( void *pTransformArg,
+                                                    int bOwnFlag );
+void CPL_DLL GDALDestroyGridTransformer( void *pTransformArg );
+int  CPL_DLL GDALGridTransform(
+    void *pTransformArg, int bDstToSrc, int nPointCount,
+    double *x, double *y, double *z, int *panSuccess );
+
 int CPL_DLL CPL_STDCALL
 GDALSimpleImageWarp( GDALDatasetH hSrcDS,
                      GDALDatasetH hDstDS,
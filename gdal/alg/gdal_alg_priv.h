@@ -97,6 +97,22 @@ void GDALdllImageFilledPolygon( int nRasterXSize, int nRasterYSize,
                                 double *padfVariant,
                                 llScanlineFunc pfnScanlineFunc, void *pCBData );
 
+/************************************************************************/
+/*      Warp kernel profiling (only when built with -DGWK_PROFILING).   */
+/************************************************************************/
+
+/** Time spent in the warp kernel source fetching and destination writing
+ * helpers. */
+typedef struct {
+    /*! Number of calls to GWKGetPixelRow() */  GUIntBig nGetPixelRowCalls;
+    /*! Time spent in GWKGetPixelRow(), in s */  double   dfGetPixelRowTime;
+    /*! Number of calls to GWKSetPixelValue*() */ GUIntBig nSetPixelCalls;
+    /*! Time spent in GWKSetPixelValue*(), in s */ double  dfSetPixelTime;
+} GWKProfilingCounters;
+
+void CPL_DLL GWKResetProfilingCounters( void );
+int CPL_DLL GWKGetProfilingCounters( GWKProfilingCounters* psCounters );
+
 CPL_C_END
 
 /************************************************************************/
@@ -130,7 +146,9 @@ public:
                           GInt32 *panLastLineId,  GInt32 *panThisLineId,
                           int nXSize );
 
+    int      ResolveMerges();
     void     CompleteMerges();
+    void     KeepPolygons( const GInt32 *panPolyIds, int nPolyCount );
 
     void     Clear();
 };
@@ -151,6 +169,8 @@ void CPL_DLL GDALUnregisterTransformDeserializer(void* pData);
 
 void GDALCleanupTransformDeserializerMutex();
 
+void GDALCleanupGridTransformerCache();
+
 /* Transformer cloning */
 
 void* GDALCreateTPSTransformerInt( int nGCPCount, const GDAL_GCP *pasGCPList,
@@ -158,6 +178,48 @@ void* GDALCreateTPSTransformerInt( int nGCPCount, const GDAL_GCP *pasGCPList,
 
 void CPL_DLL * GDALCloneTransformer( void *pTransformerArg );
 
+/************************************************************************/
+/*      DEM processing (3x3 algorithms of gdaldem)                      */
+/************************************************************************/
+
+typedef enum {
+    GDEM_HILLSHADE,
+    GDEM_SLOPE,
+    GDEM_ASPECT,
+    GDEM_TRI,
+    GDEM_TPI,
+    GDEM_ROUGHNESS
+} GDALDEMAlgorithm;
+
+/** Settings of a 3x3 DEM algorithm, with the defaults of gdaldem. */
+struct GDALDEMAlgOptions
+{
+    GDALDEMAlgorithm eAlg = GDEM_HILLSHADE;
+    double z = 1.0;
+    double scale = 1.0;
+    double az = 315.0;
+    double alt = 45.0;
+    /*! 0 for percent, 1 for degrees */ int slopeFormat = 1;
+    bool bZevenbergenThorne = false;
+    bool bCombined = false;
+    bool bMultiDirectional = false;
+    bool bAngleAsAzimuth = true;
+    bool bZeroForFlat = false;
+    bool bComputeAtEdges = false;
+};
+
+GDALDataType GDALDEMGetOutputDataType( const GDALDEMAlgOptions* psOptions );
+bool GDALDEMGetOutputNoData( const GDALDEMAlgOptions* psOptions,
+                             double* pdfNoDataValue );
+CPLErr GDALDEMProcessBand( GDALRasterBandH hSrcBand,
+                           GDALRasterBandH hDstBand,
+                           const double* padfGeoTransform,
+                           const GDALDEMAlgOptions* psOptions,
+                           GDALProgressFunc pfnProgress,
+                           void* pProgressData );
+GDALDatasetH GDALDEMCreateOnTheFlyDataset( GDALDatasetH hSrcDS, int nBand,
+                                           const GDALDEMAlgOptions* psOptions );
+
 /************************************************************************/
 /*      Color table related                                             */
 /************************************************************************/
@@ -36,11 +36,17 @@
 #include <cstring>
 
 #include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_mem_cache.h"
 #include "cpl_minixml.h"
+#include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
@@ -204,6 +210,314 @@ static void RPCComputeTerms( double dfLong, double dfLat, double dfHeight,
 /* ==================================================================== */
 /************************************************************************/
 
+/************************************************************************/
+/*                              GDALRPCDEM                              */
+/************************************************************************/
+
+// Size, in pixels, of the side of the tiles of the DEM cache.
+constexpr int RPC_DEM_TILE_SIZE = 256;
+
+// Tile of elevation values read from the DEM. Immutable once created, so it
+// can be used without locking by the transformers holding a reference on it.
+struct GDALRPCDEMTile
+{
+    int nTileX = 0;
+    int nTileY = 0;
+    int nXOff = 0;
+    int nYOff = 0;
+    int nXSize = 0;
+    int nYSize = 0;
+    std::vector<double> adfData{};
+};
+
+typedef std::shared_ptr<const GDALRPCDEMTile> GDALRPCDEMTilePtr;
+
+// A DEM opened once per process (for a given path), and shared by all RPC
+// transformers using it, including the clones created for each warping
+// thread. Access to the dataset and to the tile cache is serialized by a
+// mutex.
+class GDALRPCDEM
+{
+    CPLString    m_osKey;
+    GDALDataset *m_poDS = nullptr;
+    int          m_nTilesX = 0;
+    std::mutex   m_oMutex{};
+    lru11::Cache<GIntBig, GDALRPCDEMTilePtr> m_oCache;
+
+    GDALRPCDEM( const GDALRPCDEM& ) = delete;
+    GDALRPCDEM& operator=( const GDALRPCDEM& ) = delete;
+
+    GDALRPCDEMTilePtr GetTile( int nTileX, int nTileY );
+
+  public:
+    int          nRasterXSize = 0;
+    int          nRasterYSize = 0;
+    int          bGotNoDataValue = FALSE;
+    double       dfNoDataValue = 0.0;
+    CPLString    osSRS{};
+    bool         bHasGeoTransform = false;
+    double       adfGeoTransform[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+
+    GDALRPCDEM( const CPLString& osKey, GDALDataset *poDS,
+                size_t nMaxTiles );
+    ~GDALRPCDEM();
+
+    bool ReadWindow( int nX, int nY, int nWidth, int nHeight,
+                     double *padfOut, GDALRPCDEMTilePtr &poLastTile );
+
+    static std::shared_ptr<GDALRPCDEM> Acquire( const char *pszDEMPath,
+                                                bool bApplyVDatumShift );
+};
+
+// Registry of the DEMs currently in use. Entries expire when the last
+// transformer using a DEM is destroyed.
+static CPLMutex *hRPCDEMMutex = nullptr;
+static std::map<CPLString, std::weak_ptr<GDALRPCDEM>> *poRPCDEMMap = nullptr;
+
+/************************************************************************/
+/*                             GDALRPCDEM()                             */
+/************************************************************************/
+
+GDALRPCDEM::GDALRPCDEM( const CPLString& osKey, GDALDataset *poDS,
+                        size_t nMaxTiles ) :
+    m_osKey(osKey),
+    m_poDS(poDS),
+    m_nTilesX(DIV_ROUND_UP(poDS->GetRasterXSize(), RPC_DEM_TILE_SIZE)),
+    m_oCache(nMaxTiles, 0),
+    nRasterXSize(poDS->GetRasterXSize()),
+    nRasterYSize(poDS->GetRasterYSize())
+{
+    dfNoDataValue =
+        poDS->GetRasterBand(1)->GetNoDataValue( &bGotNoDataValue );
+    const char *pszSRS = poDS->GetProjectionRef();
+    if( pszSRS != nullptr )
+        osSRS = pszSRS;
+    bHasGeoTransform = poDS->GetGeoTransform(adfGeoTransform) == CE_None;
+}
+
+/************************************************************************/
+/*                            ~GDALRPCDEM()                             */
+/************************************************************************/
+
+GDALRPCDEM::~GDALRPCDEM()
+{
+    GDALClose( m_poDS );
+
+    CPLMutexHolderD( &hRPCDEMMutex );
+    if( poRPCDEMMap )
+    {
+        auto oIter = poRPCDEMMap->find(m_osKey);
+        if( oIter != poRPCDEMMap->end() && oIter->second.expired() )
+            poRPCDEMMap->erase(oIter);
+        if( poRPCDEMMap->empty() )
+        {
+            delete poRPCDEMMap;
+            poRPCDEMMap = nullptr;
+        }
+    }
+}
+
+/************************************************************************/
+/*                              Acquire()                               */
+/************************************************************************/
+
+std::shared_ptr<GDALRPCDEM> GDALRPCDEM::Acquire( const char *pszDEMPath,
+                                                 bool bApplyVDatumShift )
+{
+    // Do not reuse cached tiles of a file that has been modified since.
+    CPLString osKey(pszDEMPath);
+    VSIStatBufL sStat;
+    if( VSIStatL(pszDEMPath, &sStat) == 0 )
+    {
+        osKey += CPLSPrintf("|" CPL_FRMT_GIB "|" CPL_FRMT_GIB,
+                            static_cast<GIntBig>(sStat.st_mtime),
+                            static_cast<GIntBig>(sStat.st_size));
+    }
+    if( bApplyVDatumShift )
+        osKey += "|VDATUM_SHIFT";
+
+    CPLMutexHolderD( &hRPCDEMMutex );
+    if( poRPCDEMMap == nullptr )
+        poRPCDEMMap = new std::map<CPLString, std::weak_ptr<GDALRPCDEM>>();
+    auto oIter = poRPCDEMMap->find(osKey);
+    if( oIter != poRPCDEMMap->end() )
+    {
+        std::shared_ptr<GDALRPCDEM> poDEM = oIter->second.lock();
+        if( poDEM )
+            return poDEM;
+    }
+
+    CPLString osPrevValueConfigOption;
+    if( bApplyVDatumShift )
+    {
+        osPrevValueConfigOption
+            = CPLGetThreadLocalConfigOption("GTIFF_REPORT_COMPD_CS", "");
+        CPLSetThreadLocalConfigOption("GTIFF_REPORT_COMPD_CS", "YES");
+    }
+    GDALDataset *poDS = nullptr;
+    {
+        CPLConfigOptionSetter oSetter("CPL_ALLOW_VSISTDIN", "NO", true);
+        poDS = reinterpret_cast<GDALDataset *>(
+            GDALOpen(pszDEMPath, GA_ReadOnly));
+    }
+    if( bApplyVDatumShift )
+    {
+        CPLSetThreadLocalConfigOption("GTIFF_REPORT_COMPD_CS",
+                                        !osPrevValueConfigOption.empty()
+                                            ? osPrevValueConfigOption.c_str()
+                                            : nullptr);
+    }
+    if( poDS == nullptr )
+        return std::shared_ptr<GDALRPCDEM>();
+    if( poDS->GetRasterCount() == 0 )
+    {
+        GDALClose(poDS);
+        return std::shared_ptr<GDALRPCDEM>();
+    }
+
+    // Size of the tile cache, in MB.
+    const int nCacheSizeMB = std::max(1, atoi(
+        CPLGetConfigOption("GDAL_RPC_DEM_CACHE_MAX", "64")));
+    const size_t nMaxTiles = std::max(static_cast<size_t>(4),
+        static_cast<size_t>(nCacheSizeMB) * 1024 * 1024 /
+            (RPC_DEM_TILE_SIZE * RPC_DEM_TILE_SIZE * sizeof(double)));
+
+    std::shared_ptr<GDALRPCDEM> poDEM =
+        std::make_shared<GDALRPCDEM>(osKey, poDS, nMaxTiles);
+    (*poRPCDEMMap)[osKey] = poDEM;
+    return poDEM;
+}
+
+/************************************************************************/
+/*                              GetTile()                               */
+/************************************************************************/
+
+GDALRPCDEMTilePtr GDALRPCDEM::GetTile( int nTileX, int nTileY )
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+
+    const GIntBig nKey = static_cast<GIntBig>(nTileY) * m_nTilesX + nTileX;
+    GDALRPCDEMTilePtr poTile;
+    if( m_oCache.tryGet(nKey, poTile) )
+        return poTile;
+
+    std::shared_ptr<GDALRPCDEMTile> poNewTile =
+        std::make_shared<GDALRPCDEMTile>();
+    poNewTile->nTileX = nTileX;
+    poNewTile->nTileY = nTileY;
+    poNewTile->nXOff = nTileX * RPC_DEM_TILE_SIZE;
+    poNewTile->nYOff = nTileY * RPC_DEM_TILE_SIZE;
+    poNewTile->nXSize =
+        std::min(RPC_DEM_TILE_SIZE, nRasterXSize - poNewTile->nXOff);
+    poNewTile->nYSize =
+        std::min(RPC_DEM_TILE_SIZE, nRasterYSize - poNewTile->nYOff);
+    try
+    {
+        poNewTile->adfData.resize(
+            static_cast<size_t>(poNewTile->nXSize) * poNewTile->nYSize);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate DEM tile");
+        return GDALRPCDEMTilePtr();
+    }
+    if( m_poDS->GetRasterBand(1)->RasterIO(GF_Read,
+                        poNewTile->nXOff, poNewTile->nYOff,
+                        poNewTile->nXSize, poNewTile->nYSize,
+                        &poNewTile->adfData[0],
+                        poNewTile->nXSize, poNewTile->nYSize,
+                        GDT_Float64, 0, 0, nullptr) != CE_None )
+    {
+        return GDALRPCDEMTilePtr();
+    }
+
+    poTile = poNewTile;
+    m_oCache.insert(nKey, poTile);
+    return poTile;
+}
+
+/************************************************************************/
+/*                             ReadWindow()                             */
+/************************************************************************/
+
+// Extract a window of the DEM, that must be inside the raster. poLastTile
+// is a per-caller hint of the last tile used, to avoid taking the lock
+// when consecutive requests hit the same tile, which is the common case.
+bool GDALRPCDEM::ReadWindow( int nX, int nY, int nWidth, int nHeight,
+                             double *padfOut, GDALRPCDEMTilePtr &poLastTile )
+{
+    const int nLastTileX = (nX + nWidth - 1) / RPC_DEM_TILE_SIZE;
+    const int nLastTileY = (nY + nHeight - 1) / RPC_DEM_TILE_SIZE;
+    for( int nTileY = nY / RPC_DEM_TILE_SIZE; nTileY <= nLastTileY; nTileY++ )
+    {
+        for( int nTileX = nX / RPC_DEM_TILE_SIZE; nTileX <= nLastTileX;
+             nTileX++ )
+        {
+            if( !poLastTile || poLastTile->nTileX != nTileX ||
+                poLastTile->nTileY != nTileY )
+            {
+                GDALRPCDEMTilePtr poTile = GetTile(nTileX, nTileY);
+                if( !poTile )
+                    return false;
+                poLastTile = poTile;
+            }
+            const GDALRPCDEMTile *poTile = poLastTile.get();
+
+            const int nMinX = std::max(nX, poTile->nXOff);
+            const int nMaxX = std::min(nX + nWidth,
+                                       poTile->nXOff + poTile->nXSize);
+            const int nMinY = std::max(nY, poTile->nYOff);
+            const int nMaxY = std::min(nY + nHeight,
+                                       poTile->nYOff + poTile->nYSize);
+            for( int iY = nMinY; iY < nMaxY; iY++ )
+            {
+                memcpy( padfOut + static_cast<size_t>(iY - nY) * nWidth +
+                            nMinX - nX,
+                        &poTile->adfData[0] +
+                            static_cast<size_t>(iY - poTile->nYOff) *
+                                poTile->nXSize + nMinX - poTile->nXOff,
+                        (nMaxX - nMinX) * sizeof(double) );
+            }
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          GDALRPCDEMAccessor                          */
+/************************************************************************/
+
+// Per-transformer access to a shared DEM.
+class GDALRPCDEMAccessor
+{
+    std::shared_ptr<GDALRPCDEM> m_poDEM;
+    GDALRPCDEMTilePtr m_poLastTile{};
+
+    GDALRPCDEMAccessor( const GDALRPCDEMAccessor& ) = delete;
+    GDALRPCDEMAccessor& operator=( const GDALRPCDEMAccessor& ) = delete;
+
+  public:
+    explicit GDALRPCDEMAccessor( const std::shared_ptr<GDALRPCDEM>& poDEM ) :
+        m_poDEM(poDEM) {}
+
+    const GDALRPCDEM *GetDEM() const { return m_poDEM.get(); }
+    int GetRasterXSize() const { return m_poDEM->nRasterXSize; }
+    int GetRasterYSize() const { return m_poDEM->nRasterYSize; }
+    double GetNoDataValue( int *pbGotNoDataValue ) const
+    {
+        *pbGotNoDataValue = m_poDEM->bGotNoDataValue;
+        return m_poDEM->dfNoDataValue;
+    }
+
+    bool ReadWindow( int nX, int nY, int nWidth, int nHeight,
+                     double *padfOut )
+    {
+        return m_poDEM->ReadWindow( nX, nY, nWidth, nHeight, padfOut,
+                                    m_poLastTile );
+    }
+};
+
 /*! DEM Resampling Algorithm */
 typedef enum {
   /*! Nearest neighbour (select on one input pixel) */ DRA_NearestNeighbour=0,
@@ -236,17 +550,7 @@ typedef struct {
     double      dfDEMMissingValue;
     int         bApplyDEMVDatumShift;
 
-    GDALDataset *poDS;
-    double     *padfDEMBuffer;
-    int         nDEMExtractions;
-    int         nBufferMaxRadius;
-    int         nHitsInBuffer;
-    int         nBufferX;
-    int         nBufferY;
-    int         nBufferWidth;
-    int         nBufferHeight;
-    int         nLastQueriedX;
-    int         nLastQueriedY;
+    GDALRPCDEMAccessor *poDEM;
 
     OGRCoordinateTransformation *poCT;
 
@@ -334,19 +638,16 @@ static double RPCEvaluate( const double *padfTerms, const double *padfCoefs )
 #endif
 
 /************************************************************************/
-/*                         RPCTransformPoint()                          */
+/*                        RPCNormalizeCoords()                          */
 /************************************************************************/
 
-static void RPCTransformPoint( const GDALRPCTransformInfo *psRPCTransformInfo,
-                               double dfLong, double dfLat, double dfHeight,
-                               double *pdfPixel, double *pdfLine )
+static void RPCNormalizeCoords( const GDALRPCTransformInfo *psRPCTransformInfo,
+                                double dfLong, double dfLat, double dfHeight,
+                                double& dfNormalizedLong,
+                                double& dfNormalizedLat,
+                                double& dfNormalizedHeight )
 
 {
-    double adfTermsWithMargin[20+1] = {};
-    // Make padfTerms aligned on 16-byte boundary for SSE2 aligned loads.
-    double* padfTerms =
-        adfTermsWithMargin + (reinterpret_cast<GUIntptr_t>(adfTermsWithMargin) % 16) / 8;
-
     // Avoid dateline issues.
     double diffLong = dfLong - psRPCTransformInfo->sRPC.dfLONG_OFF;
     if( diffLong < -270 )
@@ -358,12 +659,12 @@ static void RPCTransformPoint( const GDALRPCTransformInfo *psRPCTransformInfo,
         diffLong -= 360;
     }
 
-    const double dfNormalizedLong =
+    dfNormalizedLong =
       diffLong / psRPCTransformInfo->sRPC.dfLONG_SCALE;
-    const double dfNormalizedLat =
+    dfNormalizedLat =
         (dfLat - psRPCTransformInfo->sRPC.dfLAT_OFF) /
         psRPCTransformInfo->sRPC.dfLAT_SCALE;
-    const double dfNormalizedHeight =
+    dfNormalizedHeight =
         (dfHeight - psRPCTransformInfo->sRPC.dfHEIGHT_OFF) /
         psRPCTransformInfo->sRPC.dfHEIGHT_SCALE;
 
@@ -412,6 +713,28 @@ static void RPCTransformPoint( const GDALRPCTransformInfo *psRPCTransformInfo,
             }
         }
     }
+}
+
+/************************************************************************/
+/*                         RPCTransformPoint()                          */
+/************************************************************************/
+
+static void RPCTransformPoint( const GDALRPCTransformInfo *psRPCTransformInfo,
+                               double dfLong, double dfLat, double dfHeight,
+                               double *pdfPixel, double *pdfLine )
+
+{
+    double adfTermsWithMargin[20+1] = {};
+    // Make padfTerms aligned on 16-byte boundary for SSE2 aligned loads.
+    double* padfTerms =
+        adfTermsWithMargin + (reinterpret_cast<GUIntptr_t>(adfTermsWithMargin) % 16) / 8;
+
+    double dfNormalizedLong = 0.0;
+    double dfNormalizedLat = 0.0;
+    double dfNormalizedHeight = 0.0;
+    RPCNormalizeCoords( psRPCTransformInfo, dfLong, dfLat, dfHeight,
+                        dfNormalizedLong, dfNormalizedLat,
+                        dfNormalizedHeight );
 
     RPCComputeTerms( dfNormalizedLong, dfNormalizedLat,
                      dfNormalizedHeight, padfTerms );
@@ -444,6 +767,93 @@ static void RPCTransformPoint( const GDALRPCTransformInfo *psRPCTransformInfo,
         + psRPCTransformInfo->sRPC.dfLINE_OFF + 0.5;
 }
 
+/************************************************************************/
+/*                         RPCTransformPoints()                         */
+/************************************************************************/
+
+// Same as RPCTransformPoint() on arrays of points, which may be the same
+// arrays for input and output. With SSE2, points are processed by pairs,
+// each register holding the same polynomial term for 2 points.
+static void RPCTransformPoints( const GDALRPCTransformInfo *psRPCTransformInfo,
+                                int nPointCount,
+                                const double *padfLong, const double *padfLat,
+                                const double *padfHeight,
+                                double *padfPixel, double *padfLine )
+{
+    int i = 0;
+#ifdef USE_SSE2_OPTIM
+    const double *padfCoeffs = psRPCTransformInfo->padfCoeffs;
+    for( ; i + 1 < nPointCount; i += 2 )
+    {
+        double adfLong[2] = { 0.0, 0.0 };
+        double adfLat[2] = { 0.0, 0.0 };
+        double adfHeight[2] = { 0.0, 0.0 };
+        for( int k = 0; k < 2; k++ )
+        {
+            RPCNormalizeCoords( psRPCTransformInfo,
+                                padfLong[i + k], padfLat[i + k],
+                                padfHeight[i + k],
+                                adfLong[k], adfLat[k], adfHeight[k] );
+        }
+        const XMMReg2Double L = XMMReg2Double::Load2Val(adfLong);
+        const XMMReg2Double P = XMMReg2Double::Load2Val(adfLat);
+        const XMMReg2Double H = XMMReg2Double::Load2Val(adfHeight);
+
+        // Same order as RPCComputeTerms(), except for the constant term.
+        const XMMReg2Double LL = L * L;
+        const XMMReg2Double PP = P * P;
+        const XMMReg2Double HH = H * H;
+        const XMMReg2Double aoTerms[19] = {
+            L, P, H, L * P, L * H, P * H, LL, PP, HH,
+            L * P * H, LL * L, L * PP, L * HH, LL * P, PP * P,
+            P * HH, LL * H, PP * H, HH * H };
+
+        XMMReg2Double oLineNum = XMMReg2Double::Load1ValHighAndLow(padfCoeffs);
+        XMMReg2Double oLineDen =
+            XMMReg2Double::Load1ValHighAndLow(padfCoeffs + 20);
+        XMMReg2Double oSampNum =
+            XMMReg2Double::Load1ValHighAndLow(padfCoeffs + 40);
+        XMMReg2Double oSampDen =
+            XMMReg2Double::Load1ValHighAndLow(padfCoeffs + 60);
+        for( int j = 1; j < 20; j++ )
+        {
+            const XMMReg2Double& oTerm = aoTerms[j - 1];
+            oLineNum += oTerm *
+                XMMReg2Double::Load1ValHighAndLow(padfCoeffs + j);
+            oLineDen += oTerm *
+                XMMReg2Double::Load1ValHighAndLow(padfCoeffs + j + 20);
+            oSampNum += oTerm *
+                XMMReg2Double::Load1ValHighAndLow(padfCoeffs + j + 40);
+            oSampDen += oTerm *
+                XMMReg2Double::Load1ValHighAndLow(padfCoeffs + j + 60);
+        }
+
+        double adfResultX[2] = { 0.0, 0.0 };
+        double adfResultY[2] = { 0.0, 0.0 };
+        (oSampNum / oSampDen).Store2Val(adfResultX);
+        (oLineNum / oLineDen).Store2Val(adfResultY);
+
+        // RPCs are using the center of upper left pixel = 0,0 convention
+        // convert to top left corner = 0,0 convention used in GDAL.
+        for( int k = 0; k < 2; k++ )
+        {
+            padfPixel[i + k] =
+                adfResultX[k] * psRPCTransformInfo->sRPC.dfSAMP_SCALE
+                + psRPCTransformInfo->sRPC.dfSAMP_OFF + 0.5;
+            padfLine[i + k] =
+                adfResultY[k] * psRPCTransformInfo->sRPC.dfLINE_SCALE
+                + psRPCTransformInfo->sRPC.dfLINE_OFF + 0.5;
+        }
+    }
+#endif
+    for( ; i < nPointCount; i++ )
+    {
+        RPCTransformPoint( psRPCTransformInfo,
+                           padfLong[i], padfLat[i], padfHeight[i],
+                           padfPixel + i, padfLine + i );
+    }
+}
+
 /************************************************************************/
 /*                     GDALSerializeRPCDEMResample()                    */
 /************************************************************************/
@@ -534,7 +944,7 @@ static bool GDALRPCGetHeightAtLongLat( GDALRPCTransformInfo *psTransform,
 {
     double dfVDatumShift = 0.0;
     double dfDEMH = 0.0;
-    if( psTransform->poDS )
+    if( psTransform->poDEM )
     {
         double dfX = 0.0;
         double dfY = 0.0;
@@ -575,7 +985,7 @@ retry:
             if( !bRetried && psTransform->poCT == nullptr &&
                 (dfXIn >= 180.0 || dfXIn <= -180.0) )
             {
-                const int nRasterXSize = psTransform->poDS->GetRasterXSize();
+                const int nRasterXSize = psTransform->poDEM->GetRasterXSize();
                 const double dfMinDEMLong = psTransform->adfDEMGeoTransform[0];
                 const double dfMaxDEMLong =
                     psTransform->adfDEMGeoTransform[0]
@@ -715,7 +1125,11 @@ retry:
  * extract elevation offsets from. In this situation the Z passed into the
  * transformation function is assumed to be height above ground. This option
  * should be used in replacement of RPC_HEIGHT to provide a way of defining
- * a non uniform ground for the target scene (GDAL >= 1.8.0)
+ * a non uniform ground for the target scene (GDAL >= 1.8.0).
+ * Starting with GDAL 2.4, the DEM is opened only once for all the RPC
+ * transformers using it, and its elevation values are read by tiles of
+ * 256x256 pixels, kept in a cache whose maximum size in MB can be set
+ * with the GDAL_RPC_DEM_CACHE_MAX configuration option (default 64).
  *
  * <li> RPC_DEMINTERPOLATION: the DEM interpolation (near, bilinear or cubic)
  *
@@ -1016,9 +1430,7 @@ void GDALDestroyRPCTransformer( void *pTransformAlg )
 
     CPLFree( psTransform->pszDEMPath );
 
-    if( psTransform->poDS )
-        GDALClose(psTransform->poDS);
-    CPLFree(psTransform->padfDEMBuffer);
+    delete psTransform->poDEM;
     if( psTransform->poCT )
         OCTDestroyCoordinateTransformation(
             reinterpret_cast<OGRCoordinateTransformationH>(psTransform->poCT));
@@ -1092,7 +1504,7 @@ RPCInverseTransformPoint( GDALRPCTransformInfo *psTransform,
     bool bLastPixelDeltaValid = false;
     const int nMaxIterations =
         (psTransform->nMaxIterations > 0) ? psTransform->nMaxIterations :
-        (psTransform->poDS != nullptr) ? 20 : 10;
+        (psTransform->poDEM != nullptr) ? 20 : 10;
     int nCountConsecutiveErrorBelow2 = 0;
 
     int iIter = 0;  // Used after for.
@@ -1108,7 +1520,7 @@ RPCInverseTransformPoint( GDALRPCTransformInfo *psTransform,
         if( !GDALRPCGetHeightAtLongLat(psTransform, dfResultX, dfResultY,
                                        &dfDEMH, &dfDEMPixel, &dfDEMLine) )
         {
-            if( psTransform->poDS )
+            if( psTransform->poDEM )
             {
                 CPLDebug(
                     "RPC", "DEM (pixel, line) = (%g, %g)",
@@ -1121,14 +1533,14 @@ RPCInverseTransformPoint( GDALRPCTransformInfo *psTransform,
             if( iIter == 0 )
             {
                 bool bUseRefZ = true;
-                if( psTransform->poDS )
+                if( psTransform->poDEM )
                 {
-                    if( dfDEMPixel >= psTransform->poDS->GetRasterXSize() )
-                        dfDEMPixel = psTransform->poDS->GetRasterXSize() - 0.5;
+                    if( dfDEMPixel >= psTransform->poDEM->GetRasterXSize() )
+                        dfDEMPixel = psTransform->poDEM->GetRasterXSize() - 0.5;
                     else if( dfDEMPixel < 0 )
                         dfDEMPixel = 0.5;
-                    if( dfDEMLine >= psTransform->poDS->GetRasterYSize() )
-                        dfDEMLine = psTransform->poDS->GetRasterYSize() - 0.5;
+                    if( dfDEMLine >= psTransform->poDEM->GetRasterYSize() )
+                        dfDEMLine = psTransform->poDEM->GetRasterYSize() - 0.5;
                     else if( dfDEMPixel < 0 )
                         dfDEMPixel = 0.5;
                     if( GDALRPCGetDEMHeight( psTransform, dfDEMPixel,
@@ -1202,7 +1614,7 @@ RPCInverseTransformPoint( GDALRPCTransformInfo *psTransform,
             }
             break;
         }
-        else if( psTransform->poDS != nullptr &&
+        else if( psTransform->poDEM != nullptr &&
                  bLastPixelDeltaValid &&
                  dfPixelDeltaX * dfLastPixelDeltaX < 0 &&
                  dfPixelDeltaY * dfLastPixelDeltaY < 0 )
@@ -1229,7 +1641,7 @@ RPCInverseTransformPoint( GDALRPCTransformInfo *psTransform,
         }
 
         double dfBoostFactor = 1.0;
-        if( psTransform->poDS != nullptr &&
+        if( psTransform->poDEM != nullptr &&
             nCountConsecutiveErrorBelow2 >= 5 && dfError < 2 )
         {
           // When there is a DEM, if we remain below a given threshold (somewhat
@@ -1311,115 +1723,7 @@ static bool GDALRPCExtractDEMWindow( GDALRPCTransformInfo *psTransform,
                                      int nX, int nY, int nWidth, int nHeight,
                                      double* padfOut )
 {
-    psTransform->nDEMExtractions++;
-    if( psTransform->padfDEMBuffer == nullptr )
-    {
-        // Should only happen in case of failed memory allocation.
-        return psTransform->poDS->GetRasterBand(1)->
-                                  RasterIO(GF_Read, nX, nY, nWidth, nHeight,
-                                           padfOut, nWidth, nHeight,
-                                           GDT_Float64, 0, 0,
-                                           nullptr) == CE_None;
-    }
-
-    // Instead of reading just nWidth * nHeight pixels (with those being <= 4),
-    // target a larger buffer since small extractions can be costly, particular
-    // with VRT.
-    if( !(nX >= psTransform->nBufferX &&
-          nX + nWidth <= psTransform->nBufferX + psTransform->nBufferWidth &&
-          nY >= psTransform->nBufferY &&
-          nY + nHeight <= psTransform->nBufferY + psTransform->nBufferHeight ) )
-    {
-#ifdef DEBUG_VERBOSE_EXTRACT_DEM
-        CPLDebug("RPC", "Current request: %d,%d-%dx%d",
-                  nX, nY, nWidth, nHeight);
-        CPLDebug("RPC", "Hits in last DEM buffer: %d (%d pixels)",
-                 psTransform->nHitsInBuffer,
-                 psTransform->nBufferWidth * psTransform->nBufferHeight);
-        CPLDebug("RPC", "Last DEM buffer: %d,%d-%dx%d",
-                 psTransform->nBufferX,
-                 psTransform->nBufferY,
-                 psTransform->nBufferWidth,
-                 psTransform->nBufferHeight);
-#endif
-        const int nRasterXSize = psTransform->poDS->GetRasterXSize();
-        const int nRasterYSize = psTransform->poDS->GetRasterYSize();
-        // If we have only queried a few points, no need to extract on a large
-        // window We will progressively extend the window up to its maximum size
-        // if we extract a significant number of points.
-        int nRadius = psTransform->nBufferMaxRadius;
-        if( psTransform->nDEMExtractions <
-            psTransform->nBufferMaxRadius * psTransform->nBufferMaxRadius )
-        {
-            nRadius = static_cast<int> (
-                  sqrt(static_cast<double>(psTransform->nDEMExtractions)) );
-            CPLAssert( nRadius <= psTransform->nBufferMaxRadius );
-        }
-        // Check if there's some overlap between consecutive requests to decide
-        // if we must have a buffer around the interest window.
-        const int nDiffX = nX - psTransform->nLastQueriedX;
-        const int nDiffY = nY - psTransform->nLastQueriedY;
-        if( psTransform->nLastQueriedX >= 0 &&
-            (nDiffX > nRadius || -nDiffX > nRadius ||
-             nDiffY > nRadius || -nDiffY > nRadius) )
-        {
-            nRadius = 0;
-        }
-        psTransform->nBufferX = nX - nRadius;
-        if( psTransform->nBufferX < 0 )
-            psTransform->nBufferX = 0;
-        psTransform->nBufferY = nY - nRadius;
-        if( psTransform->nBufferY < 0 )
-            psTransform->nBufferY = 0;
-        psTransform->nBufferWidth = nWidth + 2 * nRadius;
-        if( psTransform->nBufferX + psTransform->nBufferWidth > nRasterXSize )
-            psTransform->nBufferWidth = nRasterXSize - psTransform->nBufferX;
-        psTransform->nBufferHeight = nHeight + 2 * nRadius;
-        if( psTransform->nBufferY + psTransform->nBufferHeight > nRasterYSize )
-            psTransform->nBufferHeight = nRasterYSize - psTransform->nBufferY;
-#ifdef DEBUG_VERBOSE_EXTRACT_DEM
-        CPLDebug("RPC", "New DEM buffer: %d,%d-%dx%d",
-                 psTransform->nBufferX,
-                 psTransform->nBufferY,
-                 psTransform->nBufferWidth,
-                 psTransform->nBufferHeight);
-#endif
-        CPLErr eErr = psTransform->poDS->GetRasterBand(1)->RasterIO(GF_Read,
-                        psTransform->nBufferX, psTransform->nBufferY,
-                        psTransform->nBufferWidth, psTransform->nBufferHeight,
-                        psTransform->padfDEMBuffer,
-                        psTransform->nBufferWidth, psTransform->nBufferHeight,
-                        GDT_Float64, 0, 0, nullptr);
-        if( eErr != CE_None )
-        {
-            psTransform->nBufferX = -1;
-            psTransform->nBufferY = -1;
-            psTransform->nBufferWidth = -1;
-            psTransform->nBufferHeight = -1;
-            return false;
-        }
-#ifdef DEBUG_VERBOSE_EXTRACT_DEM
-         psTransform->nHitsInBuffer = 1;
-#endif
-    }
-    else
-    {
-#ifdef DEBUG_VERBOSE
-        psTransform->nHitsInBuffer++;
-#endif
-    }
-    psTransform->nLastQueriedX = nX;
-    psTransform->nLastQueriedY = nY;
-
-    for( int i=0; i<nHeight; i++)
-    {
-        memcpy( padfOut + i * nWidth,
-                psTransform->padfDEMBuffer + (nY - psTransform->nBufferY + i) *
-                    psTransform->nBufferWidth + nX - psTransform->nBufferX,
-                nWidth * sizeof(double) );
-    }
-
-    return true;
+    return psTransform->poDEM->ReadWindow( nX, nY, nWidth, nHeight, padfOut );
 }
 
 /************************************************************************/
@@ -1431,11 +1735,11 @@ int GDALRPCGetDEMHeight( GDALRPCTransformInfo *psTransform,
                          const double dfXIn, const double dfYIn,
                          double* pdfDEMH )
 {
-    const int nRasterXSize = psTransform->poDS->GetRasterXSize();
-    const int nRasterYSize = psTransform->poDS->GetRasterYSize();
+    const int nRasterXSize = psTransform->poDEM->GetRasterXSize();
+    const int nRasterYSize = psTransform->poDEM->GetRasterYSize();
     int bGotNoDataValue = FALSE;
     const double dfNoDataValue =
-        psTransform->poDS->GetRasterBand(1)->GetNoDataValue( &bGotNoDataValue );
+        psTransform->poDEM->GetNoDataValue( &bGotNoDataValue );
 
     if( psTransform->eResampleAlg == DRA_Cubic )
     {
@@ -1577,7 +1881,7 @@ near_fallback:
 /************************************************************************/
 
 static int
-GDALRPCTransformWholeLineWithDEM( const GDALRPCTransformInfo *psTransform,
+GDALRPCTransformWholeLineWithDEM( GDALRPCTransformInfo *psTransform,
                                   int nPointCount,
                                   double *padfX, double *padfY, double *padfZ,
                                   int *panSuccess,
@@ -1592,11 +1896,8 @@ GDALRPCTransformWholeLineWithDEM( const GDALRPCTransformInfo *psTransform,
             panSuccess[i] = FALSE;
         return FALSE;
     }
-    CPLErr eErr = psTransform->poDS->GetRasterBand(1)->
-        RasterIO(GF_Read, nXLeft, nYTop, nXWidth, nYHeight,
-                 padfDEMBuffer, nXWidth, nYHeight,
-                 GDT_Float64, 0, 0, nullptr);
-    if( eErr != CE_None )
+    if( !psTransform->poDEM->ReadWindow( nXLeft, nYTop, nXWidth, nYHeight,
+                                         padfDEMBuffer ) )
     {
         for( int i = 0; i < nPointCount; i++ )
             panSuccess[i] = FALSE;
@@ -1606,7 +1907,7 @@ GDALRPCTransformWholeLineWithDEM( const GDALRPCTransformInfo *psTransform,
 
     int bGotNoDataValue = FALSE;
     const double dfNoDataValue =
-        psTransform->poDS->GetRasterBand(1)->GetNoDataValue( &bGotNoDataValue );
+        psTransform->poDEM->GetNoDataValue( &bGotNoDataValue );
 
     // dfY in pixel center convention.
     const double dfY =
@@ -1789,35 +2090,14 @@ static bool GDALRPCOpenDEM( GDALRPCTransformInfo* psTransform )
 
     bool bIsValid = false;
 
-    CPLString osPrevValueConfigOption;
-    if( psTransform->bApplyDEMVDatumShift )
-    {
-        osPrevValueConfigOption
-            = CPLGetThreadLocalConfigOption("GTIFF_REPORT_COMPD_CS", "");
-        CPLSetThreadLocalConfigOption("GTIFF_REPORT_COMPD_CS", "YES");
-    }
-    CPLConfigOptionSetter oSetter("CPL_ALLOW_VSISTDIN", "NO", true);
-    psTransform->poDS = reinterpret_cast<GDALDataset *>(
-        GDALOpen(psTransform->pszDEMPath, GA_ReadOnly));
-    if( psTransform->poDS != nullptr &&
-        psTransform->poDS->GetRasterCount() >= 1 )
+    std::shared_ptr<GDALRPCDEM> poSharedDEM =
+        GDALRPCDEM::Acquire( psTransform->pszDEMPath,
+                             CPL_TO_BOOL(psTransform->bApplyDEMVDatumShift) );
+    if( poSharedDEM )
     {
-        psTransform->nBufferMaxRadius =
-            atoi(CPLGetConfigOption("GDAL_RPC_DEM_BUFFER_MAX_RADIUS", "2"));
-        psTransform->nHitsInBuffer = 0;
-        const int nMaxWindowSize = 4;
-        psTransform->padfDEMBuffer = static_cast<double*>(VSIMalloc(
-            (nMaxWindowSize + 2 * psTransform->nBufferMaxRadius) *
-            (nMaxWindowSize + 2 * psTransform->nBufferMaxRadius) *
-            sizeof(double) ));
-        psTransform->nBufferX = -1;
-        psTransform->nBufferY = -1;
-        psTransform->nBufferWidth = -1;
-        psTransform->nBufferHeight = -1;
-        psTransform->nLastQueriedX = -1;
-        psTransform->nLastQueriedY = -1;
-        const char* pszSpatialRef = psTransform->poDS->GetProjectionRef();
-        if( pszSpatialRef != nullptr && pszSpatialRef[0] != '\0' )
+        psTransform->poDEM = new GDALRPCDEMAccessor(poSharedDEM);
+        const char* pszSpatialRef = poSharedDEM->osSRS.c_str();
+        if( pszSpatialRef[0] != '\0' )
         {
             OGRSpatialReference* poWGSSpaRef =
                     new OGRSpatialReference(SRS_WKT_WGS84);
@@ -1887,8 +2167,10 @@ static bool GDALRPCOpenDEM( GDALRPCTransformInfo* psTransform )
             delete poDSSpaRef;
         }
 
-        if( psTransform->poDS->GetGeoTransform(
-                            psTransform->adfDEMGeoTransform) == CE_None &&
+        memcpy( psTransform->adfDEMGeoTransform,
+                poSharedDEM->adfGeoTransform,
+                sizeof(psTransform->adfDEMGeoTransform) );
+        if( poSharedDEM->bHasGeoTransform &&
             GDALInvGeoTransform( psTransform->adfDEMGeoTransform,
                                     psTransform->adfDEMReverseGeoTransform ) )
         {
@@ -1896,14 +2178,6 @@ static bool GDALRPCOpenDEM( GDALRPCTransformInfo* psTransform )
         }
     }
 
-    if( psTransform->bApplyDEMVDatumShift )
-    {
-        CPLSetThreadLocalConfigOption("GTIFF_REPORT_COMPD_CS",
-                                        !osPrevValueConfigOption.empty()
-                                            ? osPrevValueConfigOption.c_str()
-                                            : nullptr);
-    }
-
     return bIsValid;
 }
 
@@ -1938,7 +2212,7 @@ int GDALRPCTransform( void *pTransformArg, int bDstToSrc,
         // identical, that the DEM is in WGS84 geodetic and that it has no
         // rotation.  Such case is for example triggered when doing gdalwarp
         // with a target SRS of EPSG:4326 or EPSG:3857.
-        if( nPointCount >= 10 && psTransform->poDS != nullptr &&
+        if( nPointCount >= 10 && psTransform->poDEM != nullptr &&
             psTransform->poCT == nullptr && padfY[0] == padfY[nPointCount-1] &&
             padfY[0] == padfY[nPointCount/ 2] &&
             psTransform->adfDEMReverseGeoTransform[1] > 0.0 &&
@@ -2001,9 +2275,9 @@ int GDALRPCTransform( void *pTransformArg, int bDstToSrc,
                     nYHeight = 1;
                 }
                 if( nXLeft >= 0 &&
-                    nXLeft + nXWidth <= psTransform->poDS->GetRasterXSize() &&
+                    nXLeft + nXWidth <= psTransform->poDEM->GetRasterXSize() &&
                     nYTop >= 0 &&
-                    nYTop + nYHeight <= psTransform->poDS->GetRasterYSize() )
+                    nYTop + nYHeight <= psTransform->poDEM->GetRasterYSize() )
                 {
                     static bool bOnce = false;
                     if( !bOnce )
@@ -2022,6 +2296,14 @@ int GDALRPCTransform( void *pTransformArg, int bDstToSrc,
             }
         }
 
+        // Fetch heights, and evaluate the RPC polynomials by batches of
+        // points.
+        constexpr int BATCH_SIZE = 64;
+        int anIdx[BATCH_SIZE];
+        double adfLong[BATCH_SIZE];
+        double adfLat[BATCH_SIZE];
+        double adfHeight[BATCH_SIZE];
+        int nBatchCount = 0;
         for( int i = 0; i < nPointCount; i++ )
         {
             double dfHeight = 0.0;
@@ -2031,13 +2313,30 @@ int GDALRPCTransform( void *pTransformArg, int bDstToSrc,
                 panSuccess[i] = FALSE;
                 padfX[i] = HUGE_VAL;
                 padfY[i] = HUGE_VAL;
-                continue;
+            }
+            else
+            {
+                anIdx[nBatchCount] = i;
+                adfLong[nBatchCount] = padfX[i];
+                adfLat[nBatchCount] = padfY[i];
+                adfHeight[nBatchCount] = (padfZ ? padfZ[i] : 0.0) + dfHeight;
+                nBatchCount++;
+                panSuccess[i] = TRUE;
             }
 
-            RPCTransformPoint( psTransform, padfX[i], padfY[i],
-                               (padfZ ? padfZ[i] : 0.0) + dfHeight,
-                                padfX + i, padfY + i );
-            panSuccess[i] = TRUE;
+            if( nBatchCount == BATCH_SIZE ||
+                (nBatchCount > 0 && i == nPointCount - 1) )
+            {
+                RPCTransformPoints( psTransform, nBatchCount,
+                                    adfLong, adfLat, adfHeight,
+                                    adfLong, adfLat );
+                for( int j = 0; j < nBatchCount; j++ )
+                {
+                    padfX[anIdx[j]] = adfLong[j];
+                    padfY[anIdx[j]] = adfLat[j];
+                }
+                nBatchCount = 0;
+            }
         }
 
         return TRUE;
@@ -32,6 +32,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 #include <map>
 #include <utility>
 
@@ -67,10 +68,36 @@ typedef struct
     int       nGCPCount;
     GDAL_GCP *pasGCPList;
 
+    // Number of GCPs per patch of the local mode, or 0 for a global spline.
+    int       nLocalPoints;
+    double    dfLocalOverlap;
+
     volatile int nRefCount;
 
 } TPSTransformInfo;
 
+/************************************************************************/
+/*                         GDALTPSGetOptions()                          */
+/************************************************************************/
+
+static char **GDALTPSGetOptions( const TPSTransformInfo *psInfo )
+{
+    char** papszOptions = nullptr;
+    if( psInfo->nLocalPoints > 0 )
+    {
+        papszOptions = CSLSetNameValue(papszOptions, "TPS_METHOD", "LOCAL");
+        papszOptions = CSLSetNameValue(papszOptions, "TPS_LOCAL_POINTS",
+                            CPLSPrintf("%d", psInfo->nLocalPoints));
+        papszOptions = CSLSetNameValue(papszOptions, "TPS_LOCAL_OVERLAP",
+                            CPLSPrintf("%.18g", psInfo->dfLocalOverlap));
+    }
+    else
+    {
+        papszOptions = CSLSetNameValue(papszOptions, "TPS_METHOD", "FULL");
+    }
+    return papszOptions;
+}
+
 /************************************************************************/
 /*                   GDALCreateSimilarTPSTransformer()                  */
 /************************************************************************/
@@ -98,9 +125,11 @@ void* GDALCreateSimilarTPSTransformer( void *hTransformArg,
             pasGCPList[i].dfGCPPixel /= dfRatioX;
             pasGCPList[i].dfGCPLine /= dfRatioY;
         }
+        char** papszOptions = GDALTPSGetOptions(psInfo);
         psInfo = static_cast<TPSTransformInfo *>(
-            GDALCreateTPSTransformer( psInfo->nGCPCount, pasGCPList,
-                                      psInfo->bReversed ));
+            GDALCreateTPSTransformerInt( psInfo->nGCPCount, pasGCPList,
+                                         psInfo->bReversed, papszOptions ));
+        CSLDestroy( papszOptions );
         GDALDeinitGCPs( psInfo->nGCPCount, pasGCPList );
         CPLFree( pasGCPList );
     }
@@ -127,6 +156,19 @@ void* GDALCreateSimilarTPSTransformer( void *hTransformArg,
  * for large numbers of GCPs.  For instance, for reference, it takes on the
  * order of 10s for 400 GCPs on a 2GHz Athlon processor.
  *
+ * For large numbers of GCPs, the GDAL_TPS_METHOD configuration option can be
+ * set to LOCAL (GDAL &gt;= 2.4) to use a partition of unity of local thin
+ * plate splines, each one fitted on the GCPs of a region of the extent,
+ * instead of a global one. The transformation remains exact at the control
+ * points, and the solving and evaluation costs grow about linearly with the
+ * number of GCPs, at the expense of slightly different results between
+ * control points. The GDAL_TPS_LOCAL_POINTS (default 100) and
+ * GDAL_TPS_LOCAL_OVERLAP (default 0.5) configuration options control the
+ * number of GCPs per region and the overlap between neighbouring regions, in
+ * fraction of the region size. Larger values get closer to the global spline.
+ * The same settings can be passed as the TPS_METHOD, TPS_LOCAL_POINTS and
+ * TPS_LOCAL_OVERLAP transformer options of GDALCreateGenImgProjTransformer2().
+ *
  * TPS Transformers are serializable.
  *
  * The GDAL Thin Plate Spline transformer is based on code provided by
@@ -170,6 +212,28 @@ void *GDALCreateTPSTransformerInt( int nGCPCount, const GDAL_GCP *pasGCPList,
     psInfo->poForward = new VizGeorefSpline2D( 2 );
     psInfo->poReverse = new VizGeorefSpline2D( 2 );
 
+    const char* pszMethod = CSLFetchNameValueDef(papszOptions, "TPS_METHOD",
+                                CPLGetConfigOption("GDAL_TPS_METHOD", "FULL"));
+    if( EQUAL(pszMethod, "LOCAL") )
+    {
+        psInfo->nLocalPoints = std::max(10, atoi(CSLFetchNameValueDef(
+            papszOptions, "TPS_LOCAL_POINTS",
+            CPLGetConfigOption("GDAL_TPS_LOCAL_POINTS", "100"))));
+        psInfo->dfLocalOverlap = CPLAtof(CSLFetchNameValueDef(
+            papszOptions, "TPS_LOCAL_OVERLAP",
+            CPLGetConfigOption("GDAL_TPS_LOCAL_OVERLAP", "0.5")));
+        psInfo->poForward->set_local( psInfo->nLocalPoints,
+                                      psInfo->dfLocalOverlap );
+        psInfo->poReverse->set_local( psInfo->nLocalPoints,
+                                      psInfo->dfLocalOverlap );
+    }
+    else if( !EQUAL(pszMethod, "FULL") )
+    {
+        CPLError(CE_Warning, CPLE_NotSupported,
+                 "Unsupported value for TPS_METHOD: %s. Using FULL",
+                 pszMethod);
+    }
+
     memcpy( psInfo->sTI.abySignature,
             GDAL_GTI2_SIGNATURE,
             strlen(GDAL_GTI2_SIGNATURE) );
@@ -407,6 +471,20 @@ CPLXMLNode *GDALSerializeTPSTransformer( void *pTransformArg )
         psTree, "Reversed",
         CPLString().Printf( "%d", static_cast<int>(psInfo->bReversed) ) );
 
+/* -------------------------------------------------------------------- */
+/*      Serialize the local mode settings.                              */
+/* -------------------------------------------------------------------- */
+    if( psInfo->nLocalPoints > 0 )
+    {
+        CPLCreateXMLElementAndValue( psTree, "Method", "LOCAL" );
+        CPLCreateXMLElementAndValue(
+            psTree, "LocalPoints",
+            CPLString().Printf( "%d", psInfo->nLocalPoints ) );
+        CPLCreateXMLElementAndValue(
+            psTree, "LocalOverlap",
+            CPLString().Printf( "%.18g", psInfo->dfLocalOverlap ) );
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Attach GCP List.                                                */
 /* -------------------------------------------------------------------- */
@@ -448,11 +526,26 @@ void *GDALDeserializeTPSTransformer( CPLXMLNode *psTree )
 /* -------------------------------------------------------------------- */
     const int bReversed = atoi(CPLGetXMLValue(psTree, "Reversed", "0"));
 
+    char** papszOptions = nullptr;
+    papszOptions = CSLSetNameValue(papszOptions, "TPS_METHOD",
+                                   CPLGetXMLValue(psTree, "Method", "FULL"));
+    const char* pszLocalPoints = CPLGetXMLValue(psTree, "LocalPoints", nullptr);
+    if( pszLocalPoints )
+        papszOptions = CSLSetNameValue(papszOptions, "TPS_LOCAL_POINTS",
+                                       pszLocalPoints);
+    const char* pszLocalOverlap =
+        CPLGetXMLValue(psTree, "LocalOverlap", nullptr);
+    if( pszLocalOverlap )
+        papszOptions = CSLSetNameValue(papszOptions, "TPS_LOCAL_OVERLAP",
+                                       pszLocalOverlap);
+
 /* -------------------------------------------------------------------- */
 /*      Generate transformation.                                        */
 /* -------------------------------------------------------------------- */
     void *pResult =
-        GDALCreateTPSTransformer( nGCPCount, pasGCPList, bReversed );
+        GDALCreateTPSTransformerInt( nGCPCount, pasGCPList, bReversed,
+                                     papszOptions );
+    CSLDestroy( papszOptions );
 
 /* -------------------------------------------------------------------- */
 /*      Cleanup GCP copy.                                               */
@@ -0,0 +1,2429 @@
+/******************************************************************************
+ *
+ * Project:  GDAL DEM Utilities
+ * Purpose:  Hillshade, slope, aspect, TRI, TPI and roughness computation,
+ *           shared by gdaldem and the DERIVED driver.
+ * Authors:  Matthew Perry, perrygeo at gmail.com
+ *           Even Rouault, even dot rouault at mines dash paris dot org
+ *           Howard Butler, hobu.inc at gmail.com
+ *           Chris Yesson, chris dot yesson at ioz dot ac dot uk
+ *
+ ******************************************************************************
+ * Copyright (c) 2006, 2009 Matthew Perry
+ * Copyright (c) 2009-2013, Even Rouault <even dot rouault at mines-paris dot org>
+ * Portions derived from GRASS 4.1 (public domain) See
+ * http://trac.osgeo.org/gdal/ticket/2975 for more information regarding
+ * history of this code
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************
+ *
+ * Slope and aspect calculations based on original method for GRASS GIS 4.1
+ * by Michael Shapiro, U.S.Army Construction Engineering Research Laboratory
+ *    Olga Waupotitsch, U.S.Army Construction Engineering Research Laboratory
+ *    Marjorie Larson, U.S.Army Construction Engineering Research Laboratory
+ * as found in GRASS's r.slope.aspect module.
+ *
+ * Horn's formula is used to find the first order derivatives in x and y directions
+ * for slope and aspect calculations: Horn, B. K. P. (1981).
+ * "Hill Shading and the Reflectance Map", Proceedings of the IEEE, 69(1):14-47.
+ *
+ * Other reference :
+ * Burrough, P.A. and McDonell, R.A., 1998. Principles of Geographical Information
+ * Systems. p. 190.
+ *
+ * Shaded relief based on original method for GRASS GIS 4.1 by Jim Westervelt,
+ * U.S. Army Construction Engineering Research Laboratory
+ * as found in GRASS's r.shaded.relief (formerly shade.rel.sh) module.
+ * ref: "r.mapcalc: An Algebra for GIS and Image Processing",
+ * by Michael Shapiro and Jim Westervelt, U.S. Army Construction Engineering
+ * Research Laboratory (March/1991)
+ *
+ * TRI - Terrain Ruggedness Index is as described in Wilson et al. (2007)
+ * this is based on the method of Valentine et al. (2004)
+ *
+ * TPI - Topographic Position Index follows the description in
+ * Wilson et al. (2007), following Weiss (2001).  The radius is fixed
+ * at 1 cell width/height
+ *
+ * Roughness - follows the definition in Wilson et al. (2007), which follows
+ * Dartnell (2000).
+ *
+ * References for TRI/TPI/Roughness:
+ * Dartnell, P. 2000. Applying Remote Sensing Techniques to map Seafloor
+ *  Geology/Habitat Relationships. Masters Thesis, San Francisco State
+ *  University, pp. 108.
+ * Valentine, P. C., S. J. Fuller, L. A. Scully. 2004. Terrain Ruggedness
+ *  Analysis and Distribution of Boulder Ridges in the Stellwagen Bank National
+ *  Marine Sanctuary Region (poster). Galway, Ireland: 5th International
+ *  Symposium on Marine Geological and Biological Habitat Mapping (GeoHAB),
+ *  May 2004.
+ * Weiss, A. D. 2001. Topographic Positions and Landforms Analysis (poster),
+ *  ESRI International User Conference, July 2001. San Diego, CA: ESRI.
+ * Wilson, M. F. J.; O'Connell, B.; Brown, C.; Guinan, J. C. & Grehan, A. J.
+ *  Multiscale terrain analysis of multibeam bathymetry data for habitat mapping
+ *  on the continental slope Marine Geodesy, 2007, 30, 3-35
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_alg.h"
+#include "gdal_alg_priv.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_progress.h"
+#include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal.h"
+#include "gdal_priv.h"
+#include "gdal_thread_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define HAVE_16_SSE_REG
+#define HAVE_SSE2
+#include "emmintrin.h"
+#endif
+
+CPL_CVSID("$Id$")
+
+static const double kdfDegreesToRadians = M_PI / 180.0;
+static const double kdfRadiansToDegrees = 180.0 / M_PI;
+
+/************************************************************************/
+/*                          ComputeVal()                                */
+/************************************************************************/
+
+template<class T>
+struct GDALGeneric3x3ProcessingAlg
+{
+    typedef float (*type) (const T* pafWindow, float fDstNoDataValue, void* pData);
+};
+
+template<class T>
+struct GDALGeneric3x3ProcessingAlg_multisample
+{
+    typedef int (*type)  (const T* pafThreeLineWin,
+                          int nLine1Off,
+                          int nLine2Off,
+                          int nLine3Off,
+                          int nXSize,
+                          void* pData,
+                          float* pafOutputBuf);
+};
+
+template<class T>
+static float ComputeVal( bool bSrcHasNoData, T fSrcNoDataValue,
+                         bool bIsSrcNoDataNan,
+                         T* afWin, float fDstNoDataValue,
+                         typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg,
+                         void* pData,
+                         bool bComputeAtEdges );
+
+template<>
+float ComputeVal( bool bSrcHasNoData, float fSrcNoDataValue,
+                  bool bIsSrcNoDataNan,
+                  float* afWin, float fDstNoDataValue,
+                  GDALGeneric3x3ProcessingAlg<float>::type pfnAlg,
+                  void* pData,
+                  bool bComputeAtEdges )
+{
+    if( bSrcHasNoData &&
+        ((!bIsSrcNoDataNan && ARE_REAL_EQUAL(afWin[4], fSrcNoDataValue)) ||
+         (bIsSrcNoDataNan && CPLIsNan(afWin[4]))) )
+    {
+        return fDstNoDataValue;
+    }
+    else if( bSrcHasNoData )
+    {
+        for( int k = 0; k < 9; k++ )
+        {
+            if( (!bIsSrcNoDataNan &&
+                 ARE_REAL_EQUAL(afWin[k], fSrcNoDataValue)) ||
+                (bIsSrcNoDataNan && CPLIsNan(afWin[k])) )
+            {
+                if( bComputeAtEdges )
+                    afWin[k] = afWin[4];
+                else
+                    return fDstNoDataValue;
+            }
+        }
+    }
+
+    return pfnAlg(afWin, fDstNoDataValue, pData);
+}
+
+template<>
+float ComputeVal( bool bSrcHasNoData, GInt32 fSrcNoDataValue,
+                  bool /* bIsSrcNoDataNan */,
+                  GInt32* afWin, float fDstNoDataValue,
+                  GDALGeneric3x3ProcessingAlg<GInt32>::type pfnAlg,
+                  void* pData,
+                  bool bComputeAtEdges )
+{
+    if( bSrcHasNoData && afWin[4] == fSrcNoDataValue )
+    {
+        return fDstNoDataValue;
+    }
+    else if( bSrcHasNoData )
+    {
+        for( int k = 0; k < 9; k++ )
+        {
+            if( afWin[k] == fSrcNoDataValue )
+            {
+                if( bComputeAtEdges )
+                    afWin[k] = afWin[4];
+                else
+                    return fDstNoDataValue;
+            }
+        }
+    }
+
+    return pfnAlg(afWin, fDstNoDataValue, pData);
+}
+
+/************************************************************************/
+/*                           INTERPOL()                                 */
+/************************************************************************/
+
+template<class T> static T INTERPOL(T a, T b, int bSrcHasNodata, T fSrcNoDataValue);
+
+template<>
+float INTERPOL(float a, float b, int bSrcHasNoData, float fSrcNoDataValue)
+{
+    return ((bSrcHasNoData && (ARE_REAL_EQUAL(a, fSrcNoDataValue) ||
+                               ARE_REAL_EQUAL(b, fSrcNoDataValue))) ?
+                                            fSrcNoDataValue : 2 * (a) - (b));
+}
+
+template<>
+GInt32 INTERPOL(GInt32 a, GInt32 b, int bSrcHasNoData, GInt32 fSrcNoDataValue)
+{
+    if( bSrcHasNoData && ((a == fSrcNoDataValue) || (b == fSrcNoDataValue)) )
+        return fSrcNoDataValue;
+    int nVal = 2 * a - b;
+    if( bSrcHasNoData && fSrcNoDataValue == nVal )
+        return nVal + 1;
+    return nVal;
+}
+
+/************************************************************************/
+/*                    GDALGeneric3x3ProcessingParams                    */
+/************************************************************************/
+
+// Settings shared by all the lines computed by GDALGeneric3x3Processing().
+template<class T>
+struct GDALGeneric3x3ProcessingParams
+{
+    int nXSize;
+    int nYSize;
+    typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg;
+    typename GDALGeneric3x3ProcessingAlg_multisample<T>::type
+                                                        pfnAlg_multisample;
+    void* pData;
+    bool bComputeAtEdges;
+    bool bSrcHasNoData;
+    bool bIsSrcNoDataNan;
+    T fSrcNoDataValue;
+    float fDstNoDataValue;
+};
+
+/************************************************************************/
+/*                     GDALGeneric3x3InitSrcNoData()                    */
+/************************************************************************/
+
+// Sets the source nodata members of sParams from hSrcBand, and returns the
+// data type in which the source values must be read.
+template<class T>
+static GDALDataType GDALGeneric3x3InitSrcNoData(
+    GDALRasterBandH hSrcBand, GDALGeneric3x3ProcessingParams<T>& sParams )
+{
+    GDALDataType eReadDT;
+    int bSrcHasNoData = FALSE;
+    const double dfNoDataValue =
+        GDALGetRasterNoDataValue(hSrcBand, &bSrcHasNoData);
+
+    int bIsSrcNoDataNan = FALSE;
+    T fSrcNoDataValue = 0;
+    if( std::numeric_limits<T>::is_integer )
+    {
+        eReadDT = GDT_Int32;
+        if( bSrcHasNoData )
+        {
+            GDALDataType eSrcDT = GDALGetRasterDataType( hSrcBand );
+            CPLAssert( eSrcDT == GDT_Byte ||
+                       eSrcDT == GDT_UInt16 ||
+                       eSrcDT == GDT_Int16 );
+            const int nMinVal =
+                (eSrcDT == GDT_Byte ) ? 0 : (eSrcDT == GDT_UInt16) ? 0 : -32768;
+            const int nMaxVal =
+                (eSrcDT == GDT_Byte )
+                ? 255
+                : (eSrcDT == GDT_UInt16) ? 65535 : 32767;
+
+            if( fabs(dfNoDataValue - floor(dfNoDataValue + 0.5)) < 1e-2 &&
+                dfNoDataValue >= nMinVal && dfNoDataValue <= nMaxVal )
+            {
+                fSrcNoDataValue = static_cast<T>(floor(dfNoDataValue + 0.5));
+            }
+            else
+            {
+                bSrcHasNoData = FALSE;
+            }
+        }
+    }
+    else
+    {
+        eReadDT = GDT_Float32;
+        fSrcNoDataValue = static_cast<T>(dfNoDataValue);
+        bIsSrcNoDataNan = bSrcHasNoData && CPLIsNan(dfNoDataValue);
+    }
+
+    sParams.bSrcHasNoData = CPL_TO_BOOL(bSrcHasNoData);
+    sParams.bIsSrcNoDataNan = CPL_TO_BOOL(bIsSrcNoDataNan);
+    sParams.fSrcNoDataValue = fSrcNoDataValue;
+    return eReadDT;
+}
+
+/************************************************************************/
+/*                       GDALGeneric3x3IsNoData()                       */
+/************************************************************************/
+
+// Same tests as in ComputeVal().
+static bool GDALGeneric3x3IsNoData( float fVal, float fSrcNoDataValue,
+                                    bool bIsSrcNoDataNan )
+{
+    return bIsSrcNoDataNan ? CPL_TO_BOOL(CPLIsNan(fVal)) :
+                             ARE_REAL_EQUAL(fVal, fSrcNoDataValue);
+}
+
+static bool GDALGeneric3x3IsNoData( GInt32 nVal, GInt32 nSrcNoDataValue,
+                                    bool /* bIsSrcNoDataNan */ )
+{
+    return nVal == nSrcNoDataValue;
+}
+
+/************************************************************************/
+/*                     GDALGeneric3x3LineHasNoData()                    */
+/************************************************************************/
+
+template<class T>
+static bool GDALGeneric3x3LineHasNoData(
+    const GDALGeneric3x3ProcessingParams<T>& sParams, const T* pafLine )
+{
+    if( !sParams.bSrcHasNoData )
+        return false;
+    for( int iX = 0; iX < sParams.nXSize; iX++ )
+    {
+        if( GDALGeneric3x3IsNoData(pafLine[iX], sParams.fSrcNoDataValue,
+                                   sParams.bIsSrcNoDataNan) )
+            return true;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                      GDALGeneric3x3ProcessLine()                     */
+/************************************************************************/
+
+// Computes output line iY. nLine1Off, nLine2Off and nLine3Off are the offsets
+// in pafLines of the source lines iY-1, iY and iY+1. For the first line,
+// nLine1Off is not used, and for the last line, nLine3Off is not used.
+// bLinesHaveNoData must be set if one of the 3 source lines has nodata
+// values.
+template<class T>
+static void GDALGeneric3x3ProcessLine(
+    const GDALGeneric3x3ProcessingParams<T>& sParams, int iY,
+    const T* pafLines, int nLine1Off, int nLine2Off, int nLine3Off,
+    bool bLinesHaveNoData, float* pafOutputBuf )
+{
+    const int nXSize = sParams.nXSize;
+    const int nYSize = sParams.nYSize;
+    const bool bComputeAtEdges = sParams.bComputeAtEdges;
+    const bool bSrcHasNoData = sParams.bSrcHasNoData;
+    const T fSrcNoDataValue = sParams.fSrcNoDataValue;
+    const float fDstNoDataValue = sParams.fDstNoDataValue;
+
+    // Move a 3x3 pafWindow over each cell
+    // (where the cell in question is #4)
+    //
+    //      0 1 2
+    //      3 4 5
+    //      6 7 8
+
+    if( iY == 0 || iY == nYSize - 1 )
+    {
+        if( !(bComputeAtEdges && nXSize >= 2 && nYSize >= 2) )
+        {
+            // Exclude the edges
+            for( int j = 0; j < nXSize; j++ )
+            {
+                pafOutputBuf[j] = fDstNoDataValue;
+            }
+            return;
+        }
+
+        for( int j = 0; j < nXSize; j++ )
+        {
+            int jmin = (j == 0) ? j : j - 1;
+            int jmax = (j == nXSize - 1) ? j : j + 1;
+
+            if( iY == 0 )
+            {
+                T afWin[9] = {
+                    INTERPOL(pafLines[nLine2Off + jmin],
+                             pafLines[nLine3Off + jmin],
+                             bSrcHasNoData, fSrcNoDataValue),
+                    INTERPOL(pafLines[nLine2Off + j],
+                             pafLines[nLine3Off + j],
+                             bSrcHasNoData, fSrcNoDataValue),
+                    INTERPOL(pafLines[nLine2Off + jmax],
+                             pafLines[nLine3Off + jmax],
+                             bSrcHasNoData, fSrcNoDataValue),
+                    pafLines[nLine2Off + jmin],
+                    pafLines[nLine2Off + j],
+                    pafLines[nLine2Off + jmax],
+                    pafLines[nLine3Off + jmin],
+                    pafLines[nLine3Off + j],
+                    pafLines[nLine3Off + jmax]
+                };
+                pafOutputBuf[j] = ComputeVal(
+                    bSrcHasNoData,
+                    fSrcNoDataValue,
+                    sParams.bIsSrcNoDataNan,
+                    afWin, fDstNoDataValue,
+                    sParams.pfnAlg, sParams.pData, bComputeAtEdges);
+            }
+            else
+            {
+                T afWin[9] = {
+                    pafLines[nLine1Off + jmin],
+                    pafLines[nLine1Off + j],
+                    pafLines[nLine1Off + jmax],
+                    pafLines[nLine2Off + jmin],
+                    pafLines[nLine2Off + j],
+                    pafLines[nLine2Off + jmax],
+                    INTERPOL(pafLines[nLine2Off + jmin],
+                             pafLines[nLine1Off + jmin],
+                             bSrcHasNoData, fSrcNoDataValue),
+                    INTERPOL(pafLines[nLine2Off + j],
+                             pafLines[nLine1Off + j],
+                             bSrcHasNoData, fSrcNoDataValue),
+                    INTERPOL(pafLines[nLine2Off + jmax],
+                             pafLines[nLine1Off + jmax],
+                             bSrcHasNoData, fSrcNoDataValue),
+                };
+                pafOutputBuf[j] = ComputeVal(
+                    bSrcHasNoData,
+                    fSrcNoDataValue,
+                    sParams.bIsSrcNoDataNan,
+                    afWin, fDstNoDataValue,
+                    sParams.pfnAlg, sParams.pData, bComputeAtEdges);
+            }
+        }
+        return;
+    }
+
+    if( bComputeAtEdges && nXSize >= 2 )
+    {
+        int j = 0;
+        T afWin[9] = {
+            INTERPOL(pafLines[nLine1Off + j],
+                     pafLines[nLine1Off + j+1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafLines[nLine1Off + j],
+            pafLines[nLine1Off + j+1],
+            INTERPOL(pafLines[nLine2Off + j],
+                     pafLines[nLine2Off + j+1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafLines[nLine2Off + j],
+            pafLines[nLine2Off + j+1],
+            INTERPOL(pafLines[nLine3Off + j],
+                     pafLines[nLine3Off + j+1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafLines[nLine3Off + j],
+            pafLines[nLine3Off + j+1]
+        };
+
+        pafOutputBuf[j] =
+            ComputeVal(
+                bLinesHaveNoData,
+                fSrcNoDataValue,
+                sParams.bIsSrcNoDataNan,
+                afWin, fDstNoDataValue,
+                sParams.pfnAlg, sParams.pData, bComputeAtEdges);
+    }
+    else
+    {
+        // Exclude the edges
+        pafOutputBuf[0] = fDstNoDataValue;
+    }
+
+    int j = 1;
+    if( sParams.pfnAlg_multisample && !bLinesHaveNoData )
+    {
+        j = sParams.pfnAlg_multisample(pafLines,
+                                       nLine1Off,
+                                       nLine2Off,
+                                       nLine3Off,
+                                       nXSize,
+                                       sParams.pData,
+                                       pafOutputBuf);
+    }
+
+    for( ; j < nXSize - 1; j++ )
+    {
+        T afWin[9] = {
+            pafLines[nLine1Off + j-1],
+            pafLines[nLine1Off + j],
+            pafLines[nLine1Off + j+1],
+            pafLines[nLine2Off + j-1],
+            pafLines[nLine2Off + j],
+            pafLines[nLine2Off + j+1],
+            pafLines[nLine3Off + j-1],
+            pafLines[nLine3Off + j],
+            pafLines[nLine3Off + j+1]
+        };
+
+        pafOutputBuf[j] =
+            ComputeVal(
+                bLinesHaveNoData,
+                fSrcNoDataValue,
+                sParams.bIsSrcNoDataNan,
+                afWin, fDstNoDataValue,
+                sParams.pfnAlg, sParams.pData, bComputeAtEdges);
+    }
+
+    if( bComputeAtEdges && nXSize >= 2 )
+    {
+        j = nXSize - 1;
+
+        T afWin[9] = {
+            pafLines[nLine1Off + j-1],
+            pafLines[nLine1Off + j],
+            INTERPOL(pafLines[nLine1Off + j],
+                     pafLines[nLine1Off + j-1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafLines[nLine2Off + j-1],
+            pafLines[nLine2Off + j],
+            INTERPOL(pafLines[nLine2Off + j],
+                     pafLines[nLine2Off + j-1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafLines[nLine3Off + j-1],
+            pafLines[nLine3Off + j],
+            INTERPOL(pafLines[nLine3Off + j],
+                     pafLines[nLine3Off + j-1],
+                     bSrcHasNoData, fSrcNoDataValue)
+        };
+
+        pafOutputBuf[j] =
+            ComputeVal(
+                bLinesHaveNoData,
+                fSrcNoDataValue,
+                sParams.bIsSrcNoDataNan,
+                afWin, fDstNoDataValue,
+                sParams.pfnAlg, sParams.pData, bComputeAtEdges);
+    }
+    else
+    {
+        // Exclude the edges
+        if( nXSize > 1 )
+            pafOutputBuf[nXSize - 1] = fDstNoDataValue;
+    }
+}
+
+/************************************************************************/
+/*                         GDALGeneric3x3Strip                          */
+/************************************************************************/
+
+// A strip of full-width output lines [nYOff, nYOff + nYCount[, with the
+// source lines [nSrcYOff, nSrcYOff + nSrcYCount[ it depends on, i.e. the
+// output lines plus a one-line halo above and below (clamped to the
+// raster).
+template<class T>
+struct GDALGeneric3x3Strip
+{
+    const GDALGeneric3x3ProcessingParams<T>* psParams = nullptr;
+    int nYOff = 0;
+    int nYCount = 0;
+    int nSrcYOff = 0;
+    int nSrcYCount = 0;
+    T* pafSrc = nullptr;
+    float* pafDst = nullptr;
+    CPLMutex* hMutex = nullptr;
+    bool bFinished = false;
+
+    GDALGeneric3x3Strip() = default;
+    ~GDALGeneric3x3Strip()
+    {
+        VSIFree(pafSrc);
+        VSIFree(pafDst);
+    }
+
+    void Compute();
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALGeneric3x3Strip)
+};
+
+template<class T>
+void GDALGeneric3x3Strip<T>::Compute()
+{
+    const int nXSize = psParams->nXSize;
+
+    // In case none of the 3 lines have nodata values, then no need to
+    // check it in ComputeVal()
+    std::vector<bool> abLineHasNoData(nSrcYCount);
+    for( int i = 0; i < nSrcYCount; i++ )
+    {
+        abLineHasNoData[i] = GDALGeneric3x3LineHasNoData(
+            *psParams, pafSrc + static_cast<size_t>(i) * nXSize);
+    }
+
+    // Same rule as in GDALGeneric3x3RasterBand::IReadBlock(), for a window
+    // that spans the left and right edges of the raster.
+    const bool bHasSideEdge = psParams->bComputeAtEdges;
+
+    for( int iY = nYOff; iY < nYOff + nYCount; iY++ )
+    {
+        const int iLine = iY - nSrcYOff;
+        bool bLinesHaveNoData = psParams->bSrcHasNoData;
+        if( iY > 0 && iY < psParams->nYSize - 1 && !bHasSideEdge )
+        {
+            bLinesHaveNoData = abLineHasNoData[iLine - 1] ||
+                               abLineHasNoData[iLine] ||
+                               abLineHasNoData[iLine + 1];
+        }
+        GDALGeneric3x3ProcessLine(
+            *psParams, iY, pafSrc,
+            (iLine - 1) * nXSize, iLine * nXSize, (iLine + 1) * nXSize,
+            bLinesHaveNoData,
+            pafDst + static_cast<size_t>(iY - nYOff) * nXSize);
+    }
+}
+
+/************************************************************************/
+/*                    GDALGeneric3x3ComputeStripFunc()                  */
+/************************************************************************/
+
+template<class T>
+static void GDALGeneric3x3ComputeStripFunc( void* pData )
+{
+    GDALGeneric3x3Strip<T>* poStrip =
+        static_cast<GDALGeneric3x3Strip<T>*>(pData);
+    poStrip->Compute();
+
+    CPLAcquireMutex(poStrip->hMutex, 1000.0);
+    poStrip->bFinished = true;
+    CPLReleaseMutex(poStrip->hMutex);
+}
+
+/************************************************************************/
+/*                    GDALGeneric3x3WriteOldestStrip()                  */
+/************************************************************************/
+
+// Waits for the oldest submitted strip to be computed and writes it, unless
+// eErr is already set, then moves it to the free strips. Without job queue,
+// the strip must have been computed.
+template<class T>
+static CPLErr GDALGeneric3x3WriteOldestStrip(
+    std::deque<GDALGeneric3x3Strip<T>*>& apoStrips,
+    std::vector<GDALGeneric3x3Strip<T>*>& apoFreeStrips,
+    CPLJobQueue* poJobQueue, CPLMutex* hMutex,
+    GDALRasterBandH hDstBand, CPLErr eErr,
+    GDALProgressFunc pfnProgress, void *pProgressData )
+{
+    GDALGeneric3x3Strip<T>* poStrip = apoStrips.front();
+    apoStrips.pop_front();
+
+    while( poJobQueue != nullptr )
+    {
+        CPLAcquireMutex(hMutex, 1000.0);
+        const bool bFinished = poStrip->bFinished;
+        CPLReleaseMutex(hMutex);
+        if( bFinished )
+            break;
+        poJobQueue->WaitEvent();
+    }
+
+    if( eErr == CE_None )
+    {
+        const int nXSize = poStrip->psParams->nXSize;
+        eErr = GDALRasterIO(hDstBand, GF_Write,
+                            0, poStrip->nYOff, nXSize, poStrip->nYCount,
+                            poStrip->pafDst, nXSize, poStrip->nYCount,
+                            GDT_Float32, 0, 0);
+        if( eErr == CE_None &&
+            !pfnProgress(
+                1.0 * (poStrip->nYOff + poStrip->nYCount) /
+                    poStrip->psParams->nYSize,
+                nullptr, pProgressData) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+    apoFreeStrips.push_back(poStrip);
+    return eErr;
+}
+
+/************************************************************************/
+/*                  GDALGeneric3x3Processing()                          */
+/************************************************************************/
+
+// The raster is processed by strips of full-width lines. The calling thread
+// reads the source lines of each strip, reusing the two last lines of the
+// previous strip, and writes the computed strips in order. If
+// GDAL_NUM_THREADS is set, strips are computed by the global worker threads.
+template<class T>
+static
+CPLErr GDALGeneric3x3Processing(
+    GDALRasterBandH hSrcBand,
+    GDALRasterBandH hDstBand,
+    typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg,
+    typename GDALGeneric3x3ProcessingAlg_multisample<T>::type pfnAlg_multisample,
+    void *pData,
+    bool bComputeAtEdges,
+    GDALProgressFunc pfnProgress,
+    void *pProgressData )
+{
+    if( pfnProgress == nullptr )
+        pfnProgress = GDALDummyProgress;
+
+/* -------------------------------------------------------------------- */
+/*      Initialize progress counter.                                    */
+/* -------------------------------------------------------------------- */
+    if( !pfnProgress( 0.0, nullptr, pProgressData ) )
+    {
+        CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        return CE_Failure;
+    }
+
+    const int nXSize = GDALGetRasterBandXSize(hSrcBand);
+    const int nYSize = GDALGetRasterBandYSize(hSrcBand);
+
+    int bDstHasNoData = FALSE;
+    float fDstNoDataValue =
+        static_cast<float>(GDALGetRasterNoDataValue(hDstBand, &bDstHasNoData));
+    if( !bDstHasNoData )
+        fDstNoDataValue = 0.0;
+
+    GDALGeneric3x3ProcessingParams<T> sParams;
+    sParams.nXSize = nXSize;
+    sParams.nYSize = nYSize;
+    sParams.pfnAlg = pfnAlg;
+    sParams.pfnAlg_multisample = pfnAlg_multisample;
+    sParams.pData = pData;
+    sParams.bComputeAtEdges = bComputeAtEdges;
+    sParams.fDstNoDataValue = fDstNoDataValue;
+    const GDALDataType eReadDT =
+        GDALGeneric3x3InitSrcNoData(hSrcBand, sParams);
+
+/* -------------------------------------------------------------------- */
+/*      Strips aligned on the output blocks.                            */
+/* -------------------------------------------------------------------- */
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    GDALGetBlockSize(hDstBand, &nBlockXSize, &nBlockYSize);
+    const int nStripYSize = GDALGetStripYSize(nXSize, nYSize, nBlockYSize);
+
+    const int nThreads = GDALGetNumThreads();
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    CPLMutex* hMutex = nullptr;
+    size_t nMaxStrips = 1;
+    if( nThreads > 1 && nStripYSize < nYSize )
+    {
+        poJobQueue = GDALCreateGlobalThreadPoolJobQueue(nThreads);
+        if( poJobQueue != nullptr )
+        {
+            CPLDebug("GDAL", "gdaldem processing with %d threads", nThreads);
+            hMutex = CPLCreateMutex();
+            CPLReleaseMutex(hMutex);
+            // Bound the number of strips kept in memory, while leaving
+            // enough of them in flight for the calling thread to read the
+            // next strips while the workers compute the previous ones.
+            nMaxStrips = 2 * static_cast<size_t>(nThreads);
+        }
+    }
+    std::deque<GDALGeneric3x3Strip<T>*> apoStrips;
+    // Strips already written, whose buffers can be reused.
+    std::vector<GDALGeneric3x3Strip<T>*> apoFreeStrips;
+
+    // Last source lines of the previous strip, which are the first ones
+    // of the next strip.
+    T* pafHalo = static_cast<T *>(
+        VSI_MALLOC3_VERBOSE(2, sizeof(T), nXSize));
+    int nHaloYOff = 0;
+    int nHaloYCount = 0;
+
+    CPLErr eErr = pafHalo ? CE_None : CE_Failure;
+    for( int iYOff = 0; iYOff < nYSize && eErr == CE_None;
+         iYOff += nStripYSize )
+    {
+        GDALGeneric3x3Strip<T>* poStrip = nullptr;
+        if( !apoFreeStrips.empty() )
+        {
+            poStrip = apoFreeStrips.back();
+            apoFreeStrips.pop_back();
+        }
+        else
+        {
+            poStrip = new GDALGeneric3x3Strip<T>();
+            poStrip->psParams = &sParams;
+            poStrip->hMutex = hMutex;
+            const int nMaxSrcYCount = std::min(nYSize, nStripYSize + 2);
+            poStrip->pafSrc = static_cast<T *>(
+                VSI_MALLOC3_VERBOSE(nMaxSrcYCount, sizeof(T), nXSize));
+            poStrip->pafDst = static_cast<float *>(
+                VSI_MALLOC3_VERBOSE(nStripYSize, sizeof(float), nXSize));
+            if( poStrip->pafSrc == nullptr || poStrip->pafDst == nullptr )
+            {
+                delete poStrip;
+                eErr = CE_Failure;
+                break;
+            }
+        }
+        poStrip->bFinished = false;
+        poStrip->nYOff = iYOff;
+        poStrip->nYCount = std::min(nStripYSize, nYSize - iYOff);
+        poStrip->nSrcYOff = std::max(0, iYOff - 1);
+        poStrip->nSrcYCount =
+            std::min(nYSize, iYOff + poStrip->nYCount + 1) -
+            poStrip->nSrcYOff;
+
+        int nReadYOff = poStrip->nSrcYOff;
+        for( int i = 0; i < nHaloYCount; i++ )
+        {
+            if( nHaloYOff + i == nReadYOff )
+            {
+                memcpy(poStrip->pafSrc +
+                        static_cast<size_t>(nReadYOff - poStrip->nSrcYOff) *
+                                                                    nXSize,
+                       pafHalo + static_cast<size_t>(i) * nXSize,
+                       sizeof(T) * nXSize);
+                nReadYOff++;
+            }
+        }
+        const int nSrcYEnd = poStrip->nSrcYOff + poStrip->nSrcYCount;
+        if( nReadYOff < nSrcYEnd )
+        {
+            eErr = GDALRasterIO(hSrcBand, GF_Read,
+                                0, nReadYOff, nXSize, nSrcYEnd - nReadYOff,
+                                poStrip->pafSrc +
+                                    static_cast<size_t>(
+                                        nReadYOff - poStrip->nSrcYOff) * nXSize,
+                                nXSize, nSrcYEnd - nReadYOff,
+                                eReadDT, 0, 0);
+            if( eErr != CE_None )
+            {
+                delete poStrip;
+                break;
+            }
+        }
+
+        nHaloYCount = std::min(2, poStrip->nSrcYCount);
+        nHaloYOff = nSrcYEnd - nHaloYCount;
+        memcpy(pafHalo,
+               poStrip->pafSrc +
+                static_cast<size_t>(nHaloYOff - poStrip->nSrcYOff) * nXSize,
+               sizeof(T) * nXSize * nHaloYCount);
+
+        if( poJobQueue == nullptr )
+        {
+            poStrip->Compute();
+            apoStrips.push_back(poStrip);
+            eErr = GDALGeneric3x3WriteOldestStrip(
+                apoStrips, apoFreeStrips, nullptr, hMutex, hDstBand, eErr,
+                pfnProgress, pProgressData);
+            continue;
+        }
+
+        while( apoStrips.size() >= nMaxStrips && eErr == CE_None )
+        {
+            eErr = GDALGeneric3x3WriteOldestStrip(
+                apoStrips, apoFreeStrips, poJobQueue.get(), hMutex,
+                hDstBand, eErr, pfnProgress, pProgressData);
+        }
+        if( eErr != CE_None )
+        {
+            delete poStrip;
+            break;
+        }
+        apoStrips.push_back(poStrip);
+        if( !poJobQueue->SubmitJob(GDALGeneric3x3ComputeStripFunc<T>,
+                                   poStrip) )
+        {
+            apoStrips.pop_back();
+            delete poStrip;
+            eErr = CE_Failure;
+        }
+    }
+
+    // Wait for the pending strips, and write them if no error occurred.
+    while( !apoStrips.empty() )
+    {
+        eErr = GDALGeneric3x3WriteOldestStrip(
+            apoStrips, apoFreeStrips, poJobQueue.get(), hMutex,
+            hDstBand, eErr, pfnProgress, pProgressData);
+    }
+
+    for( size_t i = 0; i < apoFreeStrips.size(); i++ )
+        delete apoFreeStrips[i];
+    poJobQueue.reset();
+    if( hMutex )
+        CPLDestroyMutex(hMutex);
+    VSIFree(pafHalo);
+
+    if( eErr == CE_None )
+        pfnProgress( 1.0, nullptr, pProgressData );
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                            GradientAlg                               */
+/************************************************************************/
+
+typedef enum
+{
+    HORN,
+    ZEVENBERGEN_THORNE
+} GradientAlg;
+
+template<class T, GradientAlg alg> struct Gradient
+{
+    static void inline calc(const T* afWin, double inv_ewres, double inv_nsres,
+                            double&x, double&y);
+};
+
+template<class T> struct Gradient<T, HORN>
+{
+    static void calc(const T* afWin, double inv_ewres, double inv_nsres,
+                     double&x, double&y)
+    {
+        x = ((afWin[0] + afWin[3] + afWin[3] + afWin[6]) -
+             (afWin[2] + afWin[5] + afWin[5] + afWin[8])) * inv_ewres;
+
+        y = ((afWin[6] + afWin[7] + afWin[7] + afWin[8]) -
+             (afWin[0] + afWin[1] + afWin[1] + afWin[2])) * inv_nsres;
+    }
+};
+
+template<class T> struct Gradient<T, ZEVENBERGEN_THORNE>
+{
+    static void calc(const T* afWin, double inv_ewres, double inv_nsres,
+                     double&x, double&y)
+    {
+        x = (afWin[3] - afWin[5]) * inv_ewres;
+        y = (afWin[7] - afWin[1]) * inv_nsres;
+    }
+};
+
+/************************************************************************/
+/*                         GDALHillshade()                              */
+/************************************************************************/
+
+typedef struct
+{
+    double inv_nsres;
+    double inv_ewres;
+    double sin_altRadians;
+    double cos_alt_mul_z;
+    double azRadians;
+    double cos_az_mul_cos_alt_mul_z;
+    double sin_az_mul_cos_alt_mul_z;
+    double square_z;
+    double sin_altRadians_mul_254;
+    double cos_az_mul_cos_alt_mul_z_mul_254;
+    double sin_az_mul_cos_alt_mul_z_mul_254;
+
+    double square_z_mul_square_inv_res;
+    double cos_az_mul_cos_alt_mul_z_mul_254_mul_inv_res;
+    double sin_az_mul_cos_alt_mul_z_mul_254_mul_inv_res;
+} GDALHillshadeAlgData;
+
+/* Unoptimized formulas are :
+    x = psData->z*((afWin[0] + afWin[3] + afWin[3] + afWin[6]) -
+        (afWin[2] + afWin[5] + afWin[5] + afWin[8])) /
+        (8.0 * psData->ewres * psData->scale);
+
+    y = psData->z*((afWin[6] + afWin[7] + afWin[7] + afWin[8]) -
+        (afWin[0] + afWin[1] + afWin[1] + afWin[2])) /
+        (8.0 * psData->nsres * psData->scale);
+
+    slope = atan(sqrt(x*x + y*y));
+
+    aspect = atan2(y,x);
+
+    cang = sin(alt) * cos(slope) +
+           cos(alt) * sin(slope) *
+           cos(az - M_PI/2 - aspect);
+
+We can avoid a lot of trigonometric computations:
+
+    since cos(atan(x)) = 1 / sqrt(1+x^2)
+      ==> cos(slope) = 1 / sqrt(1+ x*x+y*y)
+
+      and sin(atan(x)) = x / sqrt(1+x^2)
+      ==> sin(slope) = sqrt(x*x + y*y) / sqrt(1+ x*x+y*y)
+
+      and cos(az - M_PI/2 - aspect)
+        = cos(-az + M_PI/2 + aspect)
+        = cos(M_PI/2 - (az - aspect))
+        = sin(az - aspect)
+        = -sin(aspect-az)
+
+==> cang = (sin(alt) - cos(alt) * sqrt(x*x + y*y)  * sin(aspect-as)) /
+           sqrt(1+ x*x+y*y)
+
+    But:
+    sin(aspect - az) = sin(aspect)*cos(az) - cos(aspect)*sin(az))
+
+and as sin(aspect)=sin(atan2(y,x)) = y / sqrt(xx_plus_yy)
+   and cos(aspect)=cos(atan2(y,x)) = x / sqrt(xx_plus_yy)
+
+    sin(aspect - az) = (y * cos(az) - x * sin(az)) / sqrt(xx_plus_yy)
+
+so we get a final formula with just one transcendental function
+(reciprocal of square root):
+
+    cang = (psData->sin_altRadians -
+           (y * psData->cos_az_mul_cos_alt_mul_z -
+            x * psData->sin_az_mul_cos_alt_mul_z)) /
+           sqrt(1 + psData->square_z * xx_plus_yy);
+*/
+
+#ifdef HAVE_SSE2
+inline double ApproxADivByInvSqrtB( double a, double b )
+{
+    __m128d regB = _mm_load_sd( &b );
+    __m128d regB_half = _mm_mul_sd( regB, _mm_set1_pd( 0.5 ) );
+    // Compute rough approximation of 1 / sqrt(b) with _mm_rsqrt_ss
+    regB = _mm_cvtss_sd( regB, _mm_rsqrt_ss(
+                            _mm_cvtsd_ss( _mm_setzero_ps(), regB ) ) );
+    // And perform one step of Newton-Raphson approximation to improve it
+    // approx_inv_sqrt_x = approx_inv_sqrt_x*(1.5 -
+    //                            0.5*x*approx_inv_sqrt_x*approx_inv_sqrt_x);
+    regB = _mm_mul_sd(regB, _mm_sub_sd( _mm_set1_pd( 1.5 ),
+                                        _mm_mul_sd(regB_half,
+                                                   _mm_mul_sd(regB, regB)) ) );
+    double dOut;
+    _mm_store_sd( &dOut, regB );
+    return a * dOut;
+}
+#else
+inline double ApproxADivByInvSqrtB( double a, double b )
+{
+    return a / sqrt(b);
+}
+#endif
+
+template<class T, GradientAlg alg>
+static
+float GDALHillshadeAlg (const T* afWin, float /*fDstNoDataValue*/, void* pData)
+{
+    GDALHillshadeAlgData* psData = static_cast<GDALHillshadeAlgData*>(pData);
+
+    // First Slope ...
+    double x, y;
+    Gradient<T, alg>::calc(afWin, psData->inv_ewres, psData->inv_nsres, x, y);
+
+    const double xx_plus_yy = x * x + y * y;
+
+    // ... then the shade value
+    const double cang_mul_254 =
+        ApproxADivByInvSqrtB(
+            psData->sin_altRadians_mul_254 -
+            (y * psData->cos_az_mul_cos_alt_mul_z_mul_254 -
+             x * psData->sin_az_mul_cos_alt_mul_z_mul_254),
+            1 + psData->square_z * xx_plus_yy);
+
+    const double cang = cang_mul_254 <= 0.0 ? 1.0 : 1.0 + cang_mul_254;
+
+    return static_cast<float>(cang);
+}
+
+template<class T>
+static
+float GDALHillshadeAlg_same_res (const T* afWin, float /*fDstNoDataValue*/, void* pData)
+{
+    GDALHillshadeAlgData* psData = static_cast<GDALHillshadeAlgData*>(pData);
+
+    // First Slope ...
+    /*x = (afWin[0] + afWin[3] + afWin[3] + afWin[6]) -
+        (afWin[2] + afWin[5] + afWin[5] + afWin[8]);
+
+    y = (afWin[0] + afWin[1] + afWin[1] + afWin[2]) -
+        (afWin[6] + afWin[7] + afWin[7] + afWin[8]);*/
+
+    T accX = afWin[0] - afWin[8];
+    const T six_minus_two = afWin[6] - afWin[2];
+    T accY = accX;
+    const T three_minus_five = afWin[3] - afWin[5];
+    const T one_minus_seven = afWin[1] - afWin[7];
+    accX += three_minus_five;
+    accY += one_minus_seven;
+    accX += three_minus_five;
+    accY += one_minus_seven;
+    accX += six_minus_two;
+    accY -= six_minus_two;
+    const double x = accX;
+    const double y = accY;
+
+    const double xx_plus_yy = x * x + y * y;
+
+    // ... then the shade value
+    const double cang_mul_254 =
+        ApproxADivByInvSqrtB(
+            psData->sin_altRadians_mul_254 +
+            (x * psData->sin_az_mul_cos_alt_mul_z_mul_254_mul_inv_res +
+             y * psData->cos_az_mul_cos_alt_mul_z_mul_254_mul_inv_res),
+            1 + psData->square_z_mul_square_inv_res * xx_plus_yy);
+
+    const double cang = cang_mul_254 <= 0.0 ? 1.0 : 1.0 + cang_mul_254;
+
+    return static_cast<float>(cang);
+}
+
+#ifdef HAVE_16_SSE_REG
+template<class T>
+static
+int GDALHillshadeAlg_same_res_multisample( const T* pafThreeLineWin,
+                                           int nLine1Off,
+                                           int nLine2Off,
+                                           int nLine3Off,
+                                           int nXSize,
+                                           void* pData,
+                                           float* pafOutputBuf )
+{
+    // Only valid for T == int
+
+    GDALHillshadeAlgData* psData = static_cast<GDALHillshadeAlgData*>(pData);
+    const __m128d reg_fact_x = _mm_load1_pd(
+                      &(psData->sin_az_mul_cos_alt_mul_z_mul_254_mul_inv_res));
+    const __m128d reg_fact_y = _mm_load1_pd (
+                      &(psData->cos_az_mul_cos_alt_mul_z_mul_254_mul_inv_res));
+    const __m128d reg_constant_num = _mm_load1_pd(
+                      &(psData->sin_altRadians_mul_254));
+    const __m128d reg_constant_denom = _mm_load1_pd(
+                      &(psData->square_z_mul_square_inv_res));
+    const __m128d reg_half = _mm_set1_pd(0.5);
+    const __m128d reg_one = _mm_add_pd(reg_half, reg_half);
+    const __m128 reg_one_float = _mm_set1_ps(1);
+
+    int j = 1;  // Used after for.
+    for( ; j < nXSize - 4; j+= 4 )
+    {
+        const T* firstLine  = pafThreeLineWin + nLine1Off + j-1;
+        const T* secondLine = pafThreeLineWin + nLine2Off + j-1;
+        const T* thirdLine  = pafThreeLineWin + nLine3Off + j-1;
+
+        __m128i firstLine0 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(firstLine) );
+        __m128i firstLine1 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(firstLine + 1) );
+        __m128i firstLine2 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(firstLine + 2) );
+        __m128i thirdLine0 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(thirdLine) );
+        __m128i thirdLine1 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(thirdLine + 1) );
+        __m128i thirdLine2 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(thirdLine + 2) );
+        __m128i accX = _mm_sub_epi32( firstLine0, thirdLine2);
+        const __m128i six_minus_two = _mm_sub_epi32( thirdLine0, firstLine2 );
+        __m128i accY = accX;
+        const __m128i three_minus_five = _mm_sub_epi32(
+                          _mm_loadu_si128( reinterpret_cast<__m128i const*>(secondLine) ),
+                          _mm_loadu_si128( reinterpret_cast<__m128i const*>(secondLine+2) ) );
+        const __m128i one_minus_seven = _mm_sub_epi32( firstLine1, thirdLine1 );
+        accX = _mm_add_epi32(accX, three_minus_five);
+        accY = _mm_add_epi32(accY, one_minus_seven);
+        accX = _mm_add_epi32(accX, three_minus_five);
+        accY = _mm_add_epi32(accY, one_minus_seven);
+        accX = _mm_add_epi32(accX, six_minus_two);
+        accY = _mm_sub_epi32(accY, six_minus_two);
+
+        __m128d reg_x0 = _mm_cvtepi32_pd(accX);
+        __m128d reg_x1 = _mm_cvtepi32_pd(_mm_srli_si128(accX, 8));
+        __m128d reg_y0 = _mm_cvtepi32_pd(accY);
+        __m128d reg_y1 = _mm_cvtepi32_pd(_mm_srli_si128(accY, 8));
+        __m128d reg_xx_plus_yy0 = _mm_add_pd( _mm_mul_pd(reg_x0, reg_x0),
+                                              _mm_mul_pd(reg_y0, reg_y0) );
+        __m128d reg_xx_plus_yy1 = _mm_add_pd( _mm_mul_pd(reg_x1, reg_x1),
+                                              _mm_mul_pd(reg_y1, reg_y1) );
+
+        __m128d reg_numerator0 = _mm_add_pd(reg_constant_num,
+                  _mm_add_pd( _mm_mul_pd(reg_fact_x, reg_x0),
+                              _mm_mul_pd(reg_fact_y, reg_y0) ) );
+        __m128d reg_numerator1 = _mm_add_pd(reg_constant_num,
+                  _mm_add_pd( _mm_mul_pd(reg_fact_x, reg_x1),
+                              _mm_mul_pd(reg_fact_y, reg_y1) ) );
+        __m128d reg_denominator0 = _mm_add_pd(reg_one,
+                              _mm_mul_pd(reg_constant_denom, reg_xx_plus_yy0));
+        __m128d reg_denominator1 = _mm_add_pd(reg_one,
+                              _mm_mul_pd(reg_constant_denom, reg_xx_plus_yy1));
+
+        __m128d regB0 = reg_denominator0;
+        __m128d regB1 = reg_denominator1;
+        __m128d regB0_half = _mm_mul_pd( regB0, reg_half );
+        __m128d regB1_half = _mm_mul_pd( regB1, reg_half );
+        // Compute rough approximation of 1 / sqrt(b) with _mm_rsqrt_ps
+        regB0 = _mm_cvtps_pd( _mm_rsqrt_ps( _mm_cvtpd_ps( regB0 ) ) );
+        regB1 = _mm_cvtps_pd( _mm_rsqrt_ps( _mm_cvtpd_ps( regB1 ) ) );
+        // And perform one step of Newton-Raphson approximation to improve it
+        // approx_inv_sqrt_x = approx_inv_sqrt_x*(1.5 -
+        //                            0.5*x*approx_inv_sqrt_x*approx_inv_sqrt_x);
+        const __m128d reg_one_and_a_half = _mm_add_pd(reg_one, reg_half);
+        regB0 = _mm_mul_pd(regB0, _mm_sub_pd( reg_one_and_a_half,
+                                             _mm_mul_pd(regB0_half,
+                                                  _mm_mul_pd(regB0, regB0)) ) );
+        regB1 = _mm_mul_pd(regB1, _mm_sub_pd( reg_one_and_a_half,
+                                            _mm_mul_pd(regB1_half,
+                                                  _mm_mul_pd(regB1, regB1)) ) );
+        reg_numerator0 = _mm_mul_pd(reg_numerator0, regB0);
+        reg_numerator1 = _mm_mul_pd(reg_numerator1, regB1);
+
+        __m128 res = _mm_castsi128_ps(
+          _mm_unpacklo_epi64 (_mm_castps_si128(_mm_cvtpd_ps(reg_numerator0)),
+                              _mm_castps_si128(_mm_cvtpd_ps(reg_numerator1))));
+        res = _mm_add_ps(res, reg_one_float);
+        res = _mm_max_ps(res, reg_one_float);
+
+        _mm_storeu_ps( pafOutputBuf + j, res);
+    }
+    return j;
+}
+#endif
+
+#ifdef HAVE_16_SSE_REG
+
+/************************************************************************/
+/*                           GDALDEMSSE2Ops                             */
+/************************************************************************/
+
+// Operations on 4 source values, done in the type of the source values,
+// as in the scalar Gradient code.
+template<class T> struct GDALDEMSSE2Ops;
+
+template<> struct GDALDEMSSE2Ops<float>
+{
+    typedef __m128 Reg;
+    static Reg Load( const float* p ) { return _mm_loadu_ps(p); }
+    static Reg Add( Reg a, Reg b ) { return _mm_add_ps(a, b); }
+    static Reg Sub( Reg a, Reg b ) { return _mm_sub_ps(a, b); }
+    static void ToDouble( Reg a, __m128d& lo, __m128d& hi )
+    {
+        lo = _mm_cvtps_pd(a);
+        hi = _mm_cvtps_pd(_mm_movehl_ps(a, a));
+    }
+};
+
+template<> struct GDALDEMSSE2Ops<GInt32>
+{
+    typedef __m128i Reg;
+    static Reg Load( const GInt32* p )
+    {
+        return _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+    }
+    static Reg Add( Reg a, Reg b ) { return _mm_add_epi32(a, b); }
+    static Reg Sub( Reg a, Reg b ) { return _mm_sub_epi32(a, b); }
+    static void ToDouble( Reg a, __m128d& lo, __m128d& hi )
+    {
+        lo = _mm_cvtepi32_pd(a);
+        hi = _mm_cvtepi32_pd(_mm_srli_si128(a, 8));
+    }
+};
+
+/************************************************************************/
+/*                           GradientSSE2                               */
+/************************************************************************/
+
+// Unscaled gradients of 4 consecutive pixels, given the first value of their
+// 3x3 windows in each line. Same operations as in Gradient<T, alg>::calc().
+template<class T, GradientAlg alg> struct GradientSSE2
+{
+    static void calc( const T* firstLine, const T* secondLine,
+                      const T* thirdLine,
+                      typename GDALDEMSSE2Ops<T>::Reg& accX,
+                      typename GDALDEMSSE2Ops<T>::Reg& accY );
+};
+
+template<class T> struct GradientSSE2<T, HORN>
+{
+    static void calc( const T* firstLine, const T* secondLine,
+                      const T* thirdLine,
+                      typename GDALDEMSSE2Ops<T>::Reg& accX,
+                      typename GDALDEMSSE2Ops<T>::Reg& accY )
+    {
+        typedef GDALDEMSSE2Ops<T> Ops;
+        const typename Ops::Reg w0 = Ops::Load(firstLine);
+        const typename Ops::Reg w1 = Ops::Load(firstLine + 1);
+        const typename Ops::Reg w2 = Ops::Load(firstLine + 2);
+        const typename Ops::Reg w3 = Ops::Load(secondLine);
+        const typename Ops::Reg w5 = Ops::Load(secondLine + 2);
+        const typename Ops::Reg w6 = Ops::Load(thirdLine);
+        const typename Ops::Reg w7 = Ops::Load(thirdLine + 1);
+        const typename Ops::Reg w8 = Ops::Load(thirdLine + 2);
+        accX = Ops::Sub(Ops::Add(Ops::Add(Ops::Add(w0, w3), w3), w6),
+                        Ops::Add(Ops::Add(Ops::Add(w2, w5), w5), w8));
+        accY = Ops::Sub(Ops::Add(Ops::Add(Ops::Add(w6, w7), w7), w8),
+                        Ops::Add(Ops::Add(Ops::Add(w0, w1), w1), w2));
+    }
+};
+
+template<class T> struct GradientSSE2<T, ZEVENBERGEN_THORNE>
+{
+    static void calc( const T* firstLine, const T* secondLine,
+                      const T* thirdLine,
+                      typename GDALDEMSSE2Ops<T>::Reg& accX,
+                      typename GDALDEMSSE2Ops<T>::Reg& accY )
+    {
+        typedef GDALDEMSSE2Ops<T> Ops;
+        accX = Ops::Sub(Ops::Load(secondLine), Ops::Load(secondLine + 2));
+        accY = Ops::Sub(Ops::Load(thirdLine + 1), Ops::Load(firstLine + 1));
+    }
+};
+
+/************************************************************************/
+/*                    GDALHillshadeSSE2ComputeShade()                   */
+/************************************************************************/
+
+// Computes the shade of 2 pixels from the numerator and denominator of
+// ApproxADivByInvSqrtB(), with the same operations as the scalar code.
+static inline __m128 GDALHillshadeSSE2ComputeShade( __m128d reg_numerator,
+                                                    __m128d reg_denominator )
+{
+    const __m128d reg_one = _mm_set1_pd(1.0);
+    __m128d regB = reg_denominator;
+    const __m128d regB_half = _mm_mul_pd( regB, _mm_set1_pd(0.5) );
+    // Compute rough approximation of 1 / sqrt(b) with _mm_rsqrt_ps
+    regB = _mm_cvtps_pd( _mm_rsqrt_ps( _mm_cvtpd_ps( regB ) ) );
+    // And perform one step of Newton-Raphson approximation to improve it
+    regB = _mm_mul_pd(regB, _mm_sub_pd( _mm_set1_pd(1.5),
+                                        _mm_mul_pd(regB_half,
+                                                   _mm_mul_pd(regB, regB)) ) );
+    const __m128d cang_mul_254 = _mm_mul_pd(reg_numerator, regB);
+
+    // cang = cang_mul_254 <= 0.0 ? 1.0 : 1.0 + cang_mul_254
+    const __m128d mask = _mm_cmple_pd(cang_mul_254, _mm_setzero_pd());
+    const __m128d cang =
+        _mm_or_pd(_mm_and_pd(mask, reg_one),
+                  _mm_andnot_pd(mask, _mm_add_pd(reg_one, cang_mul_254)));
+    return _mm_cvtpd_ps(cang);
+}
+
+/************************************************************************/
+/*                    GDALHillshadeAlg_multisample()                    */
+/************************************************************************/
+
+// Processes 4 pixels at a time, with the same results as
+// GDALHillshadeAlg<T, alg>, or GDALHillshadeAlg_same_res<T> if bSameRes is
+// set (only with HORN).
+template<class T, GradientAlg alg, bool bSameRes>
+static
+int GDALHillshadeAlg_multisample( const T* pafThreeLineWin,
+                                  int nLine1Off,
+                                  int nLine2Off,
+                                  int nLine3Off,
+                                  int nXSize,
+                                  void* pData,
+                                  float* pafOutputBuf )
+{
+    typedef GDALDEMSSE2Ops<T> Ops;
+    GDALHillshadeAlgData* psData = static_cast<GDALHillshadeAlgData*>(pData);
+    const __m128d reg_inv_ewres = _mm_set1_pd(psData->inv_ewres);
+    const __m128d reg_inv_nsres = _mm_set1_pd(psData->inv_nsres);
+    const __m128d reg_fact_x = _mm_set1_pd( bSameRes ?
+        psData->sin_az_mul_cos_alt_mul_z_mul_254_mul_inv_res :
+        psData->sin_az_mul_cos_alt_mul_z_mul_254 );
+    const __m128d reg_fact_y = _mm_set1_pd( bSameRes ?
+        psData->cos_az_mul_cos_alt_mul_z_mul_254_mul_inv_res :
+        psData->cos_az_mul_cos_alt_mul_z_mul_254 );
+    const __m128d reg_constant_num =
+        _mm_set1_pd(psData->sin_altRadians_mul_254);
+    const __m128d reg_constant_denom = _mm_set1_pd( bSameRes ?
+        psData->square_z_mul_square_inv_res : psData->square_z );
+    const __m128d reg_one = _mm_set1_pd(1.0);
+
+    int j = 1;  // Used after for.
+    for( ; j < nXSize - 4; j += 4 )
+    {
+        const T* firstLine  = pafThreeLineWin + nLine1Off + j-1;
+        const T* secondLine = pafThreeLineWin + nLine2Off + j-1;
+        const T* thirdLine  = pafThreeLineWin + nLine3Off + j-1;
+
+        typename Ops::Reg accX;
+        typename Ops::Reg accY;
+        if( bSameRes )
+        {
+            // Same operations as in GDALHillshadeAlg_same_res()
+            const typename Ops::Reg firstLine2 = Ops::Load(firstLine + 2);
+            const typename Ops::Reg thirdLine1 = Ops::Load(thirdLine + 1);
+            accX = Ops::Sub(Ops::Load(firstLine), Ops::Load(thirdLine + 2));
+            const typename Ops::Reg six_minus_two =
+                Ops::Sub(Ops::Load(thirdLine), firstLine2);
+            accY = accX;
+            const typename Ops::Reg three_minus_five =
+                Ops::Sub(Ops::Load(secondLine), Ops::Load(secondLine + 2));
+            const typename Ops::Reg one_minus_seven =
+                Ops::Sub(Ops::Load(firstLine + 1), thirdLine1);
+            accX = Ops::Add(accX, three_minus_five);
+            accY = Ops::Add(accY, one_minus_seven);
+            accX = Ops::Add(accX, three_minus_five);
+            accY = Ops::Add(accY, one_minus_seven);
+            accX = Ops::Add(accX, six_minus_two);
+            accY = Ops::Sub(accY, six_minus_two);
+        }
+        else
+        {
+            GradientSSE2<T, alg>::calc(firstLine, secondLine, thirdLine,
+                                       accX, accY);
+        }
+
+        __m128d reg_x0, reg_x1, reg_y0, reg_y1;
+        Ops::ToDouble(accX, reg_x0, reg_x1);
+        Ops::ToDouble(accY, reg_y0, reg_y1);
+
+        __m128d reg_numerator0, reg_numerator1;
+        if( bSameRes )
+        {
+            reg_numerator0 = _mm_add_pd(reg_constant_num,
+                  _mm_add_pd( _mm_mul_pd(reg_x0, reg_fact_x),
+                              _mm_mul_pd(reg_y0, reg_fact_y) ) );
+            reg_numerator1 = _mm_add_pd(reg_constant_num,
+                  _mm_add_pd( _mm_mul_pd(reg_x1, reg_fact_x),
+                              _mm_mul_pd(reg_y1, reg_fact_y) ) );
+        }
+        else
+        {
+            reg_x0 = _mm_mul_pd(reg_x0, reg_inv_ewres);
+            reg_x1 = _mm_mul_pd(reg_x1, reg_inv_ewres);
+            reg_y0 = _mm_mul_pd(reg_y0, reg_inv_nsres);
+            reg_y1 = _mm_mul_pd(reg_y1, reg_inv_nsres);
+            reg_numerator0 = _mm_sub_pd(reg_constant_num,
+                  _mm_sub_pd( _mm_mul_pd(reg_y0, reg_fact_y),
+                              _mm_mul_pd(reg_x0, reg_fact_x) ) );
+            reg_numerator1 = _mm_sub_pd(reg_constant_num,
+                  _mm_sub_pd( _mm_mul_pd(reg_y1, reg_fact_y),
+                              _mm_mul_pd(reg_x1, reg_fact_x) ) );
+        }
+
+        const __m128d reg_xx_plus_yy0 = _mm_add_pd(
+            _mm_mul_pd(reg_x0, reg_x0), _mm_mul_pd(reg_y0, reg_y0) );
+        const __m128d reg_xx_plus_yy1 = _mm_add_pd(
+            _mm_mul_pd(reg_x1, reg_x1), _mm_mul_pd(reg_y1, reg_y1) );
+        const __m128d reg_denominator0 = _mm_add_pd(reg_one,
+                              _mm_mul_pd(reg_constant_denom, reg_xx_plus_yy0));
+        const __m128d reg_denominator1 = _mm_add_pd(reg_one,
+                              _mm_mul_pd(reg_constant_denom, reg_xx_plus_yy1));
+
+        const __m128 res = _mm_movelh_ps(
+            GDALHillshadeSSE2ComputeShade(reg_numerator0, reg_denominator0),
+            GDALHillshadeSSE2ComputeShade(reg_numerator1, reg_denominator1));
+        _mm_storeu_ps( pafOutputBuf + j, res );
+    }
+    return j;
+}
+#endif
+
+static const double INV_SQUARE_OF_HALF_PI = 1.0 / ((M_PI*M_PI)/4);
+
+template<class T, GradientAlg alg>
+static
+float GDALHillshadeCombinedAlg (const T* afWin, float /*fDstNoDataValue*/, void* pData)
+{
+    GDALHillshadeAlgData* psData = static_cast<GDALHillshadeAlgData*>(pData);
+
+    // First Slope ...
+    double x, y;
+    Gradient<T, alg>::calc(afWin, psData->inv_ewres, psData->inv_nsres, x, y);
+
+    const double xx_plus_yy = x * x + y * y;
+
+    const double slope = xx_plus_yy * psData->square_z;
+
+    // ... then the shade value
+    double cang =
+        acos(
+            ApproxADivByInvSqrtB(
+                psData->sin_altRadians -
+                (y * psData->cos_az_mul_cos_alt_mul_z -
+                 x * psData->sin_az_mul_cos_alt_mul_z),
+                1 + slope));
+
+    // combined shading
+    cang = 1 - cang * atan(sqrt(slope)) * INV_SQUARE_OF_HALF_PI;
+
+    const float fcang =
+        cang <= 0.0
+        ? 1.0f
+        : static_cast<float>(1.0 + (254.0 * cang));
+
+    return fcang;
+}
+
+static
+void* GDALCreateHillshadeData( const double* adfGeoTransform,
+                               double z,
+                               double scale,
+                               double alt,
+                               double az,
+                               bool bZevenbergenThorne )
+{
+    GDALHillshadeAlgData* pData = static_cast<GDALHillshadeAlgData *>(
+        CPLCalloc(1, sizeof(GDALHillshadeAlgData)));
+
+    pData->inv_nsres = 1.0 / adfGeoTransform[5];
+    pData->inv_ewres = 1.0 / adfGeoTransform[1];
+    pData->sin_altRadians = sin(alt * kdfDegreesToRadians);
+    pData->azRadians = az * kdfDegreesToRadians;
+    const double z_scaled = z / ((bZevenbergenThorne ? 2 : 8) * scale);
+    pData->cos_alt_mul_z =
+        cos(alt * kdfDegreesToRadians) * z_scaled;
+    pData->cos_az_mul_cos_alt_mul_z =
+        cos(pData->azRadians) * pData->cos_alt_mul_z;
+    pData->sin_az_mul_cos_alt_mul_z =
+        sin(pData->azRadians) * pData->cos_alt_mul_z;
+    pData->square_z = z_scaled * z_scaled;
+
+    pData->sin_altRadians_mul_254 = 254.0 *
+                                    pData->sin_altRadians;
+    pData->cos_az_mul_cos_alt_mul_z_mul_254 = 254.0 *
+        pData->cos_az_mul_cos_alt_mul_z;
+    pData->sin_az_mul_cos_alt_mul_z_mul_254 = 254.0 *
+        pData->sin_az_mul_cos_alt_mul_z;
+
+    if( adfGeoTransform[1] == -adfGeoTransform[5] )
+    {
+        pData->square_z_mul_square_inv_res =
+          pData->square_z * pData->inv_ewres * pData->inv_ewres;
+        pData->cos_az_mul_cos_alt_mul_z_mul_254_mul_inv_res =
+          pData->cos_az_mul_cos_alt_mul_z_mul_254 * -pData->inv_ewres;
+        pData->sin_az_mul_cos_alt_mul_z_mul_254_mul_inv_res =
+          pData->sin_az_mul_cos_alt_mul_z_mul_254 * pData->inv_ewres;
+    }
+
+    return pData;
+}
+
+/************************************************************************/
+/*                   GDALHillshadeMultiDirectional()                    */
+/************************************************************************/
+
+typedef struct
+{
+    double inv_nsres;
+    double inv_ewres;
+    double square_z;
+    double sin_altRadians_mul_127;
+    double sin_altRadians_mul_254;
+
+    double cos_alt_mul_z_mul_127;
+    double cos225_az_mul_cos_alt_mul_z_mul_127;
+
+} GDALHillshadeMultiDirectionalAlgData;
+
+template<class T, GradientAlg alg>
+static
+float GDALHillshadeMultiDirectionalAlg (const T* afWin,
+                                        float /*fDstNoDataValue*/,
+                                        void* pData)
+{
+    const GDALHillshadeMultiDirectionalAlgData* psData =
+            static_cast<const GDALHillshadeMultiDirectionalAlgData*>(pData);
+
+    // First Slope ...
+    double x, y;
+    Gradient<T, alg>::calc(afWin, psData->inv_ewres, psData->inv_nsres, x, y);
+
+    // See http://pubs.usgs.gov/of/1992/of92-422/of92-422.pdf
+    // W225 = sin^2(aspect - 225) = 0.5 * (1 - 2 * sin(aspect) * cos(aspect))
+    // W270 = sin^2(aspect - 270) = cos^2(aspect)
+    // W315 = sin^2(aspect - 315) = 0.5 * (1 + 2 * sin(aspect) * cos(aspect))
+    // W360 = sin^2(aspect - 360) = sin^2(aspect)
+    // hillshade=  0.5 * (W225 * hillshade(az=225) +
+    //                    W270 * hillshade(az=270) +
+    //                    W315 * hillshade(az=315) +
+    //                    W360 * hillshade(az=360))
+
+    const double xx = x * x;
+    const double yy = y * y;
+    const double xx_plus_yy = xx + yy;
+    if( xx_plus_yy == 0.0 )
+        return static_cast<float>(1.0 + psData->sin_altRadians_mul_254);
+
+    // ... then the shade value from different azimuth
+    double val225_mul_127 = psData->sin_altRadians_mul_127 +
+                            (x-y) * psData->cos225_az_mul_cos_alt_mul_z_mul_127;
+    val225_mul_127 = ( val225_mul_127 <= 0.0) ? 0.0 : val225_mul_127;
+    double val270_mul_127 = psData->sin_altRadians_mul_127 -
+                            x * psData->cos_alt_mul_z_mul_127;
+    val270_mul_127 = ( val270_mul_127 <= 0.0) ? 0.0 : val270_mul_127;
+    double val315_mul_127 = psData->sin_altRadians_mul_127 +
+                            (x+y) * psData->cos225_az_mul_cos_alt_mul_z_mul_127;
+    val315_mul_127 = ( val315_mul_127 <= 0.0) ? 0.0 : val315_mul_127;
+    double val360_mul_127 = psData->sin_altRadians_mul_127 -
+                            y * psData->cos_alt_mul_z_mul_127;
+    val360_mul_127 = ( val360_mul_127 <= 0.0) ? 0.0 : val360_mul_127;
+
+    // ... then the weighted shading
+    const double weight_225 = 0.5 * xx_plus_yy - x * y;
+    const double weight_270 = xx;
+    const double weight_315 = xx_plus_yy - weight_225;
+    const double weight_360 = yy;
+    const double cang_mul_127 = ApproxADivByInvSqrtB(
+                  (weight_225 * val225_mul_127 +
+                   weight_270 * val270_mul_127 +
+                   weight_315 * val315_mul_127 +
+                   weight_360 * val360_mul_127) / xx_plus_yy,
+            1 + psData->square_z * xx_plus_yy);
+
+    const double cang = 1.0 + cang_mul_127;
+
+    return static_cast<float>(cang);
+}
+
+static
+void* GDALCreateHillshadeMultiDirectionalData( const double* adfGeoTransform,
+                                               double z,
+                                               double scale,
+                                               double alt,
+                                               bool bZevenbergenThorne )
+{
+    GDALHillshadeMultiDirectionalAlgData* pData =
+      static_cast<GDALHillshadeMultiDirectionalAlgData *>(
+          CPLCalloc(1, sizeof(GDALHillshadeMultiDirectionalAlgData)));
+
+    pData->inv_nsres = 1.0 / adfGeoTransform[5];
+    pData->inv_ewres = 1.0 / adfGeoTransform[1];
+    const double z_scaled = z / ((bZevenbergenThorne ? 2 : 8) * scale);
+    const double cos_alt_mul_z =
+        cos(alt * kdfDegreesToRadians) * z_scaled;
+    pData->square_z = z_scaled * z_scaled;
+
+    pData->sin_altRadians_mul_127 = 127.0 * sin(alt * kdfDegreesToRadians);
+    pData->sin_altRadians_mul_254 = 254.0 * sin(alt * kdfDegreesToRadians);
+    pData->cos_alt_mul_z_mul_127 = 127.0 * cos_alt_mul_z;
+    pData->cos225_az_mul_cos_alt_mul_z_mul_127 = 127.0 *
+        cos(225 * kdfDegreesToRadians) * cos_alt_mul_z;
+
+    return pData;
+}
+
+/************************************************************************/
+/*                         GDALSlope()                                  */
+/************************************************************************/
+
+typedef struct
+{
+    double nsres;
+    double ewres;
+    double scale;
+    int    slopeFormat;
+} GDALSlopeAlgData;
+
+template<class T>
+static
+float GDALSlopeHornAlg( const T* afWin, float /*fDstNoDataValue*/, void* pData )
+{
+    const GDALSlopeAlgData* psData = static_cast<const GDALSlopeAlgData*>(pData);
+
+    const double dx = ((afWin[0] + afWin[3] + afWin[3] + afWin[6]) -
+          (afWin[2] + afWin[5] + afWin[5] + afWin[8]))/psData->ewres;
+
+    const double dy = ((afWin[6] + afWin[7] + afWin[7] + afWin[8]) -
+          (afWin[0] + afWin[1] + afWin[1] + afWin[2]))/psData->nsres;
+
+    const double key = (dx * dx + dy * dy);
+
+    if( psData->slopeFormat == 1 )
+        return static_cast<float>(
+            atan(sqrt(key) / (8*psData->scale)) * kdfRadiansToDegrees);
+
+    return static_cast<float>(100*(sqrt(key) / (8*psData->scale)));
+}
+
+template<class T>
+static
+float GDALSlopeZevenbergenThorneAlg( const T* afWin,
+                                     float /*fDstNoDataValue*/,
+                                     void* pData )
+{
+    const GDALSlopeAlgData* psData = static_cast<const GDALSlopeAlgData*>(pData);
+
+    const double dx = (afWin[3] - afWin[5]) / psData->ewres;
+    const double dy = (afWin[7] - afWin[1]) / psData->nsres;
+    const double key = dx * dx + dy * dy;
+
+    if( psData->slopeFormat == 1 )
+        return static_cast<float>(
+            atan(sqrt(key) / (2*psData->scale)) * kdfRadiansToDegrees);
+
+    return static_cast<float>(100*(sqrt(key) / (2*psData->scale)));
+}
+
+static
+void* GDALCreateSlopeData( const double* adfGeoTransform,
+                           double scale,
+                           int slopeFormat )
+{
+    GDALSlopeAlgData* pData =
+        static_cast<GDALSlopeAlgData*>(CPLMalloc(sizeof(GDALSlopeAlgData)));
+
+    pData->nsres = adfGeoTransform[5];
+    pData->ewres = adfGeoTransform[1];
+    pData->scale = scale;
+    pData->slopeFormat = slopeFormat;
+    return pData;
+}
+
+/************************************************************************/
+/*                         GDALAspect()                                 */
+/************************************************************************/
+
+typedef struct
+{
+    bool bAngleAsAzimuth;
+} GDALAspectAlgData;
+
+template<class T>
+static
+float GDALAspectAlg( const T* afWin, float fDstNoDataValue, void* pData )
+{
+    const GDALAspectAlgData* psData = static_cast<const GDALAspectAlgData*>(pData);
+
+    const double dx = ((afWin[2] + afWin[5] + afWin[5] + afWin[8]) -
+          (afWin[0] + afWin[3] + afWin[3] + afWin[6]));
+
+    const double dy = ((afWin[6] + afWin[7] + afWin[7] + afWin[8]) -
+          (afWin[0] + afWin[1] + afWin[1] + afWin[2]));
+
+    float aspect = static_cast<float>(atan2(dy,-dx) / kdfDegreesToRadians);
+
+    if( dx == 0 && dy == 0 )
+    {
+        /* Flat area */
+        aspect = fDstNoDataValue;
+    }
+    else if( psData->bAngleAsAzimuth )
+    {
+        if( aspect > 90.0f )
+            aspect = 450.0f - aspect;
+        else
+            aspect = 90.0f - aspect;
+    }
+    else
+    {
+        if( aspect < 0 )
+            aspect += 360.0f;
+    }
+
+    if( aspect == 360.0f )
+        aspect = 0.0;
+
+    return aspect;
+}
+
+template<class T>
+static
+float GDALAspectZevenbergenThorneAlg( const T* afWin, float fDstNoDataValue,
+                                      void* pData )
+{
+    const GDALAspectAlgData* psData = static_cast<const GDALAspectAlgData*>(pData);
+
+    const double dx = afWin[5] - afWin[3];
+    const double dy = afWin[7] - afWin[1];
+    float aspect = static_cast<float>(atan2(dy,-dx) / kdfDegreesToRadians);
+    if( dx == 0 && dy == 0 )
+    {
+        /* Flat area */
+        aspect = fDstNoDataValue;
+    }
+    else if( psData->bAngleAsAzimuth )
+    {
+        if( aspect > 90.0f )
+            aspect = 450.0f - aspect;
+        else
+            aspect = 90.0f - aspect;
+    }
+    else
+    {
+        if( aspect < 0 )
+            aspect += 360.0f;
+    }
+
+    if( aspect == 360.0f )
+        aspect = 0.0;
+
+    return aspect;
+}
+
+static
+void *GDALCreateAspectData( bool bAngleAsAzimuth )
+{
+    GDALAspectAlgData* pData =
+        static_cast<GDALAspectAlgData *>(CPLMalloc(sizeof(GDALAspectAlgData)));
+
+    pData->bAngleAsAzimuth = bAngleAsAzimuth;
+    return pData;
+}
+
+/************************************************************************/
+/*                         GDALTRIAlg()                                 */
+/************************************************************************/
+
+template<class T> static T MyAbs(T x);
+
+template<> float MyAbs( float x ) { return fabsf(x); }
+template<> int MyAbs( int x ) { return x >= 0 ? x : -x; }
+
+template<class T>
+static
+float GDALTRIAlg( const T* afWin,
+                  float /*fDstNoDataValue*/,
+                  void* /*pData*/ )
+{
+    // Terrain Ruggedness is average difference in height
+    return (MyAbs(afWin[0]-afWin[4]) +
+            MyAbs(afWin[1]-afWin[4]) +
+            MyAbs(afWin[2]-afWin[4]) +
+            MyAbs(afWin[3]-afWin[4]) +
+            MyAbs(afWin[5]-afWin[4]) +
+            MyAbs(afWin[6]-afWin[4]) +
+            MyAbs(afWin[7]-afWin[4]) +
+            MyAbs(afWin[8]-afWin[4])) * 0.125f;
+}
+
+/************************************************************************/
+/*                         GDALTPIAlg()                                 */
+/************************************************************************/
+
+template<class T>
+static
+float GDALTPIAlg( const T* afWin,
+                  float /*fDstNoDataValue*/,
+                  void* /*pData*/ )
+{
+    // Terrain Position is the difference between
+    // The central cell and the mean of the surrounding cells
+    return afWin[4] -
+            ((afWin[0]+
+              afWin[1]+
+              afWin[2]+
+              afWin[3]+
+              afWin[5]+
+              afWin[6]+
+              afWin[7]+
+              afWin[8]) * 0.125f );
+}
+
+/************************************************************************/
+/*                     GDALRoughnessAlg()                               */
+/************************************************************************/
+
+template<class T>
+static
+float GDALRoughnessAlg( const T* afWin, float /*fDstNoDataValue*/,
+                        void* /*pData*/ )
+{
+    // Roughness is the largest difference
+    //  between any two cells
+
+    T pafRoughnessMin = afWin[0];
+    T pafRoughnessMax = afWin[0];
+
+    for( int k = 1; k < 9; k++ )
+    {
+        if( afWin[k] > pafRoughnessMax )
+        {
+            pafRoughnessMax=afWin[k];
+        }
+        if( afWin[k] < pafRoughnessMin )
+        {
+            pafRoughnessMin=afWin[k];
+        }
+    }
+    return static_cast<float>(pafRoughnessMax - pafRoughnessMin);
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                       GDALGeneric3x3Dataset                        */
+/* ==================================================================== */
+/************************************************************************/
+
+// On-the-fly dataset computing the output of a 3x3 algorithm by tiles. Each
+// tile is computed from the source window of the tile plus a one pixel halo,
+// with the same results as GDALGeneric3x3Processing(), so that any tile can
+// be requested independently, and computed tiles are kept in the block
+// cache. The dataset holds a reference on the source dataset, and takes
+// ownership of pAlgData.
+
+template<class T>
+class GDALGeneric3x3RasterBand;
+
+template<class T>
+class GDALGeneric3x3Dataset : public GDALDataset
+{
+    friend class GDALGeneric3x3RasterBand<T>;
+
+    GDALGeneric3x3ProcessingParams<T> sParams;
+    GDALDatasetH       hSrcDS;
+    GDALRasterBandH    hSrcBand;
+    GDALDataType       eReadDT;
+    T*                 pafSourceBuf;
+    float*             pafOutputBuf;
+    int                bDstHasNoData;
+    double             dfDstNoDataValue;
+
+  public:
+                        GDALGeneric3x3Dataset(
+                            GDALDatasetH hSrcDS,
+                            GDALRasterBandH hSrcBand,
+                            GDALDataType eDstDataType,
+                            int bDstHasNoData,
+                            double dfDstNoDataValue,
+                            typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg,
+                            typename GDALGeneric3x3ProcessingAlg_multisample<T>::type pfnAlg_multisample,
+                            void* pAlgData,
+                            bool bComputeAtEdges );
+                       ~GDALGeneric3x3Dataset();
+
+    bool                InitOK() const { return pafSourceBuf != nullptr &&
+                                                pafOutputBuf != nullptr; }
+
+    CPLErr      GetGeoTransform( double * padfGeoTransform ) override;
+    const char *GetProjectionRef() override;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                    GDALGeneric3x3RasterBand                       */
+/* ==================================================================== */
+/************************************************************************/
+
+template<class T>
+class GDALGeneric3x3RasterBand : public GDALRasterBand
+{
+    friend class GDALGeneric3x3Dataset<T>;
+
+  public:
+                 GDALGeneric3x3RasterBand( GDALGeneric3x3Dataset<T> *poDS,
+                                           GDALDataType eDstDataType );
+
+    virtual CPLErr          IReadBlock( int, int, void * ) override;
+    virtual double          GetNoDataValue( int* pbHasNoData ) override;
+};
+
+template<class T>
+GDALGeneric3x3Dataset<T>::GDALGeneric3x3Dataset(
+    GDALDatasetH hSrcDSIn,
+    GDALRasterBandH hSrcBandIn,
+    GDALDataType eDstDataType,
+    int bDstHasNoDataIn,
+    double dfDstNoDataValueIn,
+    typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlgIn,
+    typename GDALGeneric3x3ProcessingAlg_multisample<T>::type pfnAlg_multisampleIn,
+    void* pAlgDataIn,
+    bool bComputeAtEdgesIn ) :
+    hSrcDS(hSrcDSIn),
+    hSrcBand(hSrcBandIn),
+    eReadDT(GDT_Unknown),
+    pafSourceBuf(nullptr),
+    pafOutputBuf(nullptr),
+    bDstHasNoData(bDstHasNoDataIn),
+    dfDstNoDataValue(dfDstNoDataValueIn)
+{
+    CPLAssert(eDstDataType == GDT_Byte || eDstDataType == GDT_Float32);
+
+    GDALReferenceDataset(hSrcDS);
+
+    nRasterXSize = GDALGetRasterXSize(hSrcDS);
+    nRasterYSize = GDALGetRasterYSize(hSrcDS);
+
+    sParams.nXSize = nRasterXSize;
+    sParams.nYSize = nRasterYSize;
+    sParams.pfnAlg = pfnAlgIn;
+    sParams.pfnAlg_multisample = pfnAlg_multisampleIn;
+    sParams.pData = pAlgDataIn;
+    sParams.bComputeAtEdges = bComputeAtEdgesIn;
+    sParams.fDstNoDataValue =
+        bDstHasNoData ? static_cast<float>(dfDstNoDataValue) : 0.0f;
+    eReadDT = GDALGeneric3x3InitSrcNoData(hSrcBand, sParams);
+
+    GDALGeneric3x3RasterBand<T>* poBand =
+        new GDALGeneric3x3RasterBand<T>(this, eDstDataType);
+    SetBand(1, poBand);
+
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    pafSourceBuf = static_cast<T *>(VSI_MALLOC3_VERBOSE(
+        sizeof(T), nBlockXSize + 2, nBlockYSize + 2));
+    pafOutputBuf = static_cast<float *>(VSI_MALLOC2_VERBOSE(
+        sizeof(float), nBlockXSize + 2));
+}
+
+template<class T>
+GDALGeneric3x3Dataset<T>::~GDALGeneric3x3Dataset()
+{
+    FlushCache();
+    CPLFree(pafSourceBuf);
+    CPLFree(pafOutputBuf);
+    CPLFree(sParams.pData);
+    GDALReleaseDataset(hSrcDS);
+}
+
+template<class T>
+CPLErr GDALGeneric3x3Dataset<T>::GetGeoTransform( double * padfGeoTransform )
+{
+    return GDALGetGeoTransform(hSrcDS, padfGeoTransform);
+}
+
+template<class T>
+const char *GDALGeneric3x3Dataset<T>::GetProjectionRef()
+{
+    return GDALGetProjectionRef(hSrcDS);
+}
+
+template<class T>
+GDALGeneric3x3RasterBand<T>::GDALGeneric3x3RasterBand(
+    GDALGeneric3x3Dataset<T> *poDSIn,
+    GDALDataType eDstDataType )
+{
+    poDS = poDSIn;
+    nBand = 1;
+    eDataType = eDstDataType;
+    nBlockXSize = std::min(256, poDS->GetRasterXSize());
+    nBlockYSize = std::min(256, poDS->GetRasterYSize());
+}
+
+template<class T>
+CPLErr GDALGeneric3x3RasterBand<T>::IReadBlock( int nBlockXOff,
+                                                int nBlockYOff,
+                                                void *pImage )
+{
+    auto poGDS = cpl::down_cast<GDALGeneric3x3Dataset<T> *>(poDS);
+    const GDALGeneric3x3ProcessingParams<T>& sGlobalParams = poGDS->sParams;
+
+    const int nXOff = nBlockXOff * nBlockXSize;
+    const int nYOff = nBlockYOff * nBlockYSize;
+    const int nReqXSize = std::min(nBlockXSize, nRasterXSize - nXOff);
+    const int nReqYSize = std::min(nBlockYSize, nRasterYSize - nYOff);
+
+/* -------------------------------------------------------------------- */
+/*      Read the source window of the block plus its halo, clamped to   */
+/*      the raster.                                                     */
+/* -------------------------------------------------------------------- */
+    const int nSrcXOff = std::max(0, nXOff - 1);
+    const int nSrcYOff = std::max(0, nYOff - 1);
+    const int nSrcXSize =
+        std::min(nRasterXSize, nXOff + nReqXSize + 1) - nSrcXOff;
+    const int nSrcYSize =
+        std::min(nRasterYSize, nYOff + nReqYSize + 1) - nSrcYOff;
+
+    CPLErr eErr = GDALRasterIO( poGDS->hSrcBand, GF_Read,
+                                nSrcXOff, nSrcYOff, nSrcXSize, nSrcYSize,
+                                poGDS->pafSourceBuf, nSrcXSize, nSrcYSize,
+                                poGDS->eReadDT, 0, 0 );
+    if( eErr != CE_None )
+        return eErr;
+
+/* -------------------------------------------------------------------- */
+/*      Compute the window lines as if the window was the whole raster */
+/*      width. Columns of the halo are computed but not used, so the    */
+/*      edge processing only applies at the edges of the raster, as     */
+/*      the window is at least 2 pixels wide if the raster is.          */
+/* -------------------------------------------------------------------- */
+    GDALGeneric3x3ProcessingParams<T> sParams(sGlobalParams);
+    sParams.nXSize = nSrcXSize;
+
+    // In case none of the 3 lines have nodata values, then no need to
+    // check it in ComputeVal()
+    std::vector<bool> abLineHasNoData(nSrcYSize);
+    for( int i = 0; i < nSrcYSize; i++ )
+    {
+        abLineHasNoData[i] = GDALGeneric3x3LineHasNoData(
+            sParams, poGDS->pafSourceBuf + static_cast<size_t>(i) * nSrcXSize);
+    }
+
+    // The values extrapolated at the left and right edges of the raster may
+    // happen to be equal to the nodata value, so whether they are checked
+    // must not depend on the extent of the window.
+    const bool bHasSideEdge =
+        sParams.bComputeAtEdges &&
+        (nSrcXOff == 0 || nSrcXOff + nSrcXSize == nRasterXSize);
+
+    for( int iY = nYOff; iY < nYOff + nReqYSize; iY++ )
+    {
+        const int iLine = iY - nSrcYOff;
+        bool bLinesHaveNoData = sParams.bSrcHasNoData;
+        if( iY > 0 && iY < nRasterYSize - 1 && !bHasSideEdge )
+        {
+            bLinesHaveNoData = abLineHasNoData[iLine - 1] ||
+                               abLineHasNoData[iLine] ||
+                               abLineHasNoData[iLine + 1];
+        }
+        GDALGeneric3x3ProcessLine(
+            sParams, iY, poGDS->pafSourceBuf,
+            (iLine - 1) * nSrcXSize, iLine * nSrcXSize,
+            (iLine + 1) * nSrcXSize,
+            bLinesHaveNoData, poGDS->pafOutputBuf);
+
+        const float* pafLine = poGDS->pafOutputBuf + (nXOff - nSrcXOff);
+        const size_t nDstOff =
+            static_cast<size_t>(iY - nYOff) * nBlockXSize;
+        if( eDataType == GDT_Byte )
+        {
+            GByte* pabyDst = static_cast<GByte*>(pImage) + nDstOff;
+            for( int j = 0; j < nReqXSize; j++ )
+                pabyDst[j] = static_cast<GByte>(pafLine[j] + 0.5);
+        }
+        else
+        {
+            memcpy(static_cast<float*>(pImage) + nDstOff, pafLine,
+                   nReqXSize * sizeof(float));
+        }
+    }
+
+    return CE_None;
+}
+
+template<class T>
+double GDALGeneric3x3RasterBand<T>::GetNoDataValue( int* pbHasNoData )
+{
+    auto poGDS = cpl::down_cast<GDALGeneric3x3Dataset<T> *>(poDS);
+    if( pbHasNoData )
+        *pbHasNoData = poGDS->bDstHasNoData;
+    return poGDS->dfDstNoDataValue;
+}
+
+/************************************************************************/
+/*                     GDALCreateGeneric3x3Dataset()                    */
+/************************************************************************/
+
+// Instantiates the GDALGeneric3x3Dataset suited to the data type of
+// hSrcBand. pAlgData is owned by the returned dataset, or freed on failure.
+static GDALDataset* GDALCreateGeneric3x3Dataset(
+    GDALDatasetH hSrcDataset,
+    GDALRasterBandH hSrcBand,
+    GDALDataType eDstDataType,
+    bool bDstHasNoData,
+    double dfDstNoDataValue,
+    GDALGeneric3x3ProcessingAlg<float>::type pfnAlgFloat,
+    GDALGeneric3x3ProcessingAlg_multisample<float>::type pfnAlgFloat_multisample,
+    GDALGeneric3x3ProcessingAlg<GInt32>::type pfnAlgInt32,
+    GDALGeneric3x3ProcessingAlg_multisample<GInt32>::type pfnAlgInt32_multisample,
+    void* pAlgData,
+    bool bComputeAtEdges )
+{
+    const GDALDataType eSrcDT = GDALGetRasterDataType(hSrcBand);
+    if( eSrcDT == GDT_Byte ||
+        eSrcDT == GDT_Int16 ||
+        eSrcDT == GDT_UInt16 )
+    {
+        GDALGeneric3x3Dataset<GInt32>* poDS =
+            new GDALGeneric3x3Dataset<GInt32>(hSrcDataset, hSrcBand,
+                                    eDstDataType,
+                                    bDstHasNoData,
+                                    dfDstNoDataValue,
+                                    pfnAlgInt32,
+                                    pfnAlgInt32_multisample,
+                                    pAlgData,
+                                    bComputeAtEdges);
+        if( !(poDS->InitOK()) )
+        {
+            delete poDS;
+            return nullptr;
+        }
+        return poDS;
+    }
+
+    GDALGeneric3x3Dataset<float>* poDS =
+        new GDALGeneric3x3Dataset<float>(hSrcDataset, hSrcBand,
+                                eDstDataType,
+                                bDstHasNoData,
+                                dfDstNoDataValue,
+                                pfnAlgFloat,
+                                pfnAlgFloat_multisample,
+                                pAlgData,
+                                bComputeAtEdges);
+    if( !(poDS->InitOK()) )
+    {
+        delete poDS;
+        return nullptr;
+    }
+    return poDS;
+}
+
+/************************************************************************/
+/*                          GDALDEMAlgorithms                           */
+/************************************************************************/
+
+// The functions computing the algorithm selected by GDALDEMAlgOptions, for
+// both source value types, and their data.
+struct GDALDEMAlgorithms
+{
+    GDALGeneric3x3ProcessingAlg<float>::type pfnAlgFloat = nullptr;
+    GDALGeneric3x3ProcessingAlg<GInt32>::type pfnAlgInt32 = nullptr;
+    GDALGeneric3x3ProcessingAlg_multisample<float>::type
+                                        pfnAlgFloat_multisample = nullptr;
+    GDALGeneric3x3ProcessingAlg_multisample<GInt32>::type
+                                        pfnAlgInt32_multisample = nullptr;
+    void* pData = nullptr;
+};
+
+static void GDALDEMInitAlgorithms( const double* padfGeoTransform,
+                                   const GDALDEMAlgOptions* psOptions,
+                                   GDALDEMAlgorithms& sAlgs )
+{
+    if( psOptions->eAlg == GDEM_HILLSHADE && psOptions->bMultiDirectional )
+    {
+        sAlgs.pData = GDALCreateHillshadeMultiDirectionalData(
+                                        padfGeoTransform,
+                                        psOptions->z,
+                                        psOptions->scale,
+                                        psOptions->alt,
+                                        psOptions->bZevenbergenThorne);
+        if( psOptions->bZevenbergenThorne )
+        {
+            sAlgs.pfnAlgFloat = GDALHillshadeMultiDirectionalAlg<float, ZEVENBERGEN_THORNE>;
+            sAlgs.pfnAlgInt32 = GDALHillshadeMultiDirectionalAlg<GInt32, ZEVENBERGEN_THORNE>;
+        }
+        else
+        {
+            sAlgs.pfnAlgFloat = GDALHillshadeMultiDirectionalAlg<float, HORN>;
+            sAlgs.pfnAlgInt32 = GDALHillshadeMultiDirectionalAlg<GInt32, HORN>;
+        }
+    }
+    else if( psOptions->eAlg == GDEM_HILLSHADE )
+    {
+        sAlgs.pData = GDALCreateHillshadeData(padfGeoTransform,
+                                              psOptions->z,
+                                              psOptions->scale,
+                                              psOptions->alt,
+                                              psOptions->az,
+                                              psOptions->bZevenbergenThorne);
+        if( psOptions->bZevenbergenThorne )
+        {
+            if( !psOptions->bCombined )
+            {
+                sAlgs.pfnAlgFloat = GDALHillshadeAlg<float, ZEVENBERGEN_THORNE>;
+                sAlgs.pfnAlgInt32 = GDALHillshadeAlg<GInt32, ZEVENBERGEN_THORNE>;
+#ifdef HAVE_16_SSE_REG
+                sAlgs.pfnAlgFloat_multisample = GDALHillshadeAlg_multisample<
+                                        float, ZEVENBERGEN_THORNE, false>;
+                sAlgs.pfnAlgInt32_multisample = GDALHillshadeAlg_multisample<
+                                        GInt32, ZEVENBERGEN_THORNE, false>;
+#endif
+            }
+            else
+            {
+                sAlgs.pfnAlgFloat = GDALHillshadeCombinedAlg<float, ZEVENBERGEN_THORNE>;
+                sAlgs.pfnAlgInt32 = GDALHillshadeCombinedAlg<GInt32, ZEVENBERGEN_THORNE>;
+            }
+        }
+        else
+        {
+            if( !psOptions->bCombined )
+            {
+                if( padfGeoTransform[1] == -padfGeoTransform[5] )
+                {
+                    sAlgs.pfnAlgFloat = GDALHillshadeAlg_same_res<float>;
+                    sAlgs.pfnAlgInt32 = GDALHillshadeAlg_same_res<GInt32>;
+#ifdef HAVE_16_SSE_REG
+                    sAlgs.pfnAlgFloat_multisample =
+                        GDALHillshadeAlg_multisample<float, HORN, true>;
+                    sAlgs.pfnAlgInt32_multisample =
+                                GDALHillshadeAlg_same_res_multisample<GInt32>;
+#endif
+                }
+                else
+                {
+                    sAlgs.pfnAlgFloat = GDALHillshadeAlg<float, HORN>;
+                    sAlgs.pfnAlgInt32 = GDALHillshadeAlg<GInt32, HORN>;
+#ifdef HAVE_16_SSE_REG
+                    sAlgs.pfnAlgFloat_multisample =
+                        GDALHillshadeAlg_multisample<float, HORN, false>;
+                    sAlgs.pfnAlgInt32_multisample =
+                        GDALHillshadeAlg_multisample<GInt32, HORN, false>;
+#endif
+                }
+            }
+            else
+            {
+                sAlgs.pfnAlgFloat = GDALHillshadeCombinedAlg<float, HORN>;
+                sAlgs.pfnAlgInt32 = GDALHillshadeCombinedAlg<GInt32, HORN>;
+            }
+        }
+    }
+    else if( psOptions->eAlg == GDEM_SLOPE )
+    {
+        sAlgs.pData = GDALCreateSlopeData(padfGeoTransform,
+                                          psOptions->scale,
+                                          psOptions->slopeFormat);
+        if( psOptions->bZevenbergenThorne )
+        {
+            sAlgs.pfnAlgFloat = GDALSlopeZevenbergenThorneAlg<float>;
+            sAlgs.pfnAlgInt32 = GDALSlopeZevenbergenThorneAlg<GInt32>;
+        }
+        else
+        {
+            sAlgs.pfnAlgFloat = GDALSlopeHornAlg<float>;
+            sAlgs.pfnAlgInt32 = GDALSlopeHornAlg<GInt32>;
+        }
+    }
+    else if( psOptions->eAlg == GDEM_ASPECT )
+    {
+        sAlgs.pData = GDALCreateAspectData(psOptions->bAngleAsAzimuth);
+        if( psOptions->bZevenbergenThorne )
+        {
+            sAlgs.pfnAlgFloat = GDALAspectZevenbergenThorneAlg<float>;
+            sAlgs.pfnAlgInt32 = GDALAspectZevenbergenThorneAlg<GInt32>;
+        }
+        else
+        {
+            sAlgs.pfnAlgFloat = GDALAspectAlg<float>;
+            sAlgs.pfnAlgInt32 = GDALAspectAlg<GInt32>;
+        }
+    }
+    else if( psOptions->eAlg == GDEM_TRI )
+    {
+        sAlgs.pfnAlgFloat = GDALTRIAlg<float>;
+        sAlgs.pfnAlgInt32 = GDALTRIAlg<GInt32>;
+    }
+    else if( psOptions->eAlg == GDEM_TPI )
+    {
+        sAlgs.pfnAlgFloat = GDALTPIAlg<float>;
+        sAlgs.pfnAlgInt32 = GDALTPIAlg<GInt32>;
+    }
+    else if( psOptions->eAlg == GDEM_ROUGHNESS )
+    {
+        sAlgs.pfnAlgFloat = GDALRoughnessAlg<float>;
+        sAlgs.pfnAlgInt32 = GDALRoughnessAlg<GInt32>;
+    }
+}
+
+/************************************************************************/
+/*                      GDALDEMGetOutputDataType()                      */
+/************************************************************************/
+
+GDALDataType GDALDEMGetOutputDataType( const GDALDEMAlgOptions* psOptions )
+{
+    return psOptions->eAlg == GDEM_HILLSHADE ? GDT_Byte : GDT_Float32;
+}
+
+/************************************************************************/
+/*                       GDALDEMGetOutputNoData()                       */
+/************************************************************************/
+
+// Returns whether the output has a nodata value, and sets *pdfNoDataValue
+// to it, or to 0 otherwise.
+bool GDALDEMGetOutputNoData( const GDALDEMAlgOptions* psOptions,
+                             double* pdfNoDataValue )
+{
+    *pdfNoDataValue = 0.0;
+    if( psOptions->eAlg == GDEM_HILLSHADE )
+        return true;
+    if( psOptions->eAlg == GDEM_ASPECT && psOptions->bZeroForFlat )
+        return false;
+    *pdfNoDataValue = -9999;
+    return true;
+}
+
+/************************************************************************/
+/*                         GDALDEMProcessBand()                         */
+/************************************************************************/
+
+// Computes the algorithm of psOptions from hSrcBand into hDstBand, whose
+// nodata value, if any, must already be set.
+CPLErr GDALDEMProcessBand( GDALRasterBandH hSrcBand,
+                           GDALRasterBandH hDstBand,
+                           const double* padfGeoTransform,
+                           const GDALDEMAlgOptions* psOptions,
+                           GDALProgressFunc pfnProgress,
+                           void* pProgressData )
+{
+    GDALDEMAlgorithms sAlgs;
+    GDALDEMInitAlgorithms(padfGeoTransform, psOptions, sAlgs);
+
+    CPLErr eErr;
+    const GDALDataType eSrcDT = GDALGetRasterDataType(hSrcBand);
+    if( eSrcDT == GDT_Byte || eSrcDT == GDT_Int16 || eSrcDT == GDT_UInt16 )
+    {
+        eErr = GDALGeneric3x3Processing<GInt32>(hSrcBand, hDstBand,
+                                                sAlgs.pfnAlgInt32,
+                                                sAlgs.pfnAlgInt32_multisample,
+                                                sAlgs.pData,
+                                                psOptions->bComputeAtEdges,
+                                                pfnProgress, pProgressData);
+    }
+    else
+    {
+        eErr = GDALGeneric3x3Processing<float>(hSrcBand, hDstBand,
+                                               sAlgs.pfnAlgFloat,
+                                               sAlgs.pfnAlgFloat_multisample,
+                                               sAlgs.pData,
+                                               psOptions->bComputeAtEdges,
+                                               pfnProgress, pProgressData);
+    }
+
+    CPLFree(sAlgs.pData);
+    return eErr;
+}
+
+/************************************************************************/
+/*                    GDALDEMCreateOnTheFlyDataset()                    */
+/************************************************************************/
+
+// Returns a dataset computing the algorithm of psOptions from band nBand of
+// hSrcDS by blocks, when they are read. It holds a reference on hSrcDS.
+GDALDatasetH GDALDEMCreateOnTheFlyDataset( GDALDatasetH hSrcDS, int nBand,
+                                           const GDALDEMAlgOptions* psOptions )
+{
+    if( nBand <= 0 || nBand > GDALGetRasterCount(hSrcDS) )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Unable to fetch band #%d", nBand );
+        return nullptr;
+    }
+
+    double adfGeoTransform[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+    GDALGetGeoTransform(hSrcDS, adfGeoTransform);
+
+    GDALDEMAlgorithms sAlgs;
+    GDALDEMInitAlgorithms(adfGeoTransform, psOptions, sAlgs);
+
+    double dfDstNoDataValue = 0.0;
+    const bool bDstHasNoData =
+        GDALDEMGetOutputNoData(psOptions, &dfDstNoDataValue);
+
+    // sAlgs.pData is owned by the returned dataset.
+    return GDALCreateGeneric3x3Dataset(
+        hSrcDS, GDALGetRasterBand(hSrcDS, nBand),
+        GDALDEMGetOutputDataType(psOptions),
+        bDstHasNoData, dfDstNoDataValue,
+        sAlgs.pfnAlgFloat, sAlgs.pfnAlgFloat_multisample,
+        sAlgs.pfnAlgInt32, sAlgs.pfnAlgInt32_multisample,
+        sAlgs.pData, psOptions->bComputeAtEdges);
+}
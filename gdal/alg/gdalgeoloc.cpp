@@ -29,6 +29,7 @@
 
 #include "cpl_port.h"
 #include "gdal_alg.h"
+#include "gdalgeoloc.h"
 
 #include <climits>
 #include <cmath>
@@ -59,50 +60,6 @@ CPL_C_END
 /* ==================================================================== */
 /************************************************************************/
 
-
-//Constants to track down systematic shifts
-const double FSHIFT = 0.5;
-const double ISHIFT = 0.5;
-const double OVERSAMPLE_FACTOR=1.3;
-
-typedef struct {
-    GDALTransformerInfo sTI;
-
-    bool        bReversed;
-
-    // Map from target georef coordinates back to geolocation array
-    // pixel line coordinates.  Built only if needed.
-    int         nBackMapWidth;
-    int         nBackMapHeight;
-    double      adfBackMapGeoTransform[6];  // Maps georef to pixel/line.
-    float       *pafBackMapX;
-    float       *pafBackMapY;
-
-    // Geolocation bands.
-    GDALDatasetH     hDS_X;
-    GDALRasterBandH  hBand_X;
-    GDALDatasetH     hDS_Y;
-    GDALRasterBandH  hBand_Y;
-
-    // Located geolocation data.
-    int              nGeoLocXSize;
-    int              nGeoLocYSize;
-    double           *padfGeoLocX;
-    double           *padfGeoLocY;
-
-    int              bHasNoData;
-    double           dfNoDataX;
-
-    // Geolocation <-> base image mapping.
-    double           dfPIXEL_OFFSET;
-    double           dfPIXEL_STEP;
-    double           dfLINE_OFFSET;
-    double           dfLINE_STEP;
-
-    char **          papszGeolocationInfo;
-
-} GDALGeoLocTransformInfo;
-
 /************************************************************************/
 /*                         GeoLocLoadFullData()                         */
 /************************************************************************/
@@ -798,6 +755,28 @@ void *GDALCreateGeoLocTransformer( GDALDatasetH hBaseDS,
         return nullptr;
     }
 
+/* -------------------------------------------------------------------- */
+/*      With the QUADTREE method, index the geolocation mesh instead    */
+/*      of loading it, and invert it cell by cell.                      */
+/* -------------------------------------------------------------------- */
+    if( EQUAL(CPLGetConfigOption("GDAL_GEOLOC_INVERSE_METHOD", "BACKMAP"),
+              "QUADTREE") )
+    {
+        psTransform->nGeoLocXSize = nXSize_XBand;
+        psTransform->nGeoLocYSize =
+            nYSize_XBand == 1 ? nXSize_YBand : nYSize_XBand;
+        psTransform->dfNoDataX =
+            GDALGetRasterNoDataValue( psTransform->hBand_X,
+                                      &(psTransform->bHasNoData) );
+        psTransform->poQuadTree = GDALGeoLocBuildQuadTree( psTransform );
+        if( psTransform->poQuadTree == nullptr )
+        {
+            GDALDestroyGeoLocTransformer( psTransform );
+            return nullptr;
+        }
+        return psTransform;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Load the geolocation array.                                     */
 /* -------------------------------------------------------------------- */
@@ -827,6 +806,8 @@ void GDALDestroyGeoLocTransformer( void *pTransformAlg )
 
     CPLFree( psTransform->pafBackMapX );
     CPLFree( psTransform->pafBackMapY );
+    if( psTransform->poQuadTree )
+        GDALGeoLocFreeQuadTree( psTransform->poQuadTree );
     CSLDestroy( psTransform->papszGeolocationInfo );
     CPLFree( psTransform->padfGeoLocX );
     CPLFree( psTransform->padfGeoLocY );
@@ -887,11 +868,51 @@ int GDALGeoLocTransform( void *pTransformArg,
             int iY = std::max(0, static_cast<int>(dfGeoLocLine));
             iY = std::min(iY, psTransform->nGeoLocYSize-1);
 
-            double *padfGLX = psTransform->padfGeoLocX + iX + iY * nXSize;
-            double *padfGLY = psTransform->padfGeoLocY + iX + iY * nXSize;
+            // Corners of the geolocation cell, in order (iX, iY),
+            // (iX+1, iY), (iX, iY+1) and (iX+1, iY+1). Those beyond the
+            // last sample are not used.
+            double adfGLX[4] = { 0.0, 0.0, 0.0, 0.0 };
+            double adfGLY[4] = { 0.0, 0.0, 0.0, 0.0 };
+            if( psTransform->poQuadTree )
+            {
+                if( !GDALGeoLocGetCellQuadTree( psTransform->poQuadTree,
+                                                iX, iY, adfGLX, adfGLY ) )
+                {
+                    panSuccess[i] = FALSE;
+                    padfX[i] = HUGE_VAL;
+                    padfY[i] = HUGE_VAL;
+                    continue;
+                }
+            }
+            else
+            {
+                const double *padfGLX =
+                    psTransform->padfGeoLocX + iX + iY * nXSize;
+                const double *padfGLY =
+                    psTransform->padfGeoLocY + iX + iY * nXSize;
+                const bool bHasNextX = iX + 1 < psTransform->nGeoLocXSize;
+                const bool bHasNextY = iY + 1 < psTransform->nGeoLocYSize;
+                adfGLX[0] = padfGLX[0];
+                adfGLY[0] = padfGLY[0];
+                if( bHasNextX )
+                {
+                    adfGLX[1] = padfGLX[1];
+                    adfGLY[1] = padfGLY[1];
+                }
+                if( bHasNextY )
+                {
+                    adfGLX[2] = padfGLX[nXSize];
+                    adfGLY[2] = padfGLY[nXSize];
+                }
+                if( bHasNextX && bHasNextY )
+                {
+                    adfGLX[3] = padfGLX[nXSize + 1];
+                    adfGLY[3] = padfGLY[nXSize + 1];
+                }
+            }
 
             if( psTransform->bHasNoData &&
-                padfGLX[0] == psTransform->dfNoDataX )
+                adfGLX[0] == psTransform->dfNoDataX )
             {
                 panSuccess[i] = FALSE;
                 padfX[i] = HUGE_VAL;
@@ -905,49 +926,80 @@ int GDALGeoLocTransform( void *pTransformArg,
             if( iX + 1 < psTransform->nGeoLocXSize &&
                 iY + 1 < psTransform->nGeoLocYSize &&
                 (!psTransform->bHasNoData ||
-                    (padfGLX[1] != psTransform->dfNoDataX &&
-                     padfGLX[nXSize] != psTransform->dfNoDataX &&
-                     padfGLX[nXSize + 1] != psTransform->dfNoDataX) ))
+                    (adfGLX[1] != psTransform->dfNoDataX &&
+                     adfGLX[2] != psTransform->dfNoDataX &&
+                     adfGLX[3] != psTransform->dfNoDataX) ))
             {
                 padfX[i] =
                     (1 - (dfGeoLocLine -iY))
-                    * (padfGLX[0] +
-                       (dfGeoLocPixel-iX) * (padfGLX[1] - padfGLX[0]))
+                    * (adfGLX[0] +
+                       (dfGeoLocPixel-iX) * (adfGLX[1] - adfGLX[0]))
                     + (dfGeoLocLine -iY)
-                    * (padfGLX[nXSize] + (dfGeoLocPixel-iX) *
-                       (padfGLX[nXSize+1] - padfGLX[nXSize]));
+                    * (adfGLX[2] + (dfGeoLocPixel-iX) *
+                       (adfGLX[3] - adfGLX[2]));
                 padfY[i] =
                     (1 - (dfGeoLocLine -iY))
-                    * (padfGLY[0] +
-                       (dfGeoLocPixel-iX) * (padfGLY[1] - padfGLY[0]))
+                    * (adfGLY[0] +
+                       (dfGeoLocPixel-iX) * (adfGLY[1] - adfGLY[0]))
                     + (dfGeoLocLine -iY)
-                    * (padfGLY[nXSize] + (dfGeoLocPixel-iX) *
-                       (padfGLY[nXSize+1] - padfGLY[nXSize]));
+                    * (adfGLY[2] + (dfGeoLocPixel-iX) *
+                       (adfGLY[3] - adfGLY[2]));
             }
             else if( iX + 1 < psTransform->nGeoLocXSize &&
                      (!psTransform->bHasNoData ||
-                        padfGLX[1] != psTransform->dfNoDataX) )
+                        adfGLX[1] != psTransform->dfNoDataX) )
             {
                 padfX[i] =
-                    padfGLX[0] + (dfGeoLocPixel-iX) * (padfGLX[1] - padfGLX[0]);
+                    adfGLX[0] + (dfGeoLocPixel-iX) * (adfGLX[1] - adfGLX[0]);
                 padfY[i] =
-                    padfGLY[0] + (dfGeoLocPixel-iX) * (padfGLY[1] - padfGLY[0]);
+                    adfGLY[0] + (dfGeoLocPixel-iX) * (adfGLY[1] - adfGLY[0]);
             }
             else if( iY + 1 < psTransform->nGeoLocYSize &&
                      (!psTransform->bHasNoData ||
-                        padfGLX[nXSize] != psTransform->dfNoDataX) )
+                        adfGLX[2] != psTransform->dfNoDataX) )
             {
-                padfX[i] = padfGLX[0]
-                    + (dfGeoLocLine -iY) * (padfGLX[nXSize] - padfGLX[0]);
-                padfY[i] = padfGLY[0]
-                    + (dfGeoLocLine -iY) * (padfGLY[nXSize] - padfGLY[0]);
+                padfX[i] = adfGLX[0]
+                    + (dfGeoLocLine -iY) * (adfGLX[2] - adfGLX[0]);
+                padfY[i] = adfGLY[0]
+                    + (dfGeoLocLine -iY) * (adfGLY[2] - adfGLY[0]);
             }
             else
             {
-                padfX[i] = padfGLX[0];
-                padfY[i] = padfGLY[0];
+                padfX[i] = adfGLX[0];
+                padfY[i] = adfGLY[0];
+            }
+
+            panSuccess[i] = TRUE;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      geox/geoy to pixel/line by inverting the bilinear mapping of    */
+/*      the geolocation cell containing the point.                      */
+/* -------------------------------------------------------------------- */
+    else if( psTransform->poQuadTree )
+    {
+        for( int i = 0; i < nPointCount; i++ )
+        {
+            double dfGeoLocPixel = 0.0;
+            double dfGeoLocLine = 0.0;
+            if( padfX[i] == HUGE_VAL || padfY[i] == HUGE_VAL ||
+                !GDALGeoLocInverseTransformQuadTree( psTransform->poQuadTree,
+                                                     padfX[i], padfY[i],
+                                                     &dfGeoLocPixel,
+                                                     &dfGeoLocLine ) )
+            {
+                panSuccess[i] = FALSE;
+                padfX[i] = HUGE_VAL;
+                padfY[i] = HUGE_VAL;
+                continue;
             }
 
+            // Same convention as the values stored in the backmap.
+            padfX[i] = (dfGeoLocPixel + FSHIFT) * psTransform->dfPIXEL_STEP +
+                       psTransform->dfPIXEL_OFFSET;
+            padfY[i] = (dfGeoLocLine + FSHIFT) * psTransform->dfLINE_STEP +
+                       psTransform->dfLINE_OFFSET;
             panSuccess[i] = TRUE;
         }
     }
@@ -0,0 +1,106 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Private declarations of the geolocation array based transformer.
+ * Author:   agent <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef GDALGEOLOC_H_INCLUDED
+#define GDALGEOLOC_H_INCLUDED
+
+#ifndef DOXYGEN_SKIP
+
+#include "gdal_alg.h"
+
+//Constants to track down systematic shifts
+const double FSHIFT = 0.5;
+const double ISHIFT = 0.5;
+const double OVERSAMPLE_FACTOR=1.3;
+
+class GDALGeoLocQuadTree;
+
+typedef struct {
+    GDALTransformerInfo sTI;
+
+    bool        bReversed;
+
+    // Map from target georef coordinates back to geolocation array
+    // pixel line coordinates.  Built only if needed.
+    int         nBackMapWidth;
+    int         nBackMapHeight;
+    double      adfBackMapGeoTransform[6];  // Maps georef to pixel/line.
+    float       *pafBackMapX;
+    float       *pafBackMapY;
+
+    // Index of the geolocation mesh, used instead of the backmap and of
+    // padfGeoLocX/Y when GDAL_GEOLOC_INVERSE_METHOD=QUADTREE.
+    GDALGeoLocQuadTree *poQuadTree;
+
+    // Geolocation bands.
+    GDALDatasetH     hDS_X;
+    GDALRasterBandH  hBand_X;
+    GDALDatasetH     hDS_Y;
+    GDALRasterBandH  hBand_Y;
+
+    // Located geolocation data.
+    int              nGeoLocXSize;
+    int              nGeoLocYSize;
+    double           *padfGeoLocX;
+    double           *padfGeoLocY;
+
+    int              bHasNoData;
+    double           dfNoDataX;
+
+    // Geolocation <-> base image mapping.
+    double           dfPIXEL_OFFSET;
+    double           dfPIXEL_STEP;
+    double           dfLINE_OFFSET;
+    double           dfLINE_STEP;
+
+    char **          papszGeolocationInfo;
+
+} GDALGeoLocTransformInfo;
+
+/* Quadtree based inverse mapping, in gdalgeolocquadtree.cpp */
+
+bool GDALGeoLocReadRegion( const GDALGeoLocTransformInfo *psTransform,
+                           int nXOff, int nYOff, int nXSize, int nYSize,
+                           double *padfX, double *padfY );
+
+GDALGeoLocQuadTree *GDALGeoLocBuildQuadTree(
+                                const GDALGeoLocTransformInfo *psTransform );
+void GDALGeoLocFreeQuadTree( GDALGeoLocQuadTree *poQuadTree );
+
+bool GDALGeoLocGetCellQuadTree( GDALGeoLocQuadTree *poQuadTree,
+                                int iX, int iY,
+                                double adfX[4], double adfY[4] );
+
+bool GDALGeoLocInverseTransformQuadTree( GDALGeoLocQuadTree *poQuadTree,
+                                         double dfGeoX, double dfGeoY,
+                                         double *pdfGeoLocPixel,
+                                         double *pdfGeoLocLine );
+
+#endif /* #ifndef DOXYGEN_SKIP */
+
+#endif /* GDALGEOLOC_H_INCLUDED */
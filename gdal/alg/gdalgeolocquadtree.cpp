@@ -0,0 +1,655 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Quadtree based inverse mapping of the geolocation array
+ *           transformer.
+ * Author:   agent <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdalgeoloc.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_mem_cache.h"
+#include "cpl_quad_tree.h"
+#include "gdal.h"
+
+CPL_CVSID("$Id$")
+
+// Number of cells of the geolocation mesh along each side of a chunk.
+constexpr int GEOLOC_CHUNK_SIZE = 128;
+
+/************************************************************************/
+/*                           GDALGeoLocChunk                            */
+/************************************************************************/
+
+// Geolocation samples of a rectangular region of the geolocation arrays,
+// with an index of its cells. Adjacent chunks share a row or column of
+// samples, so that every cell is entirely in one chunk.
+struct GDALGeoLocChunk
+{
+    int nXOff = 0;
+    int nYOff = 0;
+    int nXSize = 0;
+    int nYSize = 0;
+    std::vector<double> adfX{};
+    std::vector<double> adfY{};
+    CPLQuadTree *hCellTree = nullptr;
+
+    GDALGeoLocChunk() = default;
+    GDALGeoLocChunk(const GDALGeoLocChunk&) = delete;
+    GDALGeoLocChunk& operator=(const GDALGeoLocChunk&) = delete;
+
+    ~GDALGeoLocChunk()
+    {
+        if( hCellTree )
+            CPLQuadTreeDestroy(hCellTree);
+    }
+};
+
+typedef std::shared_ptr<GDALGeoLocChunk> GDALGeoLocChunkPtr;
+
+/************************************************************************/
+/*                          GDALGeoLocQuadTree                          */
+/************************************************************************/
+
+// Two level index of the geolocation mesh: a quadtree of the extents of all
+// chunks, built once, and a quadtree of the cells of each chunk, built when
+// the chunk is first needed. Only a bounded number of chunks is kept in
+// memory, so the geolocation arrays are never fully loaded.
+class GDALGeoLocQuadTree
+{
+    const GDALGeoLocTransformInfo *m_psTransform = nullptr;
+    int m_nChunksX = 0;
+    int m_nChunksY = 0;
+    CPLQuadTree *m_hChunkTree = nullptr;
+
+    std::mutex m_oMutex{};
+    lru11::Cache<int, GDALGeoLocChunkPtr> m_oCache;
+
+    GDALGeoLocQuadTree(const GDALGeoLocQuadTree&) = delete;
+    GDALGeoLocQuadTree& operator=(const GDALGeoLocQuadTree&) = delete;
+
+    void GetChunkWindow( int iChunkX, int iChunkY,
+                         int &nXOff, int &nYOff,
+                         int &nXSize, int &nYSize ) const;
+    GDALGeoLocChunkPtr LoadChunk( int iChunkX, int iChunkY ) const;
+
+  public:
+    GDALGeoLocQuadTree( const GDALGeoLocTransformInfo *psTransform,
+                        size_t nMaxChunks );
+    ~GDALGeoLocQuadTree();
+
+    bool Build();
+    GDALGeoLocChunkPtr GetChunk( int iChunkX, int iChunkY );
+    bool GetCell( int iX, int iY, double adfX[4], double adfY[4] );
+    bool InverseTransform( double dfGeoX, double dfGeoY,
+                           double &dfGeoLocPixel, double &dfGeoLocLine );
+};
+
+/************************************************************************/
+/*                        GDALGeoLocReadRegion()                        */
+/************************************************************************/
+
+// Read geolocation samples of a region, expanding the X and Y vectors of
+// regular grids.
+bool GDALGeoLocReadRegion( const GDALGeoLocTransformInfo *psTransform,
+                           int nXOff, int nYOff, int nXSize, int nYSize,
+                           double *padfX, double *padfY )
+{
+    const bool bRegularGrid =
+        GDALGetRasterYSize( psTransform->hDS_X ) == 1 &&
+        GDALGetRasterYSize( psTransform->hDS_Y ) == 1;
+
+    if( !bRegularGrid )
+    {
+        return GDALRasterIO( psTransform->hBand_X, GF_Read,
+                             nXOff, nYOff, nXSize, nYSize,
+                             padfX, nXSize, nYSize,
+                             GDT_Float64, 0, 0 ) == CE_None &&
+               GDALRasterIO( psTransform->hBand_Y, GF_Read,
+                             nXOff, nYOff, nXSize, nYSize,
+                             padfY, nXSize, nYSize,
+                             GDT_Float64, 0, 0 ) == CE_None;
+    }
+
+    // The X band contains the x coordinates for all lines, and the Y band
+    // the y coordinates for all columns.
+    if( GDALRasterIO( psTransform->hBand_X, GF_Read,
+                      nXOff, 0, nXSize, 1,
+                      padfX, nXSize, 1,
+                      GDT_Float64, 0, 0 ) != CE_None ||
+        GDALRasterIO( psTransform->hBand_Y, GF_Read,
+                      nYOff, 0, nYSize, 1,
+                      padfY, nYSize, 1,
+                      GDT_Float64, 0, 0 ) != CE_None )
+    {
+        return false;
+    }
+    for( int j = nYSize - 1; j >= 0; j-- )
+    {
+        const double dfY = padfY[j];
+        for( int i = 0; i < nXSize; i++ )
+            padfY[static_cast<size_t>(j) * nXSize + i] = dfY;
+    }
+    for( int j = 1; j < nYSize; j++ )
+    {
+        memcpy( padfX + static_cast<size_t>(j) * nXSize, padfX,
+                nXSize * sizeof(double) );
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                         GDALGeoLocQuadTree()                         */
+/************************************************************************/
+
+GDALGeoLocQuadTree::GDALGeoLocQuadTree(
+                            const GDALGeoLocTransformInfo *psTransform,
+                            size_t nMaxChunks ) :
+    m_psTransform(psTransform),
+    m_nChunksX(std::max(1, (psTransform->nGeoLocXSize - 1 +
+                            GEOLOC_CHUNK_SIZE - 1) / GEOLOC_CHUNK_SIZE)),
+    m_nChunksY(std::max(1, (psTransform->nGeoLocYSize - 1 +
+                            GEOLOC_CHUNK_SIZE - 1) / GEOLOC_CHUNK_SIZE)),
+    m_oCache(nMaxChunks, 0)
+{
+}
+
+/************************************************************************/
+/*                        ~GDALGeoLocQuadTree()                         */
+/************************************************************************/
+
+GDALGeoLocQuadTree::~GDALGeoLocQuadTree()
+{
+    if( m_hChunkTree )
+        CPLQuadTreeDestroy(m_hChunkTree);
+}
+
+/************************************************************************/
+/*                           GetChunkWindow()                           */
+/************************************************************************/
+
+void GDALGeoLocQuadTree::GetChunkWindow( int iChunkX, int iChunkY,
+                                         int &nXOff, int &nYOff,
+                                         int &nXSize, int &nYSize ) const
+{
+    nXOff = iChunkX * GEOLOC_CHUNK_SIZE;
+    nYOff = iChunkY * GEOLOC_CHUNK_SIZE;
+    nXSize = std::min(GEOLOC_CHUNK_SIZE + 1,
+                      m_psTransform->nGeoLocXSize - nXOff);
+    nYSize = std::min(GEOLOC_CHUNK_SIZE + 1,
+                      m_psTransform->nGeoLocYSize - nYOff);
+}
+
+/************************************************************************/
+/*                                Build()                               */
+/************************************************************************/
+
+// Compute the extent of each chunk, reading the geolocation arrays one
+// strip of chunks at a time, and index them.
+bool GDALGeoLocQuadTree::Build()
+{
+    const int nXSize = m_psTransform->nGeoLocXSize;
+    std::vector<CPLRectObj> asChunkBounds;
+    std::vector<bool> abValidChunk;
+    std::vector<double> adfX;
+    std::vector<double> adfY;
+    try
+    {
+        asChunkBounds.resize(static_cast<size_t>(m_nChunksX) * m_nChunksY);
+        abValidChunk.resize(asChunkBounds.size());
+        adfX.resize(static_cast<size_t>(nXSize) * (GEOLOC_CHUNK_SIZE + 1));
+        adfY.resize(adfX.size());
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError( CE_Failure, CPLE_OutOfMemory,
+                  "Cannot allocate geolocation quadtree" );
+        return false;
+    }
+
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = std::numeric_limits<double>::max();
+    sGlobalBounds.miny = std::numeric_limits<double>::max();
+    sGlobalBounds.maxx = -std::numeric_limits<double>::max();
+    sGlobalBounds.maxy = -std::numeric_limits<double>::max();
+
+    for( int iChunkY = 0; iChunkY < m_nChunksY; iChunkY++ )
+    {
+        int nXOff = 0;
+        int nYOff = 0;
+        int nChunkXSize = 0;
+        int nChunkYSize = 0;
+        GetChunkWindow( 0, iChunkY, nXOff, nYOff, nChunkXSize, nChunkYSize );
+        if( !GDALGeoLocReadRegion( m_psTransform, 0, nYOff,
+                                   nXSize, nChunkYSize,
+                                   &adfX[0], &adfY[0] ) )
+            return false;
+
+        for( int iChunkX = 0; iChunkX < m_nChunksX; iChunkX++ )
+        {
+            GetChunkWindow( iChunkX, iChunkY, nXOff, nYOff,
+                            nChunkXSize, nChunkYSize );
+            const size_t iChunk =
+                static_cast<size_t>(iChunkY) * m_nChunksX + iChunkX;
+            CPLRectObj &sBounds = asChunkBounds[iChunk];
+            sBounds.minx = std::numeric_limits<double>::max();
+            sBounds.miny = std::numeric_limits<double>::max();
+            sBounds.maxx = -std::numeric_limits<double>::max();
+            sBounds.maxy = -std::numeric_limits<double>::max();
+            for( int j = 0; j < nChunkYSize; j++ )
+            {
+                for( int i = nXOff; i < nXOff + nChunkXSize; i++ )
+                {
+                    const size_t iSample = static_cast<size_t>(j) * nXSize + i;
+                    if( m_psTransform->bHasNoData &&
+                        adfX[iSample] == m_psTransform->dfNoDataX )
+                        continue;
+                    sBounds.minx = std::min(sBounds.minx, adfX[iSample]);
+                    sBounds.miny = std::min(sBounds.miny, adfY[iSample]);
+                    sBounds.maxx = std::max(sBounds.maxx, adfX[iSample]);
+                    sBounds.maxy = std::max(sBounds.maxy, adfY[iSample]);
+                    abValidChunk[iChunk] = true;
+                }
+            }
+            if( abValidChunk[iChunk] )
+            {
+                sGlobalBounds.minx = std::min(sGlobalBounds.minx,
+                                              sBounds.minx);
+                sGlobalBounds.miny = std::min(sGlobalBounds.miny,
+                                              sBounds.miny);
+                sGlobalBounds.maxx = std::max(sGlobalBounds.maxx,
+                                              sBounds.maxx);
+                sGlobalBounds.maxy = std::max(sGlobalBounds.maxy,
+                                              sBounds.maxy);
+            }
+        }
+    }
+
+    m_hChunkTree = CPLQuadTreeCreate(&sGlobalBounds, nullptr);
+    for( size_t iChunk = 0; iChunk < asChunkBounds.size(); iChunk++ )
+    {
+        if( abValidChunk[iChunk] )
+        {
+            CPLQuadTreeInsertWithBounds(
+                m_hChunkTree,
+                reinterpret_cast<void *>(static_cast<GUIntptr_t>(iChunk)),
+                &asChunkBounds[iChunk] );
+        }
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                              LoadChunk()                             */
+/************************************************************************/
+
+GDALGeoLocChunkPtr GDALGeoLocQuadTree::LoadChunk( int iChunkX,
+                                                  int iChunkY ) const
+{
+    GDALGeoLocChunkPtr poChunk = std::make_shared<GDALGeoLocChunk>();
+    GetChunkWindow( iChunkX, iChunkY, poChunk->nXOff, poChunk->nYOff,
+                    poChunk->nXSize, poChunk->nYSize );
+    const int nXSize = poChunk->nXSize;
+    const int nYSize = poChunk->nYSize;
+    poChunk->adfX.resize(static_cast<size_t>(nXSize) * nYSize);
+    poChunk->adfY.resize(poChunk->adfX.size());
+    if( !GDALGeoLocReadRegion( m_psTransform, poChunk->nXOff, poChunk->nYOff,
+                               nXSize, nYSize,
+                               &poChunk->adfX[0], &poChunk->adfY[0] ) )
+        return GDALGeoLocChunkPtr();
+
+/* -------------------------------------------------------------------- */
+/*      Index the cells that have 4 valid corners.                      */
+/* -------------------------------------------------------------------- */
+    std::vector<CPLRectObj> asCellBounds;
+    std::vector<int> anCells;
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = std::numeric_limits<double>::max();
+    sGlobalBounds.miny = std::numeric_limits<double>::max();
+    sGlobalBounds.maxx = -std::numeric_limits<double>::max();
+    sGlobalBounds.maxy = -std::numeric_limits<double>::max();
+    for( int j = 0; j + 1 < nYSize; j++ )
+    {
+        for( int i = 0; i + 1 < nXSize; i++ )
+        {
+            const size_t aiCorners[4] = {
+                static_cast<size_t>(j) * nXSize + i,
+                static_cast<size_t>(j) * nXSize + i + 1,
+                static_cast<size_t>(j + 1) * nXSize + i,
+                static_cast<size_t>(j + 1) * nXSize + i + 1 };
+            CPLRectObj sBounds;
+            sBounds.minx = std::numeric_limits<double>::max();
+            sBounds.miny = std::numeric_limits<double>::max();
+            sBounds.maxx = -std::numeric_limits<double>::max();
+            sBounds.maxy = -std::numeric_limits<double>::max();
+            bool bValid = true;
+            for( int k = 0; k < 4; k++ )
+            {
+                const double dfX = poChunk->adfX[aiCorners[k]];
+                const double dfY = poChunk->adfY[aiCorners[k]];
+                if( m_psTransform->bHasNoData &&
+                    dfX == m_psTransform->dfNoDataX )
+                {
+                    bValid = false;
+                    break;
+                }
+                sBounds.minx = std::min(sBounds.minx, dfX);
+                sBounds.miny = std::min(sBounds.miny, dfY);
+                sBounds.maxx = std::max(sBounds.maxx, dfX);
+                sBounds.maxy = std::max(sBounds.maxy, dfY);
+            }
+            if( !bValid )
+                continue;
+            asCellBounds.push_back(sBounds);
+            anCells.push_back(j * nXSize + i);
+            sGlobalBounds.minx = std::min(sGlobalBounds.minx, sBounds.minx);
+            sGlobalBounds.miny = std::min(sGlobalBounds.miny, sBounds.miny);
+            sGlobalBounds.maxx = std::max(sGlobalBounds.maxx, sBounds.maxx);
+            sGlobalBounds.maxy = std::max(sGlobalBounds.maxy, sBounds.maxy);
+        }
+    }
+
+    if( !anCells.empty() )
+    {
+        poChunk->hCellTree = CPLQuadTreeCreate(&sGlobalBounds, nullptr);
+        for( size_t k = 0; k < anCells.size(); k++ )
+        {
+            CPLQuadTreeInsertWithBounds(
+                poChunk->hCellTree,
+                reinterpret_cast<void *>(static_cast<GUIntptr_t>(anCells[k])),
+                &asCellBounds[k] );
+        }
+    }
+
+    return poChunk;
+}
+
+/************************************************************************/
+/*                              GetChunk()                              */
+/************************************************************************/
+
+GDALGeoLocChunkPtr GDALGeoLocQuadTree::GetChunk( int iChunkX, int iChunkY )
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+
+    const int nKey = iChunkY * m_nChunksX + iChunkX;
+    GDALGeoLocChunkPtr poChunk;
+    if( m_oCache.tryGet(nKey, poChunk) )
+        return poChunk;
+
+    poChunk = LoadChunk( iChunkX, iChunkY );
+    if( poChunk )
+        m_oCache.insert(nKey, poChunk);
+    return poChunk;
+}
+
+/************************************************************************/
+/*                               GetCell()                              */
+/************************************************************************/
+
+// Fetch the samples at (iX, iY), (iX+1, iY), (iX, iY+1) and (iX+1, iY+1),
+// for those that are inside the geolocation arrays.
+bool GDALGeoLocQuadTree::GetCell( int iX, int iY,
+                                  double adfX[4], double adfY[4] )
+{
+    const int iChunkX = std::min(iX / GEOLOC_CHUNK_SIZE, m_nChunksX - 1);
+    const int iChunkY = std::min(iY / GEOLOC_CHUNK_SIZE, m_nChunksY - 1);
+    GDALGeoLocChunkPtr poChunk = GetChunk( iChunkX, iChunkY );
+    if( !poChunk )
+        return false;
+
+    const int i = iX - poChunk->nXOff;
+    const int j = iY - poChunk->nYOff;
+    for( int k = 0; k < 4; k++ )
+    {
+        const int iSampleX = i + (k & 1);
+        const int iSampleY = j + (k >> 1);
+        if( iSampleX >= poChunk->nXSize || iSampleY >= poChunk->nYSize )
+        {
+            adfX[k] = 0.0;
+            adfY[k] = 0.0;
+            continue;
+        }
+        const size_t iSample =
+            static_cast<size_t>(iSampleY) * poChunk->nXSize + iSampleX;
+        adfX[k] = poChunk->adfX[iSample];
+        adfY[k] = poChunk->adfY[iSample];
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                       GDALGeoLocInvertCell()                         */
+/************************************************************************/
+
+// Find (u, v) in [0,1]x[0,1] such that the bilinear interpolation of the
+// cell corners (in order (0,0), (1,0), (0,1), (1,1)) is (dfX, dfY). The cell
+// is split in two triangles to get a first estimate by barycentric
+// inversion, which is then refined with Newton iterations on the bilinear
+// mapping used by the forward transformation.
+static bool GDALGeoLocInvertCell( const double adfX[4], const double adfY[4],
+                                  double dfX, double dfY,
+                                  double &dfU, double &dfV )
+{
+    constexpr double EPS = 1e-10;
+
+    // Triangles (0,0)-(1,0)-(1,1) and (0,0)-(1,1)-(0,1).
+    static const int aanTriangles[2][3] = { { 0, 1, 3 }, { 0, 3, 2 } };
+    bool bFound = false;
+    for( int iTri = 0; iTri < 2 && !bFound; iTri++ )
+    {
+        const int iA = aanTriangles[iTri][0];
+        const int iB = aanTriangles[iTri][1];
+        const int iC = aanTriangles[iTri][2];
+        const double dfDet =
+            (adfY[iB] - adfY[iC]) * (adfX[iA] - adfX[iC]) +
+            (adfX[iC] - adfX[iB]) * (adfY[iA] - adfY[iC]);
+        if( dfDet == 0.0 )
+            continue;
+        const double dfL1 =
+            ((adfY[iB] - adfY[iC]) * (dfX - adfX[iC]) +
+             (adfX[iC] - adfX[iB]) * (dfY - adfY[iC])) / dfDet;
+        const double dfL2 =
+            ((adfY[iC] - adfY[iA]) * (dfX - adfX[iC]) +
+             (adfX[iA] - adfX[iC]) * (dfY - adfY[iC])) / dfDet;
+        const double dfL3 = 1.0 - dfL1 - dfL2;
+        if( dfL1 < -EPS || dfL2 < -EPS || dfL3 < -EPS )
+            continue;
+
+        dfU = dfL1 * (iA & 1) + dfL2 * (iB & 1) + dfL3 * (iC & 1);
+        dfV = dfL1 * (iA >> 1) + dfL2 * (iB >> 1) + dfL3 * (iC >> 1);
+        bFound = true;
+    }
+    if( !bFound )
+        return false;
+
+    double dfNewU = dfU;
+    double dfNewV = dfV;
+    for( int iIter = 0; iIter < 5; iIter++ )
+    {
+        const double dfFX =
+            (1 - dfNewV) * (adfX[0] + dfNewU * (adfX[1] - adfX[0])) +
+            dfNewV * (adfX[2] + dfNewU * (adfX[3] - adfX[2])) - dfX;
+        const double dfFY =
+            (1 - dfNewV) * (adfY[0] + dfNewU * (adfY[1] - adfY[0])) +
+            dfNewV * (adfY[2] + dfNewU * (adfY[3] - adfY[2])) - dfY;
+        const double dfDXDU = (1 - dfNewV) * (adfX[1] - adfX[0]) +
+                              dfNewV * (adfX[3] - adfX[2]);
+        const double dfDXDV = (1 - dfNewU) * (adfX[2] - adfX[0]) +
+                              dfNewU * (adfX[3] - adfX[1]);
+        const double dfDYDU = (1 - dfNewV) * (adfY[1] - adfY[0]) +
+                              dfNewV * (adfY[3] - adfY[2]);
+        const double dfDYDV = (1 - dfNewU) * (adfY[2] - adfY[0]) +
+                              dfNewU * (adfY[3] - adfY[1]);
+        const double dfDet = dfDXDU * dfDYDV - dfDXDV * dfDYDU;
+        if( dfDet == 0.0 )
+            break;
+        const double dfDU = (dfFX * dfDYDV - dfFY * dfDXDV) / dfDet;
+        const double dfDV = (dfFY * dfDXDU - dfFX * dfDYDU) / dfDet;
+        dfNewU -= dfDU;
+        dfNewV -= dfDV;
+        if( fabs(dfDU) < EPS && fabs(dfDV) < EPS )
+            break;
+    }
+
+    // Keep the triangle estimate if the refinement left the cell.
+    if( dfNewU >= -EPS && dfNewU <= 1 + EPS &&
+        dfNewV >= -EPS && dfNewV <= 1 + EPS )
+    {
+        dfU = dfNewU;
+        dfV = dfNewV;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          InverseTransform()                          */
+/************************************************************************/
+
+bool GDALGeoLocQuadTree::InverseTransform( double dfGeoX, double dfGeoY,
+                                           double &dfGeoLocPixel,
+                                           double &dfGeoLocLine )
+{
+    CPLRectObj sAoi;
+    sAoi.minx = dfGeoX;
+    sAoi.miny = dfGeoY;
+    sAoi.maxx = dfGeoX;
+    sAoi.maxy = dfGeoY;
+
+    int nChunkCount = 0;
+    void **pahChunks = CPLQuadTreeSearch(m_hChunkTree, &sAoi, &nChunkCount);
+    bool bFound = false;
+    for( int iChunk = 0; iChunk < nChunkCount && !bFound; iChunk++ )
+    {
+        const int nChunk = static_cast<int>(
+            reinterpret_cast<GUIntptr_t>(pahChunks[iChunk]));
+        GDALGeoLocChunkPtr poChunk =
+            GetChunk( nChunk % m_nChunksX, nChunk / m_nChunksX );
+        if( !poChunk || poChunk->hCellTree == nullptr )
+            continue;
+
+        int nCellCount = 0;
+        void **pahCells =
+            CPLQuadTreeSearch(poChunk->hCellTree, &sAoi, &nCellCount);
+        for( int iCell = 0; iCell < nCellCount && !bFound; iCell++ )
+        {
+            const int nCell = static_cast<int>(
+                reinterpret_cast<GUIntptr_t>(pahCells[iCell]));
+            const int i = nCell % poChunk->nXSize;
+            const int j = nCell / poChunk->nXSize;
+            const size_t iSample = static_cast<size_t>(nCell);
+            const double adfX[4] = {
+                poChunk->adfX[iSample],
+                poChunk->adfX[iSample + 1],
+                poChunk->adfX[iSample + poChunk->nXSize],
+                poChunk->adfX[iSample + poChunk->nXSize + 1] };
+            const double adfY[4] = {
+                poChunk->adfY[iSample],
+                poChunk->adfY[iSample + 1],
+                poChunk->adfY[iSample + poChunk->nXSize],
+                poChunk->adfY[iSample + poChunk->nXSize + 1] };
+            double dfU = 0.0;
+            double dfV = 0.0;
+            if( GDALGeoLocInvertCell( adfX, adfY, dfGeoX, dfGeoY,
+                                      dfU, dfV ) )
+            {
+                dfGeoLocPixel = poChunk->nXOff + i + dfU;
+                dfGeoLocLine = poChunk->nYOff + j + dfV;
+                bFound = true;
+            }
+        }
+        CPLFree(pahCells);
+    }
+    CPLFree(pahChunks);
+
+    return bFound;
+}
+
+/************************************************************************/
+/*                      GDALGeoLocBuildQuadTree()                       */
+/************************************************************************/
+
+GDALGeoLocQuadTree *GDALGeoLocBuildQuadTree(
+                                const GDALGeoLocTransformInfo *psTransform )
+{
+    // Each chunk takes about 1 MB with its cell index.
+    const int nMaxChunks = std::max(1,
+        atoi(CPLGetConfigOption("GDAL_GEOLOC_QUADTREE_CACHE_CHUNKS", "64")));
+
+    GDALGeoLocQuadTree *poQuadTree =
+        new GDALGeoLocQuadTree(psTransform, nMaxChunks);
+    if( !poQuadTree->Build() )
+    {
+        delete poQuadTree;
+        return nullptr;
+    }
+    return poQuadTree;
+}
+
+/************************************************************************/
+/*                       GDALGeoLocFreeQuadTree()                       */
+/************************************************************************/
+
+void GDALGeoLocFreeQuadTree( GDALGeoLocQuadTree *poQuadTree )
+{
+    delete poQuadTree;
+}
+
+/************************************************************************/
+/*                     GDALGeoLocGetCellQuadTree()                      */
+/************************************************************************/
+
+bool GDALGeoLocGetCellQuadTree( GDALGeoLocQuadTree *poQuadTree,
+                                int iX, int iY,
+                                double adfX[4], double adfY[4] )
+{
+    return poQuadTree->GetCell( iX, iY, adfX, adfY );
+}
+
+/************************************************************************/
+/*                 GDALGeoLocInverseTransformQuadTree()                 */
+/************************************************************************/
+
+bool GDALGeoLocInverseTransformQuadTree( GDALGeoLocQuadTree *poQuadTree,
+                                         double dfGeoX, double dfGeoY,
+                                         double *pdfGeoLocPixel,
+                                         double *pdfGeoLocLine )
+{
+    return poQuadTree->InverseTransform( dfGeoX, dfGeoY,
+                                         *pdfGeoLocPixel, *pdfGeoLocLine );
+}
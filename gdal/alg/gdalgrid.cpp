@@ -51,6 +51,7 @@
 #include "cpl_vsi.h"
 #include "cpl_worker_thread_pool.h"
 #include "gdal.h"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -1675,7 +1676,8 @@ struct GDALGridContext
     double*             padfZ;
     bool                bFreePadfXYZArrays;
 
-    CPLWorkerThreadPool *poWorkerThreadPool;
+    CPLJobQueue        *poJobQueue;
+    int                 nThreads;
 };
 
 static void GDALGridContextCreateQuadTree( GDALGridContext* psContext );
@@ -2041,21 +2043,18 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
         nThreads = atoi(pszThreads);
     if( nThreads > 128 )
         nThreads = 128;
+    psContext->poJobQueue = nullptr;
+    psContext->nThreads = 0;
     if( nThreads > 1 )
     {
-        psContext->poWorkerThreadPool = new CPLWorkerThreadPool();
-        if( !psContext->poWorkerThreadPool->Setup(nThreads, nullptr, nullptr) )
-        {
-            delete psContext->poWorkerThreadPool;
-            psContext->poWorkerThreadPool = nullptr;
-        }
-        else
+        psContext->poJobQueue =
+            GDALCreateGlobalThreadPoolJobQueue(nThreads).release();
+        if( psContext->poJobQueue != nullptr )
         {
+            psContext->nThreads = nThreads;
             CPLDebug("GDAL_GRID", "Using %d threads", nThreads);
         }
     }
-    else
-        psContext->poWorkerThreadPool = nullptr;
 
     return psContext;
 }
@@ -2137,7 +2136,7 @@ void GDALGridContextFree( GDALGridContext* psContext )
         VSIFreeAligned(psContext->sExtraParameters.pafZ);
         if( psContext->sExtraParameters.psTriangulation )
             GDALTriangulationFree(psContext->sExtraParameters.psTriangulation);
-        delete psContext->poWorkerThreadPool;
+        delete psContext->poJobQueue;
         CPLFree(psContext);
     }
 }
@@ -2285,7 +2284,7 @@ CPLErr GDALGridContextProcess(
     sJob.hCond = nullptr;
     sJob.hCondMutex = nullptr;
 
-    if( psContext->poWorkerThreadPool == nullptr )
+    if( psContext->poJobQueue == nullptr )
     {
         if( sJob.pfnRealProgress != nullptr &&
             sJob.pfnRealProgress != GDALDummyProgress )
@@ -2297,7 +2296,7 @@ CPLErr GDALGridContextProcess(
     }
     else
     {
-        int nThreads  = psContext->poWorkerThreadPool->GetThreadCount();
+        const int nThreads = psContext->nThreads;
         GDALGridJob* pasJobs = static_cast<GDALGridJob *>(
             CPLMalloc(sizeof(GDALGridJob) * nThreads) );
 
@@ -2313,8 +2312,8 @@ CPLErr GDALGridContextProcess(
         {
             memcpy(&pasJobs[i], &sJob, sizeof(GDALGridJob));
             pasJobs[i].nYStart = i;
-            psContext->poWorkerThreadPool->SubmitJob( GDALGridJobProcess,
-                                                      &pasJobs[i] );
+            psContext->poJobQueue->SubmitJob( GDALGridJobProcess,
+                                              &pasJobs[i] );
         }
 
 /* -------------------------------------------------------------------- */
@@ -2345,7 +2344,7 @@ CPLErr GDALGridContextProcess(
 /* -------------------------------------------------------------------- */
 /*      Wait for all threads to complete and finish.                    */
 /* -------------------------------------------------------------------- */
-        psContext->poWorkerThreadPool->WaitCompletion();
+        psContext->poJobQueue->WaitCompletion();
 
         CPLFree(pasJobs);
         CPLDestroyCond(sJob.hCond);
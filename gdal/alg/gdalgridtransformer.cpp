@@ -0,0 +1,973 @@
+/******************************************************************************
+ *
+ * Project:  High Performance Image Reprojector
+ * Purpose:  Transformer interpolating a precomputed grid of the
+ *           destination to source mapping of another transformer.
+ * Author:   agent <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_alg.h"
+#include "gdal_alg_priv.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_mem_cache.h"
+#include "cpl_minixml.h"
+#include "cpl_multiproc.h"
+#include "cpl_sha256.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+
+CPL_CVSID("$Id$")
+
+CPL_C_START
+CPLXMLNode *GDALSerializeGridTransformer( void *pTransformArg );
+void *GDALDeserializeGridTransformer( CPLXMLNode *psTree );
+CPL_C_END
+
+static void *GDALCreateSimilarGridTransformer( void *hTransformArg,
+                                               double dfRatioX,
+                                               double dfRatioY );
+
+/************************************************************************/
+/*                          GDALTransformerGrid                         */
+/************************************************************************/
+
+// Source pixel/line at the nodes of a grid covering the destination area
+// [nXOff,nXOff+nXSize]x[nYOff,nYOff+nYSize]. Nodes are nStep pixels apart,
+// except the last column and row which are on the right and bottom edges.
+// Nodes that could not be transformed are set to HUGE_VAL.
+struct GDALTransformerGridNodes
+{
+    int nXOff = 0;
+    int nYOff = 0;
+    int nXSize = 0;
+    int nYSize = 0;
+    int nStep = 0;
+    int nXNodes = 0;
+    int nYNodes = 0;
+    std::vector<double> adfSrcX{};
+    std::vector<double> adfSrcY{};
+
+    void InitNodeCount()
+    {
+        nXNodes = (nXSize + nStep - 1) / nStep + 1;
+        nYNodes = (nYSize + nStep - 1) / nStep + 1;
+    }
+    double NodeX( int iX ) const
+        { return nXOff + std::min(static_cast<double>(iX) * nStep,
+                                  static_cast<double>(nXSize)); }
+    double NodeY( int iY ) const
+        { return nYOff + std::min(static_cast<double>(iY) * nStep,
+                                  static_cast<double>(nYSize)); }
+};
+
+// Grid covering the destination area [0,nXSize]x[0,nYSize]. Cells where the
+// interpolation of the grid is not accurate enough are covered by a finer
+// grid of their own. Immutable once built, so it is shared between
+// transformers.
+struct GDALTransformerGrid : public GDALTransformerGridNodes
+{
+    // For each cell, index in aoSubGrids of the grid refining it, or -1.
+    // Empty if no cell is refined.
+    std::vector<int> anCellSubGrid{};
+    std::vector<GDALTransformerGridNodes> aoSubGrids{};
+};
+
+typedef std::shared_ptr<const GDALTransformerGrid> GDALTransformerGridPtr;
+
+typedef struct
+{
+    GDALTransformerInfo sTI;
+
+    GDALTransformerGridPtr *poGrid;
+
+    // Source pixel/line are divided by those, for transformers created by
+    // GDALCreateSimilarTransformer().
+    double dfSrcRatioX;
+    double dfSrcRatioY;
+
+    // Used for the forward direction, and for points outside of the grid.
+    // May be NULL.
+    GDALTransformerFunc pfnBaseTransformer;
+    void *pBaseTransformArg;
+    int bOwnSubtransformer;
+} GridTransformInfo;
+
+/************************************************************************/
+/*                        Process-wide grid cache                       */
+/************************************************************************/
+
+typedef lru11::Cache<std::string, GDALTransformerGridPtr, std::mutex>
+                                                    GDALTransformerGridCache;
+
+static CPLMutex *hGridCacheMutex = nullptr;
+static GDALTransformerGridCache *poGridCache = nullptr;
+
+static GDALTransformerGridCache *GDALGetTransformerGridCache()
+{
+    CPLMutexHolderD(&hGridCacheMutex);
+    if( poGridCache == nullptr )
+    {
+        const int nSize = std::max(1,
+            atoi(CPLGetConfigOption("GDAL_GRID_TRANSFORMER_CACHE_SIZE",
+                                    "16")));
+        poGridCache = new GDALTransformerGridCache(nSize, 0);
+    }
+    return poGridCache;
+}
+
+/************************************************************************/
+/*                   GDALCleanupGridTransformerCache()                  */
+/************************************************************************/
+
+void GDALCleanupGridTransformerCache()
+{
+    delete poGridCache;
+    poGridCache = nullptr;
+    if( hGridCacheMutex != nullptr )
+    {
+        CPLDestroyMutex(hGridCacheMutex);
+        hGridCacheMutex = nullptr;
+    }
+}
+
+/************************************************************************/
+/*                       GDALGridTransformerKey()                       */
+/************************************************************************/
+
+// Key identifying the grid computed from a base transformer and grid
+// parameters, built from the serialization of the base transformer (which
+// carries its SRS and geotransforms). Empty if it is not serializable.
+static std::string GDALGridTransformerKey( GDALTransformerFunc pfnBase,
+                                           void *pBaseArg,
+                                           int nDstXSize, int nDstYSize,
+                                           int nStep, double dfMaxError )
+{
+    CPLErrorHandlerPusher oQuietError(CPLQuietErrorHandler);
+    CPLXMLNode *psTree = GDALSerializeTransformer( pfnBase, pBaseArg );
+    CPLErrorReset();
+    if( psTree == nullptr )
+        return std::string();
+
+    char *pszXML = CPLSerializeXMLTree( psTree );
+    CPLDestroyXMLNode( psTree );
+    CPLString osKey(pszXML);
+    CPLFree( pszXML );
+    osKey += CPLSPrintf("|%d|%d|%d|%.17g",
+                        nDstXSize, nDstYSize, nStep, dfMaxError);
+
+    GByte abyHash[CPL_SHA256_HASH_SIZE] = {};
+    CPL_SHA256( osKey.c_str(), osKey.size(), abyHash );
+    std::string osHex;
+    for( int i = 0; i < CPL_SHA256_HASH_SIZE; i++ )
+        osHex += CPLSPrintf("%02x", abyHash[i]);
+    return osHex;
+}
+
+/************************************************************************/
+/*                         GDALComputeGridNodes()                       */
+/************************************************************************/
+
+static bool GDALComputeGridNodes( GDALTransformerGridNodes &oGrid,
+                                  GDALTransformerFunc pfnBase,
+                                  void *pBaseArg )
+{
+    oGrid.InitNodeCount();
+    const size_t nNodes = static_cast<size_t>(oGrid.nXNodes) * oGrid.nYNodes;
+    try
+    {
+        oGrid.adfSrcX.resize(nNodes);
+        oGrid.adfSrcY.resize(nNodes);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError( CE_Failure, CPLE_OutOfMemory,
+                  "Cannot allocate transformer grid" );
+        return false;
+    }
+
+    std::vector<double> adfZ(oGrid.nXNodes);
+    std::vector<int> anSuccess(oGrid.nXNodes);
+    for( int iY = 0; iY < oGrid.nYNodes; iY++ )
+    {
+        double *padfX = &oGrid.adfSrcX[static_cast<size_t>(iY) *
+                                       oGrid.nXNodes];
+        double *padfY = &oGrid.adfSrcY[static_cast<size_t>(iY) *
+                                       oGrid.nXNodes];
+        for( int iX = 0; iX < oGrid.nXNodes; iX++ )
+        {
+            padfX[iX] = oGrid.NodeX(iX);
+            padfY[iX] = oGrid.NodeY(iY);
+            adfZ[iX] = 0.0;
+        }
+        if( !pfnBase( pBaseArg, TRUE, oGrid.nXNodes, padfX, padfY, &adfZ[0],
+                      &anSuccess[0] ) )
+        {
+            std::fill(anSuccess.begin(), anSuccess.end(), FALSE);
+        }
+        for( int iX = 0; iX < oGrid.nXNodes; iX++ )
+        {
+            if( !anSuccess[iX] )
+            {
+                padfX[iX] = HUGE_VAL;
+                padfY[iX] = HUGE_VAL;
+            }
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                           GDALGetGridCell()                          */
+/************************************************************************/
+
+// Cell of the grid containing destination pixel/line (dfX, dfY). Returns
+// false if the point is outside of the grid.
+static bool GDALGetGridCell( const GDALTransformerGridNodes &oGrid,
+                             double dfX, double dfY, int &iX, int &iY )
+{
+    if( !(dfX >= oGrid.nXOff && dfX <= oGrid.nXOff + oGrid.nXSize &&
+          dfY >= oGrid.nYOff && dfY <= oGrid.nYOff + oGrid.nYSize) )
+        return false;
+
+    iX = std::min(static_cast<int>((dfX - oGrid.nXOff) / oGrid.nStep),
+                  oGrid.nXNodes - 2);
+    iY = std::min(static_cast<int>((dfY - oGrid.nYOff) / oGrid.nStep),
+                  oGrid.nYNodes - 2);
+    return true;
+}
+
+/************************************************************************/
+/*                        GDALInterpolateGridCell()                     */
+/************************************************************************/
+
+// Bilinear interpolation of cell (iX, iY) of the grid at destination
+// pixel/line (dfX, dfY). Returns false if a corner of the cell could not be
+// transformed.
+static bool GDALInterpolateGridCell( const GDALTransformerGridNodes &oGrid,
+                                     int iX, int iY, double dfX, double dfY,
+                                     double &dfSrcX, double &dfSrcY )
+{
+    const double dfX0 = oGrid.NodeX(iX);
+    const double dfY0 = oGrid.NodeY(iY);
+    const double dfRatioX = (dfX - dfX0) / (oGrid.NodeX(iX + 1) - dfX0);
+    const double dfRatioY = (dfY - dfY0) / (oGrid.NodeY(iY + 1) - dfY0);
+
+    const size_t i00 = static_cast<size_t>(iY) * oGrid.nXNodes + iX;
+    const size_t i10 = i00 + 1;
+    const size_t i01 = i00 + oGrid.nXNodes;
+    const size_t i11 = i01 + 1;
+    if( oGrid.adfSrcX[i00] == HUGE_VAL || oGrid.adfSrcX[i10] == HUGE_VAL ||
+        oGrid.adfSrcX[i01] == HUGE_VAL || oGrid.adfSrcX[i11] == HUGE_VAL )
+        return false;
+
+    const double dfTopX = oGrid.adfSrcX[i00] +
+        dfRatioX * (oGrid.adfSrcX[i10] - oGrid.adfSrcX[i00]);
+    const double dfBottomX = oGrid.adfSrcX[i01] +
+        dfRatioX * (oGrid.adfSrcX[i11] - oGrid.adfSrcX[i01]);
+    const double dfTopY = oGrid.adfSrcY[i00] +
+        dfRatioX * (oGrid.adfSrcY[i10] - oGrid.adfSrcY[i00]);
+    const double dfBottomY = oGrid.adfSrcY[i01] +
+        dfRatioX * (oGrid.adfSrcY[i11] - oGrid.adfSrcY[i01]);
+    dfSrcX = dfTopX + dfRatioY * (dfBottomX - dfTopX);
+    dfSrcY = dfTopY + dfRatioY * (dfBottomY - dfTopY);
+    return true;
+}
+
+/************************************************************************/
+/*                     GDALInterpolateTransformerGrid()                 */
+/************************************************************************/
+
+// Interpolation of the grid, or of the finer grid of the cell, at
+// destination pixel/line (dfX, dfY). Returns false if the point is outside
+// of the grid, or if a corner of its cell could not be transformed.
+static bool GDALInterpolateTransformerGrid( const GDALTransformerGrid &oGrid,
+                                            double dfX, double dfY,
+                                            double &dfSrcX, double &dfSrcY )
+{
+    int iX = 0;
+    int iY = 0;
+    if( !GDALGetGridCell( oGrid, dfX, dfY, iX, iY ) )
+        return false;
+
+    if( !oGrid.anCellSubGrid.empty() )
+    {
+        const int iSubGrid = oGrid.anCellSubGrid[
+            static_cast<size_t>(iY) * (oGrid.nXNodes - 1) + iX];
+        if( iSubGrid >= 0 )
+        {
+            const GDALTransformerGridNodes &oSubGrid =
+                oGrid.aoSubGrids[iSubGrid];
+            int iSubX = 0;
+            int iSubY = 0;
+            if( !GDALGetGridCell( oSubGrid, dfX, dfY, iSubX, iSubY ) )
+                return false;
+            return GDALInterpolateGridCell( oSubGrid, iSubX, iSubY, dfX, dfY,
+                                            dfSrcX, dfSrcY );
+        }
+    }
+
+    return GDALInterpolateGridCell( oGrid, iX, iY, dfX, dfY, dfSrcX, dfSrcY );
+}
+
+/************************************************************************/
+/*                       GDALComputeGridCellErrors()                    */
+/************************************************************************/
+
+// Error of the interpolation at the center of each cell of the grid, in
+// source pixels, against the base transformer. Cells whose center or a
+// corner could not be transformed get 0.
+static void GDALComputeGridCellErrors( const GDALTransformerGridNodes &oGrid,
+                                       GDALTransformerFunc pfnBase,
+                                       void *pBaseArg,
+                                       std::vector<double> &adfError )
+{
+    const int nXCells = oGrid.nXNodes - 1;
+    const int nYCells = oGrid.nYNodes - 1;
+    adfError.assign(static_cast<size_t>(nXCells) * nYCells, 0.0);
+
+    std::vector<double> adfX(nXCells);
+    std::vector<double> adfY(nXCells);
+    std::vector<double> adfZ(nXCells);
+    std::vector<int> anSuccess(nXCells);
+    for( int iY = 0; iY < nYCells; iY++ )
+    {
+        const double dfCenterY = (oGrid.NodeY(iY) + oGrid.NodeY(iY + 1)) / 2;
+        for( int iX = 0; iX < nXCells; iX++ )
+        {
+            adfX[iX] = (oGrid.NodeX(iX) + oGrid.NodeX(iX + 1)) / 2;
+            adfY[iX] = dfCenterY;
+            adfZ[iX] = 0.0;
+        }
+        if( !pfnBase( pBaseArg, TRUE, nXCells, &adfX[0], &adfY[0],
+                      &adfZ[0], &anSuccess[0] ) )
+            continue;
+        for( int iX = 0; iX < nXCells; iX++ )
+        {
+            double dfSrcX = 0.0;
+            double dfSrcY = 0.0;
+            if( !anSuccess[iX] ||
+                !GDALInterpolateGridCell(
+                    oGrid, iX, iY,
+                    (oGrid.NodeX(iX) + oGrid.NodeX(iX + 1)) / 2, dfCenterY,
+                    dfSrcX, dfSrcY) )
+                continue;
+            adfError[static_cast<size_t>(iY) * nXCells + iX] =
+                fabs(dfSrcX - adfX[iX]) + fabs(dfSrcY - adfY[iX]);
+        }
+    }
+}
+
+/************************************************************************/
+/*                       GDALComputeTransformerGrid()                   */
+/************************************************************************/
+
+// Compute the grid with nodes nStep pixels apart. If dfMaxError > 0, the
+// error of the interpolation at the center of each cell is checked against
+// the base transformer, and the cells over dfMaxError get a finer grid of
+// their own, whose step is halved until the error at the center of each of
+// its cells is within dfMaxError, or the step is 1.
+static GDALTransformerGridPtr
+GDALComputeTransformerGrid( GDALTransformerFunc pfnBase, void *pBaseArg,
+                            int nDstXSize, int nDstYSize,
+                            int nStep, double dfMaxError )
+{
+    std::shared_ptr<GDALTransformerGrid> poGrid =
+        std::make_shared<GDALTransformerGrid>();
+    poGrid->nXSize = nDstXSize;
+    poGrid->nYSize = nDstYSize;
+    poGrid->nStep = nStep;
+    if( !GDALComputeGridNodes( *poGrid, pfnBase, pBaseArg ) )
+        return GDALTransformerGridPtr();
+
+    if( nStep == 1 || dfMaxError <= 0.0 )
+        return poGrid;
+
+    std::vector<double> adfError;
+    GDALComputeGridCellErrors( *poGrid, pfnBase, pBaseArg, adfError );
+
+    const int nXCells = poGrid->nXNodes - 1;
+    std::vector<double> adfSubError;
+    for( size_t iCell = 0; iCell < adfError.size(); iCell++ )
+    {
+        if( adfError[iCell] <= dfMaxError )
+            continue;
+
+        const int iX = static_cast<int>(iCell % nXCells);
+        const int iY = static_cast<int>(iCell / nXCells);
+        GDALTransformerGridNodes oSubGrid;
+        oSubGrid.nXOff = iX * nStep;
+        oSubGrid.nYOff = iY * nStep;
+        oSubGrid.nXSize = static_cast<int>(poGrid->NodeX(iX + 1)) -
+                          oSubGrid.nXOff;
+        oSubGrid.nYSize = static_cast<int>(poGrid->NodeY(iY + 1)) -
+                          oSubGrid.nYOff;
+        for( oSubGrid.nStep = std::max(1, nStep / 2); ;
+             oSubGrid.nStep = std::max(1, oSubGrid.nStep / 2) )
+        {
+            if( !GDALComputeGridNodes( oSubGrid, pfnBase, pBaseArg ) )
+                return GDALTransformerGridPtr();
+            if( oSubGrid.nStep == 1 )
+                break;
+            GDALComputeGridCellErrors( oSubGrid, pfnBase, pBaseArg,
+                                       adfSubError );
+            if( *std::max_element(adfSubError.begin(), adfSubError.end()) <=
+                    dfMaxError )
+                break;
+        }
+
+        if( poGrid->anCellSubGrid.empty() )
+            poGrid->anCellSubGrid.resize(adfError.size(), -1);
+        poGrid->anCellSubGrid[iCell] =
+            static_cast<int>(poGrid->aoSubGrids.size());
+        poGrid->aoSubGrids.push_back(std::move(oSubGrid));
+    }
+
+    if( !poGrid->aoSubGrids.empty() )
+    {
+        CPLDebug("GDAL", "GridTransformer: %d cells out of %d refined to "
+                 "reach error threshold %g",
+                 static_cast<int>(poGrid->aoSubGrids.size()),
+                 static_cast<int>(adfError.size()), dfMaxError);
+    }
+
+    return poGrid;
+}
+
+/************************************************************************/
+/*                    GDALCreateGridTransformerFromGrid()               */
+/************************************************************************/
+
+static GridTransformInfo *
+GDALCreateGridTransformerFromGrid( const GDALTransformerGridPtr& poGrid )
+{
+    GridTransformInfo *psInfo = static_cast<GridTransformInfo *>(
+        CPLCalloc(sizeof(GridTransformInfo), 1));
+    psInfo->poGrid = new GDALTransformerGridPtr(poGrid);
+    psInfo->dfSrcRatioX = 1.0;
+    psInfo->dfSrcRatioY = 1.0;
+
+    memcpy(psInfo->sTI.abySignature,
+           GDAL_GTI2_SIGNATURE,
+           strlen(GDAL_GTI2_SIGNATURE));
+    psInfo->sTI.pszClassName = "GDALGridTransformer";
+    psInfo->sTI.pfnTransform = GDALGridTransform;
+    psInfo->sTI.pfnCleanup = GDALDestroyGridTransformer;
+    psInfo->sTI.pfnSerialize = GDALSerializeGridTransformer;
+    psInfo->sTI.pfnCreateSimilar = GDALCreateSimilarGridTransformer;
+
+    return psInfo;
+}
+
+/************************************************************************/
+/*                   GDALCreateSimilarGridTransformer()                 */
+/************************************************************************/
+
+static void *GDALCreateSimilarGridTransformer( void *hTransformArg,
+                                               double dfRatioX,
+                                               double dfRatioY )
+{
+    VALIDATE_POINTER1( hTransformArg, "GDALCreateSimilarGridTransformer",
+                       nullptr );
+
+    GridTransformInfo *psInfo =
+        static_cast<GridTransformInfo *>(hTransformArg);
+
+    GridTransformInfo *psClonedInfo =
+        GDALCreateGridTransformerFromGrid( *(psInfo->poGrid) );
+    psClonedInfo->dfSrcRatioX = psInfo->dfSrcRatioX * dfRatioX;
+    psClonedInfo->dfSrcRatioY = psInfo->dfSrcRatioY * dfRatioY;
+    if( psInfo->pBaseTransformArg )
+    {
+        psClonedInfo->pfnBaseTransformer = psInfo->pfnBaseTransformer;
+        psClonedInfo->pBaseTransformArg =
+            GDALCreateSimilarTransformer( psInfo->pBaseTransformArg,
+                                          dfRatioX, dfRatioY );
+        if( psClonedInfo->pBaseTransformArg == nullptr )
+        {
+            GDALDestroyGridTransformer( psClonedInfo );
+            return nullptr;
+        }
+        psClonedInfo->bOwnSubtransformer = TRUE;
+    }
+
+    return psClonedInfo;
+}
+
+/************************************************************************/
+/*                      GDALCreateGridTransformer()                     */
+/************************************************************************/
+
+/**
+ * Create a transformer interpolating a precomputed grid.
+ *
+ * The destination to source mapping of the base transformer is computed on
+ * the nodes of a regular grid covering the destination pixel/line area
+ * [0,nDstXSize]x[0,nDstYSize], and GDALGridTransform() bilinearly
+ * interpolates it, without calling the base transformer.  This is
+ * intended for repeated warps with the same source and destination
+ * georeferencing, as in tile renderers.
+ *
+ * Grids are kept in a process-wide cache (of GDAL_GRID_TRANSFORMER_CACHE_SIZE
+ * grids, 16 by default) keyed on the serialization of the base transformer,
+ * which includes its SRS and geotransforms, and on the grid parameters, so
+ * creating a grid transformer for an already seen configuration does not
+ * call the base transformer.  If the GDAL_GRID_TRANSFORMER_CACHE_DIR
+ * configuration option is set to a directory, grids are also saved there
+ * and reused by other processes.
+ *
+ * Grid transformers are serializable, and the serialized form only contains
+ * the grid, so a deserialized grid transformer does not involve PROJ.
+ *
+ * Points outside of the grid area, or in a cell with a corner that could not
+ * be transformed, as well as all points in the source to destination
+ * direction, are transformed with the base transformer while it is
+ * attached (it is not serialized), and fail otherwise.
+ *
+ * @param pfnBaseTransformer the transformer to sample.
+ * @param pBaseTransformArg the callback argument for the base transformer.
+ * It is not owned by the grid transformer, unless
+ * GDALGridTransformerOwnsSubtransformer() is called.
+ * @param nDstXSize width of the destination area.
+ * @param nDstYSize height of the destination area.
+ * @param nStep distance in destination pixels between grid nodes.
+ * @param dfMaxError if > 0, the cells of the grid where the interpolation
+ * error at their center, in source pixels, is above that value are covered
+ * by a finer grid, whose step is halved until the error at the center of
+ * each of its cells is below that value.
+ *
+ * @return callback pointer suitable for use with GDALGridTransform(), or NULL
+ * in case of failure.  It should be deallocated with
+ * GDALDestroyGridTransformer().
+ *
+ * @since GDAL 2.4
+ */
+
+void *GDALCreateGridTransformer( GDALTransformerFunc pfnBaseTransformer,
+                                 void *pBaseTransformArg,
+                                 int nDstXSize, int nDstYSize,
+                                 int nStep, double dfMaxError )
+{
+    VALIDATE_POINTER1( pfnBaseTransformer, "GDALCreateGridTransformer",
+                       nullptr );
+
+    if( nDstXSize <= 0 || nDstYSize <= 0 || nStep <= 0 )
+    {
+        CPLError( CE_Failure, CPLE_IllegalArg,
+                  "Invalid grid size or step" );
+        return nullptr;
+    }
+
+    const std::string osKey =
+        GDALGridTransformerKey( pfnBaseTransformer, pBaseTransformArg,
+                                nDstXSize, nDstYSize, nStep, dfMaxError );
+    const char *pszCacheDir =
+        CPLGetConfigOption("GDAL_GRID_TRANSFORMER_CACHE_DIR", nullptr);
+    CPLString osCacheFile;
+    if( !osKey.empty() && pszCacheDir != nullptr && pszCacheDir[0] != '\0' )
+        osCacheFile = CPLFormFilename(pszCacheDir, osKey.c_str(), "xml");
+
+/* -------------------------------------------------------------------- */
+/*      Look for the grid in the process cache, then on disk.           */
+/* -------------------------------------------------------------------- */
+    GDALTransformerGridPtr poGrid;
+    if( !osKey.empty() )
+        GDALGetTransformerGridCache()->tryGet(osKey, poGrid);
+
+    if( !poGrid && !osCacheFile.empty() )
+    {
+        VSIStatBufL sStat;
+        if( VSIStatL(osCacheFile, &sStat) == 0 )
+        {
+            CPLXMLNode *psTree = CPLParseXMLFile(osCacheFile);
+            if( psTree != nullptr )
+            {
+                GridTransformInfo *psCached = static_cast<GridTransformInfo *>(
+                    GDALDeserializeGridTransformer(psTree));
+                CPLDestroyXMLNode(psTree);
+                if( psCached != nullptr )
+                {
+                    poGrid = *(psCached->poGrid);
+                    GDALDestroyGridTransformer(psCached);
+                }
+            }
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Otherwise compute it.                                           */
+/* -------------------------------------------------------------------- */
+    bool bComputed = false;
+    if( !poGrid )
+    {
+        poGrid = GDALComputeTransformerGrid( pfnBaseTransformer,
+                                             pBaseTransformArg,
+                                             nDstXSize, nDstYSize,
+                                             nStep, dfMaxError );
+        if( !poGrid )
+            return nullptr;
+        bComputed = true;
+    }
+
+    if( !osKey.empty() )
+        GDALGetTransformerGridCache()->insert(osKey, poGrid);
+
+    GridTransformInfo *psInfo = GDALCreateGridTransformerFromGrid( poGrid );
+    psInfo->pfnBaseTransformer = pfnBaseTransformer;
+    psInfo->pBaseTransformArg = pBaseTransformArg;
+
+    if( bComputed && !osCacheFile.empty() )
+    {
+        // Write to a temporary file and rename it, so that concurrent
+        // processes never read a partial file.
+        CPLXMLNode *psTree = GDALSerializeGridTransformer( psInfo );
+        const CPLString osTmpFile(
+            CPLSPrintf("%s.%d." CPL_FRMT_GIB ".tmp", osCacheFile.c_str(),
+                       CPLGetCurrentProcessID(), CPLGetPID()));
+        if( psTree != nullptr &&
+            CPLSerializeXMLTreeToFile( psTree, osTmpFile ) )
+        {
+            if( VSIRename( osTmpFile, osCacheFile ) != 0 )
+                VSIUnlink( osTmpFile );
+        }
+        CPLDestroyXMLNode( psTree );
+    }
+
+    return psInfo;
+}
+
+/************************************************************************/
+/*               GDALGridTransformerOwnsSubtransformer()                */
+/************************************************************************/
+
+/** Set whether the grid transformer destroys its base transformer */
+void GDALGridTransformerOwnsSubtransformer( void *pTransformArg,
+                                            int bOwnFlag )
+{
+    GridTransformInfo *psInfo =
+        static_cast<GridTransformInfo *>(pTransformArg);
+
+    psInfo->bOwnSubtransformer = bOwnFlag;
+}
+
+/************************************************************************/
+/*                     GDALDestroyGridTransformer()                     */
+/************************************************************************/
+
+/**
+ * Destroy grid transformer.
+ *
+ * @param pTransformArg the transform arg previously returned by
+ * GDALCreateGridTransformer().
+ */
+
+void GDALDestroyGridTransformer( void *pTransformArg )
+{
+    if( pTransformArg == nullptr )
+        return;
+
+    GridTransformInfo *psInfo =
+        static_cast<GridTransformInfo *>(pTransformArg);
+
+    if( psInfo->bOwnSubtransformer && psInfo->pBaseTransformArg != nullptr )
+        GDALDestroyTransformer( psInfo->pBaseTransformArg );
+
+    delete psInfo->poGrid;
+    CPLFree( psInfo );
+}
+
+/************************************************************************/
+/*                          GDALGridTransform()                         */
+/************************************************************************/
+
+/**
+ * Transform points with a grid transformer.
+ *
+ * This function matches the GDALTransformerFunc() signature.  Details of
+ * the arguments are described there.
+ */
+
+int GDALGridTransform( void *pTransformArg, int bDstToSrc,
+                       int nPointCount,
+                       double *padfX, double *padfY, double *padfZ,
+                       int *panSuccess )
+{
+    GridTransformInfo *psInfo =
+        static_cast<GridTransformInfo *>(pTransformArg);
+
+    if( !bDstToSrc )
+    {
+        if( psInfo->pBaseTransformArg != nullptr )
+            return psInfo->pfnBaseTransformer( psInfo->pBaseTransformArg,
+                                               FALSE, nPointCount,
+                                               padfX, padfY, padfZ,
+                                               panSuccess );
+        for( int i = 0; i < nPointCount; i++ )
+            panSuccess[i] = FALSE;
+        return FALSE;
+    }
+
+    const GDALTransformerGrid &oGrid = **(psInfo->poGrid);
+    bool bNeedBase = false;
+    for( int i = 0; i < nPointCount; i++ )
+    {
+        double dfSrcX = 0.0;
+        double dfSrcY = 0.0;
+        if( GDALInterpolateTransformerGrid( oGrid, padfX[i], padfY[i],
+                                            dfSrcX, dfSrcY ) )
+        {
+            padfX[i] = dfSrcX / psInfo->dfSrcRatioX;
+            padfY[i] = dfSrcY / psInfo->dfSrcRatioY;
+            panSuccess[i] = TRUE;
+        }
+        else
+        {
+            panSuccess[i] = FALSE;
+            bNeedBase = true;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Points not covered by the grid go through the base              */
+/*      transformer, one at a time since they are normally rare.        */
+/* -------------------------------------------------------------------- */
+    if( bNeedBase && psInfo->pBaseTransformArg != nullptr )
+    {
+        for( int i = 0; i < nPointCount; i++ )
+        {
+            if( panSuccess[i] )
+                continue;
+            psInfo->pfnBaseTransformer( psInfo->pBaseTransformArg, TRUE, 1,
+                                        padfX + i, padfY + i, padfZ + i,
+                                        panSuccess + i );
+        }
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                    GDALSerializeGridTransformer()                    */
+/************************************************************************/
+
+static char *GDALEncodeGridValues( const std::vector<double>& adfValues )
+{
+    std::vector<double> adfLSB(adfValues);
+    for( size_t i = 0; i < adfLSB.size(); i++ )
+        CPL_LSBPTR64(&adfLSB[i]);
+    return CPLBase64Encode(static_cast<int>(adfLSB.size() * sizeof(double)),
+                           reinterpret_cast<const GByte *>(&adfLSB[0]));
+}
+
+CPLXMLNode *GDALSerializeGridTransformer( void *pTransformArg )
+{
+    VALIDATE_POINTER1( pTransformArg, "GDALSerializeGridTransformer",
+                       nullptr );
+
+    GridTransformInfo *psInfo =
+        static_cast<GridTransformInfo *>(pTransformArg);
+    const GDALTransformerGrid &oGrid = **(psInfo->poGrid);
+
+    double dfNodes = static_cast<double>(oGrid.adfSrcX.size());
+    for( const auto& oSubGrid : oGrid.aoSubGrids )
+        dfNodes += static_cast<double>(oSubGrid.adfSrcX.size());
+    if( dfNodes * sizeof(double) > INT_MAX / 2 )
+    {
+        CPLError( CE_Failure, CPLE_NotSupported,
+                  "Grid too large to be serialized" );
+        return nullptr;
+    }
+
+    CPLXMLNode *psTree =
+        CPLCreateXMLNode( nullptr, CXT_Element, "GridTransformer" );
+
+    CPLCreateXMLElementAndValue( psTree, "DstXSize",
+                                 CPLSPrintf("%d", oGrid.nXSize) );
+    CPLCreateXMLElementAndValue( psTree, "DstYSize",
+                                 CPLSPrintf("%d", oGrid.nYSize) );
+    CPLCreateXMLElementAndValue( psTree, "Step",
+                                 CPLSPrintf("%d", oGrid.nStep) );
+    if( psInfo->dfSrcRatioX != 1.0 || psInfo->dfSrcRatioY != 1.0 )
+    {
+        CPLCreateXMLElementAndValue( psTree, "SrcRatioX",
+                    CPLSPrintf("%.17g", psInfo->dfSrcRatioX) );
+        CPLCreateXMLElementAndValue( psTree, "SrcRatioY",
+                    CPLSPrintf("%.17g", psInfo->dfSrcRatioY) );
+    }
+
+    char *pszSrcX = GDALEncodeGridValues( oGrid.adfSrcX );
+    CPLCreateXMLElementAndValue( psTree, "SrcX", pszSrcX );
+    CPLFree( pszSrcX );
+    char *pszSrcY = GDALEncodeGridValues( oGrid.adfSrcY );
+    CPLCreateXMLElementAndValue( psTree, "SrcY", pszSrcY );
+    CPLFree( pszSrcY );
+
+    if( !oGrid.aoSubGrids.empty() )
+    {
+        CPLXMLNode *psSubGrids =
+            CPLCreateXMLNode( psTree, CXT_Element, "SubGrids" );
+        for( size_t iCell = 0; iCell < oGrid.anCellSubGrid.size(); iCell++ )
+        {
+            if( oGrid.anCellSubGrid[iCell] < 0 )
+                continue;
+            const GDALTransformerGridNodes &oSubGrid =
+                oGrid.aoSubGrids[oGrid.anCellSubGrid[iCell]];
+            CPLXMLNode *psSubGrid =
+                CPLCreateXMLNode( psSubGrids, CXT_Element, "SubGrid" );
+            CPLAddXMLAttributeAndValue( psSubGrid, "cell",
+                                        CPLSPrintf("%d",
+                                                   static_cast<int>(iCell)) );
+            CPLAddXMLAttributeAndValue( psSubGrid, "step",
+                                        CPLSPrintf("%d", oSubGrid.nStep) );
+            pszSrcX = GDALEncodeGridValues( oSubGrid.adfSrcX );
+            CPLCreateXMLElementAndValue( psSubGrid, "SrcX", pszSrcX );
+            CPLFree( pszSrcX );
+            pszSrcY = GDALEncodeGridValues( oSubGrid.adfSrcY );
+            CPLCreateXMLElementAndValue( psSubGrid, "SrcY", pszSrcY );
+            CPLFree( pszSrcY );
+        }
+    }
+
+    return psTree;
+}
+
+/************************************************************************/
+/*                   GDALDeserializeGridTransformer()                   */
+/************************************************************************/
+
+static bool GDALDecodeGridValues( const char *pszBase64, size_t nValues,
+                                  std::vector<double>& adfValues )
+{
+    GByte *pabyData = reinterpret_cast<GByte *>(CPLStrdup(pszBase64));
+    const int nBytes = CPLBase64DecodeInPlace( pabyData );
+    if( static_cast<size_t>(nBytes) != nValues * sizeof(double) )
+    {
+        CPLFree( pabyData );
+        return false;
+    }
+    adfValues.resize(nValues);
+    memcpy(&adfValues[0], pabyData, nBytes);
+    CPLFree( pabyData );
+    for( size_t i = 0; i < nValues; i++ )
+        CPL_LSBPTR64(&adfValues[i]);
+    return true;
+}
+
+void *GDALDeserializeGridTransformer( CPLXMLNode *psTree )
+{
+    std::shared_ptr<GDALTransformerGrid> poGrid =
+        std::make_shared<GDALTransformerGrid>();
+    poGrid->nXSize = atoi(CPLGetXMLValue( psTree, "DstXSize", "0" ));
+    poGrid->nYSize = atoi(CPLGetXMLValue( psTree, "DstYSize", "0" ));
+    poGrid->nStep = atoi(CPLGetXMLValue( psTree, "Step", "0" ));
+    if( poGrid->nXSize <= 0 || poGrid->nYSize <= 0 ||
+        poGrid->nStep <= 0 )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Invalid DstXSize, DstYSize or Step in GridTransformer" );
+        return nullptr;
+    }
+    poGrid->InitNodeCount();
+    const size_t nNodes =
+        static_cast<size_t>(poGrid->nXNodes) * poGrid->nYNodes;
+
+    if( !GDALDecodeGridValues( CPLGetXMLValue( psTree, "SrcX", "" ),
+                               nNodes, poGrid->adfSrcX ) ||
+        !GDALDecodeGridValues( CPLGetXMLValue( psTree, "SrcY", "" ),
+                               nNodes, poGrid->adfSrcY ) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Invalid SrcX or SrcY in GridTransformer" );
+        return nullptr;
+    }
+
+    const int nXCells = poGrid->nXNodes - 1;
+    const size_t nCells = static_cast<size_t>(nXCells) * (poGrid->nYNodes - 1);
+    CPLXMLNode *psSubGrids = CPLGetXMLNode( psTree, "SubGrids" );
+    for( CPLXMLNode *psIter = psSubGrids ? psSubGrids->psChild : nullptr;
+         psIter != nullptr; psIter = psIter->psNext )
+    {
+        if( psIter->eType != CXT_Element ||
+            !EQUAL(psIter->pszValue, "SubGrid") )
+            continue;
+
+        const int iCell = atoi(CPLGetXMLValue( psIter, "cell", "-1" ));
+        GDALTransformerGridNodes oSubGrid;
+        oSubGrid.nStep = atoi(CPLGetXMLValue( psIter, "step", "0" ));
+        if( iCell < 0 || static_cast<size_t>(iCell) >= nCells ||
+            oSubGrid.nStep <= 0 ||
+            (!poGrid->anCellSubGrid.empty() &&
+             poGrid->anCellSubGrid[iCell] >= 0) )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Invalid SubGrid in GridTransformer" );
+            return nullptr;
+        }
+        const int iX = iCell % nXCells;
+        const int iY = iCell / nXCells;
+        oSubGrid.nXOff = iX * poGrid->nStep;
+        oSubGrid.nYOff = iY * poGrid->nStep;
+        oSubGrid.nXSize = static_cast<int>(poGrid->NodeX(iX + 1)) -
+                          oSubGrid.nXOff;
+        oSubGrid.nYSize = static_cast<int>(poGrid->NodeY(iY + 1)) -
+                          oSubGrid.nYOff;
+        oSubGrid.InitNodeCount();
+        const size_t nSubNodes =
+            static_cast<size_t>(oSubGrid.nXNodes) * oSubGrid.nYNodes;
+        if( !GDALDecodeGridValues( CPLGetXMLValue( psIter, "SrcX", "" ),
+                                   nSubNodes, oSubGrid.adfSrcX ) ||
+            !GDALDecodeGridValues( CPLGetXMLValue( psIter, "SrcY", "" ),
+                                   nSubNodes, oSubGrid.adfSrcY ) )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Invalid SrcX or SrcY in GridTransformer SubGrid" );
+            return nullptr;
+        }
+
+        if( poGrid->anCellSubGrid.empty() )
+            poGrid->anCellSubGrid.resize(nCells, -1);
+        poGrid->anCellSubGrid[iCell] =
+            static_cast<int>(poGrid->aoSubGrids.size());
+        poGrid->aoSubGrids.push_back(std::move(oSubGrid));
+    }
+
+    GridTransformInfo *psInfo = GDALCreateGridTransformerFromGrid( poGrid );
+    psInfo->dfSrcRatioX = CPLAtof(CPLGetXMLValue( psTree, "SrcRatioX", "1" ));
+    psInfo->dfSrcRatioY = CPLAtof(CPLGetXMLValue( psTree, "SrcRatioY", "1" ));
+
+    return psInfo;
+}
@@ -45,6 +45,7 @@
 #include "../frmts/vrt/vrtdataset.h"
 #include "gdal_priv.h"
 #include "gdal_priv_templates.hpp"
+#include "gdal_thread_pool.h"
 // #include "gdalsse_priv.h"
 
 // Limit types to practical use cases.
@@ -164,7 +165,8 @@ GDALPansharpenOptions* GDALClonePansharpenOptions(
 GDALPansharpenOperation::GDALPansharpenOperation() :
     psOptions(nullptr),
     bPositiveWeights(TRUE),
-    poThreadPool(nullptr),
+    poJobQueue(nullptr),
+    nJobQueueThreads(0),
     nKernelRadius(0)
 {}
 
@@ -180,7 +182,7 @@ GDALPansharpenOperation::~GDALPansharpenOperation()
     GDALDestroyPansharpenOptions(psOptions);
     for( size_t i = 0; i < aVDS.size(); i++ )
         delete aVDS[i];
-    delete poThreadPool;
+    delete poJobQueue;
 }
 
 /************************************************************************/
@@ -384,13 +386,9 @@ GDALPansharpenOperation::Initialize( const GDALPansharpenOptions* psOptionsIn )
     if( nThreads > 1 )
     {
         CPLDebug("PANSHARPEN", "Using %d threads", nThreads);
-        poThreadPool = new (std::nothrow) CPLWorkerThreadPool();
-        if( poThreadPool == nullptr ||
-            !poThreadPool->Setup( nThreads, nullptr, nullptr ) )
-        {
-            delete poThreadPool;
-            poThreadPool = nullptr;
-        }
+        poJobQueue = GDALCreateGlobalThreadPoolJobQueue(nThreads).release();
+        if( poJobQueue != nullptr )
+            nJobQueueThreads = nThreads;
     }
 
     GDALRIOResampleAlg eResampleAlg = psOptions->eResampleAlg;
@@ -1086,9 +1084,9 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
     }
 
     int nTasks = 0;
-    if( poThreadPool )
+    if( poJobQueue )
     {
-        nTasks = poThreadPool->GetThreadCount();
+        nTasks = nJobQueueThreads;
         if( nTasks > nYSize )
             nTasks = nYSize;
     }
@@ -1338,9 +1336,9 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
 #ifdef DEBUG_TIMING
                 gettimeofday(&tv, nullptr);
 #endif
-                poThreadPool->SubmitJobs(PansharpenResampleJobThreadFunc,
-                                         ahJobData);
-                poThreadPool->WaitCompletion();
+                poJobQueue->SubmitJobs(PansharpenResampleJobThreadFunc,
+                                       ahJobData);
+                poJobQueue->WaitCompletion();
             }
         }
 
@@ -1496,8 +1494,8 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
 #ifdef DEBUG_TIMING
             gettimeofday(&tv, nullptr);
 #endif
-            poThreadPool->SubmitJobs(PansharpenJobThreadFunc, ahJobData);
-            poThreadPool->WaitCompletion();
+            poJobQueue->SubmitJobs(PansharpenJobThreadFunc, ahJobData);
+            poJobQueue->WaitCompletion();
         }
 
         eErr = CE_None;
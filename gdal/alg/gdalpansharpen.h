@@ -192,7 +192,8 @@ class GDALPansharpenOperation
         std::vector<GDALDataset*> aVDS; // to destroy
         std::vector<GDALRasterBand*> aMSBands; // original multispectral bands potentially warped into a VRT
         int bPositiveWeights;
-        CPLWorkerThreadPool* poThreadPool;
+        CPLJobQueue* poJobQueue;
+        int nJobQueueThreads;
         int nKernelRadius;
 
         static void PansharpenJobThreadFunc(void* pUserData);
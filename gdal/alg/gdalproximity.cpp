@@ -34,13 +34,18 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -50,6 +55,46 @@ ProcessProximityLine( GInt32 *panSrcScanline, int *panNearX, int *panNearY,
                       float *pafProximity, double *pdfSrcNoDataValue,
                       int nTargetValues, int *panTargetValues );
 
+/************************************************************************/
+/*                       GDALExactProximityParams                       */
+/************************************************************************/
+
+struct GDALExactProximityParams
+{
+    int nXSize = 0;
+    int nYSize = 0;
+    // Squared georeferenced size of pixels along both axes, 1 for pixel
+    // distances.
+    double dfPixelXSize2 = 1.0;
+    double dfPixelYSize2 = 1.0;
+    double dfMaxDist2 = 0.0;
+    const double *pdfSrcNoDataValue = nullptr;
+    int nTargetValues = 0;
+    const int *panTargetValues = nullptr;
+    float fNoDataValue = 0.0f;
+    bool bFixedBufVal = false;
+    double dfFixedBufVal = 0.0;
+
+    bool IsTarget( GInt32 nValue ) const
+    {
+        if( nTargetValues == 0 )
+            return nValue != 0;
+        for( int i = 0; i < nTargetValues; i++ )
+        {
+            if( nValue == panTargetValues[i] )
+                return true;
+        }
+        return false;
+    }
+};
+
+static CPLErr
+ComputeExactProximity( GDALRasterBandH hSrcBand,
+                       GDALRasterBandH hWorkProximityBand,
+                       GDALRasterBandH hProximityBand,
+                       const GDALExactProximityParams& sParams,
+                       GDALProgressFunc pfnProgress, void * pProgressArg );
+
 /************************************************************************/
 /*                        GDALComputeProximity()                        */
 /************************************************************************/
@@ -84,6 +129,17 @@ Indicates whether distances will be computed in pixel units or
 in georeferenced units.  The default is pixel units.  This also
 determines the interpretation of MAXDIST.
 
+  ALGORITHM=[APPROXIMATE]/EXACT
+
+The default APPROXIMATE algorithm propagates the nearest target pixel
+found from line to line, in a top-down then bottom-up pass, which may
+slightly overestimate some distances.  EXACT (GDAL >= 2.4) computes the
+exact Euclidean distance transform in linear time, as a separable pass over
+columns then lines (Meijster et al. / Felzenszwalb and Huttenlocher).  With
+DISTUNITS=GEO, it also takes into account non square pixels.  The lines may
+be processed in parallel by setting the GDAL_NUM_THREADS configuration
+option to a number of threads or ALL_CPUS.
+
   MAXDIST=n
 
 The maximum distance to search.  Proximity distances greater than
@@ -122,11 +178,35 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
     if( pfnProgress == nullptr )
         pfnProgress = GDALDummyProgress;
 
+/* -------------------------------------------------------------------- */
+/*      Which algorithm?                                                */
+/* -------------------------------------------------------------------- */
+    bool bExact = false;
+    const char *pszOpt = CSLFetchNameValue( papszOptions, "ALGORITHM" );
+    if( pszOpt )
+    {
+        if( EQUAL(pszOpt, "EXACT") )
+            bExact = true;
+        else if( !EQUAL(pszOpt, "APPROXIMATE") )
+        {
+            CPLError(
+                CE_Failure, CPLE_AppDefined,
+                "Unrecognized ALGORITHM value '%s', "
+                "should be APPROXIMATE or EXACT.",
+                pszOpt );
+            return CE_Failure;
+        }
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Are we using pixels or georeferenced coordinates for distances? */
+/*      The exact algorithm uses the georeferenced size of the pixels   */
+/*      along both axes.                                                */
 /* -------------------------------------------------------------------- */
     double dfDistMult = 1.0;
-    const char *pszOpt = CSLFetchNameValue( papszOptions, "DISTUNITS" );
+    double dfPixelXSize = 1.0;
+    double dfPixelYSize = 1.0;
+    pszOpt = CSLFetchNameValue( papszOptions, "DISTUNITS" );
     if( pszOpt )
     {
         if( EQUAL(pszOpt, "GEO") )
@@ -137,12 +217,30 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
                 double adfGeoTransform[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
 
                 GDALGetGeoTransform( hSrcDS, adfGeoTransform );
-                if( std::abs(adfGeoTransform[1]) !=
-                    std::abs(adfGeoTransform[5]) )
-                    CPLError(
-                        CE_Warning, CPLE_AppDefined,
-                        "Pixels not square, distances will be inaccurate." );
-                dfDistMult = std::abs(adfGeoTransform[1]);
+                if( bExact )
+                {
+                    dfPixelXSize = sqrt(
+                        adfGeoTransform[1] * adfGeoTransform[1] +
+                        adfGeoTransform[4] * adfGeoTransform[4] );
+                    dfPixelYSize = sqrt(
+                        adfGeoTransform[2] * adfGeoTransform[2] +
+                        adfGeoTransform[5] * adfGeoTransform[5] );
+                    if( adfGeoTransform[1] * adfGeoTransform[2] +
+                        adfGeoTransform[4] * adfGeoTransform[5] != 0.0 )
+                        CPLError(
+                            CE_Warning, CPLE_AppDefined,
+                            "Pixels not rectangular, distances will be "
+                            "inaccurate." );
+                }
+                else
+                {
+                    if( std::abs(adfGeoTransform[1]) !=
+                        std::abs(adfGeoTransform[5]) )
+                        CPLError(
+                            CE_Warning, CPLE_AppDefined,
+                            "Pixels not square, distances will be inaccurate." );
+                    dfDistMult = std::abs(adfGeoTransform[1]);
+                }
             }
         }
         else if( !EQUAL(pszOpt, "PIXEL") )
@@ -165,6 +263,11 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
 
     CPLDebug( "GDAL", "MAXDIST=%g, DISTMULT=%g", dfMaxDist, dfDistMult );
 
+    // The exact algorithm works in the final distance units, without limit
+    // by default.
+    const double dfExactMaxDist = pszOpt ?
+        CPLAtof(pszOpt) : std::numeric_limits<double>::infinity();
+
 /* -------------------------------------------------------------------- */
 /*      Verify the source and destination are compatible.               */
 /* -------------------------------------------------------------------- */
@@ -256,7 +359,9 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
 /* -------------------------------------------------------------------- */
 /*      We need a signed type for the working proximity values kept     */
 /*      on disk.  If our proximity band is not signed, then create a    */
-/*      temporary file for this purpose.                                */
+/*      temporary file for this purpose.  The exact algorithm keeps     */
+/*      the distance in lines to the nearest target of each column,     */
+/*      which needs a type able to hold any line number exactly.        */
 /* -------------------------------------------------------------------- */
     GDALRasterBandH hWorkProximityBand = hProximityBand;
     GDALDatasetH hWorkProximityDS = nullptr;
@@ -270,9 +375,14 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
     GInt32 *panSrcScanline = nullptr;
     bool bTempFileAlreadyDeleted = false;
 
-    if( eProxType == GDT_Byte
-        || eProxType == GDT_UInt16
-        || eProxType == GDT_UInt32 )
+    const bool bNeedTempWorkBand = bExact ?
+        !(eProxType == GDT_Int32 || eProxType == GDT_Float64 ||
+          (eProxType == GDT_Float32 && nYSize <= (1 << 24))) :
+        (eProxType == GDT_Byte
+         || eProxType == GDT_UInt16
+         || eProxType == GDT_UInt32);
+
+    if( bNeedTempWorkBand )
     {
         GDALDriverH hDriver = GDALGetDriverByName("GTiff");
         if( hDriver == nullptr )
@@ -285,7 +395,8 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
         CPLString osTmpFile = CPLGenerateTempFilename( "proximity" );
         hWorkProximityDS =
             GDALCreate( hDriver, osTmpFile,
-                        nXSize, nYSize, 1, GDT_Float32, nullptr );
+                        nXSize, nYSize, 1,
+                        bExact ? GDT_Int32 : GDT_Float32, nullptr );
         if( hWorkProximityDS == nullptr )
         {
             eErr = CE_Failure;
@@ -298,6 +409,29 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
         hWorkProximityBand = GDALGetRasterBand( hWorkProximityDS, 1 );
     }
 
+    if( bExact )
+    {
+        GDALExactProximityParams sParams;
+        sParams.nXSize = nXSize;
+        sParams.nYSize = nYSize;
+        sParams.dfPixelXSize2 = dfPixelXSize * dfPixelXSize;
+        sParams.dfPixelYSize2 = dfPixelYSize * dfPixelYSize;
+        // Squared distances are computed as dx^2 * sx^2 + dy^2 * sy^2, so
+        // allow for rounding when MAXDIST is a multiple of the pixel size.
+        sParams.dfMaxDist2 = dfExactMaxDist * dfExactMaxDist * (1 + 1e-10);
+        sParams.pdfSrcNoDataValue = pdfSrcNoData;
+        sParams.nTargetValues = nTargetValues;
+        sParams.panTargetValues = panTargetValues;
+        sParams.fNoDataValue = fNoDataValue;
+        sParams.bFixedBufVal = bFixedBufVal;
+        sParams.dfFixedBufVal = dfFixedBufVal;
+
+        eErr = ComputeExactProximity( hSrcBand, hWorkProximityBand,
+                                      hProximityBand, sParams,
+                                      pfnProgress, pProgressArg );
+        goto end;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Allocate buffer for two scanlines of distances as floats        */
 /*      (the current and last line).                                    */
@@ -592,3 +726,324 @@ ProcessProximityLine( GInt32 *panSrcScanline, int *panNearX, int *panNearY,
 
     return CE_None;
 }
+
+/************************************************************************/
+/*                       ExactDistanceTransformLine()                   */
+/*                                                                      */
+/*      Compute the squared distance of the pixels of a line to the     */
+/*      nearest target, given the distance in lines to the nearest      */
+/*      target of each column (-1 if none), as the lower envelope of    */
+/*      the parabolas rooted at each column (Felzenszwalb and           */
+/*      Huttenlocher, "Distance Transforms of Sampled Functions").      */
+/*      padfDist2 is set to -1 if there is no target at all.            */
+/*      panV and padfZ are working buffers of nXSize and nXSize + 1     */
+/*      values.                                                         */
+/************************************************************************/
+
+static void
+ExactDistanceTransformLine( const GInt32 *panColDist,
+                            const GDALExactProximityParams& sParams,
+                            double *padfDist2, int *panV, double *padfZ )
+{
+    const int nXSize = sParams.nXSize;
+    const double dfX2 = sParams.dfPixelXSize2;
+
+    // Squared distance to the nearest target of column iX.
+    const auto ColDist2 = [&panColDist, &sParams](int iX)
+    {
+        const double dfDY = panColDist[iX];
+        return dfDY * dfDY * sParams.dfPixelYSize2;
+    };
+
+    // Build the lower envelope: panV[0..k] are the columns whose parabola
+    // is part of it, the one of panV[j] being the lowest on
+    // [padfZ[j], padfZ[j+1]].
+    int k = -1;
+    for( int iQ = 0; iQ < nXSize; iQ++ )
+    {
+        if( panColDist[iQ] < 0 )
+            continue;
+
+        const double dfQ = ColDist2(iQ) + dfX2 * iQ * static_cast<double>(iQ);
+        double dfS = -std::numeric_limits<double>::infinity();
+        while( k >= 0 )
+        {
+            const int iV = panV[k];
+            dfS = (dfQ - (ColDist2(iV) + dfX2 * iV * static_cast<double>(iV)))
+                  / (2.0 * dfX2 * (iQ - iV));
+            if( dfS > padfZ[k] )
+                break;
+            k--;
+        }
+        if( k < 0 )
+            dfS = -std::numeric_limits<double>::infinity();
+        k++;
+        panV[k] = iQ;
+        padfZ[k] = dfS;
+    }
+
+    if( k < 0 )
+    {
+        for( int iX = 0; iX < nXSize; iX++ )
+            padfDist2[iX] = -1.0;
+        return;
+    }
+    padfZ[k+1] = std::numeric_limits<double>::infinity();
+
+    int j = 0;
+    for( int iX = 0; iX < nXSize; iX++ )
+    {
+        while( padfZ[j+1] < iX )
+            j++;
+        const double dfDX = iX - panV[j];
+        padfDist2[iX] = dfX2 * dfDX * dfDX + ColDist2(panV[j]);
+    }
+}
+
+/************************************************************************/
+/*                        GDALExactProximityJob                         */
+/************************************************************************/
+
+// Lines [iStart, iEnd[ of a strip to compute.
+struct GDALExactProximityJob
+{
+    const GDALExactProximityParams *psParams = nullptr;
+    const GInt32 *panSrc = nullptr;
+    const GInt32 *panColDist = nullptr;
+    float *pafProximity = nullptr;
+    int iStart = 0;
+    int iEnd = 0;
+};
+
+/************************************************************************/
+/*                     ExactProximityComputeLines()                     */
+/************************************************************************/
+
+static void ExactProximityComputeLines( void *pData )
+{
+    const GDALExactProximityJob *psJob =
+        static_cast<const GDALExactProximityJob *>(pData);
+    const GDALExactProximityParams &sParams = *(psJob->psParams);
+    const int nXSize = sParams.nXSize;
+
+    std::vector<double> adfDist2(nXSize);
+    std::vector<int> anV(nXSize);
+    std::vector<double> adfZ(nXSize + 1);
+
+    for( int iLine = psJob->iStart; iLine < psJob->iEnd; iLine++ )
+    {
+        const size_t nOffset = static_cast<size_t>(iLine) * nXSize;
+        const GInt32 *panSrc = psJob->panSrc + nOffset;
+        float *pafProximity = psJob->pafProximity + nOffset;
+
+        ExactDistanceTransformLine( psJob->panColDist + nOffset, sParams,
+                                    &adfDist2[0], &anV[0], &adfZ[0] );
+
+        for( int iX = 0; iX < nXSize; iX++ )
+        {
+            if( sParams.IsTarget(panSrc[iX]) )
+                pafProximity[iX] = 0.0f;
+            else if( (sParams.pdfSrcNoDataValue != nullptr &&
+                      panSrc[iX] == *(sParams.pdfSrcNoDataValue)) ||
+                     adfDist2[iX] < 0.0 ||
+                     adfDist2[iX] > sParams.dfMaxDist2 )
+                pafProximity[iX] = sParams.fNoDataValue;
+            else if( sParams.bFixedBufVal )
+                pafProximity[iX] = static_cast<float>(sParams.dfFixedBufVal);
+            else
+                pafProximity[iX] = static_cast<float>(sqrt(adfDist2[iX]));
+        }
+    }
+}
+
+/************************************************************************/
+/*                        ComputeExactProximity()                       */
+/*                                                                      */
+/*      Exact Euclidean distance transform, in two passes over the      */
+/*      raster by strips of lines (Meijster et al., "A General          */
+/*      Algorithm for Computing Distance Transforms in Linear Time").   */
+/*      The top-down pass computes, for each pixel, the distance in     */
+/*      lines to the nearest target above it in its column, and saves   */
+/*      it in the work band.  The bottom-up pass completes it with the  */
+/*      nearest target below, and then computes the distance of each    */
+/*      line independently, possibly in worker threads.                 */
+/************************************************************************/
+
+static CPLErr
+ComputeExactProximity( GDALRasterBandH hSrcBand,
+                       GDALRasterBandH hWorkProximityBand,
+                       GDALRasterBandH hProximityBand,
+                       const GDALExactProximityParams& sParams,
+                       GDALProgressFunc pfnProgress, void * pProgressArg )
+{
+    const int nXSize = sParams.nXSize;
+    const int nYSize = sParams.nYSize;
+
+/* -------------------------------------------------------------------- */
+/*      Worker threads.                                                 */
+/* -------------------------------------------------------------------- */
+    int nThreads = GDALGetNumThreads();
+
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    if( nThreads > 1 )
+    {
+        poJobQueue = GDALCreateGlobalThreadPoolJobQueue(nThreads);
+        if( poJobQueue == nullptr )
+            nThreads = 1;
+        else
+            CPLDebug("GDAL", "GDALComputeProximity() using %d threads",
+                     nThreads);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Strips of about 256K pixels, with at least one line per         */
+/*      thread.                                                         */
+/* -------------------------------------------------------------------- */
+    const int nStripYSize = GDALGetStripYSize(nXSize, nYSize, 0, nThreads);
+    const size_t nStripPixels = static_cast<size_t>(nXSize) * nStripYSize;
+
+    GInt32 *panSrc = static_cast<GInt32 *>(
+        VSI_MALLOC2_VERBOSE(sizeof(GInt32), nStripPixels));
+    GInt32 *panColDist = static_cast<GInt32 *>(
+        VSI_MALLOC2_VERBOSE(sizeof(GInt32), nStripPixels));
+    float *pafProximity = static_cast<float *>(
+        VSI_MALLOC2_VERBOSE(sizeof(float), nStripPixels));
+    if( panSrc == nullptr || panColDist == nullptr || pafProximity == nullptr )
+    {
+        CPLFree( panSrc );
+        CPLFree( panColDist );
+        CPLFree( pafProximity );
+        return CE_Failure;
+    }
+
+    CPLErr eErr = CE_None;
+
+/* -------------------------------------------------------------------- */
+/*      Loop from top to bottom of the image.                           */
+/* -------------------------------------------------------------------- */
+    for( int iYOff = 0; eErr == CE_None && iYOff < nYSize;
+         iYOff += nStripYSize )
+    {
+        const int nLines = std::min(nStripYSize, nYSize - iYOff);
+        eErr = GDALRasterIO( hSrcBand, GF_Read, 0, iYOff, nXSize, nLines,
+                             panSrc, nXSize, nLines, GDT_Int32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        for( int iLine = 0; iLine < nLines; iLine++ )
+        {
+            const size_t nOffset = static_cast<size_t>(iLine) * nXSize;
+            // The last line of the previous (full) strip is still at the
+            // end of the buffer.
+            const GInt32 *panLastColDist =
+                iLine > 0 ? panColDist + nOffset - nXSize :
+                iYOff > 0 ? panColDist + (nStripPixels - nXSize) : nullptr;
+            for( int iX = 0; iX < nXSize; iX++ )
+            {
+                if( sParams.IsTarget(panSrc[nOffset + iX]) )
+                    panColDist[nOffset + iX] = 0;
+                else if( panLastColDist == nullptr ||
+                         panLastColDist[iX] < 0 )
+                    panColDist[nOffset + iX] = -1;
+                else
+                    panColDist[nOffset + iX] = panLastColDist[iX] + 1;
+            }
+        }
+
+        eErr = GDALRasterIO( hWorkProximityBand, GF_Write,
+                             0, iYOff, nXSize, nLines,
+                             panColDist, nXSize, nLines, GDT_Int32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        if( !pfnProgress( 0.5 * (iYOff + nLines) / static_cast<double>(nYSize),
+                          "", pProgressArg ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Loop from bottom to top of the image.                           */
+/* -------------------------------------------------------------------- */
+    std::vector<GInt32> anNextColDist;
+    std::vector<GDALExactProximityJob> asJobs(nThreads);
+    const int nLastStripYOff = ((nYSize - 1) / nStripYSize) * nStripYSize;
+    for( int iYOff = nLastStripYOff; eErr == CE_None && iYOff >= 0;
+         iYOff -= nStripYSize )
+    {
+        const int nLines = std::min(nStripYSize, nYSize - iYOff);
+        eErr = GDALRasterIO( hWorkProximityBand, GF_Read,
+                             0, iYOff, nXSize, nLines,
+                             panColDist, nXSize, nLines, GDT_Int32, 0, 0 );
+        if( eErr == CE_None )
+            eErr = GDALRasterIO( hSrcBand, GF_Read, 0, iYOff, nXSize, nLines,
+                                 panSrc, nXSize, nLines, GDT_Int32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        // Take into account the nearest target below.
+        for( int iLine = nLines - 1; iLine >= 0; iLine-- )
+        {
+            GInt32 *panLineColDist =
+                panColDist + static_cast<size_t>(iLine) * nXSize;
+            const GInt32 *panBelowColDist =
+                iLine < nLines - 1 ? panLineColDist + nXSize :
+                !anNextColDist.empty() ? &anNextColDist[0] : nullptr;
+            if( panBelowColDist == nullptr )
+                continue;
+            for( int iX = 0; iX < nXSize; iX++ )
+            {
+                if( panBelowColDist[iX] >= 0 &&
+                    (panLineColDist[iX] < 0 ||
+                     panBelowColDist[iX] + 1 < panLineColDist[iX]) )
+                    panLineColDist[iX] = panBelowColDist[iX] + 1;
+            }
+        }
+        anNextColDist.assign(panColDist, panColDist + nXSize);
+
+        // Then compute the distances line by line.
+        const int nJobs = std::min(nThreads, nLines);
+        for( int i = 0; i < nJobs; i++ )
+        {
+            GDALExactProximityJob &sJob = asJobs[i];
+            sJob.psParams = &sParams;
+            sJob.panSrc = panSrc;
+            sJob.panColDist = panColDist;
+            sJob.pafProximity = pafProximity;
+            sJob.iStart = static_cast<int>(
+                static_cast<GIntBig>(nLines) * i / nJobs);
+            sJob.iEnd = static_cast<int>(
+                static_cast<GIntBig>(nLines) * (i + 1) / nJobs);
+            if( poJobQueue == nullptr ||
+                !poJobQueue->SubmitJob(ExactProximityComputeLines, &sJob) )
+            {
+                ExactProximityComputeLines(&sJob);
+            }
+        }
+        if( poJobQueue != nullptr )
+            poJobQueue->WaitCompletion();
+
+        // Write out results.
+        eErr = GDALRasterIO( hProximityBand, GF_Write,
+                             0, iYOff, nXSize, nLines,
+                             pafProximity, nXSize, nLines, GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        if( !pfnProgress( 0.5 + 0.5 * (nYSize - iYOff) /
+                                    static_cast<double>(nYSize),
+                          "", pProgressArg ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+    CPLFree( panSrc );
+    CPLFree( panColDist );
+    CPLFree( pafProximity );
+
+    return eErr;
+}
@@ -31,6 +31,7 @@
 #include "gdal_alg_priv.h"
 
 #include <cstddef>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -155,15 +156,15 @@ int GDALRasterPolygonEnumeratorT<DataType, EqualityTest>::NewPolygon(
 }
 
 /************************************************************************/
-/*                           CompleteMerges()                           */
+/*                           ResolveMerges()                            */
 /*                                                                      */
 /*      Make a pass through the maps, ensuring every polygon id         */
 /*      points to the final id it should use, not an intermediate       */
-/*      value.                                                          */
+/*      value.  Returns the number of final polygons.                   */
 /************************************************************************/
 
 template<class DataType, class EqualityTest>
-void GDALRasterPolygonEnumeratorT<DataType, EqualityTest>::CompleteMerges()
+int GDALRasterPolygonEnumeratorT<DataType, EqualityTest>::ResolveMerges()
 
 {
     int nFinalPolyCount = 0;
@@ -191,11 +192,54 @@ void GDALRasterPolygonEnumeratorT<DataType, EqualityTest>::CompleteMerges()
             nFinalPolyCount++;
     }
 
+    return nFinalPolyCount;
+}
+
+/************************************************************************/
+/*                           CompleteMerges()                           */
+/************************************************************************/
+
+template<class DataType, class EqualityTest>
+void GDALRasterPolygonEnumeratorT<DataType, EqualityTest>::CompleteMerges()
+
+{
+    const int nFinalPolyCount = ResolveMerges();
+
     CPLDebug( "GDALRasterPolygonEnumerator",
               "Counted %d polygon fragments forming %d final polygons.",
               nNextPolygonId, nFinalPolyCount );
 }
 
+/************************************************************************/
+/*                            KeepPolygons()                            */
+/*                                                                      */
+/*      Forget all polygons but the nPolyCount final ones listed in     */
+/*      panPolyIds, which are renumbered from 0 in the order of the     */
+/*      list.  Used to only keep the polygons of the last line when     */
+/*      streaming over a raster.                                        */
+/************************************************************************/
+
+template<class DataType, class EqualityTest>
+void GDALRasterPolygonEnumeratorT<DataType, EqualityTest>::KeepPolygons(
+    const GInt32 *panPolyIds, int nPolyCount )
+
+{
+    CPLAssert( nPolyCount <= nNextPolygonId );
+
+    // Copy the values first, as new ids may overlap old ones.
+    std::vector<DataType> anValues(nPolyCount);
+    for( int i = 0; i < nPolyCount; i++ )
+        anValues[i] = panPolyValue[panPolyIds[i]];
+
+    for( int i = 0; i < nPolyCount; i++ )
+    {
+        panPolyIdMap[i] = i;
+        panPolyValue[i] = anValues[i];
+    }
+
+    nNextPolygonId = nPolyCount;
+}
+
 /************************************************************************/
 /*                            ProcessLine()                             */
 /*                                                                      */
@@ -52,6 +52,7 @@
 #include "cpl_vsi.h"
 #include "gdal.h"
 #include "gdal_priv.h"
+#include "gdalsse_priv.h"
 #include "ogr_core.h"
 #include "ogr_spatialref.h"
 #include "ogr_srs_api.h"
@@ -64,6 +65,7 @@ void *GDALDeserializeGCPTransformer( CPLXMLNode *psTree );
 void *GDALDeserializeTPSTransformer( CPLXMLNode *psTree );
 void *GDALDeserializeGeoLocTransformer( CPLXMLNode *psTree );
 void *GDALDeserializeRPCTransformer( CPLXMLNode *psTree );
+void *GDALDeserializeGridTransformer( CPLXMLNode *psTree );
 CPL_C_END
 
 static CPLXMLNode *GDALSerializeReprojectionTransformer( void *pTransformArg );
@@ -1248,6 +1250,14 @@ static GDALGenImgProjTransformInfo* GDALCreateGenImgProjTransformerInternal()
  * method to be considered on the target dataset.  Will be used for pixel/line
  * to georef transformation on the destination dataset. NO_GEOTRANSFORM can be
  * used to specify the identity geotransform (ungeoreference image)
+ * <li> TPS_METHOD: FULL or LOCAL. (GDAL &gt;= 2.4) Whether a global thin
+ * plate spline, or a partition of unity of local ones, should be used for the
+ * GCP_TPS method. See GDALCreateTPSTransformer(). Defaults to the value of the
+ * GDAL_TPS_METHOD configuration option, or FULL.
+ * <li> TPS_LOCAL_POINTS: number of GCPs per local spline, when TPS_METHOD=LOCAL.
+ * (GDAL &gt;= 2.4) Defaults to 100.
+ * <li> TPS_LOCAL_OVERLAP: overlap between local splines, in fraction of their
+ * size, when TPS_METHOD=LOCAL. (GDAL &gt;= 2.4) Defaults to 0.5.
  * <li> RPC_HEIGHT: A fixed height to be used with RPC calculations.
  * <li> RPC_DEM: The name of a DEM file to be used with RPC calculations.
  * <li> Other RPC related options. See GDALCreateRPCTransformer()
@@ -1946,6 +1956,80 @@ void GDALDestroyGenImgProjTransformer( void *hTransformArg )
     CPLFree( psInfo );
 }
 
+/************************************************************************/
+/*                    GDALApplyGeoTransformToPoint()                    */
+/************************************************************************/
+
+static inline void GDALApplyGeoTransformToPoint( const double* padfGeoTransform,
+                                                 double* pdfX, double* pdfY,
+                                                 int bSuccess )
+{
+    if( !bSuccess )
+        return;
+
+    const double dfNewX = padfGeoTransform[0]
+        + *pdfX * padfGeoTransform[1]
+        + *pdfY * padfGeoTransform[2];
+    const double dfNewY = padfGeoTransform[3]
+        + *pdfX * padfGeoTransform[4]
+        + *pdfY * padfGeoTransform[5];
+
+    *pdfX = dfNewX;
+    *pdfY = dfNewY;
+}
+
+/************************************************************************/
+/*                   GDALApplyGeoTransformToPoints()                    */
+/************************************************************************/
+
+// Apply a geotransform to the points whose panSuccess flag is set. Points
+// are processed two at a time, with the same operations in the same order as
+// the scalar expression, so results are identical.
+static void GDALApplyGeoTransformToPoints( const double* padfGeoTransform,
+                                           int nPointCount,
+                                           double* padfX, double* padfY,
+                                           const int* panSuccess )
+{
+    const XMMReg2Double dfGT0 =
+        XMMReg2Double::Load1ValHighAndLow(padfGeoTransform + 0);
+    const XMMReg2Double dfGT1 =
+        XMMReg2Double::Load1ValHighAndLow(padfGeoTransform + 1);
+    const XMMReg2Double dfGT2 =
+        XMMReg2Double::Load1ValHighAndLow(padfGeoTransform + 2);
+    const XMMReg2Double dfGT3 =
+        XMMReg2Double::Load1ValHighAndLow(padfGeoTransform + 3);
+    const XMMReg2Double dfGT4 =
+        XMMReg2Double::Load1ValHighAndLow(padfGeoTransform + 4);
+    const XMMReg2Double dfGT5 =
+        XMMReg2Double::Load1ValHighAndLow(padfGeoTransform + 5);
+
+    int i = 0;
+    for( ; i + 1 < nPointCount; i += 2 )
+    {
+        if( panSuccess[i] && panSuccess[i+1] )
+        {
+            const XMMReg2Double dfX = XMMReg2Double::Load2Val(padfX + i);
+            const XMMReg2Double dfY = XMMReg2Double::Load2Val(padfY + i);
+            const XMMReg2Double dfNewX = dfGT0 + dfX * dfGT1 + dfY * dfGT2;
+            const XMMReg2Double dfNewY = dfGT3 + dfX * dfGT4 + dfY * dfGT5;
+            dfNewX.Store2Val(padfX + i);
+            dfNewY.Store2Val(padfY + i);
+        }
+        else
+        {
+            GDALApplyGeoTransformToPoint( padfGeoTransform, padfX + i,
+                                          padfY + i, panSuccess[i] );
+            GDALApplyGeoTransformToPoint( padfGeoTransform, padfX + i + 1,
+                                          padfY + i + 1, panSuccess[i+1] );
+        }
+    }
+    if( i < nPointCount )
+    {
+        GDALApplyGeoTransformToPoint( padfGeoTransform, padfX + i,
+                                      padfY + i, panSuccess[i] );
+    }
+}
+
 /************************************************************************/
 /*                      GDALGenImgProjTransform()                       */
 /************************************************************************/
@@ -2010,21 +2094,8 @@ int GDALGenImgProjTransform( void *pTransformArgIn, int bDstToSrc,
     }
     else
     {
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            if( !panSuccess[i] )
-                continue;
-
-            const double dfNewX = padfGeoTransform[0]
-                + padfX[i] * padfGeoTransform[1]
-                + padfY[i] * padfGeoTransform[2];
-            const double dfNewY = padfGeoTransform[3]
-                + padfX[i] * padfGeoTransform[4]
-                + padfY[i] * padfGeoTransform[5];
-
-            padfX[i] = dfNewX;
-            padfY[i] = dfNewY;
-        }
+        GDALApplyGeoTransformToPoints( padfGeoTransform, nPointCount,
+                                       padfX, padfY, panSuccess );
     }
 
 /* -------------------------------------------------------------------- */
@@ -2064,21 +2135,8 @@ int GDALGenImgProjTransform( void *pTransformArgIn, int bDstToSrc,
     }
     else
     {
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            if( !panSuccess[i] )
-                continue;
-
-            const double dfNewX = padfGeoTransform[0]
-                + padfX[i] * padfGeoTransform[1]
-                + padfY[i] * padfGeoTransform[2];
-            const double dfNewY = padfGeoTransform[3]
-                + padfX[i] * padfGeoTransform[4]
-                + padfY[i] * padfGeoTransform[5];
-
-            padfX[i] = dfNewX;
-            padfY[i] = dfNewY;
-        }
+        GDALApplyGeoTransformToPoints( padfGeoTransform, nPointCount,
+                                       padfX, padfY, panSuccess );
     }
 
     return TRUE;
@@ -2587,6 +2645,9 @@ GDALDeserializeReprojectionTransformer( CPLXMLNode *psTree )
 /* ==================================================================== */
 /************************************************************************/
 
+// Number of control points per row in 2D approximation mode.
+#define APPROX_2D_CTRL_COLS 9
+
 typedef struct
 {
     GDALTransformerInfo sTI;
@@ -2597,6 +2658,29 @@ typedef struct
     double dfMaxErrorReverse;
 
     int bOwnSubtransformer;
+
+    // 2D approximation: maximum number of rows covered by a pair of control
+    // rows, or 0 if disabled.
+    int n2DMaxRows;
+
+    // Control rows of the current 2D tile.
+    int b2DCacheValid;
+    int b2DDstToSrc;
+    int n2DPoints;
+    double df2DRowY[2];
+    double df2DZ;
+    int an2DCtrlIdx[APPROX_2D_CTRL_COLS];
+    double adf2DCtrlX[APPROX_2D_CTRL_COLS];
+    double adf2DX[2][APPROX_2D_CTRL_COLS];
+    double adf2DY[2][APPROX_2D_CTRL_COLS];
+    double adf2DZ[2][APPROX_2D_CTRL_COLS];
+
+    // Whether the current 2D tile reaches the error threshold. If not, its
+    // rows use the 1D approximation.
+    int b2DTileUsable;
+
+    // Whether the use of the 2D approximation has been reported.
+    int b2DReported;
 } ApproxTransformInfo;
 
 /************************************************************************/
@@ -2630,6 +2714,8 @@ GDALCreateSimilarApproxTransformer( void *hTransformArg,
         }
     }
     psClonedInfo->bOwnSubtransformer = TRUE;
+    psClonedInfo->b2DCacheValid = FALSE;
+    psClonedInfo->b2DReported = FALSE;
 
     return psClonedInfo;
 }
@@ -2664,6 +2750,12 @@ GDALSerializeApproxTransformer( void *pTransformArg )
                         CPLString().Printf("%g", psInfo->dfMaxErrorReverse) );
     }
 
+    if( psInfo->n2DMaxRows > 0 )
+    {
+        CPLCreateXMLElementAndValue( psTree, "Max2DRows",
+                        CPLString().Printf("%d", psInfo->n2DMaxRows) );
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Capture underlying transformer.                                 */
 /* -------------------------------------------------------------------- */
@@ -2710,6 +2802,15 @@ GDALSerializeApproxTransformer( void *pTransformArg )
  * circumstances as little internal validation is done, in order to keep things
  * fast.
  *
+ * When the GDAL_APPROX_TRANSFORMER_2D_ROWS configuration option is set to a
+ * value of 2 or more, the approximation is also done across scanlines: the
+ * exact transformer is evaluated on control points of two rows up to that
+ * many lines apart, and the scanlines in between are interpolated from them,
+ * provided the error at the center of the tile is within the threshold.
+ * This requires successive calls to pass the same X values, as warpers do.
+ * The control rows are cached in the transformer, so in that mode a
+ * transformer should not be used by several threads at the same time.
+ *
  * @param pfnBaseTransformer the high precision transformer which should be
  * approximated.
  * @param pBaseTransformArg the callback argument for the high precision
@@ -2746,6 +2847,12 @@ void *GDALCreateApproxTransformer2( GDALTransformerFunc pfnBaseTransformer,
     psATInfo->dfMaxErrorForward = dfMaxErrorForward;
     psATInfo->dfMaxErrorReverse = dfMaxErrorReverse;
     psATInfo->bOwnSubtransformer = FALSE;
+    psATInfo->n2DMaxRows =
+        atoi(CPLGetConfigOption("GDAL_APPROX_TRANSFORMER_2D_ROWS", "0"));
+    if( psATInfo->n2DMaxRows < 2 )
+        psATInfo->n2DMaxRows = 0;
+    psATInfo->b2DCacheValid = FALSE;
+    psATInfo->b2DReported = FALSE;
 
     memcpy(psATInfo->sTI.abySignature,
            GDAL_GTI2_SIGNATURE,
@@ -2799,6 +2906,262 @@ void GDALDestroyApproxTransformer( void * pCBData )
     CPLFree( pCBData );
 }
 
+/************************************************************************/
+/*                    GDALApproxInterpolateLinear()                     */
+/************************************************************************/
+
+// Replace the nPoints points by dfStart + dfDelta * (x - dfX0) on each axis.
+// Points are processed two at a time.
+static void GDALApproxInterpolateLinear( int nPoints,
+                                         double *x, double *y, double *z,
+                                         int *panSuccess,
+                                         double dfX0,
+                                         double dfStartX, double dfStartY,
+                                         double dfStartZ,
+                                         double dfDeltaX, double dfDeltaY,
+                                         double dfDeltaZ )
+{
+    const XMMReg2Double v_dfX0 = XMMReg2Double::Load1ValHighAndLow(&dfX0);
+    const XMMReg2Double v_dfStartX =
+        XMMReg2Double::Load1ValHighAndLow(&dfStartX);
+    const XMMReg2Double v_dfStartY =
+        XMMReg2Double::Load1ValHighAndLow(&dfStartY);
+    const XMMReg2Double v_dfStartZ =
+        XMMReg2Double::Load1ValHighAndLow(&dfStartZ);
+    const XMMReg2Double v_dfDeltaX =
+        XMMReg2Double::Load1ValHighAndLow(&dfDeltaX);
+    const XMMReg2Double v_dfDeltaY =
+        XMMReg2Double::Load1ValHighAndLow(&dfDeltaY);
+    const XMMReg2Double v_dfDeltaZ =
+        XMMReg2Double::Load1ValHighAndLow(&dfDeltaZ);
+
+    int i = 0;
+    for( ; i + 1 < nPoints; i += 2 )
+    {
+        const XMMReg2Double v_dfDist =
+            XMMReg2Double::Load2Val(x + i) - v_dfX0;
+        (v_dfStartX + v_dfDeltaX * v_dfDist).Store2Val(x + i);
+        (v_dfStartY + v_dfDeltaY * v_dfDist).Store2Val(y + i);
+        (v_dfStartZ + v_dfDeltaZ * v_dfDist).Store2Val(z + i);
+        panSuccess[i] = TRUE;
+        panSuccess[i+1] = TRUE;
+    }
+    if( i < nPoints )
+    {
+        const double dfDist = x[i] - dfX0;
+        x[i] = dfStartX + dfDeltaX * dfDist;
+        y[i] = dfStartY + dfDeltaY * dfDist;
+        z[i] = dfStartZ + dfDeltaZ * dfDist;
+        panSuccess[i] = TRUE;
+    }
+}
+
+/************************************************************************/
+/*                      GDALApproxBuild2DTile()                         */
+/************************************************************************/
+
+// Compute the control rows of a 2D tile starting at line dfY, with the
+// control columns already set in psATInfo. The tile height is reduced until
+// the bilinear interpolation at the center row of the tile, at the control
+// columns and halfway between them, is within the error threshold.
+static bool GDALApproxBuild2DTile( ApproxTransformInfo *psATInfo,
+                                   int bDstToSrc, const double *x,
+                                   double dfY, double dfZ )
+{
+    const int nCols = APPROX_2D_CTRL_COLS;
+    const int nCtrlPoints = 4 * nCols - 1;
+    const double dfMaxError = (bDstToSrc) ? psATInfo->dfMaxErrorReverse :
+                                            psATInfo->dfMaxErrorForward;
+    double adfX[nCtrlPoints] = {};
+    double adfY[nCtrlPoints] = {};
+    double adfZ[nCtrlPoints] = {};
+    int anSuccess[nCtrlPoints] = {};
+
+    for( int nRows = psATInfo->n2DMaxRows; nRows >= 2; nRows /= 2 )
+    {
+        // Layout: top row, bottom row and center row at the control columns,
+        // then center row halfway between control columns.
+        const double dfYBottom = dfY + nRows;
+        const double dfYCenter = dfY + nRows / 2;
+        for( int k = 0; k < nCols; k++ )
+        {
+            adfX[k] = psATInfo->adf2DCtrlX[k];
+            adfY[k] = dfY;
+            adfX[nCols + k] = psATInfo->adf2DCtrlX[k];
+            adfY[nCols + k] = dfYBottom;
+            adfX[2 * nCols + k] = psATInfo->adf2DCtrlX[k];
+            adfY[2 * nCols + k] = dfYCenter;
+            if( k + 1 < nCols )
+            {
+                adfX[3 * nCols + k] =
+                    x[(psATInfo->an2DCtrlIdx[k] +
+                       psATInfo->an2DCtrlIdx[k+1]) / 2];
+                adfY[3 * nCols + k] = dfYCenter;
+            }
+        }
+        for( int k = 0; k < nCtrlPoints; k++ )
+            adfZ[k] = dfZ;
+
+        if( !psATInfo->pfnBaseTransformer( psATInfo->pBaseCBData, bDstToSrc,
+                                           nCtrlPoints, adfX, adfY, adfZ,
+                                           anSuccess ) )
+        {
+            continue;
+        }
+        bool bOK = true;
+        for( int k = 0; bOK && k < nCtrlPoints; k++ )
+            bOK = anSuccess[k] != FALSE;
+
+        const double dfYRatio =
+            (dfYCenter - dfY) / static_cast<double>(nRows);
+        double adfCenterX[nCols] = {};
+        double adfCenterY[nCols] = {};
+        for( int k = 0; bOK && k < nCols; k++ )
+        {
+            adfCenterX[k] = adfX[k] + dfYRatio * (adfX[nCols + k] - adfX[k]);
+            adfCenterY[k] = adfY[k] + dfYRatio * (adfY[nCols + k] - adfY[k]);
+            const double dfError = fabs(adfCenterX[k] - adfX[2 * nCols + k]) +
+                                   fabs(adfCenterY[k] - adfY[2 * nCols + k]);
+            bOK = dfError <= dfMaxError;
+        }
+        for( int k = 0; bOK && k + 1 < nCols; k++ )
+        {
+            const double dfXRatio =
+                (x[(psATInfo->an2DCtrlIdx[k] +
+                    psATInfo->an2DCtrlIdx[k+1]) / 2] -
+                 psATInfo->adf2DCtrlX[k]) /
+                (psATInfo->adf2DCtrlX[k+1] - psATInfo->adf2DCtrlX[k]);
+            const double dfInterpX = adfCenterX[k] +
+                dfXRatio * (adfCenterX[k+1] - adfCenterX[k]);
+            const double dfInterpY = adfCenterY[k] +
+                dfXRatio * (adfCenterY[k+1] - adfCenterY[k]);
+            const double dfError = fabs(dfInterpX - adfX[3 * nCols + k]) +
+                                   fabs(dfInterpY - adfY[3 * nCols + k]);
+            bOK = dfError <= dfMaxError;
+        }
+        if( !bOK )
+            continue;
+
+        psATInfo->df2DRowY[1] = dfYBottom;
+        for( int k = 0; k < nCols; k++ )
+        {
+            psATInfo->adf2DX[0][k] = adfX[k];
+            psATInfo->adf2DY[0][k] = adfY[k];
+            psATInfo->adf2DZ[0][k] = adfZ[k];
+            psATInfo->adf2DX[1][k] = adfX[nCols + k];
+            psATInfo->adf2DY[1][k] = adfY[nCols + k];
+            psATInfo->adf2DZ[1][k] = adfZ[nCols + k];
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/************************************************************************/
+/*                        GDALApproxTransform2D()                       */
+/************************************************************************/
+
+// Transform a scanline by bilinear interpolation of the control rows of the
+// 2D tile containing it, computing that tile if needed. Returns -1 if the 2D
+// approximation cannot be used for that scanline.
+static int GDALApproxTransform2D( ApproxTransformInfo *psATInfo,
+                                  int bDstToSrc, int nPoints,
+                                  double *x, double *y, double *z,
+                                  int *panSuccess )
+{
+    const int nCols = APPROX_2D_CTRL_COLS;
+
+    // Need a point between each pair of control columns.
+    if( nPoints <= 2 * (nCols - 1) || z[0] != z[nPoints-1] )
+        return -1;
+
+    const double dfY = y[0];
+    const double dfZ = z[0];
+
+    bool bInTile = psATInfo->b2DCacheValid &&
+                   psATInfo->b2DDstToSrc == bDstToSrc &&
+                   psATInfo->n2DPoints == nPoints &&
+                   psATInfo->df2DZ == dfZ &&
+                   dfY >= psATInfo->df2DRowY[0] &&
+                   dfY <= psATInfo->df2DRowY[1];
+    for( int k = 0; bInTile && k < nCols; k++ )
+    {
+        bInTile = x[psATInfo->an2DCtrlIdx[k]] == psATInfo->adf2DCtrlX[k];
+    }
+
+    if( !bInTile )
+    {
+        psATInfo->b2DCacheValid = TRUE;
+        psATInfo->b2DDstToSrc = bDstToSrc;
+        psATInfo->n2DPoints = nPoints;
+        psATInfo->df2DZ = dfZ;
+        psATInfo->df2DRowY[0] = dfY;
+        for( int k = 0; k < nCols; k++ )
+        {
+            psATInfo->an2DCtrlIdx[k] = static_cast<int>(
+                static_cast<GIntBig>(nPoints - 1) * k / (nCols - 1));
+            psATInfo->adf2DCtrlX[k] = x[psATInfo->an2DCtrlIdx[k]];
+        }
+        psATInfo->b2DTileUsable =
+            GDALApproxBuild2DTile( psATInfo, bDstToSrc, x, dfY, dfZ );
+        if( !psATInfo->b2DTileUsable )
+        {
+            // Use the 1D approximation for the rows that the largest tile
+            // would have covered, rather than retrying at each row.
+            psATInfo->df2DRowY[1] = dfY + psATInfo->n2DMaxRows;
+        }
+    }
+
+    if( !psATInfo->b2DTileUsable )
+        return -1;
+
+    if( !psATInfo->b2DReported )
+    {
+        psATInfo->b2DReported = TRUE;
+        CPLDebug( "GDAL", "Approximate transformer: using 2D tiles of up "
+                  "to %d rows", psATInfo->n2DMaxRows );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Interpolate the control points for this row, and then the       */
+/*      points between them.                                            */
+/* -------------------------------------------------------------------- */
+    const double dfYRatio = (dfY - psATInfo->df2DRowY[0]) /
+                            (psATInfo->df2DRowY[1] - psATInfo->df2DRowY[0]);
+    double adfRowX[nCols] = {};
+    double adfRowY[nCols] = {};
+    double adfRowZ[nCols] = {};
+    for( int k = 0; k < nCols; k++ )
+    {
+        adfRowX[k] = psATInfo->adf2DX[0][k] + dfYRatio *
+            (psATInfo->adf2DX[1][k] - psATInfo->adf2DX[0][k]);
+        adfRowY[k] = psATInfo->adf2DY[0][k] + dfYRatio *
+            (psATInfo->adf2DY[1][k] - psATInfo->adf2DY[0][k]);
+        adfRowZ[k] = psATInfo->adf2DZ[0][k] + dfYRatio *
+            (psATInfo->adf2DZ[1][k] - psATInfo->adf2DZ[0][k]);
+    }
+
+    for( int k = 0; k + 1 < nCols; k++ )
+    {
+        const int iStart = psATInfo->an2DCtrlIdx[k];
+        const int iEnd = (k + 2 == nCols) ? nPoints :
+                                            psATInfo->an2DCtrlIdx[k+1];
+        const double dfDist =
+            psATInfo->adf2DCtrlX[k+1] - psATInfo->adf2DCtrlX[k];
+        GDALApproxInterpolateLinear( iEnd - iStart,
+                                     x + iStart, y + iStart, z + iStart,
+                                     panSuccess + iStart,
+                                     psATInfo->adf2DCtrlX[k],
+                                     adfRowX[k], adfRowY[k], adfRowZ[k],
+                                     (adfRowX[k+1] - adfRowX[k]) / dfDist,
+                                     (adfRowY[k+1] - adfRowY[k]) / dfDist,
+                                     (adfRowZ[k+1] - adfRowZ[k]) / dfDist );
+    }
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                      GDALApproxTransformInternal()                   */
 /************************************************************************/
@@ -3061,31 +3424,10 @@ static int GDALApproxTransformInternal( void *pCBData, int bDstToSrc,
 /*      NOTE: the above comment is not true: gdalwarp uses approximator */
 /*      also to compute the source pixel of each target pixel.          */
 /* -------------------------------------------------------------------- */
-    for( int i = nPoints-1; i >= 0; i-- )
-    {
-#ifdef check_error
-        double xtemp = x[i];
-        double ytemp = y[i];
-        double ztemp = z[i];
-        double x_ori = xtemp;
-        double y_ori = ytemp;
-        int btemp = FALSE;
-        psATInfo->pfnBaseTransformer( psATInfo->pBaseCBData, bDstToSrc,
-                                      1, &xtemp, &ytemp, &ztemp, &btemp);
-#endif
-        const double dfDist = (x[i] - x[0]);
-        x[i] = xSMETransformed[0] + dfDeltaX * dfDist;
-        y[i] = ySMETransformed[0] + dfDeltaY * dfDist;
-        z[i] = zSMETransformed[0] + dfDeltaZ * dfDist;
-#ifdef check_error
-        const double dfError2 = fabs(x[i] - xtemp) + fabs(y[i] - ytemp);
-        if( dfError2 > 4 /*10 * dfMaxError*/ )
-        {
-            /*ok*/printf("Error = %f on (%f, %f)\n", dfError2,  x_ori, y_ori);
-        }
-#endif
-        panSuccess[i] = TRUE;
-    }
+    GDALApproxInterpolateLinear( nPoints, x, y, z, panSuccess, x[0],
+                                 xSMETransformed[0], ySMETransformed[0],
+                                 zSMETransformed[0],
+                                 dfDeltaX, dfDeltaY, dfDeltaZ );
 
     return TRUE;
 }
@@ -3131,6 +3473,14 @@ int GDALApproxTransform( void *pCBData, int bDstToSrc, int nPoints,
         goto end;
     }
 
+    if( psATInfo->n2DMaxRows > 0 )
+    {
+        bRet = GDALApproxTransform2D( psATInfo, bDstToSrc, nPoints,
+                                      x, y, z, panSuccess );
+        if( bRet >= 0 )
+            goto end;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Transform first, last and middle point.                         */
 /* -------------------------------------------------------------------- */
@@ -3224,6 +3574,14 @@ GDALDeserializeApproxTransformer( CPLXMLNode *psTree )
                                                         dfMaxErrorReverse );
     GDALApproxTransformerOwnsSubtransformer( pApproxCBData, TRUE );
 
+    const char* pszMax2DRows = CPLGetXMLValue( psTree, "Max2DRows", nullptr);
+    if( pszMax2DRows != nullptr )
+    {
+        const int nMax2DRows = atoi(pszMax2DRows);
+        static_cast<ApproxTransformInfo *>(pApproxCBData)->n2DMaxRows =
+            nMax2DRows >= 2 ? nMax2DRows : 0;
+    }
+
     return pApproxCBData;
 }
 
@@ -3484,6 +3842,11 @@ CPLErr GDALDeserializeTransformer( CPLXMLNode *psTree,
         *ppfnFunc = GDALApproxTransform;
         *ppTransformArg = GDALDeserializeApproxTransformer( psTree );
     }
+    else if( EQUAL(psTree->pszValue, "GridTransformer") )
+    {
+        *ppfnFunc = GDALGridTransform;
+        *ppTransformArg = GDALDeserializeGridTransformer( psTree );
+    }
     else
     {
         GDALTransformDeserializeFunc pfnDeserializeFunc = nullptr;
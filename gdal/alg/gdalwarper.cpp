@@ -1141,6 +1141,24 @@ GDALWarpDstAlphaMasker( void *pMaskFuncArg, int nBandCount,
  * set the number of threads to use to parallelize the computation part of the
  * warping. If not set, computation will be done in a single thread.</li>
  *
+ * <li>CHUNKS_IN_FLIGHT: (GDAL >= 2.4) Maximum number of chunks processed at
+ * the same time by GDALWarpOperation::ChunkAndWarpMulti() (gdalwarp -multi),
+ * each one being read, warped or written. Defaults to 3. Each chunk in flight
+ * uses its own buffers of up to the warp memory limit.</li>
+ *
+ * <li>CHUNK_ORDER: (GDAL >= 2.4) Order in which the chunks are processed by
+ * GDALWarpOperation::ChunkAndWarpImage() and ChunkAndWarpMulti(). Can be
+ * DESTINATION (top to bottom, left to right in the destination), SOURCE
+ * (along a space filling curve going through the center of the source windows
+ * of the chunks) or AUTO (the default), which selects SOURCE when it is
+ * estimated to reduce the amount of source pixels read by at least 20%.
+ * This is typically the case for rotated or high latitude reprojections,
+ * where the source windows of consecutive chunks in destination order overlap
+ * poorly. In all cases, the part of the source window of a chunk that has
+ * already been read for the previous chunk is copied from its buffer rather
+ * than read again, which requires keeping one additional source buffer.
+ * STREAMABLE_OUTPUT=YES implies DESTINATION.</li>
+ *
  * <li>STREAMABLE_OUTPUT: (GDAL >= 2.0) This defaults to FALSE, but may
  * be set to TRUE typically when writing to a streamed file. The
  * gdalwarp utility automatically sets this option when writing to
@@ -1588,6 +1606,8 @@ GDALSerializeWarpOptions( const GDALWarpOptions *psWO )
         pszAlgName = "Quartile1";
     else if( psWO->eResampleAlg == GRA_Q3 )
         pszAlgName = "Quartile3";
+    else if( psWO->eResampleAlg == GRA_Sum )
+        pszAlgName = "Sum";
     else
         pszAlgName = "Unknown";
 
@@ -1837,6 +1857,8 @@ GDALWarpOptions * CPL_STDCALL GDALDeserializeWarpOptions( CPLXMLNode *psTree )
         psWO->eResampleAlg = GRA_Q1;
     else if( EQUAL(pszValue, "Quartile3") )
         psWO->eResampleAlg = GRA_Q3;
+    else if( EQUAL(pszValue, "Sum") )
+        psWO->eResampleAlg = GRA_Sum;
     else if( EQUAL(pszValue, "Default") )
         /* leave as is */;
     else
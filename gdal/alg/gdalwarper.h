@@ -60,7 +60,8 @@ typedef enum {
   /*! Min (selects minimum of all non-NODATA contributing pixels) */ GRA_Min=9,
   /*! Med (selects median of all non-NODATA contributing pixels) */ GRA_Med=10,
   /*! Q1 (selects first quartile of all non-NODATA contributing pixels) */ GRA_Q1=11,
-  /*! Q3 (selects third quartile of all non-NODATA contributing pixels) */ GRA_Q3=12
+  /*! Q3 (selects third quartile of all non-NODATA contributing pixels) */ GRA_Q3=12,
+  /*! Sum (computes the sum of all non-NODATA contributing pixels) */ GRA_Sum=13
 } GDALResampleAlg;
 
 /*! GWKAverageOrMode Algorithm */
@@ -70,7 +71,8 @@ typedef enum {
     /*! Mode of GDT_Byte, GDT_UInt16, or GDT_Int16 */ GWKAOM_Imode=3,
     /*! Maximum */ GWKAOM_Max=4,
     /*! Minimum */ GWKAOM_Min=5,
-    /*! Quantile */ GWKAOM_Quant=6
+    /*! Quantile */ GWKAOM_Quant=6,
+    /*! Sum */ GWKAOM_Sum=7
 } GWKAverageOrModeAlg;
 
 /*! @cond Doxygen_Suppress */
@@ -433,6 +435,8 @@ void GWKThreadsEnd(void* psThreadDataIn);
 
 /*! @cond Doxygen_Suppress */
 typedef struct _GDALWarpChunk GDALWarpChunk;
+typedef struct _GDALWarpChunkPipeline GDALWarpChunkPipeline;
+typedef struct _GDALWarpSrcWindowCache GDALWarpSrcWindowCache;
 /*! @endcond */
 
 class CPL_DLL GDALWarpOperation {
@@ -452,7 +456,8 @@ private:
     static CPLErr          CreateKernelMask( GDALWarpKernel *, int iBand,
                                       const char *pszType );
 
-    CPLMutex        *hIOMutex;
+    GDALWarpChunkPipeline *psPipeline;
+    GDALWarpSrcWindowCache *psSrcWindowCache;
     CPLMutex        *hWarpMutex;
 
     int             nChunkListCount;
@@ -471,6 +476,16 @@ private:
                                       int nDstXSize, int nDstYSize );
     void            ReportTiming( const char * );
 
+    bool            AcquireSrcIOMutex();
+    void            ReleaseSrcIOMutex();
+    bool            AcquireDstIOMutex();
+    void            ReleaseDstIOMutex();
+    bool            WaitForWriteTurn( int nDstXOff, int nDstYOff,
+                                      int nDstXSize, int nDstYSize );
+    void            EndWriteTurn();
+    void            BeginSrcWindowCache( GDALWarpSrcWindowCache* psCache );
+    void            EndSrcWindowCache();
+
 public:
                     GDALWarpOperation();
     virtual        ~GDALWarpOperation();
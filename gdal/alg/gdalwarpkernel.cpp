@@ -45,6 +45,7 @@
 
 #include "cpl_atomic_ops.h"
 #include "cpl_conv.h"
+#include "cpl_cpu_features.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
 #include "cpl_progress.h"
@@ -54,6 +55,7 @@
 #include "gdal.h"
 #include "gdal_alg.h"
 #include "gdal_alg_priv.h"
+#include "gdal_thread_pool.h"
 #include "gdalwarpkernel_opencl.h"
 
 // We restrict to 64bit processors because they are guaranteed to have SSE2.
@@ -71,6 +73,14 @@
 
 #endif
 
+// Build with -DGWK_PROFILING to collect the time spent in the source pixel
+// fetching and destination pixel writing helpers. Used by
+// autotest/cpp/testperfwarp.
+#ifdef GWK_PROFILING
+#include <atomic>
+#include <chrono>
+#endif
+
 CPL_CVSID("$Id$")
 
 constexpr double BAND_DENSITY_THRESHOLD = 0.0000000001;
@@ -78,6 +88,142 @@ constexpr float SRC_DENSITY_THRESHOLD =  0.000000001f;
 
 // #define INSTANTIATE_FLOAT64_SSE2_IMPL
 
+/************************************************************************/
+/*                      Profiling of helper functions                   */
+/************************************************************************/
+
+#ifdef GWK_PROFILING
+
+namespace {
+
+std::atomic<GUIntBig> gnGWKGetPixelRowCalls(0);
+std::atomic<GUIntBig> gnGWKGetPixelRowNanoSec(0);
+std::atomic<GUIntBig> gnGWKSetPixelCalls(0);
+std::atomic<GUIntBig> gnGWKSetPixelNanoSec(0);
+
+class GWKProfilingScope
+{
+    std::atomic<GUIntBig>& m_nCalls;
+    std::atomic<GUIntBig>& m_nNanoSec;
+    std::chrono::steady_clock::time_point m_oStart;
+
+    CPL_DISALLOW_COPY_ASSIGN(GWKProfilingScope)
+
+  public:
+    GWKProfilingScope( std::atomic<GUIntBig>& nCalls,
+                       std::atomic<GUIntBig>& nNanoSec ) :
+        m_nCalls(nCalls), m_nNanoSec(nNanoSec),
+        m_oStart(std::chrono::steady_clock::now()) {}
+
+    ~GWKProfilingScope()
+    {
+        const auto oEnd = std::chrono::steady_clock::now();
+        m_nCalls.fetch_add(1, std::memory_order_relaxed);
+        m_nNanoSec.fetch_add(static_cast<GUIntBig>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                oEnd - m_oStart).count()), std::memory_order_relaxed);
+    }
+};
+
+} // namespace
+
+#define GWK_PROFILE_GET_PIXEL_ROW() \
+    GWKProfilingScope oProfilingScope(gnGWKGetPixelRowCalls, \
+                                      gnGWKGetPixelRowNanoSec)
+#define GWK_PROFILE_SET_PIXEL() \
+    GWKProfilingScope oProfilingScope(gnGWKSetPixelCalls, \
+                                      gnGWKSetPixelNanoSec)
+
+#else
+
+#define GWK_PROFILE_GET_PIXEL_ROW()
+#define GWK_PROFILE_SET_PIXEL()
+
+#endif
+
+/************************************************************************/
+/*                     GWKResetProfilingCounters()                      */
+/************************************************************************/
+
+/** Reset the warp kernel profiling counters.
+ *
+ * Only useful when GDAL is built with -DGWK_PROFILING.
+ */
+void GWKResetProfilingCounters()
+{
+#ifdef GWK_PROFILING
+    gnGWKGetPixelRowCalls = 0;
+    gnGWKGetPixelRowNanoSec = 0;
+    gnGWKSetPixelCalls = 0;
+    gnGWKSetPixelNanoSec = 0;
+#endif
+}
+
+/************************************************************************/
+/*                      GWKGetProfilingCounters()                       */
+/************************************************************************/
+
+/** Fetch the warp kernel profiling counters accumulated since the last
+ * call to GWKResetProfilingCounters().
+ *
+ * @return TRUE if GDAL is built with -DGWK_PROFILING, FALSE otherwise (in
+ * which case the counters are set to zero).
+ */
+int GWKGetProfilingCounters( GWKProfilingCounters* psCounters )
+{
+#ifdef GWK_PROFILING
+    psCounters->nGetPixelRowCalls = gnGWKGetPixelRowCalls;
+    psCounters->dfGetPixelRowTime = gnGWKGetPixelRowNanoSec * 1e-9;
+    psCounters->nSetPixelCalls = gnGWKSetPixelCalls;
+    psCounters->dfSetPixelTime = gnGWKSetPixelNanoSec * 1e-9;
+    return TRUE;
+#else
+    memset(psCounters, 0, sizeof(GWKProfilingCounters));
+    return FALSE;
+#endif
+}
+
+#if defined(HAVE_AVX2_AT_COMPILE_TIME) && (defined(__x86_64) || defined(_M_X64))
+#define HAVE_AVX2_WARP_KERNELS
+
+// Implemented in gdalwarpkernel_avx2.cpp
+void GWKResampleNoMasks4SampleRow_AVX2( GDALResampleAlg eResample,
+                                        const GByte* pSrc,
+                                        int nSrcXSize, int nSrcYSize,
+                                        int nSrcXOff, int nSrcYOff,
+                                        int nCount,
+                                        const double* padfX,
+                                        const double* padfY,
+                                        const int* pabSuccess,
+                                        GByte* pDst, GByte* pabyDone );
+void GWKResampleNoMasks4SampleRow_AVX2( GDALResampleAlg eResample,
+                                        const GInt16* pSrc,
+                                        int nSrcXSize, int nSrcYSize,
+                                        int nSrcXOff, int nSrcYOff,
+                                        int nCount,
+                                        const double* padfX,
+                                        const double* padfY,
+                                        const int* pabSuccess,
+                                        GInt16* pDst, GByte* pabyDone );
+void GWKResampleNoMasks4SampleRow_AVX2( GDALResampleAlg eResample,
+                                        const GUInt16* pSrc,
+                                        int nSrcXSize, int nSrcYSize,
+                                        int nSrcXOff, int nSrcYOff,
+                                        int nCount,
+                                        const double* padfX,
+                                        const double* padfY,
+                                        const int* pabSuccess,
+                                        GUInt16* pDst, GByte* pabyDone );
+bool GWKBilinearResample4SampleRow_AVX2( const GDALWarpKernel* poWK,
+                                         int iBand, int nCount,
+                                         const double* padfX,
+                                         const double* padfY,
+                                         const int* pabSuccess,
+                                         double* padfDensity,
+                                         double* padfReal,
+                                         GByte* pabyDone );
+#endif
+
 static const int anGWKFilterRadius[] =
 {
     0,  // Nearest neighbour
@@ -93,6 +239,7 @@ static const int anGWKFilterRadius[] =
     0,  // Med
     0,  // Q1
     0,  // Q3
+    0,  // Sum
 };
 
 static double GWKBilinear(double dfX);
@@ -115,6 +262,7 @@ static const FilterFuncType apfGWKFilter[] =
     nullptr,  // Med
     nullptr,  // Q1
     nullptr,  // Q3
+    nullptr,  // Sum
 };
 
 // TODO(schwehr): Can we make these functions have a const * const arg?
@@ -138,6 +286,7 @@ static const FilterFunc4ValuesType apfGWKFilter4Values[] =
     nullptr,  // Med
     nullptr,  // Q1
     nullptr,  // Q3
+    nullptr,  // Sum
 };
 
 int GWKGetFilterRadius(GDALResampleAlg eResampleAlg)
@@ -303,7 +452,8 @@ static void GWKThreadInitTransformer(void* pData)
 
 typedef struct
 {
-    CPLWorkerThreadPool* poThreadPool;
+    CPLJobQueue* poJobQueue;
+    int nThreads;
     GWKJobStruct* pasThreadJob;
     CPLCond* hCond;
     CPLMutex* hCondMutex;
@@ -374,15 +524,17 @@ void* GWKThreadsCreate( char** papszWarpOptions,
             apInitData.push_back(&(psThreadData->pasThreadJob[i]));
         }
 
-        psThreadData->poThreadPool = new (std::nothrow) CPLWorkerThreadPool();
-        if( psThreadData->poThreadPool == nullptr ||
-            !psThreadData->poThreadPool->Setup(nThreads,
-                                          GWKThreadInitTransformer,
-                                          &apInitData[0]) )
+        psThreadData->poJobQueue =
+            GDALCreateGlobalThreadPoolJobQueue(nThreads).release();
+        psThreadData->nThreads = nThreads;
+        if( psThreadData->poJobQueue == nullptr ||
+            !psThreadData->poJobQueue->SubmitJobs(GWKThreadInitTransformer,
+                                                  apInitData) )
         {
             GWKThreadsEnd(psThreadData);
             return nullptr;
         }
+        psThreadData->poJobQueue->WaitCompletion();
 
         for( int i = 1; i < nThreads; i++ )
         {
@@ -404,8 +556,8 @@ void* GWKThreadsCreate( char** papszWarpOptions,
             }
             CPLFree(psThreadData->pasThreadJob);
             psThreadData->pasThreadJob = nullptr;
-            delete psThreadData->poThreadPool;
-            psThreadData->poThreadPool = nullptr;
+            delete psThreadData->poJobQueue;
+            psThreadData->poJobQueue = nullptr;
 
             CPLDebug("WARP", "Cannot duplicate transformer function. "
                      "Falling back to mono-thread computation");
@@ -425,16 +577,18 @@ void GWKThreadsEnd( void* psThreadDataIn )
         return;
 
     GWKThreadData* psThreadData = static_cast<GWKThreadData *>(psThreadDataIn);
-    if( psThreadData->poThreadPool )
+    if( psThreadData->poJobQueue )
     {
-        const int nThreads = psThreadData->poThreadPool->GetThreadCount();
+        // Wait for the transformer initialization jobs, in case of failure.
+        psThreadData->poJobQueue->WaitCompletion();
+        const int nThreads = psThreadData->nThreads;
         for( int i = 1; i < nThreads; i++ )
         {
             if( psThreadData->pasThreadJob[i].pTransformerArg )
                 GDALDestroyTransformer(psThreadData->
                                        pasThreadJob[i].pTransformerArg);
         }
-        delete psThreadData->poThreadPool;
+        delete psThreadData->poJobQueue;
     }
     CPLFree(psThreadData->pasThreadJob);
     if( psThreadData->hCond )
@@ -471,13 +625,12 @@ static CPLErr GWKRun( GDALWarpKernel *poWK,
 
     GWKThreadData* psThreadData =
         static_cast<GWKThreadData*>(poWK->psThreadData);
-    if( psThreadData == nullptr || psThreadData->poThreadPool == nullptr )
+    if( psThreadData == nullptr || psThreadData->poJobQueue == nullptr )
     {
         return GWKGenericMonoThread(poWK, pfnFunc);
     }
 
-    int nThreads =
-        std::min(psThreadData->poThreadPool->GetThreadCount(), nDstYSize / 2);
+    int nThreads = std::min(psThreadData->nThreads, nDstYSize / 2);
     // Config option mostly useful for tests to be able to test multithreading
     // with small rasters
     const int nWarpChunkSize = atoi(
@@ -516,7 +669,7 @@ static CPLErr GWKRun( GDALWarpKernel *poWK,
             psThreadData->pasThreadJob[i].pfnProgress = GWKProgressThread;
         else
             psThreadData->pasThreadJob[i].pfnProgress = nullptr;
-        psThreadData->poThreadPool->SubmitJob( pfnFunc,
+        psThreadData->poJobQueue->SubmitJob( pfnFunc,
                             static_cast<void*>(&psThreadData->pasThreadJob[i]) );
     }
 
@@ -548,7 +701,7 @@ static CPLErr GWKRun( GDALWarpKernel *poWK,
 /* -------------------------------------------------------------------- */
 /*      Wait for all jobs to complete.                                  */
 /* -------------------------------------------------------------------- */
-    psThreadData->poThreadPool->WaitCompletion();
+    psThreadData->poJobQueue->WaitCompletion();
 
     return !bStop ? CE_None : CE_Failure;
 }
@@ -1276,6 +1429,9 @@ CPLErr GDALWarpKernel::PerformWarp()
     if( eResample == GRA_Q3 )
         return GWKAverageOrMode( this );
 
+    if( eResample == GRA_Sum )
+        return GWKAverageOrMode( this );
+
     if( !GDALDataTypeIsComplex(eWorkingDataType) )
         return GWKRealCase( this );
 
@@ -1404,6 +1560,8 @@ static bool GWKSetPixelValueRealT( GDALWarpKernel *poWK, int iBand,
                                    int iDstOffset, double dfDensity,
                                    T value)
 {
+    GWK_PROFILE_SET_PIXEL();
+
     T *pDst = reinterpret_cast<T*>(poWK->papabyDstImage[iBand]);
 
 /* -------------------------------------------------------------------- */
@@ -1476,6 +1634,8 @@ static bool GWKSetPixelValue( GDALWarpKernel *poWK, int iBand,
                               double dfReal, double dfImag )
 
 {
+    GWK_PROFILE_SET_PIXEL();
+
     GByte *pabyDst = poWK->papabyDstImage[iBand];
 
 /* -------------------------------------------------------------------- */
@@ -1702,6 +1862,8 @@ static bool GWKSetPixelValueReal( GDALWarpKernel *poWK, int iBand,
                                   double dfReal )
 
 {
+    GWK_PROFILE_SET_PIXEL();
+
     GByte *pabyDst = poWK->papabyDstImage[iBand];
 
 /* -------------------------------------------------------------------- */
@@ -1988,6 +2150,8 @@ static bool GWKGetPixelRow( GDALWarpKernel *poWK, int iBand,
                             double adfReal[],
                             double* padfImag )
 {
+    GWK_PROFILE_GET_PIXEL_ROW();
+
     // We know that nSrcLen is even, so we can *always* unroll loops 2x.
     const int nSrcLen = nHalfSrcLen * 2;
     bool bHasValid = false;
@@ -4992,6 +5156,28 @@ static void GWKRealCaseThread( void* pData)
     for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
         padfX[nDstXSize + iDstX] = iDstX + 0.5 + poWK->nDstXOff;
 
+#ifdef HAVE_AVX2_WARP_KERNELS
+    // Bilinear densities and values of a whole scanline for each band, and
+    // whether they could be computed by the AVX2 kernel.
+    const bool bUseAVX2 =
+        poWK->eResample == GRA_Bilinear && bUse4SamplesFormula &&
+        nSrcXSize > 1 && nSrcYSize > 1 && nDstXSize >= 4 &&
+        (poWK->eWorkingDataType == GDT_Byte ||
+         poWK->eWorkingDataType == GDT_Int16 ||
+         poWK->eWorkingDataType == GDT_UInt16 ||
+         poWK->eWorkingDataType == GDT_Float32) &&
+        CPLHaveRuntimeAVX2();
+    std::vector<double> adfAVX2Density;
+    std::vector<double> adfAVX2Real;
+    std::vector<GByte> abyAVX2Done;
+    if( bUseAVX2 )
+    {
+        adfAVX2Density.resize(static_cast<size_t>(poWK->nBands) * nDstXSize);
+        adfAVX2Real.resize(static_cast<size_t>(poWK->nBands) * nDstXSize);
+        abyAVX2Done.resize(nDstXSize);
+    }
+#endif
+
 /* ==================================================================== */
 /*      Loop over output lines.                                         */
 /* ==================================================================== */
@@ -5024,6 +5210,20 @@ static void GWKRealCaseThread( void* pData)
                                       iDstY + 0.5 + poWK->nDstYOff);
         }
 
+#ifdef HAVE_AVX2_WARP_KERNELS
+        if( bUseAVX2 )
+        {
+            for( int iBand = 0; iBand < poWK->nBands; iBand++ )
+            {
+                const size_t nOffset = static_cast<size_t>(iBand) * nDstXSize;
+                GWKBilinearResample4SampleRow_AVX2(
+                    poWK, iBand, nDstXSize, padfX, padfY, pabSuccess,
+                    &adfAVX2Density[nOffset], &adfAVX2Real[nOffset],
+                    &abyAVX2Done[0]);
+            }
+        }
+#endif
+
 /* ==================================================================== */
 /*      Loop over pixels in output scanline.                            */
 /* ==================================================================== */
@@ -5076,6 +5276,15 @@ static void GWKRealCaseThread( void* pData)
                         GWKGetPixelValueReal( poWK, iBand, iSrcOffset,
                                               &dfBandDensity, &dfValueReal ));
                 }
+#ifdef HAVE_AVX2_WARP_KERNELS
+                else if( bUseAVX2 && abyAVX2Done[iDstX] )
+                {
+                    const size_t nOffset =
+                        static_cast<size_t>(iBand) * nDstXSize + iDstX;
+                    dfBandDensity = adfAVX2Density[nOffset];
+                    dfValueReal = adfAVX2Real[nOffset];
+                }
+#endif
                 else if( poWK->eResample == GRA_Bilinear &&
                          bUse4SamplesFormula )
                 {
@@ -5197,6 +5406,67 @@ static CPLErr GWKRealCase( GDALWarpKernel *poWK )
     return GWKRun( poWK, "GWKRealCase", GWKRealCaseThread );
 }
 
+#ifdef HAVE_AVX2_WARP_KERNELS
+
+/************************************************************************/
+/*                  GWKResampleNoMasks4SampleRowAVX2()                  */
+/************************************************************************/
+
+// Returns false for the data types that have no AVX2 implementation.
+template<class T>
+static bool GWKResampleNoMasks4SampleRowAVX2( const GDALWarpKernel* /*poWK*/,
+                                              GDALResampleAlg /*eResample*/,
+                                              int /*iBand*/,
+                                              const double* /*padfX*/,
+                                              const double* /*padfY*/,
+                                              const int* /*pabSuccess*/,
+                                              T* /*pDst*/,
+                                              GByte* /*pabyDone*/ )
+{
+    return false;
+}
+
+template<class T>
+static bool GWKResampleNoMasks4SampleRowAVX2Impl( const GDALWarpKernel* poWK,
+                                                  GDALResampleAlg eResample,
+                                                  int iBand,
+                                                  const double* padfX,
+                                                  const double* padfY,
+                                                  const int* pabSuccess,
+                                                  T* pDst,
+                                                  GByte* pabyDone )
+{
+    GWKResampleNoMasks4SampleRow_AVX2(
+        eResample,
+        reinterpret_cast<const T*>(poWK->papabySrcImage[iBand]),
+        poWK->nSrcXSize, poWK->nSrcYSize,
+        poWK->nSrcXOff, poWK->nSrcYOff,
+        poWK->nDstXSize, padfX, padfY, pabSuccess, pDst, pabyDone);
+    return true;
+}
+
+#define GWK_AVX2_NO_MASKS_ROW_SPECIALIZATION(T) \
+template<> \
+bool GWKResampleNoMasks4SampleRowAVX2<T>( const GDALWarpKernel* poWK, \
+                                          GDALResampleAlg eResample, \
+                                          int iBand, \
+                                          const double* padfX, \
+                                          const double* padfY, \
+                                          const int* pabSuccess, \
+                                          T* pDst, \
+                                          GByte* pabyDone ) \
+{ \
+    return GWKResampleNoMasks4SampleRowAVX2Impl( poWK, eResample, iBand, \
+                                                 padfX, padfY, pabSuccess, \
+                                                 pDst, pabyDone ); \
+}
+
+GWK_AVX2_NO_MASKS_ROW_SPECIALIZATION(GByte)
+GWK_AVX2_NO_MASKS_ROW_SPECIALIZATION(GInt16)
+GWK_AVX2_NO_MASKS_ROW_SPECIALIZATION(GUInt16)
+
+#endif // HAVE_AVX2_WARP_KERNELS
+
 /************************************************************************/
 /*                GWKResampleNoMasksOrDstDensityOnlyThreadInternal()    */
 /************************************************************************/
@@ -5241,6 +5511,22 @@ static void GWKResampleNoMasksOrDstDensityOnlyThreadInternal( void* pData )
     for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
         padfX[nDstXSize + iDstX] = iDstX + 0.5 + poWK->nDstXOff;
 
+#ifdef HAVE_AVX2_WARP_KERNELS
+    // Interpolated values of a whole scanline for each band, and whether
+    // they could be computed by the AVX2 kernels.
+    const bool bUseAVX2 =
+        bUse4SamplesFormula &&
+        (eResample == GRA_Bilinear || eResample == GRA_Cubic) &&
+        nDstXSize >= 8 && CPLHaveRuntimeAVX2();
+    std::vector<T> aAVX2Values;
+    std::vector<GByte> abyAVX2Done;
+    if( bUseAVX2 )
+    {
+        aAVX2Values.resize(static_cast<size_t>(poWK->nBands) * nDstXSize);
+        abyAVX2Done.resize(nDstXSize);
+    }
+#endif
+
 /* ==================================================================== */
 /*      Loop over output lines.                                         */
 /* ==================================================================== */
@@ -5272,6 +5558,24 @@ static void GWKResampleNoMasksOrDstDensityOnlyThreadInternal( void* pData )
                                       iDstY + 0.5 + poWK->nDstYOff);
         }
 
+#ifdef HAVE_AVX2_WARP_KERNELS
+/* -------------------------------------------------------------------- */
+/*      Interpolate the pixels far enough from the source window        */
+/*      edges by groups of 8.                                           */
+/* -------------------------------------------------------------------- */
+        bool bAVX2Row = false;
+        if( bUseAVX2 )
+        {
+            for( int iBand = 0; iBand < poWK->nBands; iBand++ )
+            {
+                bAVX2Row = GWKResampleNoMasks4SampleRowAVX2(
+                    poWK, eResample, iBand, padfX, padfY, pabSuccess,
+                    &aAVX2Values[static_cast<size_t>(iBand) * nDstXSize],
+                    &abyAVX2Done[0]);
+            }
+        }
+#endif
+
 /* ==================================================================== */
 /*      Loop over pixels in output scanline.                            */
 /* ==================================================================== */
@@ -5296,6 +5600,13 @@ static void GWKResampleNoMasksOrDstDensityOnlyThreadInternal( void* pData )
                     value = reinterpret_cast<T *>(
                         poWK->papabySrcImage[iBand])[iSrcOffset];
                 }
+#ifdef HAVE_AVX2_WARP_KERNELS
+                else if( bAVX2Row && abyAVX2Done[iDstX] )
+                {
+                    value = aAVX2Values[
+                        static_cast<size_t>(iBand) * nDstXSize + iDstX];
+                }
+#endif
                 else if( bUse4SamplesFormula )
                 {
                     if( eResample == GRA_Bilinear )
@@ -5690,6 +6001,561 @@ static CPLErr GWKAverageOrMode( GDALWarpKernel *poWK )
     return GWKRun( poWK, "GWKAverageOrMode", GWKAverageOrModeThread );
 }
 
+namespace {
+
+/************************************************************************/
+/*                            GWKAOMState                               */
+/************************************************************************/
+
+// Source window of a destination pixel.
+struct GWKAOMWindow
+{
+    bool bValid = false;
+    int  iXMin = 0;
+    int  iXMax = 0;
+    int  iYMin = 0;
+    int  iYMax = 0;
+};
+
+// Working buffers of a GWKAverageOrModeThread() job, allocated once and
+// reused for every destination line and band.
+struct GWKAOMState
+{
+    GDALWarpKernel *poWK = nullptr;
+    int nAlgo = 0;
+
+    // Only used with nAlgo == GWKAOM_Imode.
+    int *panVals = nullptr;
+    int nBins = 0;
+    int nBinsOffset = 0;
+
+    // Only used with nAlgo == GWKAOM_Fmode.
+    float *pafVals = nullptr;
+    int *panSums = nullptr;
+
+    // Only used with nAlgo == GWKAOM_Quant.
+    float quant = 0.5;
+    std::vector<double> adfValues{};
+
+    // Source windows of the destination pixels of the current line.
+    std::vector<GWKAOMWindow> aoWindows{};
+
+    // Whether all the windows of the current line cover the same source
+    // lines, and the union of their source columns.
+    bool bSameSrcLines = false;
+    int iLineXMin = 0;
+    int iLineXMax = 0;
+
+    // Per source column accumulators of the current line.
+    std::vector<double> adfColumnValue{};
+    std::vector<int> anColumnCount{};
+
+    // Result of the current band for the current line.
+    std::vector<double> adfDstValue{};
+    std::vector<GByte> abyDstFound{};
+};
+
+/************************************************************************/
+/*                          GWKAOMSource                                */
+/************************************************************************/
+
+// Typed access to the valid source pixels of a band, with the same
+// validity rules as GWKGetPixelValue().
+template<class T> struct GWKAOMSource
+{
+    const T *pSrc = nullptr;
+    // 2 for complex data types, whose real part only is used.
+    int nStride = 1;
+    const GUInt32 *panUnifiedSrcValid = nullptr;
+    const GUInt32 *panBandSrcValid = nullptr;
+    const float *pafUnifiedSrcDensity = nullptr;
+
+    GWKAOMSource( const GDALWarpKernel *poWK, int iBand, int nStrideIn ) :
+        pSrc(reinterpret_cast<const T *>(poWK->papabySrcImage[iBand])),
+        nStride(nStrideIn),
+        panUnifiedSrcValid(poWK->panUnifiedSrcValid),
+        panBandSrcValid(poWK->papanBandSrcValid ?
+                            poWK->papanBandSrcValid[iBand] : nullptr),
+        pafUnifiedSrcDensity(poWK->pafUnifiedSrcDensity)
+    {}
+
+    bool HasMask() const
+    {
+        return panUnifiedSrcValid != nullptr || panBandSrcValid != nullptr ||
+               pafUnifiedSrcDensity != nullptr;
+    }
+
+    bool IsValid( int iSrcOffset ) const
+    {
+        if( panUnifiedSrcValid != nullptr
+            && !(panUnifiedSrcValid[iSrcOffset>>5]
+                 & (0x01 << (iSrcOffset & 0x1f))) )
+            return false;
+        if( panBandSrcValid != nullptr
+            && !(panBandSrcValid[iSrcOffset>>5]
+                 & (0x01 << (iSrcOffset & 0x1f))) )
+            return false;
+        return pafUnifiedSrcDensity == nullptr ||
+               pafUnifiedSrcDensity[iSrcOffset] > BAND_DENSITY_THRESHOLD;
+    }
+
+    double GetValue( int iSrcOffset ) const
+    {
+        return static_cast<double>(pSrc[iSrcOffset * nStride]);
+    }
+};
+
+/************************************************************************/
+/*                      GWKAOMComputeWindows()                          */
+/************************************************************************/
+
+void GWKAOMComputeWindows( GWKAOMState& oState,
+                           const double* padfX, const double* padfY,
+                           const int* pabSuccess,
+                           const double* padfX2, const double* padfY2,
+                           const int* pabSuccess2 )
+{
+    const GDALWarpKernel *poWK = oState.poWK;
+    const int nSrcXSize = poWK->nSrcXSize;
+    const int nSrcYSize = poWK->nSrcYSize;
+
+    oState.bSameSrcLines = true;
+    oState.iLineXMin = nSrcXSize;
+    oState.iLineXMax = 0;
+    bool bFirst = true;
+    int iLineYMin = 0;
+    int iLineYMax = 0;
+
+    for( int iDstX = 0; iDstX < poWK->nDstXSize; iDstX++ )
+    {
+        GWKAOMWindow& oWindow = oState.aoWindows[iDstX];
+        oWindow.bValid = pabSuccess[iDstX] && pabSuccess2[iDstX];
+        if( !oWindow.bValid )
+            continue;
+
+        // Compute corners in source crs.
+        int iSrcXMin =
+            std::max(static_cast<int>(floor(padfX[iDstX] + 1e-10)) -
+                     poWK->nSrcXOff, 0);
+        int iSrcXMax =
+            std::min(static_cast<int>(ceil(padfX2[iDstX] - 1e-10)) -
+                     poWK->nSrcXOff, nSrcXSize);
+        int iSrcYMin =
+            std::max(static_cast<int>(floor(padfY[iDstX] + 1e-10)) -
+                     poWK->nSrcYOff, 0);
+        int iSrcYMax =
+            std::min(static_cast<int>(ceil(padfY2[iDstX] - 1e-10)) -
+                     poWK->nSrcYOff, nSrcYSize);
+
+        // The transformation might not have preserved ordering of
+        // coordinates so do the necessary swapping (#5433).
+        // NOTE: this is really an approximative fix. To do something
+        // more precise we would for example need to compute the
+        // transformation of coordinates in the
+        // [iDstX,iDstY]x[iDstX+1,iDstY+1] square back to source
+        // coordinates, and take the bounding box of the got source
+        // coordinates.
+        if( iSrcXMax < iSrcXMin )
+        {
+            iSrcXMin = std::max(
+                 static_cast<int>(floor((padfX2[iDstX] + 1.0e-10))) -
+                 poWK->nSrcXOff,
+                 0);
+            iSrcXMax = std::min(
+                 static_cast<int>(ceil((padfX[iDstX] - 1.0e-10))) -
+                 poWK->nSrcXOff,
+                 nSrcXSize);
+        }
+        if( iSrcYMax < iSrcYMin )
+        {
+            iSrcYMin = std::max(
+                static_cast<int>(floor((padfY2[iDstX] + 1e-10))) -
+                poWK->nSrcYOff,
+                0);
+            iSrcYMax = std::min(
+                static_cast<int>(ceil((padfY[iDstX] - 1e-10))) -
+                poWK->nSrcYOff,
+                nSrcYSize);
+        }
+        if( iSrcXMin == iSrcXMax && iSrcXMax < nSrcXSize )
+            iSrcXMax++;
+        if( iSrcYMin == iSrcYMax && iSrcYMax < nSrcYSize )
+            iSrcYMax++;
+
+        oWindow.iXMin = iSrcXMin;
+        oWindow.iXMax = iSrcXMax;
+        oWindow.iYMin = iSrcYMin;
+        oWindow.iYMax = iSrcYMax;
+
+        if( iSrcXMin < iSrcXMax )
+        {
+            oState.iLineXMin = std::min(oState.iLineXMin, iSrcXMin);
+            oState.iLineXMax = std::max(oState.iLineXMax, iSrcXMax);
+        }
+        if( bFirst )
+        {
+            iLineYMin = iSrcYMin;
+            iLineYMax = iSrcYMax;
+            bFirst = false;
+        }
+        else if( iSrcYMin != iLineYMin || iSrcYMax != iLineYMax )
+        {
+            oState.bSameSrcLines = false;
+        }
+    }
+}
+
+/************************************************************************/
+/*                     GWKAOMAccumulateColumns()                        */
+/************************************************************************/
+
+// Accumulate per source column the sum, minimum or maximum of the valid
+// pixels of the source lines shared by all the windows of the destination
+// line. Each source pixel is thus read only once per destination line, and
+// the reduction of the destination pixels only has to go through the
+// columns of their window.
+template<class T>
+void GWKAOMAccumulateColumns( GWKAOMState& oState,
+                              const GWKAOMSource<T>& oSrc,
+                              int iSrcYMin, int iSrcYMax )
+{
+    const int nSrcXSize = oState.poWK->nSrcXSize;
+    const int iXMin = oState.iLineXMin;
+    const int nXCount = oState.iLineXMax - iXMin;
+    double* padfColumn = &oState.adfColumnValue[0] + iXMin;
+    int* panCount = &oState.anColumnCount[0] + iXMin;
+
+    double dfInit = 0.0;
+    if( oState.nAlgo == GWKAOM_Max )
+        dfInit = std::numeric_limits<double>::lowest();
+    else if( oState.nAlgo == GWKAOM_Min )
+        dfInit = std::numeric_limits<double>::max();
+    std::fill(padfColumn, padfColumn + nXCount, dfInit);
+    std::fill(panCount, panCount + nXCount, 0);
+
+    const bool bHasMask = oSrc.HasMask();
+    for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
+    {
+        const int iLineOffset = iSrcY * nSrcXSize + iXMin;
+        if( !bHasMask && oSrc.nStride == 1 )
+        {
+            // Branchless loops over a contiguous source line, that can be
+            // vectorized by the compiler.
+            const T* pSrc = oSrc.pSrc + iLineOffset;
+            if( oState.nAlgo == GWKAOM_Max )
+            {
+                for( int i = 0; i < nXCount; i++ )
+                {
+                    const double dfVal = static_cast<double>(pSrc[i]);
+                    padfColumn[i] = padfColumn[i] < dfVal ? dfVal
+                                                          : padfColumn[i];
+                }
+            }
+            else if( oState.nAlgo == GWKAOM_Min )
+            {
+                for( int i = 0; i < nXCount; i++ )
+                {
+                    const double dfVal = static_cast<double>(pSrc[i]);
+                    padfColumn[i] = padfColumn[i] > dfVal ? dfVal
+                                                          : padfColumn[i];
+                }
+            }
+            else
+            {
+                for( int i = 0; i < nXCount; i++ )
+                    padfColumn[i] += static_cast<double>(pSrc[i]);
+            }
+            continue;
+        }
+
+        for( int i = 0; i < nXCount; i++ )
+        {
+            if( !oSrc.IsValid(iLineOffset + i) )
+                continue;
+            const double dfVal = oSrc.GetValue(iLineOffset + i);
+            panCount[i]++;
+            if( oState.nAlgo == GWKAOM_Max )
+            {
+                if( padfColumn[i] < dfVal )
+                    padfColumn[i] = dfVal;
+            }
+            else if( oState.nAlgo == GWKAOM_Min )
+            {
+                if( padfColumn[i] > dfVal )
+                    padfColumn[i] = dfVal;
+            }
+            else
+            {
+                padfColumn[i] += dfVal;
+            }
+        }
+    }
+
+    if( !bHasMask && oSrc.nStride == 1 )
+        std::fill(panCount, panCount + nXCount, iSrcYMax - iSrcYMin);
+}
+
+/************************************************************************/
+/*                        GWKAverageOrModeLine()                        */
+/************************************************************************/
+
+// Compute the value of a band for all the destination pixels of a line.
+template<class T>
+void GWKAverageOrModeLine( GWKAOMState& oState, int iBand, int nStride )
+{
+    const GDALWarpKernel *poWK = oState.poWK;
+    const int nDstXSize = poWK->nDstXSize;
+    const int nSrcXSize = poWK->nSrcXSize;
+    const int nAlgo = oState.nAlgo;
+    const GWKAOMSource<T> oSrc(poWK, iBand, nStride);
+
+    // Sums of integer values are exact whatever the summation order, so
+    // that per column accumulation gives the same results as the per
+    // window one.
+    const bool bUseColumns =
+        oState.bSameSrcLines &&
+        oState.iLineXMin < oState.iLineXMax &&
+        (nAlgo == GWKAOM_Max || nAlgo == GWKAOM_Min ||
+         ((nAlgo == GWKAOM_Sum || nAlgo == GWKAOM_Average) &&
+          std::numeric_limits<T>::is_integer));
+    if( bUseColumns )
+    {
+        for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
+        {
+            if( oState.aoWindows[iDstX].bValid )
+            {
+                GWKAOMAccumulateColumns(oState, oSrc,
+                                        oState.aoWindows[iDstX].iYMin,
+                                        oState.aoWindows[iDstX].iYMax);
+                break;
+            }
+        }
+    }
+
+    for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
+    {
+        oState.abyDstFound[iDstX] = FALSE;
+        const GWKAOMWindow& oWindow = oState.aoWindows[iDstX];
+        if( !oWindow.bValid )
+            continue;
+
+        const int iSrcXMin = oWindow.iXMin;
+        const int iSrcXMax = oWindow.iXMax;
+        const int iSrcYMin = oWindow.iYMin;
+        const int iSrcYMax = oWindow.iYMax;
+
+        double dfValueReal = 0.0;
+        // Count of pixels used to compute the value.
+        int nCount = 0;
+
+        if( bUseColumns )
+        {
+            const double* padfColumn = &oState.adfColumnValue[0];
+            const int* panCount = &oState.anColumnCount[0];
+            if( nAlgo == GWKAOM_Max )
+            {
+                double dfTotal = std::numeric_limits<double>::lowest();
+                for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
+                {
+                    nCount += panCount[iSrcX];
+                    if( dfTotal < padfColumn[iSrcX] )
+                        dfTotal = padfColumn[iSrcX];
+                }
+                dfValueReal = dfTotal;
+            }
+            else if( nAlgo == GWKAOM_Min )
+            {
+                double dfTotal = std::numeric_limits<double>::max();
+                for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
+                {
+                    nCount += panCount[iSrcX];
+                    if( dfTotal > padfColumn[iSrcX] )
+                        dfTotal = padfColumn[iSrcX];
+                }
+                dfValueReal = dfTotal;
+            }
+            else
+            {
+                double dfTotal = 0.0;
+                for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
+                {
+                    nCount += panCount[iSrcX];
+                    dfTotal += padfColumn[iSrcX];
+                }
+                dfValueReal = nAlgo == GWKAOM_Average && nCount > 0 ?
+                                            dfTotal / nCount : dfTotal;
+            }
+        }
+        else if( nAlgo == GWKAOM_Average || nAlgo == GWKAOM_Sum )
+        {
+            // This code adapted from GDALDownsampleChunk32R_AverageT()
+            // in gcore/overview.cpp.
+            double dfTotal = 0.0;
+            for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
+            {
+                for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
+                {
+                    const int iSrcOffset = iSrcX + iSrcY * nSrcXSize;
+                    if( oSrc.IsValid(iSrcOffset) )
+                    {
+                        nCount++;
+                        dfTotal += oSrc.GetValue(iSrcOffset);
+                    }
+                }
+            }
+            dfValueReal = nAlgo == GWKAOM_Average && nCount > 0 ?
+                                            dfTotal / nCount : dfTotal;
+        }
+        else if( nAlgo == GWKAOM_Max || nAlgo == GWKAOM_Min )
+        {
+            double dfTotal = nAlgo == GWKAOM_Max ?
+                std::numeric_limits<double>::lowest() :
+                std::numeric_limits<double>::max();
+            for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
+            {
+                for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
+                {
+                    const int iSrcOffset = iSrcX + iSrcY * nSrcXSize;
+                    if( !oSrc.IsValid(iSrcOffset) )
+                        continue;
+                    nCount++;
+                    const double dfVal = oSrc.GetValue(iSrcOffset);
+                    if( nAlgo == GWKAOM_Max ? dfTotal < dfVal
+                                            : dfTotal > dfVal )
+                    {
+                        dfTotal = dfVal;
+                    }
+                }
+            }
+            dfValueReal = dfTotal;
+        }
+        else if( nAlgo == GWKAOM_Quant )
+        {
+            std::vector<double>& adfValues = oState.adfValues;
+            adfValues.clear();
+            for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
+            {
+                for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
+                {
+                    const int iSrcOffset = iSrcX + iSrcY * nSrcXSize;
+                    if( oSrc.IsValid(iSrcOffset) )
+                        adfValues.push_back(oSrc.GetValue(iSrcOffset));
+                }
+            }
+            nCount = static_cast<int>(adfValues.size());
+
+            if( nCount > 0 )
+            {
+                // Only the quantile needs to be at its sorted position.
+                const int quantIdx = static_cast<int>(
+                    std::ceil(oState.quant * adfValues.size() - 1));
+                std::nth_element(adfValues.begin(),
+                                 adfValues.begin() + quantIdx,
+                                 adfValues.end());
+                dfValueReal = adfValues[quantIdx];
+            }
+        }
+        else if( nAlgo == GWKAOM_Fmode )
+        {
+            // This code adapted from GDALDownsampleChunk32R_Mode() in
+            // gcore/overview.cpp.
+            // Does it make sense it makes to run a
+            // majority filter on floating point data? But, here it
+            // is for the sake of compatibility. It won't look
+            // right on RGB images by the nature of the filter.
+            float* pafVals = oState.pafVals;
+            int* panSums = oState.panSums;
+            int iMaxInd = 0;
+            int iMaxVal = -1;
+            int i = 0;
+
+            for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
+            {
+                for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
+                {
+                    const int iSrcOffset = iSrcX + iSrcY * nSrcXSize;
+                    if( !oSrc.IsValid(iSrcOffset) )
+                        continue;
+
+                    const float fVal =
+                        static_cast<float>(oSrc.GetValue(iSrcOffset));
+
+                    // Check array for existing entry.
+                    for( i = 0; i < iMaxInd; ++i )
+                        if( pafVals[i] == fVal
+                            && ++panSums[i] > panSums[iMaxVal] )
+                        {
+                            iMaxVal = i;
+                            break;
+                        }
+
+                    // Add to arr if entry not already there.
+                    if( i == iMaxInd )
+                    {
+                        pafVals[iMaxInd] = fVal;
+                        panSums[iMaxInd] = 1;
+
+                        if( iMaxVal < 0 )
+                            iMaxVal = iMaxInd;
+
+                        ++iMaxInd;
+                    }
+                }
+            }
+
+            if( iMaxVal != -1 )
+            {
+                nCount = 1;
+                dfValueReal = pafVals[iMaxVal];
+            }
+        }
+        else if( nAlgo == GWKAOM_Imode )
+        {
+            // Byte, UInt16 or Int16.
+            int* panVals = oState.panVals;
+            const int nBinsOffset = oState.nBinsOffset;
+            int nMaxVal = 0;
+            int iMaxInd = -1;
+
+            memset(panVals, 0, oState.nBins * sizeof(int));
+
+            for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
+            {
+                for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
+                {
+                    const int iSrcOffset = iSrcX + iSrcY * nSrcXSize;
+                    if( !oSrc.IsValid(iSrcOffset) )
+                        continue;
+
+                    const int nVal =
+                        static_cast<int>(oSrc.GetValue(iSrcOffset));
+                    if( ++panVals[nVal+nBinsOffset] > nMaxVal )
+                    {
+                        // Sum the density.
+                        // Is it the most common value so far?
+                        iMaxInd = nVal;
+                        nMaxVal = panVals[nVal+nBinsOffset];
+                    }
+                }
+            }
+
+            if( iMaxInd != -1 )
+            {
+                nCount = 1;
+                dfValueReal = iMaxInd;
+            }
+        }
+
+        if( nCount > 0 )
+        {
+            oState.adfDstValue[iDstX] = dfValueReal;
+            oState.abyDstFound[iDstX] = TRUE;
+        }
+    }
+}
+
+} // namespace
+
 // Overall logic based on GWKGeneralCaseThread().
 static void GWKAverageOrModeThread( void* pData)
 {
@@ -5705,23 +6571,16 @@ static void GWKAverageOrModeThread( void* pData)
 /* -------------------------------------------------------------------- */
 /*      Find out which algorithm to use (small optim.)                  */
 /* -------------------------------------------------------------------- */
-    int nAlgo = 0;
-
-    // These vars only used with nAlgo == 3.
-    int *panVals = nullptr;
-    int nBins = 0;
-    int nBinsOffset = 0;
-
-    // Only used with nAlgo = 2.
-    float* pafVals = nullptr;
-    int* panSums = nullptr;
-
-    // Only used with nAlgo = 6.
-    float quant = 0.5;
+    GWKAOMState oState;
+    oState.poWK = poWK;
 
     if( poWK->eResample == GRA_Average )
     {
-        nAlgo = GWKAOM_Average;
+        oState.nAlgo = GWKAOM_Average;
+    }
+    else if( poWK->eResample == GRA_Sum )
+    {
+        oState.nAlgo = GWKAOM_Sum;
     }
     else if( poWK->eResample == GRA_Mode )
     {
@@ -5730,44 +6589,44 @@ static void GWKAverageOrModeThread( void* pData)
             poWK->eWorkingDataType == GDT_UInt16 ||
             poWK->eWorkingDataType == GDT_Int16 )
         {
-            nAlgo = GWKAOM_Imode;
+            oState.nAlgo = GWKAOM_Imode;
 
             // In the case of a paletted or non-paletted byte band,
             // Input values are between 0 and 255.
             if( poWK->eWorkingDataType == GDT_Byte )
             {
-                nBins = 256;
+                oState.nBins = 256;
             }
             // In the case of Int16, input values are between -32768 and 32767.
             else if( poWK->eWorkingDataType == GDT_Int16 )
             {
-                nBins = 65536;
-                nBinsOffset = 32768;
+                oState.nBins = 65536;
+                oState.nBinsOffset = 32768;
             }
             // In the case of UInt16, input values are between 0 and 65537.
             else if( poWK->eWorkingDataType == GDT_UInt16 )
             {
-                nBins = 65536;
+                oState.nBins = 65536;
             }
-            panVals =
-                static_cast<int *>(VSI_MALLOC_VERBOSE(nBins * sizeof(int)));
-            if( panVals == nullptr )
+            oState.panVals = static_cast<int *>(
+                VSI_MALLOC_VERBOSE(oState.nBins * sizeof(int)));
+            if( oState.panVals == nullptr )
                 return;
         }
         else
         {
-            nAlgo = GWKAOM_Fmode;
+            oState.nAlgo = GWKAOM_Fmode;
 
             if( nSrcXSize > 0 && nSrcYSize > 0 )
             {
-                pafVals = static_cast<float *>(
+                oState.pafVals = static_cast<float *>(
                     VSI_MALLOC3_VERBOSE(nSrcXSize, nSrcYSize, sizeof(float)));
-                panSums = static_cast<int *>(
+                oState.panSums = static_cast<int *>(
                     VSI_MALLOC3_VERBOSE(nSrcXSize, nSrcYSize, sizeof(int)));
-                if( pafVals == nullptr || panSums == nullptr )
+                if( oState.pafVals == nullptr || oState.panSums == nullptr )
                 {
-                    VSIFree(pafVals);
-                    VSIFree(panSums);
+                    VSIFree(oState.pafVals);
+                    VSIFree(oState.panSums);
                     return;
                 }
             }
@@ -5775,26 +6634,26 @@ static void GWKAverageOrModeThread( void* pData)
     }
     else if( poWK->eResample == GRA_Max )
     {
-        nAlgo = GWKAOM_Max;
+        oState.nAlgo = GWKAOM_Max;
     }
     else if( poWK->eResample == GRA_Min )
     {
-        nAlgo = GWKAOM_Min;
+        oState.nAlgo = GWKAOM_Min;
     }
     else if( poWK->eResample == GRA_Med )
     {
-        nAlgo = GWKAOM_Quant;
-        quant = 0.5;
+        oState.nAlgo = GWKAOM_Quant;
+        oState.quant = 0.5;
     }
     else if( poWK->eResample == GRA_Q1 )
     {
-        nAlgo = GWKAOM_Quant;
-        quant = 0.25;
+        oState.nAlgo = GWKAOM_Quant;
+        oState.quant = 0.25;
     }
     else if( poWK->eResample == GRA_Q3 )
     {
-        nAlgo = GWKAOM_Quant;
-        quant = 0.75;
+        oState.nAlgo = GWKAOM_Quant;
+        oState.quant = 0.75;
     }
     else
     {
@@ -5806,7 +6665,27 @@ static void GWKAverageOrModeThread( void* pData)
     }
 
     CPLDebug("GDAL",
-             "GDALWarpKernel():GWKAverageOrModeThread() using algo %d", nAlgo);
+             "GDALWarpKernel():GWKAverageOrModeThread() using algo %d",
+             oState.nAlgo);
+
+    try
+    {
+        oState.aoWindows.resize(nDstXSize);
+        oState.adfColumnValue.resize(nSrcXSize);
+        oState.anColumnCount.resize(nSrcXSize);
+        oState.adfDstValue.resize(nDstXSize);
+        oState.abyDstFound.resize(nDstXSize);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "GWKAverageOrModeThread(): out of memory");
+        VSIFree(oState.panVals);
+        VSIFree(oState.pafVals);
+        VSIFree(oState.panSums);
+        return;
+    }
+    std::vector<GByte> abyHasFoundDensity(nDstXSize);
 
 /* -------------------------------------------------------------------- */
 /*      Allocate x,y,z coordinate arrays for transformation ... two     */
@@ -5882,411 +6761,102 @@ static void GWKAverageOrModeThread( void* pData)
                                       iDstY + 1.0 + poWK->nDstYOff);
         }
 
-/* ==================================================================== */
-/*      Loop over pixels in output scanline.                            */
-/* ==================================================================== */
-        for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
-        {
-            int iSrcOffset = 0;
-            double dfDensity = 1.0;
-            bool bHasFoundDensity = false;
-
-            if( !pabSuccess[iDstX] || !pabSuccess2[iDstX] )
-                continue;
-            const int iDstOffset = iDstX + iDstY * nDstXSize;
+/* -------------------------------------------------------------------- */
+/*      Compute the source window of each pixel of the line once for    */
+/*      all bands.                                                      */
+/* -------------------------------------------------------------------- */
+        GWKAOMComputeWindows(oState, padfX, padfY, pabSuccess,
+                             padfX2, padfY2, pabSuccess2);
+        std::fill(abyHasFoundDensity.begin(), abyHasFoundDensity.end(),
+                  static_cast<GByte>(FALSE));
 
 /* ==================================================================== */
 /*      Loop processing each band.                                      */
 /* ==================================================================== */
-
-            for( int iBand = 0; iBand < poWK->nBands; iBand++ )
+        for( int iBand = 0; iBand < poWK->nBands; iBand++ )
+        {
+            switch( poWK->eWorkingDataType )
             {
-                double dfBandDensity = 0.0;
-                double dfValueReal = 0.0;
-                double dfValueRealTmp = 0.0;
-                double dfValueImagTmp = 0.0;
-
-/* -------------------------------------------------------------------- */
-/*      Collect the source value.                                       */
-/* -------------------------------------------------------------------- */
-
-                double dfTotal = 0.0;
-                // Count of pixels used to compute average/mode.
-                int nCount = 0;
-                // Count of all pixels sampled, including nodata.
-                int nCount2 = 0;
-
-                // Compute corners in source crs.
-                int iSrcXMin =
-                    std::max(static_cast<int>(floor(padfX[iDstX] + 1e-10)) -
-                             poWK->nSrcXOff, 0);
-                int iSrcXMax =
-                    std::min(static_cast<int>(ceil(padfX2[iDstX] - 1e-10)) -
-                             poWK->nSrcXOff, nSrcXSize);
-                int iSrcYMin =
-                    std::max(static_cast<int>(floor(padfY[iDstX] + 1e-10)) -
-                             poWK->nSrcYOff, 0);
-                int iSrcYMax =
-                    std::min(static_cast<int>(ceil(padfY2[iDstX] - 1e-10)) -
-                             poWK->nSrcYOff, nSrcYSize);
-
-                // The transformation might not have preserved ordering of
-                // coordinates so do the necessary swapping (#5433).
-                // NOTE: this is really an approximative fix. To do something
-                // more precise we would for example need to compute the
-                // transformation of coordinates in the
-                // [iDstX,iDstY]x[iDstX+1,iDstY+1] square back to source
-                // coordinates, and take the bounding box of the got source
-                // coordinates.
-                if( iSrcXMax < iSrcXMin )
-                {
-                    iSrcXMin = std::max(
-                         static_cast<int>(floor((padfX2[iDstX] + 1.0e-10))) -
-                         poWK->nSrcXOff,
-                         0);
-                    iSrcXMax = std::min(
-                         static_cast<int>(ceil((padfX[iDstX] - 1.0e-10))) -
-                         poWK->nSrcXOff,
-                         nSrcXSize);
-                }
-                if( iSrcYMax < iSrcYMin )
-                {
-                    iSrcYMin = std::max(
-                        static_cast<int>(floor((padfY2[iDstX] + 1e-10))) -
-                        poWK->nSrcYOff,
-                        0);
-                    iSrcYMax = std::min(
-                        static_cast<int>(ceil((padfY[iDstX] - 1e-10))) -
-                        poWK->nSrcYOff,
-                        nSrcYSize);
-                }
-                if( iSrcXMin == iSrcXMax && iSrcXMax < nSrcXSize )
-                    iSrcXMax++;
-                if( iSrcYMin == iSrcYMax && iSrcYMax < nSrcYSize )
-                    iSrcYMax++;
-
-                // Loop over source lines and pixels - 3 possible algorithms.
-
-                // poWK->eResample == GRA_Average.
-                if( nAlgo == GWKAOM_Average )
-                {
-                    // This code adapted from GDALDownsampleChunk32R_AverageT()
-                    // in gcore/overview.cpp.
-                    for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
-                    {
-                        for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
-                        {
-                            iSrcOffset = iSrcX + iSrcY * nSrcXSize;
-
-                            if( poWK->panUnifiedSrcValid != nullptr
-                                && !(poWK->panUnifiedSrcValid[iSrcOffset>>5]
-                                     & (0x01 << (iSrcOffset & 0x1f))) )
-                            {
-                                continue;
-                            }
-
-                            nCount2++;
-                            if( GWKGetPixelValue(
-                                    poWK, iBand, iSrcOffset,
-                                    &dfBandDensity, &dfValueRealTmp,
-                                    &dfValueImagTmp ) &&
-                                dfBandDensity > BAND_DENSITY_THRESHOLD )
-                            {
-                                nCount++;
-                                dfTotal += dfValueRealTmp;
-                            }
-                        }
-                    }
-
-                    if( nCount > 0 )
-                    {
-                        dfValueReal = dfTotal / nCount;
-                        dfBandDensity = 1;
-                        bHasFoundDensity = true;
-                    }
-                }  // GRA_Average.
-                else if( nAlgo == GWKAOM_Imode || nAlgo == GWKAOM_Fmode )
-                // poWK->eResample == GRA_Mode
-                {
-                    // This code adapted from GDALDownsampleChunk32R_Mode() in
-                    // gcore/overview.cpp.
-                    if( nAlgo == GWKAOM_Fmode ) // int32 or float.
-                    {
-                        // Does it make sense it makes to run a
-                        // majority filter on floating point data? But, here it
-                        // is for the sake of compatibility. It won't look
-                        // right on RGB images by the nature of the filter.
-                        int iMaxInd = 0;
-                        int iMaxVal = -1;
-                        int i = 0;
-
-                        for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
-                        {
-                            for( int iSrcX = iSrcXMin;
-                                 iSrcX < iSrcXMax;
-                                 iSrcX++ )
-                            {
-                                iSrcOffset = iSrcX + iSrcY * nSrcXSize;
-
-                                if( poWK->panUnifiedSrcValid != nullptr
-                                    && !(poWK->panUnifiedSrcValid[iSrcOffset>>5]
-                                         & (0x01 << (iSrcOffset & 0x1f))) )
-                                    continue;
-
-                                nCount2++;
-                                if( GWKGetPixelValue(
-                                        poWK, iBand, iSrcOffset,
-                                        &dfBandDensity, &dfValueRealTmp,
-                                        &dfValueImagTmp ) &&
-                                    dfBandDensity > BAND_DENSITY_THRESHOLD )
-                                {
-                                    nCount++;
-
-                                    const float fVal =
-                                        static_cast<float>(dfValueRealTmp);
-
-                                    // Check array for existing entry.
-                                    for( i = 0; i < iMaxInd; ++i )
-                                        if( pafVals[i] == fVal
-                                            && ++panSums[i] > panSums[iMaxVal] )
-                                        {
-                                            iMaxVal = i;
-                                            break;
-                                        }
-
-                                    // Add to arr if entry not already there.
-                                    if( i == iMaxInd )
-                                    {
-                                        pafVals[iMaxInd] = fVal;
-                                        panSums[iMaxInd] = 1;
-
-                                        if( iMaxVal < 0 )
-                                            iMaxVal = iMaxInd;
-
-                                        ++iMaxInd;
-                                    }
-                                }
-                            }
-                        }
-
-                        if( iMaxVal != -1 )
-                        {
-                            dfValueReal = pafVals[iMaxVal];
-                            dfBandDensity = 1;
-                            bHasFoundDensity = true;
-                        }
-                    }
-                    else // byte or int16.
-                    {
-                        int nMaxVal = 0;
-                        int iMaxInd = -1;
-
-                        memset(panVals, 0, nBins*sizeof(int));
-
-                        for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
-                        {
-                            for( int iSrcX = iSrcXMin;
-                                 iSrcX < iSrcXMax;
-                                 iSrcX++ )
-                            {
-                                iSrcOffset = iSrcX + iSrcY * nSrcXSize;
-
-                                if( poWK->panUnifiedSrcValid != nullptr
-                                    && !(poWK->panUnifiedSrcValid[iSrcOffset>>5]
-                                         & (0x01 << (iSrcOffset & 0x1f))) )
-                                    continue;
-
-                                nCount2++;
-                                if( GWKGetPixelValue(
-                                        poWK, iBand, iSrcOffset,
-                                        &dfBandDensity, &dfValueRealTmp,
-                                        &dfValueImagTmp ) &&
-                                    dfBandDensity > BAND_DENSITY_THRESHOLD )
-                                {
-                                    nCount++;
-
-                                    const int nVal =
-                                        static_cast<int>(dfValueRealTmp);
-                                    if( ++panVals[nVal+nBinsOffset] > nMaxVal )
-                                    {
-                                        // Sum the density.
-                                        // Is it the most common value so far?
-                                        iMaxInd = nVal;
-                                        nMaxVal = panVals[nVal+nBinsOffset];
-                                    }
-                                }
-                            }
-                        }
-
-                        if( iMaxInd != -1 )
-                        {
-                            dfValueReal = iMaxInd;
-                            dfBandDensity = 1;
-                            bHasFoundDensity = true;
-                        }
-                    }
-                }  // GRA_Mode.
-                else if( nAlgo == GWKAOM_Max )
-                // poWK->eResample == GRA_Max.
-                {
-                    dfTotal = std::numeric_limits<double>::lowest();
-                    // This code adapted from nAlgo 1 method, GRA_Average.
-                    for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
-                    {
-                        for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
-                        {
-                            iSrcOffset = iSrcX + iSrcY * nSrcXSize;
-
-                            if( poWK->panUnifiedSrcValid != nullptr
-                                && !(poWK->panUnifiedSrcValid[iSrcOffset>>5]
-                                     & (0x01 << (iSrcOffset & 0x1f))) )
-                            {
-                                continue;
-                            }
-
-                            // Returns pixel value if it is not no data.
-                            if( GWKGetPixelValue(
-                                    poWK, iBand, iSrcOffset,
-                                    &dfBandDensity, &dfValueRealTmp,
-                                    &dfValueImagTmp ) &&
-                                dfBandDensity > BAND_DENSITY_THRESHOLD )
-                            {
-                                nCount++;
-                                if( dfTotal < dfValueRealTmp )
-                                {
-                                    dfTotal = dfValueRealTmp;
-                                }
-                            }
-                        }
-                    }
-
-                    if( nCount > 0 )
-                    {
-                        dfValueReal = dfTotal;
-                        dfBandDensity = 1;
-                        bHasFoundDensity = true;
-                    }
-                }  // GRA_Max.
-                else if( nAlgo == GWKAOM_Min )
-                // poWK->eResample == GRA_Min.
-                {
-                    dfTotal = std::numeric_limits<double>::max();
-                    // This code adapted from nAlgo 1 method, GRA_Average.
-                    for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
-                    {
-                        for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
-                        {
-                            iSrcOffset = iSrcX + iSrcY * nSrcXSize;
-
-                            if( poWK->panUnifiedSrcValid != nullptr
-                                && !(poWK->panUnifiedSrcValid[iSrcOffset>>5]
-                                     & (0x01 << (iSrcOffset & 0x1f))) )
-                            {
-                                continue;
-                            }
-
-                            // Returns pixel value if it is not no data.
-                            if( GWKGetPixelValue(
-                                    poWK, iBand, iSrcOffset,
-                                    &dfBandDensity, &dfValueRealTmp,
-                                    &dfValueImagTmp ) &&
-                                dfBandDensity > BAND_DENSITY_THRESHOLD )
-                            {
-                                nCount++;
-                                if( dfTotal > dfValueRealTmp )
-                                {
-                                    dfTotal = dfValueRealTmp;
-                                }
-                            }
-                        }
-                    }
-
-                    if( nCount > 0 )
-                    {
-                        dfValueReal = dfTotal;
-                        dfBandDensity = 1;
-                        bHasFoundDensity = true;
-                    }
-                }  // GRA_Min.
-                else if( nAlgo == GWKAOM_Quant )
-                // poWK->eResample == GRA_Med | GRA_Q1 | GRA_Q3.
-                {
-                    std::vector<double> dfValuesTmp;
-
-                    // This code adapted from nAlgo 1 method, GRA_Average.
-                    for( int iSrcY = iSrcYMin; iSrcY < iSrcYMax; iSrcY++ )
-                    {
-                        for( int iSrcX = iSrcXMin; iSrcX < iSrcXMax; iSrcX++ )
-                        {
-                            iSrcOffset = iSrcX + iSrcY * nSrcXSize;
-
-                            if( poWK->panUnifiedSrcValid != nullptr
-                                && !(poWK->panUnifiedSrcValid[iSrcOffset>>5]
-                                     & (0x01 << (iSrcOffset & 0x1f))) )
-                            {
-                                continue;
-                            }
-
-                            // Returns pixel value if it is not no data.
-                            if( GWKGetPixelValue(
-                                    poWK, iBand, iSrcOffset,
-                                    &dfBandDensity, &dfValueRealTmp,
-                                    &dfValueImagTmp ) &&
-                                dfBandDensity > BAND_DENSITY_THRESHOLD )
-                            {
-                                nCount++;
-                                dfValuesTmp.push_back(dfValueRealTmp);
-                            }
-                        }
-                    }
-
-                    if( nCount > 0 )
-                    {
-                        std::sort(dfValuesTmp.begin(), dfValuesTmp.end());
-                        int quantIdx = static_cast<int>(
-                            std::ceil(quant * dfValuesTmp.size() - 1));
-                        dfValueReal = dfValuesTmp[quantIdx];
-
-                        dfBandDensity = 1;
-                        bHasFoundDensity = true;
-                        dfValuesTmp.clear();
-                    }
-                }  // Quantile.
+                case GDT_Byte:
+                    GWKAverageOrModeLine<GByte>(oState, iBand, 1);
+                    break;
+                case GDT_Int16:
+                    GWKAverageOrModeLine<GInt16>(oState, iBand, 1);
+                    break;
+                case GDT_UInt16:
+                    GWKAverageOrModeLine<GUInt16>(oState, iBand, 1);
+                    break;
+                case GDT_Int32:
+                    GWKAverageOrModeLine<GInt32>(oState, iBand, 1);
+                    break;
+                case GDT_UInt32:
+                    GWKAverageOrModeLine<GUInt32>(oState, iBand, 1);
+                    break;
+                case GDT_Float32:
+                    GWKAverageOrModeLine<float>(oState, iBand, 1);
+                    break;
+                case GDT_Float64:
+                    GWKAverageOrModeLine<double>(oState, iBand, 1);
+                    break;
+                case GDT_CInt16:
+                    GWKAverageOrModeLine<GInt16>(oState, iBand, 2);
+                    break;
+                case GDT_CInt32:
+                    GWKAverageOrModeLine<GInt32>(oState, iBand, 2);
+                    break;
+                case GDT_CFloat32:
+                    GWKAverageOrModeLine<float>(oState, iBand, 2);
+                    break;
+                case GDT_CFloat64:
+                    GWKAverageOrModeLine<double>(oState, iBand, 2);
+                    break;
+                default:
+                    std::fill(oState.abyDstFound.begin(),
+                              oState.abyDstFound.end(),
+                              static_cast<GByte>(FALSE));
+                    break;
+            }
 
 /* -------------------------------------------------------------------- */
 /*      We have a computed value from the source.  Now apply it to      */
 /*      the destination pixel.                                          */
 /* -------------------------------------------------------------------- */
-                if( bHasFoundDensity )
-                {
-                    // TODO: Should we compute dfBandDensity in fct of
-                    // nCount/nCount2, or use as a threshold to set the dest
-                    // value?
-                    // dfBandDensity = (float) nCount / nCount2;
-                    // if( (float) nCount / nCount2 > 0.1 )
-                    // or fix gdalwarp crop_to_cutline to crop partially
-                    // overlapping pixels.
-                    double dfValueImag = 0.0;
-                    GWKSetPixelValue( poWK, iBand, iDstOffset,
-                                      dfBandDensity,
-                                      dfValueReal, dfValueImag );
-                }
-            }
+            for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
+            {
+                if( !oState.abyDstFound[iDstX] )
+                    continue;
 
-            if( !bHasFoundDensity )
-                continue;
+                // TODO: Should we compute dfBandDensity in fct of
+                // nCount/nCount2, or use as a threshold to set the dest
+                // value?
+                // dfBandDensity = (float) nCount / nCount2;
+                // if( (float) nCount / nCount2 > 0.1 )
+                // or fix gdalwarp crop_to_cutline to crop partially
+                // overlapping pixels.
+                const int iDstOffset = iDstX + iDstY * nDstXSize;
+                GWKSetPixelValue( poWK, iBand, iDstOffset,
+                                  1.0, oState.adfDstValue[iDstX], 0.0 );
+                abyHasFoundDensity[iDstX] = TRUE;
+            }
+        }
 
 /* -------------------------------------------------------------------- */
 /*      Update destination density/validity masks.                      */
 /* -------------------------------------------------------------------- */
-            GWKOverlayDensity( poWK, iDstOffset, dfDensity );
+        for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
+        {
+            if( !abyHasFoundDensity[iDstX] )
+                continue;
+
+            const int iDstOffset = iDstX + iDstY * nDstXSize;
+            GWKOverlayDensity( poWK, iDstOffset, 1.0 );
 
             if( poWK->panDstValid != nullptr )
             {
                 poWK->panDstValid[iDstOffset>>5] |=
                     0x01 << (iDstOffset & 0x1f);
             }
-        } /* Next iDstX */
+        }
 
 /* -------------------------------------------------------------------- */
 /*      Report progress to the user, and optionally cancel out.         */
@@ -6306,7 +6876,7 @@ static void GWKAverageOrModeThread( void* pData)
     CPLFree( padfZ2 );
     CPLFree( pabSuccess );
     CPLFree( pabSuccess2 );
-    VSIFree( panVals );
-    VSIFree(pafVals);
-    VSIFree(panSums);
+    VSIFree( oState.panVals );
+    VSIFree( oState.pafVals );
+    VSIFree( oState.panSums );
 }
@@ -0,0 +1,712 @@
+/******************************************************************************
+ *
+ * Project:  High Performance Image Reprojector
+ * Purpose:  AVX2 specializations of the bilinear and cubic warp kernels
+ * Author:   agent <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+
+CPL_CVSID("$Id$")
+
+#if defined(HAVE_AVX2_AT_COMPILE_TIME) && ( defined(__x86_64) || defined(_M_X64) )
+
+#include <immintrin.h>
+
+#include <limits>
+
+#include "gdalwarper.h"
+
+void GWKResampleNoMasks4SampleRow_AVX2( GDALResampleAlg eResample,
+                                        const GByte* pSrc,
+                                        int nSrcXSize, int nSrcYSize,
+                                        int nSrcXOff, int nSrcYOff,
+                                        int nCount,
+                                        const double* padfX,
+                                        const double* padfY,
+                                        const int* pabSuccess,
+                                        GByte* pDst, GByte* pabyDone );
+void GWKResampleNoMasks4SampleRow_AVX2( GDALResampleAlg eResample,
+                                        const GInt16* pSrc,
+                                        int nSrcXSize, int nSrcYSize,
+                                        int nSrcXOff, int nSrcYOff,
+                                        int nCount,
+                                        const double* padfX,
+                                        const double* padfY,
+                                        const int* pabSuccess,
+                                        GInt16* pDst, GByte* pabyDone );
+void GWKResampleNoMasks4SampleRow_AVX2( GDALResampleAlg eResample,
+                                        const GUInt16* pSrc,
+                                        int nSrcXSize, int nSrcYSize,
+                                        int nSrcXOff, int nSrcYOff,
+                                        int nCount,
+                                        const double* padfX,
+                                        const double* padfY,
+                                        const int* pabSuccess,
+                                        GUInt16* pDst, GByte* pabyDone );
+bool GWKBilinearResample4SampleRow_AVX2( const GDALWarpKernel* poWK,
+                                         int iBand, int nCount,
+                                         const double* padfX,
+                                         const double* padfY,
+                                         const int* pabSuccess,
+                                         double* padfDensity,
+                                         double* padfReal,
+                                         GByte* pabyDone );
+
+// Destination pixels are processed by groups of 8 (4 for the masked case).
+// Only the pixels whose source neighbourhood is fully inside the source
+// window are computed, and flagged in pabyDone[]. The others, as well as
+// the remaining pixels that do not fill a whole group, are left to the
+// scalar code of gdalwarpkernel.cpp.
+// The unmasked kernels accumulate in single precision, which is accurate
+// enough for 8 and 16 bit integer outputs, whereas the masked bilinear
+// kernel works in double precision to give the same results as the scalar
+// code.
+
+namespace {
+
+constexpr float SRC_DENSITY_THRESHOLD = 0.000000001f;
+
+/************************************************************************/
+/*                          GWKCombine128()                             */
+/************************************************************************/
+
+inline __m256i GWKCombine128( __m128i lo, __m128i hi )
+{
+    return _mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+inline __m256 GWKCombine128( __m128 lo, __m128 hi )
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+/************************************************************************/
+/*                        GWKClampOffsetsAVX2()                         */
+/*                                                                      */
+/*      Replace the offsets of the lanes that are not set in nMask.     */
+/************************************************************************/
+
+// The gathers load all lanes, so rejected lanes must be given an offset
+// whose loads stay within the source buffer. nSafeOffset is the smallest
+// offset an accepted lane can have, so its loads are within the buffer as
+// soon as one lane is accepted.
+inline __m256i GWKClampOffsetsAVX2( __m256i off, int nMask, int nSafeOffset )
+{
+    const __m256i bit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i bKeep = _mm256_cmpeq_epi32(
+        _mm256_and_si256(_mm256_set1_epi32(nMask), bit), bit);
+    return _mm256_blendv_epi8(_mm256_set1_epi32(nSafeOffset), off, bKeep);
+}
+
+inline __m128i GWKClampOffsetsAVX2( __m128i off, int nMask, int nSafeOffset )
+{
+    const __m128i bit = _mm_setr_epi32(1, 2, 4, 8);
+    const __m128i bKeep = _mm_cmpeq_epi32(
+        _mm_and_si128(_mm_set1_epi32(nMask), bit), bit);
+    return _mm_blendv_epi8(_mm_set1_epi32(nSafeOffset), off, bKeep);
+}
+
+/************************************************************************/
+/*                       GWKLoadPairAVX2()                              */
+/*                                                                      */
+/*      Load the 2 consecutive source values at each of the 8 offsets.  */
+/************************************************************************/
+
+// The Byte version reads 4 bytes at each offset, which the caller must
+// guarantee to be within the source buffer.
+inline void GWKLoadPairAVX2( const GByte* pSrc, __m256i off,
+                             __m256& v0, __m256& v1 )
+{
+    const __m256i g =
+        _mm256_i32gather_epi32(reinterpret_cast<const int*>(pSrc), off, 1);
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    v0 = _mm256_cvtepi32_ps(_mm256_and_si256(g, mask));
+    v1 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(g, 8), mask));
+}
+
+inline void GWKLoadPairAVX2( const GUInt16* pSrc, __m256i off,
+                             __m256& v0, __m256& v1 )
+{
+    const __m256i g =
+        _mm256_i32gather_epi32(reinterpret_cast<const int*>(pSrc), off, 2);
+    v0 = _mm256_cvtepi32_ps(_mm256_and_si256(g, _mm256_set1_epi32(0xFFFF)));
+    v1 = _mm256_cvtepi32_ps(_mm256_srli_epi32(g, 16));
+}
+
+inline void GWKLoadPairAVX2( const GInt16* pSrc, __m256i off,
+                             __m256& v0, __m256& v1 )
+{
+    const __m256i g =
+        _mm256_i32gather_epi32(reinterpret_cast<const int*>(pSrc), off, 2);
+    v0 = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(g, 16), 16));
+    v1 = _mm256_cvtepi32_ps(_mm256_srai_epi32(g, 16));
+}
+
+/************************************************************************/
+/*                       GWKLoadQuadAVX2()                              */
+/*                                                                      */
+/*      Load the 4 consecutive source values at each of the 8 offsets.  */
+/************************************************************************/
+
+inline void GWKLoadQuadAVX2( const GByte* pSrc, __m256i off, __m256 v[4] )
+{
+    const __m256i g =
+        _mm256_i32gather_epi32(reinterpret_cast<const int*>(pSrc), off, 1);
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    v[0] = _mm256_cvtepi32_ps(_mm256_and_si256(g, mask));
+    v[1] = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(g, 8), mask));
+    v[2] = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(g, 16), mask));
+    v[3] = _mm256_cvtepi32_ps(_mm256_srli_epi32(g, 24));
+}
+
+template<class T>
+inline void GWKLoadQuadAVX2( const T* pSrc, __m256i off, __m256 v[4] )
+{
+    GWKLoadPairAVX2(pSrc, off, v[0], v[1]);
+    GWKLoadPairAVX2(pSrc, _mm256_add_epi32(off, _mm256_set1_epi32(2)),
+                    v[2], v[3]);
+}
+
+/************************************************************************/
+/*                        GWKStoreResultAVX2()                          */
+/************************************************************************/
+
+// Same rounding and clamping as GWKClampValueT<T>().
+template<class T>
+inline void GWKStoreResultAVX2( __m256 v, int nMask, T* pDst, GByte* pabyDone )
+{
+    v = _mm256_floor_ps(_mm256_add_ps(v, _mm256_set1_ps(0.5f)));
+    v = _mm256_max_ps(v, _mm256_set1_ps(
+        static_cast<float>(std::numeric_limits<T>::min())));
+    v = _mm256_min_ps(v, _mm256_set1_ps(
+        static_cast<float>(std::numeric_limits<T>::max())));
+    int anVal[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(anVal),
+                       _mm256_cvttps_epi32(v));
+    for( int k = 0; k < 8; k++ )
+    {
+        if( nMask & (1 << k) )
+        {
+            pDst[k] = static_cast<T>(anVal[k]);
+            pabyDone[k] = 1;
+        }
+    }
+}
+
+/************************************************************************/
+/*                   GWKResampleNoMasks4SampleRowT()                    */
+/************************************************************************/
+
+template<class T, GDALResampleAlg eResample>
+void GWKResampleNoMasks4SampleRowT( const T* pSrc,
+                                    int nSrcXSize, int nSrcYSize,
+                                    int nSrcXOff, int nSrcYOff,
+                                    int nCount,
+                                    const double* padfX,
+                                    const double* padfY,
+                                    const int* pabSuccess,
+                                    T* pDst, GByte* pabyDone )
+{
+    memset(pabyDone, 0, nCount);
+
+    // Bilinear needs a 2x2 neighbourhood, cubic a 4x4 one starting one
+    // pixel before.
+    const int nBefore = eResample == GRA_Cubic ? 1 : 0;
+    const int nAfter = eResample == GRA_Cubic ? 2 : 1;
+    const __m256d dfXOff = _mm256_set1_pd(nSrcXOff + 0.5);
+    const __m256d dfYOff = _mm256_set1_pd(nSrcYOff + 0.5);
+    const __m256d dfMinX = _mm256_set1_pd(nBefore);
+    const __m256d dfMinY = _mm256_set1_pd(nBefore);
+    const __m256d dfMaxX = _mm256_set1_pd(nSrcXSize - nAfter);
+    const __m256d dfMaxY = _mm256_set1_pd(nSrcYSize - nAfter);
+    const __m256i nStride = _mm256_set1_epi32(nSrcXSize);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    // The Byte bilinear loads read 2 bytes beyond the 2x2 neighbourhood.
+    const int nLastOffset =
+        (sizeof(T) == 1 && eResample == GRA_Bilinear) ?
+            nSrcXSize * nSrcYSize - 3 - nSrcXSize : INT_MAX;
+    // Offset of the upper left pixel of the first neighbourhood.
+    const int nSafeOffset = nBefore * nSrcXSize + nBefore;
+
+    for( int i = 0; i + 8 <= nCount; i += 8 )
+    {
+        // Source coordinates minus half a pixel, relative to the window.
+        const __m256d dfX0 = _mm256_sub_pd(_mm256_loadu_pd(padfX + i), dfXOff);
+        const __m256d dfX1 =
+            _mm256_sub_pd(_mm256_loadu_pd(padfX + i + 4), dfXOff);
+        const __m256d dfY0 = _mm256_sub_pd(_mm256_loadu_pd(padfY + i), dfYOff);
+        const __m256d dfY1 =
+            _mm256_sub_pd(_mm256_loadu_pd(padfY + i + 4), dfYOff);
+        const __m256d dfFloorX0 = _mm256_floor_pd(dfX0);
+        const __m256d dfFloorX1 = _mm256_floor_pd(dfX1);
+        const __m256d dfFloorY0 = _mm256_floor_pd(dfY0);
+        const __m256d dfFloorY1 = _mm256_floor_pd(dfY1);
+
+        // Ordered comparisons, so that NaN coordinates are rejected.
+        const __m256d bIn0 = _mm256_and_pd(
+            _mm256_and_pd(_mm256_cmp_pd(dfFloorX0, dfMinX, _CMP_GE_OQ),
+                          _mm256_cmp_pd(dfFloorX0, dfMaxX, _CMP_LT_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(dfFloorY0, dfMinY, _CMP_GE_OQ),
+                          _mm256_cmp_pd(dfFloorY0, dfMaxY, _CMP_LT_OQ)));
+        const __m256d bIn1 = _mm256_and_pd(
+            _mm256_and_pd(_mm256_cmp_pd(dfFloorX1, dfMinX, _CMP_GE_OQ),
+                          _mm256_cmp_pd(dfFloorX1, dfMaxX, _CMP_LT_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(dfFloorY1, dfMinY, _CMP_GE_OQ),
+                          _mm256_cmp_pd(dfFloorY1, dfMaxY, _CMP_LT_OQ)));
+        const __m256i anSuccess = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(pabSuccess + i));
+        int nMask = (_mm256_movemask_pd(bIn0) |
+                     (_mm256_movemask_pd(bIn1) << 4)) &
+                    ~_mm256_movemask_ps(_mm256_castsi256_ps(
+                        _mm256_cmpeq_epi32(anSuccess,
+                                           _mm256_setzero_si256())));
+        if( nMask == 0 )
+            continue;
+
+        const __m256i iSrcX = GWKCombine128(_mm256_cvttpd_epi32(dfFloorX0),
+                                            _mm256_cvttpd_epi32(dfFloorX1));
+        const __m256i iSrcY = GWKCombine128(_mm256_cvttpd_epi32(dfFloorY0),
+                                            _mm256_cvttpd_epi32(dfFloorY1));
+        __m256i iSrcOffset =
+            _mm256_add_epi32(_mm256_mullo_epi32(iSrcY, nStride), iSrcX);
+        if( nLastOffset != INT_MAX )
+        {
+            nMask &= _mm256_movemask_ps(_mm256_castsi256_ps(
+                _mm256_cmpgt_epi32(_mm256_set1_epi32(nLastOffset),
+                                   iSrcOffset)));
+            if( nMask == 0 )
+                continue;
+        }
+        iSrcOffset = GWKClampOffsetsAVX2(iSrcOffset, nMask, nSafeOffset);
+
+        // Fractional parts are computed in double precision, as the scalar
+        // code does, before accumulating in single precision.
+        const __m256 dfDeltaX = GWKCombine128(
+            _mm256_cvtpd_ps(_mm256_sub_pd(dfX0, dfFloorX0)),
+            _mm256_cvtpd_ps(_mm256_sub_pd(dfX1, dfFloorX1)));
+        const __m256 dfDeltaY = GWKCombine128(
+            _mm256_cvtpd_ps(_mm256_sub_pd(dfY0, dfFloorY0)),
+            _mm256_cvtpd_ps(_mm256_sub_pd(dfY1, dfFloorY1)));
+
+        __m256 dfValue;
+        if( eResample == GRA_Bilinear )
+        {
+            const __m256 dfRatioX = _mm256_sub_ps(one, dfDeltaX);
+            const __m256 dfRatioY = _mm256_sub_ps(one, dfDeltaY);
+            __m256 v00, v01, v10, v11;
+            GWKLoadPairAVX2(pSrc, iSrcOffset, v00, v01);
+            GWKLoadPairAVX2(pSrc, _mm256_add_epi32(iSrcOffset, nStride),
+                            v10, v11);
+            const __m256 dfTop = _mm256_add_ps(
+                _mm256_mul_ps(v00, dfRatioX), _mm256_mul_ps(v01, dfDeltaX));
+            const __m256 dfBottom = _mm256_add_ps(
+                _mm256_mul_ps(v10, dfRatioX), _mm256_mul_ps(v11, dfDeltaX));
+            dfValue = _mm256_add_ps(_mm256_mul_ps(dfTop, dfRatioY),
+                                    _mm256_mul_ps(dfBottom, dfDeltaY));
+        }
+        else
+        {
+            // Same formulas as GWKCubicComputeWeights() and
+            // CubicConvolution().
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 dfHalfX = _mm256_mul_ps(half, dfDeltaX);
+            const __m256 dfThreeX = _mm256_mul_ps(_mm256_set1_ps(3.0f),
+                                                  dfDeltaX);
+            const __m256 dfHalfX2 = _mm256_mul_ps(dfHalfX, dfDeltaX);
+            const __m256 c0 = _mm256_mul_ps(dfHalfX, _mm256_add_ps(
+                _mm256_set1_ps(-1.0f), _mm256_mul_ps(dfDeltaX,
+                    _mm256_sub_ps(_mm256_set1_ps(2.0f), dfDeltaX))));
+            const __m256 c1 = _mm256_add_ps(one, _mm256_mul_ps(dfHalfX2,
+                _mm256_add_ps(_mm256_set1_ps(-5.0f), dfThreeX)));
+            const __m256 c2 = _mm256_mul_ps(dfHalfX, _mm256_add_ps(one,
+                _mm256_mul_ps(dfDeltaX,
+                    _mm256_sub_ps(_mm256_set1_ps(4.0f), dfThreeX))));
+            const __m256 c3 = _mm256_mul_ps(dfHalfX2,
+                _mm256_add_ps(_mm256_set1_ps(-1.0f), dfDeltaX));
+
+            __m256 adfRow[4];
+            __m256i iRowOffset = _mm256_sub_epi32(
+                _mm256_sub_epi32(iSrcOffset, nStride), _mm256_set1_epi32(1));
+            for( int j = 0; j < 4; j++ )
+            {
+                __m256 v[4];
+                GWKLoadQuadAVX2(pSrc, iRowOffset, v);
+                adfRow[j] = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(c0, v[0]),
+                                  _mm256_mul_ps(c1, v[1])),
+                    _mm256_add_ps(_mm256_mul_ps(c2, v[2]),
+                                  _mm256_mul_ps(c3, v[3])));
+                iRowOffset = _mm256_add_epi32(iRowOffset, nStride);
+            }
+
+            const __m256 dfDeltaY2 = _mm256_mul_ps(dfDeltaY, dfDeltaY);
+            const __m256 dfDeltaY3 = _mm256_mul_ps(dfDeltaY2, dfDeltaY);
+            const __m256 f0 = adfRow[0];
+            const __m256 f1 = adfRow[1];
+            const __m256 f2 = adfRow[2];
+            const __m256 f3 = adfRow[3];
+            const __m256 t1 = _mm256_mul_ps(dfDeltaY, _mm256_sub_ps(f2, f0));
+            const __m256 t2 = _mm256_mul_ps(dfDeltaY2, _mm256_sub_ps(
+                _mm256_add_ps(
+                    _mm256_sub_ps(_mm256_add_ps(f0, f0),
+                                  _mm256_mul_ps(_mm256_set1_ps(5.0f), f1)),
+                    _mm256_mul_ps(_mm256_set1_ps(4.0f), f2)),
+                f3));
+            const __m256 t3 = _mm256_mul_ps(dfDeltaY3, _mm256_sub_ps(
+                _mm256_add_ps(
+                    _mm256_mul_ps(_mm256_set1_ps(3.0f), _mm256_sub_ps(f1, f2)),
+                    f3),
+                f0));
+            dfValue = _mm256_add_ps(f1, _mm256_mul_ps(half,
+                _mm256_add_ps(_mm256_add_ps(t1, t2), t3)));
+        }
+
+        GWKStoreResultAVX2(dfValue, nMask, pDst + i, pabyDone + i);
+    }
+}
+
+template<class T>
+void GWKResampleNoMasks4SampleRowT( GDALResampleAlg eResample,
+                                    const T* pSrc,
+                                    int nSrcXSize, int nSrcYSize,
+                                    int nSrcXOff, int nSrcYOff,
+                                    int nCount,
+                                    const double* padfX,
+                                    const double* padfY,
+                                    const int* pabSuccess,
+                                    T* pDst, GByte* pabyDone )
+{
+    if( eResample == GRA_Cubic )
+        GWKResampleNoMasks4SampleRowT<T, GRA_Cubic>(
+            pSrc, nSrcXSize, nSrcYSize, nSrcXOff, nSrcYOff, nCount,
+            padfX, padfY, pabSuccess, pDst, pabyDone);
+    else
+        GWKResampleNoMasks4SampleRowT<T, GRA_Bilinear>(
+            pSrc, nSrcXSize, nSrcYSize, nSrcXOff, nSrcYOff, nCount,
+            padfX, padfY, pabSuccess, pDst, pabyDone);
+}
+
+/************************************************************************/
+/*                      GWKLoadValues4AVX2()                            */
+/*                                                                      */
+/*      Load the source values at 4 offsets, as doubles.                */
+/************************************************************************/
+
+// As for the Byte bilinear case above, the Byte version reads 4 bytes at
+// each offset.
+inline __m256d GWKLoadValues4AVX2( const GByte* pSrc, __m128i off )
+{
+    const __m128i g =
+        _mm_i32gather_epi32(reinterpret_cast<const int*>(pSrc), off, 1);
+    return _mm256_cvtepi32_pd(_mm_and_si128(g, _mm_set1_epi32(0xFF)));
+}
+
+inline __m256d GWKLoadValues4AVX2( const GUInt16* pSrc, __m128i off )
+{
+    // Aligned down 32 bit loads, so that the last value of the buffer can be
+    // read.
+    const __m128i g = _mm_i32gather_epi32(
+        reinterpret_cast<const int*>(pSrc),
+        _mm_andnot_si128(_mm_set1_epi32(1), off), 2);
+    const __m128i shift =
+        _mm_slli_epi32(_mm_and_si128(off, _mm_set1_epi32(1)), 4);
+    return _mm256_cvtepi32_pd(_mm_and_si128(_mm_srlv_epi32(g, shift),
+                                            _mm_set1_epi32(0xFFFF)));
+}
+
+inline __m256d GWKLoadValues4AVX2( const GInt16* pSrc, __m128i off )
+{
+    const __m128i g = _mm_i32gather_epi32(
+        reinterpret_cast<const int*>(pSrc),
+        _mm_andnot_si128(_mm_set1_epi32(1), off), 2);
+    const __m128i shift =
+        _mm_slli_epi32(_mm_and_si128(off, _mm_set1_epi32(1)), 4);
+    return _mm256_cvtepi32_pd(_mm_srai_epi32(
+        _mm_slli_epi32(_mm_srlv_epi32(g, shift), 16), 16));
+}
+
+inline __m256d GWKLoadValues4AVX2( const float* pSrc, __m128i off )
+{
+    return _mm256_cvtps_pd(_mm_i32gather_ps(pSrc, off, 4));
+}
+
+/************************************************************************/
+/*                       GWKLoadValidAVX2()                             */
+/*                                                                      */
+/*      Return all ones for the offsets whose validity bit is set.      */
+/************************************************************************/
+
+inline __m128i GWKLoadValidAVX2( const GUInt32* panValid, __m128i off )
+{
+    const __m128i g = _mm_i32gather_epi32(
+        reinterpret_cast<const int*>(panValid), _mm_srli_epi32(off, 5), 4);
+    const __m128i bit = _mm_and_si128(
+        _mm_srlv_epi32(g, _mm_and_si128(off, _mm_set1_epi32(0x1f))),
+        _mm_set1_epi32(1));
+    return _mm_cmpeq_epi32(bit, _mm_set1_epi32(1));
+}
+
+/************************************************************************/
+/*                   GWKBilinearResample4SampleRowT()                   */
+/************************************************************************/
+
+// Must produce exactly the same results as GWKBilinearResample4Sample()
+// for the pixels whose 2x2 neighbourhood is inside the source window, so
+// accumulation is done in double precision and in the same order.
+template<class T>
+void GWKBilinearResample4SampleRowT( const GDALWarpKernel* poWK,
+                                     int iBand, int nCount,
+                                     const double* padfX,
+                                     const double* padfY,
+                                     const int* pabSuccess,
+                                     double* padfDensity,
+                                     double* padfReal,
+                                     GByte* pabyDone )
+{
+    memset(pabyDone, 0, nCount);
+
+    const int nSrcXSize = poWK->nSrcXSize;
+    const int nSrcYSize = poWK->nSrcYSize;
+    const T* pSrc = reinterpret_cast<const T*>(poWK->papabySrcImage[iBand]);
+    const GUInt32* panUnifiedSrcValid = poWK->panUnifiedSrcValid;
+    const GUInt32* panBandSrcValid =
+        poWK->papanBandSrcValid ? poWK->papanBandSrcValid[iBand] : nullptr;
+    const float* pafUnifiedSrcDensity = poWK->pafUnifiedSrcDensity;
+
+    const __m256d dfXOff = _mm256_set1_pd(poWK->nSrcXOff);
+    const __m256d dfYOff = _mm256_set1_pd(poWK->nSrcYOff);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d oneAndHalf = _mm256_set1_pd(1.5);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d dfMaxX = _mm256_set1_pd(nSrcXSize - 1);
+    const __m256d dfMaxY = _mm256_set1_pd(nSrcYSize - 1);
+    const __m256d dfThreshold = _mm256_set1_pd(SRC_DENSITY_THRESHOLD);
+    const __m128i nStride = _mm_set1_epi32(nSrcXSize);
+    // The Byte loads of the lower right pixel read up to offset + 4.
+    const int nLastOffset = sizeof(T) == 1 ?
+        nSrcXSize * nSrcYSize - 4 - nSrcXSize : INT_MAX;
+
+    for( int i = 0; i + 4 <= nCount; i += 4 )
+    {
+        const __m256d dfSrcX = _mm256_sub_pd(_mm256_loadu_pd(padfX + i), dfXOff);
+        const __m256d dfSrcY = _mm256_sub_pd(_mm256_loadu_pd(padfY + i), dfYOff);
+        const __m256d dfFloorX = _mm256_floor_pd(_mm256_sub_pd(dfSrcX, half));
+        const __m256d dfFloorY = _mm256_floor_pd(_mm256_sub_pd(dfSrcY, half));
+        const __m256d bIn = _mm256_and_pd(
+            _mm256_and_pd(_mm256_cmp_pd(dfFloorX, zero, _CMP_GE_OQ),
+                          _mm256_cmp_pd(dfFloorX, dfMaxX, _CMP_LT_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(dfFloorY, zero, _CMP_GE_OQ),
+                          _mm256_cmp_pd(dfFloorY, dfMaxY, _CMP_LT_OQ)));
+        const __m128i anSuccess =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(pabSuccess + i));
+        int nMask = _mm256_movemask_pd(bIn) &
+            ~_mm_movemask_ps(_mm_castsi128_ps(
+                _mm_cmpeq_epi32(anSuccess, _mm_setzero_si128())));
+        if( nMask == 0 )
+            continue;
+
+        const __m128i iSrcX = _mm256_cvttpd_epi32(dfFloorX);
+        const __m128i iSrcY = _mm256_cvttpd_epi32(dfFloorY);
+        __m128i iSrcOffset =
+            _mm_add_epi32(_mm_mullo_epi32(iSrcY, nStride), iSrcX);
+        if( nLastOffset != INT_MAX )
+        {
+            nMask &= _mm_movemask_ps(_mm_castsi128_ps(
+                _mm_cmpgt_epi32(_mm_set1_epi32(nLastOffset), iSrcOffset)));
+            if( nMask == 0 )
+                continue;
+        }
+        iSrcOffset = GWKClampOffsetsAVX2(iSrcOffset, nMask, 0);
+
+        const __m256d dfRatioX =
+            _mm256_sub_pd(oneAndHalf, _mm256_sub_pd(dfSrcX, dfFloorX));
+        const __m256d dfRatioY =
+            _mm256_sub_pd(oneAndHalf, _mm256_sub_pd(dfSrcY, dfFloorY));
+        const __m256d adfMult[4] = {
+            _mm256_mul_pd(dfRatioX, dfRatioY),
+            _mm256_mul_pd(_mm256_sub_pd(one, dfRatioX), dfRatioY),
+            _mm256_mul_pd(dfRatioX, _mm256_sub_pd(one, dfRatioY)),
+            _mm256_mul_pd(_mm256_sub_pd(one, dfRatioX),
+                          _mm256_sub_pd(one, dfRatioY)) };
+        const __m128i anOffset[4] = {
+            iSrcOffset,
+            _mm_add_epi32(iSrcOffset, _mm_set1_epi32(1)),
+            _mm_add_epi32(iSrcOffset, nStride),
+            _mm_add_epi32(_mm_add_epi32(iSrcOffset, nStride),
+                          _mm_set1_epi32(1)) };
+
+        __m256d dfAccumulatorReal = zero;
+        __m256d dfAccumulatorDensity = zero;
+        __m256d dfAccumulatorDivisor = zero;
+        // Upper left, upper right, lower left, lower right.
+        for( int k = 0; k < 4; k++ )
+        {
+            __m128i bValid = _mm_set1_epi32(-1);
+            if( panUnifiedSrcValid )
+                bValid = _mm_and_si128(bValid,
+                    GWKLoadValidAVX2(panUnifiedSrcValid, anOffset[k]));
+            if( panBandSrcValid )
+                bValid = _mm_and_si128(bValid,
+                    GWKLoadValidAVX2(panBandSrcValid, anOffset[k]));
+            __m256d dfDensity = pafUnifiedSrcDensity ?
+                _mm256_cvtps_pd(_mm_i32gather_ps(pafUnifiedSrcDensity,
+                                                 anOffset[k], 4)) : one;
+            dfDensity = _mm256_and_pd(dfDensity,
+                _mm256_castsi256_pd(_mm256_cvtepi32_epi64(bValid)));
+            const __m256d bUse =
+                _mm256_cmp_pd(dfDensity, dfThreshold, _CMP_GT_OQ);
+            const __m256d dfValue = GWKLoadValues4AVX2(pSrc, anOffset[k]);
+
+            dfAccumulatorDivisor = _mm256_add_pd(dfAccumulatorDivisor,
+                _mm256_and_pd(adfMult[k], bUse));
+            dfAccumulatorReal = _mm256_add_pd(dfAccumulatorReal,
+                _mm256_and_pd(_mm256_mul_pd(dfValue, adfMult[k]), bUse));
+            dfAccumulatorDensity = _mm256_add_pd(dfAccumulatorDensity,
+                _mm256_and_pd(_mm256_mul_pd(dfDensity, adfMult[k]), bUse));
+        }
+
+        double adfDivisor[4];
+        double adfReal[4];
+        double adfDensity[4];
+        _mm256_storeu_pd(adfDivisor, dfAccumulatorDivisor);
+        _mm256_storeu_pd(adfReal, dfAccumulatorReal);
+        _mm256_storeu_pd(adfDensity, dfAccumulatorDensity);
+        for( int k = 0; k < 4; k++ )
+        {
+            if( !(nMask & (1 << k)) )
+                continue;
+            if( adfDivisor[k] == 1.0 )
+            {
+                padfReal[i + k] = adfReal[k];
+                padfDensity[i + k] = adfDensity[k];
+            }
+            else if( adfDivisor[k] < 0.00001 )
+            {
+                padfReal[i + k] = 0.0;
+                padfDensity[i + k] = 0.0;
+            }
+            else
+            {
+                padfReal[i + k] = adfReal[k] / adfDivisor[k];
+                padfDensity[i + k] = adfDensity[k] / adfDivisor[k];
+            }
+            pabyDone[i + k] = 1;
+        }
+    }
+}
+
+}  // namespace
+
+/************************************************************************/
+/*                 GWKResampleNoMasks4SampleRow_AVX2()                  */
+/************************************************************************/
+
+void GWKResampleNoMasks4SampleRow_AVX2( GDALResampleAlg eResample,
+                                        const GByte* pSrc,
+                                        int nSrcXSize, int nSrcYSize,
+                                        int nSrcXOff, int nSrcYOff,
+                                        int nCount,
+                                        const double* padfX,
+                                        const double* padfY,
+                                        const int* pabSuccess,
+                                        GByte* pDst, GByte* pabyDone )
+{
+    GWKResampleNoMasks4SampleRowT(eResample, pSrc, nSrcXSize, nSrcYSize,
+                                  nSrcXOff, nSrcYOff, nCount,
+                                  padfX, padfY, pabSuccess, pDst, pabyDone);
+}
+
+void GWKResampleNoMasks4SampleRow_AVX2( GDALResampleAlg eResample,
+                                        const GInt16* pSrc,
+                                        int nSrcXSize, int nSrcYSize,
+                                        int nSrcXOff, int nSrcYOff,
+                                        int nCount,
+                                        const double* padfX,
+                                        const double* padfY,
+                                        const int* pabSuccess,
+                                        GInt16* pDst, GByte* pabyDone )
+{
+    GWKResampleNoMasks4SampleRowT(eResample, pSrc, nSrcXSize, nSrcYSize,
+                                  nSrcXOff, nSrcYOff, nCount,
+                                  padfX, padfY, pabSuccess, pDst, pabyDone);
+}
+
+void GWKResampleNoMasks4SampleRow_AVX2( GDALResampleAlg eResample,
+                                        const GUInt16* pSrc,
+                                        int nSrcXSize, int nSrcYSize,
+                                        int nSrcXOff, int nSrcYOff,
+                                        int nCount,
+                                        const double* padfX,
+                                        const double* padfY,
+                                        const int* pabSuccess,
+                                        GUInt16* pDst, GByte* pabyDone )
+{
+    GWKResampleNoMasks4SampleRowT(eResample, pSrc, nSrcXSize, nSrcYSize,
+                                  nSrcXOff, nSrcYOff, nCount,
+                                  padfX, padfY, pabSuccess, pDst, pabyDone);
+}
+
+/************************************************************************/
+/*                GWKBilinearResample4SampleRow_AVX2()                  */
+/************************************************************************/
+
+bool GWKBilinearResample4SampleRow_AVX2( const GDALWarpKernel* poWK,
+                                         int iBand, int nCount,
+                                         const double* padfX,
+                                         const double* padfY,
+                                         const int* pabSuccess,
+                                         double* padfDensity,
+                                         double* padfReal,
+                                         GByte* pabyDone )
+{
+    switch( poWK->eWorkingDataType )
+    {
+        case GDT_Byte:
+            GWKBilinearResample4SampleRowT<GByte>(
+                poWK, iBand, nCount, padfX, padfY, pabSuccess,
+                padfDensity, padfReal, pabyDone);
+            return true;
+        case GDT_Int16:
+            GWKBilinearResample4SampleRowT<GInt16>(
+                poWK, iBand, nCount, padfX, padfY, pabSuccess,
+                padfDensity, padfReal, pabyDone);
+            return true;
+        case GDT_UInt16:
+            GWKBilinearResample4SampleRowT<GUInt16>(
+                poWK, iBand, nCount, padfX, padfY, pabSuccess,
+                padfDensity, padfReal, pabyDone);
+            return true;
+        case GDT_Float32:
+            GWKBilinearResample4SampleRowT<float>(
+                poWK, iBand, nCount, padfX, padfY, pabSuccess,
+                padfDensity, padfReal, pabyDone);
+            return true;
+        default:
+            return false;
+    }
+}
+
+#endif // defined(HAVE_AVX2_AT_COMPILE_TIME) && ( defined(__x86_64) || defined(_M_X64) )
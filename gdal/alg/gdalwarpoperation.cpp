@@ -38,6 +38,8 @@
 
 #include <algorithm>
 #include <limits>
+#include <utility>
+#include <vector>
 
 #include "cpl_config.h"
 #include "cpl_conv.h"
@@ -58,6 +60,38 @@ struct _GDALWarpChunk {
     double sExtraSx, sExtraSy;
 };
 
+// State shared by the chunks processed concurrently by ChunkAndWarpMulti().
+struct _GDALWarpChunkPipeline {
+    // Serialize I/O on the source and on the destination datasets, so that
+    // reading a chunk can overlap writing another one. Both are the same
+    // mutex when the source and destination datasets are the same.
+    CPLMutex *hSrcIOMutex;
+    CPLMutex *hDstIOMutex;
+
+    // Chunks are written in the order of the chunk list. hCondMutex protects
+    // iNextChunkToWrite and bStop.
+    CPLMutex *hCondMutex;
+    CPLCond  *hCond;
+    int       iNextChunkToWrite;
+    bool      bStop;
+};
+
+// Source buffer of the last warped chunk, kept by ChunkAndWarpImage() and
+// ChunkAndWarpMulti() so that the next chunk can copy the part of its source
+// window that overlaps it instead of reading it again. Accessed under the
+// source IO mutex.
+struct _GDALWarpSrcWindowCache {
+    GByte    *pabyData;
+    int       nXOff;
+    int       nYOff;
+    int       nXSize;
+    int       nYSize;
+
+    // Statistics, in source pixels.
+    GIntBig   nPixelsNeeded;
+    GIntBig   nPixelsRead;
+};
+
 /************************************************************************/
 /* ==================================================================== */
 /*                          GDALWarpOperation                           */
@@ -137,7 +171,8 @@ GDALWarpKernel.
 
 GDALWarpOperation::GDALWarpOperation() :
     psOptions(nullptr),
-    hIOMutex(nullptr),
+    psPipeline(nullptr),
+    psSrcWindowCache(nullptr),
     hWarpMutex(nullptr),
     nChunkListCount(0),
     nChunkListMax(0),
@@ -156,12 +191,6 @@ GDALWarpOperation::~GDALWarpOperation()
 {
     WipeOptions();
 
-    if( hIOMutex != nullptr )
-    {
-        CPLDestroyMutex( hIOMutex );
-        CPLDestroyMutex( hWarpMutex );
-    }
-
     WipeChunkList();
     if( psThreadData )
         GWKThreadsEnd(psThreadData);
@@ -227,7 +256,8 @@ int GDALWarpOperation::ValidateOptions()
         && psOptions->eResampleAlg != GRA_Min
         && psOptions->eResampleAlg != GRA_Med
         && psOptions->eResampleAlg != GRA_Q1
-        && psOptions->eResampleAlg != GRA_Q3)
+        && psOptions->eResampleAlg != GRA_Q3
+        && psOptions->eResampleAlg != GRA_Sum)
     {
         CPLError( CE_Failure, CPLE_IllegalArg,
                   "GDALWarpOptions.Validate(): "
@@ -763,6 +793,55 @@ static int OrderWarpChunk(const void* _a, const void *_b)
         return 0;
 }
 
+// Index of (nX, nY), with 0 <= nX, nY < 65536, along a Hilbert curve.
+static GUIntBig GWOHilbertIndex( GUInt32 nX, GUInt32 nY )
+{
+    constexpr GUInt32 N = 65536;
+    GUIntBig nIndex = 0;
+    for( GUInt32 s = N / 2; s > 0; s /= 2 )
+    {
+        const GUInt32 rx = (nX & s) != 0 ? 1 : 0;
+        const GUInt32 ry = (nY & s) != 0 ? 1 : 0;
+        nIndex += static_cast<GUIntBig>(s) * s * ((3 * rx) ^ ry);
+        if( ry == 0 )
+        {
+            if( rx == 1 )
+            {
+                nX = N - 1 - nX;
+                nY = N - 1 - nY;
+            }
+            std::swap(nX, nY);
+        }
+    }
+    return nIndex;
+}
+
+// Number of source pixels read when processing the chunks in the given
+// order, if the source window of each chunk is reused by the next one.
+static double GWOSrcPixelsToRead( const GDALWarpChunk* pasChunks,
+                                  int nChunkCount )
+{
+    double dfPixels = 0.0;
+    for( int i = 0; i < nChunkCount; i++ )
+    {
+        const GDALWarpChunk& sChunk = pasChunks[i];
+        dfPixels += static_cast<double>(sChunk.ssx) * sChunk.ssy;
+        if( i > 0 )
+        {
+            const GDALWarpChunk& sPrev = pasChunks[i-1];
+            const int nXOverlap =
+                std::min(sChunk.sx + sChunk.ssx, sPrev.sx + sPrev.ssx) -
+                std::max(sChunk.sx, sPrev.sx);
+            const int nYOverlap =
+                std::min(sChunk.sy + sChunk.ssy, sPrev.sy + sPrev.ssy) -
+                std::max(sChunk.sy, sPrev.sy);
+            if( nXOverlap > 0 && nYOverlap > 0 )
+                dfPixels -= static_cast<double>(nXOverlap) * nYOverlap;
+        }
+    }
+    return dfPixels;
+}
+
 void GDALWarpOperation::CollectChunkList(
     int nDstXOff, int nDstYOff,  int nDstXSize, int nDstYSize )
 
@@ -802,6 +881,67 @@ void GDALWarpOperation::CollectChunkList(
         dfApproxAccArea += static_cast<double>(pasThisChunk->ssx) *
                                 pasThisChunk->ssy;
     }
+
+/* -------------------------------------------------------------------- */
+/*      When the source windows of consecutive chunks in destination    */
+/*      order overlap poorly (typically for rotated or high latitude    */
+/*      reprojections), order the chunks along a Hilbert curve going    */
+/*      through the center of their source windows instead, so that     */
+/*      each chunk can reuse most of the source window of the previous  */
+/*      one.                                                            */
+/* -------------------------------------------------------------------- */
+    const char* pszChunkOrder =
+        CSLFetchNameValueDef(psOptions->papszWarpOptions,
+                             "CHUNK_ORDER", "AUTO");
+    if( nChunkListCount > 2 && nSrcXOff < nSrcX2Off && nSrcYOff < nSrcY2Off &&
+        !EQUAL(pszChunkOrder, "DESTINATION") &&
+        !CPLFetchBool(psOptions->papszWarpOptions, "STREAMABLE_OUTPUT",
+                      false) )
+    {
+        const double dfXScale = 65535.0 / (nSrcX2Off - nSrcXOff);
+        const double dfYScale = 65535.0 / (nSrcY2Off - nSrcYOff);
+        std::vector<std::pair<GUIntBig, int>> aoKeys;
+        aoKeys.reserve(nChunkListCount);
+        for( int iChunk = 0; iChunk < nChunkListCount; iChunk++ )
+        {
+            const GDALWarpChunk& sChunk = pasChunkList[iChunk];
+            const double dfX = std::max(0.0, std::min(65535.0,
+                (sChunk.sx + sChunk.ssx * 0.5 - nSrcXOff) * dfXScale));
+            const double dfY = std::max(0.0, std::min(65535.0,
+                (sChunk.sy + sChunk.ssy * 0.5 - nSrcYOff) * dfYScale));
+            aoKeys.push_back(std::pair<GUIntBig, int>(
+                GWOHilbertIndex(static_cast<GUInt32>(dfX),
+                                static_cast<GUInt32>(dfY)),
+                iChunk));
+        }
+        // Stable, so that chunks with the same key stay in destination order.
+        std::stable_sort(aoKeys.begin(), aoKeys.end(),
+            [](const std::pair<GUIntBig, int>& a,
+               const std::pair<GUIntBig, int>& b)
+            { return a.first < b.first; });
+
+        std::vector<GDALWarpChunk> asSrcOrderedChunks;
+        asSrcOrderedChunks.reserve(nChunkListCount);
+        for( const auto& oKey : aoKeys )
+            asSrcOrderedChunks.push_back(pasChunkList[oKey.second]);
+
+        const double dfDstOrderPixels =
+            GWOSrcPixelsToRead(pasChunkList, nChunkListCount);
+        const double dfSrcOrderPixels =
+            GWOSrcPixelsToRead(&asSrcOrderedChunks[0], nChunkListCount);
+        // Destination order is friendlier to the output driver, so only
+        // switch when the saving is significant.
+        if( EQUAL(pszChunkOrder, "SOURCE") ||
+            dfSrcOrderPixels < 0.8 * dfDstOrderPixels )
+        {
+            CPLDebug("WARP",
+                     "Ordering %d chunks by source window locality: "
+                     "%.0f source pixels to read instead of %.0f",
+                     nChunkListCount, dfSrcOrderPixels, dfDstOrderPixels);
+            memcpy(pasChunkList, &asSrcOrderedChunks[0],
+                   sizeof(GDALWarpChunk) * nChunkListCount);
+        }
+    }
     if( nSrcXOff < nSrcX2Off )
     {
         const double dfTotalArea =
@@ -820,6 +960,45 @@ void GDALWarpOperation::CollectChunkList(
     }
 }
 
+/************************************************************************/
+/*                        BeginSrcWindowCache()                         */
+/************************************************************************/
+
+void GDALWarpOperation::BeginSrcWindowCache(
+    GDALWarpSrcWindowCache* psCache )
+{
+    psCache->pabyData = nullptr;
+    psCache->nXOff = 0;
+    psCache->nYOff = 0;
+    psCache->nXSize = 0;
+    psCache->nYSize = 0;
+    psCache->nPixelsNeeded = 0;
+    psCache->nPixelsRead = 0;
+    psSrcWindowCache = psCache;
+}
+
+/************************************************************************/
+/*                         EndSrcWindowCache()                          */
+/************************************************************************/
+
+void GDALWarpOperation::EndSrcWindowCache()
+{
+    if( psSrcWindowCache == nullptr )
+        return;
+    if( psSrcWindowCache->nPixelsNeeded > 0 )
+    {
+        CPLDebug("WARP",
+                 "Source pixels needed: " CPL_FRMT_GIB ", read: " CPL_FRMT_GIB
+                 " (%.1f%%)",
+                 psSrcWindowCache->nPixelsNeeded,
+                 psSrcWindowCache->nPixelsRead,
+                 100.0 * psSrcWindowCache->nPixelsRead /
+                     psSrcWindowCache->nPixelsNeeded);
+    }
+    CPLFree(psSrcWindowCache->pabyData);
+    psSrcWindowCache = nullptr;
+}
+
 /************************************************************************/
 /*                         ChunkAndWarpImage()                          */
 /************************************************************************/
@@ -856,6 +1035,9 @@ CPLErr GDALWarpOperation::ChunkAndWarpImage(
 /* -------------------------------------------------------------------- */
     CollectChunkList( nDstXOff, nDstYOff, nDstXSize, nDstYSize );
 
+    GDALWarpSrcWindowCache sSrcWindowCache;
+    BeginSrcWindowCache( &sSrcWindowCache );
+
 /* -------------------------------------------------------------------- */
 /*      Total up output pixels to process.                              */
 /* -------------------------------------------------------------------- */
@@ -898,11 +1080,15 @@ CPLErr GDALWarpOperation::ChunkAndWarpImage(
                        dfProgressBase, dfProgressScale);
 
         if( eErr != CE_None )
+        {
+            EndSrcWindowCache();
             return eErr;
+        }
 
         dfPixelsProcessed += dfChunkPixels;
     }
 
+    EndSrcWindowCache();
     WipeChunkList();
 
     psOptions->pfnProgress( 1.00001, "", psOptions->pProgressArg );
@@ -933,60 +1119,44 @@ CPLErr GDALChunkAndWarpImage( GDALWarpOperationH hOperation,
 
 typedef struct
 {
-    GDALWarpOperation *poOperation;
-    GDALWarpChunk     *pasChunkInfo;
-    CPLJoinableThread *hThreadHandle;
-    CPLErr             eErr;
-    double             dfProgressBase;
-    double             dfProgressScale;
-    CPLMutex          *hIOMutex;
-
-    CPLMutex          *hCondMutex;
-    volatile int       bIOMutexTaken;
-    CPLCond           *hCond;
+    GDALWarpOperation     *poOperation;
+    GDALWarpChunkPipeline *psPipeline;
+    GDALWarpChunk         *pasChunkInfo;
+    int                    iChunk;
+    CPLJoinableThread     *hThreadHandle;
+    CPLErr                 eErr;
+    double                 dfProgressBase;
+    double                 dfProgressScale;
 } ChunkThreadData;
 
 static void ChunkThreadMain( void *pThreadData )
 
 {
-    volatile ChunkThreadData* psData =
-        static_cast<volatile ChunkThreadData*>(pThreadData);
+    ChunkThreadData* psData = static_cast<ChunkThreadData*>(pThreadData);
 
     GDALWarpChunk *pasChunkInfo = psData->pasChunkInfo;
 
+    psData->eErr = psData->poOperation->WarpRegion(
+                                pasChunkInfo->dx, pasChunkInfo->dy,
+                                pasChunkInfo->dsx, pasChunkInfo->dsy,
+                                pasChunkInfo->sx, pasChunkInfo->sy,
+                                pasChunkInfo->ssx, pasChunkInfo->ssy,
+                                pasChunkInfo->sExtraSx,
+                                pasChunkInfo->sExtraSy,
+                                psData->dfProgressBase,
+                                psData->dfProgressScale);
+
 /* -------------------------------------------------------------------- */
-/*      Acquire IO mutex.                                               */
+/*      On failure, wake up the chunks waiting for their turn to        */
+/*      write, so that they abort.                                      */
 /* -------------------------------------------------------------------- */
-    if( !CPLAcquireMutex( psData->hIOMutex, 600.0 ) )
-    {
-        CPLError( CE_Failure, CPLE_AppDefined,
-                    "Failed to acquire IOMutex in WarpRegion()." );
-        psData->eErr = CE_Failure;
-    }
-    else
+    if( psData->eErr != CE_None )
     {
-        if( psData->hCond != nullptr )
-        {
-            CPLAcquireMutex( psData->hCondMutex, 1.0 );
-            psData->bIOMutexTaken = TRUE;
-            CPLCondSignal(psData->hCond);
-            CPLReleaseMutex( psData->hCondMutex );
-        }
-
-        psData->eErr = psData->poOperation->WarpRegion(
-                                    pasChunkInfo->dx, pasChunkInfo->dy,
-                                    pasChunkInfo->dsx, pasChunkInfo->dsy,
-                                    pasChunkInfo->sx, pasChunkInfo->sy,
-                                    pasChunkInfo->ssx, pasChunkInfo->ssy,
-                                    pasChunkInfo->sExtraSx,
-                                    pasChunkInfo->sExtraSy,
-                                    psData->dfProgressBase,
-                                    psData->dfProgressScale);
-
-    /* -------------------------------------------------------------------- */
-    /*      Release the IO mutex.                                           */
-    /* -------------------------------------------------------------------- */
-        CPLReleaseMutex( psData->hIOMutex );
+        GDALWarpChunkPipeline* psPipeline = psData->psPipeline;
+        CPLAcquireMutex( psPipeline->hCondMutex, 1000.0 );
+        psPipeline->bStop = true;
+        CPLCondBroadcast( psPipeline->hCond );
+        CPLReleaseMutex( psPipeline->hCondMutex );
     }
 }
 
@@ -1006,6 +1176,17 @@ static void ChunkThreadMain( void *pThreadData )
  * internally this method uses multiple threads to interleave input/output
  * for one region while the processing is being done for another.
  *
+ * Starting with GDAL 2.4, chunks go through a pipeline made of three stages:
+ * reading of the source (and destination, if not initialized) data, warping,
+ * and writing to the destination. Several chunks, set by the
+ * CHUNKS_IN_FLIGHT warping option (3 by default), are processed at the same
+ * time, each in a different stage. Reading of the source dataset and I/O on
+ * the destination dataset are serialized separately, so they can overlap,
+ * and chunks are written in order. Each chunk in flight has its own
+ * buffers, so the memory used can reach CHUNKS_IN_FLIGHT times the warp
+ * memory limit. The source and destination datasets must be independent
+ * objects (or the same object).
+ *
  * @param nDstXOff X offset to window of destination data to be produced.
  * @param nDstYOff Y offset to window of destination data to be produced.
  * @param nDstXSize Width of output window on destination file to be produced.
@@ -1018,127 +1199,153 @@ CPLErr GDALWarpOperation::ChunkAndWarpMulti(
     int nDstXOff, int nDstYOff,  int nDstXSize, int nDstYSize )
 
 {
-    hIOMutex = CPLCreateMutex();
-    hWarpMutex = CPLCreateMutex();
+    const int nChunksInFlight = std::max(2, std::min(64, atoi(
+        CSLFetchNameValueDef(psOptions->papszWarpOptions,
+                             "CHUNKS_IN_FLIGHT", "3"))));
+
+    GDALWarpChunkPipeline sPipeline;
+    sPipeline.hSrcIOMutex = CPLCreateMutex();
+    CPLReleaseMutex( sPipeline.hSrcIOMutex );
+    if( psOptions->hSrcDS == psOptions->hDstDS )
+    {
+        sPipeline.hDstIOMutex = sPipeline.hSrcIOMutex;
+    }
+    else
+    {
+        sPipeline.hDstIOMutex = CPLCreateMutex();
+        CPLReleaseMutex( sPipeline.hDstIOMutex );
+    }
+    sPipeline.hCondMutex = CPLCreateMutex();
+    CPLReleaseMutex( sPipeline.hCondMutex );
+    sPipeline.hCond = CPLCreateCond();
+    sPipeline.iNextChunkToWrite = 0;
+    sPipeline.bStop = false;
 
-    CPLReleaseMutex( hIOMutex );
+    hWarpMutex = CPLCreateMutex();
     CPLReleaseMutex( hWarpMutex );
 
-    CPLCond* hCond = CPLCreateCond();
-    CPLMutex* hCondMutex = CPLCreateMutex();
-    CPLReleaseMutex(hCondMutex);
+    psPipeline = &sPipeline;
 
 /* -------------------------------------------------------------------- */
 /*      Collect the list of chunks to operate on.                       */
 /* -------------------------------------------------------------------- */
     CollectChunkList( nDstXOff, nDstYOff, nDstXSize, nDstYSize );
 
+    GDALWarpSrcWindowCache sSrcWindowCache;
+    BeginSrcWindowCache( &sSrcWindowCache );
+
 /* -------------------------------------------------------------------- */
-/*      Process them one at a time, updating the progress               */
-/*      information for each region.                                    */
+/*      Launch a thread per chunk, with at most nChunksInFlight         */
+/*      threads alive at a time. Chunk iChunk uses the slot             */
+/*      iChunk % nChunksInFlight, once the chunk that used it before    */
+/*      has completed.                                                  */
 /* -------------------------------------------------------------------- */
-    ChunkThreadData volatile asThreadData[2] = {};
-    memset(reinterpret_cast<void*>(
-        const_cast<ChunkThreadData(*)[2]>(&asThreadData)), 0, sizeof(asThreadData));
-    asThreadData[0].poOperation = this;
-    asThreadData[0].hIOMutex = hIOMutex;
-    asThreadData[1].poOperation = this;
-    asThreadData[1].hIOMutex = hIOMutex;
+    std::vector<ChunkThreadData> asThreadData(nChunksInFlight);
+    for( int iThread = 0; iThread < nChunksInFlight; iThread++ )
+    {
+        asThreadData[iThread].poOperation = this;
+        asThreadData[iThread].psPipeline = &sPipeline;
+        asThreadData[iThread].pasChunkInfo = nullptr;
+        asThreadData[iThread].iChunk = -1;
+        asThreadData[iThread].hThreadHandle = nullptr;
+        asThreadData[iThread].eErr = CE_None;
+    }
 
     double dfPixelsProcessed = 0.0;
     double dfTotalPixels = static_cast<double>(nDstXSize)*nDstYSize;
 
     CPLErr eErr = CE_None;
-    for( int iChunk = 0; iChunk < nChunkListCount+1; iChunk++ )
+    for( int iChunk = 0;
+         pasChunkList != nullptr && iChunk < nChunkListCount; iChunk++ )
     {
-        int iThread = iChunk % 2;
+        ChunkThreadData& sData = asThreadData[iChunk % nChunksInFlight];
 
 /* -------------------------------------------------------------------- */
-/*      Launch thread for this chunk.                                   */
+/*      Wait for the previous chunk of this slot to complete.           */
 /* -------------------------------------------------------------------- */
-        if( pasChunkList != nullptr && iChunk < nChunkListCount )
+        if( sData.hThreadHandle != nullptr )
         {
-            GDALWarpChunk *pasThisChunk = pasChunkList + iChunk;
-            const double dfChunkPixels =
-                pasThisChunk->dsx * static_cast<double>(pasThisChunk->dsy);
-
-            asThreadData[iThread].dfProgressBase =
-                dfPixelsProcessed / dfTotalPixels;
-            asThreadData[iThread].dfProgressScale =
-                dfChunkPixels / dfTotalPixels;
-
-            dfPixelsProcessed += dfChunkPixels;
-
-            asThreadData[iThread].pasChunkInfo = pasThisChunk;
+            CPLJoinThread(sData.hThreadHandle);
+            sData.hThreadHandle = nullptr;
 
-            if( iChunk == 0 )
-            {
-                asThreadData[iThread].hCond = hCond;
-                asThreadData[iThread].hCondMutex = hCondMutex;
-            }
-            else
-            {
-                asThreadData[iThread].hCond = nullptr;
-                asThreadData[iThread].hCondMutex = nullptr;
-            }
-            asThreadData[iThread].bIOMutexTaken = FALSE;
+            CPLDebug( "GDAL", "Finished chunk %d.", sData.iChunk );
 
-            CPLDebug( "GDAL", "Start chunk %d.", iChunk );
-            asThreadData[iThread].hThreadHandle = CPLCreateJoinableThread(
-                ChunkThreadMain,
-                const_cast<ChunkThreadData *>(&asThreadData[iThread]));
-            if( asThreadData[iThread].hThreadHandle == nullptr )
-            {
-                CPLError(
-                    CE_Failure, CPLE_AppDefined,
-                    "CPLCreateJoinableThread() failed in ChunkAndWarpMulti()");
-                eErr = CE_Failure;
+            eErr = sData.eErr;
+            if( eErr != CE_None )
                 break;
-            }
-
-            // Wait that the first thread has acquired the IO mutex before
-            // proceeding.  This will ensure that the first thread will run
-            // before the second one.
-            if( iChunk == 0 )
-            {
-                CPLAcquireMutex(hCondMutex, 1.0);
-                while( asThreadData[iThread].bIOMutexTaken == FALSE )
-                    CPLCondWait(hCond, hCondMutex);
-                CPLReleaseMutex(hCondMutex);
-            }
         }
 
 /* -------------------------------------------------------------------- */
-/*      Wait for previous chunks thread to complete.                    */
+/*      Launch thread for this chunk.                                   */
 /* -------------------------------------------------------------------- */
-        if( iChunk > 0 )
-        {
-            iThread = (iChunk-1) % 2;
+        GDALWarpChunk *pasThisChunk = pasChunkList + iChunk;
+        const double dfChunkPixels =
+            pasThisChunk->dsx * static_cast<double>(pasThisChunk->dsy);
 
-            // Wait for thread to finish.
-            CPLJoinThread(asThreadData[iThread].hThreadHandle);
-            asThreadData[iThread].hThreadHandle = nullptr;
+        sData.dfProgressBase = dfPixelsProcessed / dfTotalPixels;
+        sData.dfProgressScale = dfChunkPixels / dfTotalPixels;
 
-            CPLDebug( "GDAL", "Finished chunk %d.", iChunk-1 );
+        dfPixelsProcessed += dfChunkPixels;
 
-            eErr = asThreadData[iThread].eErr;
+        sData.pasChunkInfo = pasThisChunk;
+        sData.iChunk = iChunk;
 
-            if( eErr != CE_None )
-                break;
+        CPLDebug( "GDAL", "Start chunk %d.", iChunk );
+        sData.hThreadHandle = CPLCreateJoinableThread(ChunkThreadMain, &sData);
+        if( sData.hThreadHandle == nullptr )
+        {
+            CPLError(
+                CE_Failure, CPLE_AppDefined,
+                "CPLCreateJoinableThread() failed in ChunkAndWarpMulti()");
+            eErr = CE_Failure;
+            break;
         }
     }
 
-    /* -------------------------------------------------------------------- */
-    /*      Wait for all threads to complete.                               */
-    /* -------------------------------------------------------------------- */
-    for( int iThread = 0; iThread < 2; iThread++ )
+/* -------------------------------------------------------------------- */
+/*      On failure, make sure that the chunks still waiting for their   */
+/*      turn to write abort.                                            */
+/* -------------------------------------------------------------------- */
+    if( eErr != CE_None )
+    {
+        CPLAcquireMutex( sPipeline.hCondMutex, 1000.0 );
+        sPipeline.bStop = true;
+        CPLCondBroadcast( sPipeline.hCond );
+        CPLReleaseMutex( sPipeline.hCondMutex );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Wait for all threads to complete, in chunk order.               */
+/* -------------------------------------------------------------------- */
+    std::vector<int> anSlots;
+    for( int iThread = 0; iThread < nChunksInFlight; iThread++ )
+        anSlots.push_back(iThread);
+    std::sort(anSlots.begin(), anSlots.end(),
+              [&asThreadData](int a, int b)
+              { return asThreadData[a].iChunk < asThreadData[b].iChunk; });
+    for( int iThread : anSlots )
     {
-        if( asThreadData[iThread].hThreadHandle )
-            CPLJoinThread(asThreadData[iThread].hThreadHandle);
+        ChunkThreadData& sData = asThreadData[iThread];
+        if( sData.hThreadHandle != nullptr )
+        {
+            CPLJoinThread(sData.hThreadHandle);
+            sData.hThreadHandle = nullptr;
+            CPLDebug( "GDAL", "Finished chunk %d.", sData.iChunk );
+            if( eErr == CE_None )
+                eErr = sData.eErr;
+        }
     }
 
-    CPLDestroyCond(hCond);
-    CPLDestroyMutex(hCondMutex);
+    EndSrcWindowCache();
+    psPipeline = nullptr;
+    CPLDestroyMutex( hWarpMutex );
+    hWarpMutex = nullptr;
+
+    CPLDestroyCond( sPipeline.hCond );
+    CPLDestroyMutex( sPipeline.hCondMutex );
+    if( sPipeline.hDstIOMutex != sPipeline.hSrcIOMutex )
+        CPLDestroyMutex( sPipeline.hDstIOMutex );
+    CPLDestroyMutex( sPipeline.hSrcIOMutex );
 
     WipeChunkList();
 
@@ -1389,6 +1596,112 @@ CPLErr GDALWarpOperation::CollectChunkListInternal(
     return CE_None;
 }
 
+/************************************************************************/
+/*                         AcquireSrcIOMutex()                          */
+/************************************************************************/
+
+// Serialize access to the source dataset when called from
+// ChunkAndWarpMulti(). No-op otherwise.
+bool GDALWarpOperation::AcquireSrcIOMutex()
+{
+    if( psPipeline != nullptr &&
+        !CPLAcquireMutex( psPipeline->hSrcIOMutex, 600.0 ) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Failed to acquire source IOMutex in WarpRegion()." );
+        return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                         ReleaseSrcIOMutex()                          */
+/************************************************************************/
+
+void GDALWarpOperation::ReleaseSrcIOMutex()
+{
+    if( psPipeline != nullptr )
+        CPLReleaseMutex( psPipeline->hSrcIOMutex );
+}
+
+/************************************************************************/
+/*                         AcquireDstIOMutex()                          */
+/************************************************************************/
+
+// Serialize access to the destination dataset when called from
+// ChunkAndWarpMulti(). No-op otherwise.
+bool GDALWarpOperation::AcquireDstIOMutex()
+{
+    if( psPipeline != nullptr &&
+        !CPLAcquireMutex( psPipeline->hDstIOMutex, 600.0 ) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Failed to acquire destination IOMutex in WarpRegion()." );
+        return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                         ReleaseDstIOMutex()                          */
+/************************************************************************/
+
+void GDALWarpOperation::ReleaseDstIOMutex()
+{
+    if( psPipeline != nullptr )
+        CPLReleaseMutex( psPipeline->hDstIOMutex );
+}
+
+/************************************************************************/
+/*                          WaitForWriteTurn()                          */
+/************************************************************************/
+
+// When called from ChunkAndWarpMulti(), wait until all the chunks before the
+// one of the passed destination window have been written, and acquire the
+// destination IO mutex. Returns false if another chunk has failed.
+bool GDALWarpOperation::WaitForWriteTurn( int nDstXOff, int nDstYOff,
+                                          int nDstXSize, int nDstYSize )
+{
+    if( psPipeline == nullptr )
+        return true;
+
+    CPLAcquireMutex( psPipeline->hCondMutex, 1000.0 );
+    while( !psPipeline->bStop &&
+           psPipeline->iNextChunkToWrite < nChunkListCount )
+    {
+        const GDALWarpChunk* psChunk =
+            pasChunkList + psPipeline->iNextChunkToWrite;
+        if( psChunk->dx == nDstXOff && psChunk->dy == nDstYOff &&
+            psChunk->dsx == nDstXSize && psChunk->dsy == nDstYSize )
+        {
+            break;
+        }
+        CPLCondWait( psPipeline->hCond, psPipeline->hCondMutex );
+    }
+    const bool bStop = psPipeline->bStop;
+    CPLReleaseMutex( psPipeline->hCondMutex );
+
+    return !bStop && AcquireDstIOMutex();
+}
+
+/************************************************************************/
+/*                            EndWriteTurn()                            */
+/************************************************************************/
+
+// Release the destination IO mutex and let the next chunk write.
+void GDALWarpOperation::EndWriteTurn()
+{
+    if( psPipeline == nullptr )
+        return;
+
+    ReleaseDstIOMutex();
+
+    CPLAcquireMutex( psPipeline->hCondMutex, 1000.0 );
+    psPipeline->iNextChunkToWrite++;
+    CPLCondBroadcast( psPipeline->hCond );
+    CPLReleaseMutex( psPipeline->hCondMutex );
+}
+
 /************************************************************************/
 /*                             WarpRegion()                             */
 /************************************************************************/
@@ -1498,6 +1811,12 @@ CPLErr GDALWarpOperation::WarpRegion( int nDstXOff, int nDstYOff,
     GDALDataset* poDstDS = reinterpret_cast<GDALDataset*>(psOptions->hDstDS);
     if( !bDstBufferInitialized )
     {
+        if( !AcquireDstIOMutex() )
+        {
+            DestroyDestinationBuffer(pDstBuffer);
+            return CE_Failure;
+        }
+
         CPLErr eErr = CE_None;
         if( psOptions->nBandCount == 1 )
         {
@@ -1522,6 +1841,8 @@ CPLErr GDALWarpOperation::WarpRegion( int nDstXOff, int nDstYOff,
                 0, 0, 0, nullptr);
         }
 
+        ReleaseDstIOMutex();
+
         if( eErr != CE_None )
         {
             DestroyDestinationBuffer(pDstBuffer);
@@ -1544,7 +1865,12 @@ CPLErr GDALWarpOperation::WarpRegion( int nDstXOff, int nDstYOff,
 /* -------------------------------------------------------------------- */
 /*      Write the output data back to disk if all went well.            */
 /* -------------------------------------------------------------------- */
-    if( eErr == CE_None )
+    if( eErr == CE_None &&
+        !WaitForWriteTurn(nDstXOff, nDstYOff, nDstXSize, nDstYSize) )
+    {
+        eErr = CE_Failure;
+    }
+    else if( eErr == CE_None )
     {
         if( psOptions->nBandCount == 1 )
         {
@@ -1579,6 +1905,8 @@ CPLErr GDALWarpOperation::WarpRegion( int nDstXOff, int nDstYOff,
                 eErr = CE_Failure;
         }
         ReportTiming( "Output buffer write" );
+
+        EndWriteTurn();
     }
 
 /* -------------------------------------------------------------------- */
@@ -1611,6 +1939,37 @@ CPLErr GDALWarpRegion( GDALWarpOperationH hOperation,
                     nSrcXOff, nSrcYOff, nSrcXSize, nSrcYSize);
 }
 
+/************************************************************************/
+/*                          GWOReadSrcWindow()                          */
+/************************************************************************/
+
+// Read a window of the source bands into a buffer of the working data type.
+static CPLErr GWOReadSrcWindow( const GDALWarpOptions* psOptions,
+                                int nXOff, int nYOff, int nXSize, int nYSize,
+                                GByte* pabyData,
+                                GSpacing nLineSpace, GSpacing nBandSpace )
+{
+    GDALDataset* poSrcDS = reinterpret_cast<GDALDataset*>(psOptions->hSrcDS);
+    const int nWordSize = GDALGetDataTypeSizeBytes(psOptions->eWorkingDataType);
+    if( psOptions->nBandCount == 1 )
+    {
+        // Particular case to simplify the stack a bit.
+        return poSrcDS->GetRasterBand(psOptions->panSrcBands[0])->RasterIO(
+                              GF_Read,
+                              nXOff, nYOff, nXSize, nYSize,
+                              pabyData, nXSize, nYSize,
+                              psOptions->eWorkingDataType,
+                              nWordSize, nLineSpace, nullptr );
+    }
+    return poSrcDS->RasterIO( GF_Read,
+                              nXOff, nYOff, nXSize, nYSize,
+                              pabyData, nXSize, nYSize,
+                              psOptions->eWorkingDataType,
+                              psOptions->nBandCount, psOptions->panSrcBands,
+                              nWordSize, nLineSpace, nBandSpace,
+                              nullptr );
+}
+
 /************************************************************************/
 /*                            WarpRegionToBuffer()                      */
 /************************************************************************/
@@ -1789,30 +2148,102 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
         oWK.papabySrcImage[i] = reinterpret_cast<GByte *>(oWK.papabySrcImage[0])
             + nWordSize * (nSrcXSize * nSrcYSize + WARP_EXTRA_ELTS) * i;
 
+/* -------------------------------------------------------------------- */
+/*      Acquire the source IO mutex for reading the source data and     */
+/*      masks.                                                          */
+/* -------------------------------------------------------------------- */
+    const bool bSrcIOMutexTaken = eErr == CE_None && AcquireSrcIOMutex();
+    if( !bSrcIOMutexTaken )
+        eErr = CE_Failure;
+
     if( eErr == CE_None && nSrcXSize > 0 && nSrcYSize > 0 )
     {
-        GDALDataset* poSrcDS =
-            reinterpret_cast<GDALDataset*>(psOptions->hSrcDS);
-        if( psOptions->nBandCount == 1 )
+        const GSpacing nLineSpace = static_cast<GSpacing>(nWordSize) *
+                                    nSrcXSize;
+        const GSpacing nBandSpace = static_cast<GSpacing>(nWordSize) *
+                                    (nSrcXSize * nSrcYSize + WARP_EXTRA_ELTS);
+        GDALWarpSrcWindowCache* psCache = psSrcWindowCache;
+        const int nXOverlapOff = psCache != nullptr ?
+            std::max(nSrcXOff, psCache->nXOff) : 0;
+        const int nYOverlapOff = psCache != nullptr ?
+            std::max(nSrcYOff, psCache->nYOff) : 0;
+        const int nXOverlapEnd = psCache != nullptr ?
+            std::min(nSrcXOff + nSrcXSize,
+                     psCache->nXOff + psCache->nXSize) : 0;
+        const int nYOverlapEnd = psCache != nullptr ?
+            std::min(nSrcYOff + nSrcYSize,
+                     psCache->nYOff + psCache->nYSize) : 0;
+
+        if( psCache != nullptr && psCache->pabyData != nullptr &&
+            nXOverlapOff < nXOverlapEnd && nYOverlapOff < nYOverlapEnd )
         {
-            // Particular case to simplify the stack a bit.
-            eErr = poSrcDS->GetRasterBand(psOptions->panSrcBands[0])->RasterIO(
-                                  GF_Read,
-                                  nSrcXOff, nSrcYOff, nSrcXSize, nSrcYSize,
-                                  oWK.papabySrcImage[0], nSrcXSize, nSrcYSize,
-                                  psOptions->eWorkingDataType,
-                                  0, 0, nullptr );
+/* -------------------------------------------------------------------- */
+/*      Copy the part of the source window already read for the         */
+/*      previous chunk, and read the (up to 4) remaining rectangles.    */
+/* -------------------------------------------------------------------- */
+            const GSpacing nCacheLineSpace =
+                static_cast<GSpacing>(nWordSize) * psCache->nXSize;
+            const GSpacing nCacheBandSpace = static_cast<GSpacing>(nWordSize) *
+                (psCache->nXSize * psCache->nYSize + WARP_EXTRA_ELTS);
+            const size_t nCopySize = static_cast<size_t>(nWordSize) *
+                                     (nXOverlapEnd - nXOverlapOff);
+            for( int iBand = 0; iBand < psOptions->nBandCount; iBand++ )
+            {
+                for( int iY = nYOverlapOff; iY < nYOverlapEnd; iY++ )
+                {
+                    memcpy(oWK.papabySrcImage[iBand] +
+                               (iY - nSrcYOff) * nLineSpace +
+                               (nXOverlapOff - nSrcXOff) * nWordSize,
+                           psCache->pabyData + iBand * nCacheBandSpace +
+                               (iY - psCache->nYOff) * nCacheLineSpace +
+                               (nXOverlapOff - psCache->nXOff) * nWordSize,
+                           nCopySize);
+                }
+            }
+
+            const int anRects[4][4] = {
+                // Above the overlap.
+                { nSrcXOff, nSrcYOff, nSrcXSize, nYOverlapOff - nSrcYOff },
+                // Below the overlap.
+                { nSrcXOff, nYOverlapEnd,
+                  nSrcXSize, nSrcYOff + nSrcYSize - nYOverlapEnd },
+                // Left of the overlap.
+                { nSrcXOff, nYOverlapOff,
+                  nXOverlapOff - nSrcXOff, nYOverlapEnd - nYOverlapOff },
+                // Right of the overlap.
+                { nXOverlapEnd, nYOverlapOff,
+                  nSrcXOff + nSrcXSize - nXOverlapEnd,
+                  nYOverlapEnd - nYOverlapOff } };
+            for( int i = 0; i < 4 && eErr == CE_None; i++ )
+            {
+                const int nRectXSize = anRects[i][2];
+                const int nRectYSize = anRects[i][3];
+                if( nRectXSize <= 0 || nRectYSize <= 0 )
+                    continue;
+                eErr = GWOReadSrcWindow(
+                    psOptions, anRects[i][0], anRects[i][1],
+                    nRectXSize, nRectYSize,
+                    oWK.papabySrcImage[0] +
+                        (anRects[i][1] - nSrcYOff) * nLineSpace +
+                        (anRects[i][0] - nSrcXOff) * nWordSize,
+                    nLineSpace, nBandSpace );
+                psCache->nPixelsRead +=
+                    static_cast<GIntBig>(nRectXSize) * nRectYSize;
+            }
         }
         else
         {
-            eErr = poSrcDS->RasterIO( GF_Read,
-                  nSrcXOff, nSrcYOff, nSrcXSize, nSrcYSize,
-                  oWK.papabySrcImage[0], nSrcXSize, nSrcYSize,
-                  psOptions->eWorkingDataType,
-                  psOptions->nBandCount, psOptions->panSrcBands,
-                  0, 0, nWordSize * (nSrcXSize * nSrcYSize + WARP_EXTRA_ELTS),
-                  nullptr );
+            eErr = GWOReadSrcWindow( psOptions, nSrcXOff, nSrcYOff,
+                                     nSrcXSize, nSrcYSize,
+                                     oWK.papabySrcImage[0],
+                                     nLineSpace, nBandSpace );
+            if( psCache != nullptr )
+                psCache->nPixelsRead +=
+                    static_cast<GIntBig>(nSrcXSize) * nSrcYSize;
         }
+        if( psCache != nullptr )
+            psCache->nPixelsNeeded +=
+                static_cast<GIntBig>(nSrcXSize) * nSrcYSize;
     }
 
     ReportTiming( "Input buffer read" );
@@ -1915,7 +2346,10 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
 
         eErr = CreateKernelMask( &oWK, i1, "DstDensity" );
 
-        if( eErr == CE_None )
+        if( eErr == CE_None && !AcquireDstIOMutex() )
+            eErr = CE_Failure;
+        else if( eErr == CE_None )
+        {
             eErr =
                 GDALWarpDstAlphaMasker( psOptions,
                                         psOptions->nBandCount,
@@ -1924,6 +2358,8 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
                                         oWK.nDstXSize, oWK.nDstYSize,
                                         oWK.papabyDstImage,
                                         TRUE, oWK.pafDstDensity );
+            ReleaseDstIOMutex();
+        }
     }
 
 /* -------------------------------------------------------------------- */
@@ -2120,16 +2556,19 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
     }
 
 /* -------------------------------------------------------------------- */
-/*      Release IO Mutex, and acquire warper mutex.                     */
+/*      Release source IO Mutex, and acquire warper mutex.              */
 /* -------------------------------------------------------------------- */
-    if( hIOMutex != nullptr )
+    if( bSrcIOMutexTaken )
+        ReleaseSrcIOMutex();
+    bool bWarpMutexTaken = false;
+    if( psPipeline != nullptr && eErr == CE_None )
     {
-        CPLReleaseMutex( hIOMutex );
-        if( !CPLAcquireMutex( hWarpMutex, 600.0 ) )
+        bWarpMutexTaken = CPL_TO_BOOL(CPLAcquireMutex( hWarpMutex, 600.0 ));
+        if( !bWarpMutexTaken )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
                       "Failed to acquire WarpMutex in WarpRegion()." );
-            return CE_Failure;
+            eErr = CE_Failure;
         }
     }
 
@@ -2157,32 +2596,52 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
             &oWK, psOptions->pPostWarpProcessorArg );
 
 /* -------------------------------------------------------------------- */
-/*      Release Warp Mutex, and acquire io mutex.                       */
+/*      Release Warp Mutex.                                             */
 /* -------------------------------------------------------------------- */
-    if( hIOMutex != nullptr )
-    {
+    if( bWarpMutexTaken )
         CPLReleaseMutex( hWarpMutex );
-        if( !CPLAcquireMutex( hIOMutex, 600.0 ) )
+
+/* -------------------------------------------------------------------- */
+/*      Write destination alpha if available.                           */
+/* -------------------------------------------------------------------- */
+    if( eErr == CE_None && psOptions->nDstAlphaBand > 0 )
+    {
+        if( !AcquireDstIOMutex() )
         {
-            CPLError( CE_Failure, CPLE_AppDefined,
-                      "Failed to acquire IOMutex in WarpRegion()." );
-            return CE_Failure;
+            eErr = CE_Failure;
+        }
+        else
+        {
+            eErr =
+                GDALWarpDstAlphaMasker( psOptions,
+                                        -psOptions->nBandCount,
+                                        psOptions->eWorkingDataType,
+                                        oWK.nDstXOff, oWK.nDstYOff,
+                                        oWK.nDstXSize, oWK.nDstYSize,
+                                        oWK.papabyDstImage,
+                                        TRUE, oWK.pafDstDensity );
+            ReleaseDstIOMutex();
         }
     }
 
 /* -------------------------------------------------------------------- */
-/*      Write destination alpha if available.                           */
+/*      Keep the source buffer for the next chunk, unless it may have   */
+/*      been altered by the application.                                */
 /* -------------------------------------------------------------------- */
-    if( eErr == CE_None && psOptions->nDstAlphaBand > 0 )
+    if( psSrcWindowCache != nullptr && eErr == CE_None &&
+        nSrcXSize > 0 && nSrcYSize > 0 &&
+        psOptions->pfnPreWarpChunkProcessor == nullptr &&
+        psOptions->pfnPostWarpChunkProcessor == nullptr &&
+        AcquireSrcIOMutex() )
     {
-        eErr =
-            GDALWarpDstAlphaMasker( psOptions,
-                                    -psOptions->nBandCount,
-                                    psOptions->eWorkingDataType,
-                                    oWK.nDstXOff, oWK.nDstYOff,
-                                    oWK.nDstXSize, oWK.nDstYSize,
-                                    oWK.papabyDstImage,
-                                    TRUE, oWK.pafDstDensity );
+        CPLFree( psSrcWindowCache->pabyData );
+        psSrcWindowCache->pabyData = oWK.papabySrcImage[0];
+        psSrcWindowCache->nXOff = nSrcXOff;
+        psSrcWindowCache->nYOff = nSrcYOff;
+        psSrcWindowCache->nXSize = nSrcXSize;
+        psSrcWindowCache->nYSize = nSrcYSize;
+        ReleaseSrcIOMutex();
+        oWK.papabySrcImage[0] = nullptr;
     }
 
 /* -------------------------------------------------------------------- */
@@ -35,7 +35,9 @@
 #include <string.h>
 
 #include <algorithm>
+#include <deque>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "gdal_alg_priv.h"
@@ -44,9 +46,12 @@
 #include "ogr_core.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_multiproc.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -261,6 +266,27 @@ void RPolygon::AddSegment( int x1, int y1, int x2, int y2 )
 /* ==================================================================== */
 /************************************************************************/
 
+/************************************************************************/
+/*                             GPEdgeKey()                              */
+/*                                                                      */
+/*      Polygons being formed only collect the unit pixel edges of      */
+/*      their boundary, each packed in a 64 bit key so that sorting     */
+/*      the keys restores the order in which they were found: by line,  */
+/*      then by column, the horizontal edge before the vertical one.    */
+/*      Merging two polygons is then a mere concatenation of their      */
+/*      edges, and the rings are only formed once the polygon is        */
+/*      complete.                                                       */
+/************************************************************************/
+
+typedef std::vector<GUIntBig> GPEdgeList;
+
+static GUIntBig GPEdgeKey( int iX, int iY, bool bVertical )
+{
+    return (static_cast<GUIntBig>(iY) << 32) |
+           (static_cast<GUIntBig>(iX) << 1) |
+           (bVertical ? 1U : 0U);
+}
+
 /************************************************************************/
 /*                              AddEdges()                              */
 /*                                                                      */
@@ -270,13 +296,11 @@ void RPolygon::AddSegment( int x1, int y1, int x2, int y2 )
 /*      other side of the edge.                                         */
 /************************************************************************/
 
-template<class DataType>
 static void AddEdges( GInt32 *panThisLineId, GInt32 *panLastLineId,
-                      GInt32 *panPolyIdMap, DataType *panPolyValue,
-                      RPolygon **papoPoly, int iX, int iY )
+                      GInt32 *panPolyIdMap,
+                      std::vector<GPEdgeList> &aoPolyEdges, int iX, int iY )
 
 {
-    // TODO(schwehr): Simplify these three vars.
     int nThisId = panThisLineId[iX];
     if( nThisId != -1 )
         nThisId = panPolyIdMap[nThisId];
@@ -287,68 +311,83 @@ static void AddEdges( GInt32 *panThisLineId, GInt32 *panLastLineId,
     if( nPreviousId != -1 )
         nPreviousId = panPolyIdMap[nPreviousId];
 
-    const int iXReal = iX - 1;
-
+    // Horizontal edge from (iX-1, iY) to (iX, iY).
     if( nThisId != nPreviousId )
     {
+        const GUIntBig nEdge = GPEdgeKey( iX, iY, false );
         if( nThisId != -1 )
-        {
-            if( papoPoly[nThisId] == nullptr )
-                papoPoly[nThisId] = new RPolygon( panPolyValue[nThisId] );
-
-            papoPoly[nThisId]->AddSegment( iXReal, iY, iXReal+1, iY );
-        }
+            aoPolyEdges[nThisId].push_back( nEdge );
         if( nPreviousId != -1 )
-        {
-            if( papoPoly[nPreviousId] == nullptr )
-                papoPoly[nPreviousId] = new RPolygon(panPolyValue[nPreviousId]);
-
-            papoPoly[nPreviousId]->AddSegment( iXReal, iY, iXReal+1, iY );
-        }
+            aoPolyEdges[nPreviousId].push_back( nEdge );
     }
 
+    // Vertical edge from (iX, iY) to (iX, iY+1).
     if( nThisId != nRightId )
     {
+        const GUIntBig nEdge = GPEdgeKey( iX, iY, true );
         if( nThisId != -1 )
-        {
-            if( papoPoly[nThisId] == nullptr )
-                papoPoly[nThisId] = new RPolygon(panPolyValue[nThisId]);
-
-            papoPoly[nThisId]->AddSegment( iXReal+1, iY, iXReal+1, iY+1 );
-        }
-
+            aoPolyEdges[nThisId].push_back( nEdge );
         if( nRightId != -1 )
-        {
-            if( papoPoly[nRightId] == nullptr )
-                papoPoly[nRightId] = new RPolygon(panPolyValue[nRightId]);
-
-            papoPoly[nRightId]->AddSegment( iXReal+1, iY, iXReal+1, iY+1 );
-        }
+            aoPolyEdges[nRightId].push_back( nEdge );
     }
 }
 
 /************************************************************************/
-/*                         EmitPolygonToLayer()                         */
+/*                          GPCompletedPolygon                          */
 /************************************************************************/
 
-static CPLErr
-EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
-                    RPolygon *poRPoly, double *padfGeoTransform )
+// A polygon that can no longer grow, waiting to be written.
+struct GPCompletedPolygon
+{
+    GIntBig      nId = 0;  // Scanline order id of its final fragment.
+    int          nLastLineUpdated = 0;
+    double       dfPolyValue = 0.0;
+    GPEdgeList   anEdges{};
+    OGRGeometryH hPolygon = nullptr;
+};
+
+/************************************************************************/
+/*                       GPBuildPolygonGeometry()                       */
+/*                                                                      */
+/*      Replay the edges of a complete polygon in the order they were   */
+/*      found, turn them into coherent rings, and create the polygon    */
+/*      geometry.  Does not use any shared state, so it can run in a    */
+/*      worker thread.                                                  */
+/************************************************************************/
+
+static OGRGeometryH
+GPBuildPolygonGeometry( GPCompletedPolygon *psPoly,
+                        const double *padfGeoTransform )
 
 {
+    std::sort( psPoly->anEdges.begin(), psPoly->anEdges.end() );
+
+    RPolygon oRPoly( psPoly->dfPolyValue );
+    for( size_t i = 0; i < psPoly->anEdges.size(); i++ )
+    {
+        const GUIntBig nEdge = psPoly->anEdges[i];
+        const int nY = static_cast<int>(nEdge >> 32);
+        const int nX = static_cast<int>((nEdge >> 1) & 0x7FFFFFFF);
+        if( nEdge & 1 )
+            oRPoly.AddSegment( nX, nY, nX, nY+1 );
+        else
+            oRPoly.AddSegment( nX-1, nY, nX, nY );
+    }
+    GPEdgeList().swap( psPoly->anEdges );
+
 /* -------------------------------------------------------------------- */
 /*      Turn bits of lines into coherent rings.                         */
 /* -------------------------------------------------------------------- */
-    poRPoly->Coalesce();
+    oRPoly.Coalesce();
 
 /* -------------------------------------------------------------------- */
 /*      Create the polygon geometry.                                    */
 /* -------------------------------------------------------------------- */
     OGRGeometryH hPolygon = OGR_G_CreateGeometry( wkbPolygon );
 
-    for( size_t iString = 0; iString < poRPoly->aanXY.size(); iString++ )
+    for( size_t iString = 0; iString < oRPoly.aanXY.size(); iString++ )
     {
-        std::vector<int> &anString = poRPoly->aanXY[iString];
+        std::vector<int> &anString = oRPoly.aanXY[iString];
         OGRGeometryH hRing = OGR_G_CreateGeometry( wkbLinearRing );
 
         // We go last to first to ensure the linestring is allocated to
@@ -375,15 +414,28 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
         OGR_G_AddGeometryDirectly( hPolygon, hRing );
     }
 
+    return hPolygon;
+}
+
+/************************************************************************/
+/*                         EmitPolygonToLayer()                         */
+/************************************************************************/
+
+static CPLErr
+EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
+                    GPCompletedPolygon *psPoly )
+
+{
 /* -------------------------------------------------------------------- */
 /*      Create the feature object.                                      */
 /* -------------------------------------------------------------------- */
     OGRFeatureH hFeat = OGR_F_Create( OGR_L_GetLayerDefn( hOutLayer ) );
 
-    OGR_F_SetGeometryDirectly( hFeat, hPolygon );
+    OGR_F_SetGeometryDirectly( hFeat, psPoly->hPolygon );
+    psPoly->hPolygon = nullptr;
 
     if( iPixValField >= 0 )
-        OGR_F_SetFieldDouble( hFeat, iPixValField, poRPoly->dfPolyValue );
+        OGR_F_SetFieldDouble( hFeat, iPixValField, psPoly->dfPolyValue );
 
 /* -------------------------------------------------------------------- */
 /*      Write the to the layer.                                         */
@@ -398,6 +450,264 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
     return eErr;
 }
 
+/************************************************************************/
+/*                            GPPolygonBatch                            */
+/************************************************************************/
+
+// Consecutive complete polygons, in the order they must be written.
+struct GPPolygonBatch
+{
+    std::vector<GPCompletedPolygon> aoPolygons{};
+    GUIntBig nEdgeCount = 0;
+    const double *padfGeoTransform = nullptr;
+    CPLMutex *hMutex = nullptr;
+    bool bFinished = false;
+
+    GPPolygonBatch() = default;
+    ~GPPolygonBatch()
+    {
+        for( size_t i = 0; i < aoPolygons.size(); i++ )
+        {
+            if( aoPolygons[i].hPolygon )
+                OGR_G_DestroyGeometry( aoPolygons[i].hPolygon );
+        }
+    }
+
+    CPL_DISALLOW_COPY_ASSIGN(GPPolygonBatch)
+};
+
+/************************************************************************/
+/*                     GPBuildBatchGeometriesFunc()                     */
+/************************************************************************/
+
+static void GPBuildBatchGeometriesFunc( void *pData )
+{
+    GPPolygonBatch *poBatch = static_cast<GPPolygonBatch *>(pData);
+    for( size_t i = 0; i < poBatch->aoPolygons.size(); i++ )
+    {
+        poBatch->aoPolygons[i].hPolygon =
+            GPBuildPolygonGeometry( &poBatch->aoPolygons[i],
+                                    poBatch->padfGeoTransform );
+    }
+
+    if( poBatch->hMutex )
+        CPLAcquireMutex( poBatch->hMutex, 1000.0 );
+    poBatch->bFinished = true;
+    if( poBatch->hMutex )
+        CPLReleaseMutex( poBatch->hMutex );
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                           GPPolygonWriter                            */
+/*                                                                      */
+/*      Writes complete polygons to the output layer in the order       */
+/*      they are added.  If GDAL_NUM_THREADS is set, the rings and      */
+/*      geometries of batches of polygons are formed by the global      */
+/*      worker threads, while the calling thread goes on with the       */
+/*      next lines and creates the features.                            */
+/* ==================================================================== */
+/************************************************************************/
+
+// Number of edges from which a batch is handed to a worker thread.
+constexpr GUIntBig knGPBatchEdgeCount = 256 * 1024;
+
+class GPPolygonWriter
+{
+    OGRLayerH       hOutLayer;
+    int             iPixValField;
+    const double   *padfGeoTransform;
+
+    std::unique_ptr<CPLJobQueue> poJobQueue{};
+    CPLMutex       *hMutex = nullptr;
+    size_t          nMaxBatches = 0;
+
+    // Batches submitted and not written yet, oldest first.
+    std::deque<GPPolygonBatch *> apoBatches{};
+    // Batch being filled.
+    GPPolygonBatch *poCurBatch = nullptr;
+
+    CPLErr          eErr = CE_None;
+
+    bool            IsBatchFinished( GPPolygonBatch *poBatch );
+    void            WriteOldestBatch();
+    void            SubmitCurrentBatch();
+
+    CPL_DISALLOW_COPY_ASSIGN(GPPolygonWriter)
+
+  public:
+    GPPolygonWriter( OGRLayerH hOutLayerIn, int iPixValFieldIn,
+                     const double *padfGeoTransformIn );
+    ~GPPolygonWriter();
+
+    CPLErr          AddPolygons( std::vector<GPCompletedPolygon> &aoPolygons );
+    CPLErr          Flush();
+};
+
+/************************************************************************/
+/*                          GPPolygonWriter()                           */
+/************************************************************************/
+
+GPPolygonWriter::GPPolygonWriter( OGRLayerH hOutLayerIn, int iPixValFieldIn,
+                                  const double *padfGeoTransformIn ) :
+    hOutLayer(hOutLayerIn),
+    iPixValField(iPixValFieldIn),
+    padfGeoTransform(padfGeoTransformIn)
+{
+    const int nThreads = GDALGetNumThreads();
+
+    if( nThreads > 1 )
+    {
+        poJobQueue = GDALCreateGlobalThreadPoolJobQueue(nThreads);
+        if( poJobQueue != nullptr )
+        {
+            CPLDebug("GDAL", "GDALPolygonize() using %d threads", nThreads);
+            hMutex = CPLCreateMutex();
+            CPLReleaseMutex(hMutex);
+            nMaxBatches = 2 * static_cast<size_t>(nThreads);
+        }
+    }
+}
+
+/************************************************************************/
+/*                          ~GPPolygonWriter()                          */
+/************************************************************************/
+
+GPPolygonWriter::~GPPolygonWriter()
+{
+    // Only happens on error: discard what was not written.
+    eErr = CE_Failure;
+    while( !apoBatches.empty() )
+        WriteOldestBatch();
+    delete poCurBatch;
+
+    poJobQueue.reset();
+    if( hMutex )
+        CPLDestroyMutex(hMutex);
+}
+
+/************************************************************************/
+/*                          IsBatchFinished()                           */
+/************************************************************************/
+
+bool GPPolygonWriter::IsBatchFinished( GPPolygonBatch *poBatch )
+{
+    if( hMutex == nullptr )
+        return poBatch->bFinished;
+    CPLAcquireMutex(hMutex, 1000.0);
+    const bool bFinished = poBatch->bFinished;
+    CPLReleaseMutex(hMutex);
+    return bFinished;
+}
+
+/************************************************************************/
+/*                          WriteOldestBatch()                          */
+/*                                                                      */
+/*      Wait for the geometries of the oldest batch to be formed, and   */
+/*      write its features, unless an error already occurred.          */
+/************************************************************************/
+
+void GPPolygonWriter::WriteOldestBatch()
+{
+    GPPolygonBatch *poBatch = apoBatches.front();
+    apoBatches.pop_front();
+
+    while( !IsBatchFinished(poBatch) )
+        poJobQueue->WaitEvent();
+
+    for( size_t i = 0; eErr == CE_None && i < poBatch->aoPolygons.size();
+         i++ )
+    {
+        eErr = EmitPolygonToLayer( hOutLayer, iPixValField,
+                                   &poBatch->aoPolygons[i] );
+    }
+
+    delete poBatch;
+}
+
+/************************************************************************/
+/*                         SubmitCurrentBatch()                         */
+/************************************************************************/
+
+void GPPolygonWriter::SubmitCurrentBatch()
+{
+    if( poCurBatch == nullptr )
+        return;
+
+    GPPolygonBatch *poBatch = poCurBatch;
+    poCurBatch = nullptr;
+    apoBatches.push_back(poBatch);
+
+    if( eErr != CE_None )
+    {
+        poBatch->bFinished = true;
+    }
+    else if( poJobQueue == nullptr ||
+             !poJobQueue->SubmitJob(GPBuildBatchGeometriesFunc, poBatch) )
+    {
+        GPBuildBatchGeometriesFunc(poBatch);
+    }
+
+    // Write the batches that are ready, and bound the number of batches
+    // kept in memory.
+    while( !apoBatches.empty() &&
+           (apoBatches.size() > nMaxBatches ||
+            IsBatchFinished(apoBatches.front())) )
+    {
+        WriteOldestBatch();
+    }
+}
+
+/************************************************************************/
+/*                            AddPolygons()                             */
+/*                                                                      */
+/*      Take ownership of the content of aoPolygons, which is emptied.  */
+/************************************************************************/
+
+CPLErr
+GPPolygonWriter::AddPolygons( std::vector<GPCompletedPolygon> &aoPolygons )
+{
+    if( aoPolygons.empty() )
+        return eErr;
+
+    if( poCurBatch == nullptr )
+    {
+        poCurBatch = new GPPolygonBatch();
+        poCurBatch->padfGeoTransform = padfGeoTransform;
+        poCurBatch->hMutex = hMutex;
+    }
+
+    for( size_t i = 0; i < aoPolygons.size(); i++ )
+    {
+        poCurBatch->nEdgeCount += aoPolygons[i].anEdges.size();
+        poCurBatch->aoPolygons.push_back( std::move(aoPolygons[i]) );
+    }
+    aoPolygons.clear();
+
+    if( poJobQueue == nullptr || poCurBatch->nEdgeCount >= knGPBatchEdgeCount )
+        SubmitCurrentBatch();
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                               Flush()                                */
+/************************************************************************/
+
+CPLErr GPPolygonWriter::Flush()
+{
+    SubmitCurrentBatch();
+    while( !apoBatches.empty() )
+        WriteOldestBatch();
+    return eErr;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*     End of GPPolygonWriter                                           */
+/* ==================================================================== */
+/************************************************************************/
+
 /************************************************************************/
 /*                          GPMaskImageData()                           */
 /*                                                                      */
@@ -407,28 +717,66 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
 
 template<class DataType>
 static CPLErr
-GPMaskImageData( GDALRasterBandH hMaskBand, GByte* pabyMaskLine,
-                 int iY, int nXSize,
-                 DataType *panImageLine )
+GPMaskImageData( GDALRasterBandH hMaskBand, GByte* pabyMaskLines,
+                 int iY, int nXSize, int nYCount,
+                 DataType *panImageLines )
 
 {
     const CPLErr eErr =
-        GDALRasterIO( hMaskBand, GF_Read, 0, iY, nXSize, 1,
-                      pabyMaskLine, nXSize, 1, GDT_Byte, 0, 0 );
+        GDALRasterIO( hMaskBand, GF_Read, 0, iY, nXSize, nYCount,
+                      pabyMaskLines, nXSize, nYCount, GDT_Byte, 0, 0 );
     if( eErr != CE_None )
         return eErr;
 
-    for( int i = 0; i < nXSize; i++ )
+    const size_t nCount = static_cast<size_t>(nXSize) * nYCount;
+    for( size_t i = 0; i < nCount; i++ )
     {
-        if( pabyMaskLine[i] == 0 )
-            panImageLine[i] = GP_NODATA_MARKER;
+        if( pabyMaskLines[i] == 0 )
+            panImageLines[i] = GP_NODATA_MARKER;
     }
 
     return CE_None;
 }
 
+/************************************************************************/
+/*                      GPTakeCompletedPolygons()                       */
+/*                                                                      */
+/*      Move the completed polygons not updated since nMaxLastLine      */
+/*      from aoCompleted to aoSelected, by increasing id.               */
+/************************************************************************/
+
+static void
+GPTakeCompletedPolygons( std::vector<GPCompletedPolygon> &aoCompleted,
+                         int nMaxLastLine,
+                         std::vector<GPCompletedPolygon> &aoSelected )
+{
+    size_t nKept = 0;
+    for( size_t i = 0; i < aoCompleted.size(); i++ )
+    {
+        if( aoCompleted[i].nLastLineUpdated <= nMaxLastLine )
+            aoSelected.push_back( std::move(aoCompleted[i]) );
+        else if( nKept++ != i )
+            aoCompleted[nKept - 1] = std::move(aoCompleted[i]);
+    }
+    aoCompleted.resize( nKept );
+
+    std::sort( aoSelected.begin(), aoSelected.end(),
+               [](const GPCompletedPolygon &a, const GPCompletedPolygon &b)
+               { return a.nId < b.nId; } );
+}
+
 /************************************************************************/
 /*                           GDALPolygonizeT()                          */
+/*                                                                      */
+/*      Single pass over the raster, by strips of lines.  Only the      */
+/*      polygons present on the last line are tracked, with the edges   */
+/*      collected so far, so that memory use is proportional to the     */
+/*      raster width and to the size of the polygons being formed.      */
+/*      Polygons that do not extend into the current line are           */
+/*      complete, and are written periodically, in the order of the     */
+/*      first fragment met of their final polygon id. This gives the    */
+/*      same output, features order included, as the former two pass    */
+/*      algorithm.                                                      */
 /************************************************************************/
 
 template<class DataType, class EqualityTest>
@@ -463,11 +811,22 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
     }
 
 /* -------------------------------------------------------------------- */
-/*      Allocate working buffers.                                       */
+/*      The raster is read by strips of about 256K pixels, aligned on   */
+/*      the blocks when they are not larger than that.                  */
 /* -------------------------------------------------------------------- */
     const int nXSize = GDALGetRasterBandXSize( hSrcBand );
     const int nYSize = GDALGetRasterBandYSize( hSrcBand );
 
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    GDALGetBlockSize( hSrcBand, &nBlockXSize, &nBlockYSize );
+    const int nStripYSize = GDALGetStripYSize(nXSize, nYSize, nBlockYSize);
+
+/* -------------------------------------------------------------------- */
+/*      Allocate working buffers.                                       */
+/* -------------------------------------------------------------------- */
+    DataType *panStripVal = static_cast<DataType *>(
+        VSI_MALLOC3_VERBOSE(sizeof(DataType), nXSize, nStripYSize));
     DataType *panLastLineVal = static_cast<DataType *>(
         VSI_MALLOC2_VERBOSE(sizeof(DataType), nXSize + 2));
     DataType *panThisLineVal = static_cast<DataType *>(
@@ -477,20 +836,22 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
     GInt32 *panThisLineId = static_cast<GInt32 *>(
         VSI_MALLOC2_VERBOSE(sizeof(GInt32), nXSize + 2));
 
-    GByte *pabyMaskLine =
+    GByte *pabyMaskStrip =
         hMaskBand != nullptr
-        ? static_cast<GByte *>(VSI_MALLOC_VERBOSE(nXSize))
+        ? static_cast<GByte *>(VSI_MALLOC2_VERBOSE(nXSize, nStripYSize))
         : nullptr;
 
-    if( panLastLineVal == nullptr || panThisLineVal == nullptr ||
+    if( panStripVal == nullptr ||
+        panLastLineVal == nullptr || panThisLineVal == nullptr ||
         panLastLineId == nullptr || panThisLineId == nullptr ||
-        (hMaskBand != nullptr && pabyMaskLine == nullptr) )
+        (hMaskBand != nullptr && pabyMaskStrip == nullptr) )
     {
         CPLFree( panThisLineId );
         CPLFree( panLastLineId );
         CPLFree( panThisLineVal );
         CPLFree( panLastLineVal );
-        CPLFree( pabyMaskLine );
+        CPLFree( panStripVal );
+        CPLFree( pabyMaskStrip );
         return CE_Failure;
     }
 
@@ -518,59 +879,6 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
             GDALGetGeoTransform( hSrcDS, adfGeoTransform );
     }
 
-/* -------------------------------------------------------------------- */
-/*      The first pass over the raster is only used to build up the     */
-/*      polygon id map so we will know in advance what polygons are     */
-/*      what on the second pass.                                        */
-/* -------------------------------------------------------------------- */
-    GDALRasterPolygonEnumeratorT<DataType,
-                                 EqualityTest> oFirstEnum(nConnectedness);
-
-    CPLErr eErr = CE_None;
-
-    for( int iY = 0; eErr == CE_None && iY < nYSize; iY++ )
-    {
-        eErr = GDALRasterIO(
-            hSrcBand,
-            GF_Read, 0, iY, nXSize, 1,
-            panThisLineVal, nXSize, 1, eDT, 0, 0 );
-
-        if( eErr == CE_None && hMaskBand != nullptr )
-            eErr = GPMaskImageData(hMaskBand, pabyMaskLine, iY, nXSize,
-                                   panThisLineVal);
-
-        if( iY == 0 )
-            oFirstEnum.ProcessLine(
-                nullptr, panThisLineVal, nullptr, panThisLineId, nXSize );
-        else
-            oFirstEnum.ProcessLine(
-                panLastLineVal, panThisLineVal,
-                panLastLineId,  panThisLineId,
-                nXSize );
-
-        // Swap lines.
-        std::swap(panLastLineVal, panThisLineVal);
-        std::swap(panLastLineId, panThisLineId);
-
-/* -------------------------------------------------------------------- */
-/*      Report progress, and support interrupts.                        */
-/* -------------------------------------------------------------------- */
-        if( eErr == CE_None
-            && !pfnProgress( 0.10 * ((iY+1) / static_cast<double>(nYSize)),
-                             "", pProgressArg ) )
-        {
-            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-            eErr = CE_Failure;
-        }
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Make a pass through the maps, ensuring every polygon id         */
-/*      points to the final id it should use, not an intermediate       */
-/*      value.                                                          */
-/* -------------------------------------------------------------------- */
-    oFirstEnum.CompleteMerges();
-
 /* -------------------------------------------------------------------- */
 /*      Initialize ids to -1 to serve as a nodata value for the         */
 /*      previous line, and past the beginning and end of the            */
@@ -583,18 +891,33 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
         panLastLineId[iX] = -1;
 
 /* -------------------------------------------------------------------- */
-/*      We will use a new enumerator for the second pass primarily      */
-/*      so we can preserve the first pass map.                          */
+/*      The enumerator only knows the polygons of the last line, with   */
+/*      ids in [0, nActivePolyCount[, and the fragments created on the  */
+/*      current line.  For each of them, we keep the order in which     */
+/*      its fragment was created over the whole raster, and the edges   */
+/*      collected so far when it is a final id.                         */
 /* -------------------------------------------------------------------- */
     GDALRasterPolygonEnumeratorT<DataType,
-                                 EqualityTest> oSecondEnum(nConnectedness);
-    RPolygon **papoPoly = static_cast<RPolygon **>(
-        CPLCalloc(sizeof(RPolygon*), oFirstEnum.nNextPolygonId));
+                                 EqualityTest> oEnum(nConnectedness);
+    int nActivePolyCount = 0;
+    GIntBig nNextPolyOrderId = 0;
+    std::vector<GIntBig> anPolyOrderId;
+    std::vector<GPEdgeList> aoPolyEdges;
+
+    std::vector<GInt32> anNewPolyId;
+    std::vector<GInt32> anKeptPolyIds;
+    std::vector<GIntBig> anKeptPolyOrderId;
+    std::vector<GPEdgeList> aoKeptPolyEdges;
+
+    std::vector<GPCompletedPolygon> aoCompleted;
+    std::vector<GPCompletedPolygon> aoToWrite;
+    GPPolygonWriter oWriter( hOutLayer, iPixValField, adfGeoTransform );
+
+    int nStripYOff = 0;
+    int nStripYCount = 0;
+
+    CPLErr eErr = CE_None;
 
-/* ==================================================================== */
-/*      Second pass during which we will actually collect polygon       */
-/*      edges as geometries.                                            */
-/* ==================================================================== */
     for( int iY = 0; eErr == CE_None && iY < nYSize+1; iY++ )
     {
 /* -------------------------------------------------------------------- */
@@ -602,20 +925,31 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
 /* -------------------------------------------------------------------- */
         if( iY < nYSize )
         {
-            eErr = GDALRasterIO( hSrcBand, GF_Read, 0, iY, nXSize, 1,
-                                 panThisLineVal, nXSize, 1, eDT, 0, 0 );
+            if( iY == nStripYOff + nStripYCount )
+            {
+                nStripYOff = iY;
+                nStripYCount = std::min(nStripYSize, nYSize - iY);
+                eErr = GDALRasterIO( hSrcBand, GF_Read,
+                                     0, nStripYOff, nXSize, nStripYCount,
+                                     panStripVal, nXSize, nStripYCount,
+                                     eDT, 0, 0 );
+
+                if( eErr == CE_None && hMaskBand != nullptr )
+                    eErr = GPMaskImageData( hMaskBand, pabyMaskStrip,
+                                            nStripYOff, nXSize, nStripYCount,
+                                            panStripVal );
+                if( eErr != CE_None )
+                    break;
+            }
 
-            if( eErr == CE_None && hMaskBand != nullptr )
-                eErr = GPMaskImageData( hMaskBand, pabyMaskLine, iY, nXSize,
-                                        panThisLineVal );
+            memcpy( panThisLineVal,
+                    panStripVal +
+                        static_cast<size_t>(iY - nStripYOff) * nXSize,
+                    sizeof(DataType) * nXSize );
         }
 
-        if( eErr != CE_None )
-            continue;
-
 /* -------------------------------------------------------------------- */
-/*      Determine what polygon the various pixels belong to (redoing    */
-/*      the same thing done in the first pass above).                   */
+/*      Determine what polygon the various pixels belong to.            */
 /* -------------------------------------------------------------------- */
         if( iY == nYSize )
         {
@@ -624,49 +958,112 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
         }
         else if( iY == 0 )
         {
-            oSecondEnum.ProcessLine(
+            oEnum.ProcessLine(
                 nullptr, panThisLineVal, nullptr, panThisLineId+1, nXSize );
         }
         else
         {
-            oSecondEnum.ProcessLine(
+            oEnum.ProcessLine(
                 panLastLineVal, panThisLineVal,
                 panLastLineId+1,  panThisLineId+1,
                 nXSize );
         }
 
+/* -------------------------------------------------------------------- */
+/*      Number the new fragments, and move the edges of the polygons    */
+/*      merged on this line to their final polygon.                     */
+/* -------------------------------------------------------------------- */
+        const int nPolyCount = oEnum.nNextPolygonId;
+        for( int iPoly = nActivePolyCount; iPoly < nPolyCount; iPoly++ )
+            anPolyOrderId.push_back( nNextPolyOrderId++ );
+        aoPolyEdges.resize( nPolyCount );
+
+        oEnum.ResolveMerges();
+        GInt32 *panPolyIdMap = oEnum.panPolyIdMap;
+
+        for( int iPoly = 0; iPoly < nActivePolyCount; iPoly++ )
+        {
+            const int nFinalId = panPolyIdMap[iPoly];
+            if( nFinalId == iPoly )
+                continue;
+
+            GPEdgeList &anDstEdges = aoPolyEdges[nFinalId];
+            GPEdgeList &anSrcEdges = aoPolyEdges[iPoly];
+            if( anDstEdges.size() < anSrcEdges.size() )
+                std::swap( anDstEdges, anSrcEdges );
+            anDstEdges.insert( anDstEdges.end(),
+                               anSrcEdges.begin(), anSrcEdges.end() );
+            GPEdgeList().swap( anSrcEdges );
+        }
+
 /* -------------------------------------------------------------------- */
 /*      Add polygon edges to our polygon list for the pixel             */
 /*      boundaries within and above this line.                          */
 /* -------------------------------------------------------------------- */
         for( int iX = 0; iX < nXSize+1; iX++ )
         {
-            AddEdges( panThisLineId, panLastLineId,
-                      oFirstEnum.panPolyIdMap, oFirstEnum.panPolyValue,
-                      papoPoly, iX, iY );
+            AddEdges( panThisLineId, panLastLineId, panPolyIdMap,
+                      aoPolyEdges, iX, iY );
         }
 
 /* -------------------------------------------------------------------- */
-/*      Periodically we scan out polygons and write out those that      */
-/*      haven't been added to on the last line as we can be sure        */
-/*      they are complete.                                              */
+/*      Only keep the polygons present on this line, renumbered in      */
+/*      order of appearance.  The other ones are complete.              */
 /* -------------------------------------------------------------------- */
-        if( iY % 8 == 7 )
+        anNewPolyId.assign( nPolyCount, -1 );
+        anKeptPolyIds.clear();
+        for( int iX = 1; iX < nXSize+1; iX++ )
         {
-            for( int iX = 0;
-                 eErr == CE_None && iX < oSecondEnum.nNextPolygonId;
-                 iX++ )
-            {
-                if( papoPoly[iX] && papoPoly[iX]->nLastLineUpdated < iY-1 )
-                {
-                    eErr =
-                        EmitPolygonToLayer( hOutLayer, iPixValField,
-                                            papoPoly[iX], adfGeoTransform );
+            if( panThisLineId[iX] == -1 )
+                continue;
 
-                    delete papoPoly[iX];
-                    papoPoly[iX] = nullptr;
-                }
+            const int nFinalId = panPolyIdMap[panThisLineId[iX]];
+            if( anNewPolyId[nFinalId] < 0 )
+            {
+                anNewPolyId[nFinalId] =
+                    static_cast<GInt32>(anKeptPolyIds.size());
+                anKeptPolyIds.push_back( nFinalId );
             }
+            panThisLineId[iX] = anNewPolyId[nFinalId];
+        }
+
+        for( int iPoly = 0; iPoly < nActivePolyCount; iPoly++ )
+        {
+            if( panPolyIdMap[iPoly] != iPoly || anNewPolyId[iPoly] >= 0 )
+                continue;
+
+            aoCompleted.push_back( GPCompletedPolygon() );
+            GPCompletedPolygon &oPoly = aoCompleted.back();
+            oPoly.nId = anPolyOrderId[iPoly];
+            oPoly.nLastLineUpdated = iY;
+            oPoly.dfPolyValue = oEnum.panPolyValue[iPoly];
+            std::swap( oPoly.anEdges, aoPolyEdges[iPoly] );
+        }
+
+        const int nKeptPolyCount = static_cast<int>(anKeptPolyIds.size());
+        anKeptPolyOrderId.resize( nKeptPolyCount );
+        aoKeptPolyEdges.clear();
+        aoKeptPolyEdges.resize( nKeptPolyCount );
+        for( int iPoly = 0; iPoly < nKeptPolyCount; iPoly++ )
+        {
+            anKeptPolyOrderId[iPoly] = anPolyOrderId[anKeptPolyIds[iPoly]];
+            std::swap( aoKeptPolyEdges[iPoly],
+                       aoPolyEdges[anKeptPolyIds[iPoly]] );
+        }
+        std::swap( anPolyOrderId, anKeptPolyOrderId );
+        std::swap( aoPolyEdges, aoKeptPolyEdges );
+
+        oEnum.KeepPolygons( anKeptPolyIds.data(), nKeptPolyCount );
+        nActivePolyCount = nKeptPolyCount;
+
+/* -------------------------------------------------------------------- */
+/*      Periodically we write out the complete polygons that haven't    */
+/*      been added to on the last line.                                 */
+/* -------------------------------------------------------------------- */
+        if( iY % 8 == 7 )
+        {
+            GPTakeCompletedPolygons( aoCompleted, iY - 2, aoToWrite );
+            eErr = oWriter.AddPolygons( aoToWrite );
         }
 
 /* -------------------------------------------------------------------- */
@@ -680,8 +1077,7 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
 /*      Report progress, and support interrupts.                        */
 /* -------------------------------------------------------------------- */
         if( eErr == CE_None
-            && !pfnProgress( 0.10 + 0.90 * ((iY + 1) /
-                                            static_cast<double>(nYSize)),
+            && !pfnProgress( (iY + 1) / static_cast<double>(nYSize + 1),
                              "", pProgressArg ) )
         {
             CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
@@ -690,18 +1086,14 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
     }
 
 /* -------------------------------------------------------------------- */
-/*      Make a cleanup pass for all unflushed polygons.                 */
+/*      Write all the remaining polygons.                               */
 /* -------------------------------------------------------------------- */
-    for( int iX = 0; eErr == CE_None && iX < oSecondEnum.nNextPolygonId; iX++ )
+    if( eErr == CE_None )
     {
-        if( papoPoly[iX] )
-        {
-            eErr = EmitPolygonToLayer( hOutLayer, iPixValField,
-                                       papoPoly[iX], adfGeoTransform );
-
-            delete papoPoly[iX];
-            papoPoly[iX] = nullptr;
-        }
+        GPTakeCompletedPolygons( aoCompleted, nYSize, aoToWrite );
+        eErr = oWriter.AddPolygons( aoToWrite );
+        if( eErr == CE_None )
+            eErr = oWriter.Flush();
     }
 
 /* -------------------------------------------------------------------- */
@@ -711,8 +1103,8 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
     CPLFree( panLastLineId );
     CPLFree( panThisLineVal );
     CPLFree( panLastLineVal );
-    CPLFree( pabyMaskLine );
-    CPLFree( papoPoly );
+    CPLFree( panStripVal );
+    CPLFree( pabyMaskStrip );
 
     return eErr;
 }
@@ -791,10 +1183,17 @@ GBool GDALFloatEquals( float A, float B )
  * do this when the layer is created, presumably matching the raster
  * coordinate system.
  *
- * The algorithm used attempts to minimize memory use so that very large
- * rasters can be processed.  However, if the raster has many polygons
- * or very large/complex polygons, the memory use for holding polygon
- * enumerations and active polygon geometries may grow to be quite large.
+ * The algorithm used makes a single pass over the raster and only keeps
+ * track of the polygons present on the current scanline, so that memory
+ * use is proportional to the raster width rather than to its area, and
+ * polygons are written to the output layer as they are completed.  However,
+ * if the raster has very large/complex polygons, the memory use for holding
+ * the edges of active polygons may grow to be quite large.
+ *
+ * Starting with GDAL 2.4, the GDAL_NUM_THREADS configuration option can be
+ * set to a number of threads or ALL_CPUS, so that the polygon geometries are
+ * formed by worker threads.  Features are written in the same order
+ * whatever the number of threads.
  *
  * The algorithm will generally produce very dense polygon geometries, with
  * edges that follow exactly on pixel boundaries for all non-interior pixels.
@@ -867,10 +1266,17 @@ GDALPolygonize( GDALRasterBandH hSrcBand,
  * do this when the layer is created, presumably matching the raster
  * coordinate system.
  *
- * The algorithm used attempts to minimize memory use so that very large
- * rasters can be processed.  However, if the raster has many polygons
- * or very large/complex polygons, the memory use for holding polygon
- * enumerations and active polygon geometries may grow to be quite large.
+ * The algorithm used makes a single pass over the raster and only keeps
+ * track of the polygons present on the current scanline, so that memory
+ * use is proportional to the raster width rather than to its area, and
+ * polygons are written to the output layer as they are completed.  However,
+ * if the raster has very large/complex polygons, the memory use for holding
+ * the edges of active polygons may grow to be quite large.
+ *
+ * Starting with GDAL 2.4, the GDAL_NUM_THREADS configuration option can be
+ * set to a number of threads or ALL_CPUS, so that the polygon geometries are
+ * formed by worker threads.  Features are written in the same order
+ * whatever the number of threads.
  *
  * The algorithm will generally produce very dense polygon geometries, with
  * edges that follow exactly on pixel boundaries for all non-interior pixels.
@@ -32,18 +32,23 @@
 #include "gdal_alg.h"
 
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -346,7 +351,7 @@ GDALMultiFilter( GDALRasterBandH hTargetBand,
 #define QUAD_CHECK(quad_dist, quad_value,                               \
 target_x, target_y, origin_x, origin_y, target_value )                  \
                                                                         \
-if( quad_value != nNoDataVal )                                          \
+if( target_y != nNoDataVal )                                            \
 {                                                                       \
     const double dfDx =                                                 \
         static_cast<double>(target_x) - static_cast<double>(origin_x);  \
@@ -362,6 +367,919 @@ if( quad_value != nNoDataVal )                                          \
     }                                                                   \
 }
 
+/************************************************************************/
+/*                         GDALFillNodataRunJobs()                      */
+/*                                                                      */
+/*      Run a job over the lines of a buffer, either in the calling     */
+/*      thread or split in worker threads.  Each job processes one      */
+/*      line every nLineStep lines, to balance the load of lines with   */
+/*      many pixels to interpolate.                                     */
+/************************************************************************/
+
+template<class T> static void
+GDALFillNodataRunJobs( CPLJobQueue *poJobQueue, int nThreads, int nLines,
+                       const T& sJobTemplate, CPLThreadFunc pfnFunc )
+{
+    const int nJobs = std::max(1, std::min(nThreads, nLines));
+    std::vector<T> asJobs(nJobs, sJobTemplate);
+    for( int i = 0; i < nJobs; i++ )
+    {
+        asJobs[i].iFirstLine = i;
+        asJobs[i].nLineStep = nJobs;
+        if( poJobQueue == nullptr ||
+            !poJobQueue->SubmitJob(pfnFunc, &asJobs[i]) )
+        {
+            pfnFunc(&asJobs[i]);
+        }
+    }
+    if( poJobQueue != nullptr )
+        poJobQueue->WaitCompletion();
+}
+
+/************************************************************************/
+/*                         GDALFillNodataSearchJob                      */
+/************************************************************************/
+
+struct GDALFillNodataSearchJob
+{
+    const GByte *pabyMask = nullptr;
+    float *pafScanline = nullptr;
+    GByte *pabyFiltMask = nullptr;
+    const GUInt32 *panTopDownY = nullptr;
+    const float *pafTopDownValue = nullptr;
+    // Has one more line than the others: the one below the strip.
+    const GUInt32 *panBottomUpY = nullptr;
+    const float *pafBottomUpValue = nullptr;
+    int nXSize = 0;
+    int iYOff = 0;
+    int nLines = 0;
+    double dfMaxSearchDist = 0.0;
+    GUInt32 nNoDataVal = 0;
+    int iFirstLine = 0;
+    int nLineStep = 1;
+};
+
+/************************************************************************/
+/*                       GDALFillNodataSearchLines()                    */
+/*                                                                      */
+/*      Interpolate the nodata pixels of lines of a strip from the      */
+/*      last valid value found in each column above (top-down pass)     */
+/*      and below (bottom-up pass).                                     */
+/************************************************************************/
+
+static void GDALFillNodataSearchLines( void *pData )
+{
+    const GDALFillNodataSearchJob *psJob =
+        static_cast<const GDALFillNodataSearchJob *>(pData);
+    const int nXSize = psJob->nXSize;
+    const double dfMaxSearchDist = psJob->dfMaxSearchDist;
+    const int nMaxSearchDist = static_cast<int>(floor(dfMaxSearchDist));
+    const GUInt32 nNoDataVal = psJob->nNoDataVal;
+
+    for( int iLine = psJob->iFirstLine; iLine < psJob->nLines;
+         iLine += psJob->nLineStep )
+    {
+        const int iY = psJob->iYOff + iLine;
+        const size_t nOffset = static_cast<size_t>(iLine) * nXSize;
+        const GByte *pabyMask = psJob->pabyMask + nOffset;
+        float *pafScanline = psJob->pafScanline + nOffset;
+        GByte *pabyFiltMask = psJob->pabyFiltMask + nOffset;
+        const GUInt32 *panTopDownY = psJob->panTopDownY + nOffset;
+        const float *pafTopDownValue = psJob->pafTopDownValue + nOffset;
+        // Bottom-up information of the next line.
+        const GUInt32 *panLastY = psJob->panBottomUpY + nOffset + nXSize;
+        const float *pafLastValue =
+            psJob->pafBottomUpValue + nOffset + nXSize;
+
+        memset( pabyFiltMask, 0, nXSize );
+        for( int iX = 0; iX < nXSize; iX++ )
+        {
+            int nThisMaxSearchDist = nMaxSearchDist;
+
+            // If this was a valid target - no change.
+            if( pabyMask[iX] )
+                continue;
+
+            // Quadrants 0:topleft, 1:bottomleft, 2:topright, 3:bottomright
+            double adfQuadDist[4] = {};
+            double adfQuadValue[4] = {};
+
+            for( int iQuad = 0; iQuad < 4; iQuad++ )
+            {
+                adfQuadDist[iQuad] = dfMaxSearchDist + 1.0;
+                adfQuadValue[iQuad] = 0.0;
+            }
+
+            // Step left and right by one pixel searching for the closest
+            // target value for each quadrant.
+            for( int iStep = 0; iStep < nThisMaxSearchDist; iStep++ )
+            {
+                const int iLeftX = std::max(0, iX - iStep);
+                const int iRightX = std::min(nXSize - 1, iX + iStep);
+
+                // Top left includes current line.
+                QUAD_CHECK(adfQuadDist[0], adfQuadValue[0],
+                           iLeftX, panTopDownY[iLeftX], iX, iY,
+                           pafTopDownValue[iLeftX] );
+
+                // Bottom left.
+                QUAD_CHECK(adfQuadDist[1], adfQuadValue[1],
+                           iLeftX, panLastY[iLeftX], iX, iY,
+                           pafLastValue[iLeftX] );
+
+                // Top right and bottom right do no include center pixel.
+                if( iStep == 0 )
+                     continue;
+
+                // Top right includes current line.
+                QUAD_CHECK(adfQuadDist[2], adfQuadValue[2],
+                           iRightX, panTopDownY[iRightX], iX, iY,
+                           pafTopDownValue[iRightX] );
+
+                // Bottom right.
+                QUAD_CHECK(adfQuadDist[3], adfQuadValue[3],
+                           iRightX, panLastY[iRightX], iX, iY,
+                           pafLastValue[iRightX] );
+
+                // Every four steps, recompute maximum distance.
+                if( (iStep & 0x3) == 0 )
+                    nThisMaxSearchDist = static_cast<int>(floor(
+                        std::max(std::max(adfQuadDist[0], adfQuadDist[1]),
+                                 std::max(adfQuadDist[2], adfQuadDist[3]))));
+            }
+
+            double dfWeightSum = 0.0;
+            double dfValueSum = 0.0;
+
+            for( int iQuad = 0; iQuad < 4; iQuad++ )
+            {
+                if( adfQuadDist[iQuad] <= dfMaxSearchDist )
+                {
+                    const double dfWeight = 1.0 / adfQuadDist[iQuad];
+
+                    dfWeightSum += dfWeight;
+                    dfValueSum += adfQuadValue[iQuad] * dfWeight;
+                }
+            }
+
+            if( dfWeightSum > 0.0 )
+            {
+                pabyFiltMask[iX] = 255;
+                pafScanline[iX] = static_cast<float>(dfValueSum / dfWeightSum);
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                          GDALFillNodataInvDist()                     */
+/*                                                                      */
+/*      Default algorithm: four quadrant search of the nearest valid    */
+/*      values, and inverse distance weighting of them.                 */
+/*                                                                      */
+/*      The raster is processed by strips of lines.  A first pass      */
+/*      from top to bottom collects the "last known value" above each   */
+/*      pixel of each column and writes it out to the work files.  A    */
+/*      second pass from bottom to top collects similar information     */
+/*      below each pixel, and uses it in combination with the top to    */
+/*      bottom information to interpolate the lines of the strip,       */
+/*      possibly in worker threads.                                     */
+/************************************************************************/
+
+static CPLErr
+GDALFillNodataInvDist( GDALRasterBandH hTargetBand,
+                       GDALRasterBandH hMaskBand,
+                       GDALRasterBandH hYBand,
+                       GDALRasterBandH hValBand,
+                       GDALRasterBandH hFiltMaskBand,
+                       double dfMaxSearchDist,
+                       GUInt32 nNoDataVal,
+                       CPLJobQueue *poJobQueue,
+                       int nThreads,
+                       double dfProgressRatio,
+                       GDALProgressFunc pfnProgress,
+                       void * pProgressArg )
+{
+    const int nXSize = GDALGetRasterBandXSize(hTargetBand);
+    const int nYSize = GDALGetRasterBandYSize(hTargetBand);
+
+/* -------------------------------------------------------------------- */
+/*      Allocate strips of about 256K pixels, with at least one line    */
+/*      per thread.                                                     */
+/* -------------------------------------------------------------------- */
+    const int nStripYSize = GDALGetStripYSize(nXSize, nYSize, 0, nThreads);
+    const size_t nStripPixels = static_cast<size_t>(nXSize) * nStripYSize;
+
+    GByte *pabyMask =
+        static_cast<GByte *>(VSI_MALLOC_VERBOSE(nStripPixels));
+    GByte *pabyFiltMask =
+        static_cast<GByte *>(VSI_MALLOC_VERBOSE(nStripPixels));
+    float *pafScanline = static_cast<float *>(
+        VSI_MALLOC2_VERBOSE(nStripPixels, sizeof(float)));
+    GUInt32 *panTopDownY = static_cast<GUInt32 *>(
+        VSI_MALLOC2_VERBOSE(nStripPixels, sizeof(GUInt32)));
+    float *pafTopDownValue = static_cast<float *>(
+        VSI_MALLOC2_VERBOSE(nStripPixels, sizeof(float)));
+    GUInt32 *panBottomUpY = static_cast<GUInt32 *>(
+        VSI_MALLOC2_VERBOSE(nStripPixels + nXSize, sizeof(GUInt32)));
+    float *pafBottomUpValue = static_cast<float *>(
+        VSI_MALLOC2_VERBOSE(nStripPixels + nXSize, sizeof(float)));
+
+    // Values of the line before (top-down) or after (bottom-up) the strip.
+    std::vector<GUInt32> anLastY(nXSize, nNoDataVal);
+    std::vector<float> afLastValue(nXSize, 0.0f);
+
+    CPLErr eErr = CE_None;
+
+    if( pabyMask == nullptr || pabyFiltMask == nullptr ||
+        pafScanline == nullptr || panTopDownY == nullptr ||
+        pafTopDownValue == nullptr || panBottomUpY == nullptr ||
+        pafBottomUpValue == nullptr )
+    {
+        eErr = CE_Failure;
+    }
+
+/* ==================================================================== */
+/*      Make first pass from top to bottom collecting the "last         */
+/*      known value" for each column and writing it out to the work     */
+/*      files.                                                          */
+/* ==================================================================== */
+    for( int iYOff = 0; eErr == CE_None && iYOff < nYSize;
+         iYOff += nStripYSize )
+    {
+        const int nLines = std::min(nStripYSize, nYSize - iYOff);
+
+/* -------------------------------------------------------------------- */
+/*      Read data and mask for this strip.                              */
+/* -------------------------------------------------------------------- */
+        eErr =
+            GDALRasterIO( hMaskBand, GF_Read, 0, iYOff, nXSize, nLines,
+                          pabyMask, nXSize, nLines, GDT_Byte, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        eErr =
+            GDALRasterIO( hTargetBand, GF_Read, 0, iYOff, nXSize, nLines,
+                          pafScanline, nXSize, nLines, GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+/* -------------------------------------------------------------------- */
+/*      Figure out the most recent pixel for each column.               */
+/* -------------------------------------------------------------------- */
+        for( int iLine = 0; iLine < nLines; iLine++ )
+        {
+            const int iY = iYOff + iLine;
+            const size_t nOffset = static_cast<size_t>(iLine) * nXSize;
+            const GUInt32 *panPrevY =
+                iLine > 0 ? panTopDownY + nOffset - nXSize : &anLastY[0];
+            const float *pafPrevValue =
+                iLine > 0 ? pafTopDownValue + nOffset - nXSize :
+                            &afLastValue[0];
+            GUInt32 *panThisY = panTopDownY + nOffset;
+            float *pafThisValue = pafTopDownValue + nOffset;
+
+            for( int iX = 0; iX < nXSize; iX++ )
+            {
+                if( pabyMask[nOffset + iX] )
+                {
+                    pafThisValue[iX] = pafScanline[nOffset + iX];
+                    panThisY[iX] = iY;
+                }
+                else if( iY <= dfMaxSearchDist + panPrevY[iX] )
+                {
+                    pafThisValue[iX] = pafPrevValue[iX];
+                    panThisY[iX] = panPrevY[iX];
+                }
+                else
+                {
+                    pafThisValue[iX] = 0.0f;
+                    panThisY[iX] = nNoDataVal;
+                }
+            }
+        }
+
+        const size_t nLastOffset = static_cast<size_t>(nLines - 1) * nXSize;
+        memcpy( &anLastY[0], panTopDownY + nLastOffset,
+                nXSize * sizeof(GUInt32) );
+        memcpy( &afLastValue[0], pafTopDownValue + nLastOffset,
+                nXSize * sizeof(float) );
+
+/* -------------------------------------------------------------------- */
+/*      Write out best index/value to working files.                    */
+/* -------------------------------------------------------------------- */
+        eErr = GDALRasterIO( hYBand, GF_Write, 0, iYOff, nXSize, nLines,
+                             panTopDownY, nXSize, nLines, GDT_UInt32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        eErr = GDALRasterIO( hValBand, GF_Write, 0, iYOff, nXSize, nLines,
+                             pafTopDownValue, nXSize, nLines,
+                             GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+/* -------------------------------------------------------------------- */
+/*      report progress.                                                */
+/* -------------------------------------------------------------------- */
+        if( !pfnProgress(
+                dfProgressRatio * (0.5*(iYOff+nLines) /
+                                   static_cast<double>(nYSize)),
+                "Filling...", pProgressArg ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+/* ==================================================================== */
+/*      Now we will do collect similar this/last information from       */
+/*      bottom to top and use it in combination with the top to         */
+/*      bottom search info to interpolate.                              */
+/*                                                                      */
+/*      The last line is interpolated with the top to bottom            */
+/*      information of the last line in place of the (non existing)     */
+/*      bottom to top information of the line below.                    */
+/* ==================================================================== */
+    GDALFillNodataSearchJob sJob;
+    sJob.pabyMask = pabyMask;
+    sJob.pafScanline = pafScanline;
+    sJob.pabyFiltMask = pabyFiltMask;
+    sJob.panTopDownY = panTopDownY;
+    sJob.pafTopDownValue = pafTopDownValue;
+    sJob.panBottomUpY = panBottomUpY;
+    sJob.pafBottomUpValue = pafBottomUpValue;
+    sJob.nXSize = nXSize;
+    sJob.dfMaxSearchDist = dfMaxSearchDist;
+    sJob.nNoDataVal = nNoDataVal;
+
+    const int nLastStripYOff = ((nYSize - 1) / nStripYSize) * nStripYSize;
+    for( int iYOff = nLastStripYOff; eErr == CE_None && iYOff >= 0;
+         iYOff -= nStripYSize )
+    {
+        const int nLines = std::min(nStripYSize, nYSize - iYOff);
+
+        eErr =
+            GDALRasterIO( hMaskBand, GF_Read, 0, iYOff, nXSize, nLines,
+                          pabyMask, nXSize, nLines, GDT_Byte, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        eErr =
+            GDALRasterIO( hTargetBand, GF_Read, 0, iYOff, nXSize, nLines,
+                          pafScanline, nXSize, nLines, GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+/* -------------------------------------------------------------------- */
+/*      Figure out the most recent pixel for each column.               */
+/* -------------------------------------------------------------------- */
+        const size_t nBelowOffset = static_cast<size_t>(nLines) * nXSize;
+        memcpy( panBottomUpY + nBelowOffset, &anLastY[0],
+                nXSize * sizeof(GUInt32) );
+        memcpy( pafBottomUpValue + nBelowOffset, &afLastValue[0],
+                nXSize * sizeof(float) );
+
+        for( int iLine = nLines - 1; iLine >= 0; iLine-- )
+        {
+            const int iY = iYOff + iLine;
+            const size_t nOffset = static_cast<size_t>(iLine) * nXSize;
+            const GUInt32 *panNextY = panBottomUpY + nOffset + nXSize;
+            const float *pafNextValue = pafBottomUpValue + nOffset + nXSize;
+            GUInt32 *panThisY = panBottomUpY + nOffset;
+            float *pafThisValue = pafBottomUpValue + nOffset;
+
+            for( int iX = 0; iX < nXSize; iX++ )
+            {
+                if( pabyMask[nOffset + iX] )
+                {
+                    pafThisValue[iX] = pafScanline[nOffset + iX];
+                    panThisY[iX] = iY;
+                }
+                else if( panNextY[iX] - iY <= dfMaxSearchDist )
+                {
+                    pafThisValue[iX] = pafNextValue[iX];
+                    panThisY[iX] = panNextY[iX];
+                }
+                else
+                {
+                    pafThisValue[iX] = 0.0f;
+                    panThisY[iX] = nNoDataVal;
+                }
+            }
+        }
+
+        memcpy( &anLastY[0], panBottomUpY, nXSize * sizeof(GUInt32) );
+        memcpy( &afLastValue[0], pafBottomUpValue, nXSize * sizeof(float) );
+
+/* -------------------------------------------------------------------- */
+/*      Load the last y and corresponding value from the top down pass. */
+/* -------------------------------------------------------------------- */
+        eErr =
+            GDALRasterIO( hYBand, GF_Read, 0, iYOff, nXSize, nLines,
+                          panTopDownY, nXSize, nLines, GDT_UInt32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        eErr =
+            GDALRasterIO( hValBand, GF_Read, 0, iYOff, nXSize, nLines,
+                          pafTopDownValue, nXSize, nLines,
+                          GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+/* -------------------------------------------------------------------- */
+/*      Attempt to interpolate any pixels that are nodata.              */
+/* -------------------------------------------------------------------- */
+        sJob.iYOff = iYOff;
+        sJob.nLines = nLines;
+        GDALFillNodataRunJobs( poJobQueue, nThreads, nLines, sJob,
+                               GDALFillNodataSearchLines );
+
+/* -------------------------------------------------------------------- */
+/*      Write out the updated data and mask information.                */
+/* -------------------------------------------------------------------- */
+        eErr =
+            GDALRasterIO( hTargetBand, GF_Write, 0, iYOff, nXSize, nLines,
+                          pafScanline, nXSize, nLines, GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        if( hFiltMaskBand != nullptr )
+        {
+            eErr =
+                GDALRasterIO( hFiltMaskBand, GF_Write,
+                              0, iYOff, nXSize, nLines,
+                              pabyFiltMask, nXSize, nLines, GDT_Byte, 0, 0 );
+            if( eErr != CE_None )
+                break;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      report progress.                                                */
+/* -------------------------------------------------------------------- */
+        if( !pfnProgress(
+                dfProgressRatio*(0.5+0.5*(nYSize-iYOff) /
+                                 static_cast<double>(nYSize)),
+                "Filling...", pProgressArg) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+    CPLFree(pabyMask);
+    CPLFree(pabyFiltMask);
+    CPLFree(pafScanline);
+    CPLFree(panTopDownY);
+    CPLFree(pafTopDownValue);
+    CPLFree(panBottomUpY);
+    CPLFree(pafBottomUpValue);
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                         GDALFillNodataPyramidJob                     */
+/************************************************************************/
+
+struct GDALFillNodataPyramidJob
+{
+    // Finer level, or a strip of lines of it.
+    float *pafValue = nullptr;
+    GByte *pabyValid = nullptr;
+    GByte *pabyFiltMask = nullptr;
+    int nXSize = 0;
+    int iYOff = 0;
+    int nLines = 0;
+    // Coarser level, or the lines of it covering the strip.
+    float *pafParentValue = nullptr;
+    GByte *pabyParentValid = nullptr;
+    int nParentXSize = 0;
+    int nParentYSize = 0;
+    int iParentYOff = 0;
+    int nParentLines = 0;
+    int iFirstLine = 0;
+    int nLineStep = 1;
+};
+
+/************************************************************************/
+/*                         GDALFillNodataPullLines()                    */
+/*                                                                      */
+/*      Compute lines of the coarser level as the average of the        */
+/*      valid pixels of the 2x2 pixels of the finer level they cover.   */
+/************************************************************************/
+
+static void GDALFillNodataPullLines( void *pData )
+{
+    const GDALFillNodataPyramidJob *psJob =
+        static_cast<const GDALFillNodataPyramidJob *>(pData);
+    const int nXSize = psJob->nXSize;
+
+    for( int iLine = psJob->iFirstLine; iLine < psJob->nParentLines;
+         iLine += psJob->nLineStep )
+    {
+        const int iParentY = psJob->iParentYOff + iLine;
+        const size_t nParentOffset =
+            static_cast<size_t>(iParentY) * psJob->nParentXSize;
+        const int iYStart = 2 * iParentY - psJob->iYOff;
+        const int iYEnd = std::min(iYStart + 2, psJob->nLines);
+
+        for( int iParentX = 0; iParentX < psJob->nParentXSize; iParentX++ )
+        {
+            const int iXEnd = std::min(2 * iParentX + 2, nXSize);
+            double dfValueSum = 0.0;
+            int nCount = 0;
+            for( int iY = iYStart; iY < iYEnd; iY++ )
+            {
+                const size_t nOffset = static_cast<size_t>(iY) * nXSize;
+                for( int iX = 2 * iParentX; iX < iXEnd; iX++ )
+                {
+                    if( psJob->pabyValid[nOffset + iX] )
+                    {
+                        dfValueSum += psJob->pafValue[nOffset + iX];
+                        nCount++;
+                    }
+                }
+            }
+            if( nCount > 0 )
+            {
+                psJob->pafParentValue[nParentOffset + iParentX] =
+                    static_cast<float>(dfValueSum / nCount);
+                psJob->pabyParentValid[nParentOffset + iParentX] = 1;
+            }
+            else
+            {
+                psJob->pafParentValue[nParentOffset + iParentX] = 0.0f;
+                psJob->pabyParentValid[nParentOffset + iParentX] = 0;
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                     GDALFillNodataGetParentIndices()                 */
+/*                                                                      */
+/*      Bilinear interpolation weights of the two coarser level         */
+/*      pixels around the center of a finer level pixel.                */
+/************************************************************************/
+
+static void GDALFillNodataGetParentIndices( int i, int nParentSize,
+                                            int anParent[2],
+                                            double adfWeight[2] )
+{
+    if( (i % 2) == 0 )
+    {
+        anParent[0] = i / 2 - 1;
+        adfWeight[0] = 0.25;
+        anParent[1] = i / 2;
+        adfWeight[1] = 0.75;
+    }
+    else
+    {
+        anParent[0] = i / 2;
+        adfWeight[0] = 0.75;
+        anParent[1] = i / 2 + 1;
+        adfWeight[1] = 0.25;
+    }
+    for( int j = 0; j < 2; j++ )
+    {
+        if( anParent[j] < 0 || anParent[j] >= nParentSize )
+        {
+            anParent[j] = 0;
+            adfWeight[j] = 0.0;
+        }
+    }
+}
+
+/************************************************************************/
+/*                         GDALFillNodataPushLines()                    */
+/*                                                                      */
+/*      Fill the invalid pixels of lines of the finer level by          */
+/*      bilinear interpolation of the valid pixels of the coarser       */
+/*      level.                                                          */
+/************************************************************************/
+
+static void GDALFillNodataPushLines( void *pData )
+{
+    const GDALFillNodataPyramidJob *psJob =
+        static_cast<const GDALFillNodataPyramidJob *>(pData);
+    const int nXSize = psJob->nXSize;
+    const int nParentXSize = psJob->nParentXSize;
+
+    for( int iLine = psJob->iFirstLine; iLine < psJob->nLines;
+         iLine += psJob->nLineStep )
+    {
+        const size_t nOffset = static_cast<size_t>(iLine) * nXSize;
+        int anParentY[2] = { 0, 0 };
+        double adfWeightY[2] = { 0.0, 0.0 };
+        GDALFillNodataGetParentIndices( psJob->iYOff + iLine,
+                                        psJob->nParentYSize,
+                                        anParentY, adfWeightY );
+
+        if( psJob->pabyFiltMask != nullptr )
+            memset( psJob->pabyFiltMask + nOffset, 0, nXSize );
+
+        for( int iX = 0; iX < nXSize; iX++ )
+        {
+            if( psJob->pabyValid[nOffset + iX] )
+                continue;
+
+            int anParentX[2] = { 0, 0 };
+            double adfWeightX[2] = { 0.0, 0.0 };
+            GDALFillNodataGetParentIndices( iX, nParentXSize,
+                                            anParentX, adfWeightX );
+
+            double dfValueSum = 0.0;
+            double dfWeightSum = 0.0;
+            for( int j = 0; j < 2; j++ )
+            {
+                const size_t nParentOffset =
+                    static_cast<size_t>(anParentY[j]) * nParentXSize;
+                for( int i = 0; i < 2; i++ )
+                {
+                    const double dfWeight = adfWeightY[j] * adfWeightX[i];
+                    if( dfWeight > 0.0 &&
+                        psJob->pabyParentValid[nParentOffset + anParentX[i]] )
+                    {
+                        dfValueSum += dfWeight *
+                            psJob->pafParentValue[nParentOffset +
+                                                  anParentX[i]];
+                        dfWeightSum += dfWeight;
+                    }
+                }
+            }
+
+            if( dfWeightSum > 0.0 )
+            {
+                psJob->pafValue[nOffset + iX] =
+                    static_cast<float>(dfValueSum / dfWeightSum);
+                psJob->pabyValid[nOffset + iX] = 1;
+                if( psJob->pabyFiltMask != nullptr )
+                    psJob->pabyFiltMask[nOffset + iX] = 255;
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                          GDALFillNodataPyramid()                     */
+/*                                                                      */
+/*      Pyramid ("pull-push") interpolation.  A pyramid of coarser      */
+/*      levels is built by averaging the valid pixels of each 2x2       */
+/*      block of the finer level.  The invalid pixels of each level     */
+/*      are then filled from the coarsest to the finest level by        */
+/*      bilinear interpolation of the coarser level, so that the cost   */
+/*      does not depend on the size of the areas to fill.               */
+/*                                                                      */
+/*      The full resolution raster is processed by strips of lines,     */
+/*      and the coarser levels are kept in memory.                      */
+/************************************************************************/
+
+static CPLErr
+GDALFillNodataPyramid( GDALRasterBandH hTargetBand,
+                       GDALRasterBandH hMaskBand,
+                       GDALRasterBandH hFiltMaskBand,
+                       double dfMaxSearchDist,
+                       CPLJobQueue *poJobQueue,
+                       int nThreads,
+                       double dfProgressRatio,
+                       GDALProgressFunc pfnProgress,
+                       void * pProgressArg )
+{
+    const int nXSize = GDALGetRasterBandXSize(hTargetBand);
+    const int nYSize = GDALGetRasterBandYSize(hTargetBand);
+
+/* -------------------------------------------------------------------- */
+/*      Allocate the coarser levels, until their pixels are as large    */
+/*      as the maximum search distance.                                 */
+/* -------------------------------------------------------------------- */
+    struct GDALFillNodataLevel
+    {
+        int nXSize;
+        int nYSize;
+        float *pafValue;
+        GByte *pabyValid;
+    };
+    std::vector<GDALFillNodataLevel> asLevels;
+
+    CPLErr eErr = CE_None;
+    int nLevelXSize = nXSize;
+    int nLevelYSize = nYSize;
+    double dfPixelSize = 1.0;
+    while( (nLevelXSize > 1 || nLevelYSize > 1) &&
+           (asLevels.empty() || dfPixelSize < dfMaxSearchDist) )
+    {
+        nLevelXSize = (nLevelXSize + 1) / 2;
+        nLevelYSize = (nLevelYSize + 1) / 2;
+        dfPixelSize *= 2;
+
+        GDALFillNodataLevel sLevel;
+        sLevel.nXSize = nLevelXSize;
+        sLevel.nYSize = nLevelYSize;
+        sLevel.pafValue = static_cast<float *>(
+            VSI_MALLOC3_VERBOSE(nLevelXSize, nLevelYSize, sizeof(float)));
+        sLevel.pabyValid = static_cast<GByte *>(
+            VSI_MALLOC2_VERBOSE(nLevelXSize, nLevelYSize));
+        asLevels.push_back(sLevel);
+        if( sLevel.pafValue == nullptr || sLevel.pabyValid == nullptr )
+        {
+            eErr = CE_Failure;
+            break;
+        }
+    }
+    CPLDebug( "GDAL", "GDALFillNodata(): %d pyramid levels",
+              static_cast<int>(asLevels.size()) );
+
+    // Single pixel raster: nothing to interpolate from.
+    if( asLevels.empty() )
+        return CE_None;
+
+/* -------------------------------------------------------------------- */
+/*      Allocate strips of about 256K pixels, with at least one line    */
+/*      per thread, and an even number of lines.                        */
+/* -------------------------------------------------------------------- */
+    const int nStripYSize =
+        GDALGetStripYSize(nXSize, nYSize + 1, 0, std::max(2, nThreads)) & ~1;
+    const size_t nStripPixels = static_cast<size_t>(nXSize) * nStripYSize;
+
+    GByte *pabyMask =
+        static_cast<GByte *>(VSI_MALLOC_VERBOSE(nStripPixels));
+    GByte *pabyFiltMask =
+        static_cast<GByte *>(VSI_MALLOC_VERBOSE(nStripPixels));
+    float *pafScanline = static_cast<float *>(
+        VSI_MALLOC2_VERBOSE(nStripPixels, sizeof(float)));
+    if( pabyMask == nullptr || pabyFiltMask == nullptr ||
+        pafScanline == nullptr )
+    {
+        eErr = CE_Failure;
+    }
+
+/* ==================================================================== */
+/*      Build the first coarser level from strips of the raster.        */
+/* ==================================================================== */
+    GDALFillNodataPyramidJob sJob;
+    for( int iYOff = 0; eErr == CE_None && iYOff < nYSize;
+         iYOff += nStripYSize )
+    {
+        const int nLines = std::min(nStripYSize, nYSize - iYOff);
+
+        eErr =
+            GDALRasterIO( hMaskBand, GF_Read, 0, iYOff, nXSize, nLines,
+                          pabyMask, nXSize, nLines, GDT_Byte, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        eErr =
+            GDALRasterIO( hTargetBand, GF_Read, 0, iYOff, nXSize, nLines,
+                          pafScanline, nXSize, nLines, GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        sJob.pafValue = pafScanline;
+        sJob.pabyValid = pabyMask;
+        sJob.nXSize = nXSize;
+        sJob.iYOff = iYOff;
+        sJob.nLines = nLines;
+        sJob.pafParentValue = asLevels[0].pafValue;
+        sJob.pabyParentValid = asLevels[0].pabyValid;
+        sJob.nParentXSize = asLevels[0].nXSize;
+        sJob.nParentYSize = asLevels[0].nYSize;
+        sJob.iParentYOff = iYOff / 2;
+        sJob.nParentLines = (nLines + 1) / 2;
+        GDALFillNodataRunJobs( poJobQueue, nThreads, sJob.nParentLines, sJob,
+                               GDALFillNodataPullLines );
+
+        if( !pfnProgress(
+                dfProgressRatio * (0.4*(iYOff+nLines) /
+                                   static_cast<double>(nYSize)),
+                "Filling...", pProgressArg ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+/* ==================================================================== */
+/*      Build the other coarser levels, and then fill them back from    */
+/*      the coarsest one.                                               */
+/* ==================================================================== */
+    const int nLevels = static_cast<int>(asLevels.size());
+    for( int iLevel = 1; eErr == CE_None && iLevel < nLevels; iLevel++ )
+    {
+        const GDALFillNodataLevel &sLevel = asLevels[iLevel - 1];
+        const GDALFillNodataLevel &sParent = asLevels[iLevel];
+        sJob.pafValue = sLevel.pafValue;
+        sJob.pabyValid = sLevel.pabyValid;
+        sJob.nXSize = sLevel.nXSize;
+        sJob.iYOff = 0;
+        sJob.nLines = sLevel.nYSize;
+        sJob.pafParentValue = sParent.pafValue;
+        sJob.pabyParentValid = sParent.pabyValid;
+        sJob.nParentXSize = sParent.nXSize;
+        sJob.nParentYSize = sParent.nYSize;
+        sJob.iParentYOff = 0;
+        sJob.nParentLines = sParent.nYSize;
+        GDALFillNodataRunJobs( poJobQueue, nThreads, sJob.nParentLines, sJob,
+                               GDALFillNodataPullLines );
+    }
+
+    for( int iLevel = nLevels - 2; eErr == CE_None && iLevel >= 0; iLevel-- )
+    {
+        const GDALFillNodataLevel &sLevel = asLevels[iLevel];
+        const GDALFillNodataLevel &sParent = asLevels[iLevel + 1];
+        sJob.pafValue = sLevel.pafValue;
+        sJob.pabyValid = sLevel.pabyValid;
+        sJob.pabyFiltMask = nullptr;
+        sJob.nXSize = sLevel.nXSize;
+        sJob.iYOff = 0;
+        sJob.nLines = sLevel.nYSize;
+        sJob.pafParentValue = sParent.pafValue;
+        sJob.pabyParentValid = sParent.pabyValid;
+        sJob.nParentXSize = sParent.nXSize;
+        sJob.nParentYSize = sParent.nYSize;
+        GDALFillNodataRunJobs( poJobQueue, nThreads, sJob.nLines, sJob,
+                               GDALFillNodataPushLines );
+    }
+
+    if( eErr == CE_None &&
+        !pfnProgress( dfProgressRatio * 0.5, "Filling...", pProgressArg ) )
+    {
+        CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        eErr = CE_Failure;
+    }
+
+/* ==================================================================== */
+/*      Fill the strips of the raster from the first coarser level.     */
+/* ==================================================================== */
+    for( int iYOff = 0; eErr == CE_None && iYOff < nYSize;
+         iYOff += nStripYSize )
+    {
+        const int nLines = std::min(nStripYSize, nYSize - iYOff);
+
+        eErr =
+            GDALRasterIO( hMaskBand, GF_Read, 0, iYOff, nXSize, nLines,
+                          pabyMask, nXSize, nLines, GDT_Byte, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        eErr =
+            GDALRasterIO( hTargetBand, GF_Read, 0, iYOff, nXSize, nLines,
+                          pafScanline, nXSize, nLines, GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        sJob.pafValue = pafScanline;
+        sJob.pabyValid = pabyMask;
+        sJob.pabyFiltMask = pabyFiltMask;
+        sJob.nXSize = nXSize;
+        sJob.iYOff = iYOff;
+        sJob.nLines = nLines;
+        sJob.pafParentValue = asLevels[0].pafValue;
+        sJob.pabyParentValid = asLevels[0].pabyValid;
+        sJob.nParentXSize = asLevels[0].nXSize;
+        sJob.nParentYSize = asLevels[0].nYSize;
+        GDALFillNodataRunJobs( poJobQueue, nThreads, nLines, sJob,
+                               GDALFillNodataPushLines );
+
+        eErr =
+            GDALRasterIO( hTargetBand, GF_Write, 0, iYOff, nXSize, nLines,
+                          pafScanline, nXSize, nLines, GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        if( hFiltMaskBand != nullptr )
+        {
+            eErr =
+                GDALRasterIO( hFiltMaskBand, GF_Write,
+                              0, iYOff, nXSize, nLines,
+                              pabyFiltMask, nXSize, nLines, GDT_Byte, 0, 0 );
+            if( eErr != CE_None )
+                break;
+        }
+
+        if( !pfnProgress(
+                dfProgressRatio*(0.5+0.5*(iYOff+nLines) /
+                                 static_cast<double>(nYSize)),
+                "Filling...", pProgressArg) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+    for( size_t i = 0; i < asLevels.size(); i++ )
+    {
+        CPLFree( asLevels[i].pafValue );
+        CPLFree( asLevels[i].pabyValid );
+    }
+    CPLFree(pabyMask);
+    CPLFree(pabyFiltMask);
+    CPLFree(pafScanline);
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                           GDALFillNodata()                           */
 /************************************************************************/
@@ -384,6 +1302,19 @@ if( quad_value != nNoDataVal )                                          \
  * is generally not so great for interpolating a raster from sparse
  * point data - see the algorithms defined in gdal_grid.h for that case.
  *
+ * The cost of the conic search grows with the size of the regions to
+ * fill.  Starting with GDAL 2.4, the ALGORITHM=PYRAMID option selects
+ * an alternate algorithm, better suited to large regions: a pyramid of
+ * coarser resolution levels is built by averaging the valid pixels, and
+ * the nodata pixels of each level are filled by bilinear interpolation of
+ * the coarser level, from the coarsest to the full resolution.  In that
+ * mode, dfMaxSearchDist limits the size of the pixels of the coarsest
+ * level, so pixels up to about twice that distance may be filled.
+ *
+ * The interpolation of strips of lines is split in as many jobs as
+ * specified by the GDAL_NUM_THREADS configuration option (default 1, or
+ * ALL_CPUS).
+ *
  * @param hTargetBand the raster band to be modified in place.
  * @param hMaskBand a mask band indicating pixels to be interpolated
  * (zero valued).
@@ -393,7 +1324,8 @@ if( quad_value != nNoDataVal )                                          \
  * @param nSmoothingIterations the number of 3x3 smoothing filter passes to
  * run (0 or more).
  * @param papszOptions additional name=value options in a string list (the
- * temporary file driver can be specified like TEMP_FILE_DRIVER=MEM).
+ * temporary file driver can be specified like TEMP_FILE_DRIVER=MEM, and
+ * the algorithm like ALGORITHM=[INV_DIST]/PYRAMID).
  * @param pfnProgress the progress function to report completion.
  * @param pProgressArg callback data for progress function.
  *
@@ -419,8 +1351,6 @@ GDALFillNodata( GDALRasterBandH hTargetBand,
     if( dfMaxSearchDist == 0.0 )
         dfMaxSearchDist = std::max(nXSize, nYSize) + 1;
 
-    const int nMaxSearchDist = static_cast<int>(floor(dfMaxSearchDist));
-
     // Special "x" pixel values identifying pixels as special.
     GDALDataType eType = GDT_UInt16;
     GUInt32 nNoDataVal = 65535;
@@ -434,6 +1364,16 @@ GDALFillNodata( GDALRasterBandH hTargetBand,
     if( hMaskBand == nullptr )
         hMaskBand = GDALGetMaskBand( hTargetBand );
 
+    const char *pszAlgorithm =
+        CSLFetchNameValueDef( papszOptions, "ALGORITHM", "INV_DIST" );
+    const bool bPyramid = EQUAL(pszAlgorithm, "PYRAMID");
+    if( !bPyramid && !EQUAL(pszAlgorithm, "INV_DIST") )
+    {
+        CPLError( CE_Failure, CPLE_NotSupported,
+                  "Unsupported ALGORITHM=%s", pszAlgorithm );
+        return CE_Failure;
+    }
+
     // If there are smoothing iterations, reserve 10% of the progress for them.
     const double dfProgressRatio = nSmoothingIterations > 0 ? 0.9 : 1.0;
 
@@ -479,359 +1419,107 @@ GDALFillNodata( GDALRasterBandH hTargetBand,
                 papszWorkFileOptions, "BIGTIFF", "IF_SAFER");
     }
 
-/* -------------------------------------------------------------------- */
-/*      Create a work file to hold the Y "last value" indices.          */
-/* -------------------------------------------------------------------- */
     const CPLString osTmpFile = CPLGenerateTempFilename("");
     const CPLString osYTmpFile = osTmpFile + "fill_y_work.tif";
+    const CPLString osValTmpFile = osTmpFile + "fill_val_work.tif";
+    const CPLString osFiltMaskTmpFile = osTmpFile + "fill_filtmask_work.tif";
 
-    GDALDatasetH hYDS =
-        GDALCreate( hDriver, osYTmpFile, nXSize, nYSize, 1,
-                    eType, papszWorkFileOptions );
-
-    if( hYDS == nullptr )
-    {
-        CPLError(
-            CE_Failure, CPLE_AppDefined,
-            "Could not create Y index work file. Check driver capabilities.");
-        return CE_Failure;
-    }
+    GDALDatasetH hYDS = nullptr;
+    GDALDatasetH hValDS = nullptr;
+    GDALDatasetH hFiltMaskDS = nullptr;
+    GDALRasterBandH hFiltMaskBand = nullptr;
 
-    GDALRasterBandH hYBand = GDALGetRasterBand( hYDS, 1 );
+    CPLErr eErr = CE_None;
 
 /* -------------------------------------------------------------------- */
-/*      Create a work file to hold the pixel value associated with      */
-/*      the "last xy value" pixel.                                      */
+/*      Worker threads.                                                 */
 /* -------------------------------------------------------------------- */
-    const CPLString osValTmpFile = osTmpFile + "fill_val_work.tif";
-
-    GDALDatasetH hValDS =
-        GDALCreate( hDriver, osValTmpFile, nXSize, nYSize, 1,
-                    GDALGetRasterDataType( hTargetBand ),
-                    papszWorkFileOptions );
+    int nThreads = GDALGetNumThreads();
 
-    if( hValDS == nullptr )
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    if( nThreads > 1 )
     {
-        CPLError(CE_Failure, CPLE_AppDefined,
-            "Could not create XY value work file. Check driver capabilities.");
-        return CE_Failure;
+        poJobQueue = GDALCreateGlobalThreadPoolJobQueue(nThreads);
+        if( poJobQueue == nullptr )
+            nThreads = 1;
+        else
+            CPLDebug("GDAL", "GDALFillNodata() using %d threads", nThreads);
     }
 
-    GDALRasterBandH hValBand = GDALGetRasterBand( hValDS, 1 );
-
 /* -------------------------------------------------------------------- */
 /*      Create a mask file to make it clear what pixels can be filtered */
 /*      on the filtering pass.                                          */
 /* -------------------------------------------------------------------- */
-    const CPLString osFiltMaskTmpFile = osTmpFile + "fill_filtmask_work.tif";
-
-    GDALDatasetH hFiltMaskDS =
-        GDALCreate( hDriver, osFiltMaskTmpFile, nXSize, nYSize, 1,
-                    GDT_Byte, papszWorkFileOptions );
-
-    if( hFiltMaskDS == nullptr )
+    if( nSmoothingIterations > 0 )
     {
-        CPLError(CE_Failure, CPLE_AppDefined,
-            "Could not create mask work file. Check driver capabilities.");
-        return CE_Failure;
-    }
-
-    GDALRasterBandH hFiltMaskBand = GDALGetRasterBand( hFiltMaskDS, 1 );
-
-/* -------------------------------------------------------------------- */
-/*      Allocate buffers for last scanline and this scanline.           */
-/* -------------------------------------------------------------------- */
-
-    GUInt32 *panLastY =
-        static_cast<GUInt32 *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(GUInt32)));
-    GUInt32 *panThisY =
-        static_cast<GUInt32 *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(GUInt32)));
-    GUInt32 *panTopDownY =
-        static_cast<GUInt32 *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(GUInt32)));
-    float *pafLastValue =
-        static_cast<float *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(float)));
-    float *pafThisValue =
-        static_cast<float *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(float)));
-    float *pafTopDownValue =
-        static_cast<float *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(float)));
-    float *pafScanline =
-        static_cast<float *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(float)));
-    GByte *pabyMask = static_cast<GByte *>(VSI_CALLOC_VERBOSE(nXSize, 1));
-    GByte *pabyFiltMask = static_cast<GByte *>(VSI_CALLOC_VERBOSE(nXSize, 1));
+        hFiltMaskDS =
+            GDALCreate( hDriver, osFiltMaskTmpFile, nXSize, nYSize, 1,
+                        GDT_Byte, papszWorkFileOptions );
 
-    CPLErr eErr = CE_None;
+        if( hFiltMaskDS == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                "Could not create mask work file. Check driver capabilities.");
+            eErr = CE_Failure;
+            goto end;
+        }
 
-    if( panLastY == nullptr || panThisY == nullptr || panTopDownY == nullptr ||
-        pafLastValue == nullptr || pafThisValue == nullptr ||
-        pafTopDownValue == nullptr ||
-        pafScanline == nullptr || pabyMask == nullptr || pabyFiltMask == nullptr )
-    {
-        eErr = CE_Failure;
-        goto end;
+        hFiltMaskBand = GDALGetRasterBand( hFiltMaskDS, 1 );
     }
 
-    for( int iX = 0; iX < nXSize; iX++ )
+    if( bPyramid )
     {
-        panLastY[iX] = nNoDataVal;
+        eErr = GDALFillNodataPyramid( hTargetBand, hMaskBand, hFiltMaskBand,
+                                      dfMaxSearchDist,
+                                      poJobQueue.get(), nThreads,
+                                      dfProgressRatio,
+                                      pfnProgress, pProgressArg );
     }
-
-/* ==================================================================== */
-/*      Make first pass from top to bottom collecting the "last         */
-/*      known value" for each column and writing it out to the work     */
-/*      files.                                                          */
-/* ==================================================================== */
-
-    for( int iY = 0; iY < nYSize && eErr == CE_None; iY++ )
+    else
     {
 /* -------------------------------------------------------------------- */
-/*      Read data and mask for this line.                               */
-/* -------------------------------------------------------------------- */
-        eErr =
-            GDALRasterIO( hMaskBand, GF_Read, 0, iY, nXSize, 1,
-                          pabyMask, nXSize, 1, GDT_Byte, 0, 0 );
-
-        if( eErr != CE_None )
-            break;
-
-        eErr =
-            GDALRasterIO( hTargetBand, GF_Read, 0, iY, nXSize, 1,
-                          pafScanline, nXSize, 1, GDT_Float32, 0, 0 );
-
-        if( eErr != CE_None )
-            break;
-
-/* -------------------------------------------------------------------- */
-/*      Figure out the most recent pixel for each column.               */
-/* -------------------------------------------------------------------- */
-
-        for( int iX = 0; iX < nXSize; iX++ )
-        {
-            if( pabyMask[iX] )
-            {
-                pafThisValue[iX] = pafScanline[iX];
-                panThisY[iX] = iY;
-            }
-            else if( iY <= dfMaxSearchDist + panLastY[iX] )
-            {
-                pafThisValue[iX] = pafLastValue[iX];
-                panThisY[iX] = panLastY[iX];
-            }
-            else
-            {
-                panThisY[iX] = nNoDataVal;
-            }
-        }
-
-/* -------------------------------------------------------------------- */
-/*      Write out best index/value to working files.                    */
-/* -------------------------------------------------------------------- */
-        eErr = GDALRasterIO( hYBand, GF_Write, 0, iY, nXSize, 1,
-                             panThisY, nXSize, 1, GDT_UInt32, 0, 0 );
-        if( eErr != CE_None )
-            break;
-
-        eErr = GDALRasterIO( hValBand, GF_Write, 0, iY, nXSize, 1,
-                             pafThisValue, nXSize, 1, GDT_Float32, 0, 0 );
-        if( eErr != CE_None )
-            break;
-
-/* -------------------------------------------------------------------- */
-/*      Flip this/last buffers.                                         */
+/*      Create a work file to hold the Y "last value" indices.          */
 /* -------------------------------------------------------------------- */
-        std::swap(pafThisValue, pafLastValue);
-        std::swap(panThisY, panLastY);
+        hYDS =
+            GDALCreate( hDriver, osYTmpFile, nXSize, nYSize, 1,
+                        eType, papszWorkFileOptions );
 
-/* -------------------------------------------------------------------- */
-/*      report progress.                                                */
-/* -------------------------------------------------------------------- */
-        if( eErr == CE_None &&
-            !pfnProgress(
-                dfProgressRatio * (0.5*(iY+1) /
-                                   static_cast<double>(nYSize)),
-                "Filling...", pProgressArg ) )
+        if( hYDS == nullptr )
         {
-            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            CPLError(
+                CE_Failure, CPLE_AppDefined,
+                "Could not create Y index work file. "
+                "Check driver capabilities.");
             eErr = CE_Failure;
+            goto end;
         }
-    }
-
-/* ==================================================================== */
-/*      Now we will do collect similar this/last information from       */
-/*      bottom to top and use it in combination with the top to         */
-/*      bottom search info to interpolate.                              */
-/* ==================================================================== */
-    for( int iY = nYSize-1; iY >= 0 && eErr == CE_None; iY-- )
-    {
-        eErr =
-            GDALRasterIO( hMaskBand, GF_Read, 0, iY, nXSize, 1,
-                          pabyMask, nXSize, 1, GDT_Byte, 0, 0 );
-
-        if( eErr != CE_None )
-            break;
-
-        eErr =
-            GDALRasterIO( hTargetBand, GF_Read, 0, iY, nXSize, 1,
-                          pafScanline, nXSize, 1, GDT_Float32, 0, 0 );
-
-        if( eErr != CE_None )
-            break;
-
-/* -------------------------------------------------------------------- */
-/*      Figure out the most recent pixel for each column.               */
-/* -------------------------------------------------------------------- */
-
-        for( int iX = 0; iX < nXSize; iX++ )
-        {
-            if( pabyMask[iX] )
-            {
-                pafThisValue[iX] = pafScanline[iX];
-                panThisY[iX] = iY;
-            }
-            else if( panLastY[iX] - iY <= dfMaxSearchDist )
-            {
-                pafThisValue[iX] = pafLastValue[iX];
-                panThisY[iX] = panLastY[iX];
-            }
-            else
-            {
-                panThisY[iX] = nNoDataVal;
-            }
-        }
-
-/* -------------------------------------------------------------------- */
-/*      Load the last y and corresponding value from the top down pass. */
-/* -------------------------------------------------------------------- */
-        eErr =
-            GDALRasterIO( hYBand, GF_Read, 0, iY, nXSize, 1,
-                          panTopDownY, nXSize, 1, GDT_UInt32, 0, 0 );
-
-        if( eErr != CE_None )
-            break;
-
-        eErr =
-            GDALRasterIO( hValBand, GF_Read, 0, iY, nXSize, 1,
-                          pafTopDownValue, nXSize, 1, GDT_Float32, 0, 0 );
-
-        if( eErr != CE_None )
-            break;
-
-/* -------------------------------------------------------------------- */
-/*      Attempt to interpolate any pixels that are nodata.              */
-/* -------------------------------------------------------------------- */
-        memset( pabyFiltMask, 0, nXSize );
-        for( int iX = 0; iX < nXSize; iX++ )
-        {
-            int nThisMaxSearchDist = nMaxSearchDist;
-
-            // If this was a valid target - no change.
-            if( pabyMask[iX] )
-                continue;
-
-            // Quadrants 0:topleft, 1:bottomleft, 2:topright, 3:bottomright
-            double adfQuadDist[4] = {};
-            double adfQuadValue[4] = {};
-
-            for( int iQuad = 0; iQuad < 4; iQuad++ )
-            {
-                adfQuadDist[iQuad] = dfMaxSearchDist + 1.0;
-                adfQuadValue[iQuad] = 0.0;
-            }
-
-            // Step left and right by one pixel searching for the closest
-            // target value for each quadrant.
-            for( int iStep = 0; iStep < nThisMaxSearchDist; iStep++ )
-            {
-                const int iLeftX = std::max(0, iX - iStep);
-                const int iRightX = std::min(nXSize - 1, iX + iStep);
-
-                // Top left includes current line.
-                QUAD_CHECK(adfQuadDist[0], adfQuadValue[0],
-                           iLeftX, panTopDownY[iLeftX], iX, iY,
-                           pafTopDownValue[iLeftX] );
-
-                // Bottom left.
-                QUAD_CHECK(adfQuadDist[1], adfQuadValue[1],
-                           iLeftX, panLastY[iLeftX], iX, iY,
-                           pafLastValue[iLeftX] );
-
-                // Top right and bottom right do no include center pixel.
-                if( iStep == 0 )
-                     continue;
-
-                // Top right includes current line.
-                QUAD_CHECK(adfQuadDist[2], adfQuadValue[2],
-                           iRightX, panTopDownY[iRightX], iX, iY,
-                           pafTopDownValue[iRightX] );
-
-                // Bottom right.
-                QUAD_CHECK(adfQuadDist[3], adfQuadValue[3],
-                           iRightX, panLastY[iRightX], iX, iY,
-                           pafLastValue[iRightX] );
-
-                // Every four steps, recompute maximum distance.
-                if( (iStep & 0x3) == 0 )
-                    nThisMaxSearchDist = static_cast<int>(floor(
-                        std::max(std::max(adfQuadDist[0], adfQuadDist[1]),
-                                 std::max(adfQuadDist[2], adfQuadDist[3]))));
-            }
-
-            double dfWeightSum = 0.0;
-            double dfValueSum = 0.0;
-
-            for( int iQuad = 0; iQuad < 4; iQuad++ )
-            {
-                if( adfQuadDist[iQuad] <= dfMaxSearchDist )
-                {
-                    const double dfWeight = 1.0 / adfQuadDist[iQuad];
-
-                    dfWeightSum += dfWeight;
-                    dfValueSum += adfQuadValue[iQuad] * dfWeight;
-                }
-            }
-
-            if( dfWeightSum > 0.0 )
-            {
-                pabyMask[iX] = 255;
-                pabyFiltMask[iX] = 255;
-                pafScanline[iX] = static_cast<float>(dfValueSum / dfWeightSum);
-            }
-        }
-
-/* -------------------------------------------------------------------- */
-/*      Write out the updated data and mask information.                */
-/* -------------------------------------------------------------------- */
-        eErr =
-            GDALRasterIO( hTargetBand, GF_Write, 0, iY, nXSize, 1,
-                          pafScanline, nXSize, 1, GDT_Float32, 0, 0 );
-
-        if( eErr != CE_None )
-            break;
-
-        eErr =
-            GDALRasterIO( hFiltMaskBand, GF_Write, 0, iY, nXSize, 1,
-                          pabyFiltMask, nXSize, 1, GDT_Byte, 0, 0 );
-
-        if( eErr != CE_None )
-            break;
 
 /* -------------------------------------------------------------------- */
-/*      Flip this/last buffers.                                         */
+/*      Create a work file to hold the pixel value associated with      */
+/*      the "last xy value" pixel.                                      */
 /* -------------------------------------------------------------------- */
-        std::swap(pafThisValue, pafLastValue);
-        std::swap(panThisY, panLastY);
+        hValDS =
+            GDALCreate( hDriver, osValTmpFile, nXSize, nYSize, 1,
+                        GDALGetRasterDataType( hTargetBand ),
+                        papszWorkFileOptions );
 
-/* -------------------------------------------------------------------- */
-/*      report progress.                                                */
-/* -------------------------------------------------------------------- */
-        if( eErr == CE_None &&
-            !pfnProgress(
-                dfProgressRatio*(0.5+0.5*(nYSize-iY) /
-                                 static_cast<double>(nYSize)),
-                "Filling...", pProgressArg) )
+        if( hValDS == nullptr )
         {
-            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            CPLError(CE_Failure, CPLE_AppDefined,
+                "Could not create XY value work file. "
+                "Check driver capabilities.");
             eErr = CE_Failure;
+            goto end;
         }
+
+        eErr = GDALFillNodataInvDist( hTargetBand, hMaskBand,
+                                      GDALGetRasterBand( hYDS, 1 ),
+                                      GDALGetRasterBand( hValDS, 1 ),
+                                      hFiltMaskBand,
+                                      dfMaxSearchDist, nNoDataVal,
+                                      poJobQueue.get(), nThreads,
+                                      dfProgressRatio,
+                                      pfnProgress, pProgressArg );
     }
 
 /* ==================================================================== */
@@ -855,28 +1543,26 @@ GDALFillNodata( GDALRasterBandH hTargetBand,
     }
 
 /* -------------------------------------------------------------------- */
-/*      Close and clean up temporary files. Free working buffers        */
+/*      Close and clean up temporary files.                             */
 /* -------------------------------------------------------------------- */
 end:
-    CPLFree(panLastY);
-    CPLFree(panThisY);
-    CPLFree(panTopDownY);
-    CPLFree(pafLastValue);
-    CPLFree(pafThisValue);
-    CPLFree(pafTopDownValue);
-    CPLFree(pafScanline);
-    CPLFree(pabyMask);
-    CPLFree(pabyFiltMask);
-
-    GDALClose( hYDS );
-    GDALClose( hValDS );
-    GDALClose( hFiltMaskDS );
-
     CSLDestroy(papszWorkFileOptions);
 
-    GDALDeleteDataset( hDriver, osYTmpFile );
-    GDALDeleteDataset( hDriver, osValTmpFile );
-    GDALDeleteDataset( hDriver, osFiltMaskTmpFile );
+    if( hYDS != nullptr )
+    {
+        GDALClose( hYDS );
+        GDALDeleteDataset( hDriver, osYTmpFile );
+    }
+    if( hValDS != nullptr )
+    {
+        GDALClose( hValDS );
+        GDALDeleteDataset( hDriver, osValTmpFile );
+    }
+    if( hFiltMaskDS != nullptr )
+    {
+        GDALClose( hFiltMaskDS );
+        GDALDeleteDataset( hDriver, osFiltMaskTmpFile );
+    }
 
     return eErr;
 }
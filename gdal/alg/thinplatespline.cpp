@@ -42,7 +42,9 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "cpl_error.h"
 #include "cpl_vsi.h"
@@ -435,6 +437,8 @@ static void VizGeorefSpline2DBase_func4( double* res,
 
 int VizGeorefSpline2D::solve()
 {
+    free_local();
+
     // No points at all.
     if( _nof_points < 1 )
     {
@@ -546,6 +550,9 @@ int VizGeorefSpline2D::solve()
         return 3;
     }
 
+    if( _local_points > 0 && _nof_points > _local_points )
+        return solve_local(xmin, xmax, ymin, ymax);
+
     type = VIZ_GEOREF_SPLINE_FULL;
     // Make the necessary memory allocations.
 
@@ -709,6 +716,10 @@ int VizGeorefSpline2D::get_point( const double Px, const double Py,
         }
         break;
     }
+    case VIZ_GEOREF_SPLINE_LOCAL:
+    {
+        return get_point_local( Px, Py, vars );
+    }
     case VIZ_GEOREF_SPLINE_POINT_WAS_ADDED:
     {
         CPLError(CE_Failure, CPLE_AppDefined,
@@ -735,4 +746,272 @@ int VizGeorefSpline2D::get_point( const double Px, const double Py,
     return 1;
 }
 
+
+//////////////////////////////////////////////////////////////////////////////
+//// Partition of unity of local splines
+//////////////////////////////////////////////////////////////////////////////
+
+// The extent of the points is divided into a regular grid of cells. Each cell
+// is the center of a patch, larger than the cell, on which a thin plate spline
+// is fitted on the points that fall within it. The value at a location is the
+// average of the values of the patches, weighted by a smooth bump function
+// that vanishes at the patch border. The result is continuous, and remains
+// exact at the points since a patch with a non-zero weight at a point always
+// contains that point.
+
+struct VizGeorefSpline2DPatch
+{
+    double cx = 0.0;
+    double cy = 0.0;
+    double sx = 0.0;  // Half width.
+    double sy = 0.0;  // Half height.
+    std::unique_ptr<VizGeorefSpline2D> poSpline{};
+};
+
+struct VizGeorefSpline2DLocal
+{
+    int nx = 0;
+    int ny = 0;
+    double xmin = 0.0;
+    double xmax = 0.0;
+    double ymin = 0.0;
+    double ymax = 0.0;
+    double cell_w = 0.0;
+    double cell_h = 0.0;
+    std::vector<VizGeorefSpline2DPatch> patches{};
+    // Patches intersecting the cell i are
+    // cell_patches[cell_start[i]] ... cell_patches[cell_start[i+1]-1]
+    std::vector<int> cell_start{};
+    std::vector<int> cell_patches{};
+};
+
+void VizGeorefSpline2D::free_local()
+{
+    delete _local;
+    _local = nullptr;
+}
+
+static int VizGeorefSpline2DCellIdx( double v, double vmin, double size,
+                                     int n )
+{
+    const double dfIdx = (v - vmin) / size;
+    if( !(dfIdx >= 0.0) )
+        return 0;
+    if( dfIdx >= n )
+        return n - 1;
+    return static_cast<int>(dfIdx);
+}
+
+int VizGeorefSpline2D::solve_local( double xmin, double xmax,
+                                    double ymin, double ymax )
+{
+    const double delx = xmax - xmin;
+    const double dely = ymax - ymin;
+    const double overlap = std::max(0.05, _local_overlap);
+
+    // Each patch spans (1 + 2 * overlap) cells in each direction, so size the
+    // grid for a patch to hold about _local_points points on average.
+    const double dfCells =
+        std::max(1.0, static_cast<double>(_nof_points) *
+                            SQ(1.0 + 2.0 * overlap) / _local_points);
+    const int nx = static_cast<int>(std::max(1.0, std::min(4096.0,
+                        floor(sqrt(dfCells * delx / dely) + 0.5))));
+    const int ny = static_cast<int>(std::max(1.0, std::min(4096.0,
+                        floor(dfCells / nx + 0.5))));
+    const int nCells = nx * ny;
+
+    std::unique_ptr<VizGeorefSpline2DLocal> psLocal(
+        new VizGeorefSpline2DLocal());
+    psLocal->nx = nx;
+    psLocal->ny = ny;
+    psLocal->xmin = xmin;
+    psLocal->xmax = xmax;
+    psLocal->ymin = ymin;
+    psLocal->ymax = ymax;
+    psLocal->cell_w = delx / nx;
+    psLocal->cell_h = dely / ny;
+    const double cell_w = psLocal->cell_w;
+    const double cell_h = psLocal->cell_h;
+
+    // Bucket the points per cell.
+    std::vector<int> anPointStart(nCells + 1);
+    std::vector<int> anPoints(_nof_points);
+    std::vector<int> anPointCell(_nof_points);
+    for( int p = 0; p < _nof_points; p++ )
+    {
+        anPointCell[p] =
+            VizGeorefSpline2DCellIdx(y[p], ymin, cell_h, ny) * nx +
+            VizGeorefSpline2DCellIdx(x[p], xmin, cell_w, nx);
+        anPointStart[anPointCell[p] + 1]++;
+    }
+    for( int i = 0; i < nCells; i++ )
+        anPointStart[i + 1] += anPointStart[i];
+    {
+        std::vector<int> anFill(anPointStart.begin(), anPointStart.end() - 1);
+        for( int p = 0; p < _nof_points; p++ )
+            anPoints[anFill[anPointCell[p]]++] = p;
+    }
+
+    // Fit the patches. A patch with too few points, or whose points are
+    // degenerate, is enlarged until its fit succeeds.
+    const int nMinPoints =
+        std::min(_nof_points, std::max(3, _local_points / 8));
+    psLocal->patches.resize(nCells);
+    for( int iy = 0; iy < ny; iy++ )
+    {
+        for( int ix = 0; ix < nx; ix++ )
+        {
+            VizGeorefSpline2DPatch& patch = psLocal->patches[iy * nx + ix];
+            patch.cx = xmin + (ix + 0.5) * cell_w;
+            patch.cy = ymin + (iy + 0.5) * cell_h;
+            patch.sx = (0.5 + overlap) * cell_w;
+            patch.sy = (0.5 + overlap) * cell_h;
+
+            while( true )
+            {
+                std::unique_ptr<VizGeorefSpline2D> poSpline(
+                    new VizGeorefSpline2D(_nof_vars));
+                const int ix0 = VizGeorefSpline2DCellIdx(
+                    patch.cx - patch.sx, xmin, cell_w, nx);
+                const int ix1 = VizGeorefSpline2DCellIdx(
+                    patch.cx + patch.sx, xmin, cell_w, nx);
+                const int iy0 = VizGeorefSpline2DCellIdx(
+                    patch.cy - patch.sy, ymin, cell_h, ny);
+                const int iy1 = VizGeorefSpline2DCellIdx(
+                    patch.cy + patch.sy, ymin, cell_h, ny);
+                int nCount = 0;
+                for( int iCellY = iy0; iCellY <= iy1; iCellY++ )
+                {
+                    for( int iCellX = ix0; iCellX <= ix1; iCellX++ )
+                    {
+                        const int iCell = iCellY * nx + iCellX;
+                        for( int i = anPointStart[iCell];
+                             i < anPointStart[iCell + 1]; i++ )
+                        {
+                            const int p = anPoints[i];
+                            if( !(fabs(x[p] - patch.cx) < patch.sx &&
+                                  fabs(y[p] - patch.cy) < patch.sy) )
+                                continue;
+                            double vals[VIZGEOREF_MAX_VARS];
+                            for( int v = 0; v < _nof_vars; v++ )
+                                vals[v] = rhs[v][p + 3];
+                            if( !poSpline->add_point(x[p], y[p], vals) )
+                                return 0;
+                            nCount++;
+                        }
+                    }
+                }
+
+                if( nCount >= nMinPoints )
+                {
+                    CPLErrorStateBackuper oErrorStateBackuper;
+                    CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+                    if( poSpline->solve() != 0 )
+                    {
+                        patch.poSpline = std::move(poSpline);
+                        break;
+                    }
+                }
+
+                if( patch.sx > delx && patch.sy > dely )
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "Degenerate system. Computation aborted.");
+                    return 0;
+                }
+                patch.sx *= 1.5;
+                patch.sy *= 1.5;
+            }
+        }
+    }
+
+    // Index the patches intersecting each cell.
+    std::vector<int>& anCellStart = psLocal->cell_start;
+    std::vector<int>& anCellPatches = psLocal->cell_patches;
+    anCellStart.resize(nCells + 1);
+    for( int iPass = 0; iPass < 2; iPass++ )
+    {
+        std::vector<int> anFill;
+        if( iPass == 1 )
+        {
+            for( int i = 0; i < nCells; i++ )
+                anCellStart[i + 1] += anCellStart[i];
+            anCellPatches.resize(anCellStart[nCells]);
+            anFill.assign(anCellStart.begin(), anCellStart.end() - 1);
+        }
+        for( int iPatch = 0; iPatch < nCells; iPatch++ )
+        {
+            const VizGeorefSpline2DPatch& patch = psLocal->patches[iPatch];
+            const int ix0 = VizGeorefSpline2DCellIdx(
+                patch.cx - patch.sx, xmin, cell_w, nx);
+            const int ix1 = VizGeorefSpline2DCellIdx(
+                patch.cx + patch.sx, xmin, cell_w, nx);
+            const int iy0 = VizGeorefSpline2DCellIdx(
+                patch.cy - patch.sy, ymin, cell_h, ny);
+            const int iy1 = VizGeorefSpline2DCellIdx(
+                patch.cy + patch.sy, ymin, cell_h, ny);
+            for( int iCellY = iy0; iCellY <= iy1; iCellY++ )
+            {
+                for( int iCellX = ix0; iCellX <= ix1; iCellX++ )
+                {
+                    const int iCell = iCellY * nx + iCellX;
+                    if( iPass == 0 )
+                        anCellStart[iCell + 1]++;
+                    else
+                        anCellPatches[anFill[iCell]++] = iPatch;
+                }
+            }
+        }
+    }
+
+    _local = psLocal.release();
+    type = VIZ_GEOREF_SPLINE_LOCAL;
+    return 4;
+}
+
+int VizGeorefSpline2D::get_point_local( const double Px, const double Py,
+                                        double *vars )
+{
+    const VizGeorefSpline2DLocal* psLocal = _local;
+
+    // Outside of the extent of the points, weights are evaluated at the
+    // nearest location inside it, so that the border patches extrapolate.
+    const double Qx = std::max(psLocal->xmin, std::min(psLocal->xmax, Px));
+    const double Qy = std::max(psLocal->ymin, std::min(psLocal->ymax, Py));
+    const int iCell =
+        VizGeorefSpline2DCellIdx(Qy, psLocal->ymin, psLocal->cell_h,
+                                 psLocal->ny) * psLocal->nx +
+        VizGeorefSpline2DCellIdx(Qx, psLocal->xmin, psLocal->cell_w,
+                                 psLocal->nx);
+
+    double sum_w = 0.0;
+    double sum_vars[VIZGEOREF_MAX_VARS] = {};
+    for( int i = psLocal->cell_start[iCell];
+         i < psLocal->cell_start[iCell + 1]; i++ )
+    {
+        const VizGeorefSpline2DPatch& patch =
+            psLocal->patches[psLocal->cell_patches[i]];
+        const double tx = (Qx - patch.cx) / patch.sx;
+        const double ty = (Qy - patch.cy) / patch.sy;
+        if( !(fabs(tx) < 1.0 && fabs(ty) < 1.0) )
+            continue;
+        const double w = SQ((1.0 - tx * tx) * (1.0 - ty * ty));
+        double patch_vars[VIZGEOREF_MAX_VARS];
+        patch.poSpline->get_point(Px, Py, patch_vars);
+        for( int v = 0; v < _nof_vars; v++ )
+            sum_vars[v] += w * patch_vars[v];
+        sum_w += w;
+    }
+
+    if( !(sum_w > 0.0) )
+    {
+        for( int v = 0; v < _nof_vars; v++ )
+            vars[v] = 0.0;
+        return 0;
+    }
+    for( int v = 0; v < _nof_vars; v++ )
+        vars[v] = sum_vars[v] / sum_w;
+    return 1;
+}
+
 /*! @endcond */
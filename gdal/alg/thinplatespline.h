@@ -45,6 +45,7 @@ typedef enum
     VIZ_GEOREF_SPLINE_TWO_POINTS,
     VIZ_GEOREF_SPLINE_ONE_DIMENSIONAL,
     VIZ_GEOREF_SPLINE_FULL,
+    VIZ_GEOREF_SPLINE_LOCAL,
 
     VIZ_GEOREF_SPLINE_POINT_WAS_ADDED,
     VIZ_GEOREF_SPLINE_POINT_WAS_DELETED
@@ -53,9 +54,14 @@ typedef enum
 //#define VIZ_GEOREF_SPLINE_MAX_POINTS 40
 #define VIZGEOREF_MAX_VARS 2
 
+struct VizGeorefSpline2DLocal;
+
 class VizGeorefSpline2D
 {
     bool grow_points();
+    int solve_local( double xmin, double xmax, double ymin, double ymax );
+    int get_point_local( const double Px, const double Py, double *Pvars );
+    void free_local();
 
   public:
 
@@ -72,6 +78,9 @@ class VizGeorefSpline2D
 #endif
         _dx(0.0),
         _dy(0.0),
+        _local_points(0),
+        _local_overlap(0.5),
+        _local(nullptr),
         x(nullptr),
         y(nullptr),
         u(nullptr),
@@ -88,6 +97,7 @@ class VizGeorefSpline2D
     }
 
     ~VizGeorefSpline2D() {
+        free_local();
         CPLFree( x );
         CPLFree( y );
         CPLFree( u );
@@ -158,6 +168,16 @@ class VizGeorefSpline2D
 #endif
     int solve(void);
 
+    // Use a partition of unity of local thin plate splines, each one fitted
+    // on about nof_points_per_patch points, instead of a global one, when
+    // there are more points than that. overlap is the extension of each
+    // patch beyond its grid cell, in fraction of the cell size.
+    void set_local( int nof_points_per_patch, double overlap )
+    {
+        _local_points = nof_points_per_patch;
+        _local_overlap = overlap;
+    }
+
   private:
 
     vizGeorefInterType type;
@@ -175,6 +195,10 @@ class VizGeorefSpline2D
 
     double _dx, _dy;
 
+    int _local_points;
+    double _local_overlap;
+    VizGeorefSpline2DLocal *_local;
+
     double *x; // [VIZ_GEOREF_SPLINE_MAX_POINTS+3];
     double *y; // [VIZ_GEOREF_SPLINE_MAX_POINTS+3];
 
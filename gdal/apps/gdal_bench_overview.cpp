@@ -0,0 +1,526 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Utilities
+ * Purpose:  Benchmark of the overview resampling code.
+ * Author:   agent <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "gdal_priv.h"
+#include "commonutils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+CPL_CVSID("$Id$")
+
+/************************************************************************/
+/*                               Usage()                                */
+/************************************************************************/
+
+static void Usage()
+{
+    printf(
+        "Usage: gdal_bench_overview [-size <xsize> <ysize>] [-b <bands>]\n"
+        "                           [-factor <n>] [-iter <n>] [-threads <n>]\n"
+        "                           [-ot <type>]* [-r <method>]* "
+        "[-chunk <lines>]*\n"
+        "                           [-no_resample_func] [-no_multiband]\n"
+        "\n"
+        "Runs the resampling functions returned by GDALGetResampleFunction()\n"
+        "and GDALRegenerateOverviewsMultiBand() on synthetic rasters, and\n"
+        "reports the number of source pixels processed per second.\n"
+        "\n"
+        "Defaults: -size 4096 4096 -b 1 -factor 2 -iter 3 -threads 1\n"
+        "          -ot Byte -ot UInt16 -ot Int16 -ot UInt32 -ot Int32\n"
+        "          -ot Float32 -ot Float64\n"
+        "          -r NEAR -r AVERAGE -r GAUSS -r MODE -r CUBIC\n"
+        "          -r CUBICSPLINE -r LANCZOS -r BILINEAR\n"
+        "          -chunk 64 -chunk 256 -chunk 1024\n" );
+    exit(1);
+}
+
+/************************************************************************/
+/*                            GetTimeSec()                              */
+/************************************************************************/
+
+static double GetTimeSec()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/************************************************************************/
+/*                         CreateSourceDataset()                        */
+/************************************************************************/
+
+// Fill a MEM dataset with a deterministic mix of smooth gradients and noise,
+// so that the value distribution is neither constant (which would favour
+// MODE) nor completely random.
+static GDALDataset* CreateSourceDataset( int nXSize, int nYSize, int nBands,
+                                         GDALDataType eDT )
+{
+    GDALDriver* poMEMDriver =
+        GetGDALDriverManager()->GetDriverByName("MEM");
+    if( poMEMDriver == nullptr )
+        return nullptr;
+    GDALDataset* poDS =
+        poMEMDriver->Create("", nXSize, nYSize, nBands, eDT, nullptr);
+    if( poDS == nullptr )
+        return nullptr;
+
+    double dfMax = 255.0;
+    if( eDT == GDT_UInt16 || eDT == GDT_Int16 )
+        dfMax = 30000.0;
+    else if( eDT != GDT_Byte )
+        dfMax = 1e6;
+
+    std::vector<double> adfLine(nXSize);
+    GUInt32 nSeed = 1;
+    for( int iBand = 0; iBand < nBands; ++iBand )
+    {
+        GDALRasterBand* poBand = poDS->GetRasterBand(iBand + 1);
+        for( int iY = 0; iY < nYSize; ++iY )
+        {
+            for( int iX = 0; iX < nXSize; ++iX )
+            {
+                nSeed = nSeed * 1103515245U + 12345U;
+                const double dfNoise = ((nSeed >> 16) & 0xFF) / 255.0;
+                const double dfGradient =
+                    0.5 + 0.25 * sin(iX * 0.01 + iBand) * cos(iY * 0.013);
+                adfLine[iX] =
+                    std::floor(dfMax * (0.8 * dfGradient + 0.2 * dfNoise));
+            }
+            if( poBand->RasterIO(GF_Write, 0, iY, nXSize, 1,
+                                 &adfLine[0], nXSize, 1, GDT_Float64,
+                                 0, 0, nullptr) != CE_None )
+            {
+                delete poDS;
+                return nullptr;
+            }
+        }
+    }
+    return poDS;
+}
+
+/************************************************************************/
+/*                         BenchResampleFunction()                      */
+/************************************************************************/
+
+// Time one GDALResampleFunction over a whole band, called on horizontal
+// swaths of nChunkLines source lines, as GDALRegenerateOverviews() does.
+// Returns the best elapsed time, or a negative value on error.
+static double BenchResampleFunction( GDALRasterBand* poSrcBand,
+                                     const char* pszResampling,
+                                     int nFactor, int nChunkLines,
+                                     int nIter )
+{
+    int nRadius = 0;
+    GDALResampleFunction pfnResample =
+        GDALGetResampleFunction(pszResampling, &nRadius);
+    if( pfnResample == nullptr )
+        return -1.0;
+
+    const GDALDataType eSrcDT = poSrcBand->GetRasterDataType();
+    const GDALDataType eWrkDT =
+        GDALGetOvrWorkDataType(pszResampling, eSrcDT);
+    const int nWrkDTSize = GDALGetDataTypeSizeBytes(eWrkDT);
+    const int nSrcXSize = poSrcBand->GetXSize();
+    const int nSrcYSize = poSrcBand->GetYSize();
+    const int nDstXSize = std::max(1, nSrcXSize / nFactor);
+    const int nDstYSize = std::max(1, nSrcYSize / nFactor);
+    const double dfXRatioDstToSrc =
+        static_cast<double>(nSrcXSize) / nDstXSize;
+    const double dfYRatioDstToSrc =
+        static_cast<double>(nSrcYSize) / nDstYSize;
+
+    // The whole source band is loaded once in the working data type, so that
+    // only the resampling is timed.
+    GByte* pabyChunk = static_cast<GByte*>(
+        VSI_MALLOC3_VERBOSE(nSrcXSize, nSrcYSize, nWrkDTSize));
+    if( pabyChunk == nullptr )
+        return -1.0;
+    if( poSrcBand->RasterIO(GF_Read, 0, 0, nSrcXSize, nSrcYSize,
+                            pabyChunk, nSrcXSize, nSrcYSize, eWrkDT,
+                            0, 0, nullptr) != CE_None )
+    {
+        VSIFree(pabyChunk);
+        return -1.0;
+    }
+
+    GDALDriver* poMEMDriver =
+        GetGDALDriverManager()->GetDriverByName("MEM");
+    GDALDataset* poOvrDS =
+        poMEMDriver->Create("", nDstXSize, nDstYSize, 1, eSrcDT, nullptr);
+    if( poOvrDS == nullptr )
+    {
+        VSIFree(pabyChunk);
+        return -1.0;
+    }
+    GDALRasterBand* poOvrBand = poOvrDS->GetRasterBand(1);
+
+    const int nDstChunkLines = std::max(1, nChunkLines / nFactor);
+    double dfBest = -1.0;
+    for( int iIter = 0; iIter < nIter; ++iIter )
+    {
+        const double dfStart = GetTimeSec();
+        for( int nDstYOff = 0; nDstYOff < nDstYSize;
+             nDstYOff += nDstChunkLines )
+        {
+            const int nDstYOff2 =
+                std::min(nDstYSize, nDstYOff + nDstChunkLines);
+            const int nChunkYOff = std::max(0,
+                static_cast<int>(nDstYOff * dfYRatioDstToSrc) -
+                    nRadius * nFactor);
+            const int nChunkYOff2 = std::min(nSrcYSize,
+                static_cast<int>(ceil(nDstYOff2 * dfYRatioDstToSrc)) +
+                    nRadius * nFactor);
+
+            if( pfnResample(dfXRatioDstToSrc, dfYRatioDstToSrc, 0.0, 0.0,
+                            eWrkDT,
+                            pabyChunk + static_cast<size_t>(nChunkYOff) *
+                                nSrcXSize * nWrkDTSize,
+                            nullptr,
+                            0, nSrcXSize,
+                            nChunkYOff, nChunkYOff2 - nChunkYOff,
+                            0, nDstXSize,
+                            nDstYOff, nDstYOff2,
+                            poOvrBand, pszResampling,
+                            FALSE, 0.0f, nullptr, eSrcDT,
+                            false) != CE_None )
+            {
+                delete poOvrDS;
+                VSIFree(pabyChunk);
+                return -1.0;
+            }
+        }
+        const double dfElapsed = GetTimeSec() - dfStart;
+        if( dfBest < 0 || dfElapsed < dfBest )
+            dfBest = dfElapsed;
+    }
+
+    delete poOvrDS;
+    VSIFree(pabyChunk);
+    return dfBest;
+}
+
+/************************************************************************/
+/*                        BenchMultiBandOverview()                      */
+/************************************************************************/
+
+// Time GDALRegenerateOverviewsMultiBand() from a MEM dataset into a tiled
+// uncompressed GTiff in /vsimem/. That function processes the source by
+// chunks matching the overview tiles, so the tile size is derived from the
+// requested number of source lines. Returns the best elapsed time, or a
+// negative value on error.
+static double BenchMultiBandOverview( GDALDataset* poSrcDS,
+                                      const char* pszResampling,
+                                      int nFactor, int nChunkLines,
+                                      int nIter, int* pnTileSize )
+{
+    GDALDriver* poGTiffDriver =
+        GetGDALDriverManager()->GetDriverByName("GTiff");
+    if( poGTiffDriver == nullptr )
+        return -1.0;
+
+    const int nBands = poSrcDS->GetRasterCount();
+    const int nDstXSize = std::max(1, poSrcDS->GetRasterXSize() / nFactor);
+    const int nDstYSize = std::max(1, poSrcDS->GetRasterYSize() / nFactor);
+    // GTiff tile dimensions must be multiple of 16.
+    const int nTileSize =
+        std::max(16, (nChunkLines / nFactor + 15) / 16 * 16);
+    *pnTileSize = nTileSize;
+
+    CPLStringList aosOptions;
+    aosOptions.SetNameValue("TILED", "YES");
+    aosOptions.SetNameValue("BLOCKXSIZE", CPLSPrintf("%d", nTileSize));
+    aosOptions.SetNameValue("BLOCKYSIZE", CPLSPrintf("%d", nTileSize));
+    if( nBands > 1 )
+        aosOptions.SetNameValue("INTERLEAVE", "PIXEL");
+
+    const char* pszOvrFilename = "/vsimem/gdal_bench_overview.tif";
+    GDALDataset* poOvrDS = poGTiffDriver->Create(
+        pszOvrFilename, nDstXSize, nDstYSize, nBands,
+        poSrcDS->GetRasterBand(1)->GetRasterDataType(), aosOptions.List());
+    if( poOvrDS == nullptr )
+        return -1.0;
+
+    std::vector<GDALRasterBand*> apoSrcBands;
+    std::vector<GDALRasterBand**> apapoOvrBands;
+    std::vector<GDALRasterBand*> apoOvrBands;
+    for( int iBand = 0; iBand < nBands; ++iBand )
+    {
+        apoSrcBands.push_back(poSrcDS->GetRasterBand(iBand + 1));
+        apoOvrBands.push_back(poOvrDS->GetRasterBand(iBand + 1));
+    }
+    for( int iBand = 0; iBand < nBands; ++iBand )
+        apapoOvrBands.push_back(&apoOvrBands[iBand]);
+
+    double dfBest = -1.0;
+    for( int iIter = 0; iIter < nIter; ++iIter )
+    {
+        const double dfStart = GetTimeSec();
+        const CPLErr eErr = GDALRegenerateOverviewsMultiBand(
+            nBands, &apoSrcBands[0], 1, &apapoOvrBands[0],
+            pszResampling, GDALDummyProgress, nullptr);
+        if( eErr == CE_None )
+            poOvrDS->FlushCache();
+        if( eErr != CE_None )
+        {
+            dfBest = -1.0;
+            break;
+        }
+        const double dfElapsed = GetTimeSec() - dfStart;
+        if( dfBest < 0 || dfElapsed < dfBest )
+            dfBest = dfElapsed;
+    }
+
+    delete poOvrDS;
+    VSIUnlink(pszOvrFilename);
+    return dfBest;
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+#define CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(nExtraArg) \
+    do { if (i + nExtraArg >= argc) \
+        Usage(); } while( false )
+
+int main( int argc, char* argv[] )
+{
+    EarlySetConfigOptions(argc, argv);
+
+    GDALAllRegister();
+
+    argc = GDALGeneralCmdLineProcessor( argc, &argv, 0 );
+    if( argc < 1 )
+        exit( -argc );
+
+    int nXSize = 4096;
+    int nYSize = 4096;
+    int nBands = 1;
+    int nFactor = 2;
+    int nIter = 3;
+    bool bResampleFunc = true;
+    bool bMultiBand = true;
+    CPLStringList aosTypes;
+    CPLStringList aosMethods;
+    std::vector<int> anChunkLines;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-size") )
+        {
+            CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(2);
+            nXSize = atoi(argv[++i]);
+            nYSize = atoi(argv[++i]);
+        }
+        else if( EQUAL(argv[i], "-b") )
+        {
+            CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
+            nBands = atoi(argv[++i]);
+        }
+        else if( EQUAL(argv[i], "-factor") )
+        {
+            CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
+            nFactor = atoi(argv[++i]);
+        }
+        else if( EQUAL(argv[i], "-iter") )
+        {
+            CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
+            nIter = atoi(argv[++i]);
+        }
+        else if( EQUAL(argv[i], "-threads") )
+        {
+            CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
+            CPLSetConfigOption("GDAL_NUM_THREADS", argv[++i]);
+        }
+        else if( EQUAL(argv[i], "-ot") )
+        {
+            CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
+            aosTypes.AddString(argv[++i]);
+        }
+        else if( EQUAL(argv[i], "-r") )
+        {
+            CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
+            aosMethods.AddString(argv[++i]);
+        }
+        else if( EQUAL(argv[i], "-chunk") )
+        {
+            CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
+            anChunkLines.push_back(atoi(argv[++i]));
+        }
+        else if( EQUAL(argv[i], "-no_resample_func") )
+        {
+            bResampleFunc = false;
+        }
+        else if( EQUAL(argv[i], "-no_multiband") )
+        {
+            bMultiBand = false;
+        }
+        else
+        {
+            Usage();
+        }
+    }
+
+    if( nXSize <= 0 || nYSize <= 0 || nBands <= 0 || nFactor <= 0 ||
+        nIter <= 0 )
+    {
+        Usage();
+    }
+    for( int nChunkLines : anChunkLines )
+    {
+        if( nChunkLines <= 0 )
+            Usage();
+    }
+
+    if( aosTypes.empty() )
+    {
+        const char* const apszDefaultTypes[] = {
+            "Byte", "UInt16", "Int16", "UInt32", "Int32",
+            "Float32", "Float64" };
+        for( const char* pszType : apszDefaultTypes )
+            aosTypes.AddString(pszType);
+    }
+    if( aosMethods.empty() )
+    {
+        const char* const apszDefaultMethods[] = {
+            "NEAR", "AVERAGE", "GAUSS", "MODE", "CUBIC",
+            "CUBICSPLINE", "LANCZOS", "BILINEAR" };
+        for( const char* pszMethod : apszDefaultMethods )
+            aosMethods.AddString(pszMethod);
+    }
+    if( anChunkLines.empty() )
+    {
+        anChunkLines.push_back(64);
+        anChunkLines.push_back(256);
+        anChunkLines.push_back(1024);
+    }
+
+    printf("Source: %dx%d, %d band(s), factor %d, best of %d iteration(s), "
+           "GDAL_NUM_THREADS=%s\n",
+           nXSize, nYSize, nBands, nFactor, nIter,
+           CPLGetConfigOption("GDAL_NUM_THREADS", "1"));
+    printf("%-18s %-8s %-12s %8s %10s %12s\n",
+           "test", "type", "method", "chunk", "time(s)", "Mpixels/s");
+
+    int nRet = 0;
+    for( int iType = 0; iType < aosTypes.size(); ++iType )
+    {
+        const GDALDataType eDT = GDALGetDataTypeByName(aosTypes[iType]);
+        if( eDT == GDT_Unknown || GDALDataTypeIsComplex(eDT) )
+        {
+            fprintf(stderr, "Unsupported data type: %s\n", aosTypes[iType]);
+            nRet = 1;
+            continue;
+        }
+
+        GDALDataset* poSrcDS =
+            CreateSourceDataset(nXSize, nYSize, nBands, eDT);
+        if( poSrcDS == nullptr )
+        {
+            nRet = 1;
+            break;
+        }
+
+        for( int iMethod = 0; iMethod < aosMethods.size(); ++iMethod )
+        {
+            const char* pszMethod = aosMethods[iMethod];
+            for( int nChunkLines : anChunkLines )
+            {
+                if( bResampleFunc )
+                {
+                    double dfTime = 0.0;
+                    for( int iBand = 0; iBand < nBands; ++iBand )
+                    {
+                        const double dfBandTime = BenchResampleFunction(
+                            poSrcDS->GetRasterBand(iBand + 1), pszMethod,
+                            nFactor, nChunkLines, nIter);
+                        if( dfBandTime < 0 )
+                        {
+                            dfTime = -1.0;
+                            break;
+                        }
+                        dfTime += dfBandTime;
+                    }
+                    if( dfTime < 0 )
+                    {
+                        printf("%-18s %-8s %-12s %8d %10s %12s\n",
+                               "resample_func", aosTypes[iType], pszMethod,
+                               nChunkLines, "failed", "-");
+                        nRet = 1;
+                    }
+                    else
+                    {
+                        printf("%-18s %-8s %-12s %8d %10.4f %12.2f\n",
+                               "resample_func", aosTypes[iType], pszMethod,
+                               nChunkLines, dfTime,
+                               static_cast<double>(nXSize) * nYSize *
+                                   nBands / std::max(dfTime, 1e-9) / 1e6);
+                    }
+                }
+
+                // GDALRegenerateOverviewsMultiBand() does not implement MODE.
+                if( bMultiBand && !STARTS_WITH_CI(pszMethod, "MODE") )
+                {
+                    int nTileSize = 0;
+                    const double dfTime = BenchMultiBandOverview(
+                        poSrcDS, pszMethod, nFactor, nChunkLines, nIter,
+                        &nTileSize);
+                    const int nEffectiveChunk = nTileSize * nFactor;
+                    if( dfTime < 0 )
+                    {
+                        printf("%-18s %-8s %-12s %8d %10s %12s\n",
+                               "multiband", aosTypes[iType], pszMethod,
+                               nEffectiveChunk, "failed", "-");
+                        nRet = 1;
+                    }
+                    else
+                    {
+                        printf("%-18s %-8s %-12s %8d %10.4f %12.2f\n",
+                               "multiband", aosTypes[iType], pszMethod,
+                               nEffectiveChunk, dfTime,
+                               static_cast<double>(nXSize) * nYSize *
+                                   nBands / std::max(dfTime, 1e-9) / 1e6);
+                    }
+                }
+                fflush(stdout);
+            }
+        }
+
+        delete poSrcDS;
+    }
+
+    CSLDestroy(argv);
+    GDALDestroyDriverManager();
+
+    return nRet;
+}
@@ -108,19 +108,11 @@
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
+#include "gdal_alg_priv.h"
 #include "gdal_priv.h"
 
-#if defined(__SSE2__) || defined(_M_X64)
-#define HAVE_16_SSE_REG
-#define HAVE_SSE2
-#include "emmintrin.h"
-#endif
-
 CPL_CVSID("$Id$")
 
-static const double kdfDegreesToRadians = M_PI / 180.0;
-static const double kdfRadiansToDegrees = 180.0 / M_PI;
-
 typedef enum
 {
     COLOR_SELECTION_INTERPOLATE,
@@ -136,1241 +128,25 @@ struct GDALDEMProcessingOptions
     /*! the progress function to use */
     GDALProgressFunc pfnProgress;
 
-    /*! pointer to the progress data variable */
-    void *pProgressData;
-
-    double z;
-    double scale;
-    double az;
-    double alt;
-    int slopeFormat;
-    bool bAddAlpha;
-    bool bZeroForFlat;
-    bool bAngleAsAzimuth;
-    ColorSelectionMode eColorSelectionMode;
-    bool bComputeAtEdges;
-    bool bZevenbergenThorne;
-    bool bCombined;
-    bool bMultiDirectional;
-    char** papszCreateOptions;
-    int nBand;
-};
-
-/************************************************************************/
-/*                          ComputeVal()                                */
-/************************************************************************/
-
-template<class T>
-struct GDALGeneric3x3ProcessingAlg
-{
-    typedef float (*type) (const T* pafWindow, float fDstNoDataValue, void* pData);
-};
-
-template<class T>
-struct GDALGeneric3x3ProcessingAlg_multisample
-{
-    typedef int (*type)  (const T* pafThreeLineWin,
-                          int nLine1Off,
-                          int nLine2Off,
-                          int nLine3Off,
-                          int nXSize,
-                          void* pData,
-                          float* pafOutputBuf);
-};
-
-template<class T>
-static float ComputeVal( bool bSrcHasNoData, T fSrcNoDataValue,
-                         bool bIsSrcNoDataNan,
-                         T* afWin, float fDstNoDataValue,
-                         typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg,
-                         void* pData,
-                         bool bComputeAtEdges );
-
-template<>
-float ComputeVal( bool bSrcHasNoData, float fSrcNoDataValue,
-                  bool bIsSrcNoDataNan,
-                  float* afWin, float fDstNoDataValue,
-                  GDALGeneric3x3ProcessingAlg<float>::type pfnAlg,
-                  void* pData,
-                  bool bComputeAtEdges )
-{
-    if( bSrcHasNoData &&
-        ((!bIsSrcNoDataNan && ARE_REAL_EQUAL(afWin[4], fSrcNoDataValue)) ||
-         (bIsSrcNoDataNan && CPLIsNan(afWin[4]))) )
-    {
-        return fDstNoDataValue;
-    }
-    else if( bSrcHasNoData )
-    {
-        for( int k = 0; k < 9; k++ )
-        {
-            if( (!bIsSrcNoDataNan &&
-                 ARE_REAL_EQUAL(afWin[k], fSrcNoDataValue)) ||
-                (bIsSrcNoDataNan && CPLIsNan(afWin[k])) )
-            {
-                if( bComputeAtEdges )
-                    afWin[k] = afWin[4];
-                else
-                    return fDstNoDataValue;
-            }
-        }
-    }
-
-    return pfnAlg(afWin, fDstNoDataValue, pData);
-}
-
-template<>
-float ComputeVal( bool bSrcHasNoData, GInt32 fSrcNoDataValue,
-                  bool /* bIsSrcNoDataNan */,
-                  GInt32* afWin, float fDstNoDataValue,
-                  GDALGeneric3x3ProcessingAlg<GInt32>::type pfnAlg,
-                  void* pData,
-                  bool bComputeAtEdges )
-{
-    if( bSrcHasNoData && afWin[4] == fSrcNoDataValue )
-    {
-        return fDstNoDataValue;
-    }
-    else if( bSrcHasNoData )
-    {
-        for( int k = 0; k < 9; k++ )
-        {
-            if( afWin[k] == fSrcNoDataValue )
-            {
-                if( bComputeAtEdges )
-                    afWin[k] = afWin[4];
-                else
-                    return fDstNoDataValue;
-            }
-        }
-    }
-
-    return pfnAlg(afWin, fDstNoDataValue, pData);
-}
-
-/************************************************************************/
-/*                           INTERPOL()                                 */
-/************************************************************************/
-
-template<class T> static T INTERPOL(T a, T b, int bSrcHasNodata, T fSrcNoDataValue);
-
-template<>
-float INTERPOL(float a, float b, int bSrcHasNoData, float fSrcNoDataValue)
-{
-    return ((bSrcHasNoData && (ARE_REAL_EQUAL(a, fSrcNoDataValue) ||
-                               ARE_REAL_EQUAL(b, fSrcNoDataValue))) ?
-                                            fSrcNoDataValue : 2 * (a) - (b));
-}
-
-template<>
-GInt32 INTERPOL(GInt32 a, GInt32 b, int bSrcHasNoData, GInt32 fSrcNoDataValue)
-{
-    if( bSrcHasNoData && ((a == fSrcNoDataValue) || (b == fSrcNoDataValue)) )
-        return fSrcNoDataValue;
-    int nVal = 2 * a - b;
-    if( bSrcHasNoData && fSrcNoDataValue == nVal )
-        return nVal + 1;
-    return nVal;
-}
-
-/************************************************************************/
-/*                  GDALGeneric3x3Processing()                          */
-/************************************************************************/
-
-template<class T>
-static
-CPLErr GDALGeneric3x3Processing(
-    GDALRasterBandH hSrcBand,
-    GDALRasterBandH hDstBand,
-    typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg,
-    typename GDALGeneric3x3ProcessingAlg_multisample<T>::type pfnAlg_multisample,
-    void *pData,
-    bool bComputeAtEdges,
-    GDALProgressFunc pfnProgress,
-    void *pProgressData )
-{
-    if( pfnProgress == nullptr )
-        pfnProgress = GDALDummyProgress;
-
-/* -------------------------------------------------------------------- */
-/*      Initialize progress counter.                                    */
-/* -------------------------------------------------------------------- */
-    if( !pfnProgress( 0.0, nullptr, pProgressData ) )
-    {
-        CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-        return CE_Failure;
-    }
-
-    const int nXSize = GDALGetRasterBandXSize(hSrcBand);
-    const int nYSize = GDALGetRasterBandYSize(hSrcBand);
-
-    // 1 line destination buffer.
-    float *pafOutputBuf = static_cast<float *>(
-        VSI_MALLOC2_VERBOSE(sizeof(float), nXSize));
-    // 3 line rotating source buffer.
-    T *pafThreeLineWin  = static_cast<T *>(
-        VSI_MALLOC2_VERBOSE(3 * sizeof(T), nXSize + 1));
-    if( pafOutputBuf == nullptr || pafThreeLineWin == nullptr )
-    {
-        VSIFree(pafOutputBuf);
-        VSIFree(pafThreeLineWin);
-        return CE_Failure;
-    }
-
-    GDALDataType eReadDT;
-    int bSrcHasNoData = FALSE;
-    const double dfNoDataValue =
-        GDALGetRasterNoDataValue(hSrcBand, &bSrcHasNoData);
-
-    int bIsSrcNoDataNan = FALSE;
-    T fSrcNoDataValue = 0;
-    if( std::numeric_limits<T>::is_integer )
-    {
-        eReadDT = GDT_Int32;
-        if( bSrcHasNoData )
-        {
-            GDALDataType eSrcDT = GDALGetRasterDataType( hSrcBand );
-            CPLAssert( eSrcDT == GDT_Byte ||
-                       eSrcDT == GDT_UInt16 ||
-                       eSrcDT == GDT_Int16 );
-            const int nMinVal =
-                (eSrcDT == GDT_Byte ) ? 0 : (eSrcDT == GDT_UInt16) ? 0 : -32768;
-            const int nMaxVal =
-                (eSrcDT == GDT_Byte )
-                ? 255
-                : (eSrcDT == GDT_UInt16) ? 65535 : 32767;
-
-            if( fabs(dfNoDataValue - floor(dfNoDataValue + 0.5)) < 1e-2 &&
-                dfNoDataValue >= nMinVal && dfNoDataValue <= nMaxVal )
-            {
-                fSrcNoDataValue = static_cast<T>(floor(dfNoDataValue + 0.5));
-            }
-            else
-            {
-                bSrcHasNoData = FALSE;
-            }
-        }
-    }
-    else
-    {
-        eReadDT = GDT_Float32;
-        fSrcNoDataValue = static_cast<T>(dfNoDataValue);
-        bIsSrcNoDataNan = bSrcHasNoData && CPLIsNan(dfNoDataValue);
-    }
-
-    int bDstHasNoData = FALSE;
-    float fDstNoDataValue =
-        static_cast<float>(GDALGetRasterNoDataValue(hDstBand, &bDstHasNoData));
-    if( !bDstHasNoData )
-        fDstNoDataValue = 0.0;
-
-    int nLine1Off = 0;
-    int nLine2Off = nXSize;
-    int nLine3Off = 2*nXSize;
-
-    // Move a 3x3 pafWindow over each cell
-    // (where the cell in question is #4)
-    //
-    //      0 1 2
-    //      3 4 5
-    //      6 7 8
-
-    /* Preload the first 2 lines */
-
-    bool abLineHasNoDataValue[3] = {
-        CPL_TO_BOOL(bSrcHasNoData),
-        CPL_TO_BOOL(bSrcHasNoData),
-        CPL_TO_BOOL(bSrcHasNoData)
-    };
-
-    // Create an extra scope for VC12 to ignore i.
-    {
-      for( int i = 0; i < 2 && i < nYSize; i++ )
-      {
-        if( GDALRasterIO( hSrcBand,
-                          GF_Read,
-                          0, i,
-                          nXSize, 1,
-                          pafThreeLineWin + i * nXSize,
-                          nXSize, 1,
-                          eReadDT,
-                          0, 0) != CE_None )
-        {
-            CPLFree(pafOutputBuf);
-            CPLFree(pafThreeLineWin);
-
-            return CE_Failure;
-        }
-        if( std::numeric_limits<T>::is_integer && bSrcHasNoData )
-        {
-            abLineHasNoDataValue[i] = false;
-            for( int iX = 0; iX < nXSize; iX++ )
-            {
-                if( pafThreeLineWin[i * nXSize + iX] == fSrcNoDataValue )
-                {
-                    abLineHasNoDataValue[i] = true;
-                    break;
-                }
-            }
-        }
-      }
-    }  // End extra scope for VC12
-
-    CPLErr eErr = CE_None;
-    if( bComputeAtEdges && nXSize >= 2 && nYSize >= 2 )
-    {
-        for( int j = 0; j < nXSize; j++ )
-        {
-            int jmin = (j == 0) ? j : j - 1;
-            int jmax = (j == nXSize - 1) ? j : j + 1;
-
-            T afWin[9] = {
-                INTERPOL(pafThreeLineWin[jmin], pafThreeLineWin[nXSize + jmin],
-                         bSrcHasNoData, fSrcNoDataValue),
-                INTERPOL(pafThreeLineWin[j],    pafThreeLineWin[nXSize + j],
-                         bSrcHasNoData, fSrcNoDataValue),
-                INTERPOL(pafThreeLineWin[jmax], pafThreeLineWin[nXSize + jmax],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[jmin],
-                pafThreeLineWin[j],
-                pafThreeLineWin[jmax],
-                pafThreeLineWin[nXSize + jmin],
-                pafThreeLineWin[nXSize + j],
-                pafThreeLineWin[nXSize + jmax]
-            };
-            pafOutputBuf[j] = ComputeVal(
-                CPL_TO_BOOL(bSrcHasNoData),
-                fSrcNoDataValue,
-                CPL_TO_BOOL(bIsSrcNoDataNan),
-                afWin, fDstNoDataValue,
-                pfnAlg, pData, bComputeAtEdges);
-        }
-        eErr = GDALRasterIO(hDstBand, GF_Write,
-                    0, 0, nXSize, 1,
-                    pafOutputBuf, nXSize, 1, GDT_Float32, 0, 0);
-    }
-    else
-    {
-        // Exclude the edges
-        for( int j = 0; j < nXSize; j++ )
-        {
-            pafOutputBuf[j] = fDstNoDataValue;
-        }
-        eErr = GDALRasterIO(hDstBand, GF_Write,
-                    0, 0, nXSize, 1,
-                    pafOutputBuf, nXSize, 1, GDT_Float32, 0, 0);
-
-        if( eErr == CE_None && nYSize > 1 )
-        {
-            eErr = GDALRasterIO(hDstBand, GF_Write,
-                        0, nYSize - 1, nXSize, 1,
-                        pafOutputBuf, nXSize, 1, GDT_Float32, 0, 0);
-        }
-    }
-    if( eErr != CE_None )
-    {
-        CPLFree(pafOutputBuf);
-        CPLFree(pafThreeLineWin);
-
-        return eErr;
-    }
-
-    int i = 1;  // Used after for.
-    for( ; i < nYSize-1; i++ )
-    {
-        /* Read third line of the line buffer */
-        eErr = GDALRasterIO(   hSrcBand,
-                        GF_Read,
-                        0, i+1,
-                        nXSize, 1,
-                        pafThreeLineWin + nLine3Off,
-                        nXSize, 1,
-                        eReadDT,
-                        0, 0);
-        if( eErr != CE_None )
-        {
-            CPLFree(pafOutputBuf);
-            CPLFree(pafThreeLineWin);
-
-            return eErr;
-        }
-
-        // In case none of the 3 lines have nodata values, then no need to
-        // check it in ComputeVal()
-        bool bOneOfThreeLinesHasNoData = CPL_TO_BOOL(bSrcHasNoData);
-        if( std::numeric_limits<T>::is_integer && bSrcHasNoData )
-        {
-            bool bLastLineHasNoDataValue = false;
-            int iX = 0;
-            for( ; iX + 3 < nXSize; iX +=4 )
-            {
-                if( pafThreeLineWin[nLine3Off + iX] == fSrcNoDataValue ||
-                    pafThreeLineWin[nLine3Off + iX + 1] == fSrcNoDataValue ||
-                    pafThreeLineWin[nLine3Off + iX + 2] == fSrcNoDataValue ||
-                    pafThreeLineWin[nLine3Off + iX + 3] == fSrcNoDataValue )
-                {
-                    bLastLineHasNoDataValue = true;
-                    break;
-                }
-            }
-            if( !bLastLineHasNoDataValue )
-            {
-                for( ; iX < nXSize; iX++ )
-                {
-                    if( pafThreeLineWin[nLine3Off + iX] == fSrcNoDataValue )
-                    {
-                        bLastLineHasNoDataValue = true;
-                    }
-                }
-            }
-            abLineHasNoDataValue[nLine3Off / nXSize] = bLastLineHasNoDataValue;
-
-            bOneOfThreeLinesHasNoData = abLineHasNoDataValue[0] ||
-                                abLineHasNoDataValue[1] ||
-                                abLineHasNoDataValue[2];
-        }
-
-        if( bComputeAtEdges && nXSize >= 2 )
-        {
-            int j = 0;
-            T afWin[9] = {
-                INTERPOL(pafThreeLineWin[nLine1Off + j],
-                         pafThreeLineWin[nLine1Off + j+1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine1Off + j],
-                pafThreeLineWin[nLine1Off + j+1],
-                INTERPOL(pafThreeLineWin[nLine2Off + j],
-                         pafThreeLineWin[nLine2Off + j+1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine2Off + j],
-                pafThreeLineWin[nLine2Off + j+1],
-                INTERPOL(pafThreeLineWin[nLine3Off + j],
-                         pafThreeLineWin[nLine3Off + j+1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine3Off + j],
-                pafThreeLineWin[nLine3Off + j+1]
-            };
-
-            pafOutputBuf[j] =
-                ComputeVal(
-                    CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
-                    fSrcNoDataValue,
-                    CPL_TO_BOOL(bIsSrcNoDataNan),
-                    afWin, fDstNoDataValue,
-                    pfnAlg, pData, bComputeAtEdges);
-        }
-        else
-        {
-            // Exclude the edges
-            pafOutputBuf[0] = fDstNoDataValue;
-        }
-
-        int j = 1;
-        if( pfnAlg_multisample && !bOneOfThreeLinesHasNoData )
-        {
-            j = pfnAlg_multisample(pafThreeLineWin,
-                                   nLine1Off,
-                                   nLine2Off,
-                                   nLine3Off,
-                                   nXSize,
-                                   pData,
-                                   pafOutputBuf);
-        }
-
-        for( ; j < nXSize - 1; j++ )
-        {
-            T afWin[9] = {
-                pafThreeLineWin[nLine1Off + j-1],
-                pafThreeLineWin[nLine1Off + j],
-                pafThreeLineWin[nLine1Off + j+1],
-                pafThreeLineWin[nLine2Off + j-1],
-                pafThreeLineWin[nLine2Off + j],
-                pafThreeLineWin[nLine2Off + j+1],
-                pafThreeLineWin[nLine3Off + j-1],
-                pafThreeLineWin[nLine3Off + j],
-                pafThreeLineWin[nLine3Off + j+1]
-            };
-
-            pafOutputBuf[j] =
-                ComputeVal(
-                    CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
-                    fSrcNoDataValue,
-                    CPL_TO_BOOL(bIsSrcNoDataNan),
-                    afWin, fDstNoDataValue,
-                    pfnAlg, pData, bComputeAtEdges);
-        }
-
-        if( bComputeAtEdges && nXSize >= 2 )
-        {
-            j = nXSize - 1;
-
-            T afWin[9] = {
-                pafThreeLineWin[nLine1Off + j-1],
-                pafThreeLineWin[nLine1Off + j],
-                INTERPOL(pafThreeLineWin[nLine1Off + j],
-                         pafThreeLineWin[nLine1Off + j-1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine2Off + j-1],
-                pafThreeLineWin[nLine2Off + j],
-                INTERPOL(pafThreeLineWin[nLine2Off + j],
-                         pafThreeLineWin[nLine2Off + j-1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine3Off + j-1],
-                pafThreeLineWin[nLine3Off + j],
-                INTERPOL(pafThreeLineWin[nLine3Off + j],
-                         pafThreeLineWin[nLine3Off + j-1],
-                         bSrcHasNoData, fSrcNoDataValue)
-            };
-
-            pafOutputBuf[j] =
-                ComputeVal(
-                    CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
-                    fSrcNoDataValue,
-                    CPL_TO_BOOL(bIsSrcNoDataNan),
-                    afWin, fDstNoDataValue,
-                    pfnAlg, pData, bComputeAtEdges);
-        }
-        else
-        {
-            // Exclude the edges
-            if( nXSize > 1 )
-                pafOutputBuf[nXSize - 1] = fDstNoDataValue;
-        }
-
-        /* -----------------------------------------
-         * Write Line to Raster
-         */
-        eErr = GDALRasterIO(hDstBand, GF_Write, 0, i, nXSize, 1,
-                            pafOutputBuf, nXSize, 1, GDT_Float32, 0, 0);
-        if( eErr != CE_None )
-        {
-            CPLFree(pafOutputBuf);
-            CPLFree(pafThreeLineWin);
-
-            return eErr;
-        }
-
-        if( !pfnProgress( 1.0 * (i+1) / nYSize, nullptr, pProgressData ) )
-        {
-            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-            eErr = CE_Failure;
-
-            CPLFree(pafOutputBuf);
-            CPLFree(pafThreeLineWin);
-
-            return eErr;
-        }
-
-        const int nTemp = nLine1Off;
-        nLine1Off = nLine2Off;
-        nLine2Off = nLine3Off;
-        nLine3Off = nTemp;
-    }
-
-    if( bComputeAtEdges && nXSize >= 2 && nYSize >= 2 )
-    {
-        for( int j = 0; j < nXSize; j++ )
-        {
-            int jmin = (j == 0) ? j : j - 1;
-            int jmax = (j == nXSize - 1) ? j : j + 1;
-
-            T afWin[9] = {
-                pafThreeLineWin[nLine1Off + jmin],
-                pafThreeLineWin[nLine1Off + j],
-                pafThreeLineWin[nLine1Off + jmax],
-                pafThreeLineWin[nLine2Off + jmin],
-                pafThreeLineWin[nLine2Off + j],
-                pafThreeLineWin[nLine2Off + jmax],
-                INTERPOL(pafThreeLineWin[nLine2Off + jmin],
-                         pafThreeLineWin[nLine1Off + jmin],
-                         bSrcHasNoData, fSrcNoDataValue),
-                INTERPOL(pafThreeLineWin[nLine2Off + j],
-                         pafThreeLineWin[nLine1Off + j],
-                         bSrcHasNoData, fSrcNoDataValue),
-                INTERPOL(pafThreeLineWin[nLine2Off + jmax],
-                         pafThreeLineWin[nLine1Off + jmax],
-                         bSrcHasNoData, fSrcNoDataValue),
-            };
-
-            pafOutputBuf[j] = ComputeVal(
-                CPL_TO_BOOL(bSrcHasNoData),
-                fSrcNoDataValue,
-                CPL_TO_BOOL(bIsSrcNoDataNan),
-                afWin, fDstNoDataValue,
-                pfnAlg, pData, bComputeAtEdges);
-        }
-        eErr = GDALRasterIO(hDstBand, GF_Write,
-                            0, i, nXSize, 1,
-                            pafOutputBuf, nXSize, 1, GDT_Float32, 0, 0);
-        if( eErr != CE_None )
-        {
-            CPLFree(pafOutputBuf);
-            CPLFree(pafThreeLineWin);
-
-            return eErr;
-        }
-    }
-
-    pfnProgress( 1.0, nullptr, pProgressData );
-    eErr = CE_None;
-
-    CPLFree(pafOutputBuf);
-    CPLFree(pafThreeLineWin);
-
-    return eErr;
-}
-
-/************************************************************************/
-/*                            GradientAlg                               */
-/************************************************************************/
-
-typedef enum
-{
-    HORN,
-    ZEVENBERGEN_THORNE
-} GradientAlg;
-
-template<class T, GradientAlg alg> struct Gradient
-{
-    static void inline calc(const T* afWin, double inv_ewres, double inv_nsres,
-                            double&x, double&y);
-};
-
-template<class T> struct Gradient<T, HORN>
-{
-    static void calc(const T* afWin, double inv_ewres, double inv_nsres,
-                     double&x, double&y)
-    {
-        x = ((afWin[0] + afWin[3] + afWin[3] + afWin[6]) -
-             (afWin[2] + afWin[5] + afWin[5] + afWin[8])) * inv_ewres;
-
-        y = ((afWin[6] + afWin[7] + afWin[7] + afWin[8]) -
-             (afWin[0] + afWin[1] + afWin[1] + afWin[2])) * inv_nsres;
-    }
-};
-
-template<class T> struct Gradient<T, ZEVENBERGEN_THORNE>
-{
-    static void calc(const T* afWin, double inv_ewres, double inv_nsres,
-                     double&x, double&y)
-    {
-        x = (afWin[3] - afWin[5]) * inv_ewres;
-        y = (afWin[7] - afWin[1]) * inv_nsres;
-    }
-};
-
-/************************************************************************/
-/*                         GDALHillshade()                              */
-/************************************************************************/
-
-typedef struct
-{
-    double inv_nsres;
-    double inv_ewres;
-    double sin_altRadians;
-    double cos_alt_mul_z;
-    double azRadians;
-    double cos_az_mul_cos_alt_mul_z;
-    double sin_az_mul_cos_alt_mul_z;
-    double square_z;
-    double sin_altRadians_mul_254;
-    double cos_az_mul_cos_alt_mul_z_mul_254;
-    double sin_az_mul_cos_alt_mul_z_mul_254;
-
-    double square_z_mul_square_inv_res;
-    double cos_az_mul_cos_alt_mul_z_mul_254_mul_inv_res;
-    double sin_az_mul_cos_alt_mul_z_mul_254_mul_inv_res;
-} GDALHillshadeAlgData;
-
-/* Unoptimized formulas are :
-    x = psData->z*((afWin[0] + afWin[3] + afWin[3] + afWin[6]) -
-        (afWin[2] + afWin[5] + afWin[5] + afWin[8])) /
-        (8.0 * psData->ewres * psData->scale);
-
-    y = psData->z*((afWin[6] + afWin[7] + afWin[7] + afWin[8]) -
-        (afWin[0] + afWin[1] + afWin[1] + afWin[2])) /
-        (8.0 * psData->nsres * psData->scale);
-
-    slope = atan(sqrt(x*x + y*y));
-
-    aspect = atan2(y,x);
-
-    cang = sin(alt) * cos(slope) +
-           cos(alt) * sin(slope) *
-           cos(az - M_PI/2 - aspect);
-
-We can avoid a lot of trigonometric computations:
-
-    since cos(atan(x)) = 1 / sqrt(1+x^2)
-      ==> cos(slope) = 1 / sqrt(1+ x*x+y*y)
-
-      and sin(atan(x)) = x / sqrt(1+x^2)
-      ==> sin(slope) = sqrt(x*x + y*y) / sqrt(1+ x*x+y*y)
-
-      and cos(az - M_PI/2 - aspect)
-        = cos(-az + M_PI/2 + aspect)
-        = cos(M_PI/2 - (az - aspect))
-        = sin(az - aspect)
-        = -sin(aspect-az)
-
-==> cang = (sin(alt) - cos(alt) * sqrt(x*x + y*y)  * sin(aspect-as)) /
-           sqrt(1+ x*x+y*y)
-
-    But:
-    sin(aspect - az) = sin(aspect)*cos(az) - cos(aspect)*sin(az))
-
-and as sin(aspect)=sin(atan2(y,x)) = y / sqrt(xx_plus_yy)
-   and cos(aspect)=cos(atan2(y,x)) = x / sqrt(xx_plus_yy)
-
-    sin(aspect - az) = (y * cos(az) - x * sin(az)) / sqrt(xx_plus_yy)
-
-so we get a final formula with just one transcendental function
-(reciprocal of square root):
-
-    cang = (psData->sin_altRadians -
-           (y * psData->cos_az_mul_cos_alt_mul_z -
-            x * psData->sin_az_mul_cos_alt_mul_z)) /
-           sqrt(1 + psData->square_z * xx_plus_yy);
-*/
-
-#ifdef HAVE_SSE2
-inline double ApproxADivByInvSqrtB( double a, double b )
-{
-    __m128d regB = _mm_load_sd( &b );
-    __m128d regB_half = _mm_mul_sd( regB, _mm_set1_pd( 0.5 ) );
-    // Compute rough approximation of 1 / sqrt(b) with _mm_rsqrt_ss
-    regB = _mm_cvtss_sd( regB, _mm_rsqrt_ss(
-                            _mm_cvtsd_ss( _mm_setzero_ps(), regB ) ) );
-    // And perform one step of Newton-Raphson approximation to improve it
-    // approx_inv_sqrt_x = approx_inv_sqrt_x*(1.5 -
-    //                            0.5*x*approx_inv_sqrt_x*approx_inv_sqrt_x);
-    regB = _mm_mul_sd(regB, _mm_sub_sd( _mm_set1_pd( 1.5 ),
-                                        _mm_mul_sd(regB_half,
-                                                   _mm_mul_sd(regB, regB)) ) );
-    double dOut;
-    _mm_store_sd( &dOut, regB );
-    return a * dOut;
-}
-#else
-inline double ApproxADivByInvSqrtB( double a, double b )
-{
-    return a / sqrt(b);
-}
-#endif
-
-template<class T, GradientAlg alg>
-static
-float GDALHillshadeAlg (const T* afWin, float /*fDstNoDataValue*/, void* pData)
-{
-    GDALHillshadeAlgData* psData = static_cast<GDALHillshadeAlgData*>(pData);
-
-    // First Slope ...
-    double x, y;
-    Gradient<T, alg>::calc(afWin, psData->inv_ewres, psData->inv_nsres, x, y);
-
-    const double xx_plus_yy = x * x + y * y;
-
-    // ... then the shade value
-    const double cang_mul_254 =
-        ApproxADivByInvSqrtB(
-            psData->sin_altRadians_mul_254 -
-            (y * psData->cos_az_mul_cos_alt_mul_z_mul_254 -
-             x * psData->sin_az_mul_cos_alt_mul_z_mul_254),
-            1 + psData->square_z * xx_plus_yy);
-
-    const double cang = cang_mul_254 <= 0.0 ? 1.0 : 1.0 + cang_mul_254;
-
-    return static_cast<float>(cang);
-}
-
-template<class T>
-static
-float GDALHillshadeAlg_same_res (const T* afWin, float /*fDstNoDataValue*/, void* pData)
-{
-    GDALHillshadeAlgData* psData = static_cast<GDALHillshadeAlgData*>(pData);
-
-    // First Slope ...
-    /*x = (afWin[0] + afWin[3] + afWin[3] + afWin[6]) -
-        (afWin[2] + afWin[5] + afWin[5] + afWin[8]);
-
-    y = (afWin[0] + afWin[1] + afWin[1] + afWin[2]) -
-        (afWin[6] + afWin[7] + afWin[7] + afWin[8]);*/
-
-    T accX = afWin[0] - afWin[8];
-    const T six_minus_two = afWin[6] - afWin[2];
-    T accY = accX;
-    const T three_minus_five = afWin[3] - afWin[5];
-    const T one_minus_seven = afWin[1] - afWin[7];
-    accX += three_minus_five;
-    accY += one_minus_seven;
-    accX += three_minus_five;
-    accY += one_minus_seven;
-    accX += six_minus_two;
-    accY -= six_minus_two;
-    const double x = accX;
-    const double y = accY;
-
-    const double xx_plus_yy = x * x + y * y;
-
-    // ... then the shade value
-    const double cang_mul_254 =
-        ApproxADivByInvSqrtB(
-            psData->sin_altRadians_mul_254 +
-            (x * psData->sin_az_mul_cos_alt_mul_z_mul_254_mul_inv_res +
-             y * psData->cos_az_mul_cos_alt_mul_z_mul_254_mul_inv_res),
-            1 + psData->square_z_mul_square_inv_res * xx_plus_yy);
-
-    const double cang = cang_mul_254 <= 0.0 ? 1.0 : 1.0 + cang_mul_254;
-
-    return static_cast<float>(cang);
-}
-
-#ifdef HAVE_16_SSE_REG
-template<class T>
-static
-int GDALHillshadeAlg_same_res_multisample( const T* pafThreeLineWin,
-                                           int nLine1Off,
-                                           int nLine2Off,
-                                           int nLine3Off,
-                                           int nXSize,
-                                           void* pData,
-                                           float* pafOutputBuf )
-{
-    // Only valid for T == int
-
-    GDALHillshadeAlgData* psData = static_cast<GDALHillshadeAlgData*>(pData);
-    const __m128d reg_fact_x = _mm_load1_pd(
-                      &(psData->sin_az_mul_cos_alt_mul_z_mul_254_mul_inv_res));
-    const __m128d reg_fact_y = _mm_load1_pd (
-                      &(psData->cos_az_mul_cos_alt_mul_z_mul_254_mul_inv_res));
-    const __m128d reg_constant_num = _mm_load1_pd(
-                      &(psData->sin_altRadians_mul_254));
-    const __m128d reg_constant_denom = _mm_load1_pd(
-                      &(psData->square_z_mul_square_inv_res));
-    const __m128d reg_half = _mm_set1_pd(0.5);
-    const __m128d reg_one = _mm_add_pd(reg_half, reg_half);
-    const __m128 reg_one_float = _mm_set1_ps(1);
-
-    int j = 1;  // Used after for.
-    for( ; j < nXSize - 4; j+= 4 )
-    {
-        const T* firstLine  = pafThreeLineWin + nLine1Off + j-1;
-        const T* secondLine = pafThreeLineWin + nLine2Off + j-1;
-        const T* thirdLine  = pafThreeLineWin + nLine3Off + j-1;
-
-        __m128i firstLine0 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(firstLine) );
-        __m128i firstLine1 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(firstLine + 1) );
-        __m128i firstLine2 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(firstLine + 2) );
-        __m128i thirdLine0 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(thirdLine) );
-        __m128i thirdLine1 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(thirdLine + 1) );
-        __m128i thirdLine2 = _mm_loadu_si128( reinterpret_cast<__m128i const*>(thirdLine + 2) );
-        __m128i accX = _mm_sub_epi32( firstLine0, thirdLine2);
-        const __m128i six_minus_two = _mm_sub_epi32( thirdLine0, firstLine2 );
-        __m128i accY = accX;
-        const __m128i three_minus_five = _mm_sub_epi32(
-                          _mm_loadu_si128( reinterpret_cast<__m128i const*>(secondLine) ),
-                          _mm_loadu_si128( reinterpret_cast<__m128i const*>(secondLine+2) ) );
-        const __m128i one_minus_seven = _mm_sub_epi32( firstLine1, thirdLine1 );
-        accX = _mm_add_epi32(accX, three_minus_five);
-        accY = _mm_add_epi32(accY, one_minus_seven);
-        accX = _mm_add_epi32(accX, three_minus_five);
-        accY = _mm_add_epi32(accY, one_minus_seven);
-        accX = _mm_add_epi32(accX, six_minus_two);
-        accY = _mm_sub_epi32(accY, six_minus_two);
-
-        __m128d reg_x0 = _mm_cvtepi32_pd(accX);
-        __m128d reg_x1 = _mm_cvtepi32_pd(_mm_srli_si128(accX, 8));
-        __m128d reg_y0 = _mm_cvtepi32_pd(accY);
-        __m128d reg_y1 = _mm_cvtepi32_pd(_mm_srli_si128(accY, 8));
-        __m128d reg_xx_plus_yy0 = _mm_add_pd( _mm_mul_pd(reg_x0, reg_x0),
-                                              _mm_mul_pd(reg_y0, reg_y0) );
-        __m128d reg_xx_plus_yy1 = _mm_add_pd( _mm_mul_pd(reg_x1, reg_x1),
-                                              _mm_mul_pd(reg_y1, reg_y1) );
-
-        __m128d reg_numerator0 = _mm_add_pd(reg_constant_num,
-                  _mm_add_pd( _mm_mul_pd(reg_fact_x, reg_x0),
-                              _mm_mul_pd(reg_fact_y, reg_y0) ) );
-        __m128d reg_numerator1 = _mm_add_pd(reg_constant_num,
-                  _mm_add_pd( _mm_mul_pd(reg_fact_x, reg_x1),
-                              _mm_mul_pd(reg_fact_y, reg_y1) ) );
-        __m128d reg_denominator0 = _mm_add_pd(reg_one,
-                              _mm_mul_pd(reg_constant_denom, reg_xx_plus_yy0));
-        __m128d reg_denominator1 = _mm_add_pd(reg_one,
-                              _mm_mul_pd(reg_constant_denom, reg_xx_plus_yy1));
-
-        __m128d regB0 = reg_denominator0;
-        __m128d regB1 = reg_denominator1;
-        __m128d regB0_half = _mm_mul_pd( regB0, reg_half );
-        __m128d regB1_half = _mm_mul_pd( regB1, reg_half );
-        // Compute rough approximation of 1 / sqrt(b) with _mm_rsqrt_ps
-        regB0 = _mm_cvtps_pd( _mm_rsqrt_ps( _mm_cvtpd_ps( regB0 ) ) );
-        regB1 = _mm_cvtps_pd( _mm_rsqrt_ps( _mm_cvtpd_ps( regB1 ) ) );
-        // And perform one step of Newton-Raphson approximation to improve it
-        // approx_inv_sqrt_x = approx_inv_sqrt_x*(1.5 -
-        //                            0.5*x*approx_inv_sqrt_x*approx_inv_sqrt_x);
-        const __m128d reg_one_and_a_half = _mm_add_pd(reg_one, reg_half);
-        regB0 = _mm_mul_pd(regB0, _mm_sub_pd( reg_one_and_a_half,
-                                             _mm_mul_pd(regB0_half,
-                                                  _mm_mul_pd(regB0, regB0)) ) );
-        regB1 = _mm_mul_pd(regB1, _mm_sub_pd( reg_one_and_a_half,
-                                            _mm_mul_pd(regB1_half,
-                                                  _mm_mul_pd(regB1, regB1)) ) );
-        reg_numerator0 = _mm_mul_pd(reg_numerator0, regB0);
-        reg_numerator1 = _mm_mul_pd(reg_numerator1, regB1);
-
-        __m128 res = _mm_castsi128_ps(
-          _mm_unpacklo_epi64 (_mm_castps_si128(_mm_cvtpd_ps(reg_numerator0)),
-                              _mm_castps_si128(_mm_cvtpd_ps(reg_numerator1))));
-        res = _mm_add_ps(res, reg_one_float);
-        res = _mm_max_ps(res, reg_one_float);
-
-        _mm_storeu_ps( pafOutputBuf + j, res);
-    }
-    return j;
-}
-#endif
-
-static const double INV_SQUARE_OF_HALF_PI = 1.0 / ((M_PI*M_PI)/4);
-
-template<class T, GradientAlg alg>
-static
-float GDALHillshadeCombinedAlg (const T* afWin, float /*fDstNoDataValue*/, void* pData)
-{
-    GDALHillshadeAlgData* psData = static_cast<GDALHillshadeAlgData*>(pData);
-
-    // First Slope ...
-    double x, y;
-    Gradient<T, alg>::calc(afWin, psData->inv_ewres, psData->inv_nsres, x, y);
-
-    const double xx_plus_yy = x * x + y * y;
-
-    const double slope = xx_plus_yy * psData->square_z;
-
-    // ... then the shade value
-    double cang =
-        acos(
-            ApproxADivByInvSqrtB(
-                psData->sin_altRadians -
-                (y * psData->cos_az_mul_cos_alt_mul_z -
-                 x * psData->sin_az_mul_cos_alt_mul_z),
-                1 + slope));
-
-    // combined shading
-    cang = 1 - cang * atan(sqrt(slope)) * INV_SQUARE_OF_HALF_PI;
-
-    const float fcang =
-        cang <= 0.0
-        ? 1.0f
-        : static_cast<float>(1.0 + (254.0 * cang));
-
-    return fcang;
-}
-
-static
-void* GDALCreateHillshadeData( double* adfGeoTransform,
-                               double z,
-                               double scale,
-                               double alt,
-                               double az,
-                               bool bZevenbergenThorne )
-{
-    GDALHillshadeAlgData* pData = static_cast<GDALHillshadeAlgData *>(
-        CPLCalloc(1, sizeof(GDALHillshadeAlgData)));
-
-    pData->inv_nsres = 1.0 / adfGeoTransform[5];
-    pData->inv_ewres = 1.0 / adfGeoTransform[1];
-    pData->sin_altRadians = sin(alt * kdfDegreesToRadians);
-    pData->azRadians = az * kdfDegreesToRadians;
-    const double z_scaled = z / ((bZevenbergenThorne ? 2 : 8) * scale);
-    pData->cos_alt_mul_z =
-        cos(alt * kdfDegreesToRadians) * z_scaled;
-    pData->cos_az_mul_cos_alt_mul_z =
-        cos(pData->azRadians) * pData->cos_alt_mul_z;
-    pData->sin_az_mul_cos_alt_mul_z =
-        sin(pData->azRadians) * pData->cos_alt_mul_z;
-    pData->square_z = z_scaled * z_scaled;
-
-    pData->sin_altRadians_mul_254 = 254.0 *
-                                    pData->sin_altRadians;
-    pData->cos_az_mul_cos_alt_mul_z_mul_254 = 254.0 *
-        pData->cos_az_mul_cos_alt_mul_z;
-    pData->sin_az_mul_cos_alt_mul_z_mul_254 = 254.0 *
-        pData->sin_az_mul_cos_alt_mul_z;
-
-    if( adfGeoTransform[1] == -adfGeoTransform[5] )
-    {
-        pData->square_z_mul_square_inv_res =
-          pData->square_z * pData->inv_ewres * pData->inv_ewres;
-        pData->cos_az_mul_cos_alt_mul_z_mul_254_mul_inv_res =
-          pData->cos_az_mul_cos_alt_mul_z_mul_254 * -pData->inv_ewres;
-        pData->sin_az_mul_cos_alt_mul_z_mul_254_mul_inv_res =
-          pData->sin_az_mul_cos_alt_mul_z_mul_254 * pData->inv_ewres;
-    }
-
-    return pData;
-}
-
-/************************************************************************/
-/*                   GDALHillshadeMultiDirectional()                    */
-/************************************************************************/
-
-typedef struct
-{
-    double inv_nsres;
-    double inv_ewres;
-    double square_z;
-    double sin_altRadians_mul_127;
-    double sin_altRadians_mul_254;
-
-    double cos_alt_mul_z_mul_127;
-    double cos225_az_mul_cos_alt_mul_z_mul_127;
-
-} GDALHillshadeMultiDirectionalAlgData;
-
-template<class T, GradientAlg alg>
-static
-float GDALHillshadeMultiDirectionalAlg (const T* afWin,
-                                        float /*fDstNoDataValue*/,
-                                        void* pData)
-{
-    const GDALHillshadeMultiDirectionalAlgData* psData =
-            static_cast<const GDALHillshadeMultiDirectionalAlgData*>(pData);
-
-    // First Slope ...
-    double x, y;
-    Gradient<T, alg>::calc(afWin, psData->inv_ewres, psData->inv_nsres, x, y);
-
-    // See http://pubs.usgs.gov/of/1992/of92-422/of92-422.pdf
-    // W225 = sin^2(aspect - 225) = 0.5 * (1 - 2 * sin(aspect) * cos(aspect))
-    // W270 = sin^2(aspect - 270) = cos^2(aspect)
-    // W315 = sin^2(aspect - 315) = 0.5 * (1 + 2 * sin(aspect) * cos(aspect))
-    // W360 = sin^2(aspect - 360) = sin^2(aspect)
-    // hillshade=  0.5 * (W225 * hillshade(az=225) +
-    //                    W270 * hillshade(az=270) +
-    //                    W315 * hillshade(az=315) +
-    //                    W360 * hillshade(az=360))
-
-    const double xx = x * x;
-    const double yy = y * y;
-    const double xx_plus_yy = xx + yy;
-    if( xx_plus_yy == 0.0 )
-        return static_cast<float>(1.0 + psData->sin_altRadians_mul_254);
-
-    // ... then the shade value from different azimuth
-    double val225_mul_127 = psData->sin_altRadians_mul_127 +
-                            (x-y) * psData->cos225_az_mul_cos_alt_mul_z_mul_127;
-    val225_mul_127 = ( val225_mul_127 <= 0.0) ? 0.0 : val225_mul_127;
-    double val270_mul_127 = psData->sin_altRadians_mul_127 -
-                            x * psData->cos_alt_mul_z_mul_127;
-    val270_mul_127 = ( val270_mul_127 <= 0.0) ? 0.0 : val270_mul_127;
-    double val315_mul_127 = psData->sin_altRadians_mul_127 +
-                            (x+y) * psData->cos225_az_mul_cos_alt_mul_z_mul_127;
-    val315_mul_127 = ( val315_mul_127 <= 0.0) ? 0.0 : val315_mul_127;
-    double val360_mul_127 = psData->sin_altRadians_mul_127 -
-                            y * psData->cos_alt_mul_z_mul_127;
-    val360_mul_127 = ( val360_mul_127 <= 0.0) ? 0.0 : val360_mul_127;
-
-    // ... then the weighted shading
-    const double weight_225 = 0.5 * xx_plus_yy - x * y;
-    const double weight_270 = xx;
-    const double weight_315 = xx_plus_yy - weight_225;
-    const double weight_360 = yy;
-    const double cang_mul_127 = ApproxADivByInvSqrtB(
-                  (weight_225 * val225_mul_127 +
-                   weight_270 * val270_mul_127 +
-                   weight_315 * val315_mul_127 +
-                   weight_360 * val360_mul_127) / xx_plus_yy,
-            1 + psData->square_z * xx_plus_yy);
-
-    const double cang = 1.0 + cang_mul_127;
-
-    return static_cast<float>(cang);
-}
-
-static
-void* GDALCreateHillshadeMultiDirectionalData( double* adfGeoTransform,
-                                               double z,
-                                               double scale,
-                                               double alt,
-                                               bool bZevenbergenThorne )
-{
-    GDALHillshadeMultiDirectionalAlgData* pData =
-      static_cast<GDALHillshadeMultiDirectionalAlgData *>(
-          CPLCalloc(1, sizeof(GDALHillshadeMultiDirectionalAlgData)));
-
-    pData->inv_nsres = 1.0 / adfGeoTransform[5];
-    pData->inv_ewres = 1.0 / adfGeoTransform[1];
-    const double z_scaled = z / ((bZevenbergenThorne ? 2 : 8) * scale);
-    const double cos_alt_mul_z =
-        cos(alt * kdfDegreesToRadians) * z_scaled;
-    pData->square_z = z_scaled * z_scaled;
-
-    pData->sin_altRadians_mul_127 = 127.0 * sin(alt * kdfDegreesToRadians);
-    pData->sin_altRadians_mul_254 = 254.0 * sin(alt * kdfDegreesToRadians);
-    pData->cos_alt_mul_z_mul_127 = 127.0 * cos_alt_mul_z;
-    pData->cos225_az_mul_cos_alt_mul_z_mul_127 = 127.0 *
-        cos(225 * kdfDegreesToRadians) * cos_alt_mul_z;
-
-    return pData;
-}
-
-/************************************************************************/
-/*                         GDALSlope()                                  */
-/************************************************************************/
-
-typedef struct
-{
-    double nsres;
-    double ewres;
-    double scale;
-    int    slopeFormat;
-} GDALSlopeAlgData;
-
-template<class T>
-static
-float GDALSlopeHornAlg( const T* afWin, float /*fDstNoDataValue*/, void* pData )
-{
-    const GDALSlopeAlgData* psData = static_cast<const GDALSlopeAlgData*>(pData);
-
-    const double dx = ((afWin[0] + afWin[3] + afWin[3] + afWin[6]) -
-          (afWin[2] + afWin[5] + afWin[5] + afWin[8]))/psData->ewres;
-
-    const double dy = ((afWin[6] + afWin[7] + afWin[7] + afWin[8]) -
-          (afWin[0] + afWin[1] + afWin[1] + afWin[2]))/psData->nsres;
-
-    const double key = (dx * dx + dy * dy);
-
-    if( psData->slopeFormat == 1 )
-        return static_cast<float>(
-            atan(sqrt(key) / (8*psData->scale)) * kdfRadiansToDegrees);
-
-    return static_cast<float>(100*(sqrt(key) / (8*psData->scale)));
-}
-
-template<class T>
-static
-float GDALSlopeZevenbergenThorneAlg( const T* afWin,
-                                     float /*fDstNoDataValue*/,
-                                     void* pData )
-{
-    const GDALSlopeAlgData* psData = static_cast<const GDALSlopeAlgData*>(pData);
-
-    const double dx = (afWin[3] - afWin[5]) / psData->ewres;
-    const double dy = (afWin[7] - afWin[1]) / psData->nsres;
-    const double key = dx * dx + dy * dy;
-
-    if( psData->slopeFormat == 1 )
-        return static_cast<float>(
-            atan(sqrt(key) / (2*psData->scale)) * kdfRadiansToDegrees);
-
-    return static_cast<float>(100*(sqrt(key) / (2*psData->scale)));
-}
-
-static
-void* GDALCreateSlopeData( double* adfGeoTransform,
-                           double scale,
-                           int slopeFormat )
-{
-    GDALSlopeAlgData* pData =
-        static_cast<GDALSlopeAlgData*>(CPLMalloc(sizeof(GDALSlopeAlgData)));
-
-    pData->nsres = adfGeoTransform[5];
-    pData->ewres = adfGeoTransform[1];
-    pData->scale = scale;
-    pData->slopeFormat = slopeFormat;
-    return pData;
-}
-
-/************************************************************************/
-/*                         GDALAspect()                                 */
-/************************************************************************/
-
-typedef struct
-{
-    bool bAngleAsAzimuth;
-} GDALAspectAlgData;
-
-template<class T>
-static
-float GDALAspectAlg( const T* afWin, float fDstNoDataValue, void* pData )
-{
-    const GDALAspectAlgData* psData = static_cast<const GDALAspectAlgData*>(pData);
-
-    const double dx = ((afWin[2] + afWin[5] + afWin[5] + afWin[8]) -
-          (afWin[0] + afWin[3] + afWin[3] + afWin[6]));
-
-    const double dy = ((afWin[6] + afWin[7] + afWin[7] + afWin[8]) -
-          (afWin[0] + afWin[1] + afWin[1] + afWin[2]));
-
-    float aspect = static_cast<float>(atan2(dy,-dx) / kdfDegreesToRadians);
-
-    if( dx == 0 && dy == 0 )
-    {
-        /* Flat area */
-        aspect = fDstNoDataValue;
-    }
-    else if( psData->bAngleAsAzimuth )
-    {
-        if( aspect > 90.0f )
-            aspect = 450.0f - aspect;
-        else
-            aspect = 90.0f - aspect;
-    }
-    else
-    {
-        if( aspect < 0 )
-            aspect += 360.0f;
-    }
-
-    if( aspect == 360.0f )
-        aspect = 0.0;
-
-    return aspect;
-}
-
-template<class T>
-static
-float GDALAspectZevenbergenThorneAlg( const T* afWin, float fDstNoDataValue,
-                                      void* pData )
-{
-    const GDALAspectAlgData* psData = static_cast<const GDALAspectAlgData*>(pData);
-
-    const double dx = afWin[5] - afWin[3];
-    const double dy = afWin[7] - afWin[1];
-    float aspect = static_cast<float>(atan2(dy,-dx) / kdfDegreesToRadians);
-    if( dx == 0 && dy == 0 )
-    {
-        /* Flat area */
-        aspect = fDstNoDataValue;
-    }
-    else if( psData->bAngleAsAzimuth )
-    {
-        if( aspect > 90.0f )
-            aspect = 450.0f - aspect;
-        else
-            aspect = 90.0f - aspect;
-    }
-    else
-    {
-        if( aspect < 0 )
-            aspect += 360.0f;
-    }
-
-    if( aspect == 360.0f )
-        aspect = 0.0;
-
-    return aspect;
-}
-
-static
-void *GDALCreateAspectData( bool bAngleAsAzimuth )
-{
-    GDALAspectAlgData* pData =
-        static_cast<GDALAspectAlgData *>(CPLMalloc(sizeof(GDALAspectAlgData)));
-
-    pData->bAngleAsAzimuth = bAngleAsAzimuth;
-    return pData;
-}
+    /*! pointer to the progress data variable */
+    void *pProgressData;
+
+    double z;
+    double scale;
+    double az;
+    double alt;
+    int slopeFormat;
+    bool bAddAlpha;
+    bool bZeroForFlat;
+    bool bAngleAsAzimuth;
+    ColorSelectionMode eColorSelectionMode;
+    bool bComputeAtEdges;
+    bool bZevenbergenThorne;
+    bool bCombined;
+    bool bMultiDirectional;
+    char** papszCreateOptions;
+    int nBand;
+};
 
 /************************************************************************/
 /*                      GDALColorRelief()                               */
@@ -2450,716 +1226,136 @@ CPLErr GDALGenerateVRTColorRelief( const char* pszDstFilename,
         bOK &= VSIFPrintfL(fp, "  <SRS>%s</SRS>\n", pszEscapedString) > 0;
         VSIFree(pszEscapedString);
     }
-    double adfGT[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
-    if( GDALGetGeoTransform(hSrcDataset, adfGT) == CE_None )
-    {
-        bOK &= VSIFPrintfL(fp,
-                           "  <GeoTransform> %.16g, %.16g, %.16g, "
-                           "%.16g, %.16g, %.16g</GeoTransform>\n",
-                           adfGT[0], adfGT[1], adfGT[2],
-                           adfGT[3], adfGT[4], adfGT[5]) > 0;
-    }
-
-    int nBlockXSize = 0;
-    int nBlockYSize = 0;
-    GDALGetBlockSize(hSrcBand, &nBlockXSize, &nBlockYSize);
-
-    int bRelativeToVRT = FALSE;
-    CPLString osPath = CPLGetPath(pszDstFilename);
-    char* pszSourceFilename = CPLStrdup(
-        CPLExtractRelativePath( osPath.c_str(), GDALGetDescription(hSrcDataset),
-                                &bRelativeToVRT ));
-
-    const int nBands = 3 + (bAddAlpha ? 1 : 0);
-
-    for( int iBand = 0; iBand < nBands; iBand++ )
-    {
-        bOK &= VSIFPrintfL(
-            fp,
-            "  <VRTRasterBand dataType=\"Byte\" band=\"%d\">\n", iBand + 1) > 0;
-        bOK &= VSIFPrintfL(
-            fp, "    <ColorInterp>%s</ColorInterp>\n",
-            GDALGetColorInterpretationName(static_cast<GDALColorInterp>(GCI_RedBand + iBand))) > 0;
-        bOK &= VSIFPrintfL(
-            fp, "    <ComplexSource>\n") > 0;
-        bOK &= VSIFPrintfL(
-            fp,
-            "      <SourceFilename relativeToVRT=\"%d\">%s</SourceFilename>\n",
-            bRelativeToVRT, pszSourceFilename) > 0;
-        bOK &= VSIFPrintfL(
-            fp, "      <SourceBand>%d</SourceBand>\n",
-            GDALGetBandNumber(hSrcBand)) > 0;
-        bOK &= VSIFPrintfL(
-            fp, "      <SourceProperties RasterXSize=\"%d\" "
-            "RasterYSize=\"%d\" DataType=\"%s\" "
-            "BlockXSize=\"%d\" BlockYSize=\"%d\"/>\n",
-            nXSize, nYSize,
-            GDALGetDataTypeName(GDALGetRasterDataType(hSrcBand)),
-            nBlockXSize, nBlockYSize) > 0;
-        bOK &= VSIFPrintfL(
-            fp,
-            "      "
-            "<SrcRect xOff=\"0\" yOff=\"0\" xSize=\"%d\" ySize=\"%d\"/>\n",
-            nXSize, nYSize) > 0;
-        bOK &= VSIFPrintfL(
-            fp,
-            "      "
-            "<DstRect xOff=\"0\" yOff=\"0\" xSize=\"%d\" ySize=\"%d\"/>\n",
-            nXSize, nYSize) > 0;
-
-        bOK &= VSIFPrintfL(fp, "      <LUT>") > 0;
-
-        for( int iColor = 0; iColor < nColorAssociation; iColor++ )
-        {
-            if( eColorSelectionMode == COLOR_SELECTION_NEAREST_ENTRY )
-            {
-                if( iColor > 1 )
-                    bOK &= VSIFPrintfL(fp, ",") > 0;
-            }
-            else if( iColor > 0 )
-                bOK &= VSIFPrintfL(fp, ",") > 0;
-
-            const double dfVal = pasColorAssociation[iColor].dfVal;
-
-            if( eColorSelectionMode == COLOR_SELECTION_EXACT_ENTRY )
-            {
-                bOK &= VSIFPrintfL(fp, "%.18g:0,",
-                                   dfVal - fabs(dfVal) * DBL_EPSILON) > 0;
-            }
-            else if( iColor > 0 &&
-                     eColorSelectionMode == COLOR_SELECTION_NEAREST_ENTRY )
-            {
-                const double dfMidVal =
-                    (dfVal + pasColorAssociation[iColor-1].dfVal) / 2.0;
-                bOK &= VSIFPrintfL(
-                    fp, "%.18g:%d",
-                    dfMidVal - fabs(dfMidVal) * DBL_EPSILON,
-                    (iBand == 0) ? pasColorAssociation[iColor-1].nR :
-                    (iBand == 1) ? pasColorAssociation[iColor-1].nG :
-                    (iBand == 2) ? pasColorAssociation[iColor-1].nB :
-                    pasColorAssociation[iColor-1].nA) > 0;
-                bOK &= VSIFPrintfL(
-                    fp, ",%.18g:%d", dfMidVal,
-                    (iBand == 0) ? pasColorAssociation[iColor].nR :
-                    (iBand == 1) ? pasColorAssociation[iColor].nG :
-                    (iBand == 2) ? pasColorAssociation[iColor].nB :
-                    pasColorAssociation[iColor].nA) > 0;
-            }
-
-            if( eColorSelectionMode != COLOR_SELECTION_NEAREST_ENTRY )
-            {
-                if( dfVal != static_cast<double>(static_cast<int>(dfVal)) )
-                    bOK &= VSIFPrintfL(fp, "%.18g", dfVal) > 0;
-                else
-                    bOK &= VSIFPrintfL(fp, "%d", static_cast<int>(dfVal)) > 0;
-                bOK &= VSIFPrintfL(fp, ":%d",
-                            (iBand == 0) ? pasColorAssociation[iColor].nR :
-                            (iBand == 1) ? pasColorAssociation[iColor].nG :
-                            (iBand == 2) ? pasColorAssociation[iColor].nB :
-                                           pasColorAssociation[iColor].nA) > 0;
-            }
-
-            if( eColorSelectionMode == COLOR_SELECTION_EXACT_ENTRY )
-            {
-                bOK &= VSIFPrintfL(fp, ",%.18g:0",
-                                   dfVal + fabs(dfVal) * DBL_EPSILON) > 0;
-            }
-        }
-        bOK &= VSIFPrintfL(fp, "</LUT>\n") > 0;
-
-        bOK &= VSIFPrintfL(fp, "    </ComplexSource>\n") > 0;
-        bOK &= VSIFPrintfL(fp, "  </VRTRasterBand>\n") > 0;
-    }
-
-    CPLFree(pszSourceFilename);
-
-    bOK &= VSIFPrintfL(fp, "</VRTDataset>\n") > 0;
-
-    VSIFCloseL(fp);
-
-    CPLFree(pasColorAssociation);
-
-    return (bOK) ? CE_None : CE_Failure;
-}
-
-/************************************************************************/
-/*                         GDALTRIAlg()                                 */
-/************************************************************************/
-
-template<class T> static T MyAbs(T x);
-
-template<> float MyAbs( float x ) { return fabsf(x); }
-template<> int MyAbs( int x ) { return x >= 0 ? x : -x; }
-
-template<class T>
-static
-float GDALTRIAlg( const T* afWin,
-                  float /*fDstNoDataValue*/,
-                  void* /*pData*/ )
-{
-    // Terrain Ruggedness is average difference in height
-    return (MyAbs(afWin[0]-afWin[4]) +
-            MyAbs(afWin[1]-afWin[4]) +
-            MyAbs(afWin[2]-afWin[4]) +
-            MyAbs(afWin[3]-afWin[4]) +
-            MyAbs(afWin[5]-afWin[4]) +
-            MyAbs(afWin[6]-afWin[4]) +
-            MyAbs(afWin[7]-afWin[4]) +
-            MyAbs(afWin[8]-afWin[4])) * 0.125f;
-}
-
-/************************************************************************/
-/*                         GDALTPIAlg()                                 */
-/************************************************************************/
-
-template<class T>
-static
-float GDALTPIAlg( const T* afWin,
-                  float /*fDstNoDataValue*/,
-                  void* /*pData*/ )
-{
-    // Terrain Position is the difference between
-    // The central cell and the mean of the surrounding cells
-    return afWin[4] -
-            ((afWin[0]+
-              afWin[1]+
-              afWin[2]+
-              afWin[3]+
-              afWin[5]+
-              afWin[6]+
-              afWin[7]+
-              afWin[8]) * 0.125f );
-}
-
-/************************************************************************/
-/*                     GDALRoughnessAlg()                               */
-/************************************************************************/
-
-template<class T>
-static
-float GDALRoughnessAlg( const T* afWin, float /*fDstNoDataValue*/,
-                        void* /*pData*/ )
-{
-    // Roughness is the largest difference
-    //  between any two cells
-
-    T pafRoughnessMin = afWin[0];
-    T pafRoughnessMax = afWin[0];
-
-    for( int k = 1; k < 9; k++ )
-    {
-        if( afWin[k] > pafRoughnessMax )
-        {
-            pafRoughnessMax=afWin[k];
-        }
-        if( afWin[k] < pafRoughnessMin )
-        {
-            pafRoughnessMin=afWin[k];
-        }
-    }
-    return static_cast<float>(pafRoughnessMax - pafRoughnessMin);
-}
-
-/************************************************************************/
-/* ==================================================================== */
-/*                       GDALGeneric3x3Dataset                        */
-/* ==================================================================== */
-/************************************************************************/
-
-template<class T>
-class GDALGeneric3x3RasterBand;
-
-template<class T>
-class GDALGeneric3x3Dataset : public GDALDataset
-{
-    friend class GDALGeneric3x3RasterBand<T>;
-
-    typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg;
-    void*              pAlgData;
-    GDALDatasetH       hSrcDS;
-    GDALRasterBandH    hSrcBand;
-    T*                 apafSourceBuf[3];
-    int                bDstHasNoData;
-    double             dfDstNoDataValue;
-    int                nCurLine;
-    bool               bComputeAtEdges;
-
-  public:
-                        GDALGeneric3x3Dataset(
-                            GDALDatasetH hSrcDS,
-                            GDALRasterBandH hSrcBand,
-                            GDALDataType eDstDataType,
-                            int bDstHasNoData,
-                            double dfDstNoDataValue,
-                            typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg,
-                            void* pAlgData,
-                            bool bComputeAtEdges );
-                       ~GDALGeneric3x3Dataset();
-
-    bool                InitOK() const { return apafSourceBuf[0] != nullptr &&
-                                                apafSourceBuf[1] != nullptr &&
-                                                apafSourceBuf[2] != nullptr; }
-
-    CPLErr      GetGeoTransform( double * padfGeoTransform ) override;
-    const char *GetProjectionRef() override;
-};
-
-/************************************************************************/
-/* ==================================================================== */
-/*                    GDALGeneric3x3RasterBand                       */
-/* ==================================================================== */
-/************************************************************************/
-
-template<class T>
-class GDALGeneric3x3RasterBand : public GDALRasterBand
-{
-    friend class GDALGeneric3x3Dataset<T>;
-    int bSrcHasNoData;
-    T fSrcNoDataValue;
-    int bIsSrcNoDataNan;
-    GDALDataType eReadDT;
-
-    void                    InitWithNoData( void* pImage );
-
-  public:
-                 GDALGeneric3x3RasterBand( GDALGeneric3x3Dataset<T> *poDS,
-                                           GDALDataType eDstDataType );
-
-    virtual CPLErr          IReadBlock( int, int, void * ) override;
-    virtual double          GetNoDataValue( int* pbHasNoData ) override;
-};
-
-template<class T>
-GDALGeneric3x3Dataset<T>::GDALGeneric3x3Dataset(
-    GDALDatasetH hSrcDSIn,
-    GDALRasterBandH hSrcBandIn,
-    GDALDataType eDstDataType,
-    int bDstHasNoDataIn,
-    double dfDstNoDataValueIn,
-    typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlgIn,
-    void* pAlgDataIn,
-    bool bComputeAtEdgesIn ) :
-    pfnAlg(pfnAlgIn),
-    pAlgData(pAlgDataIn),
-    hSrcDS(hSrcDSIn),
-    hSrcBand(hSrcBandIn),
-    bDstHasNoData(bDstHasNoDataIn),
-    dfDstNoDataValue(dfDstNoDataValueIn),
-    nCurLine(-1),
-    bComputeAtEdges(bComputeAtEdgesIn)
-{
-    CPLAssert(eDstDataType == GDT_Byte || eDstDataType == GDT_Float32);
-
-    nRasterXSize = GDALGetRasterXSize(hSrcDS);
-    nRasterYSize = GDALGetRasterYSize(hSrcDS);
-
-    SetBand(1, new GDALGeneric3x3RasterBand<T>(this, eDstDataType));
-
-    apafSourceBuf[0] =
-        static_cast<T *>(VSI_MALLOC2_VERBOSE(sizeof(T), nRasterXSize));
-    apafSourceBuf[1] =
-        static_cast<T *>(VSI_MALLOC2_VERBOSE(sizeof(T), nRasterXSize));
-    apafSourceBuf[2] =
-        static_cast<T *>(VSI_MALLOC2_VERBOSE(sizeof(T), nRasterXSize));
-}
-
-template<class T>
-GDALGeneric3x3Dataset<T>::~GDALGeneric3x3Dataset()
-{
-    CPLFree(apafSourceBuf[0]);
-    CPLFree(apafSourceBuf[1]);
-    CPLFree(apafSourceBuf[2]);
-}
-
-template<class T>
-CPLErr GDALGeneric3x3Dataset<T>::GetGeoTransform( double * padfGeoTransform )
-{
-    return GDALGetGeoTransform(hSrcDS, padfGeoTransform);
-}
-
-template<class T>
-const char *GDALGeneric3x3Dataset<T>::GetProjectionRef()
-{
-    return GDALGetProjectionRef(hSrcDS);
-}
-
-template<class T>
-GDALGeneric3x3RasterBand<T>::GDALGeneric3x3RasterBand(
-    GDALGeneric3x3Dataset<T> *poDSIn,
-    GDALDataType eDstDataType ) :
-    bSrcHasNoData(FALSE),
-    fSrcNoDataValue(0),
-    bIsSrcNoDataNan(FALSE),
-    eReadDT(GDT_Unknown)
-{
-    poDS = poDSIn;
-    nBand = 1;
-    eDataType = eDstDataType;
-    nBlockXSize = poDS->GetRasterXSize();
-    nBlockYSize = 1;
-
-    const double dfNoDataValue = GDALGetRasterNoDataValue(poDSIn->hSrcBand,
-                                                          &bSrcHasNoData);
-    if( std::numeric_limits<T>::is_integer )
-    {
-        eReadDT = GDT_Int32;
-        if( bSrcHasNoData )
-        {
-            GDALDataType eSrcDT = GDALGetRasterDataType(poDSIn->hSrcBand);
-            CPLAssert( eSrcDT == GDT_Byte ||
-                       eSrcDT == GDT_UInt16 ||
-                       eSrcDT == GDT_Int16 );
-            const int nMinVal =
-                (eSrcDT == GDT_Byte ) ? 0 : (eSrcDT == GDT_UInt16) ? 0 : -32768;
-            const int nMaxVal =
-                (eSrcDT == GDT_Byte )
-                ? 255
-                : (eSrcDT == GDT_UInt16) ? 65535 : 32767;
-
-            if( fabs(dfNoDataValue - floor(dfNoDataValue + 0.5)) < 1e-2 &&
-                dfNoDataValue >= nMinVal && dfNoDataValue <= nMaxVal )
-            {
-                fSrcNoDataValue = static_cast<T>(floor(dfNoDataValue + 0.5));
-            }
-            else
-            {
-                bSrcHasNoData = FALSE;
-            }
-        }
-    }
-    else
-    {
-        eReadDT = GDT_Float32;
-        fSrcNoDataValue = static_cast<T>(dfNoDataValue);
-        bIsSrcNoDataNan = bSrcHasNoData && CPLIsNan(dfNoDataValue);
-    }
-}
-
-template<class T>
-void GDALGeneric3x3RasterBand<T>::InitWithNoData(void* pImage)
-{
-    auto poGDS = cpl::down_cast<GDALGeneric3x3Dataset<T> *>(poDS);
-    if( eDataType == GDT_Byte )
-    {
-        for( int j = 0; j < nBlockXSize; j++ )
-            static_cast<GByte*>(pImage)[j] = static_cast<GByte>(poGDS->dfDstNoDataValue);
-    }
-    else
+    double adfGT[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    if( GDALGetGeoTransform(hSrcDataset, adfGT) == CE_None )
     {
-        for( int j = 0; j < nBlockXSize; j++ )
-            static_cast<float*>(pImage)[j] = static_cast<float>(poGDS->dfDstNoDataValue);
+        bOK &= VSIFPrintfL(fp,
+                           "  <GeoTransform> %.16g, %.16g, %.16g, "
+                           "%.16g, %.16g, %.16g</GeoTransform>\n",
+                           adfGT[0], adfGT[1], adfGT[2],
+                           adfGT[3], adfGT[4], adfGT[5]) > 0;
     }
-}
 
-template<class T>
-CPLErr GDALGeneric3x3RasterBand<T>::IReadBlock( int /*nBlockXOff*/,
-                                                int nBlockYOff,
-                                                void *pImage )
-{
-    auto poGDS = cpl::down_cast<GDALGeneric3x3Dataset<T> *>(poDS);
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    GDALGetBlockSize(hSrcBand, &nBlockXSize, &nBlockYSize);
+
+    int bRelativeToVRT = FALSE;
+    CPLString osPath = CPLGetPath(pszDstFilename);
+    char* pszSourceFilename = CPLStrdup(
+        CPLExtractRelativePath( osPath.c_str(), GDALGetDescription(hSrcDataset),
+                                &bRelativeToVRT ));
+
+    const int nBands = 3 + (bAddAlpha ? 1 : 0);
 
-    if( poGDS->bComputeAtEdges && nRasterXSize >= 2 && nRasterYSize >= 2 )
+    for( int iBand = 0; iBand < nBands; iBand++ )
     {
-        if( nBlockYOff == 0 )
+        bOK &= VSIFPrintfL(
+            fp,
+            "  <VRTRasterBand dataType=\"Byte\" band=\"%d\">\n", iBand + 1) > 0;
+        bOK &= VSIFPrintfL(
+            fp, "    <ColorInterp>%s</ColorInterp>\n",
+            GDALGetColorInterpretationName(static_cast<GDALColorInterp>(GCI_RedBand + iBand))) > 0;
+        bOK &= VSIFPrintfL(
+            fp, "    <ComplexSource>\n") > 0;
+        bOK &= VSIFPrintfL(
+            fp,
+            "      <SourceFilename relativeToVRT=\"%d\">%s</SourceFilename>\n",
+            bRelativeToVRT, pszSourceFilename) > 0;
+        bOK &= VSIFPrintfL(
+            fp, "      <SourceBand>%d</SourceBand>\n",
+            GDALGetBandNumber(hSrcBand)) > 0;
+        bOK &= VSIFPrintfL(
+            fp, "      <SourceProperties RasterXSize=\"%d\" "
+            "RasterYSize=\"%d\" DataType=\"%s\" "
+            "BlockXSize=\"%d\" BlockYSize=\"%d\"/>\n",
+            nXSize, nYSize,
+            GDALGetDataTypeName(GDALGetRasterDataType(hSrcBand)),
+            nBlockXSize, nBlockYSize) > 0;
+        bOK &= VSIFPrintfL(
+            fp,
+            "      "
+            "<SrcRect xOff=\"0\" yOff=\"0\" xSize=\"%d\" ySize=\"%d\"/>\n",
+            nXSize, nYSize) > 0;
+        bOK &= VSIFPrintfL(
+            fp,
+            "      "
+            "<DstRect xOff=\"0\" yOff=\"0\" xSize=\"%d\" ySize=\"%d\"/>\n",
+            nXSize, nYSize) > 0;
+
+        bOK &= VSIFPrintfL(fp, "      <LUT>") > 0;
+
+        for( int iColor = 0; iColor < nColorAssociation; iColor++ )
         {
-            for( int i = 0; i < 2; i++ )
+            if( eColorSelectionMode == COLOR_SELECTION_NEAREST_ENTRY )
             {
-                CPLErr eErr = GDALRasterIO( poGDS->hSrcBand,
-                                    GF_Read,
-                                    0, i, nBlockXSize, 1,
-                                    poGDS->apafSourceBuf[i+1],
-                                    nBlockXSize, 1,
-                                    eReadDT,
-                                    0, 0);
-                if( eErr != CE_None )
-                {
-                    InitWithNoData(pImage);
-                    return eErr;
-                }
+                if( iColor > 1 )
+                    bOK &= VSIFPrintfL(fp, ",") > 0;
             }
-            poGDS->nCurLine = 0;
+            else if( iColor > 0 )
+                bOK &= VSIFPrintfL(fp, ",") > 0;
+
+            const double dfVal = pasColorAssociation[iColor].dfVal;
 
-            for( int j = 0; j < nRasterXSize; j++ )
+            if( eColorSelectionMode == COLOR_SELECTION_EXACT_ENTRY )
             {
-                int jmin = (j == 0) ? j : j - 1;
-                int jmax = (j == nRasterXSize - 1) ? j : j + 1;
-
-                T afWin[9] = {
-                    INTERPOL(poGDS->apafSourceBuf[1][jmin],
-                             poGDS->apafSourceBuf[2][jmin],
-                             bSrcHasNoData, fSrcNoDataValue),
-                    INTERPOL(poGDS->apafSourceBuf[1][j],
-                             poGDS->apafSourceBuf[2][j],
-                             bSrcHasNoData, fSrcNoDataValue),
-                    INTERPOL(poGDS->apafSourceBuf[1][jmax],
-                             poGDS->apafSourceBuf[2][jmax],
-                             bSrcHasNoData, fSrcNoDataValue),
-                    poGDS->apafSourceBuf[1][jmin],
-                    poGDS->apafSourceBuf[1][j],
-                    poGDS->apafSourceBuf[1][jmax],
-                    poGDS->apafSourceBuf[2][jmin],
-                    poGDS->apafSourceBuf[2][j],
-                    poGDS->apafSourceBuf[2][jmax]
-                };
-
-                const float fVal =
-                    ComputeVal(
-                        CPL_TO_BOOL(bSrcHasNoData),
-                        fSrcNoDataValue,
-                        CPL_TO_BOOL(bIsSrcNoDataNan),
-                        afWin,
-                        static_cast<float>(poGDS->dfDstNoDataValue),
-                        poGDS->pfnAlg,
-                        poGDS->pAlgData,
-                        poGDS->bComputeAtEdges);
-
-                if( eDataType == GDT_Byte )
-                    static_cast<GByte*>(pImage)[j] = static_cast<GByte>(fVal + 0.5);
-                else
-                    static_cast<float*>(pImage)[j] = fVal;
+                bOK &= VSIFPrintfL(fp, "%.18g:0,",
+                                   dfVal - fabs(dfVal) * DBL_EPSILON) > 0;
             }
-
-            return CE_None;
-        }
-        else if( nBlockYOff == nRasterYSize - 1 )
-        {
-            if( poGDS->nCurLine != nRasterYSize - 2 )
+            else if( iColor > 0 &&
+                     eColorSelectionMode == COLOR_SELECTION_NEAREST_ENTRY )
             {
-                for( int i = 0; i < 2; i++ )
-                {
-                    CPLErr eErr = GDALRasterIO(
-                        poGDS->hSrcBand,
-                        GF_Read,
-                        0, nRasterYSize - 2 + i, nBlockXSize, 1,
-                        poGDS->apafSourceBuf[i+1],
-                        nBlockXSize, 1,
-                        eReadDT,
-                        0, 0);
-                    if( eErr != CE_None )
-                    {
-                        InitWithNoData(pImage);
-                        return eErr;
-                    }
-                }
+                const double dfMidVal =
+                    (dfVal + pasColorAssociation[iColor-1].dfVal) / 2.0;
+                bOK &= VSIFPrintfL(
+                    fp, "%.18g:%d",
+                    dfMidVal - fabs(dfMidVal) * DBL_EPSILON,
+                    (iBand == 0) ? pasColorAssociation[iColor-1].nR :
+                    (iBand == 1) ? pasColorAssociation[iColor-1].nG :
+                    (iBand == 2) ? pasColorAssociation[iColor-1].nB :
+                    pasColorAssociation[iColor-1].nA) > 0;
+                bOK &= VSIFPrintfL(
+                    fp, ",%.18g:%d", dfMidVal,
+                    (iBand == 0) ? pasColorAssociation[iColor].nR :
+                    (iBand == 1) ? pasColorAssociation[iColor].nG :
+                    (iBand == 2) ? pasColorAssociation[iColor].nB :
+                    pasColorAssociation[iColor].nA) > 0;
             }
 
-            for( int j = 0; j < nRasterXSize; j++ )
+            if( eColorSelectionMode != COLOR_SELECTION_NEAREST_ENTRY )
             {
-                int jmin = (j == 0) ? j : j - 1;
-                int jmax = (j == nRasterXSize - 1) ? j : j + 1;
-
-                T afWin[9] = {
-                    poGDS->apafSourceBuf[1][jmin],
-                    poGDS->apafSourceBuf[1][j],
-                    poGDS->apafSourceBuf[1][jmax],
-                    poGDS->apafSourceBuf[2][jmin],
-                    poGDS->apafSourceBuf[2][j],
-                    poGDS->apafSourceBuf[2][jmax],
-                    INTERPOL(poGDS->apafSourceBuf[2][jmin],
-                             poGDS->apafSourceBuf[1][jmin],
-                             bSrcHasNoData, fSrcNoDataValue),
-                    INTERPOL(poGDS->apafSourceBuf[2][j],
-                             poGDS->apafSourceBuf[1][j],
-                             bSrcHasNoData, fSrcNoDataValue),
-                    INTERPOL(poGDS->apafSourceBuf[2][jmax],
-                             poGDS->apafSourceBuf[1][jmax],
-                             bSrcHasNoData, fSrcNoDataValue)
-                };
-
-                const float fVal =
-                    ComputeVal(
-                        CPL_TO_BOOL(bSrcHasNoData),
-                        fSrcNoDataValue,
-                        CPL_TO_BOOL(bIsSrcNoDataNan),
-                        afWin,
-                        static_cast<float>(poGDS->dfDstNoDataValue),
-                        poGDS->pfnAlg,
-                        poGDS->pAlgData,
-                        poGDS->bComputeAtEdges);
-
-                if( eDataType == GDT_Byte )
-                    static_cast<GByte*>(pImage)[j] = static_cast<GByte>(fVal + 0.5);
+                if( dfVal != static_cast<double>(static_cast<int>(dfVal)) )
+                    bOK &= VSIFPrintfL(fp, "%.18g", dfVal) > 0;
                 else
-                    static_cast<float*>(pImage)[j] = fVal;
+                    bOK &= VSIFPrintfL(fp, "%d", static_cast<int>(dfVal)) > 0;
+                bOK &= VSIFPrintfL(fp, ":%d",
+                            (iBand == 0) ? pasColorAssociation[iColor].nR :
+                            (iBand == 1) ? pasColorAssociation[iColor].nG :
+                            (iBand == 2) ? pasColorAssociation[iColor].nB :
+                                           pasColorAssociation[iColor].nA) > 0;
             }
 
-            return CE_None;
-        }
-    }
-    else if( nBlockYOff == 0 || nBlockYOff == nRasterYSize - 1 )
-    {
-        InitWithNoData(pImage);
-        return CE_None;
-    }
-
-    if( poGDS->nCurLine != nBlockYOff )
-    {
-        if( poGDS->nCurLine + 1 == nBlockYOff )
-        {
-            T* pafTmp = poGDS->apafSourceBuf[0];
-            poGDS->apafSourceBuf[0] = poGDS->apafSourceBuf[1];
-            poGDS->apafSourceBuf[1] = poGDS->apafSourceBuf[2];
-            poGDS->apafSourceBuf[2] = pafTmp;
-
-            CPLErr eErr = GDALRasterIO( poGDS->hSrcBand,
-                                    GF_Read,
-                                    0, nBlockYOff + 1, nBlockXSize, 1,
-                                    poGDS->apafSourceBuf[2],
-                                    nBlockXSize, 1,
-                                    eReadDT,
-                                    0, 0);
-
-            if( eErr != CE_None )
-            {
-                InitWithNoData(pImage);
-                return eErr;
-            }
-        }
-        else
-        {
-            for( int i = 0; i < 3; i++ )
+            if( eColorSelectionMode == COLOR_SELECTION_EXACT_ENTRY )
             {
-                const CPLErr eErr =
-                    GDALRasterIO(poGDS->hSrcBand,
-                                 GF_Read,
-                                 0, nBlockYOff + i - 1, nBlockXSize, 1,
-                                 poGDS->apafSourceBuf[i],
-                                 nBlockXSize, 1,
-                                 eReadDT,
-                                 0, 0);
-                if( eErr != CE_None )
-                {
-                    InitWithNoData(pImage);
-                    return eErr;
-                }
+                bOK &= VSIFPrintfL(fp, ",%.18g:0",
+                                   dfVal + fabs(dfVal) * DBL_EPSILON) > 0;
             }
         }
+        bOK &= VSIFPrintfL(fp, "</LUT>\n") > 0;
 
-        poGDS->nCurLine = nBlockYOff;
+        bOK &= VSIFPrintfL(fp, "    </ComplexSource>\n") > 0;
+        bOK &= VSIFPrintfL(fp, "  </VRTRasterBand>\n") > 0;
     }
 
-    if( poGDS->bComputeAtEdges && nRasterXSize >= 2 )
-    {
-        int j = 0;
-        T afWin[9] = {
-            INTERPOL(poGDS->apafSourceBuf[0][j], poGDS->apafSourceBuf[0][j+1],
-                     bSrcHasNoData, fSrcNoDataValue),
-            poGDS->apafSourceBuf[0][j],
-            poGDS->apafSourceBuf[0][j+1],
-            INTERPOL(poGDS->apafSourceBuf[1][j], poGDS->apafSourceBuf[1][j+1],
-                     bSrcHasNoData, fSrcNoDataValue),
-            poGDS->apafSourceBuf[1][j],
-            poGDS->apafSourceBuf[1][j+1],
-            INTERPOL(poGDS->apafSourceBuf[2][j], poGDS->apafSourceBuf[2][j+1],
-                     bSrcHasNoData, fSrcNoDataValue),
-            poGDS->apafSourceBuf[2][j],
-            poGDS->apafSourceBuf[2][j+1]
-        };
-
-        {
-            const float fVal =
-                ComputeVal(
-                    CPL_TO_BOOL(bSrcHasNoData),
-                    fSrcNoDataValue,
-                    CPL_TO_BOOL(bIsSrcNoDataNan),
-                    afWin,
-                    static_cast<float>(poGDS->dfDstNoDataValue),
-                    poGDS->pfnAlg,
-                    poGDS->pAlgData,
-                    poGDS->bComputeAtEdges);
-
-            if( eDataType == GDT_Byte )
-                static_cast<GByte*>(pImage)[j] = static_cast<GByte>(fVal + 0.5);
-            else
-                static_cast<float*>(pImage)[j] = fVal;
-        }
-
-        j = nRasterXSize - 1;
-
-        afWin[0] = poGDS->apafSourceBuf[0][j-1];
-        afWin[1] = poGDS->apafSourceBuf[0][j];
-        afWin[2] = INTERPOL(poGDS->apafSourceBuf[0][j], poGDS->apafSourceBuf[0][j-1], bSrcHasNoData, fSrcNoDataValue);
-        afWin[3] = poGDS->apafSourceBuf[1][j-1];
-        afWin[4] = poGDS->apafSourceBuf[1][j];
-        afWin[5] = INTERPOL(poGDS->apafSourceBuf[1][j], poGDS->apafSourceBuf[1][j-1], bSrcHasNoData, fSrcNoDataValue);
-        afWin[6] = poGDS->apafSourceBuf[2][j-1];
-        afWin[7] = poGDS->apafSourceBuf[2][j];
-        afWin[8] = INTERPOL(poGDS->apafSourceBuf[2][j], poGDS->apafSourceBuf[2][j-1], bSrcHasNoData, fSrcNoDataValue);
-
-        const float fVal =
-            ComputeVal(
-                CPL_TO_BOOL(bSrcHasNoData),
-                fSrcNoDataValue,
-                CPL_TO_BOOL(bIsSrcNoDataNan),
-                afWin,
-                static_cast<float>(poGDS->dfDstNoDataValue),
-                poGDS->pfnAlg,
-                poGDS->pAlgData,
-                poGDS->bComputeAtEdges);
-
-        if( eDataType == GDT_Byte )
-            static_cast<GByte*>(pImage)[j] = static_cast<GByte>(fVal + 0.5);
-        else
-            static_cast<float*>(pImage)[j] = fVal;
-    }
-    else
-    {
-        if( eDataType == GDT_Byte )
-        {
-            static_cast<GByte*>(pImage)[0] = static_cast<GByte>(poGDS->dfDstNoDataValue);
-            if( nBlockXSize > 1 )
-                static_cast<GByte*>(pImage)[nBlockXSize - 1] = static_cast<GByte>(poGDS->dfDstNoDataValue);
-        }
-        else
-        {
-            static_cast<float*>(pImage)[0] = static_cast<float>(poGDS->dfDstNoDataValue);
-            if( nBlockXSize > 1 )
-                static_cast<float*>(pImage)[nBlockXSize - 1] =
-                    static_cast<float>(poGDS->dfDstNoDataValue);
-        }
-    }
+    CPLFree(pszSourceFilename);
 
-    for( int j = 1; j < nBlockXSize - 1; j++ )
-    {
-        T afWin[9] = {
-            poGDS->apafSourceBuf[0][j-1],
-            poGDS->apafSourceBuf[0][j],
-            poGDS->apafSourceBuf[0][j+1],
-            poGDS->apafSourceBuf[1][j-1],
-            poGDS->apafSourceBuf[1][j],
-            poGDS->apafSourceBuf[1][j+1],
-            poGDS->apafSourceBuf[2][j-1],
-            poGDS->apafSourceBuf[2][j],
-            poGDS->apafSourceBuf[2][j+1]
-        };
-
-        const float fVal =
-            ComputeVal(
-                CPL_TO_BOOL(bSrcHasNoData),
-                fSrcNoDataValue,
-                CPL_TO_BOOL(bIsSrcNoDataNan),
-                afWin,
-                static_cast<float>(poGDS->dfDstNoDataValue),
-                poGDS->pfnAlg,
-                poGDS->pAlgData,
-                poGDS->bComputeAtEdges);
-
-        if( eDataType == GDT_Byte )
-            static_cast<GByte*>(pImage)[j] = static_cast<GByte>(fVal + 0.5);
-        else
-            static_cast<float*>(pImage)[j] = fVal;
-    }
+    bOK &= VSIFPrintfL(fp, "</VRTDataset>\n") > 0;
 
-    return CE_None;
-}
+    VSIFCloseL(fp);
 
-template<class T>
-double GDALGeneric3x3RasterBand<T>::GetNoDataValue( int* pbHasNoData )
-{
-    auto poGDS = cpl::down_cast<GDALGeneric3x3Dataset<T> *>(poDS);
-    if( pbHasNoData )
-        *pbHasNoData = poGDS->bDstHasNoData;
-    return poGDS->dfDstNoDataValue;
+    CPLFree(pasColorAssociation);
+
+    return (bOK) ? CE_None : CE_Failure;
 }
 
 /************************************************************************/
@@ -3224,6 +1420,100 @@ static Algorithm GetAlgorithm(const char* pszProcessing)
     }
 }
 
+/************************************************************************/
+/*                      GDALGenerateVRTDEMProduct()                     */
+/************************************************************************/
+
+// Writes a VRT whose source is the DERIVED_SUBDATASET:<product>:<source>
+// on-the-fly dataset, with the processing settings as open options, so that
+// the product is computed when the VRT is read.
+static GDALDatasetH GDALGenerateVRTDEMProduct(
+    const char* pszDstFilename,
+    GDALDatasetH hSrcDataset,
+    Algorithm eUtilityMode,
+    const GDALDEMProcessingOptions* psOptions )
+{
+    CPLString osSrcFilename(GDALGetDescription(hSrcDataset));
+    if( osSrcFilename.empty() )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "VRT output requires a source dataset with a filename.");
+        return nullptr;
+    }
+    VSIStatBufL sStat;
+    if( CPLIsFilenameRelative(osSrcFilename) &&
+        VSIStatL(osSrcFilename, &sStat) == 0 )
+    {
+        char* pszCurDir = CPLGetCurrentDir();
+        if( pszCurDir != nullptr )
+            osSrcFilename = CPLFormFilename(pszCurDir, osSrcFilename, nullptr);
+        CPLFree(pszCurDir);
+    }
+
+    const char* pszProduct =
+        (eUtilityMode == HILL_SHADE && psOptions->bMultiDirectional)
+        ? "MULTIDIRECTIONAL_HILLSHADE"
+        : (eUtilityMode == HILL_SHADE) ? "HILLSHADE"
+        : (eUtilityMode == SLOPE) ? "SLOPE" : "ASPECT";
+
+    char** papszOpenOptions = nullptr;
+    papszOpenOptions = CSLSetNameValue(papszOpenOptions, "BAND",
+                                       CPLSPrintf("%d", psOptions->nBand));
+    papszOpenOptions = CSLSetNameValue(papszOpenOptions, "SCALE",
+                                       CPLSPrintf("%.18g", psOptions->scale));
+    if( psOptions->bZevenbergenThorne )
+        papszOpenOptions = CSLSetNameValue(papszOpenOptions, "ALG",
+                                           "ZevenbergenThorne");
+    if( psOptions->bComputeAtEdges )
+        papszOpenOptions = CSLSetNameValue(papszOpenOptions,
+                                           "COMPUTE_EDGES", "YES");
+    if( eUtilityMode == HILL_SHADE )
+    {
+        papszOpenOptions = CSLSetNameValue(papszOpenOptions, "Z_FACTOR",
+                                           CPLSPrintf("%.18g", psOptions->z));
+        papszOpenOptions = CSLSetNameValue(papszOpenOptions, "ALTITUDE",
+                                           CPLSPrintf("%.18g", psOptions->alt));
+        if( !psOptions->bMultiDirectional )
+            papszOpenOptions = CSLSetNameValue(papszOpenOptions, "AZIMUTH",
+                                           CPLSPrintf("%.18g", psOptions->az));
+        if( psOptions->bCombined )
+            papszOpenOptions = CSLSetNameValue(papszOpenOptions,
+                                               "COMBINED", "YES");
+    }
+    else if( eUtilityMode == SLOPE )
+    {
+        if( psOptions->slopeFormat == 0 )
+            papszOpenOptions = CSLSetNameValue(papszOpenOptions,
+                                               "SLOPE_FORMAT", "PERCENT");
+    }
+    else
+    {
+        if( !psOptions->bAngleAsAzimuth )
+            papszOpenOptions = CSLSetNameValue(papszOpenOptions,
+                                               "TRIGONOMETRIC", "YES");
+        if( psOptions->bZeroForFlat )
+            papszOpenOptions = CSLSetNameValue(papszOpenOptions,
+                                               "ZERO_FOR_FLAT", "YES");
+    }
+
+    CPLString osConnectionString;
+    osConnectionString.Printf("DERIVED_SUBDATASET:%s:%s",
+                              pszProduct, osSrcFilename.c_str());
+    GDALDatasetH hProductDS =
+        GDALOpenEx(osConnectionString, GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR,
+                   nullptr, papszOpenOptions, nullptr);
+    CSLDestroy(papszOpenOptions);
+    if( hProductDS == nullptr )
+        return nullptr;
+
+    GDALDatasetH hOutDS =
+        GDALCreateCopy(GDALGetDriverByName("VRT"), pszDstFilename,
+                       hProductDS, FALSE, psOptions->papszCreateOptions,
+                       psOptions->pfnProgress, psOptions->pProgressData);
+    GDALClose(hProductDS);
+    return hOutDS;
+}
+
 /************************************************************************/
 /*                            GDALDEMProcessing()                       */
 /************************************************************************/
@@ -3237,6 +1527,13 @@ static Algorithm GetAlgorithm(const char* pszProcessing)
  * GDALDEMProcessingOptionsNew() and GDALDEMProcessingOptionsFree()
  * respectively.
  *
+ * With the VRT output format, the "hillshade", "slope" and "aspect" products
+ * are computed on the fly, by blocks, when the output is read. If pszDest is
+ * an empty string, the returned dataset computes them directly, and keeps a
+ * reference on hSrcDataset, which must not be closed before it. Otherwise a
+ * VRT file is written, whose source is the DERIVED_SUBDATASET of the product
+ * on the source file.
+ *
  * @param pszDest the destination dataset path.
  * @param hSrcDataset the source dataset handle.
  * @param pszProcessing the processing to apply (one of "hillshade", "slope",
@@ -3399,147 +1696,29 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
         return nullptr;
     }
 
-    double dfDstNoDataValue = 0.0;
-    bool bDstHasNoData = false;
-    void* pData = nullptr;
-    GDALGeneric3x3ProcessingAlg<float>::type pfnAlgFloat = nullptr;
-    GDALGeneric3x3ProcessingAlg<GInt32>::type pfnAlgInt32 = nullptr;
-    GDALGeneric3x3ProcessingAlg_multisample<GInt32>::type pfnAlgInt32_multisample = nullptr;
-
-    if( eUtilityMode == HILL_SHADE && psOptions->bMultiDirectional )
-    {
-        dfDstNoDataValue = 0;
-        bDstHasNoData = true;
-        pData = GDALCreateHillshadeMultiDirectionalData(adfGeoTransform,
-                                                        psOptions->z,
-                                                        psOptions->scale,
-                                                        psOptions->alt,
-                                                        psOptions->bZevenbergenThorne);
-        if( psOptions->bZevenbergenThorne )
-        {
-            pfnAlgFloat = GDALHillshadeMultiDirectionalAlg<float, ZEVENBERGEN_THORNE>;
-            pfnAlgInt32 = GDALHillshadeMultiDirectionalAlg<GInt32, ZEVENBERGEN_THORNE>;
-        }
-        else
-        {
-            pfnAlgFloat = GDALHillshadeMultiDirectionalAlg<float, HORN>;
-            pfnAlgInt32 = GDALHillshadeMultiDirectionalAlg<GInt32, HORN>;
-        }
-    }
-    else if( eUtilityMode == HILL_SHADE )
-    {
-        dfDstNoDataValue = 0;
-        bDstHasNoData = true;
-        pData = GDALCreateHillshadeData(adfGeoTransform,
-                                        psOptions->z,
-                                        psOptions->scale,
-                                        psOptions->alt,
-                                        psOptions->az,
-                                        psOptions->bZevenbergenThorne);
-        if( psOptions->bZevenbergenThorne )
-        {
-            if( !psOptions->bCombined )
-            {
-                pfnAlgFloat = GDALHillshadeAlg<float, ZEVENBERGEN_THORNE>;
-                pfnAlgInt32 = GDALHillshadeAlg<GInt32, ZEVENBERGEN_THORNE>;
-            }
-            else
-            {
-                pfnAlgFloat = GDALHillshadeCombinedAlg<float, ZEVENBERGEN_THORNE>;
-                pfnAlgInt32 = GDALHillshadeCombinedAlg<GInt32, ZEVENBERGEN_THORNE>;
-            }
-        }
-        else
-        {
-            if( !psOptions->bCombined )
-            {
-                if( adfGeoTransform[1] == -adfGeoTransform[5] )
-                {
-                    pfnAlgFloat = GDALHillshadeAlg_same_res<float>;
-                    pfnAlgInt32 = GDALHillshadeAlg_same_res<GInt32>;
-#ifdef HAVE_16_SSE_REG
-                    pfnAlgInt32_multisample =
-                                GDALHillshadeAlg_same_res_multisample<GInt32>;
-#endif
-                }
-                else
-                {
-                    pfnAlgFloat = GDALHillshadeAlg<float, HORN>;
-                    pfnAlgInt32 = GDALHillshadeAlg<GInt32, HORN>;
-                }
-            }
-            else
-            {
-                pfnAlgFloat = GDALHillshadeCombinedAlg<float, HORN>;
-                pfnAlgInt32 = GDALHillshadeCombinedAlg<GInt32, HORN>;
-            }
-        }
-    }
-    else if( eUtilityMode == SLOPE )
-    {
-        dfDstNoDataValue = -9999;
-        bDstHasNoData = true;
-
-        pData = GDALCreateSlopeData(adfGeoTransform, psOptions->scale, psOptions->slopeFormat);
-        if( psOptions->bZevenbergenThorne )
-        {
-            pfnAlgFloat = GDALSlopeZevenbergenThorneAlg<float>;
-            pfnAlgInt32 = GDALSlopeZevenbergenThorneAlg<GInt32>;
-        }
-        else
-        {
-            pfnAlgFloat = GDALSlopeHornAlg<float>;
-            pfnAlgInt32 = GDALSlopeHornAlg<GInt32>;
-        }
-    }
-
-    else if( eUtilityMode == ASPECT )
-    {
-        if( !psOptions->bZeroForFlat )
-        {
-            dfDstNoDataValue = -9999;
-            bDstHasNoData = true;
-        }
-
-        pData = GDALCreateAspectData(psOptions->bAngleAsAzimuth);
-        if( psOptions->bZevenbergenThorne )
-        {
-            pfnAlgFloat = GDALAspectZevenbergenThorneAlg<float>;
-            pfnAlgInt32 = GDALAspectZevenbergenThorneAlg<GInt32>;
-        }
-        else
-        {
-            pfnAlgFloat = GDALAspectAlg<float>;
-            pfnAlgInt32 = GDALAspectAlg<GInt32>;
-        }
-    }
-    else if( eUtilityMode == TRI )
-    {
-        dfDstNoDataValue = -9999;
-        bDstHasNoData = true;
-        pfnAlgFloat = GDALTRIAlg<float>;
-        pfnAlgInt32 = GDALTRIAlg<GInt32>;
-    }
-    else if( eUtilityMode == TPI )
-    {
-        dfDstNoDataValue = -9999;
-        bDstHasNoData = true;
-        pfnAlgFloat = GDALTPIAlg<float>;
-        pfnAlgInt32 = GDALTPIAlg<GInt32>;
-    }
-    else if( eUtilityMode == ROUGHNESS )
-    {
-        dfDstNoDataValue = -9999;
-        bDstHasNoData = true;
-        pfnAlgFloat = GDALRoughnessAlg<float>;
-        pfnAlgInt32 = GDALRoughnessAlg<GInt32>;
-    }
+    GDALDEMAlgOptions sAlgOptions;
+    sAlgOptions.eAlg =
+        (eUtilityMode == SLOPE) ? GDEM_SLOPE :
+        (eUtilityMode == ASPECT) ? GDEM_ASPECT :
+        (eUtilityMode == TRI) ? GDEM_TRI :
+        (eUtilityMode == TPI) ? GDEM_TPI :
+        (eUtilityMode == ROUGHNESS) ? GDEM_ROUGHNESS : GDEM_HILLSHADE;
+    sAlgOptions.z = psOptions->z;
+    sAlgOptions.scale = psOptions->scale;
+    sAlgOptions.az = psOptions->az;
+    sAlgOptions.alt = psOptions->alt;
+    sAlgOptions.slopeFormat = psOptions->slopeFormat;
+    sAlgOptions.bZevenbergenThorne = psOptions->bZevenbergenThorne;
+    sAlgOptions.bCombined = psOptions->bCombined;
+    sAlgOptions.bMultiDirectional = psOptions->bMultiDirectional;
+    sAlgOptions.bAngleAsAzimuth = psOptions->bAngleAsAzimuth;
+    sAlgOptions.bZeroForFlat = psOptions->bZeroForFlat;
+    sAlgOptions.bComputeAtEdges = psOptions->bComputeAtEdges;
 
     const GDALDataType eDstDataType =
-        (eUtilityMode == HILL_SHADE ||
-         eUtilityMode == COLOR_RELIEF)
+        (eUtilityMode == COLOR_RELIEF)
         ? GDT_Byte
-        : GDT_Float32;
+        : GDALDEMGetOutputDataType(&sAlgOptions);
 
     if( EQUAL(osFormat, "VRT") )
     {
@@ -3552,17 +1731,34 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
                                        psOptions->eColorSelectionMode,
                                        psOptions->bAddAlpha);
 
-            CPLFree(pData);
-
             GDALDEMProcessingOptionsFree(psOptionsToFree);
             return GDALOpen(pszDest, GA_Update);
         }
+        else if( eUtilityMode == HILL_SHADE ||
+                 eUtilityMode == SLOPE ||
+                 eUtilityMode == ASPECT )
+        {
+            GDALDatasetH hOutDS = nullptr;
+            if( pszDest[0] == '\0' )
+            {
+                // Return the on-the-fly dataset itself.
+                hOutDS = GDALDEMCreateOnTheFlyDataset(
+                    hSrcDataset, psOptions->nBand, &sAlgOptions);
+            }
+            else
+            {
+                hOutDS = GDALGenerateVRTDEMProduct(pszDest, hSrcDataset,
+                                                   eUtilityMode, psOptions);
+            }
+            GDALDEMProcessingOptionsFree(psOptionsToFree);
+            return hOutDS;
+        }
         else
         {
             CPLError(CE_Failure, CPLE_NotSupported,
-                     "VRT driver can only be used with color-relief utility.");
+                     "VRT driver can only be used with color-relief, "
+                     "hillshade, slope and aspect utilities.");
             GDALDEMProcessingOptionsFree(psOptionsToFree);
-            CPLFree(pData);
             return nullptr;
         }
     }
@@ -3600,8 +1796,6 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
 #endif
     }
 
-    const GDALDataType eSrcDT = GDALGetRasterDataType(hSrcBand);
-
     if( GDALGetMetadataItem( hDriver, GDAL_DCAP_RASTER, nullptr) != nullptr &&
         ((bForceUseIntermediateDataset ||
           GDALGetMetadataItem( hDriver, GDAL_DCAP_CREATE, nullptr ) == nullptr) &&
@@ -3620,7 +1814,6 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
             if( !(poDS->InitOK()) )
             {
                 delete poDS;
-                CPLFree(pData);
                 GDALDEMProcessingOptionsFree(psOptionsToFree);
                 return nullptr;
             }
@@ -3628,47 +1821,12 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
         }
         else
         {
-            if( eSrcDT == GDT_Byte ||
-                eSrcDT == GDT_Int16 ||
-                eSrcDT == GDT_UInt16 )
-            {
-                GDALGeneric3x3Dataset<GInt32>* poDS =
-                    new GDALGeneric3x3Dataset<GInt32>(hSrcDataset, hSrcBand,
-                                            eDstDataType,
-                                            bDstHasNoData,
-                                            dfDstNoDataValue,
-                                            pfnAlgInt32,
-                                            pData,
-                                            psOptions->bComputeAtEdges);
-
-                if( !(poDS->InitOK()) )
-                {
-                    delete poDS;
-                    CPLFree(pData);
-                    GDALDEMProcessingOptionsFree(psOptionsToFree);
-                    return nullptr;
-                }
-                hIntermediateDataset = static_cast<GDALDatasetH>(poDS);
-            }
-            else
+            hIntermediateDataset = GDALDEMCreateOnTheFlyDataset(
+                hSrcDataset, psOptions->nBand, &sAlgOptions);
+            if( hIntermediateDataset == nullptr )
             {
-                GDALGeneric3x3Dataset<float>* poDS =
-                    new GDALGeneric3x3Dataset<float>(hSrcDataset, hSrcBand,
-                                            eDstDataType,
-                                            bDstHasNoData,
-                                            dfDstNoDataValue,
-                                            pfnAlgFloat,
-                                            pData,
-                                            psOptions->bComputeAtEdges);
-
-                if( !(poDS->InitOK()) )
-                {
-                    delete poDS;
-                    CPLFree(pData);
-                    GDALDEMProcessingOptionsFree(psOptionsToFree);
-                    return nullptr;
-                }
-                hIntermediateDataset = static_cast<GDALDatasetH>(poDS);
+                GDALDEMProcessingOptionsFree(psOptionsToFree);
+                return nullptr;
             }
         }
 
@@ -3679,8 +1837,6 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
 
         GDALClose(hIntermediateDataset);
 
-        CPLFree(pData);
-
         GDALDEMProcessingOptionsFree(psOptionsToFree);
         return hOutDS;
     }
@@ -3704,7 +1860,6 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
         CPLError(CE_Failure, CPLE_AppDefined,
                  "Unable to create dataset %s", pszDest );
         GDALDEMProcessingOptionsFree(psOptionsToFree);
-        CPLFree(pData);
         return nullptr;
     }
 
@@ -3726,31 +1881,14 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
     }
     else
     {
-        if( bDstHasNoData )
+        double dfDstNoDataValue = 0.0;
+        if( GDALDEMGetOutputNoData(&sAlgOptions, &dfDstNoDataValue) )
             GDALSetRasterNoDataValue(hDstBand, dfDstNoDataValue);
 
-        if( eSrcDT == GDT_Byte || eSrcDT == GDT_Int16 || eSrcDT == GDT_UInt16 )
-        {
-            GDALGeneric3x3Processing<GInt32>(hSrcBand, hDstBand,
-                                             pfnAlgInt32,
-                                             pfnAlgInt32_multisample,
-                                             pData,
-                                             psOptions->bComputeAtEdges,
-                                             pfnProgress, pProgressData);
-        }
-        else
-        {
-            GDALGeneric3x3Processing<float>(hSrcBand, hDstBand,
-                                            pfnAlgFloat,
-                                            nullptr,
-                                            pData,
-                                            psOptions->bComputeAtEdges,
-                                            pfnProgress, pProgressData);
-        }
+        GDALDEMProcessBand(hSrcBand, hDstBand, adfGeoTransform, &sAlgOptions,
+                           pfnProgress, pProgressData);
     }
 
-    CPLFree(pData);
-
     GDALDEMProcessingOptionsFree(psOptionsToFree);
     return hDstDataset;
 }
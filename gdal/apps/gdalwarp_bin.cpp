@@ -144,7 +144,8 @@ to select a particular level. Specify AUTO-n where n is an integer greater or
 equal to 1, to select an overview level below the AUTO one. Or specify NONE to
 force the base resolution to be used (can be useful if overviews have been
 generated with a low quality resampling method, and the warping is done using a
-higher quality resampling method).</dd>
+higher quality resampling method). The sum resampling method always uses the
+base resolution.</dd>
 <dt> <b>-wo</b> <em>"NAME=VALUE"</em>:</dt><dd> Set a warp option.  The
 GDALWarpOptions::papszWarpOptions docs show all options.  Multiple
  <b>-wo</b> options may be listed.</dd>
@@ -167,6 +168,7 @@ algorithm, worst interpolation quality).</dd>
 <dt><b>med</b></dt>: <dd>median resampling, selects the median value of all non-NODATA contributing pixels. (GDAL >= 2.0.0)</dd>
 <dt><b>q1</b></dt>: <dd>first quartile resampling, selects the first quartile value of all non-NODATA contributing pixels. (GDAL >= 2.0.0)</dd>
 <dt><b>q3</b></dt>: <dd>third quartile resampling, selects the third quartile value of all non-NODATA contributing pixels. (GDAL >= 2.0.0)</dd>
+<dt><b>sum</b></dt>: <dd>sum resampling, computes the sum of all non-NODATA contributing pixels. The output data type (see <b>-ot</b>) must be large enough to hold the sums. Source overviews are not used (see <b>-ovr</b>). (GDAL >= 2.4.0)</dd>
 </dl>
 <dt> <b>-srcnodata</b> <em>value [value...]</em>:</dt><dd> Set nodata masking
 values for input bands (different values can be supplied for each band).  If
@@ -189,10 +191,12 @@ nodata (unset/transparent) pixels. </dd>
 <dt> <b>-wm</b> <em>memory_in_mb</em>:</dt><dd> Set the amount of memory (in
 megabytes) that the warp API is allowed to use for caching.</dd>
 <dt> <b>-multi</b>:</dt><dd> Use multithreaded warping implementation.
-Two threads will be used to process chunks of image and perform
-input/output operation simultaneously. Note that computation is not
-multithreaded itself. To do that, you can use the -wo NUM_THREADS=val/ALL_CPUS
-option, which can be combined with -multi</dd>
+Several chunks of image are processed simultaneously, so that reading the
+input, warping and writing the output overlap. Starting with GDAL 2.4, the
+number of chunks in flight can be set with -wo CHUNKS_IN_FLIGHT=val (3 by
+default). Note that computation is not multithreaded itself. To do that, you
+can use the -wo NUM_THREADS=val/ALL_CPUS option, which can be combined with
+-multi</dd>
 <dt> <b>-q</b>:</dt><dd> Be quiet.</dd>
 <dt> <b>-of</b> <em>format</em>:</dt><dd> Select the output format. The default is GeoTIFF (GTiff). Use the short format name. </dd>
 <dt> <b>-co</b> <em>"NAME=VALUE"</em>:</dt><dd> passes a creation option to
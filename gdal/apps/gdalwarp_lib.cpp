@@ -150,7 +150,7 @@ struct GDALWarpAppOptions
 
     /*! the resampling method. Available methods are: near, bilinear,
         cubic, cubicspline, lanczos, average, mode, max, min, med,
-        q1, q3 */
+        q1, q3, sum */
     GDALResampleAlg eResampleAlg;
 
     /*! nodata masking values for input bands (different values can be supplied
@@ -3410,6 +3410,8 @@ GDALWarpAppOptions *GDALWarpAppOptionsNew(char** papszArgv,
                 psOptions->eResampleAlg = GRA_Q1;
             else if ( EQUAL(papszArgv[i], "q3") )
                 psOptions->eResampleAlg = GRA_Q3;
+            else if ( EQUAL(papszArgv[i], "sum") )
+                psOptions->eResampleAlg = GRA_Sum;
             else
             {
                 CPLError(CE_Failure, CPLE_IllegalArg, "Unknown resampling method: %s.", papszArgv[i]);
@@ -3527,6 +3529,18 @@ GDALWarpAppOptions *GDALWarpAppOptionsNew(char** papszArgv,
         return nullptr;
     }
 
+    // Overview pixels are already resampled, so summing them would not
+    // give the totals of the full resolution pixels.
+    if( psOptions->eResampleAlg == GRA_Sum && psOptions->nOvLevel != -1 )
+    {
+        if( psOptions->nOvLevel != -2 && !psOptions->bQuiet )
+        {
+            CPLError(CE_Warning, CPLE_AppDefined,
+                     "-ovr is ignored with -r sum. Using -ovr NONE");
+        }
+        psOptions->nOvLevel = -1;
+    }
+
     if( psOptionsForBinary )
         psOptionsForBinary->bCreateOutput = psOptions->bCreateOutput;
 
@@ -28,6 +28,7 @@
 #include "../vrt/vrtdataset.h"
 #include "gdal_pam.h"
 #include "gdal_proxy.h"
+#include "gdal_alg_priv.h"
 #include "derivedlist.h"
 
 CPL_CVSID("$Id$")
@@ -40,6 +41,26 @@ class DerivedDataset : public VRTDataset
 
         static int Identify( GDALOpenInfo * );
         static GDALDataset *Open( GDALOpenInfo * );
+        static GDALDataset *OpenDEMProduct( GDALOpenInfo *,
+                                            GDALDEMAlgorithm eAlg,
+                                            bool bMultiDirectional,
+                                            const CPLString& osFilename );
+};
+
+/* Products of gdaldem computed on the fly by GDALDEMCreateOnTheFlyDataset() */
+typedef struct
+{
+    const char *     pszDatasetName;
+    GDALDEMAlgorithm eAlg;
+    bool             bMultiDirectional;
+} DerivedDEMProductDescription;
+
+static const DerivedDEMProductDescription asDEMProductDesc[] =
+{
+    { "HILLSHADE", GDEM_HILLSHADE, false },
+    { "MULTIDIRECTIONAL_HILLSHADE", GDEM_HILLSHADE, true },
+    { "SLOPE", GDEM_SLOPE, false },
+    { "ASPECT", GDEM_ASPECT, false }
 };
 
 DerivedDataset::DerivedDataset(int nXSize, int nYSize) :
@@ -93,6 +114,17 @@ GDALDataset * DerivedDataset::Open( GDALOpenInfo * poOpenInfo )
 
     CPLDebug("DerivedDataset::Open","Derived dataset requested: %s",odDerivedName.c_str());
 
+    for( const auto& sDEMProductDesc : asDEMProductDesc )
+    {
+        if( odDerivedName == sDEMProductDesc.pszDatasetName )
+        {
+            return OpenDEMProduct(poOpenInfo,
+                                  sDEMProductDesc.eAlg,
+                                  sDEMProductDesc.bMultiDirectional,
+                                  filename.substr(alg_pos+1));
+        }
+    }
+
     CPLString pixelFunctionName = "";
     bool datasetFound = false;
 
@@ -201,6 +233,83 @@ GDALDataset * DerivedDataset::Open( GDALOpenInfo * poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                          OpenDEMProduct()                            */
+/************************************************************************/
+
+GDALDataset * DerivedDataset::OpenDEMProduct( GDALOpenInfo * poOpenInfo,
+                                              GDALDEMAlgorithm eAlg,
+                                              bool bMultiDirectional,
+                                              const CPLString& osFilename )
+{
+    char** papszOpenOptions = poOpenInfo->papszOpenOptions;
+
+    /* Translate the open options into the settings of the algorithm */
+    GDALDEMAlgOptions sAlgOptions;
+    sAlgOptions.eAlg = eAlg;
+    sAlgOptions.bMultiDirectional = bMultiDirectional;
+    sAlgOptions.z = CPLAtof(
+        CSLFetchNameValueDef(papszOpenOptions, "Z_FACTOR", "1"));
+    sAlgOptions.scale = CPLAtof(
+        CSLFetchNameValueDef(papszOpenOptions, "SCALE", "1"));
+    sAlgOptions.az = CPLAtof(
+        CSLFetchNameValueDef(papszOpenOptions, "AZIMUTH", "315"));
+    sAlgOptions.alt = CPLAtof(
+        CSLFetchNameValueDef(papszOpenOptions, "ALTITUDE", "45"));
+    sAlgOptions.bComputeAtEdges =
+        CPLFetchBool(papszOpenOptions, "COMPUTE_EDGES", false);
+    sAlgOptions.bCombined = CPLFetchBool(papszOpenOptions, "COMBINED", false);
+    sAlgOptions.bAngleAsAzimuth =
+        !CPLFetchBool(papszOpenOptions, "TRIGONOMETRIC", false);
+    sAlgOptions.bZeroForFlat =
+        CPLFetchBool(papszOpenOptions, "ZERO_FOR_FLAT", false);
+
+    const char* pszAlg = CSLFetchNameValueDef(papszOpenOptions, "ALG", "Horn");
+    if( EQUAL(pszAlg, "ZevenbergenThorne") )
+        sAlgOptions.bZevenbergenThorne = true;
+    else if( !EQUAL(pszAlg, "Horn") )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid value for ALG: %s", pszAlg);
+        return nullptr;
+    }
+
+    const char* pszSlopeFormat = CSLFetchNameValueDef(
+        papszOpenOptions, "SLOPE_FORMAT", "DEGREES");
+    if( EQUAL(pszSlopeFormat, "PERCENT") )
+        sAlgOptions.slopeFormat = 0;
+    else if( !EQUAL(pszSlopeFormat, "DEGREES") )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid value for SLOPE_FORMAT: %s", pszSlopeFormat);
+        return nullptr;
+    }
+
+    if( sAlgOptions.bCombined &&
+        (eAlg != GDEM_HILLSHADE || bMultiDirectional) )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "COMBINED can only be used with HILLSHADE");
+        return nullptr;
+    }
+
+    const int nBand =
+        atoi(CSLFetchNameValueDef(papszOpenOptions, "BAND", "1"));
+
+    GDALDatasetH hSrcDS = GDALOpenEx(osFilename,
+                                     GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR,
+                                     nullptr, nullptr, nullptr);
+    if( hSrcDS == nullptr )
+        return nullptr;
+
+    /* The returned dataset holds its own reference on hSrcDS */
+    GDALDatasetH hDS =
+        GDALDEMCreateOnTheFlyDataset(hSrcDS, nBand, &sAlgOptions);
+    GDALReleaseDataset(hSrcDS);
+
+    return static_cast<GDALDataset*>(hDS);
+}
+
 void GDALRegister_Derived()
 {
     if( GDALGetDriverByName( "DERIVED" ) != nullptr )
@@ -215,6 +324,38 @@ void GDALRegister_Derived()
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Derived datasets using VRT pixel functions" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "frmt_derived.html" );
     poDriver->SetMetadataItem( GDAL_DMD_SUBDATASETS, "NO" );
+    poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
+"<OpenOptionList>"
+"  <Option name='BAND' type='int' description='Source band of the "
+    "HILLSHADE, MULTIDIRECTIONAL_HILLSHADE, SLOPE and ASPECT products' "
+    "default='1'/>"
+"  <Option name='ALG' type='string-select' description='Gradient "
+    "algorithm' default='Horn'>"
+"    <Value>Horn</Value>"
+"    <Value>ZevenbergenThorne</Value>"
+"  </Option>"
+"  <Option name='COMPUTE_EDGES' type='boolean' description='Whether to "
+    "compute values at raster edges' default='NO'/>"
+"  <Option name='SCALE' type='float' description='Ratio of vertical units "
+    "to horizontal units' default='1'/>"
+"  <Option name='Z_FACTOR' type='float' description='Vertical exaggeration "
+    "of hillshades' default='1'/>"
+"  <Option name='AZIMUTH' type='float' description='Azimuth of the light "
+    "of HILLSHADE, in degrees' default='315'/>"
+"  <Option name='ALTITUDE' type='float' description='Altitude of the light "
+    "of hillshades, in degrees' default='45'/>"
+"  <Option name='COMBINED' type='boolean' description='Whether HILLSHADE "
+    "combines slope and oblique shading' default='NO'/>"
+"  <Option name='SLOPE_FORMAT' type='string-select' description='Unit of "
+    "SLOPE' default='DEGREES'>"
+"    <Value>DEGREES</Value>"
+"    <Value>PERCENT</Value>"
+"  </Option>"
+"  <Option name='TRIGONOMETRIC' type='boolean' description='Whether ASPECT "
+    "returns trigonometric angles instead of azimuths' default='NO'/>"
+"  <Option name='ZERO_FOR_FLAT' type='boolean' description='Whether ASPECT "
+    "returns 0 for flat areas instead of nodata' default='NO'/>"
+"</OpenOptionList>" );
 
     poDriver->pfnOpen = DerivedDataset::Open;
     poDriver->pfnIdentify = DerivedDataset::Identify;
@@ -81,6 +81,7 @@
 #include "gdal_pam.h"
 #include "gdal_priv.h"
 #include "gdal_priv_templates.hpp"
+#include "gdal_thread_pool.h"
 #include "geo_normalize.h"
 #include "geotiff.h"
 #include "geovalues.h"
@@ -103,14 +104,18 @@
 CPL_CVSID("$Id$")
 
 static bool bGlobalInExternalOvr = false;
-static std::mutex gMutexThreadPool;
-CPLWorkerThreadPool *gpoCompressThreadPool = nullptr;
 
 // Only libtiff 4.0.4 can handle between 32768 and 65535 directories.
 #if TIFFLIB_VERSION >= 20120922
 #define SUPPORTS_MORE_THAN_32768_DIRECTORIES
 #endif
 
+// TIFFReadFromUserBuffer() is available in libtiff >= 4.1, and in our
+// internal copy.
+#if defined(INTERNAL_LIBTIFF) || TIFFLIB_VERSION >= 20191103
+#define HAVE_TIFFREADFROMUSERBUFFER
+#endif
+
 const char* const szJPEGGTiffDatasetTmpPrefix = "/vsimem/gtiffdataset_jpg_tmp_";
 
 typedef enum
@@ -452,19 +457,30 @@ class GTiffDataset final : public GDALPamDataset
     void           DiscardLsb(GByte* pabyBuffer, int nBytes, int iBand) const;
     void           GetDiscardLsbOption( char** papszOptions );
 
-    CPLWorkerThreadPool *poCompressThreadPool;
+    std::unique_ptr<CPLJobQueue> poCompressQueue{};
     std::vector<GTiffCompressionJob> asCompressionJobs;
     CPLMutex      *hCompressThreadPoolMutex;
     void           InitCompressionThreads( char** papszOptions );
     void           InitCreationOrOpenOptions( char** papszOptions );
     static void    ThreadCompressionFunc( void* pData );
     void           WaitCompletionForBlock( int nBlockId );
+    void           WaitCompletionForAllJobs();
     void           WriteRawStripOrTile( int nStripOrTile,
                                         GByte* pabyCompressedBuffer,
                                         int nCompressedBufferSize );
     bool           SubmitCompressionJob( int nStripOrTile, GByte* pabyData,
                                          int cc, int nHeight) ;
 
+    std::mutex     m_oDecodeHandlesMutex{};
+    std::vector<std::pair<VSILFILE*, TIFF*>> m_aoDecodeHandles{};
+    std::vector<TIFF*> m_ahFreeDecodeHandles{};
+    bool           m_bDecodeHandlesFailed = false;
+    bool           CanDecodeBlocksMultiThreaded();
+    int            GetDecodeThreadCount();
+    bool           ReserveDecodeHandles( int nCount );
+    void           CloseDecodeHandles();
+    static void    ThreadDecodeFunc( void* pData );
+
     int            GuessJPEGQuality( bool& bOutHasQuantizationTable,
                                      bool& bOutHasHuffmanTable );
 
@@ -1123,10 +1139,22 @@ class GTiffRasterBand : public GDALPamRasterBand
                                                GIntBig *pnLineSpace,
                                                char **papszOptions );
 
+    void            ComputeBlockRange( int nXOff, int nYOff,
+                                       int nXSize, int nYSize,
+                                       int nBufXSize, int nBufYSize,
+                                       GDALRasterIOExtraArg* psExtraArg,
+                                       int& nBlockX1, int& nBlockY1,
+                                       int& nBlockX2, int& nBlockY2 ) const;
     void*           CacheMultiRange( int nXOff, int nYOff,
                                      int nXSize, int nYSize,
                                      int nBufXSize, int nBufYSize,
                                      GDALRasterIOExtraArg* psExtraArg );
+    void            CacheBlocksMultiThreaded( int nXOff, int nYOff,
+                                              int nXSize, int nYSize,
+                                              int nBufXSize, int nBufYSize,
+                                              int nBandCount,
+                                              const int* panBandMap,
+                                              GDALRasterIOExtraArg* psExtraArg );
 
 protected:
     GTiffDataset       *poGDS;
@@ -2150,6 +2178,16 @@ CPLErr GTiffDataset::IRasterIO( GDALRWFlag eRWFlag,
                                                psExtraArg);
     }
 
+    if( eAccess == GA_ReadOnly && eRWFlag == GF_Read )
+    {
+        cpl::down_cast<GTiffRasterBand *>(
+            GetRasterBand(1))->CacheBlocksMultiThreaded(nXOff, nYOff,
+                                                        nXSize, nYSize,
+                                                        nBufXSize, nBufYSize,
+                                                        nBandCount, panBandMap,
+                                                        psExtraArg);
+    }
+
     ++nJPEGOverviewVisibilityCounter;
     const CPLErr eErr =
         GDALPamDataset::IRasterIO(
@@ -3987,15 +4025,16 @@ int GTiffDataset::DirectIO( GDALRWFlag eRWFlag,
 }
 
 /************************************************************************/
-/*                         CacheMultiRange()                            */
+/*                         ComputeBlockRange()                          */
 /************************************************************************/
 
-void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
-                                        int nXSize, int nYSize,
-                                        int nBufXSize, int nBufYSize,
-                                        GDALRasterIOExtraArg* psExtraArg )
+void GTiffRasterBand::ComputeBlockRange( int nXOff, int nYOff,
+                                         int nXSize, int nYSize,
+                                         int nBufXSize, int nBufYSize,
+                                         GDALRasterIOExtraArg* psExtraArg,
+                                         int& nBlockX1, int& nBlockY1,
+                                         int& nBlockX2, int& nBlockY2 ) const
 {
-    void* pBufferedData = nullptr;
     // Same logic as in GDALRasterBand::IRasterIO()
     double dfXOff = nXOff;
     double dfYOff = nYOff;
@@ -4011,10 +4050,28 @@ void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
     const double dfSrcXInc = dfXSize / static_cast<double>( nBufXSize );
     const double dfSrcYInc = dfYSize / static_cast<double>( nBufYSize );
     const double EPS = 1e-10;
-    const int nBlockX1 = static_cast<int>((0+0.5) * dfSrcXInc + dfXOff + EPS) / nBlockXSize;
-    const int nBlockY1 = static_cast<int>((0+0.5) * dfSrcYInc + dfYOff + EPS) / nBlockYSize;
-    const int nBlockX2 = static_cast<int>((nBufXSize-1+0.5) * dfSrcXInc + dfXOff + EPS) / nBlockXSize;
-    const int nBlockY2 = static_cast<int>((nBufYSize-1+0.5) * dfSrcYInc + dfYOff + EPS) / nBlockYSize;
+    nBlockX1 = static_cast<int>((0+0.5) * dfSrcXInc + dfXOff + EPS) / nBlockXSize;
+    nBlockY1 = static_cast<int>((0+0.5) * dfSrcYInc + dfYOff + EPS) / nBlockYSize;
+    nBlockX2 = static_cast<int>((nBufXSize-1+0.5) * dfSrcXInc + dfXOff + EPS) / nBlockXSize;
+    nBlockY2 = static_cast<int>((nBufYSize-1+0.5) * dfSrcYInc + dfYOff + EPS) / nBlockYSize;
+}
+
+/************************************************************************/
+/*                         CacheMultiRange()                            */
+/************************************************************************/
+
+void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
+                                        int nXSize, int nYSize,
+                                        int nBufXSize, int nBufYSize,
+                                        GDALRasterIOExtraArg* psExtraArg )
+{
+    void* pBufferedData = nullptr;
+    int nBlockX1 = 0;
+    int nBlockY1 = 0;
+    int nBlockX2 = 0;
+    int nBlockY2 = 0;
+    ComputeBlockRange(nXOff, nYOff, nXSize, nYSize, nBufXSize, nBufYSize,
+                      psExtraArg, nBlockX1, nBlockY1, nBlockX2, nBlockY2);
 
     thandle_t th = TIFFClientdata( poGDS->hTIFF );
     if( poGDS->SetDirectory() && !VSI_TIFFHasCachedRanges(th) )
@@ -4161,6 +4218,13 @@ CPLErr GTiffRasterBand::IRasterIO( GDALRWFlag eRWFlag,
                                         psExtraArg);
     }
 
+    if( poGDS->eAccess == GA_ReadOnly && eRWFlag == GF_Read )
+    {
+        CacheBlocksMultiThreaded(nXOff, nYOff, nXSize, nYSize,
+                                 nBufXSize, nBufYSize, 1, &nBand,
+                                 psExtraArg);
+    }
+
     if( poGDS->nBands != 1 &&
         poGDS->nPlanarConfig == PLANARCONFIG_CONTIG &&
         eRWFlag == GF_Read &&
@@ -7140,6 +7204,482 @@ static void CPL_STDCALL GTIFFErrorHandler( CPLErr eErr, CPLErrorNum no,
     paoErrors->push_back(GTIFFErrorStruct(eErr, no, msg));
 }
 
+/************************************************************************/
+/*                    CanDecodeBlocksMultiThreaded()                    */
+/************************************************************************/
+
+// Whether blocks of this dataset can be decoded by TIFFReadEncodedTile()/
+// TIFFReadEncodedStrip() on a separate TIFF handle, and their content be
+// put as such in the block cache (that is the bands are of the generic
+// GTiffRasterBand class).
+bool GTiffDataset::CanDecodeBlocksMultiThreaded()
+{
+    return eAccess == GA_ReadOnly &&
+           !bStreamingIn &&
+           nCompression != COMPRESSION_OJPEG &&
+           !bTreatAsRGBA &&
+           !bTreatAsSplit &&
+           !bTreatAsSplitBitmap &&
+           !m_bDecodeHandlesFailed &&
+           nCompression != COMPRESSION_NONE &&
+           nBands > 0 &&
+           GDALGetDataTypeSizeBits(
+               GetRasterBand(1)->GetRasterDataType()) == nBitsPerSample;
+}
+
+/************************************************************************/
+/*                        GetDecodeThreadCount()                        */
+/************************************************************************/
+
+// Returns the number of threads to use for decoding blocks, or 0 if
+// multi-threaded decoding is not enabled through the NUM_THREADS open option
+// or the GDAL_NUM_THREADS configuration option. Overviews and masks use the
+// setting of their base dataset.
+int GTiffDataset::GetDecodeThreadCount()
+{
+    if( poBaseDS != nullptr )
+        return poBaseDS->GetDecodeThreadCount();
+
+    const int nThreads = GDALGetNumThreads(papszOpenOptions);
+    return nThreads > 1 ? nThreads : 0;
+}
+
+/************************************************************************/
+/*                       ReserveDecodeHandles()                         */
+/************************************************************************/
+
+// Make sure that at least nCount TIFF handles, each one with its own file
+// handle and opened on the directory of this dataset, are available for
+// the decoding threads.
+bool GTiffDataset::ReserveDecodeHandles( int nCount )
+{
+    const bool bTiled = CPL_TO_BOOL(TIFFIsTiled(hTIFF));
+    const tmsize_t nBlockBufSize =
+        bTiled ? TIFFTileSize(hTIFF) : TIFFStripSize(hTIFF);
+
+    while( static_cast<int>(m_aoDecodeHandles.size()) < nCount )
+    {
+        VSILFILE* fpDecode = VSIFOpenL(osFilename, "rb");
+        if( fpDecode == nullptr )
+        {
+            m_bDecodeHandlesFailed = true;
+            return false;
+        }
+
+        // Warnings, if any, have already been emitted when opening the
+        // dataset.
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        TIFF* hDecodeTIFF = VSI_TIFFOpen(osFilename, "r", fpDecode);
+        if( hDecodeTIFF != nullptr &&
+            TIFFCurrentDirOffset(hDecodeTIFF) != nDirOffset &&
+            !TIFFSetSubDirectory(hDecodeTIFF, nDirOffset) )
+        {
+            XTIFFClose(hDecodeTIFF);
+            hDecodeTIFF = nullptr;
+        }
+        CPLPopErrorHandler();
+
+        if( hDecodeTIFF != nullptr &&
+            nCompression == COMPRESSION_JPEG &&
+            nPhotometric == PHOTOMETRIC_YCBCR &&
+            CPLTestBool( CPLGetConfigOption("CONVERT_YCBCR_TO_RGB", "YES") ) )
+        {
+            TIFFSetField(hDecodeTIFF, TIFFTAG_JPEGCOLORMODE,
+                         JPEGCOLORMODE_RGB);
+        }
+
+        // Paranoid check that we see the same layout as the main handle.
+        if( hDecodeTIFF != nullptr &&
+            (CPL_TO_BOOL(TIFFIsTiled(hDecodeTIFF)) != bTiled ||
+             (bTiled ? TIFFTileSize(hDecodeTIFF) :
+                       TIFFStripSize(hDecodeTIFF)) != nBlockBufSize) )
+        {
+            XTIFFClose(hDecodeTIFF);
+            hDecodeTIFF = nullptr;
+        }
+
+        if( hDecodeTIFF == nullptr )
+        {
+            CPL_IGNORE_RET_VAL(VSIFCloseL(fpDecode));
+            m_bDecodeHandlesFailed = true;
+            return false;
+        }
+
+        m_aoDecodeHandles.push_back(
+            std::pair<VSILFILE*, TIFF*>(fpDecode, hDecodeTIFF));
+        m_ahFreeDecodeHandles.push_back(hDecodeTIFF);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                         CloseDecodeHandles()                         */
+/************************************************************************/
+
+void GTiffDataset::CloseDecodeHandles()
+{
+    for( size_t i = 0; i < m_aoDecodeHandles.size(); ++i )
+    {
+        XTIFFClose(m_aoDecodeHandles[i].second);
+        CPL_IGNORE_RET_VAL(VSIFCloseL(m_aoDecodeHandles[i].first));
+    }
+    m_aoDecodeHandles.clear();
+    m_ahFreeDecodeHandles.clear();
+}
+
+/************************************************************************/
+/*                         ThreadDecodeFunc()                           */
+/************************************************************************/
+
+namespace {
+struct GTiffDecodeJob
+{
+    GTiffDataset *poDS = nullptr;
+    int           nBand = 0;
+    int           nBlockXOff = 0;
+    int           nBlockYOff = 0;
+    int           nBlockId = 0;
+    int           nBlockReqSize = 0;
+    int           nBufferSize = 0;
+    GByte        *pabyBuffer = nullptr;
+    vsi_l_offset  nRawOffset = 0;
+    int           nRawSize = 0;
+    GByte        *pabyRawData = nullptr;
+    bool          bSuccess = false;
+    std::vector<GTIFFErrorStruct> aoErrors{};
+};
+}
+
+void GTiffDataset::ThreadDecodeFunc( void* pData )
+{
+    GTiffDecodeJob* psJob = static_cast<GTiffDecodeJob *>(pData);
+    GTiffDataset* poDS = psJob->poDS;
+
+    TIFF* hDecodeTIFF = nullptr;
+    {
+        std::lock_guard<std::mutex> oLock(poDS->m_oDecodeHandlesMutex);
+        if( poDS->m_ahFreeDecodeHandles.empty() )
+            return;
+        hDecodeTIFF = poDS->m_ahFreeDecodeHandles.back();
+        poDS->m_ahFreeDecodeHandles.pop_back();
+    }
+
+    if( psJob->nBlockReqSize < psJob->nBufferSize )
+        memset( psJob->pabyBuffer, 0, psJob->nBufferSize );
+
+    // Collect warnings so that they can be re-emitted from the calling
+    // thread. In case of failure, the block will be read again by
+    // IReadBlock() which will take care of the error reporting.
+    CPLPushErrorHandlerEx(GTIFFErrorHandler, &psJob->aoErrors);
+#ifdef HAVE_TIFFREADFROMUSERBUFFER
+    if( psJob->pabyRawData != nullptr )
+    {
+        psJob->bSuccess =
+            TIFFReadFromUserBuffer( hDecodeTIFF, psJob->nBlockId,
+                                    psJob->pabyRawData, psJob->nRawSize,
+                                    psJob->pabyBuffer,
+                                    psJob->nBlockReqSize ) != 0;
+    }
+    else
+#endif
+    if( TIFFIsTiled(hDecodeTIFF) )
+    {
+        psJob->bSuccess =
+            TIFFReadEncodedTile( hDecodeTIFF, psJob->nBlockId,
+                                 psJob->pabyBuffer,
+                                 psJob->nBlockReqSize ) != -1;
+    }
+    else
+    {
+        psJob->bSuccess =
+            TIFFReadEncodedStrip( hDecodeTIFF, psJob->nBlockId,
+                                  psJob->pabyBuffer,
+                                  psJob->nBlockReqSize ) != -1;
+    }
+    CPLPopErrorHandler();
+    for( size_t i = 0; psJob->bSuccess && i < psJob->aoErrors.size(); ++i )
+    {
+        if( psJob->aoErrors[i].type == CE_Failure )
+            psJob->bSuccess = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(poDS->m_oDecodeHandlesMutex);
+        poDS->m_ahFreeDecodeHandles.push_back(hDecodeTIFF);
+    }
+}
+
+/************************************************************************/
+/*                     CacheBlocksMultiThreaded()                       */
+/************************************************************************/
+
+// When NUM_THREADS/GDAL_NUM_THREADS is set, decode the blocks intersecting
+// the request that are not yet in the block cache on the decoding thread
+// pool, and insert them into the block cache, so that the following generic
+// RasterIO() only has to copy from the cache. The compressed data is read
+// in this thread, and only decoded by the workers.
+void GTiffRasterBand::CacheBlocksMultiThreaded( int nXOff, int nYOff,
+                                                int nXSize, int nYSize,
+                                                int nBufXSize, int nBufYSize,
+                                                int nBandCount,
+                                                const int* panBandMap,
+                                                GDALRasterIOExtraArg* psExtraArg )
+{
+    if( !poGDS->CanDecodeBlocksMultiThreaded() )
+        return;
+    const int nMaxThreads = poGDS->GetDecodeThreadCount();
+    if( nMaxThreads <= 1 || !poGDS->SetDirectory() )
+        return;
+
+    int nBlockX1 = 0;
+    int nBlockY1 = 0;
+    int nBlockX2 = 0;
+    int nBlockY2 = 0;
+    ComputeBlockRange(nXOff, nYOff, nXSize, nYSize, nBufXSize, nBufYSize,
+                      psExtraArg, nBlockX1, nBlockY1, nBlockX2, nBlockY2);
+    if( nBlockX1 == nBlockX2 && nBlockY1 == nBlockY2 &&
+        (nBandCount == 1 || poGDS->nPlanarConfig == PLANARCONFIG_CONTIG) )
+        return;
+
+    const bool bInterleaved =
+        poGDS->nBands > 1 && poGDS->nPlanarConfig == PLANARCONFIG_CONTIG;
+    const int nBlockBufSize = static_cast<int>(
+        TIFFIsTiled(poGDS->hTIFF) ? TIFFTileSize(poGDS->hTIFF) :
+                                    TIFFStripSize(poGDS->hTIFF));
+    if( nBlockBufSize <= 0 )
+        return;
+    nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, nBlockXSize);
+
+/* -------------------------------------------------------------------- */
+/*      Collect the blocks that are not yet in cache.                   */
+/* -------------------------------------------------------------------- */
+    std::vector<GTiffDecodeJob> asJobs;
+    for( int iY = nBlockY1; iY <= nBlockY2; ++iY )
+    {
+        // Same as in IReadBlock() for partially encoded bottom blocks.
+        int nBlockReqSize = nBlockBufSize;
+        if( iY * nBlockYSize > nRasterYSize - nBlockYSize )
+        {
+            nBlockReqSize = (nBlockBufSize / nBlockYSize)
+                * (nBlockYSize - static_cast<int>(
+                    (static_cast<GIntBig>(iY + 1) * nBlockYSize)
+                        % nRasterYSize));
+        }
+
+        for( int iX = nBlockX1; iX <= nBlockX2; ++iX )
+        {
+            for( int iBand = 0; iBand < nBandCount; ++iBand )
+            {
+                GTiffRasterBand* poBand = cpl::down_cast<GTiffRasterBand *>(
+                    poGDS->GetRasterBand(panBandMap[iBand]));
+                GDALRasterBlock* poBlock =
+                    poBand->TryGetLockedBlockRef(iX, iY);
+                if( poBlock != nullptr )
+                {
+                    poBlock->DropLock();
+                    continue;
+                }
+
+                int nBlockId = iX + iY * nBlocksPerRow;
+                if( poGDS->nPlanarConfig == PLANARCONFIG_SEPARATE )
+                    nBlockId += (poBand->nBand - 1) * poGDS->nBlocksPerBand;
+                vsi_l_offset nRawOffset = 0;
+                vsi_l_offset nRawSize = 0;
+                // Same sanity check on the compressed size as
+                // TIFFFillTile()/TIFFFillStrip(). Other blocks will be
+                // handled by IReadBlock().
+                if( poGDS->IsBlockAvailable(nBlockId, &nRawOffset,
+                                            &nRawSize) &&
+                    nRawSize > 0 &&
+                    (nRawSize <= 1024 * 1024 ||
+                     nRawSize / 10 <= static_cast<vsi_l_offset>(
+                                            nBlockBufSize) + 4096) )
+                {
+                    GTiffDecodeJob sJob;
+                    sJob.poDS = poGDS;
+                    sJob.nBand = poBand->nBand;
+                    sJob.nBlockXOff = iX;
+                    sJob.nBlockYOff = iY;
+                    sJob.nBlockId = nBlockId;
+                    sJob.nBlockReqSize = nBlockReqSize;
+                    sJob.nBufferSize = nBlockBufSize;
+                    sJob.nRawOffset = nRawOffset;
+                    sJob.nRawSize = static_cast<int>(nRawSize);
+                    asJobs.push_back(sJob);
+                }
+
+                // A pixel-interleaved block provides all bands at once.
+                if( bInterleaved )
+                    break;
+            }
+        }
+    }
+
+    if( asJobs.size() < 2 )
+        return;
+    // Do not defeat the block cache by inserting more than it can hold.
+    if( static_cast<GIntBig>(asJobs.size()) * nBlockBufSize >
+                                            GDALGetCacheMax64() / 2 )
+    {
+        CPLDebug("GTiff",
+                 "Multi-threaded decompression skipped: "
+                 "block cache not big enough");
+        return;
+    }
+
+    const int nThreads = std::min(nMaxThreads,
+                                  static_cast<int>(asJobs.size()));
+    if( !poGDS->ReserveDecodeHandles(nThreads) )
+        return;
+
+    // The queue never runs more jobs at once than there are decode handles.
+    std::unique_ptr<CPLJobQueue> poQueue =
+        GDALCreateGlobalThreadPoolJobQueue(nThreads);
+    if( poQueue == nullptr )
+        return;
+
+    GByte* pabyBuffers = static_cast<GByte *>(
+        VSI_MALLOC2_VERBOSE(asJobs.size(), nBlockBufSize));
+    if( pabyBuffers == nullptr )
+        return;
+
+    for( size_t i = 0; i < asJobs.size(); ++i )
+    {
+        asJobs[i].pabyBuffer =
+            pabyBuffers + i * static_cast<size_t>(nBlockBufSize);
+    }
+
+#ifdef HAVE_TIFFREADFROMUSERBUFFER
+/* -------------------------------------------------------------------- */
+/*      Read the compressed blocks, by increasing file offset, and      */
+/*      submit each one for decoding as soon as it is read, so that     */
+/*      I/O and decoding overlap.                                       */
+/* -------------------------------------------------------------------- */
+    std::vector<size_t> anJobOrder;
+    size_t nTotalRawSize = 0;
+    for( size_t i = 0; i < asJobs.size(); ++i )
+    {
+        anJobOrder.push_back(i);
+        nTotalRawSize += asJobs[i].nRawSize;
+    }
+    std::sort(anJobOrder.begin(), anJobOrder.end(),
+              [&asJobs](size_t i, size_t j)
+              { return asJobs[i].nRawOffset < asJobs[j].nRawOffset; });
+
+    GByte* pabyRawBuffers =
+        static_cast<GByte *>(VSI_MALLOC_VERBOSE(nTotalRawSize));
+    if( pabyRawBuffers == nullptr )
+    {
+        VSIFree(pabyBuffers);
+        return;
+    }
+
+    size_t nRawBufferOffset = 0;
+    for( size_t i = 0; i < anJobOrder.size(); ++i )
+    {
+        GTiffDecodeJob& sJob = asJobs[anJobOrder[i]];
+        sJob.pabyRawData = pabyRawBuffers + nRawBufferOffset;
+        nRawBufferOffset += sJob.nRawSize;
+
+        const tmsize_t nRead = TIFFIsTiled(poGDS->hTIFF) ?
+            TIFFReadRawTile(poGDS->hTIFF, sJob.nBlockId,
+                            sJob.pabyRawData, sJob.nRawSize) :
+            TIFFReadRawStrip(poGDS->hTIFF, sJob.nBlockId,
+                             sJob.pabyRawData, sJob.nRawSize);
+        if( nRead != sJob.nRawSize )
+        {
+            // Let IReadBlock() report the error.
+            CPLErrorReset();
+            continue;
+        }
+        if( !poQueue->SubmitJob(GTiffDataset::ThreadDecodeFunc, &sJob) )
+            break;
+    }
+    poQueue->WaitCompletion();
+    VSIFree(pabyRawBuffers);
+#else
+/* -------------------------------------------------------------------- */
+/*      Read and decode the blocks with the TIFF handles of the         */
+/*      workers.                                                        */
+/* -------------------------------------------------------------------- */
+    std::vector<void*> apData;
+    for( size_t i = 0; i < asJobs.size(); ++i )
+        apData.push_back(&asJobs[i]);
+    if( !poQueue->SubmitJobs(GTiffDataset::ThreadDecodeFunc, apData) )
+    {
+        poQueue->WaitCompletion();
+        VSIFree(pabyBuffers);
+        return;
+    }
+    poQueue->WaitCompletion();
+#endif
+
+/* -------------------------------------------------------------------- */
+/*      Push the decoded blocks into the block cache. Those that        */
+/*      failed will be read again, and errors reported, by IReadBlock() */
+/* -------------------------------------------------------------------- */
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+    for( size_t i = 0; i < asJobs.size(); ++i )
+    {
+        const GTiffDecodeJob& sJob = asJobs[i];
+        if( !sJob.bSuccess )
+            continue;
+        for( size_t j = 0; j < sJob.aoErrors.size(); ++j )
+        {
+            CPLError( sJob.aoErrors[j].type, sJob.aoErrors[j].no,
+                      "%s", sJob.aoErrors[j].msg.c_str() );
+        }
+
+        // Similarly to FillCacheForOtherBands(), fill the cache for all
+        // bands of a pixel-interleaved block, unless there are too many.
+        std::vector<int> anBandsToFill;
+        if( !bInterleaved )
+            anBandsToFill.push_back(sJob.nBand);
+        else if( poGDS->nBands < 128 )
+        {
+            for( int iBand = 1; iBand <= poGDS->nBands; ++iBand )
+                anBandsToFill.push_back(iBand);
+        }
+        else
+            anBandsToFill.assign(panBandMap, panBandMap + nBandCount);
+
+        for( size_t j = 0; j < anBandsToFill.size(); ++j )
+        {
+            const int iBand = anBandsToFill[j];
+            GTiffRasterBand* poBand = cpl::down_cast<GTiffRasterBand *>(
+                poGDS->GetRasterBand(iBand));
+            GDALRasterBlock* poBlock =
+                poBand->TryGetLockedBlockRef(sJob.nBlockXOff,
+                                             sJob.nBlockYOff);
+            if( poBlock != nullptr )
+            {
+                poBlock->DropLock();
+                continue;
+            }
+            poBlock = poBand->GetLockedBlockRef(sJob.nBlockXOff,
+                                                sJob.nBlockYOff, TRUE);
+            if( poBlock == nullptr )
+                break;
+            if( bInterleaved )
+            {
+                GDALCopyWords(sJob.pabyBuffer + (iBand - 1) * nDTSize,
+                              eDataType, poGDS->nBands * nDTSize,
+                              poBlock->GetDataRef(), eDataType, nDTSize,
+                              nBlockXSize * nBlockYSize);
+            }
+            else
+            {
+                memcpy(poBlock->GetDataRef(), sJob.pabyBuffer,
+                       static_cast<size_t>(nBlockXSize) * nBlockYSize *
+                       nDTSize);
+            }
+            poBlock->DropLock();
+        }
+    }
+
+    VSIFree(pabyBuffers);
+}
+
 /************************************************************************/
 /*                             IReadBlock()                             */
 /************************************************************************/
@@ -7341,7 +7881,6 @@ GTiffDataset::GTiffDataset() :
     pBaseMapping(nullptr),
     nRefBaseMapping(0),
     bHasDiscardedLsb(false),
-    poCompressThreadPool(nullptr),
     hCompressThreadPoolMutex(nullptr),
     m_pTempBufferForCommonDirectIO(nullptr),
     m_nTempBufferForCommonDirectIOSize(0),
@@ -7445,18 +7984,11 @@ int GTiffDataset::Finalize()
 /* -------------------------------------------------------------------- */
     FlushCacheInternal( true );
 
-    // Destroy compression pool.
-    if( poCompressThreadPool )
+    // Destroy compression queue.
+    if( poCompressQueue )
     {
-        poCompressThreadPool->WaitCompletion();
-
-        // Save thread pool for later reuse.
-        {
-            std::lock_guard<std::mutex> oLock(gMutexThreadPool);
-            delete gpoCompressThreadPool;
-            gpoCompressThreadPool = poCompressThreadPool;
-            poCompressThreadPool = nullptr;
-        }
+        poCompressQueue->WaitCompletion();
+        poCompressQueue.reset();
 
         for( int i = 0; i < static_cast<int>(asCompressionJobs.size()); ++i )
         {
@@ -7470,6 +8002,9 @@ int GTiffDataset::Finalize()
         CPLDestroyMutex(hCompressThreadPoolMutex);
     }
 
+    // Close the handles used for multi-threaded decompression.
+    CloseDecodeHandles();
+
 /* -------------------------------------------------------------------- */
 /*      If there is still changed metadata, then presumably we want     */
 /*      to push it into PAM.                                            */
@@ -8455,31 +8990,10 @@ void GTiffDataset::InitCompressionThreads( char** papszOptions )
             {
                 CPLDebug("GTiff", "Using %d threads for compression", nThreads);
 
-                // Try to reuse previously created thread pool
-                {
-                    std::lock_guard<std::mutex> oLock(gMutexThreadPool);
-                    if( gpoCompressThreadPool &&
-                        gpoCompressThreadPool->GetThreadCount() == nThreads )
-                    {
-                        poCompressThreadPool = gpoCompressThreadPool;
-                    }
-                    else
-                    {
-                        delete gpoCompressThreadPool;
-                    }
-                    gpoCompressThreadPool = nullptr;
-                }
-
-                if( poCompressThreadPool == nullptr )
-                {
-                    poCompressThreadPool = new CPLWorkerThreadPool();
-                    if( !poCompressThreadPool->Setup(nThreads, nullptr, nullptr) )
-                    {
-                        delete poCompressThreadPool;
-                        poCompressThreadPool = nullptr;
-                    }
-                }
-                if( poCompressThreadPool != nullptr )
+                // Jobs run in the process-wide thread pool, but no more
+                // than nThreads at a time.
+                poCompressQueue = GDALCreateGlobalThreadPoolJobQueue(nThreads);
+                if( poCompressQueue != nullptr )
                 {
                     // Add a margin of an extra job w.r.t thread number
                     // so as to optimize compression time (enables the main
@@ -8669,7 +9183,7 @@ void GTiffDataset::WriteRawStripOrTile( int nStripOrTile,
 
 void GTiffDataset::WaitCompletionForBlock(int nBlockId)
 {
-    if( poCompressThreadPool != nullptr )
+    if( poCompressQueue != nullptr )
     {
         for( int i = 0; i < static_cast<int>(asCompressionJobs.size()); ++i )
         {
@@ -8684,7 +9198,7 @@ void GTiffDataset::WaitCompletionForBlock(int nBlockId)
                 CPLReleaseMutex(hCompressThreadPoolMutex);
                 if( !bReady )
                 {
-                    poCompressThreadPool->WaitCompletion(0);
+                    poCompressQueue->WaitCompletion(0);
                     CPLAssert( asCompressionJobs[i].bReady );
                 }
 
@@ -8704,6 +9218,38 @@ void GTiffDataset::WaitCompletionForBlock(int nBlockId)
     }
 }
 
+/************************************************************************/
+/*                      WaitCompletionForAllJobs()                      */
+/************************************************************************/
+
+// Wait for all compression jobs, and write the resulting blocks. Must be
+// called while the directory of this dataset is the current one.
+void GTiffDataset::WaitCompletionForAllJobs()
+{
+    if( poCompressQueue == nullptr )
+        return;
+
+    poCompressQueue->WaitCompletion();
+
+    // Flush remaining data
+    for( int i = 0; i < static_cast<int>(asCompressionJobs.size()); ++i )
+    {
+        if( asCompressionJobs[i].bReady )
+        {
+            if( asCompressionJobs[i].nCompressedBufferSize )
+            {
+                WriteRawStripOrTile( asCompressionJobs[i].nStripOrTile,
+                               asCompressionJobs[i].pabyCompressedBuffer,
+                               asCompressionJobs[i].nCompressedBufferSize );
+            }
+            asCompressionJobs[i].pabyCompressedBuffer = nullptr;
+            asCompressionJobs[i].nBufferSize = 0;
+            asCompressionJobs[i].bReady = false;
+            asCompressionJobs[i].nStripOrTile = -1;
+        }
+    }
+}
+
 /************************************************************************/
 /*                      SubmitCompressionJob()                          */
 /************************************************************************/
@@ -8714,7 +9260,7 @@ bool GTiffDataset::SubmitCompressionJob( int nStripOrTile, GByte* pabyData,
 /* -------------------------------------------------------------------- */
 /*      Should we do compression in a worker thread ?                   */
 /* -------------------------------------------------------------------- */
-    if( !( poCompressThreadPool != nullptr &&
+    if( !( poCompressQueue != nullptr &&
            (nCompression == COMPRESSION_ADOBE_DEFLATE ||
             nCompression == COMPRESSION_LZW ||
             nCompression == COMPRESSION_PACKBITS ||
@@ -8724,7 +9270,7 @@ bool GTiffDataset::SubmitCompressionJob( int nStripOrTile, GByte* pabyData,
 
     int nNextCompressionJobAvail = -1;
     // Wait that at least one job is finished.
-    poCompressThreadPool->WaitCompletion(
+    poCompressQueue->WaitCompletion(
         static_cast<int>(asCompressionJobs.size() - 1) );
     for( int i = 0; i < static_cast<int>(asCompressionJobs.size()); ++i )
     {
@@ -8768,7 +9314,7 @@ bool GTiffDataset::SubmitCompressionJob( int nStripOrTile, GByte* pabyData,
         TIFFGetField( hTIFF, TIFFTAG_PREDICTOR, &psJob->nPredictor );
     }
 
-    poCompressThreadPool->SubmitJob(ThreadCompressionFunc, psJob);
+    poCompressQueue->SubmitJob(ThreadCompressionFunc, psJob);
     return true;
 }
 
@@ -9742,28 +10288,7 @@ void GTiffDataset::FlushCacheInternal( bool bFlushDirectory )
     bLoadedBlockDirty = false;
 
     // Finish compression
-    if( poCompressThreadPool )
-    {
-        poCompressThreadPool->WaitCompletion();
-
-        // Flush remaining data
-        for( int i = 0; i < static_cast<int>(asCompressionJobs.size()); ++i )
-        {
-            if( asCompressionJobs[i].bReady )
-            {
-                if( asCompressionJobs[i].nCompressedBufferSize )
-                {
-                    WriteRawStripOrTile( asCompressionJobs[i].nStripOrTile,
-                                   asCompressionJobs[i].pabyCompressedBuffer,
-                                   asCompressionJobs[i].nCompressedBufferSize );
-                }
-                asCompressionJobs[i].pabyCompressedBuffer = nullptr;
-                asCompressionJobs[i].nBufferSize = 0;
-                asCompressionJobs[i].bReady = false;
-                asCompressionJobs[i].nStripOrTile = -1;
-            }
-        }
-    }
+    WaitCompletionForAllJobs();
 
     if( bFlushDirectory && GetAccess() == GA_Update )
     {
@@ -11843,7 +12368,12 @@ bool GTiffDataset::SetDirectory( toff_t nNewOffset )
     if( GetAccess() == GA_Update )
     {
         if( *ppoActiveDSRef != nullptr )
+        {
+            // Blocks being compressed must be written before switching to
+            // another directory.
+            (*ppoActiveDSRef)->WaitCompletionForAllJobs();
             (*ppoActiveDSRef)->FlushDirectory();
+        }
     }
 
     if( nNewOffset == 0)
@@ -18614,9 +19144,6 @@ void GDALDeregister_GTiff( GDALDriver * )
 #if defined(LIBGEOTIFF_VERSION) && LIBGEOTIFF_VERSION > 1150
     GTIFDeaccessCSV();
 #endif
-
-    delete gpoCompressThreadPool;
-    gpoCompressThreadPool = nullptr;
 }
 
 /************************************************************************/
@@ -18881,7 +19408,7 @@ void GDALRegister_GTiff()
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST, osOptions );
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
-"   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression. Can be set to ALL_CPUS' default='1'/>"
+"   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression/decompression. Can be set to ALL_CPUS' default='1'/>"
 "   <Option name='GEOTIFF_KEYS_FLAVOR' type='string-select' default='STANDARD' description='Which flavor of GeoTIFF keys must be used (for writing)'>"
 "       <Value>STANDARD</Value>"
 "       <Value>ESRI_PE</Value>"
@@ -523,6 +523,7 @@
 #define TIFFReadEncodedTile gdal_TIFFReadEncodedTile
 #define _TIFFReadEncodedTileAndAllocBuffer gdal__TIFFReadEncodedTileAndAllocBuffer
 #define TIFFReadEXIFDirectory gdal_TIFFReadEXIFDirectory
+#define TIFFReadFromUserBuffer gdal_TIFFReadFromUserBuffer
 #define _tiffReadProc gdal__tiffReadProc
 #define TIFFReadRawStrip gdal_TIFFReadRawStrip
 #define TIFFReadRawStrip1 gdal_TIFFReadRawStrip1
@@ -268,6 +268,7 @@ void VRTSimpleSource::SetNoDataValue( double dfNewNoDataValue )
 /************************************************************************/
 
 static const char* const apszSpecialSyntax[] = {
+    "DERIVED_SUBDATASET:{ANY}:{FILENAME}",
     "HDF5:\"{FILENAME}\":{ANY}",
     "HDF5:{FILENAME}:{ANY}",
     "NETCDF:\"{FILENAME}\":{ANY}",
@@ -855,6 +855,8 @@ class CPL_DLL GDALRasterBlock
 
     bool                 bMustDetach;
 
+    int                  nLRUStamp;
+
     void        Detach_unlocked( void );
     void        Touch_unlocked( void );
 
@@ -1669,8 +1671,8 @@ typedef CPLErr (*GDALResampleFunction)
                         GDALDataType eSrcDataType,
                         bool bPropagateNoData );
 
-GDALResampleFunction GDALGetResampleFunction(const char* pszResampling,
-                                                 int* pnRadius);
+GDALResampleFunction CPL_DLL GDALGetResampleFunction(const char* pszResampling,
+                                                         int* pnRadius);
 
 #ifdef GDAL_ENABLE_RESAMPLING_MULTIBAND
 typedef CPLErr (*GDALResampleFunctionMultiBands)
@@ -1695,8 +1697,8 @@ GDALResampleFunctionMultiBands GDALGetResampleFunctionMultiBands(const char* psz
                                                        int* pnRadius);
 #endif
 
-GDALDataType GDALGetOvrWorkDataType(const char* pszResampling,
-                                        GDALDataType eSrcDataType);
+GDALDataType CPL_DLL GDALGetOvrWorkDataType(const char* pszResampling,
+                                                GDALDataType eSrcDataType);
 
 CPL_C_START
 
@@ -397,17 +397,22 @@ inline void GDALCopy4Words(const float* pValueIn, GInt16* const &pValueOut)
 {
     __m128 xmm = _mm_loadu_ps(pValueIn);
 
-    const __m128 xmm_min = _mm_set1_ps(-32768);
-    const __m128 xmm_max = _mm_set1_ps(32767);
-    xmm = _mm_min_ps(_mm_max_ps(xmm, xmm_min), xmm_max);
+    // NaN -> 0, as in the scalar GDALCopyWord()
+    xmm = _mm_and_ps(xmm, _mm_cmpord_ps(xmm, xmm));
 
+    // Round before clamping, in the same order as the scalar GDALCopyWord(),
+    // so that values such as 0.49999997f give the same result.
     const __m128 p0d5 = _mm_set1_ps(0.5f);
     const __m128 m0d5 = _mm_set1_ps(-0.5f);
-    const __m128 mask = _mm_cmpge_ps(xmm, p0d5);
-    // f >= 0.5f ? f + 0.5f : f - 0.5f
+    const __m128 mask = _mm_cmpge_ps(xmm, _mm_setzero_ps());
+    // f >= 0 ? f + 0.5f : f - 0.5f
     xmm = _mm_add_ps(xmm, _mm_or_ps(_mm_and_ps(mask, p0d5),
                                     _mm_andnot_ps(mask, m0d5)));
 
+    const __m128 xmm_min = _mm_set1_ps(-32768);
+    const __m128 xmm_max = _mm_set1_ps(32767);
+    xmm = _mm_min_ps(_mm_max_ps(xmm, xmm_min), xmm_max);
+
     __m128i xmm_i = _mm_cvttps_epi32 (xmm);
 
     xmm_i = _mm_packs_epi32(xmm_i, xmm_i);   // Pack int32 to int16
@@ -0,0 +1,182 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Process-wide thread pool
+ * Author:   agent <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_thread_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "cpl_conv.h"
+#include "cpl_multiproc.h"
+#include "cpl_string.h"
+
+CPL_CVSID("$Id$")
+
+static CPLMutex* hGlobalThreadPoolMutex = nullptr;
+static CPLWorkerThreadPool* gpoGlobalThreadPool = nullptr;
+
+/************************************************************************/
+/*                      GDALGetGlobalThreadPool()                       */
+/************************************************************************/
+
+/** Return the process-wide worker thread pool, creating it if needed.
+ *
+ * All the multi-threaded parts of GDAL draw their worker threads from this
+ * pool, so that running several of them at once does not create more
+ * threads than CPUs. Each user should submit its jobs in its own job queue,
+ * whose number of running jobs is limited to the number of threads it was
+ * asked to use (see GDALCreateGlobalThreadPoolJobQueue()).
+ *
+ * The pool is sized according to the GDAL_NUM_THREADS configuration option
+ * (number of threads or ALL_CPUS), or to the number of CPUs if it is not
+ * set, and at least to nThreads at creation time. A pool created for a
+ * given number of threads is not grown afterwards: users asking for more
+ * threads will share the existing ones.
+ *
+ * @param nThreads Number of threads wanted by the caller.
+ * @return the pool, or nullptr in case of failure.
+ * @since GDAL 2.4
+ */
+CPLWorkerThreadPool* GDALGetGlobalThreadPool( int nThreads )
+{
+    CPLMutexHolderD(&hGlobalThreadPoolMutex);
+    if( gpoGlobalThreadPool == nullptr )
+    {
+        const char* pszNumThreads =
+            CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+        int nPoolThreads = CPLGetNumCPUs();
+        if( pszNumThreads != nullptr && !EQUAL(pszNumThreads, "ALL_CPUS") )
+            nPoolThreads = atoi(pszNumThreads);
+        nPoolThreads = std::max(1, std::min(128,
+                                    std::max(nPoolThreads, nThreads)));
+
+        gpoGlobalThreadPool = new (std::nothrow) CPLWorkerThreadPool();
+        if( gpoGlobalThreadPool == nullptr ||
+            !gpoGlobalThreadPool->Setup(nPoolThreads, nullptr, nullptr) )
+        {
+            delete gpoGlobalThreadPool;
+            gpoGlobalThreadPool = nullptr;
+            return nullptr;
+        }
+        CPLDebug("GDAL", "Created global thread pool of %d threads",
+                 nPoolThreads);
+    }
+    return gpoGlobalThreadPool;
+}
+
+/************************************************************************/
+/*                 GDALCreateGlobalThreadPoolJobQueue()                 */
+/************************************************************************/
+
+/** Create a job queue on the process-wide worker thread pool, whose number
+ * of running jobs is limited to nThreads.
+ *
+ * @param nThreads Maximum number of jobs of the queue running concurrently.
+ * @return a new job queue, or nullptr in case of failure.
+ * @since GDAL 2.4
+ */
+std::unique_ptr<CPLJobQueue> GDALCreateGlobalThreadPoolJobQueue( int nThreads )
+{
+    CPLWorkerThreadPool* poPool = GDALGetGlobalThreadPool(nThreads);
+    if( poPool == nullptr )
+        return std::unique_ptr<CPLJobQueue>();
+    return poPool->CreateJobQueue(nThreads);
+}
+
+/************************************************************************/
+/*                          GDALGetNumThreads()                         */
+/************************************************************************/
+
+/** Return the number of worker threads requested by the user.
+ *
+ * The NUM_THREADS option of papszOptions is used if set, otherwise the
+ * pszConfigKey configuration option. The value is either a number of
+ * threads or ALL_CPUS. When none is set, 1 is returned.
+ *
+ * @param papszOptions Options (e.g. open or creation options), or nullptr.
+ * @param pszConfigKey Configuration option, GDAL_NUM_THREADS by default.
+ * @return a number of threads, between 1 and 128.
+ * @since GDAL 2.4
+ */
+int GDALGetNumThreads( CSLConstList papszOptions, const char* pszConfigKey )
+{
+    const char* pszThreads = CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if( pszThreads == nullptr )
+        pszThreads = CPLGetConfigOption(pszConfigKey, "1");
+    const int nThreads = EQUAL(pszThreads, "ALL_CPUS") ?
+                                CPLGetNumCPUs() : atoi(pszThreads);
+    return std::max(1, std::min(128, nThreads));
+}
+
+/************************************************************************/
+/*                          GDALGetStripYSize()                         */
+/************************************************************************/
+
+/** Return the number of lines of the strips used by the algorithms that
+ * process a raster by strips of full-width lines.
+ *
+ * Strips have about 256K pixels, and are aligned on the blocks when these
+ * are not larger than that.
+ *
+ * @param nXSize Raster width.
+ * @param nYSize Raster height.
+ * @param nBlockYSize Block height, or 0 for no alignment.
+ * @param nMinYSize Minimum number of lines, e.g. one per thread.
+ * @return a number of lines, between 1 and nYSize.
+ * @since GDAL 2.4
+ */
+int GDALGetStripYSize( int nXSize, int nYSize, int nBlockYSize,
+                       int nMinYSize )
+{
+    int nStripYSize = std::max(1, (256 * 1024) / std::max(1, nXSize));
+    if( nBlockYSize > 0 && nStripYSize >= nBlockYSize )
+        nStripYSize = (nStripYSize / nBlockYSize) * nBlockYSize;
+    nStripYSize = std::max(nStripYSize, nMinYSize);
+    return std::max(1, std::min(nStripYSize, nYSize));
+}
+
+/************************************************************************/
+/*                    GDALDestroyGlobalThreadPool()                     */
+/************************************************************************/
+
+// Called by GDALDestroyDriverManager(), once all datasets are closed.
+void GDALDestroyGlobalThreadPool()
+{
+    {
+        CPLMutexHolderD(&hGlobalThreadPoolMutex);
+        delete gpoGlobalThreadPool;
+        gpoGlobalThreadPool = nullptr;
+    }
+    if( hGlobalThreadPoolMutex )
+    {
+        CPLDestroyMutex(hGlobalThreadPoolMutex);
+        hGlobalThreadPoolMutex = nullptr;
+    }
+}
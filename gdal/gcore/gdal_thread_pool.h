@@ -0,0 +1,50 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Process-wide thread pool
+ * Author:   agent <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef GDAL_THREAD_POOL_H_INCLUDED
+#define GDAL_THREAD_POOL_H_INCLUDED
+
+#include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
+
+#include <memory>
+
+CPLWorkerThreadPool CPL_DLL* GDALGetGlobalThreadPool( int nThreads );
+
+std::unique_ptr<CPLJobQueue> CPL_DLL
+    GDALCreateGlobalThreadPoolJobQueue( int nThreads );
+
+void GDALDestroyGlobalThreadPool();
+
+int CPL_DLL GDALGetNumThreads( CSLConstList papszOptions = nullptr,
+                               const char* pszConfigKey = "GDAL_NUM_THREADS" );
+
+int CPL_DLL GDALGetStripYSize( int nXSize, int nYSize, int nBlockYSize = 0,
+                               int nMinYSize = 1 );
+
+#endif // GDAL_THREAD_POOL_H_INCLUDED
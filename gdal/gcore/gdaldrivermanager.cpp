@@ -44,6 +44,7 @@
 #include "gdal_alg_priv.h"
 #include "gdal.h"
 #include "gdal_pam.h"
+#include "gdal_thread_pool.h"
 #include "gdal_version.h"
 #include "ogr_srs_api.h"
 #include "ograpispy.h"
@@ -295,6 +296,7 @@ GDALDriverManager::~GDALDriverManager()
 /*      Cleanup gdaltransformer.cpp mutex.                              */
 /* -------------------------------------------------------------------- */
     GDALCleanupTransformDeserializerMutex();
+    GDALCleanupGridTransformerCache();
 
 /* -------------------------------------------------------------------- */
 /*      Cleanup cpl_error.cpp mutex.                                    */
@@ -892,4 +894,7 @@ void CPL_STDCALL GDALDestroyDriverManager( void )
         delete poDM;
         poDM = nullptr;
     }
+
+    // After the datasets have been closed, since they may use it.
+    GDALDestroyGlobalThreadPool();
 }
@@ -39,17 +39,24 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <deque>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <new>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_multiproc.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_virtualmem.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_rat.h"
+#include "gdal_thread_pool.h"
 #include "gdal_priv_templates.hpp"
 
 CPL_CVSID("$Id$")
@@ -2875,6 +2882,160 @@ GDALDatasetH CPL_STDCALL GDALGetBandDataset( GDALRasterBandH hBand )
     return GDALDataset::ToHandle(poBand->GetDataset());
 }
 
+/************************************************************************/
+/*                     GDALGetStatisticsThreadCount()                   */
+/************************************************************************/
+
+static int GDALGetStatisticsThreadCount( int nSampleBlocks )
+{
+    return std::min(GDALGetNumThreads(), nSampleBlocks);
+}
+
+/************************************************************************/
+/*                        GDALBlockStatsRunner                          */
+/*                                                                      */
+/*      Runs the per-block computations of ComputeStatistics() and      */
+/*      GetHistogram() in worker threads. Blocks are fetched by the     */
+/*      calling thread, since drivers cannot be read concurrently, and  */
+/*      each job accumulates into its own partial result, which is      */
+/*      merged by the calling thread in block order, so that the result */
+/*      does not depend on thread scheduling.                           */
+/************************************************************************/
+
+namespace {
+
+template<class Partial> class GDALBlockStatsRunner
+{
+  public:
+    // Accumulate the block data into the partial result.
+    typedef std::function<void(const void*, int, int, Partial&)> ComputeFunc;
+    // Merge the partial result into the final one, and reset it.
+    typedef std::function<void(Partial&)> MergeFunc;
+
+  private:
+    struct Job
+    {
+        GDALBlockStatsRunner *poRunner = nullptr;
+        GDALRasterBlock      *poBlock = nullptr;
+        int                   nXCheck = 0;
+        int                   nYCheck = 0;
+        bool                  bFinished = false;
+        Partial               oPartial;
+
+        explicit Job( const Partial& oPartialIn ) : oPartial(oPartialIn) {}
+    };
+
+    std::unique_ptr<CPLJobQueue> m_poJobQueue{};
+    CPLMutex           *m_hMutex = nullptr;
+    const Partial       m_oInitPartial;
+    ComputeFunc         m_oCompute;
+    MergeFunc           m_oMerge;
+    size_t              m_nMaxPendingJobs = 0;
+    std::deque<Job*>    m_apoPendingJobs{};
+    std::vector<Job*>   m_apoFreeJobs{};
+    std::vector<std::unique_ptr<Job>> m_apoJobs{};
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALBlockStatsRunner)
+
+    static void JobFunc( void* pData )
+    {
+        Job* psJob = static_cast<Job*>(pData);
+        GDALBlockStatsRunner* poRunner = psJob->poRunner;
+        poRunner->m_oCompute(psJob->poBlock->GetDataRef(),
+                             psJob->nXCheck, psJob->nYCheck,
+                             psJob->oPartial);
+        psJob->poBlock->DropLock();
+
+        CPLAcquireMutex(poRunner->m_hMutex, 1000.0);
+        psJob->bFinished = true;
+        CPLReleaseMutex(poRunner->m_hMutex);
+    }
+
+    bool IsFinished( const Job* psJob )
+    {
+        CPLAcquireMutex(m_hMutex, 1000.0);
+        const bool bFinished = psJob->bFinished;
+        CPLReleaseMutex(m_hMutex);
+        return bFinished;
+    }
+
+    void MergeOldestJob()
+    {
+        Job* psJob = m_apoPendingJobs.front();
+        m_apoPendingJobs.pop_front();
+
+        while( !IsFinished(psJob) )
+            m_poJobQueue->WaitEvent();
+
+        m_oMerge(psJob->oPartial);
+        m_apoFreeJobs.push_back(psJob);
+    }
+
+  public:
+    GDALBlockStatsRunner( const Partial& oInitPartial,
+                          const ComputeFunc& oCompute,
+                          const MergeFunc& oMerge ) :
+        m_oInitPartial(oInitPartial), m_oCompute(oCompute), m_oMerge(oMerge)
+    {}
+
+    ~GDALBlockStatsRunner()
+    {
+        // Pending jobs reference this object, so wait for them even if
+        // their result is discarded.
+        m_poJobQueue.reset();
+        if( m_hMutex )
+            CPLDestroyMutex(m_hMutex);
+    }
+
+    bool Setup( int nThreads )
+    {
+        m_hMutex = CPLCreateMutex();
+        if( m_hMutex == nullptr )
+            return false;
+        CPLReleaseMutex(m_hMutex);
+        // Bound the number of blocks that are kept locked in the cache.
+        m_nMaxPendingJobs = 2 * static_cast<size_t>(nThreads);
+        m_poJobQueue = GDALCreateGlobalThreadPoolJobQueue(nThreads);
+        return m_poJobQueue != nullptr;
+    }
+
+    // Takes ownership of the lock of poBlock.
+    void Process( GDALRasterBlock* poBlock, int nXCheck, int nYCheck )
+    {
+        while( m_apoPendingJobs.size() >= m_nMaxPendingJobs )
+            MergeOldestJob();
+
+        Job* psJob;
+        if( m_apoFreeJobs.empty() )
+        {
+            m_apoJobs.emplace_back(new Job(m_oInitPartial));
+            psJob = m_apoJobs.back().get();
+            psJob->poRunner = this;
+        }
+        else
+        {
+            psJob = m_apoFreeJobs.back();
+            m_apoFreeJobs.pop_back();
+        }
+        psJob->poBlock = poBlock;
+        psJob->nXCheck = nXCheck;
+        psJob->nYCheck = nYCheck;
+        psJob->bFinished = false;
+        m_apoPendingJobs.push_back(psJob);
+        if( !m_poJobQueue->SubmitJob(JobFunc, psJob) )
+            JobFunc(psJob);
+    }
+
+    // Wait for all jobs and merge their results.
+    void Finish()
+    {
+        while( !m_apoPendingJobs.empty() )
+            MergeOldestJob();
+    }
+};
+
+} // namespace
+
 /************************************************************************/
 /*                            GetHistogram()                            */
 /************************************************************************/
@@ -2904,6 +3065,10 @@ GDALDatasetH CPL_STDCALL GDALGetBandDataset( GDALRasterBandH hBand )
  * This method is the same as the C functions GDALGetRasterHistogram() and
  * GDALGetRasterHistogramEx().
  *
+ * Starting with GDAL 2.4, the GDAL_NUM_THREADS configuration option can be
+ * set to a number of threads or ALL_CPUS, so that the histograms of blocks
+ * are computed in parallel.
+ *
  * @param dfMin the lower bound of the histogram.
  * @param dfMax the upper bound of the histogram.
  * @param nBuckets the number of buckets in panHistogram.
@@ -3168,33 +3333,10 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
 /* -------------------------------------------------------------------- */
 /*      Read the blocks, and add to histogram.                          */
 /* -------------------------------------------------------------------- */
-        for( int iSampleBlock = 0;
-             iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
-             iSampleBlock += nSampleRate )
+        const auto ComputeBlockHistogram =
+            [&](const void* pData, int nXCheck, int nYCheck,
+                GUIntBig* panBlockHistogram)
         {
-            if( !pfnProgress(
-                    iSampleBlock /
-                        (static_cast<double>(nBlocksPerRow) * nBlocksPerColumn),
-                    "Compute Histogram", pProgressData ) )
-                return CE_Failure;
-
-            const int iYBlock = iSampleBlock / nBlocksPerRow;
-            const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
-
-            GDALRasterBlock *poBlock = GetLockedBlockRef( iXBlock, iYBlock );
-            if( poBlock == nullptr )
-                return CE_Failure;
-
-            void *pData = poBlock->GetDataRef();
-
-            int nXCheck = nBlockXSize;
-            if( (iXBlock+1) * nBlockXSize > GetXSize() )
-                nXCheck = GetXSize() - iXBlock * nBlockXSize;
-
-            int nYCheck = nBlockYSize;
-            if( (iYBlock+1) * nBlockYSize > GetYSize() )
-                nYCheck = GetYSize() - iYBlock * nBlockYSize;
-
             // this is a special case for a common situation.
             if( eDataType == GDT_Byte && !bSignedByte
                 && dfScale == 1.0 && (dfMin >= -0.5 && dfMin <= 0.5)
@@ -3202,17 +3344,16 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
                 && nBuckets == 256 )
             {
                 const int nPixels = nXCheck * nYCheck;
-                GByte *pabyData = static_cast<GByte *>(pData);
+                const GByte *pabyData = static_cast<const GByte *>(pData);
 
                 for( int i = 0; i < nPixels; i++ )
                     if( ! (bGotNoDataValue &&
                            (pabyData[i] == static_cast<GByte>(dfNoDataValue))))
                     {
-                        panHistogram[pabyData[i]]++;
+                        panBlockHistogram[pabyData[i]]++;
                     }
 
-                poBlock->DropLock();
-                continue;  // To next sample block.
+                return;
             }
 
             // This isn't the fastest way to do this, but is easier for now.
@@ -3229,26 +3370,26 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
                       {
                         if( bSignedByte )
                             dfValue =
-                                static_cast<signed char *>(pData)[iOffset];
+                                static_cast<const signed char *>(pData)[iOffset];
                         else
-                            dfValue = static_cast<GByte *>(pData)[iOffset];
+                            dfValue = static_cast<const GByte *>(pData)[iOffset];
                         break;
                       }
                       case GDT_UInt16:
-                        dfValue = static_cast<GUInt16 *>(pData)[iOffset];
+                        dfValue = static_cast<const GUInt16 *>(pData)[iOffset];
                         break;
                       case GDT_Int16:
-                        dfValue = static_cast<GInt16 *>(pData)[iOffset];
+                        dfValue = static_cast<const GInt16 *>(pData)[iOffset];
                         break;
                       case GDT_UInt32:
-                        dfValue = static_cast<GUInt32 *>(pData)[iOffset];
+                        dfValue = static_cast<const GUInt32 *>(pData)[iOffset];
                         break;
                       case GDT_Int32:
-                        dfValue = static_cast<GInt32 *>(pData)[iOffset];
+                        dfValue = static_cast<const GInt32 *>(pData)[iOffset];
                         break;
                       case GDT_Float32:
                       {
-                        const float fValue = static_cast<float *>(pData)[iOffset];
+                        const float fValue = static_cast<const float *>(pData)[iOffset];
                         if( CPLIsNan(fValue) ||
                             (bGotFloatNoDataValue && ARE_REAL_EQUAL(fValue, fNoDataValue)) )
                             continue;
@@ -3256,34 +3397,34 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
                         break;
                       }
                       case GDT_Float64:
-                        dfValue = static_cast<double *>(pData)[iOffset];
+                        dfValue = static_cast<const double *>(pData)[iOffset];
                         if( CPLIsNan(dfValue) )
                             continue;
                         break;
                       case GDT_CInt16:
                         {
                             double  dfReal =
-                                static_cast<GInt16 *>(pData)[iOffset*2];
+                                static_cast<const GInt16 *>(pData)[iOffset*2];
                             double  dfImag =
-                                static_cast<GInt16 *>(pData)[iOffset*2+1];
+                                static_cast<const GInt16 *>(pData)[iOffset*2+1];
                             dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
                         }
                         break;
                       case GDT_CInt32:
                         {
                             double  dfReal =
-                                static_cast<GInt32 *>(pData)[iOffset*2];
+                                static_cast<const GInt32 *>(pData)[iOffset*2];
                             double  dfImag =
-                                static_cast<GInt32 *>(pData)[iOffset*2+1];
+                                static_cast<const GInt32 *>(pData)[iOffset*2+1];
                             dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
                         }
                         break;
                       case GDT_CFloat32:
                         {
                             double  dfReal =
-                                static_cast<float *>(pData)[iOffset*2];
+                                static_cast<const float *>(pData)[iOffset*2];
                             double  dfImag =
-                                static_cast<float *>(pData)[iOffset*2+1];
+                                static_cast<const float *>(pData)[iOffset*2+1];
                             if ( CPLIsNan(dfReal) || CPLIsNan(dfImag) )
                                 continue;
                             dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
@@ -3292,9 +3433,9 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
                       case GDT_CFloat64:
                         {
                             double  dfReal =
-                                static_cast<double *>(pData)[iOffset*2];
+                                static_cast<const double *>(pData)[iOffset*2];
                             double  dfImag =
-                                static_cast<double *>(pData)[iOffset*2+1];
+                                static_cast<const double *>(pData)[iOffset*2+1];
                             if ( CPLIsNan(dfReal) || CPLIsNan(dfImag) )
                                 continue;
                             dfValue = sqrt( dfReal * dfReal + dfImag * dfImag );
@@ -3302,7 +3443,7 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
                         break;
                       default:
                         CPLAssert( false );
-                        return CE_Failure;
+                        return;
                     }
 
                     if( eDataType != GDT_Float32 && bGotNoDataValue &&
@@ -3315,22 +3456,93 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
                     if( nIndex < 0 )
                     {
                         if( bIncludeOutOfRange )
-                            ++panHistogram[0];
+                            ++panBlockHistogram[0];
                     }
                     else if( nIndex >= nBuckets )
                     {
                         if( bIncludeOutOfRange )
-                            ++panHistogram[nBuckets-1];
+                            ++panBlockHistogram[nBuckets-1];
                     }
                     else
                     {
-                        panHistogram[nIndex]++;
+                        panBlockHistogram[nIndex]++;
                     }
                 }
             }
+        };
+
+        // Multi-threaded computation, with per-job histograms merged by
+        // this thread. Not worth it if the histogram is so large that
+        // merging it costs as much as computing it.
+        const int nSampleBlocks =
+            DIV_ROUND_UP(nBlocksPerRow * nBlocksPerColumn, nSampleRate);
+        const int nThreads = GDALGetStatisticsThreadCount(nSampleBlocks);
+        typedef GDALBlockStatsRunner<std::vector<GUIntBig>> HistogramRunner;
+        std::unique_ptr<HistogramRunner> poRunner;
+        if( nThreads > 1 &&
+            static_cast<GIntBig>(nBuckets) <
+                static_cast<GIntBig>(nBlockXSize) * nBlockYSize )
+        {
+            poRunner.reset(new HistogramRunner(
+                std::vector<GUIntBig>(nBuckets),
+                [&ComputeBlockHistogram](const void* pData,
+                                         int nXCheck, int nYCheck,
+                                         std::vector<GUIntBig>& anPartial)
+                {
+                    ComputeBlockHistogram(pData, nXCheck, nYCheck,
+                                          &anPartial[0]);
+                },
+                [panHistogram, nBuckets](std::vector<GUIntBig>& anPartial)
+                {
+                    for( int i = 0; i < nBuckets; ++i )
+                    {
+                        panHistogram[i] += anPartial[i];
+                        anPartial[i] = 0;
+                    }
+                }));
+            if( !poRunner->Setup(nThreads) )
+                poRunner.reset();
+        }
+
+        for( int iSampleBlock = 0;
+             iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
+             iSampleBlock += nSampleRate )
+        {
+            if( !pfnProgress(
+                    iSampleBlock /
+                        (static_cast<double>(nBlocksPerRow) * nBlocksPerColumn),
+                    "Compute Histogram", pProgressData ) )
+                return CE_Failure;
+
+            const int iYBlock = iSampleBlock / nBlocksPerRow;
+            const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
+
+            GDALRasterBlock *poBlock = GetLockedBlockRef( iXBlock, iYBlock );
+            if( poBlock == nullptr )
+                return CE_Failure;
+
+            int nXCheck = nBlockXSize;
+            if( (iXBlock+1) * nBlockXSize > GetXSize() )
+                nXCheck = GetXSize() - iXBlock * nBlockXSize;
+
+            int nYCheck = nBlockYSize;
+            if( (iYBlock+1) * nBlockYSize > GetYSize() )
+                nYCheck = GetYSize() - iYBlock * nBlockYSize;
+
+            if( poRunner )
+            {
+                poRunner->Process(poBlock, nXCheck, nYCheck);
+                continue;
+            }
+
+            ComputeBlockHistogram( poBlock->GetDataRef(), nXCheck, nYCheck,
+                                   panHistogram );
 
             poBlock->DropLock();
         }
+
+        if( poRunner )
+            poRunner->Finish();
     }
 
     pfnProgress( 1.0, "Compute Histogram", pProgressData );
@@ -4694,8 +4906,502 @@ void ComputeStatisticsInternal<GUInt16>( int nXCheck,
 
 #endif // (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(_MSC_VER))
 
+// GInt16 values are shifted by 32768 into a GUInt16 buffer, so as to use
+// the GUInt16 code path. Statistics are thus returned shifted as well,
+// except the standard deviation that can be derived from nSum and nSumSquare.
+static void ComputeStatisticsInternalInt16( int nXCheck,
+                                            int nBlockXSize,
+                                            int nYCheck,
+                                            const GInt16* pData,
+                                            bool bHasNoData,
+                                            GUInt32 nNoDataValue,
+                                            GUInt32& nMin,
+                                            GUInt32& nMax,
+                                            GUIntBig& nSum,
+                                            GUIntBig& nSumSquare,
+                                            GUIntBig& nSampleCount )
+{
+    constexpr int CHUNK_SIZE = 4096;
+    // 32-byte alignment may not be enforced by linker, so do it at hand
+    GUInt16 anUnaligned[CHUNK_SIZE + 16];
+    GUInt16* panShifted = anUnaligned +
+        (32 - (reinterpret_cast<GUIntptr_t>(anUnaligned) % 32)) /
+            sizeof(GUInt16);
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const GInt16* pLine = pData + static_cast<size_t>(iY) * nBlockXSize;
+        for( int iX = 0; iX < nXCheck; iX += CHUNK_SIZE )
+        {
+            const int nCount = std::min(CHUNK_SIZE, nXCheck - iX);
+            for( int i = 0; i < nCount; i++ )
+            {
+                panShifted[i] = static_cast<GUInt16>(
+                    static_cast<GUInt16>(pLine[iX + i]) ^ 0x8000);
+            }
+            ComputeStatisticsInternal( nCount, nCount, 1,
+                                       panShifted,
+                                       bHasNoData, nNoDataValue,
+                                       nMin, nMax, nSum, nSumSquare,
+                                       nSampleCount );
+        }
+    }
+}
+
 #endif // CPL_HAS_GINT64
 
+/************************************************************************/
+/*                        GDALStatsAccumulator                          */
+/************************************************************************/
+
+namespace {
+
+// Minimum, maximum, mean and sum of squares of differences to the mean of
+// a set of samples. Samples can be added one at a time with the Welford
+// algorithm, and two accumulators can be merged with the formulas of
+// Chan et al.
+// http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+struct GDALStatsAccumulator
+{
+    double   dfMin = 0.0;
+    double   dfMax = 0.0;
+    double   dfMean = 0.0;
+    double   dfM2 = 0.0;
+    GUIntBig nSampleCount = 0;
+
+    inline void Add( double dfValue )
+    {
+        if( nSampleCount == 0 )
+        {
+            dfMin = dfValue;
+            dfMax = dfValue;
+        }
+        else
+        {
+            dfMin = std::min(dfMin, dfValue);
+            dfMax = std::max(dfMax, dfValue);
+        }
+
+        nSampleCount++;
+        const double dfDelta = dfValue - dfMean;
+        dfMean += dfDelta / nSampleCount;
+        dfM2 += dfDelta * (dfValue - dfMean);
+    }
+
+    void Merge( const GDALStatsAccumulator& oOther )
+    {
+        if( oOther.nSampleCount == 0 )
+            return;
+        if( nSampleCount == 0 )
+        {
+            *this = oOther;
+            return;
+        }
+        dfMin = std::min(dfMin, oOther.dfMin);
+        dfMax = std::max(dfMax, oOther.dfMax);
+        const double dfCount = static_cast<double>(nSampleCount);
+        const double dfOtherCount = static_cast<double>(oOther.nSampleCount);
+        const double dfNewCount = dfCount + dfOtherCount;
+        const double dfDelta = oOther.dfMean - dfMean;
+        dfMean += dfDelta * dfOtherCount / dfNewCount;
+        dfM2 += oOther.dfM2 +
+                dfDelta * dfDelta * dfCount * dfOtherCount / dfNewCount;
+        nSampleCount += oOther.nSampleCount;
+    }
+};
+
+// Statistics of unsigned integer values, computed exactly.
+struct GDALIntegerStats
+{
+    GUInt32  nMin = 0;
+    GUInt32  nMax = 0;
+    GUIntBig nSum = 0;
+    GUIntBig nSumSquare = 0;
+    GUIntBig nSampleCount = 0;
+};
+
+} // namespace
+
+/************************************************************************/
+/*                     ComputeBlockStatisticsFloat()                    */
+/************************************************************************/
+
+// Statistics of a Float32 or Float64 block, computed with a two-pass
+// algorithm (sum, then sum of squared differences to the block mean) that
+// is as robust as the Welford algorithm, but vectorizes. NaN values and
+// values equal to the nodata value (with the ARE_REAL_EQUAL() tolerance)
+// are ignored.
+template<class T>
+static void ComputeBlockStatisticsFloatGeneric( int nXCheck,
+                                                int nBlockXSize,
+                                                int nYCheck,
+                                                const T* pData,
+                                                bool bHasNoData,
+                                                T tNoDataValue,
+                                                GDALStatsAccumulator& oAcc )
+{
+    GDALStatsAccumulator oBlock;
+    double dfSum = 0.0;
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const T* const pLine = pData + static_cast<size_t>(iY) * nBlockXSize;
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            const T tValue = pLine[iX];
+            if( CPLIsNan(tValue) ||
+                (bHasNoData && ARE_REAL_EQUAL(tValue, tNoDataValue)) )
+                continue;
+            const double dfValue = tValue;
+            if( oBlock.nSampleCount == 0 )
+            {
+                oBlock.dfMin = dfValue;
+                oBlock.dfMax = dfValue;
+            }
+            else
+            {
+                oBlock.dfMin = std::min(oBlock.dfMin, dfValue);
+                oBlock.dfMax = std::max(oBlock.dfMax, dfValue);
+            }
+            oBlock.nSampleCount++;
+            dfSum += dfValue;
+        }
+    }
+    if( oBlock.nSampleCount == 0 )
+        return;
+    oBlock.dfMean = dfSum / oBlock.nSampleCount;
+
+    double dfSumDelta = 0.0;
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const T* const pLine = pData + static_cast<size_t>(iY) * nBlockXSize;
+        for( int iX = 0; iX < nXCheck; iX++ )
+        {
+            const T tValue = pLine[iX];
+            if( CPLIsNan(tValue) ||
+                (bHasNoData && ARE_REAL_EQUAL(tValue, tNoDataValue)) )
+                continue;
+            const double dfDelta = tValue - oBlock.dfMean;
+            dfSumDelta += dfDelta;
+            oBlock.dfM2 += dfDelta * dfDelta;
+        }
+    }
+    // Correct the rounding error of the mean.
+    oBlock.dfM2 -= dfSumDelta * dfSumDelta / oBlock.nSampleCount;
+    if( oBlock.dfM2 < 0 )
+        oBlock.dfM2 = 0;
+
+    oAcc.Merge(oBlock);
+}
+
+template<class T>
+static void ComputeBlockStatisticsFloat( int nXCheck,
+                                         int nBlockXSize,
+                                         int nYCheck,
+                                         const T* pData,
+                                         bool bHasNoData,
+                                         T tNoDataValue,
+                                         GDALStatsAccumulator& oAcc )
+{
+    ComputeBlockStatisticsFloatGeneric( nXCheck, nBlockXSize, nYCheck, pData,
+                                        bHasNoData, tNoDataValue, oAcc );
+}
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(_MSC_VER))
+
+#include <emmintrin.h>
+
+namespace {
+
+// Accumulates the sum, count, minimum and maximum of valid values in
+// 2 double lanes, and then the sum of (squared) differences to the mean.
+struct GDALStatsSSE2Accumulator
+{
+    __m128d xmm_sum = _mm_setzero_pd();
+    __m128d xmm_count = _mm_setzero_pd();
+    __m128d xmm_min =
+        _mm_set1_pd(std::numeric_limits<double>::infinity());
+    __m128d xmm_max =
+        _mm_set1_pd(-std::numeric_limits<double>::infinity());
+    __m128d xmm_mean = _mm_setzero_pd();
+    __m128d xmm_sum_delta = _mm_setzero_pd();
+    __m128d xmm_m2 = _mm_setzero_pd();
+
+    inline void AddPass1( __m128d xmm_value, __m128d xmm_valid )
+    {
+        const __m128d xmm_one = _mm_set1_pd(1.0);
+        xmm_sum = _mm_add_pd(xmm_sum, _mm_and_pd(xmm_valid, xmm_value));
+        xmm_count = _mm_add_pd(xmm_count, _mm_and_pd(xmm_valid, xmm_one));
+        // Invalid values are replaced by the current min/max.
+        xmm_min = _mm_min_pd(xmm_min,
+            _mm_or_pd(_mm_and_pd(xmm_valid, xmm_value),
+                      _mm_andnot_pd(xmm_valid, xmm_min)));
+        xmm_max = _mm_max_pd(xmm_max,
+            _mm_or_pd(_mm_and_pd(xmm_valid, xmm_value),
+                      _mm_andnot_pd(xmm_valid, xmm_max)));
+    }
+
+    inline void AddPass2( __m128d xmm_value, __m128d xmm_valid )
+    {
+        const __m128d xmm_delta =
+            _mm_and_pd(xmm_valid, _mm_sub_pd(xmm_value, xmm_mean));
+        xmm_sum_delta = _mm_add_pd(xmm_sum_delta, xmm_delta);
+        xmm_m2 = _mm_add_pd(xmm_m2, _mm_mul_pd(xmm_delta, xmm_delta));
+    }
+
+    static inline double HorizontalSum( __m128d xmm )
+    {
+        double adf[2];
+        _mm_storeu_pd(adf, xmm);
+        return adf[0] + adf[1];
+    }
+};
+
+// Valid mask for 2 doubles: not NaN and not equal to nodata.
+static inline __m128d GDALStatsGetValidMask( __m128d xmm_value,
+                                             bool bHasNoData,
+                                             __m128d xmm_nodata )
+{
+    __m128d xmm_valid = _mm_cmpeq_pd(xmm_value, xmm_value);
+    if( bHasNoData )
+    {
+        // Same as ARE_REAL_EQUAL(value, nodata)
+        const __m128d xmm_abs_mask = _mm_castsi128_pd(
+            _mm_set_epi32(0x7FFFFFFF, -1, 0x7FFFFFFF, -1));
+        const __m128d xmm_eps = _mm_set1_pd(
+            static_cast<double>(std::numeric_limits<float>::epsilon()) * 2);
+        const __m128d xmm_eq = _mm_or_pd(
+            _mm_cmpeq_pd(xmm_value, xmm_nodata),
+            _mm_cmplt_pd(
+                _mm_and_pd(xmm_abs_mask, _mm_sub_pd(xmm_value, xmm_nodata)),
+                _mm_mul_pd(xmm_eps,
+                    _mm_and_pd(xmm_abs_mask,
+                               _mm_add_pd(xmm_value, xmm_nodata)))));
+        xmm_valid = _mm_andnot_pd(xmm_eq, xmm_valid);
+    }
+    return xmm_valid;
+}
+
+// Valid mask for 4 floats: not NaN and not equal to nodata.
+static inline __m128 GDALStatsGetValidMask( __m128 xmm_value,
+                                            bool bHasNoData,
+                                            __m128 xmm_nodata )
+{
+    __m128 xmm_valid = _mm_cmpeq_ps(xmm_value, xmm_value);
+    if( bHasNoData )
+    {
+        // Same as ARE_REAL_EQUAL(value, nodata)
+        const __m128 xmm_abs_mask =
+            _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 xmm_eps =
+            _mm_set1_ps(std::numeric_limits<float>::epsilon() * 2);
+        const __m128 xmm_eq = _mm_or_ps(
+            _mm_cmpeq_ps(xmm_value, xmm_nodata),
+            _mm_cmplt_ps(
+                _mm_and_ps(xmm_abs_mask, _mm_sub_ps(xmm_value, xmm_nodata)),
+                _mm_mul_ps(xmm_eps,
+                    _mm_and_ps(xmm_abs_mask,
+                               _mm_add_ps(xmm_value, xmm_nodata)))));
+        xmm_valid = _mm_andnot_ps(xmm_eq, xmm_valid);
+    }
+    return xmm_valid;
+}
+
+// Finalize the SIMD accumulation together with the scalar accumulation
+// of the remaining values.
+static void GDALStatsMergeSSE2( const GDALStatsSSE2Accumulator& oSSE2,
+                                GDALStatsAccumulator& oAcc )
+{
+    GDALStatsAccumulator oBlock;
+    oBlock.nSampleCount = static_cast<GUIntBig>(
+        GDALStatsSSE2Accumulator::HorizontalSum(oSSE2.xmm_count));
+    if( oBlock.nSampleCount == 0 )
+        return;
+    double adfMin[2];
+    double adfMax[2];
+    _mm_storeu_pd(adfMin, oSSE2.xmm_min);
+    _mm_storeu_pd(adfMax, oSSE2.xmm_max);
+    oBlock.dfMin = std::min(adfMin[0], adfMin[1]);
+    oBlock.dfMax = std::max(adfMax[0], adfMax[1]);
+    oBlock.dfMean = _mm_cvtsd_f64(oSSE2.xmm_mean);
+    const double dfSumDelta =
+        GDALStatsSSE2Accumulator::HorizontalSum(oSSE2.xmm_sum_delta);
+    oBlock.dfM2 = GDALStatsSSE2Accumulator::HorizontalSum(oSSE2.xmm_m2) -
+                  dfSumDelta * dfSumDelta / oBlock.nSampleCount;
+    if( oBlock.dfM2 < 0 )
+        oBlock.dfM2 = 0;
+    oAcc.Merge(oBlock);
+}
+
+} // namespace
+
+// SSE2 optimization for Float64 case
+template<>
+void ComputeBlockStatisticsFloat<double>( int nXCheck,
+                                          int nBlockXSize,
+                                          int nYCheck,
+                                          const double* pData,
+                                          bool bHasNoData,
+                                          double dfNoDataValue,
+                                          GDALStatsAccumulator& oAcc )
+{
+    if( nXCheck < 2 )
+    {
+        ComputeBlockStatisticsFloatGeneric( nXCheck, nBlockXSize, nYCheck,
+                                            pData, bHasNoData, dfNoDataValue,
+                                            oAcc );
+        return;
+    }
+
+    const __m128d xmm_nodata = _mm_set1_pd(dfNoDataValue);
+    GDALStatsSSE2Accumulator oSSE2;
+
+    // Values that do not fill a whole vector are loaded as a vector whose
+    // other lane is forced to be invalid.
+    const auto LoadTail = [](const double* pLine, int iX)
+    {
+        return _mm_set_pd(std::numeric_limits<double>::quiet_NaN(),
+                          pLine[iX]);
+    };
+
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const double* const pLine =
+            pData + static_cast<size_t>(iY) * nBlockXSize;
+        int iX = 0;
+        for( ; iX + 1 < nXCheck; iX += 2 )
+        {
+            const __m128d xmm = _mm_loadu_pd(pLine + iX);
+            oSSE2.AddPass1(xmm,
+                           GDALStatsGetValidMask(xmm, bHasNoData, xmm_nodata));
+        }
+        if( iX < nXCheck )
+        {
+            const __m128d xmm = LoadTail(pLine, iX);
+            oSSE2.AddPass1(xmm,
+                           GDALStatsGetValidMask(xmm, bHasNoData, xmm_nodata));
+        }
+    }
+
+    const double dfCount =
+        GDALStatsSSE2Accumulator::HorizontalSum(oSSE2.xmm_count);
+    if( dfCount == 0 )
+        return;
+    oSSE2.xmm_mean = _mm_set1_pd(
+        GDALStatsSSE2Accumulator::HorizontalSum(oSSE2.xmm_sum) / dfCount);
+
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const double* const pLine =
+            pData + static_cast<size_t>(iY) * nBlockXSize;
+        int iX = 0;
+        for( ; iX + 1 < nXCheck; iX += 2 )
+        {
+            const __m128d xmm = _mm_loadu_pd(pLine + iX);
+            oSSE2.AddPass2(xmm,
+                           GDALStatsGetValidMask(xmm, bHasNoData, xmm_nodata));
+        }
+        if( iX < nXCheck )
+        {
+            const __m128d xmm = LoadTail(pLine, iX);
+            oSSE2.AddPass2(xmm,
+                           GDALStatsGetValidMask(xmm, bHasNoData, xmm_nodata));
+        }
+    }
+
+    GDALStatsMergeSSE2(oSSE2, oAcc);
+}
+
+// SSE2 optimization for Float32 case: validity is tested on 4 floats, and
+// accumulation is done on 2x2 doubles.
+template<>
+void ComputeBlockStatisticsFloat<float>( int nXCheck,
+                                         int nBlockXSize,
+                                         int nYCheck,
+                                         const float* pData,
+                                         bool bHasNoData,
+                                         float fNoDataValue,
+                                         GDALStatsAccumulator& oAcc )
+{
+    if( nXCheck < 4 )
+    {
+        ComputeBlockStatisticsFloatGeneric( nXCheck, nBlockXSize, nYCheck,
+                                            pData, bHasNoData, fNoDataValue,
+                                            oAcc );
+        return;
+    }
+
+    const __m128 xmm_nodata = _mm_set1_ps(fNoDataValue);
+    GDALStatsSSE2Accumulator oSSE2;
+
+    // Load 4 floats, with the ones beyond nXCheck forced to be invalid.
+    const auto Load = [nXCheck](const float* pLine, int iX)
+    {
+        if( iX + 3 < nXCheck )
+            return _mm_loadu_ps(pLine + iX);
+        float afTmp[4] = { std::numeric_limits<float>::quiet_NaN(),
+                           std::numeric_limits<float>::quiet_NaN(),
+                           std::numeric_limits<float>::quiet_NaN(),
+                           std::numeric_limits<float>::quiet_NaN() };
+        for( int i = 0; iX + i < nXCheck; ++i )
+            afTmp[i] = pLine[iX + i];
+        return _mm_loadu_ps(afTmp);
+    };
+
+    // Convert 4 floats and their validity mask to 2x2 doubles.
+    const auto Split = [](__m128 xmm, __m128 xmm_valid,
+                          __m128d& xmm_lo, __m128d& xmm_lo_valid,
+                          __m128d& xmm_hi, __m128d& xmm_hi_valid)
+    {
+        xmm_lo = _mm_cvtps_pd(xmm);
+        xmm_hi = _mm_cvtps_pd(_mm_movehl_ps(xmm, xmm));
+        const __m128i xmm_valid_i = _mm_castps_si128(xmm_valid);
+        xmm_lo_valid = _mm_castsi128_pd(
+            _mm_unpacklo_epi32(xmm_valid_i, xmm_valid_i));
+        xmm_hi_valid = _mm_castsi128_pd(
+            _mm_unpackhi_epi32(xmm_valid_i, xmm_valid_i));
+    };
+
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const float* const pLine =
+            pData + static_cast<size_t>(iY) * nBlockXSize;
+        for( int iX = 0; iX < nXCheck; iX += 4 )
+        {
+            const __m128 xmm = Load(pLine, iX);
+            __m128d xmm_lo, xmm_lo_valid, xmm_hi, xmm_hi_valid;
+            Split(xmm, GDALStatsGetValidMask(xmm, bHasNoData, xmm_nodata),
+                  xmm_lo, xmm_lo_valid, xmm_hi, xmm_hi_valid);
+            oSSE2.AddPass1(xmm_lo, xmm_lo_valid);
+            oSSE2.AddPass1(xmm_hi, xmm_hi_valid);
+        }
+    }
+
+    const double dfCount =
+        GDALStatsSSE2Accumulator::HorizontalSum(oSSE2.xmm_count);
+    if( dfCount == 0 )
+        return;
+    oSSE2.xmm_mean = _mm_set1_pd(
+        GDALStatsSSE2Accumulator::HorizontalSum(oSSE2.xmm_sum) / dfCount);
+
+    for( int iY = 0; iY < nYCheck; iY++ )
+    {
+        const float* const pLine =
+            pData + static_cast<size_t>(iY) * nBlockXSize;
+        for( int iX = 0; iX < nXCheck; iX += 4 )
+        {
+            const __m128 xmm = Load(pLine, iX);
+            __m128d xmm_lo, xmm_lo_valid, xmm_hi, xmm_hi_valid;
+            Split(xmm, GDALStatsGetValidMask(xmm, bHasNoData, xmm_nodata),
+                  xmm_lo, xmm_lo_valid, xmm_hi, xmm_hi_valid);
+            oSSE2.AddPass2(xmm_lo, xmm_lo_valid);
+            oSSE2.AddPass2(xmm_hi, xmm_hi_valid);
+        }
+    }
+
+    GDALStatsMergeSSE2(oSSE2, oAcc);
+}
+
+#endif // (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(_MSC_VER))
+
 /************************************************************************/
 /*                         ComputeStatistics()                          */
 /************************************************************************/
@@ -4713,6 +5419,10 @@ void ComputeStatisticsInternal<GUInt16>( int nXCheck,
  *
  * This method is the same as the C function GDALComputeRasterStatistics().
  *
+ * Starting with GDAL 2.4, the GDAL_NUM_THREADS configuration option can be
+ * set to a number of threads or ALL_CPUS, so that the statistics of blocks
+ * are computed in parallel. Blocks are still read by the calling thread.
+ *
  * @param bApproxOK If TRUE statistics may be computed based on overviews
  * or a subset of all tiles.
  *
@@ -4768,17 +5478,10 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
 /* -------------------------------------------------------------------- */
 /*      Read actual data and compute statistics.                        */
 /* -------------------------------------------------------------------- */
-    bool bFirstValue = true;
-    // Using Welford algorithm:
-    // http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
-    // to compute standard deviation in a more numerically robust way than
-    // the difference of the sum of square values with the square of the sum.
-    // dfMean and dfM2 are updated at each sample.
-    // dfM2 is the sum of square of differences to the current mean.
-    double dfMin = 0.0;
-    double dfMax = 0.0;
-    double dfMean = 0.0;
-    double dfM2 = 0.0;
+    // Using Welford algorithm to compute standard deviation in a more
+    // numerically robust way than the difference of the sum of square values
+    // with the square of the sum.
+    GDALStatsAccumulator oAcc;
 
     GDALRasterIOExtraArg sExtraArg;
     INIT_RASTERIO_EXTRA_ARG(sExtraArg);
@@ -4801,8 +5504,6 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
     const bool bSignedByte =
         pszPixelType != nullptr && EQUAL(pszPixelType, "SIGNEDBYTE");
 
-    GUIntBig nSampleCount = 0;
-
   if ( bApproxOK && HasArbitraryOverviews() )
     {
 /* -------------------------------------------------------------------- */
@@ -4910,22 +5611,7 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
                     bGotNoDataValue && ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
                     continue;
 
-                if( bFirstValue )
-                {
-                    dfMin = dfValue;
-                    dfMax = dfValue;
-                    bFirstValue = false;
-                }
-                else
-                {
-                    dfMin = std::min(dfMin, dfValue);
-                    dfMax = std::max(dfMax, dfValue);
-                }
-
-                nSampleCount++;
-                const double dfDelta = dfValue - dfMean;
-                dfMean += dfDelta / nSampleCount;
-                dfM2 += dfDelta * (dfValue - dfMean);
+                oAcc.Add(dfValue);
             }
         }
 
@@ -4960,30 +5646,108 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
         // intermediate computations. Only possible if the number of pixels
         // explored is lower than GUINTBIG_MAX / (255*255), so that nSumSquare
         // can fit on a uint64. Should be 99.99999% of cases.
-        // For GUInt16, this limits to raster of 4 giga pixels
+        // For GUInt16 and GInt16, this limits to raster of 4 giga pixels.
+        // GInt16 values are shifted by 32768 to be processed as GUInt16.
         if( (eDataType == GDT_Byte && !bSignedByte &&
              static_cast<GUIntBig>(nBlocksPerRow)*nBlocksPerColumn/nSampleRate <
                 GUINTBIG_MAX / (255U * 255U) /
                         static_cast<GUInt32>(nBlockXSize * nBlockYSize)) ||
-            (eDataType == GDT_UInt16 &&
+            ((eDataType == GDT_UInt16 || eDataType == GDT_Int16) &&
              static_cast<GUIntBig>(nBlocksPerRow)*nBlocksPerColumn/nSampleRate <
                 GUINTBIG_MAX / (65535U * 65535U) /
                         static_cast<GUInt32>(nBlockXSize * nBlockYSize)) )
         {
             const GUInt32 nMaxValueType = (eDataType == GDT_Byte) ? 255 : 65535;
-            GUInt32 nMin = nMaxValueType;
-            GUInt32 nMax = 0;
-            GUIntBig nSum = 0;
-            GUIntBig nSumSquare = 0;
+            const double dfShift = (eDataType == GDT_Int16) ? 32768.0 : 0.0;
+            GDALIntegerStats oStats;
+            oStats.nMin = nMaxValueType;
             // If no valid nodata, map to invalid value (256 for Byte)
+            const double dfShiftedNoDataValue = dfNoDataValue + dfShift;
             const GUInt32 nNoDataValue =
-                (bGotNoDataValue && dfNoDataValue >= 0 &&
-                 dfNoDataValue <= nMaxValueType &&
-                 fabs(dfNoDataValue -
-                      static_cast<GUInt32>(dfNoDataValue + 1e-10)) < 1e-10 ) ?
-                            static_cast<GUInt32>(dfNoDataValue + 1e-10) :
+                (bGotNoDataValue && dfShiftedNoDataValue >= 0 &&
+                 dfShiftedNoDataValue <= nMaxValueType &&
+                 fabs(dfShiftedNoDataValue -
+                      static_cast<GUInt32>(dfShiftedNoDataValue + 1e-10))
+                        < 1e-10 ) ?
+                            static_cast<GUInt32>(dfShiftedNoDataValue + 1e-10) :
                             nMaxValueType+1;
 
+            const auto ComputeBlockStatistics =
+                [this, nNoDataValue, nMaxValueType](
+                    const void* pData, int nXCheck, int nYCheck,
+                    GDALIntegerStats& oBlockStats)
+            {
+                if( eDataType == GDT_Byte )
+                {
+                    ComputeStatisticsInternal( nXCheck,
+                                               nBlockXSize,
+                                               nYCheck,
+                                               static_cast<const GByte*>(pData),
+                                               nNoDataValue <= nMaxValueType,
+                                               nNoDataValue,
+                                               oBlockStats.nMin,
+                                               oBlockStats.nMax,
+                                               oBlockStats.nSum,
+                                               oBlockStats.nSumSquare,
+                                               oBlockStats.nSampleCount );
+                }
+                else if( eDataType == GDT_UInt16 )
+                {
+                    ComputeStatisticsInternal( nXCheck,
+                                               nBlockXSize,
+                                               nYCheck,
+                                               static_cast<const GUInt16*>(pData),
+                                               nNoDataValue <= nMaxValueType,
+                                               nNoDataValue,
+                                               oBlockStats.nMin,
+                                               oBlockStats.nMax,
+                                               oBlockStats.nSum,
+                                               oBlockStats.nSumSquare,
+                                               oBlockStats.nSampleCount );
+                }
+                else
+                {
+                    ComputeStatisticsInternalInt16( nXCheck,
+                                               nBlockXSize,
+                                               nYCheck,
+                                               static_cast<const GInt16*>(pData),
+                                               nNoDataValue <= nMaxValueType,
+                                               nNoDataValue,
+                                               oBlockStats.nMin,
+                                               oBlockStats.nMax,
+                                               oBlockStats.nSum,
+                                               oBlockStats.nSumSquare,
+                                               oBlockStats.nSampleCount );
+                }
+            };
+
+            // Min and max are kept in the partial results, as merging them
+            // again is harmless, and they enable faster code paths in
+            // ComputeStatisticsInternal().
+            typedef GDALBlockStatsRunner<GDALIntegerStats> IntegerStatsRunner;
+            std::unique_ptr<IntegerStatsRunner> poRunner;
+            const int nThreads = GDALGetStatisticsThreadCount(
+                DIV_ROUND_UP(nBlocksPerRow * nBlocksPerColumn, nSampleRate));
+            if( nThreads > 1 )
+            {
+                poRunner.reset(new IntegerStatsRunner(
+                    oStats,
+                    ComputeBlockStatistics,
+                    [&oStats](GDALIntegerStats& oBlockStats)
+                    {
+                        oStats.nMin = std::min(oStats.nMin, oBlockStats.nMin);
+                        oStats.nMax = std::max(oStats.nMax, oBlockStats.nMax);
+                        oStats.nSum += oBlockStats.nSum;
+                        oStats.nSumSquare += oBlockStats.nSumSquare;
+                        oStats.nSampleCount += oBlockStats.nSampleCount;
+                        oBlockStats.nSum = 0;
+                        oBlockStats.nSumSquare = 0;
+                        oBlockStats.nSampleCount = 0;
+                    }));
+                if( !poRunner->Setup(nThreads) )
+                    poRunner.reset();
+            }
+
             for( int iSampleBlock = 0;
                 iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
                 iSampleBlock += nSampleRate )
@@ -4996,8 +5760,6 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
                 if( poBlock == nullptr )
                     return CE_Failure;
 
-                void* const pData = poBlock->GetDataRef();
-
                 int nXCheck = nBlockXSize;
                 if( (iXBlock+1) * nBlockXSize > GetXSize() )
                     nXCheck = GetXSize() - iXBlock * nBlockXSize;
@@ -5006,33 +5768,17 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
                 if( (iYBlock+1) * nBlockYSize > GetYSize() )
                     nYCheck = GetYSize() - iYBlock * nBlockYSize;
 
-                if( eDataType == GDT_Byte )
+                if( poRunner )
                 {
-                    ComputeStatisticsInternal( nXCheck,
-                                               nBlockXSize,
-                                               nYCheck,
-                                               static_cast<const GByte*>(pData),
-                                               nNoDataValue <= nMaxValueType,
-                                               nNoDataValue,
-                                               nMin, nMax, nSum,
-                                               nSumSquare,
-                                               nSampleCount );
+                    poRunner->Process(poBlock, nXCheck, nYCheck);
                 }
                 else
                 {
-                    ComputeStatisticsInternal( nXCheck,
-                                               nBlockXSize,
-                                               nYCheck,
-                                               static_cast<const GUInt16*>(pData),
-                                               nNoDataValue <= nMaxValueType,
-                                               nNoDataValue,
-                                               nMin, nMax, nSum,
-                                               nSumSquare,
-                                               nSampleCount );
+                    ComputeBlockStatistics( poBlock->GetDataRef(),
+                                            nXCheck, nYCheck, oStats );
+                    poBlock->DropLock();
                 }
 
-                poBlock->DropLock();
-
                 if ( !pfnProgress( iSampleBlock
                         / static_cast<double>(nBlocksPerRow*nBlocksPerColumn),
                         "Compute Statistics", pProgressData) )
@@ -5043,6 +5789,9 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
                 }
             }
 
+            if( poRunner )
+                poRunner->Finish();
+
             if( !pfnProgress( 1.0, "Compute Statistics", pProgressData ) )
             {
                 ReportError( CE_Failure, CPLE_UserInterrupt,
@@ -5053,30 +5802,35 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
 /* -------------------------------------------------------------------- */
 /*      Save computed information.                                      */
 /* -------------------------------------------------------------------- */
+            const GUIntBig nSampleCount = oStats.nSampleCount;
+            double dfMean = 0.0;
             if( nSampleCount )
-                dfMean = static_cast<double>(nSum) / nSampleCount;
+                dfMean = static_cast<double>(oStats.nSum) / nSampleCount -
+                         dfShift;
 
             // To avoid potential precision issues when doing the difference,
             // we need to do that computation on 128 bit rather than casting
             // to double
             const GDALUInt128 nTmpForStdDev(
-                    GDALUInt128::Mul(nSumSquare,nSampleCount) -
-                    GDALUInt128::Mul(nSum,nSum));
+                    GDALUInt128::Mul(oStats.nSumSquare,nSampleCount) -
+                    GDALUInt128::Mul(oStats.nSum,oStats.nSum));
             const double dfStdDev =
                 nSampleCount > 0 ?
                     sqrt(static_cast<double>(nTmpForStdDev)) / nSampleCount :
                     0.0;
 
+            const double dfMin = oStats.nMin - dfShift;
+            const double dfMax = oStats.nMax - dfShift;
             if( nSampleCount > 0 )
-                SetStatistics( nMin, nMax, dfMean, dfStdDev );
+                SetStatistics( dfMin, dfMax, dfMean, dfStdDev );
 
 /* -------------------------------------------------------------------- */
 /*      Record results.                                                 */
 /* -------------------------------------------------------------------- */
             if( pdfMin != nullptr )
-                *pdfMin = nSampleCount ? nMin : 0;
+                *pdfMin = nSampleCount ? dfMin : 0;
             if( pdfMax != nullptr )
-                *pdfMax = nSampleCount ? nMax : 0;
+                *pdfMax = nSampleCount ? dfMax : 0;
 
             if( pdfMean != nullptr )
                 *pdfMean = dfMean;
@@ -5094,26 +5848,28 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
         }
 #endif
 
-        for( int iSampleBlock = 0;
-             iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
-             iSampleBlock += nSampleRate )
+        const auto ComputeBlockStatistics =
+            [&](const void* pData, int nXCheck, int nYCheck,
+                GDALStatsAccumulator& oBlockAcc)
         {
-            const int iYBlock = iSampleBlock / nBlocksPerRow;
-            const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
-
-            GDALRasterBlock * const poBlock = GetLockedBlockRef( iXBlock, iYBlock );
-            if( poBlock == nullptr )
-                return CE_Failure;
-
-            void* const pData = poBlock->GetDataRef();
-
-            int nXCheck = nBlockXSize;
-            if( (iXBlock+1) * nBlockXSize > GetXSize() )
-                nXCheck = GetXSize() - iXBlock * nBlockXSize;
-
-            int nYCheck = nBlockYSize;
-            if( (iYBlock+1) * nBlockYSize > GetYSize() )
-                nYCheck = GetYSize() - iYBlock * nBlockYSize;
+            if( eDataType == GDT_Float32 && !bGotNoDataValue )
+            {
+                ComputeBlockStatisticsFloat( nXCheck, nBlockXSize, nYCheck,
+                                             static_cast<const float*>(pData),
+                                             bGotFloatNoDataValue,
+                                             fNoDataValue,
+                                             oBlockAcc );
+                return;
+            }
+            if( eDataType == GDT_Float64 )
+            {
+                ComputeBlockStatisticsFloat( nXCheck, nBlockXSize, nYCheck,
+                                             static_cast<const double*>(pData),
+                                             CPL_TO_BOOL(bGotNoDataValue),
+                                             dfNoDataValue,
+                                             oBlockAcc );
+                return;
+            }
 
             // This isn't the fastest way to do this, but is easier for now.
             for( int iY = 0; iY < nYCheck; iY++ )
@@ -5184,26 +5940,58 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
                         ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
                         continue;
 
-                    if( bFirstValue )
-                    {
-                        dfMin = dfValue;
-                        dfMax = dfValue;
-                        bFirstValue = false;
-                    }
-                    else
-                    {
-                        dfMin = std::min(dfMin, dfValue);
-                        dfMax = std::max(dfMax, dfValue);
-                    }
-
-                    nSampleCount++;
-                    const double dfDelta = dfValue - dfMean;
-                    dfMean += dfDelta / nSampleCount;
-                    dfM2 += dfDelta * (dfValue - dfMean);
+                    oBlockAcc.Add(dfValue);
                 }
             }
+        };
 
-            poBlock->DropLock();
+        typedef GDALBlockStatsRunner<GDALStatsAccumulator> StatsRunner;
+        std::unique_ptr<StatsRunner> poRunner;
+        const int nThreads = GDALGetStatisticsThreadCount(
+            DIV_ROUND_UP(nBlocksPerRow * nBlocksPerColumn, nSampleRate));
+        if( nThreads > 1 )
+        {
+            poRunner.reset(new StatsRunner(
+                GDALStatsAccumulator(),
+                ComputeBlockStatistics,
+                [&oAcc](GDALStatsAccumulator& oBlockAcc)
+                {
+                    oAcc.Merge(oBlockAcc);
+                    oBlockAcc = GDALStatsAccumulator();
+                }));
+            if( !poRunner->Setup(nThreads) )
+                poRunner.reset();
+        }
+
+        for( int iSampleBlock = 0;
+             iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
+             iSampleBlock += nSampleRate )
+        {
+            const int iYBlock = iSampleBlock / nBlocksPerRow;
+            const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
+
+            GDALRasterBlock * const poBlock = GetLockedBlockRef( iXBlock, iYBlock );
+            if( poBlock == nullptr )
+                return CE_Failure;
+
+            int nXCheck = nBlockXSize;
+            if( (iXBlock+1) * nBlockXSize > GetXSize() )
+                nXCheck = GetXSize() - iXBlock * nBlockXSize;
+
+            int nYCheck = nBlockYSize;
+            if( (iYBlock+1) * nBlockYSize > GetYSize() )
+                nYCheck = GetYSize() - iYBlock * nBlockYSize;
+
+            if( poRunner )
+            {
+                poRunner->Process(poBlock, nXCheck, nYCheck);
+            }
+            else
+            {
+                ComputeBlockStatistics( poBlock->GetDataRef(),
+                                        nXCheck, nYCheck, oAcc );
+                poBlock->DropLock();
+            }
 
             if ( !pfnProgress(
                      iSampleBlock
@@ -5214,6 +6002,9 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
                 return CE_Failure;
             }
         }
+
+        if( poRunner )
+            poRunner->Finish();
     }
 
     if( !pfnProgress( 1.0, "Compute Statistics", pProgressData ) )
@@ -5225,22 +6016,23 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
 /* -------------------------------------------------------------------- */
 /*      Save computed information.                                      */
 /* -------------------------------------------------------------------- */
+    const GUIntBig nSampleCount = oAcc.nSampleCount;
     const double dfStdDev =
-        nSampleCount > 0 ? sqrt(dfM2 / nSampleCount) : 0.0;
+        nSampleCount > 0 ? sqrt(oAcc.dfM2 / nSampleCount) : 0.0;
 
     if( nSampleCount > 0 )
-        SetStatistics( dfMin, dfMax, dfMean, dfStdDev );
+        SetStatistics( oAcc.dfMin, oAcc.dfMax, oAcc.dfMean, dfStdDev );
 
 /* -------------------------------------------------------------------- */
 /*      Record results.                                                 */
 /* -------------------------------------------------------------------- */
     if( pdfMin != nullptr )
-        *pdfMin = dfMin;
+        *pdfMin = oAcc.dfMin;
     if( pdfMax != nullptr )
-        *pdfMax = dfMax;
+        *pdfMax = oAcc.dfMax;
 
     if( pdfMean != nullptr )
-        *pdfMean = dfMean;
+        *pdfMean = oAcc.dfMean;
 
     if( pdfStdDev != nullptr )
         *pdfStdDev = dfStdDev;
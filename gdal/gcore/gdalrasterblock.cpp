@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <climits>
 #include <cstring>
+#include <utility>
 
 #include "cpl_atomic_ops.h"
 #include "cpl_conv.h"
@@ -48,19 +49,39 @@ CPL_CVSID("$Id$")
 static bool bCacheMaxInitialized = false;
 // Will later be overridden by the default 5% if GDAL_CACHEMAX not defined.
 static GIntBig nCacheMax = 40 * 1024 * 1024;
-static volatile GIntBig nCacheUsed = 0;
-
-static GDALRasterBlock *poOldest = nullptr;  // Tail.
-static GDALRasterBlock *poNewest = nullptr;  // Head.
 
 static int nDisableDirtyBlockFlushCounter = 0;
 
-#if 0
-static CPLMutex *hRBLock = nullptr;
-#define INITIALIZE_LOCK CPLMutexHolderD( &hRBLock )
-#define TAKE_LOCK       CPLMutexHolderOptionalLockD( hRBLock )
-#define DESTROY_LOCK    CPLDestroyMutex( hRBLock )
-#else
+/* -------------------------------------------------------------------- */
+/*      The LRU list and the memory accounting of the block cache are   */
+/*      split into GDAL_RB_SHARD_COUNT shards, each one protected by    */
+/*      its own lock, so that threads working on different bands do not */
+/*      serialize on a single lock. All the blocks of a band belong to  */
+/*      the same shard. GDAL_CACHEMAX applies to the sum of the shards, */
+/*      and each block records the value of a global counter when it is */
+/*      touched so that eviction can start with the shard holding the  */
+/*      least recently used block.                                      */
+/* -------------------------------------------------------------------- */
+
+constexpr int GDAL_RB_MAX_SHARDS = 64;
+
+typedef struct
+{
+    CPLLock         *hLock;
+    GDALRasterBlock *poOldest;  // Tail.
+    GDALRasterBlock *poNewest;  // Head.
+    volatile GIntBig nCacheUsed;
+    volatile int     nOldestStamp;
+    // Only maintained if GDAL_RB_LOCK_DEBUG_CONTENTION=YES.
+    volatile int     nLockWaiters;
+    volatile int     nLockContentions;
+    GIntBig          nLockAcquisitions;
+} GDALRBShard;
+
+static GDALRBShard asShards[GDAL_RB_MAX_SHARDS];
+static int nShardCount = 1;
+static bool bShardCountInitialized = false;
+static volatile int nLRUStampCounter = 0;
 
 static CPLLock* hRBLock = nullptr;
 static bool bDebugContention = false;
@@ -92,12 +113,143 @@ static CPLLockType GetLockType()
     return static_cast<CPLLockType>(nLockType);
 }
 
+// hRBLock only protects the initialization of the shards.
 #define INITIALIZE_LOCK         CPLLockHolderD( &hRBLock, GetLockType() ); \
                                 CPLLockSetDebugPerf(hRBLock, bDebugContention)
-#define TAKE_LOCK               CPLLockHolderOptionalLockD( hRBLock )
 #define DESTROY_LOCK            CPLDestroyLock( hRBLock )
 
-#endif
+/************************************************************************/
+/*                     GDALRBInitializeShards()                         */
+/*                                                                      */
+/*      Must be called with hRBLock held.                               */
+/************************************************************************/
+
+static void GDALRBInitializeShards()
+{
+    // The number of shards cannot change once blocks have been cached.
+    if( !bShardCountInitialized )
+    {
+        nShardCount = std::max(1, std::min(GDAL_RB_MAX_SHARDS,
+            atoi(CPLGetConfigOption("GDAL_RB_SHARD_COUNT", "1"))));
+        if( nShardCount > 1 )
+            CPLDebug("GDAL", "Using %d block cache shards", nShardCount);
+        bShardCountInitialized = true;
+    }
+    for( int i = 0; i < nShardCount; ++i )
+    {
+        if( asShards[i].hLock == nullptr )
+        {
+            asShards[i].hLock = CPLCreateLock(GetLockType());
+            CPLLockSetDebugPerf(asShards[i].hLock, bDebugContention);
+        }
+    }
+}
+
+/************************************************************************/
+/*                         GDALRBShardLock                              */
+/************************************************************************/
+
+class GDALRBShardLock
+{
+    GDALRBShard* m_psShard;
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALRBShardLock)
+
+  public:
+    explicit GDALRBShardLock( GDALRBShard* psShard ) :
+        m_psShard(psShard->hLock ? psShard : nullptr)
+    {
+        if( m_psShard == nullptr )
+            return;
+        if( bDebugContention &&
+            CPLAtomicInc(&(m_psShard->nLockWaiters)) > 1 )
+        {
+            CPLAtomicInc(&(m_psShard->nLockContentions));
+        }
+        CPLAcquireLock(m_psShard->hLock);
+        if( bDebugContention )
+            m_psShard->nLockAcquisitions++;
+    }
+
+    ~GDALRBShardLock()
+    {
+        if( m_psShard == nullptr )
+            return;
+        if( bDebugContention )
+            CPLAtomicDec(&(m_psShard->nLockWaiters));
+        CPLReleaseLock(m_psShard->hLock);
+    }
+};
+
+#define TAKE_SHARD_LOCK(psShard) GDALRBShardLock oShardLock(psShard)
+
+/************************************************************************/
+/*                          GDALRBGetShard()                            */
+/************************************************************************/
+
+static GDALRBShard* GDALRBGetShard( const GDALRasterBand* poBand )
+{
+    if( nShardCount == 1 )
+        return &asShards[0];
+    // Fibonacci hashing of the band address. Low bits are dropped as
+    // they are constant due to allocation alignment.
+    const GUIntBig nHash =
+        (static_cast<GUIntBig>(reinterpret_cast<GUIntptr_t>(poBand)) >> 4) *
+            static_cast<GUIntBig>(0x9E3779B97F4A7C15ULL);
+    return &asShards[static_cast<int>((nHash >> 32) % nShardCount)];
+}
+
+/************************************************************************/
+/*                        GDALRBGetCacheUsed()                          */
+/************************************************************************/
+
+static GIntBig GDALRBGetCacheUsed()
+{
+    GIntBig nUsed = 0;
+    for( int i = 0; i < nShardCount; ++i )
+        nUsed += asShards[i].nCacheUsed;
+    return nUsed;
+}
+
+/************************************************************************/
+/*                      GDALRBGetShardsByAge()                          */
+/*                                                                      */
+/*      Return the non-empty shards, the one with the least recently    */
+/*      used block first. This is done without locking, so the order    */
+/*      is only approximate.                                            */
+/************************************************************************/
+
+static int GDALRBGetShardsByAge( GDALRBShard** papsShards )
+{
+    // The stamps can be modified concurrently, so sort on a snapshot of
+    // them, std::sort() requiring a consistent comparison.
+    std::pair<unsigned, GDALRBShard*> asByAge[GDAL_RB_MAX_SHARDS];
+    const unsigned nNow = static_cast<unsigned>(nLRUStampCounter);
+    int nCount = 0;
+    for( int i = 0; i < nShardCount; ++i )
+    {
+        if( asShards[i].poOldest != nullptr )
+        {
+            // Use ages rather than stamps to cope with wrap-around.
+            asByAge[nCount].first =
+                nNow - static_cast<unsigned>(asShards[i].nOldestStamp);
+            asByAge[nCount].second = &asShards[i];
+            nCount++;
+        }
+    }
+    if( nCount > 1 )
+    {
+        std::sort(asByAge, asByAge + nCount,
+            [](const std::pair<unsigned, GDALRBShard*>& oA,
+               const std::pair<unsigned, GDALRBShard*>& oB)
+            {
+                return oA.first > oB.first;
+            });
+    }
+    for( int i = 0; i < nCount; ++i )
+        papsShards[i] = asByAge[i].second;
+    return nCount;
+}
 
 //#define ENABLE_DEBUG
 
@@ -156,6 +308,7 @@ void CPL_STDCALL GDALSetCacheMax64( GIntBig nNewSizeInBytes )
 
     {
         INITIALIZE_LOCK;
+        GDALRBInitializeShards();
     }
     bCacheMaxInitialized = true;
     nCacheMax = nNewSizeInBytes;
@@ -164,13 +317,13 @@ void CPL_STDCALL GDALSetCacheMax64( GIntBig nNewSizeInBytes )
 /*      Flush blocks till we are under the new limit or till we         */
 /*      can't seem to flush anymore.                                    */
 /* -------------------------------------------------------------------- */
-    while( nCacheUsed > nCacheMax )
+    while( GDALRBGetCacheUsed() > nCacheMax )
     {
-        const GIntBig nOldCacheUsed = nCacheUsed;
+        const GIntBig nOldCacheUsed = GDALRBGetCacheUsed();
 
         GDALFlushCacheBlock();
 
-        if( nCacheUsed == nOldCacheUsed )
+        if( GDALRBGetCacheUsed() == nOldCacheUsed )
             break;
     }
 }
@@ -242,6 +395,7 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
     {
         {
             INITIALIZE_LOCK;
+            GDALRBInitializeShards();
         }
         bSleepsForBockCacheDebug = CPLTestBool(
             CPLGetConfigOption("GDAL_DEBUG_BLOCK_CACHE", "NO"));
@@ -324,6 +478,7 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
 
 int CPL_STDCALL GDALGetCacheUsed()
 {
+    const GIntBig nCacheUsed = GDALRBGetCacheUsed();
     if (nCacheUsed > INT_MAX)
     {
         static bool bHasWarned = false;
@@ -352,7 +507,7 @@ int CPL_STDCALL GDALGetCacheUsed()
  * @since GDAL 1.8.0
  */
 
-GIntBig CPL_STDCALL GDALGetCacheUsed64() { return nCacheUsed; }
+GIntBig CPL_STDCALL GDALGetCacheUsed64() { return GDALRBGetCacheUsed(); }
 
 /************************************************************************/
 /*                        GDALFlushCacheBlock()                         */
@@ -403,6 +558,16 @@ int CPL_STDCALL GDALFlushCacheBlock()
  * Some driver classes are implemented in a fashion that completely avoids
  * use of the GDAL raster cache (and GDALRasterBlock) though this is not very
  * common.
+ *
+ * Starting with GDAL 2.4, the GDAL_RB_SHARD_COUNT configuration option
+ * (default 1, maximum 64) can be set before the first use of the cache to
+ * split the LRU list into several shards, each one with its own lock, so that
+ * multi-threaded access to different bands does not contend on a single
+ * lock. The cache limit still applies to the whole cache, and eviction starts
+ * with the shard that holds the least recently used block. When
+ * GDAL_RB_LOCK_DEBUG_CONTENTION=YES is set, the number of lock acquisitions and
+ * contentions of each shard is reported as a debug message when GDAL is
+ * cleaned up.
  */
 
 /************************************************************************/
@@ -431,11 +596,14 @@ int CPL_STDCALL GDALFlushCacheBlock()
 int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
 
 {
-    GDALRasterBlock *poTarget;
+    GDALRasterBlock *poTarget = nullptr;
 
+    GDALRBShard* apsShards[GDAL_RB_MAX_SHARDS];
+    const int nShards = GDALRBGetShardsByAge(apsShards);
+    for( int iShard = 0; iShard < nShards && poTarget == nullptr; ++iShard )
     {
-        INITIALIZE_LOCK;
-        poTarget = poOldest;
+        TAKE_SHARD_LOCK(apsShards[iShard]);
+        poTarget = apsShards[iShard]->poOldest;
 
         while( poTarget != nullptr )
         {
@@ -450,7 +618,7 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
         }
 
         if( poTarget == nullptr )
-            return FALSE;
+            continue;
         if( bSleepsForBockCacheDebug )
             CPLSleep(CPLAtof(
                 CPLGetConfigOption(
@@ -460,6 +628,9 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
         poTarget->GetBand()->UnreferenceBlock(poTarget);
     }
 
+    if( poTarget == nullptr )
+        return FALSE;
+
     if( bSleepsForBockCacheDebug )
         CPLSleep(CPLAtof(
             CPLGetConfigOption("GDAL_RB_FLUSHBLOCK_SLEEP_AFTER_RB_LOCK", "0")));
@@ -583,7 +754,8 @@ GDALRasterBlock::GDALRasterBlock( GDALRasterBand *poBandIn,
     poBand(poBandIn),
     poNext(nullptr),
     poPrevious(nullptr),
-    bMustDetach(true)
+    bMustDetach(true),
+    nLRUStamp(0)
 {
     CPLAssert( poBandIn != nullptr );
     poBand->GetBlockSize( &nXSize, &nYSize );
@@ -619,7 +791,8 @@ GDALRasterBlock::GDALRasterBlock( int nXOffIn, int nYOffIn ) :
     poBand(nullptr),
     poNext(nullptr),
     poPrevious(nullptr),
-    bMustDetach(false)
+    bMustDetach(false),
+    nLRUStamp(0)
 {}
 
 /************************************************************************/
@@ -645,6 +818,7 @@ void GDALRasterBlock::RecycleFor( int nXOffIn, int nYOffIn )
     nXOff = nXOffIn;
     nYOff = nYOffIn;
     bMustDetach = true;
+    nLRUStamp = 0;
 }
 
 /************************************************************************/
@@ -707,19 +881,25 @@ void GDALRasterBlock::Detach()
 {
     if( bMustDetach )
     {
-        TAKE_LOCK;
+        TAKE_SHARD_LOCK(GDALRBGetShard(poBand));
         Detach_unlocked();
     }
 }
 
 void GDALRasterBlock::Detach_unlocked()
 {
-    if( poOldest == this )
-        poOldest = poPrevious;
+    GDALRBShard* psShard = GDALRBGetShard(poBand);
 
-    if( poNewest == this )
+    if( psShard->poOldest == this )
     {
-        poNewest = poNext;
+        psShard->poOldest = poPrevious;
+        if( poPrevious != nullptr )
+            psShard->nOldestStamp = poPrevious->nLRUStamp;
+    }
+
+    if( psShard->poNewest == this )
+    {
+        psShard->poNewest = poNext;
     }
 
     if( poPrevious != nullptr )
@@ -733,7 +913,7 @@ void GDALRasterBlock::Detach_unlocked()
     bMustDetach = false;
 
     if( pData )
-        nCacheUsed -= GetEffectiveBlockSize(GetBlockSize());
+        psShard->nCacheUsed -= GetEffectiveBlockSize(GetBlockSize());
 
 #ifdef ENABLE_DEBUG
     Verify();
@@ -753,27 +933,33 @@ void GDALRasterBlock::Detach_unlocked()
 void GDALRasterBlock::Verify()
 
 {
-    TAKE_LOCK;
-
-    CPLAssert( (poNewest == nullptr && poOldest == nullptr)
-               || (poNewest != nullptr && poOldest != nullptr) );
-
-    if( poNewest != nullptr )
+    for( int iShard = 0; iShard < nShardCount; ++iShard )
     {
-        CPLAssert( poNewest->poPrevious == nullptr );
-        CPLAssert( poOldest->poNext == nullptr );
+        GDALRBShard* psShard = &asShards[iShard];
+        TAKE_SHARD_LOCK(psShard);
 
-        GDALRasterBlock* poLast = nullptr;
-        for( GDALRasterBlock *poBlock = poNewest;
-             poBlock != nullptr;
-             poBlock = poBlock->poNext )
+        CPLAssert( (psShard->poNewest == nullptr &&
+                    psShard->poOldest == nullptr)
+                   || (psShard->poNewest != nullptr &&
+                       psShard->poOldest != nullptr) );
+
+        if( psShard->poNewest != nullptr )
         {
-            CPLAssert( poBlock->poPrevious == poLast );
+            CPLAssert( psShard->poNewest->poPrevious == nullptr );
+            CPLAssert( psShard->poOldest->poNext == nullptr );
 
-            poLast = poBlock;
-        }
+            GDALRasterBlock* poLast = nullptr;
+            for( GDALRasterBlock *poBlock = psShard->poNewest;
+                 poBlock != nullptr;
+                 poBlock = poBlock->poNext )
+            {
+                CPLAssert( poBlock->poPrevious == poLast );
+
+                poLast = poBlock;
+            }
 
-        CPLAssert( poOldest == poLast );
+            CPLAssert( psShard->poOldest == poLast );
+        }
     }
 }
 
@@ -784,8 +970,9 @@ void GDALRasterBlock::Verify() {}
 #ifdef notdef
 void GDALRasterBlock::CheckNonOrphanedBlocks( GDALRasterBand* poBand )
 {
-    TAKE_LOCK;
-    for( GDALRasterBlock *poBlock = poNewest;
+    GDALRBShard* psShard = GDALRBGetShard(poBand);
+    TAKE_SHARD_LOCK(psShard);
+    for( GDALRasterBlock *poBlock = psShard->poNewest;
                           poBlock != nullptr;
                           poBlock = poBlock->poNext )
     {
@@ -858,11 +1045,13 @@ CPLErr GDALRasterBlock::Write()
 void GDALRasterBlock::Touch()
 
 {
+    GDALRBShard* psShard = GDALRBGetShard(poBand);
+
     // Can be safely tested outside the lock
-    if( poNewest == this )
+    if( psShard->poNewest == this )
         return;
 
-    TAKE_LOCK;
+    TAKE_SHARD_LOCK(psShard);
     Touch_unlocked();
 }
 
@@ -875,15 +1064,22 @@ void GDALRasterBlock::Touch_unlocked()
     // 1. Thread 1 calls Touch() and poNewest != this at that point
     // 2. Thread 2 detaches poNewest
     // 3. Thread 1 arrives here
-    if( poNewest == this )
+    GDALRBShard* psShard = GDALRBGetShard(poBand);
+    if( psShard->poNewest == this )
         return;
 
     // We should not try to touch a block that has been detached.
     // If that happen, corruption has already occurred.
     CPLAssert(bMustDetach);
 
-    if( poOldest == this )
-        poOldest = this->poPrevious;
+    if( nShardCount > 1 )
+        nLRUStamp = CPLAtomicInc(&nLRUStampCounter);
+
+    if( psShard->poOldest == this )
+    {
+        psShard->poOldest = this->poPrevious;
+        psShard->nOldestStamp = psShard->poOldest->nLRUStamp;
+    }
 
     if( poPrevious != nullptr )
         poPrevious->poNext = poNext;
@@ -892,19 +1088,20 @@ void GDALRasterBlock::Touch_unlocked()
         poNext->poPrevious = poPrevious;
 
     poPrevious = nullptr;
-    poNext = poNewest;
+    poNext = psShard->poNewest;
 
-    if( poNewest != nullptr )
+    if( psShard->poNewest != nullptr )
     {
-        CPLAssert( poNewest->poPrevious == nullptr );
-        poNewest->poPrevious = this;
+        CPLAssert( psShard->poNewest->poPrevious == nullptr );
+        psShard->poNewest->poPrevious = this;
     }
-    poNewest = this;
+    psShard->poNewest = this;
 
-    if( poOldest == nullptr )
+    if( psShard->poOldest == nullptr )
     {
         CPLAssert( poPrevious == nullptr && poNext == nullptr );
-        poOldest = this;
+        psShard->poOldest = this;
+        psShard->nOldestStamp = nLRUStamp;
     }
 #ifdef ENABLE_DEBUG
     Verify();
@@ -943,6 +1140,7 @@ CPLErr GDALRasterBlock::Internalize()
 /* -------------------------------------------------------------------- */
 /*      Flush old blocks if we are nearing our memory limit.            */
 /* -------------------------------------------------------------------- */
+    GDALRBShard* const psShard = GDALRBGetShard(poBand);
     bool bFirstIter = true;
     bool bLoopAgain = false;
     do
@@ -950,13 +1148,14 @@ CPLErr GDALRasterBlock::Internalize()
         bLoopAgain = false;
         GDALRasterBlock* apoBlocksToFree[64] = { nullptr };
         int nBlocksToFree = 0;
-        {
-            TAKE_LOCK;
 
-            if( bFirstIter )
-                nCacheUsed += GetEffectiveBlockSize(nSizeInBytes);
-            GDALRasterBlock *poTarget = poOldest;
-            while( nCacheUsed > nCurCacheMax )
+        // Detach unlocked blocks from the tail of the LRU list of a shard,
+        // whose lock must be held, while the cache is over its limit.
+        // Returns true if no other shard should be visited in this iteration.
+        const auto EvictFromShard = [&](GDALRBShard* psVictimShard)
+        {
+            GDALRasterBlock *poTarget = psVictimShard->poOldest;
+            while( GDALRBGetCacheUsed() > nCurCacheMax )
             {
                 while( poTarget != nullptr )
                 {
@@ -970,41 +1169,47 @@ CPLErr GDALRasterBlock::Internalize()
                     poTarget = poTarget->poPrevious;
                 }
 
-                if( poTarget != nullptr )
-                {
-                    if( bSleepsForBockCacheDebug )
-                        CPLSleep(CPLAtof(
-                            CPLGetConfigOption(
-                                "GDAL_RB_INTERNALIZE_SLEEP_AFTER_DROP_LOCK",
-                                "0")));
+                if( poTarget == nullptr )
+                    return false;
 
-                    GDALRasterBlock* _poPrevious = poTarget->poPrevious;
+                if( bSleepsForBockCacheDebug )
+                    CPLSleep(CPLAtof(
+                        CPLGetConfigOption(
+                            "GDAL_RB_INTERNALIZE_SLEEP_AFTER_DROP_LOCK",
+                            "0")));
 
-                    poTarget->Detach_unlocked();
-                    poTarget->GetBand()->UnreferenceBlock(poTarget);
+                GDALRasterBlock* _poPrevious = poTarget->poPrevious;
 
-                    apoBlocksToFree[nBlocksToFree++] = poTarget;
-                    if( poTarget->GetDirty() )
-                    {
-                        // Only free one dirty block at a time so that
-                        // other dirty blocks of other bands with the same
-                        // coordinates can be found with TryGetLockedBlock()
-                        bLoopAgain = nCacheUsed > nCurCacheMax;
-                        break;
-                    }
-                    if( nBlocksToFree == 64 )
-                    {
-                        bLoopAgain = ( nCacheUsed > nCurCacheMax );
-                        break;
-                    }
+                poTarget->Detach_unlocked();
+                poTarget->GetBand()->UnreferenceBlock(poTarget);
 
-                    poTarget = _poPrevious;
+                apoBlocksToFree[nBlocksToFree++] = poTarget;
+                if( poTarget->GetDirty() )
+                {
+                    // Only free one dirty block at a time so that
+                    // other dirty blocks of other bands with the same
+                    // coordinates can be found with TryGetLockedBlock()
+                    bLoopAgain = GDALRBGetCacheUsed() > nCurCacheMax;
+                    return true;
                 }
-                else
+                if( nBlocksToFree == 64 )
                 {
-                    break;
+                    bLoopAgain = GDALRBGetCacheUsed() > nCurCacheMax;
+                    return true;
                 }
+
+                poTarget = _poPrevious;
             }
+            return false;
+        };
+
+        if( nShardCount == 1 )
+        {
+            TAKE_SHARD_LOCK(psShard);
+
+            if( bFirstIter )
+                psShard->nCacheUsed += GetEffectiveBlockSize(nSizeInBytes);
+            EvictFromShard(psShard);
 
         /* ------------------------------------------------------------------ */
         /*      Add this block to the list.                                   */
@@ -1012,6 +1217,33 @@ CPLErr GDALRasterBlock::Internalize()
             if( !bLoopAgain )
                 Touch_unlocked();
         }
+        else
+        {
+            if( bFirstIter )
+            {
+                TAKE_SHARD_LOCK(psShard);
+                psShard->nCacheUsed += GetEffectiveBlockSize(nSizeInBytes);
+            }
+
+            // Visit the shards one at a time, so that a thread never holds
+            // two shard locks.
+            GDALRBShard* apsShards[GDAL_RB_MAX_SHARDS];
+            const int nShards = GDALRBGetShardsByAge(apsShards);
+            for( int iShard = 0;
+                 iShard < nShards && GDALRBGetCacheUsed() > nCurCacheMax;
+                 ++iShard )
+            {
+                TAKE_SHARD_LOCK(apsShards[iShard]);
+                if( EvictFromShard(apsShards[iShard]) )
+                    break;
+            }
+
+            if( !bLoopAgain )
+            {
+                TAKE_SHARD_LOCK(psShard);
+                Touch_unlocked();
+            }
+        }
 
         bFirstIter = false;
 
@@ -1103,6 +1335,22 @@ void GDALRasterBlock::DestroyRBMutex()
     if( hRBLock != nullptr )
         DESTROY_LOCK;
     hRBLock = nullptr;
+
+    for( int i = 0; i < nShardCount; ++i )
+    {
+        if( asShards[i].hLock == nullptr )
+            continue;
+        if( bDebugContention )
+        {
+            CPLDebug("GDAL",
+                     "Block cache shard %d: " CPL_FRMT_GIB " lock "
+                     "acquisitions, %d contentions",
+                     i, asShards[i].nLockAcquisitions,
+                     asShards[i].nLockContentions);
+        }
+        CPLDestroyLock(asShards[i].hLock);
+        asShards[i].hLock = nullptr;
+    }
 }
 /*! @endcond */
 
@@ -1176,7 +1424,7 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 #endif
 
     // Wait for the block for having been unreferenced.
-    TAKE_LOCK;
+    TAKE_SHARD_LOCK(GDALRBGetShard(poBand));
 
     return FALSE;
 }
@@ -1185,14 +1433,17 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 void GDALRasterBlock::DumpAll()
 {
     int iBlock = 0;
-    for( GDALRasterBlock *poBlock = poNewest;
-         poBlock != nullptr;
-         poBlock = poBlock->poNext )
+    for( int iShard = 0; iShard < nShardCount; ++iShard )
     {
-        printf("Block %d\n", iBlock);/*ok*/
-        poBlock->DumpBlock();
-        printf("\n");/*ok*/
-        iBlock++;
+        for( GDALRasterBlock *poBlock = asShards[iShard].poNewest;
+             poBlock != nullptr;
+             poBlock = poBlock->poNext )
+        {
+            printf("Block %d\n", iBlock);/*ok*/
+            poBlock->DumpBlock();
+            printf("\n");/*ok*/
+            iBlock++;
+        }
     }
 }
 
@@ -33,17 +33,27 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 
 #include <algorithm>
+#include <deque>
 #include <limits>
+#include <memory>
+#include <new>
 #include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_multiproc.h"
 #include "cpl_progress.h"
+#include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
+#include "gdal_priv_templates.hpp"
+#include "gdal_thread_pool.h"
 #include "gdalwarper.h"
+#include "memdataset.h"
 
 // Restrict to 64bit processors because they are guaranteed to have SSE2.
 // Could possibly be used too on 32bit, but we would need to check at runtime.
@@ -249,6 +259,225 @@ static bool ReadColorTableAsArray( const GDALColorTable* poColorTable,
     return true;
 }
 
+/************************************************************************/
+/*                         GDALAverageRound()                           */
+/************************************************************************/
+
+// Integer averages are rounded to the nearest value.
+template<class T, class Tsum> static inline T GDALAverageRound( Tsum nTotal,
+                                                                int nCount )
+{
+    return static_cast<T>((nTotal + nCount / 2) / nCount);
+}
+
+template<> inline float GDALAverageRound<float, double>( double dfTotal,
+                                                         int nCount )
+{
+    return static_cast<float>(dfTotal / nCount);
+}
+
+/************************************************************************/
+/*                        GDALAverage2x2SIMD()                          */
+/************************************************************************/
+
+// Returns the number of destination pixels processed, the remaining ones
+// being left to the caller.
+template<class T> static inline int GDALAverage2x2SIMD( const T* /* pSrc0 */,
+                                                        const T* /* pSrc1 */,
+                                                        T* /* pDst */,
+                                                        int /* nDstWidth */ )
+{
+    return 0;
+}
+
+#ifdef USE_SSE2
+
+static inline int GDALAverage2x2SIMD( const GByte* pabySrc0,
+                                      const GByte* pabySrc1,
+                                      GByte* pabyDst, int nDstWidth )
+{
+    const __m128i xmm_mask = _mm_set1_epi16(0xFF);
+    const __m128i xmm_two = _mm_set1_epi16(2);
+    int i = 0;
+    for( ; i + 16 <= nDstWidth; i += 16 )
+    {
+        // 32 source pixels of each line, summed by horizontal pairs into
+        // 16 bit lanes.
+        const __m128i xmm0_lo = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pabySrc0 + 2 * i));
+        const __m128i xmm0_hi = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pabySrc0 + 2 * i + 16));
+        const __m128i xmm1_lo = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pabySrc1 + 2 * i));
+        const __m128i xmm1_hi = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pabySrc1 + 2 * i + 16));
+        __m128i xmm_lo = _mm_add_epi16(
+            _mm_add_epi16(_mm_and_si128(xmm0_lo, xmm_mask),
+                          _mm_srli_epi16(xmm0_lo, 8)),
+            _mm_add_epi16(_mm_and_si128(xmm1_lo, xmm_mask),
+                          _mm_srli_epi16(xmm1_lo, 8)));
+        __m128i xmm_hi = _mm_add_epi16(
+            _mm_add_epi16(_mm_and_si128(xmm0_hi, xmm_mask),
+                          _mm_srli_epi16(xmm0_hi, 8)),
+            _mm_add_epi16(_mm_and_si128(xmm1_hi, xmm_mask),
+                          _mm_srli_epi16(xmm1_hi, 8)));
+        xmm_lo = _mm_srli_epi16(_mm_add_epi16(xmm_lo, xmm_two), 2);
+        xmm_hi = _mm_srli_epi16(_mm_add_epi16(xmm_hi, xmm_two), 2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pabyDst + i),
+                         _mm_packus_epi16(xmm_lo, xmm_hi));
+    }
+    return i;
+}
+
+static inline int GDALAverage2x2SIMD( const GUInt16* pasSrc0,
+                                      const GUInt16* pasSrc1,
+                                      GUInt16* pasDst, int nDstWidth )
+{
+    const __m128i xmm_mask = _mm_set1_epi32(0xFFFF);
+    const __m128i xmm_two = _mm_set1_epi32(2);
+    const __m128i xmm_32768_32 = _mm_set1_epi32(32768);
+    const __m128i xmm_m32768_16 = _mm_set1_epi16(-32768);
+    int i = 0;
+    for( ; i + 8 <= nDstWidth; i += 8 )
+    {
+        // 16 source pixels of each line, summed by horizontal pairs into
+        // 32 bit lanes.
+        const __m128i xmm0_lo = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pasSrc0 + 2 * i));
+        const __m128i xmm0_hi = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pasSrc0 + 2 * i + 8));
+        const __m128i xmm1_lo = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pasSrc1 + 2 * i));
+        const __m128i xmm1_hi = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pasSrc1 + 2 * i + 8));
+        __m128i xmm_lo = _mm_add_epi32(
+            _mm_add_epi32(_mm_and_si128(xmm0_lo, xmm_mask),
+                          _mm_srli_epi32(xmm0_lo, 16)),
+            _mm_add_epi32(_mm_and_si128(xmm1_lo, xmm_mask),
+                          _mm_srli_epi32(xmm1_lo, 16)));
+        __m128i xmm_hi = _mm_add_epi32(
+            _mm_add_epi32(_mm_and_si128(xmm0_hi, xmm_mask),
+                          _mm_srli_epi32(xmm0_hi, 16)),
+            _mm_add_epi32(_mm_and_si128(xmm1_hi, xmm_mask),
+                          _mm_srli_epi32(xmm1_hi, 16)));
+        xmm_lo = _mm_srli_epi32(_mm_add_epi32(xmm_lo, xmm_two), 2);
+        xmm_hi = _mm_srli_epi32(_mm_add_epi32(xmm_hi, xmm_two), 2);
+        // SSE2 has no unsigned 32 -> 16 bit packing, so shift the values
+        // into the signed range, and back.
+        xmm_lo = _mm_sub_epi32(xmm_lo, xmm_32768_32);
+        xmm_hi = _mm_sub_epi32(xmm_hi, xmm_32768_32);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pasDst + i),
+                         _mm_add_epi16(_mm_packs_epi32(xmm_lo, xmm_hi),
+                                       xmm_m32768_16));
+    }
+    return i;
+}
+
+static inline int GDALAverage2x2SIMD( const float* pafSrc0,
+                                      const float* pafSrc1,
+                                      float* pafDst, int nDstWidth )
+{
+    // Sum in double precision, and in the same order as the general case
+    // of GDALResampleChunk32R_AverageT(), so that results are identical.
+    const __m128d xmm_quarter = _mm_set1_pd(0.25);
+    int i = 0;
+    for( ; i + 4 <= nDstWidth; i += 4 )
+    {
+        const __m128 xmm0_lo = _mm_loadu_ps(pafSrc0 + 2 * i);
+        const __m128 xmm0_hi = _mm_loadu_ps(pafSrc0 + 2 * i + 4);
+        const __m128 xmm1_lo = _mm_loadu_ps(pafSrc1 + 2 * i);
+        const __m128 xmm1_hi = _mm_loadu_ps(pafSrc1 + 2 * i + 4);
+        // Even and odd source pixels.
+        const __m128 xmm0_even =
+            _mm_shuffle_ps(xmm0_lo, xmm0_hi, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 xmm0_odd =
+            _mm_shuffle_ps(xmm0_lo, xmm0_hi, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m128 xmm1_even =
+            _mm_shuffle_ps(xmm1_lo, xmm1_hi, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 xmm1_odd =
+            _mm_shuffle_ps(xmm1_lo, xmm1_hi, _MM_SHUFFLE(3, 1, 3, 1));
+
+        __m128d xmm_lo = _mm_add_pd(_mm_cvtps_pd(xmm0_even),
+                                    _mm_cvtps_pd(xmm0_odd));
+        xmm_lo = _mm_add_pd(xmm_lo, _mm_cvtps_pd(xmm1_even));
+        xmm_lo = _mm_add_pd(xmm_lo, _mm_cvtps_pd(xmm1_odd));
+        xmm_lo = _mm_mul_pd(xmm_lo, xmm_quarter);
+
+        __m128d xmm_hi =
+            _mm_add_pd(_mm_cvtps_pd(_mm_movehl_ps(xmm0_even, xmm0_even)),
+                       _mm_cvtps_pd(_mm_movehl_ps(xmm0_odd, xmm0_odd)));
+        xmm_hi = _mm_add_pd(
+            xmm_hi, _mm_cvtps_pd(_mm_movehl_ps(xmm1_even, xmm1_even)));
+        xmm_hi = _mm_add_pd(
+            xmm_hi, _mm_cvtps_pd(_mm_movehl_ps(xmm1_odd, xmm1_odd)));
+        xmm_hi = _mm_mul_pd(xmm_hi, xmm_quarter);
+
+        _mm_storeu_ps(pafDst + i, _mm_movelh_ps(_mm_cvtpd_ps(xmm_lo),
+                                                _mm_cvtpd_ps(xmm_hi)));
+    }
+    return i;
+}
+
+#endif  // USE_SSE2
+
+/************************************************************************/
+/*                          GDALAverage2x2()                            */
+/************************************************************************/
+
+// Average of each 2x2 source window, pSrc0 and pSrc1 being the 2 source
+// lines. No nodata.
+template<class T, class Tsum> static void GDALAverage2x2( const T* pSrc0,
+                                                          const T* pSrc1,
+                                                          T* pDst,
+                                                          int nDstWidth )
+{
+    int i = GDALAverage2x2SIMD(pSrc0, pSrc1, pDst, nDstWidth);
+    for( ; i < nDstWidth; ++i )
+    {
+        Tsum nTotal = pSrc0[2 * i];
+        nTotal += pSrc0[2 * i + 1];
+        nTotal += pSrc1[2 * i];
+        nTotal += pSrc1[2 * i + 1];
+        pDst[i] = GDALAverageRound<T, Tsum>(nTotal, 4);
+    }
+}
+
+/************************************************************************/
+/*                          GDALAverageNxN()                            */
+/************************************************************************/
+
+// Average of each NxN source window, for integer data types, whose sums
+// do not depend on the summation order. The source lines are first summed
+// column-wise into panColSums (of size nDstWidth * N), which the compiler
+// can vectorize, and then by groups of N. No nodata.
+template<class T, class Tsum> static void GDALAverageNxN( const T* pSrc,
+                                                          int nSrcLineStride,
+                                                          int N,
+                                                          T* pDst,
+                                                          int nDstWidth,
+                                                          Tsum* panColSums )
+{
+    const int nSrcWidth = nDstWidth * N;
+    for( int i = 0; i < nSrcWidth; ++i )
+        panColSums[i] = pSrc[i];
+    for( int iY = 1; iY < N; ++iY )
+    {
+        const T* pSrcLine = pSrc + iY * nSrcLineStride;
+        for( int i = 0; i < nSrcWidth; ++i )
+            panColSums[i] += pSrcLine[i];
+    }
+
+    const int nCount = N * N;
+    for( int i = 0; i < nDstWidth; ++i )
+    {
+        const Tsum* panWindow = panColSums + i * N;
+        Tsum nTotal = 0;
+        for( int j = 0; j < N; ++j )
+            nTotal += panWindow[j];
+        pDst[i] = GDALAverageRound<T, Tsum>(nTotal, nCount);
+    }
+}
+
 /************************************************************************/
 /*                    GDALResampleChunk32R_Average()                    */
 /************************************************************************/
@@ -343,7 +572,8 @@ GDALResampleChunk32R_AverageT( double dfXRatioDstToSrc,
 /* ==================================================================== */
 /*      Precompute inner loop constants.                                */
 /* ==================================================================== */
-    bool bSrcXSpacingIsTwo = true;
+    // Width of all source windows, if they are regularly spaced, or 0.
+    int nSrcXSpacing = 0;
     int nLastSrcXOff2 = -1;
     for( int iDstPixel = nDstXOff; iDstPixel < nDstXOff2; ++iDstPixel )
     {
@@ -377,14 +607,37 @@ GDALResampleChunk32R_AverageT( double dfXRatioDstToSrc,
         panSrcXOffShifted[2 * (iDstPixel - nDstXOff)] = nSrcXOff - nChunkXOff;
         panSrcXOffShifted[2 * (iDstPixel - nDstXOff) + 1] =
             nSrcXOff2 - nChunkXOff;
-        if( nSrcXOff2 - nSrcXOff != 2 ||
-            (nLastSrcXOff2 >= 0 && nLastSrcXOff2 != nSrcXOff) )
+        if( iDstPixel == nDstXOff )
+        {
+            nSrcXSpacing = nSrcXOff2 - nSrcXOff;
+        }
+        else if( nSrcXOff2 - nSrcXOff != nSrcXSpacing ||
+                 nLastSrcXOff2 != nSrcXOff )
         {
-            bSrcXSpacingIsTwo = false;
+            nSrcXSpacing = 0;
         }
         nLastSrcXOff2 = nSrcXOff2;
     }
 
+    // Integer data types are averaged by a factor larger than 2 by summing
+    // columns first.
+    const bool bIntegerWrkDataType =
+        eWrkDataType == GDT_Byte || eWrkDataType == GDT_UInt16;
+    Tsum* panColSums = nullptr;
+    if( nSrcXSpacing > 2 && bIntegerWrkDataType &&
+        poColorTable == nullptr && pabyChunkNodataMask == nullptr )
+    {
+        panColSums = static_cast<Tsum *>(
+            VSI_MALLOC3_VERBOSE(nDstXWidth, nSrcXSpacing, sizeof(Tsum)) );
+        if( panColSums == nullptr )
+        {
+            VSIFree(pDstScanline);
+            VSIFree(panSrcXOffShifted);
+            CPLFree(aEntries);
+            return CE_Failure;
+        }
+    }
+
 /* ==================================================================== */
 /*      Loop over destination scanlines.                                */
 /* ==================================================================== */
@@ -424,26 +677,28 @@ GDALResampleChunk32R_AverageT( double dfXRatioDstToSrc,
 /* -------------------------------------------------------------------- */
         if( poColorTable == nullptr )
         {
-            if( bSrcXSpacingIsTwo && nSrcYOff2 == nSrcYOff + 2 &&
-                pabyChunkNodataMask == nullptr &&
-                (eWrkDataType == GDT_Byte || eWrkDataType == GDT_UInt16) )
+            if( nSrcXSpacing == 2 && nSrcYOff2 == nSrcYOff + 2 &&
+                pabyChunkNodataMask == nullptr )
             {
                 // Optimized case : no nodata, overview by a factor of 2 and
                 // regular x and y src spacing.
                 const T* pSrcScanlineShifted =
                     pChunk + panSrcXOffShifted[0] +
                     (nSrcYOff - nChunkYOff) * nChunkXSize;
-                for( int iDstPixel = 0; iDstPixel < nDstXWidth; ++iDstPixel )
-                {
-                    const Tsum nTotal =
-                        pSrcScanlineShifted[0]
-                        + pSrcScanlineShifted[1]
-                        + pSrcScanlineShifted[nChunkXSize]
-                        + pSrcScanlineShifted[1+nChunkXSize];
-
-                    pDstScanline[iDstPixel] = static_cast<T>((nTotal + 2) / 4);
-                    pSrcScanlineShifted += 2;
-                }
+                GDALAverage2x2<T, Tsum>(pSrcScanlineShifted,
+                                        pSrcScanlineShifted + nChunkXSize,
+                                        pDstScanline, nDstXWidth);
+            }
+            else if( panColSums != nullptr &&
+                     nSrcYOff2 == nSrcYOff + nSrcXSpacing )
+            {
+                // Same with a larger integer factor.
+                const T* pSrcScanlineShifted =
+                    pChunk + panSrcXOffShifted[0] +
+                    (nSrcYOff - nChunkYOff) * nChunkXSize;
+                GDALAverageNxN<T, Tsum>(pSrcScanlineShifted, nChunkXSize,
+                                        nSrcXSpacing, pDstScanline,
+                                        nDstXWidth, panColSums);
             }
             else
             {
@@ -546,6 +801,7 @@ GDALResampleChunk32R_AverageT( double dfXRatioDstToSrc,
     CPLFree( pDstScanline );
     CPLFree( aEntries );
     CPLFree( panSrcXOffShifted );
+    CPLFree( panColSums );
 
     return eErr;
 }
@@ -917,6 +1173,158 @@ GDALResampleChunk32R_Gauss( double dfXRatioDstToSrc, double dfYRatioDstToSrc,
     return eErr;
 }
 
+/************************************************************************/
+/*                  GDALResampleChunk32R_ModeByte()                     */
+/************************************************************************/
+
+// Mode of byte data, with a 256-entry histogram that is reused for all
+// destination pixels.
+static CPLErr
+GDALResampleChunk32R_ModeByte( double dfXRatioDstToSrc,
+                               double dfYRatioDstToSrc,
+                               double dfSrcXDelta,
+                               double dfSrcYDelta,
+                               const GByte* pabyChunk,
+                               int nChunkXOff, int nChunkXSize,
+                               int nChunkYOff, int nChunkYSize,
+                               int nDstXOff, int nDstXOff2,
+                               int nDstYOff, int nDstYOff2,
+                               GDALRasterBand * poOverview,
+                               int bHasNoData, float fNoDataValue )
+{
+    const int nDstXWidth = nDstXOff2 - nDstXOff;
+    GByte* pabyDstScanline = static_cast<GByte *>(
+        VSI_MALLOC_VERBOSE(nDstXWidth) );
+    int* panSrcXOffShifted = static_cast<int *>(
+        VSI_MALLOC_VERBOSE(2 * nDstXWidth * sizeof(int)) );
+    if( pabyDstScanline == nullptr || panSrcXOffShifted == nullptr )
+    {
+        VSIFree(pabyDstScanline);
+        VSIFree(panSrcXOffShifted);
+        return CE_Failure;
+    }
+
+    if( !bHasNoData )
+        fNoDataValue = 0.0f;
+    // Value written when all source pixels are nodata.
+    GByte byNoDataValue = 0;
+    GDALCopyWord(fNoDataValue, byNoDataValue);
+    // A nodata value that is not a byte matches no source pixel.
+    const bool bSkipNoData =
+        bHasNoData && fNoDataValue >= 0.0f && fNoDataValue <= 255.0f &&
+        static_cast<float>(static_cast<int>(fNoDataValue)) == fNoDataValue;
+    const int nNoDataValue =
+        bSkipNoData ? static_cast<int>(fNoDataValue) : -1;
+
+    const int nChunkRightXOff = nChunkXOff + nChunkXSize;
+    const int nChunkBottomYOff = nChunkYOff + nChunkYSize;
+
+/* ==================================================================== */
+/*      Precompute inner loop constants.                                */
+/* ==================================================================== */
+    for( int iDstPixel = nDstXOff; iDstPixel < nDstXOff2; ++iDstPixel )
+    {
+        double dfSrcXOff = dfSrcXDelta + iDstPixel * dfXRatioDstToSrc;
+        // Apply some epsilon to avoid numerical precision issues
+        int nSrcXOff = static_cast<int>(dfSrcXOff + 1e-8);
+        if( nSrcXOff < nChunkXOff )
+            nSrcXOff = nChunkXOff;
+
+        double dfSrcXOff2 = dfSrcXDelta + (iDstPixel+1)* dfXRatioDstToSrc;
+        int nSrcXOff2 = static_cast<int>(ceil(dfSrcXOff2 - 1e-8));
+        if( nSrcXOff2 == nSrcXOff )
+            nSrcXOff2 ++;
+        if( nSrcXOff2 > nChunkRightXOff )
+            nSrcXOff2 = nChunkRightXOff;
+
+        panSrcXOffShifted[2 * (iDstPixel - nDstXOff)] = nSrcXOff - nChunkXOff;
+        panSrcXOffShifted[2 * (iDstPixel - nDstXOff) + 1] =
+            nSrcXOff2 - nChunkXOff;
+    }
+
+    int anCounts[256] = {};
+
+/* ==================================================================== */
+/*      Loop over destination scanlines.                                */
+/* ==================================================================== */
+    CPLErr eErr = CE_None;
+    for( int iDstLine = nDstYOff;
+         iDstLine < nDstYOff2 && eErr == CE_None;
+         ++iDstLine )
+    {
+        double dfSrcYOff = dfSrcYDelta + iDstLine * dfYRatioDstToSrc;
+        int nSrcYOff = static_cast<int>(dfSrcYOff + 1e-8);
+        if( nSrcYOff < nChunkYOff )
+            nSrcYOff = nChunkYOff;
+
+        double dfSrcYOff2 = dfSrcYDelta + (iDstLine+1) * dfYRatioDstToSrc;
+        int nSrcYOff2 = static_cast<int>(ceil(dfSrcYOff2 - 1e-8));
+        if( nSrcYOff2 == nSrcYOff )
+            ++nSrcYOff2;
+        if( nSrcYOff2 > nChunkBottomYOff )
+            nSrcYOff2 = nChunkBottomYOff;
+
+        const GByte* const pabySrcScanline =
+            pabyChunk + (nSrcYOff - nChunkYOff) * nChunkXSize;
+        const int nSrcYCount = nSrcYOff2 - nSrcYOff;
+
+/* -------------------------------------------------------------------- */
+/*      Loop over destination pixels                                    */
+/* -------------------------------------------------------------------- */
+        for( int iDstPixel = 0; iDstPixel < nDstXWidth; ++iDstPixel )
+        {
+            const int nSrcXOff = panSrcXOffShifted[2 * iDstPixel];
+            const int nSrcXOff2 = panSrcXOffShifted[2 * iDstPixel + 1];
+
+            // The first value to reach the highest count wins, as in the
+            // generic case.
+            int nMaxCount = 0;
+            int iMaxInd = -1;
+            for( int iY = 0; iY < nSrcYCount; ++iY )
+            {
+                const GByte* pabySrc = pabySrcScanline + iY * nChunkXSize;
+                for( int iX = nSrcXOff; iX < nSrcXOff2; ++iX )
+                {
+                    const int nVal = pabySrc[iX];
+                    if( nVal != nNoDataValue && ++anCounts[nVal] > nMaxCount )
+                    {
+                        iMaxInd = nVal;
+                        nMaxCount = anCounts[nVal];
+                    }
+                }
+            }
+
+            pabyDstScanline[iDstPixel] = (iMaxInd < 0) ?
+                byNoDataValue : static_cast<GByte>(iMaxInd);
+
+            // Reset the histogram, by revisiting the window if it is small.
+            if( nSrcYCount * (nSrcXOff2 - nSrcXOff) < 256 )
+            {
+                for( int iY = 0; iY < nSrcYCount; ++iY )
+                {
+                    const GByte* pabySrc = pabySrcScanline + iY * nChunkXSize;
+                    for( int iX = nSrcXOff; iX < nSrcXOff2; ++iX )
+                        anCounts[pabySrc[iX]] = 0;
+                }
+            }
+            else
+            {
+                memset(anCounts, 0, sizeof(anCounts));
+            }
+        }
+
+        eErr = poOverview->RasterIO(
+            GF_Write, nDstXOff, iDstLine, nDstXWidth, 1,
+            pabyDstScanline, nDstXWidth, 1, GDT_Byte,
+            0, 0, nullptr );
+    }
+
+    CPLFree( pabyDstScanline );
+    CPLFree( panSrcXOffShifted );
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                    GDALResampleChunk32R_Mode()                       */
 /************************************************************************/
@@ -925,7 +1333,7 @@ static CPLErr
 GDALResampleChunk32R_Mode( double dfXRatioDstToSrc, double dfYRatioDstToSrc,
                            double dfSrcXDelta,
                            double dfSrcYDelta,
-                           GDALDataType /* eWrkDataType */,
+                           GDALDataType eWrkDataType,
                            void * pChunk,
                            GByte * pabyChunkNodataMask,
                            int nChunkXOff, int nChunkXSize,
@@ -940,6 +1348,20 @@ GDALResampleChunk32R_Mode( double dfXRatioDstToSrc, double dfYRatioDstToSrc,
                            bool /* bPropagateNoData */ )
 
 {
+    if( eWrkDataType == GDT_Byte )
+    {
+        return GDALResampleChunk32R_ModeByte(
+            dfXRatioDstToSrc, dfYRatioDstToSrc,
+            dfSrcXDelta, dfSrcYDelta,
+            static_cast<const GByte *>( pChunk ),
+            nChunkXOff, nChunkXSize,
+            nChunkYOff, nChunkYSize,
+            nDstXOff, nDstXOff2,
+            nDstYOff, nDstYOff2,
+            poOverview,
+            bHasNoData, fNoDataValue );
+    }
+
     float * pafChunk = static_cast<float*>( pChunk );
 
 /* -------------------------------------------------------------------- */
@@ -2740,6 +3162,7 @@ GDALDataType GDALGetOvrWorkDataType( const char* pszResampling,
 {
     if( (STARTS_WITH_CI(pszResampling, "NEAR") ||
          STARTS_WITH_CI(pszResampling, "AVER") ||
+         STARTS_WITH_CI(pszResampling, "MODE") ||
          EQUAL(pszResampling, "CUBIC") ||
          EQUAL(pszResampling, "CUBICSPLINE") ||
          EQUAL(pszResampling, "LANCZOS") ||
@@ -2762,6 +3185,416 @@ GDALDataType GDALGetOvrWorkDataType( const char* pszResampling,
     return GDT_Float32;
 }
 
+namespace {
+
+/************************************************************************/
+/* ==================================================================== */
+/*                            GDALOvrJob                                */
+/* ==================================================================== */
+/************************************************************************/
+
+// Window of an overview band to compute from the source chunk(s) of a job.
+struct GDALOvrJobOutput
+{
+    int             iBand = 0;  // Index of the source chunk to resample.
+    GDALRasterBand *poDstBand = nullptr;
+    int             nDstWidth = 0;
+    int             nDstHeight = 0;
+    GDALDataType    eDstDataType = GDT_Unknown;
+    CPLString       osNBITS{};
+    double          dfXRatioDstToSrc = 0.0;
+    double          dfYRatioDstToSrc = 0.0;
+    int             nDstXOff = 0;
+    int             nDstXOff2 = 0;
+    int             nDstYOff = 0;
+    int             nDstYOff2 = 0;
+    void           *pDstBuffer = nullptr;
+};
+
+// Source chunk(s) read by the calling thread, and the overview windows
+// that must be computed from them.
+struct GDALOvrJob
+{
+    GDALResampleFunction pfnResampleFn = nullptr;
+    const char          *pszResampling = nullptr;
+    GDALDataType         eWrkDataType = GDT_Unknown;
+    GDALDataType         eSrcDataType = GDT_Unknown;
+    std::vector<void*>   apChunk{};
+    GByte               *pabyChunkNodataMask = nullptr;
+    int                  nChunkXOff = 0;
+    int                  nChunkXSize = 0;
+    int                  nChunkYOff = 0;
+    int                  nChunkYSize = 0;
+    const int           *pabHasNoData = nullptr;
+    const float         *pafNoDataValue = nullptr;
+    GDALColorTable      *poColorTable = nullptr;
+    bool                 bPropagateNoData = false;
+    std::vector<GDALOvrJobOutput> aoOutputs{};
+
+    // Set by the worker thread.
+    CPLErr               eErr = CE_None;
+    bool                 bFinished = false;
+    CPLMutex            *hMutex = nullptr;
+
+    GDALOvrJob() = default;
+    ~GDALOvrJob();
+
+    bool    AllocateChunks( int nBands, int nXSize, int nYSize, bool bMask );
+    void    FreeChunks();
+    void    AddOutput( int iBand, GDALRasterBand* poDstBand,
+                       double dfXRatioDstToSrc, double dfYRatioDstToSrc,
+                       int nDstXOff, int nDstXOff2,
+                       int nDstYOff, int nDstYOff2 );
+    CPLErr  Resample( const GDALOvrJobOutput& oOutput,
+                      GDALRasterBand* poTargetBand ) const;
+    CPLErr  ResampleInBuffer( GDALOvrJobOutput& oOutput ) const;
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALOvrJob)
+};
+
+/************************************************************************/
+/*                            ~GDALOvrJob()                             */
+/************************************************************************/
+
+GDALOvrJob::~GDALOvrJob()
+{
+    FreeChunks();
+    for( size_t i = 0; i < aoOutputs.size(); ++i )
+        VSIFree(aoOutputs[i].pDstBuffer);
+}
+
+/************************************************************************/
+/*                          AllocateChunks()                            */
+/************************************************************************/
+
+bool GDALOvrJob::AllocateChunks( int nBands, int nXSize, int nYSize,
+                                 bool bMask )
+{
+    const int nDTSize = GDALGetDataTypeSizeBytes(eWrkDataType);
+    for( int iBand = 0; iBand < nBands; ++iBand )
+    {
+        void* pChunk = VSI_MALLOC3_VERBOSE(nXSize, nYSize, nDTSize);
+        if( pChunk == nullptr )
+            return false;
+        apChunk.push_back(pChunk);
+    }
+    if( bMask )
+    {
+        pabyChunkNodataMask =
+            static_cast<GByte*>(VSI_MALLOC2_VERBOSE(nXSize, nYSize));
+        if( pabyChunkNodataMask == nullptr )
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                            FreeChunks()                              */
+/************************************************************************/
+
+void GDALOvrJob::FreeChunks()
+{
+    for( size_t i = 0; i < apChunk.size(); ++i )
+        VSIFree(apChunk[i]);
+    apChunk.clear();
+    VSIFree(pabyChunkNodataMask);
+    pabyChunkNodataMask = nullptr;
+}
+
+/************************************************************************/
+/*                             AddOutput()                              */
+/************************************************************************/
+
+void GDALOvrJob::AddOutput( int iBand, GDALRasterBand* poDstBand,
+                            double dfXRatioDstToSrc, double dfYRatioDstToSrc,
+                            int nDstXOff, int nDstXOff2,
+                            int nDstYOff, int nDstYOff2 )
+{
+    GDALOvrJobOutput oOutput;
+    oOutput.iBand = iBand;
+    oOutput.poDstBand = poDstBand;
+    oOutput.nDstWidth = poDstBand->GetXSize();
+    oOutput.nDstHeight = poDstBand->GetYSize();
+    oOutput.eDstDataType = poDstBand->GetRasterDataType();
+    const char* pszNBITS =
+        poDstBand->GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
+    if( pszNBITS )
+        oOutput.osNBITS = pszNBITS;
+    oOutput.dfXRatioDstToSrc = dfXRatioDstToSrc;
+    oOutput.dfYRatioDstToSrc = dfYRatioDstToSrc;
+    oOutput.nDstXOff = nDstXOff;
+    oOutput.nDstXOff2 = nDstXOff2;
+    oOutput.nDstYOff = nDstYOff;
+    oOutput.nDstYOff2 = nDstYOff2;
+    aoOutputs.push_back(oOutput);
+}
+
+/************************************************************************/
+/*                             Resample()                               */
+/************************************************************************/
+
+CPLErr GDALOvrJob::Resample( const GDALOvrJobOutput& oOutput,
+                             GDALRasterBand* poTargetBand ) const
+{
+    return pfnResampleFn(
+        oOutput.dfXRatioDstToSrc, oOutput.dfYRatioDstToSrc,
+        0.0, 0.0,
+        eWrkDataType,
+        apChunk[oOutput.iBand],
+        pabyChunkNodataMask,
+        nChunkXOff, nChunkXSize,
+        nChunkYOff, nChunkYSize,
+        oOutput.nDstXOff, oOutput.nDstXOff2,
+        oOutput.nDstYOff, oOutput.nDstYOff2,
+        poTargetBand,
+        pszResampling,
+        pabHasNoData[oOutput.iBand],
+        pafNoDataValue[oOutput.iBand],
+        poColorTable,
+        eSrcDataType,
+        bPropagateNoData );
+}
+
+/************************************************************************/
+/*                         ResampleInBuffer()                           */
+/************************************************************************/
+
+// Resample into oOutput.pDstBuffer instead of the overview band, so that
+// it can safely be run from a worker thread. The buffer is wrapped into a
+// MEM dataset with the dimensions and data type of the overview band, so
+// that the resampling function sees exactly the same target as in the
+// single-threaded case.
+CPLErr GDALOvrJob::ResampleInBuffer( GDALOvrJobOutput& oOutput ) const
+{
+    const int nDTSize = GDALGetDataTypeSizeBytes(oOutput.eDstDataType);
+    const int nDstXSize = oOutput.nDstXOff2 - oOutput.nDstXOff;
+    const int nDstYSize = oOutput.nDstYOff2 - oOutput.nDstYOff;
+    oOutput.pDstBuffer = VSI_MALLOC3_VERBOSE(nDstXSize, nDstYSize, nDTSize);
+    if( oOutput.pDstBuffer == nullptr )
+        return CE_Failure;
+
+    GDALDataset* poMEMDS = MEMDataset::Create( "", oOutput.nDstWidth,
+                                               oOutput.nDstHeight, 0,
+                                               oOutput.eDstDataType,
+                                               nullptr );
+    if( poMEMDS == nullptr )
+        return CE_Failure;
+
+    const GSpacing nLineSpace = static_cast<GSpacing>(nDTSize) * nDstXSize;
+    char szBuffer[32] = { '\0' };
+    int nRet =
+        CPLPrintPointer(
+            szBuffer, static_cast<GByte*>(oOutput.pDstBuffer)
+            - static_cast<GSpacing>(nDTSize) * oOutput.nDstXOff
+            - nLineSpace * oOutput.nDstYOff, sizeof(szBuffer));
+    szBuffer[nRet] = '\0';
+
+    char szBuffer0[64] = { '\0' };
+    snprintf(szBuffer0, sizeof(szBuffer0), "DATAPOINTER=%s", szBuffer);
+    char szBuffer1[64] = { '\0' };
+    snprintf(szBuffer1, sizeof(szBuffer1), "PIXELOFFSET=%d", nDTSize);
+    char szBuffer2[64] = { '\0' };
+    snprintf( szBuffer2, sizeof(szBuffer2),
+              "LINEOFFSET=" CPL_FRMT_GIB, static_cast<GIntBig>(nLineSpace) );
+    char* apszOptions[4] = { szBuffer0, szBuffer1, szBuffer2, nullptr };
+
+    poMEMDS->AddBand(oOutput.eDstDataType, apszOptions);
+    GDALRasterBand* poMEMBand = poMEMDS->GetRasterBand(1);
+    if( !oOutput.osNBITS.empty() )
+        poMEMBand->SetMetadataItem("NBITS", oOutput.osNBITS,
+                                   "IMAGE_STRUCTURE");
+
+    const CPLErr eRet = Resample(oOutput, poMEMBand);
+
+    GDALClose(poMEMDS);
+    return eRet;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          GDALOvrJobQueue                             */
+/* ==================================================================== */
+/************************************************************************/
+
+// Pipeline of resampling jobs. The calling thread reads source chunks and
+// submits them as jobs, which are resampled by the global worker threads.
+// Completed jobs are written to the overview bands by the calling thread,
+// in submission order, so that dataset I/O never happens concurrently.
+// Without worker thread, jobs are resampled directly into the overview
+// bands at submission time.
+class GDALOvrJobQueue
+{
+    std::unique_ptr<CPLJobQueue> m_poJobQueue{};
+    CPLMutex                *m_hMutex = nullptr;
+    std::deque<GDALOvrJob*>  m_apoJobs{};
+    size_t                   m_nMaxJobs = 1;
+    CPLErr                   m_eErr = CE_None;
+
+    static void ProcessJobFunc( void* pData );
+    CPLErr      WriteOldestJob();
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALOvrJobQueue)
+
+  public:
+    explicit GDALOvrJobQueue( int nThreads );
+    ~GDALOvrJobQueue();
+
+    bool        IsMultiThreaded() const { return m_poJobQueue != nullptr; }
+    CPLErr      Submit( GDALOvrJob* poJob );
+    CPLErr      Flush();
+};
+
+/************************************************************************/
+/*                          GDALOvrJobQueue()                           */
+/************************************************************************/
+
+GDALOvrJobQueue::GDALOvrJobQueue( int nThreads )
+{
+    if( nThreads <= 1 )
+        return;
+
+    m_poJobQueue = GDALCreateGlobalThreadPoolJobQueue(nThreads);
+    if( m_poJobQueue == nullptr )
+        return;
+    CPLDebug("GDAL", "Computing overviews with %d threads", nThreads);
+
+    m_hMutex = CPLCreateMutex();
+    CPLReleaseMutex(m_hMutex);
+
+    // Bound the number of source chunks kept in memory, while leaving
+    // enough jobs in flight for the calling thread to read the next chunks
+    // while the workers resample the previous ones.
+    m_nMaxJobs = 2 * static_cast<size_t>(nThreads);
+}
+
+/************************************************************************/
+/*                         ~GDALOvrJobQueue()                           */
+/************************************************************************/
+
+GDALOvrJobQueue::~GDALOvrJobQueue()
+{
+    m_eErr = CE_Failure;  // Do not write anything at that point.
+    Flush();
+    m_poJobQueue.reset();
+    if( m_hMutex )
+        CPLDestroyMutex(m_hMutex);
+}
+
+/************************************************************************/
+/*                          ProcessJobFunc()                            */
+/************************************************************************/
+
+void GDALOvrJobQueue::ProcessJobFunc( void* pData )
+{
+    GDALOvrJob* poJob = static_cast<GDALOvrJob*>(pData);
+
+    CPLErr eErr = CE_None;
+    for( size_t i = 0; i < poJob->aoOutputs.size() && eErr == CE_None; ++i )
+        eErr = poJob->ResampleInBuffer(poJob->aoOutputs[i]);
+
+    // Release source memory as soon as possible.
+    poJob->FreeChunks();
+
+    CPLAcquireMutex(poJob->hMutex, 1000.0);
+    poJob->eErr = eErr;
+    poJob->bFinished = true;
+    CPLReleaseMutex(poJob->hMutex);
+}
+
+/************************************************************************/
+/*                              Submit()                                */
+/************************************************************************/
+
+// Takes ownership of poJob.
+CPLErr GDALOvrJobQueue::Submit( GDALOvrJob* poJob )
+{
+    if( m_poJobQueue == nullptr )
+    {
+        CPLErr eErr = CE_None;
+        for( size_t i = 0; i < poJob->aoOutputs.size() && eErr == CE_None;
+             ++i )
+        {
+            eErr = poJob->Resample(poJob->aoOutputs[i],
+                                   poJob->aoOutputs[i].poDstBand);
+        }
+        delete poJob;
+        return eErr;
+    }
+
+    while( m_apoJobs.size() >= m_nMaxJobs )
+    {
+        if( WriteOldestJob() != CE_None )
+            break;
+    }
+    if( m_eErr != CE_None )
+    {
+        delete poJob;
+        return m_eErr;
+    }
+
+    poJob->hMutex = m_hMutex;
+    m_apoJobs.push_back(poJob);
+    if( !m_poJobQueue->SubmitJob(ProcessJobFunc, poJob) )
+    {
+        m_apoJobs.pop_back();
+        delete poJob;
+        m_eErr = CE_Failure;
+    }
+    return m_eErr;
+}
+
+/************************************************************************/
+/*                          WriteOldestJob()                            */
+/************************************************************************/
+
+CPLErr GDALOvrJobQueue::WriteOldestJob()
+{
+    GDALOvrJob* poJob = m_apoJobs.front();
+    m_apoJobs.pop_front();
+
+    while( true )
+    {
+        CPLAcquireMutex(m_hMutex, 1000.0);
+        const bool bFinished = poJob->bFinished;
+        CPLReleaseMutex(m_hMutex);
+        if( bFinished )
+            break;
+        m_poJobQueue->WaitEvent();
+    }
+
+    if( m_eErr == CE_None )
+        m_eErr = poJob->eErr;
+
+    for( size_t i = 0; i < poJob->aoOutputs.size() && m_eErr == CE_None; ++i )
+    {
+        const GDALOvrJobOutput& oOutput = poJob->aoOutputs[i];
+        const int nDstXSize = oOutput.nDstXOff2 - oOutput.nDstXOff;
+        const int nDstYSize = oOutput.nDstYOff2 - oOutput.nDstYOff;
+        m_eErr = oOutput.poDstBand->RasterIO(
+            GF_Write, oOutput.nDstXOff, oOutput.nDstYOff,
+            nDstXSize, nDstYSize,
+            oOutput.pDstBuffer, nDstXSize, nDstYSize,
+            oOutput.eDstDataType, 0, 0, nullptr );
+    }
+
+    delete poJob;
+    return m_eErr;
+}
+
+/************************************************************************/
+/*                               Flush()                                */
+/************************************************************************/
+
+// Wait for all submitted jobs and write their results.
+CPLErr GDALOvrJobQueue::Flush()
+{
+    while( !m_apoJobs.empty() )
+        WriteOldestJob();
+    return m_poJobQueue ? m_eErr : CE_None;
+}
+
+} // namespace
+
 /************************************************************************/
 /*                      GDALRegenerateOverviews()                       */
 /************************************************************************/
@@ -2785,6 +3618,11 @@ GDALDataType GDALGetOvrWorkDataType( const char* pszResampling,
  * considered as the nodata value and not each value of the triplet
  * independently per band.
  *
+ * Starting with GDAL 2.4, the GDAL_NUM_THREADS configuration option can be
+ * set to a number of threads or ALL_CPUS to resample the source chunks in
+ * worker threads, while the calling thread reads the next chunks and writes
+ * the computed overview lines.
+ *
  * @param hSrcBand the source (base level) band.
  * @param nOverviewCount the number of downsampled bands being generated.
  * @param pahOvrBands the list of downsampled bands to be generated.
@@ -2946,29 +3784,16 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
     const int nMaxChunkYSizeQueried =
         nFullResYChunk + 2 * nKernelRadius * nMaxOvrFactor;
 
-    GByte *pabyChunkNodataMask = nullptr;
-    void *pChunk =
-        VSI_MALLOC3_VERBOSE(
-            GDALGetDataTypeSizeBytes(eType), nMaxChunkYSizeQueried, nWidth );
-    if( bUseNoDataMask )
-    {
-        pabyChunkNodataMask =
-            static_cast<GByte*>(VSI_MALLOC2_VERBOSE( nMaxChunkYSizeQueried, nWidth ));
-    }
-
-    if( pChunk == nullptr || (bUseNoDataMask && pabyChunkNodataMask == nullptr))
-    {
-        CPLFree(pChunk);
-        CPLFree(pabyChunkNodataMask);
-        return CE_Failure;
-    }
-
     int bHasNoData = FALSE;
     const float fNoDataValue =
         static_cast<float>( poSrcBand->GetNoDataValue(&bHasNoData) );
     const bool bPropagateNoData =
         CPLTestBool( CPLGetConfigOption("GDAL_OVR_PROPAGATE_NODATA", "NO") );
 
+    // Complex data is always resampled in the calling thread.
+    GDALOvrJobQueue oJobQueue( eType == GDT_CFloat32 ?
+                                        1 : GDALGetNumThreads() );
+
 /* -------------------------------------------------------------------- */
 /*      Loop over image operating on chunks.                            */
 /* -------------------------------------------------------------------- */
@@ -3000,6 +3825,31 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
         if( nChunkYOffQueried + nChunkYSizeQueried > nHeight )
             nChunkYSizeQueried = nHeight - nChunkYOffQueried;
 
+        // Each chunk is owned by its job, so that the next one can be read
+        // while it is resampled by a worker thread.
+        GDALOvrJob* poJob = new GDALOvrJob();
+        poJob->pfnResampleFn = pfnResampleFn;
+        poJob->pszResampling = pszResampling;
+        poJob->eWrkDataType = eType;
+        poJob->eSrcDataType = poSrcBand->GetRasterDataType();
+        poJob->nChunkXOff = 0;
+        poJob->nChunkXSize = nWidth;
+        poJob->nChunkYOff = nChunkYOffQueried;
+        poJob->nChunkYSize = nChunkYSizeQueried;
+        poJob->pabHasNoData = &bHasNoData;
+        poJob->pafNoDataValue = &fNoDataValue;
+        poJob->poColorTable = poColorTable;
+        poJob->bPropagateNoData = bPropagateNoData;
+        if( !poJob->AllocateChunks(1, nWidth, nMaxChunkYSizeQueried,
+                                   bUseNoDataMask) )
+        {
+            delete poJob;
+            eErr = CE_Failure;
+            break;
+        }
+        void* pChunk = poJob->apChunk[0];
+        GByte* pabyChunkNodataMask = poJob->pabyChunkNodataMask;
+
         // Read chunk.
         if( eErr == CE_None )
             eErr = poSrcBand->RasterIO(
@@ -3118,20 +3968,13 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
             if( eType == GDT_Byte ||
                 eType == GDT_UInt16 ||
                 eType == GDT_Float32 )
-                eErr = pfnResampleFn(
-                    dfXRatioDstToSrc, dfYRatioDstToSrc,
-                    0.0, 0.0,
-                    eType,
-                    pChunk,
-                    pabyChunkNodataMask,
-                    0, nWidth,
-                    nChunkYOffQueried, nChunkYSizeQueried,
-                    0, nDstWidth,
-                    nDstYOff, nDstYOff2,
-                    papoOvrBands[iOverview], pszResampling,
-                    bHasNoData, fNoDataValue, poColorTable,
-                    poSrcBand->GetRasterDataType(),
-                    bPropagateNoData);
+            {
+                if( nDstYOff2 > nDstYOff )
+                    poJob->AddOutput( 0, papoOvrBands[iOverview],
+                                      dfXRatioDstToSrc, dfYRatioDstToSrc,
+                                      0, nDstWidth,
+                                      nDstYOff, nDstYOff2 );
+            }
             else
                 eErr = GDALResampleChunkC32R(
                     nWidth, nHeight,
@@ -3140,10 +3983,18 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
                     nDstYOff, nDstYOff2,
                     papoOvrBands[iOverview], pszResampling);
         }
+
+        if( eErr == CE_None )
+            eErr = oJobQueue.Submit(poJob);
+        else
+            delete poJob;
     }
 
-    VSIFree( pChunk );
-    VSIFree( pabyChunkNodataMask );
+    {
+        const CPLErr eErrFlush = oJobQueue.Flush();
+        if( eErr == CE_None )
+            eErr = eErrFlush;
+    }
 
 /* -------------------------------------------------------------------- */
 /*      Renormalized overview mean / stddev if needed.                  */
@@ -3205,6 +4056,11 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
  * considered as the nodata value and not each value of the triplet
  * independently per band.
  *
+ * Starting with GDAL 2.4, the GDAL_NUM_THREADS configuration option can be
+ * set to a number of threads or ALL_CPUS to resample the overview blocks in
+ * worker threads, while the calling thread reads the source data of the next
+ * blocks and writes the computed ones.
+ *
  * @param nBands the number of bands, size of papoSrcBands and size of
  *               first dimension of papapoOverviewBands
  * @param papoSrcBands the list of source bands to downsample
@@ -3359,6 +4215,8 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
     const bool bPropagateNoData =
         CPLTestBool( CPLGetConfigOption("GDAL_OVR_PROPAGATE_NODATA", "NO") );
 
+    GDALOvrJobQueue oJobQueue( GDALGetNumThreads() );
+
     // Second pass to do the real job.
     double dfCurPixelCount = 0;
     CPLErr eErr = CE_None;
@@ -3406,49 +4264,6 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
         const int nFullResYChunkQueried =
             nFullResYChunk + 2 * nKernelRadius * nOvrFactor;
 
-        void** papaChunk = static_cast<void **>(
-            VSI_MALLOC_VERBOSE(nBands * sizeof(void*)) );
-        if( papaChunk == nullptr )
-        {
-            CPLFree(pabHasNoData);
-            CPLFree(pafNoDataValue);
-            return CE_Failure;
-        }
-        GByte* pabyChunkNoDataMask = nullptr;
-        for( int iBand = 0; iBand < nBands; ++iBand )
-        {
-            papaChunk[iBand] = VSI_MALLOC3_VERBOSE(
-                nFullResXChunkQueried,
-                nFullResYChunkQueried,
-                GDALGetDataTypeSizeBytes(eWrkDataType) );
-            if( papaChunk[iBand] == nullptr )
-            {
-                while ( --iBand >= 0)
-                    CPLFree(papaChunk[iBand]);
-                CPLFree(papaChunk);
-                CPLFree(pabHasNoData);
-                CPLFree(pafNoDataValue);
-                return CE_Failure;
-            }
-        }
-        if( bUseNoDataMask )
-        {
-            pabyChunkNoDataMask = static_cast<GByte *>(
-                VSI_MALLOC2_VERBOSE( nFullResXChunkQueried,
-                                     nFullResYChunkQueried ) );
-            if( pabyChunkNoDataMask == nullptr )
-            {
-                for( int iBand = 0; iBand < nBands; ++iBand )
-                {
-                    CPLFree(papaChunk[iBand]);
-                }
-                CPLFree(papaChunk);
-                CPLFree(pabHasNoData);
-                CPLFree(pafNoDataValue);
-                return CE_Failure;
-            }
-        }
-
         int nDstYOff = 0;
         // Iterate on destination overview, block by block.
         for( nDstYOff = 0;
@@ -3531,6 +4346,31 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
                     nDstXOff, nDstYOff, nDstXCount, nDstYCount );
 #endif
 
+                // Each source chunk is owned by its job, so that the next
+                // one can be read while it is resampled by a worker thread.
+                GDALOvrJob* poJob = new GDALOvrJob();
+                poJob->pfnResampleFn = pfnResampleFn;
+                poJob->pszResampling = pszResampling;
+                poJob->eWrkDataType = eWrkDataType;
+                poJob->eSrcDataType = eDataType;
+                poJob->nChunkXOff = nChunkXOffQueried;
+                poJob->nChunkXSize = nChunkXSizeQueried;
+                poJob->nChunkYOff = nChunkYOffQueried;
+                poJob->nChunkYSize = nChunkYSizeQueried;
+                poJob->pabHasNoData = pabHasNoData;
+                poJob->pafNoDataValue = pafNoDataValue;
+                poJob->bPropagateNoData = bPropagateNoData;
+                if( !poJob->AllocateChunks(nBands, nFullResXChunkQueried,
+                                           nFullResYChunkQueried,
+                                           bUseNoDataMask) )
+                {
+                    delete poJob;
+                    eErr = CE_Failure;
+                    break;
+                }
+                void** papaChunk = &poJob->apChunk[0];
+                GByte* pabyChunkNoDataMask = poJob->pabyChunkNodataMask;
+
                 // Read the source buffers for all the bands.
                 for( int iBand = 0; iBand < nBands && eErr == CE_None; ++iBand )
                 {
@@ -3565,39 +4405,40 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
                 }
 
                 // Compute the resulting overview block.
-                for( int iBand = 0; iBand < nBands && eErr == CE_None; ++iBand )
+                if( eErr == CE_None )
                 {
-                    eErr = pfnResampleFn(
-                        dfXRatioDstToSrc, dfYRatioDstToSrc,
-                        0.0, 0.0,
-                        eWrkDataType,
-                        papaChunk[iBand],
-                        pabyChunkNoDataMask,
-                        nChunkXOffQueried, nChunkXSizeQueried,
-                        nChunkYOffQueried, nChunkYSizeQueried,
-                        nDstXOff, nDstXOff + nDstXCount,
-                        nDstYOff, nDstYOff + nDstYCount,
-                        papapoOverviewBands[iBand][iOverview],
-                        pszResampling,
-                        pabHasNoData[iBand],
-                        pafNoDataValue[iBand],
-                        /*poColorTable*/ nullptr,
-                        eDataType,
-                        bPropagateNoData);
+                    for( int iBand = 0; iBand < nBands; ++iBand )
+                    {
+                        poJob->AddOutput(
+                            iBand, papapoOverviewBands[iBand][iOverview],
+                            dfXRatioDstToSrc, dfYRatioDstToSrc,
+                            nDstXOff, nDstXOff + nDstXCount,
+                            nDstYOff, nDstYOff + nDstYCount );
+                    }
+                    eErr = oJobQueue.Submit(poJob);
+                }
+                else
+                {
+                    delete poJob;
                 }
             }
 
             dfCurPixelCount += static_cast<double>(nYCount) * nSrcWidth;
         }
 
+        // Wait for the pending blocks of this level, as they might be used
+        // as the source of the next one.
+        {
+            const CPLErr eErrFlush = oJobQueue.Flush();
+            if( eErr == CE_None )
+                eErr = eErrFlush;
+        }
+
         // Flush the data to overviews.
         for( int iBand = 0; iBand < nBands; ++iBand )
         {
-            CPLFree(papaChunk[iBand]);
             papapoOverviewBands[iBand][iOverview]->FlushCache();
         }
-        CPLFree(papaChunk);
-        CPLFree(pabyChunkNoDataMask);
     }
 
     CPLFree(pabHasNoData);
@@ -3028,6 +3028,16 @@ static inline void GDALFastCopy( T* CPL_RESTRICT pDest,
     }
 }
 
+#if defined(HAVE_AVX2_AT_COMPILE_TIME) && (defined(__x86_64) || defined(_M_X64))
+#define HAVE_AVX2_COPYWORDS
+
+bool GDALCopyWordsPacked_AVX2( const void* CPL_RESTRICT pSrcData,
+                               GDALDataType eSrcType,
+                               void* CPL_RESTRICT pDstData,
+                               GDALDataType eDstType,
+                               int nWordCount );
+#endif
+
 /************************************************************************/
 /*                           GDALCopyWords()                            */
 /************************************************************************/
@@ -3186,6 +3196,20 @@ GDALCopyWords( const void * CPL_RESTRICT pSrcData,
         }
     }
 
+#ifdef HAVE_AVX2_COPYWORDS
+    // Packed buffers of non-complex data types are converted by the AVX2
+    // kernels when the CPU supports them.
+    if( nWordCount >= 32 &&
+        nSrcPixelStride == nSrcDataTypeSize &&
+        nDstPixelStride == GDALGetDataTypeSizeBytes(eDstType) &&
+        CPLHaveRuntimeAVX2() &&
+        GDALCopyWordsPacked_AVX2(pSrcData, eSrcType, pDstData, eDstType,
+                                 nWordCount) )
+    {
+        return;
+    }
+#endif
+
     // Handle the more general case -- deals with conversion of data types
     // directly.
     switch (eSrcType)
@@ -0,0 +1,567 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  AVX2 specializations of GDALCopyWords()
+ * Author:   agent <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+
+CPL_CVSID("$Id$")
+
+#if defined(HAVE_AVX2_AT_COMPILE_TIME) && ( defined(__x86_64) || defined(_M_X64) )
+
+#include <immintrin.h>
+
+#include <climits>
+#include <limits>
+
+#include "gdal.h"
+#include "gdal_priv_templates.hpp"
+
+bool GDALCopyWordsPacked_AVX2( const void* CPL_RESTRICT pSrcData,
+                               GDALDataType eSrcType,
+                               void* CPL_RESTRICT pDstData,
+                               GDALDataType eDstType,
+                               int nWordCount );
+
+// The kernels below must produce exactly the same results as the
+// GDALCopyWord() templates of gdal_priv_templates.hpp, which are used for
+// the remaining words that do not fill a whole vector.
+
+namespace {
+
+/************************************************************************/
+/*                         GDALLoadEpi32AVX2()                          */
+/*                                                                      */
+/*      Load 8 integer words, widened to 32 bit lanes.                  */
+/************************************************************************/
+
+inline __m256i GDALLoadEpi32AVX2( const GByte* p )
+{
+    return _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+inline __m256i GDALLoadEpi32AVX2( const GInt16* p )
+{
+    return _mm256_cvtepi16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+inline __m256i GDALLoadEpi32AVX2( const GUInt16* p )
+{
+    return _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+inline __m256i GDALLoadEpi32AVX2( const GInt32* p )
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// The lanes contain the unsigned bit patterns.
+inline __m256i GDALLoadEpi32AVX2( const GUInt32* p )
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+/************************************************************************/
+/*                         GDALClampEpi32AVX2()                         */
+/************************************************************************/
+
+template<class Tin, class Tout> inline __m256i GDALClampEpi32AVX2( __m256i v )
+{
+    const GIntBig nInMin = std::numeric_limits<Tin>::min();
+    const GIntBig nInMax = std::numeric_limits<Tin>::max();
+    const GIntBig nOutMin = std::numeric_limits<Tout>::min();
+    const GIntBig nOutMax = std::numeric_limits<Tout>::max();
+    if( nInMax > INT_MAX )
+    {
+        // GUInt32 input: an unsigned min brings all lanes in the
+        // [0, INT_MAX] range.
+        return _mm256_min_epu32(v, _mm256_set1_epi32(
+            static_cast<int>(nOutMax < INT_MAX ? nOutMax : INT_MAX)));
+    }
+    if( nOutMax < nInMax )
+        v = _mm256_min_epi32(v, _mm256_set1_epi32(static_cast<int>(nOutMax)));
+    if( nOutMin > nInMin )
+        v = _mm256_max_epi32(v, _mm256_set1_epi32(static_cast<int>(nOutMin)));
+    return v;
+}
+
+/************************************************************************/
+/*                        GDALConv8ToEpi32AVX2()                        */
+/*                                                                      */
+/*      Convert 8 words to 32 bit lanes whose values are in the range   */
+/*      of the output data type.                                        */
+/************************************************************************/
+
+template<class Tin, class Tout>
+inline __m256i GDALConv8ToEpi32AVX2( const Tin* p, const Tout* )
+{
+    return GDALClampEpi32AVX2<Tin, Tout>(GDALLoadEpi32AVX2(p));
+}
+
+// clamp(f + 0.5, 0, fMax), NaN being mapped to 0
+inline __m256i GDALConv8FloatToUnsignedAVX2( const float* p, float fMax )
+{
+    __m256 ymm = _mm256_add_ps(_mm256_loadu_ps(p), _mm256_set1_ps(0.5f));
+    // _mm256_max_ps() returns its second operand if the first one is NaN
+    ymm = _mm256_max_ps(ymm, _mm256_setzero_ps());
+    ymm = _mm256_min_ps(ymm, _mm256_set1_ps(fMax));
+    return _mm256_cvttps_epi32(ymm);
+}
+
+inline __m256i GDALConv8ToEpi32AVX2( const float* p, const GByte* )
+{
+    return GDALConv8FloatToUnsignedAVX2(p, 255.0f);
+}
+
+inline __m256i GDALConv8ToEpi32AVX2( const float* p, const GUInt16* )
+{
+    return GDALConv8FloatToUnsignedAVX2(p, 65535.0f);
+}
+
+inline __m256i GDALConv8ToEpi32AVX2( const float* p, const GInt16* )
+{
+    __m256 ymm = _mm256_loadu_ps(p);
+    // NaN -> 0
+    ymm = _mm256_and_ps(ymm, _mm256_cmp_ps(ymm, ymm, _CMP_ORD_Q));
+    // f >= 0 ? f + 0.5f : f - 0.5f
+    const __m256 mask = _mm256_cmp_ps(ymm, _mm256_setzero_ps(), _CMP_GE_OQ);
+    ymm = _mm256_add_ps(ymm, _mm256_blendv_ps(_mm256_set1_ps(-0.5f),
+                                              _mm256_set1_ps(0.5f), mask));
+    ymm = _mm256_max_ps(ymm, _mm256_set1_ps(-32768.0f));
+    ymm = _mm256_min_ps(ymm, _mm256_set1_ps(32767.0f));
+    return _mm256_cvttps_epi32(ymm);
+}
+
+inline __m256i GDALConv8ToEpi32AVX2( const float* p, const GInt32* )
+{
+    const __m256 ymm = _mm256_loadu_ps(p);
+    // f > 0 ? f + 0.5f : f - 0.5f
+    const __m256 mask = _mm256_cmp_ps(ymm, _mm256_setzero_ps(), _CMP_GT_OQ);
+    const __m256i ymm_i = _mm256_cvttps_epi32(
+        _mm256_add_ps(ymm, _mm256_blendv_ps(_mm256_set1_ps(-0.5f),
+                                            _mm256_set1_ps(0.5f), mask)));
+    // Too large values are converted to INT_MIN by cvttps, as well as too
+    // small values and NaN, like the scalar conversion.
+    const __m256 mask_max = _mm256_cmp_ps(ymm, _mm256_set1_ps(2147483648.0f),
+                                          _CMP_GE_OQ);
+    return _mm256_blendv_epi8(ymm_i, _mm256_set1_epi32(INT_MAX),
+                              _mm256_castps_si256(mask_max));
+}
+
+// Convert 4 doubles in the [0, UINT_MAX] range to uint32 bit patterns
+inline __m128i GDALConv4PositiveDoubleToUInt32AVX2( __m256d ymm )
+{
+    // Shift to the int32 range, which is exact for the floored value
+    ymm = _mm256_sub_pd(_mm256_floor_pd(ymm), _mm256_set1_pd(2147483648.0));
+    return _mm_xor_si128(_mm256_cvttpd_epi32(ymm),
+                         _mm_set1_epi32(INT_MIN));
+}
+
+inline __m256i GDALConv8ToEpi32AVX2( const float* p, const GUInt32* )
+{
+    // f >= 4294967296 ? UINT_MAX : f <= 0 ? 0 : f + 0.5f, with the addition
+    // done in single precision like the scalar code.
+    const __m256 ymm = _mm256_add_ps(_mm256_loadu_ps(p),
+                                     _mm256_set1_ps(0.5f));
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d ymm_max = _mm256_set1_pd(4294967295.0);
+    __m256d ymm_lo = _mm256_cvtps_pd(_mm256_castps256_ps128(ymm));
+    __m256d ymm_hi = _mm256_cvtps_pd(_mm256_extractf128_ps(ymm, 1));
+    ymm_lo = _mm256_min_pd(_mm256_max_pd(ymm_lo, zero), ymm_max);
+    ymm_hi = _mm256_min_pd(_mm256_max_pd(ymm_hi, zero), ymm_max);
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(GDALConv4PositiveDoubleToUInt32AVX2(ymm_lo)),
+        GDALConv4PositiveDoubleToUInt32AVX2(ymm_hi), 1);
+}
+
+// Shared by double to integer conversions: 8 doubles clamped in the int32
+// range are truncated to 32 bit lanes.
+inline __m256i GDALTrunc8DoubleAVX2( __m256d ymm_lo, __m256d ymm_hi )
+{
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm256_cvttpd_epi32(ymm_lo)),
+        _mm256_cvttpd_epi32(ymm_hi), 1);
+}
+
+// clamp(d + 0.5, 0, dfMax), NaN being mapped to 0
+inline __m256d GDALConv4DoubleToUnsignedAVX2( const double* p, double dfMax )
+{
+    __m256d ymm = _mm256_add_pd(_mm256_loadu_pd(p), _mm256_set1_pd(0.5));
+    ymm = _mm256_max_pd(ymm, _mm256_setzero_pd());
+    return _mm256_min_pd(ymm, _mm256_set1_pd(dfMax));
+}
+
+inline __m256i GDALConv8ToEpi32AVX2( const double* p, const GByte* )
+{
+    return GDALTrunc8DoubleAVX2(GDALConv4DoubleToUnsignedAVX2(p, 255.0),
+                                GDALConv4DoubleToUnsignedAVX2(p + 4, 255.0));
+}
+
+inline __m256i GDALConv8ToEpi32AVX2( const double* p, const GUInt16* )
+{
+    return GDALTrunc8DoubleAVX2(GDALConv4DoubleToUnsignedAVX2(p, 65535.0),
+                                GDALConv4DoubleToUnsignedAVX2(p + 4, 65535.0));
+}
+
+inline __m256i GDALConv8ToEpi32AVX2( const double* p, const GUInt32* )
+{
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(GDALConv4PositiveDoubleToUInt32AVX2(
+            GDALConv4DoubleToUnsignedAVX2(p, 4294967295.0))),
+        GDALConv4PositiveDoubleToUInt32AVX2(
+            GDALConv4DoubleToUnsignedAVX2(p + 4, 4294967295.0)), 1);
+}
+
+// clamp(d >= 0 ? d + 0.5 : d - 0.5, dfMin, dfMax), NaN being mapped to 0.
+// The scalar Int16 conversion tests d > 0, which is equivalent as 0 and -0
+// both end up as 0.
+inline __m256d GDALConv4DoubleToSignedAVX2( const double* p,
+                                            double dfMin, double dfMax )
+{
+    __m256d ymm = _mm256_loadu_pd(p);
+    ymm = _mm256_and_pd(ymm, _mm256_cmp_pd(ymm, ymm, _CMP_ORD_Q));
+    const __m256d mask = _mm256_cmp_pd(ymm, _mm256_setzero_pd(), _CMP_GE_OQ);
+    ymm = _mm256_add_pd(ymm, _mm256_blendv_pd(_mm256_set1_pd(-0.5),
+                                              _mm256_set1_pd(0.5), mask));
+    ymm = _mm256_max_pd(ymm, _mm256_set1_pd(dfMin));
+    return _mm256_min_pd(ymm, _mm256_set1_pd(dfMax));
+}
+
+inline __m256i GDALConv8ToEpi32AVX2( const double* p, const GInt16* )
+{
+    return GDALTrunc8DoubleAVX2(
+        GDALConv4DoubleToSignedAVX2(p, -32768.0, 32767.0),
+        GDALConv4DoubleToSignedAVX2(p + 4, -32768.0, 32767.0));
+}
+
+inline __m256i GDALConv8ToEpi32AVX2( const double* p, const GInt32* )
+{
+    return GDALTrunc8DoubleAVX2(
+        GDALConv4DoubleToSignedAVX2(p, INT_MIN, INT_MAX),
+        GDALConv4DoubleToSignedAVX2(p + 4, INT_MIN, INT_MAX));
+}
+
+/************************************************************************/
+/*                       GDALStore32FromEpi32AVX2()                     */
+/*                                                                      */
+/*      Store 4x8 lanes whose values are in the output type range.      */
+/************************************************************************/
+
+inline void GDALStore32FromEpi32AVX2( GByte* p, __m256i v0, __m256i v1,
+                                      __m256i v2, __m256i v3 )
+{
+    // The packing works within 128 bit lanes, hence the final permutation
+    const __m256i v01 = _mm256_packs_epi32(v0, v1);
+    const __m256i v23 = _mm256_packs_epi32(v2, v3);
+    __m256i v = _mm256_packus_epi16(v01, v23);
+    v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0,4,1,5,2,6,3,7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+inline void GDALStore32FromEpi32AVX2( GInt16* p, __m256i v0, __m256i v1,
+                                      __m256i v2, __m256i v3 )
+{
+    const __m256i v01 = _mm256_permute4x64_epi64(
+        _mm256_packs_epi32(v0, v1), 0 | (2 << 2) | (1 << 4) | (3 << 6));
+    const __m256i v23 = _mm256_permute4x64_epi64(
+        _mm256_packs_epi32(v2, v3), 0 | (2 << 2) | (1 << 4) | (3 << 6));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v01);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 16), v23);
+}
+
+inline void GDALStore32FromEpi32AVX2( GUInt16* p, __m256i v0, __m256i v1,
+                                      __m256i v2, __m256i v3 )
+{
+    const __m256i v01 = _mm256_permute4x64_epi64(
+        _mm256_packus_epi32(v0, v1), 0 | (2 << 2) | (1 << 4) | (3 << 6));
+    const __m256i v23 = _mm256_permute4x64_epi64(
+        _mm256_packus_epi32(v2, v3), 0 | (2 << 2) | (1 << 4) | (3 << 6));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v01);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 16), v23);
+}
+
+template<class T> inline void GDALStore32FromEpi32AVX2Generic(
+    T* p, __m256i v0, __m256i v1, __m256i v2, __m256i v3 )
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 8), v1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 16), v2);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 24), v3);
+}
+
+inline void GDALStore32FromEpi32AVX2( GInt32* p, __m256i v0, __m256i v1,
+                                      __m256i v2, __m256i v3 )
+{
+    GDALStore32FromEpi32AVX2Generic(p, v0, v1, v2, v3);
+}
+
+inline void GDALStore32FromEpi32AVX2( GUInt32* p, __m256i v0, __m256i v1,
+                                      __m256i v2, __m256i v3 )
+{
+    GDALStore32FromEpi32AVX2Generic(p, v0, v1, v2, v3);
+}
+
+/************************************************************************/
+/*                         GDALConv8ToPsAVX2()                          */
+/************************************************************************/
+
+template<class Tin> inline __m256 GDALConv8ToPsAVX2( const Tin* p )
+{
+    return _mm256_cvtepi32_ps(GDALLoadEpi32AVX2(p));
+}
+
+inline __m256 GDALConv8ToPsAVX2( const float* p )
+{
+    return _mm256_loadu_ps(p);
+}
+
+// Converts 4 uint32 to double, exactly.
+inline __m256d GDALConv4UInt32ToPdAVX2( __m128i xmm )
+{
+    xmm = _mm_xor_si128(xmm, _mm_set1_epi32(INT_MIN));
+    return _mm256_add_pd(_mm256_cvtepi32_pd(xmm),
+                         _mm256_set1_pd(2147483648.0));
+}
+
+// Going through double gives the same single rounding as the scalar
+// conversion.
+inline __m256 GDALConv8ToPsAVX2( const GUInt32* p )
+{
+    const __m256i v = GDALLoadEpi32AVX2(p);
+    const __m128 lo =
+        _mm256_cvtpd_ps(GDALConv4UInt32ToPdAVX2(_mm256_castsi256_si128(v)));
+    const __m128 hi =
+        _mm256_cvtpd_ps(GDALConv4UInt32ToPdAVX2(_mm256_extracti128_si256(v, 1)));
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+// Values beyond the float range go to infinity, contrary to the default
+// rounding mode that would map values slightly larger than FLT_MAX to it.
+inline __m128 GDALConv4DoubleToPsAVX2( const double* p )
+{
+    __m256d ymm = _mm256_loadu_pd(p);
+    const __m256d ymm_max = _mm256_set1_pd(std::numeric_limits<float>::max());
+    const __m256d ymm_inf =
+        _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    ymm = _mm256_blendv_pd(ymm, ymm_inf,
+                           _mm256_cmp_pd(ymm, ymm_max, _CMP_GT_OQ));
+    ymm = _mm256_blendv_pd(ymm, _mm256_sub_pd(_mm256_setzero_pd(), ymm_inf),
+        _mm256_cmp_pd(ymm, _mm256_sub_pd(_mm256_setzero_pd(), ymm_max),
+                      _CMP_LT_OQ));
+    return _mm256_cvtpd_ps(ymm);
+}
+
+inline __m256 GDALConv8ToPsAVX2( const double* p )
+{
+    return _mm256_insertf128_ps(
+        _mm256_castps128_ps256(GDALConv4DoubleToPsAVX2(p)),
+        GDALConv4DoubleToPsAVX2(p + 4), 1);
+}
+
+/************************************************************************/
+/*                         GDALConv8ToPdAVX2()                          */
+/************************************************************************/
+
+template<class Tin> inline void GDALConv8ToPdAVX2( const Tin* p,
+                                                   __m256d& lo, __m256d& hi )
+{
+    const __m256i v = GDALLoadEpi32AVX2(p);
+    lo = _mm256_cvtepi32_pd(_mm256_castsi256_si128(v));
+    hi = _mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1));
+}
+
+inline void GDALConv8ToPdAVX2( const GUInt32* p, __m256d& lo, __m256d& hi )
+{
+    const __m256i v = GDALLoadEpi32AVX2(p);
+    lo = GDALConv4UInt32ToPdAVX2(_mm256_castsi256_si128(v));
+    hi = GDALConv4UInt32ToPdAVX2(_mm256_extracti128_si256(v, 1));
+}
+
+inline void GDALConv8ToPdAVX2( const float* p, __m256d& lo, __m256d& hi )
+{
+    const __m256 ymm = _mm256_loadu_ps(p);
+    lo = _mm256_cvtps_pd(_mm256_castps256_ps128(ymm));
+    hi = _mm256_cvtps_pd(_mm256_extractf128_ps(ymm, 1));
+}
+
+inline void GDALConv8ToPdAVX2( const double* p, __m256d& lo, __m256d& hi )
+{
+    lo = _mm256_loadu_pd(p);
+    hi = _mm256_loadu_pd(p + 4);
+}
+
+/************************************************************************/
+/*                            Kernels                                   */
+/************************************************************************/
+
+template<class Tin, class Tout>
+void GDALCopyWordsToIntAVX2( const Tin* CPL_RESTRICT pSrc,
+                             Tout* CPL_RESTRICT pDst,
+                             int nWordCount )
+{
+    int n = 0;
+    for( ; n < nWordCount - 31; n += 32 )
+    {
+        const __m256i v0 = GDALConv8ToEpi32AVX2(pSrc + n, pDst);
+        const __m256i v1 = GDALConv8ToEpi32AVX2(pSrc + n + 8, pDst);
+        const __m256i v2 = GDALConv8ToEpi32AVX2(pSrc + n + 16, pDst);
+        const __m256i v3 = GDALConv8ToEpi32AVX2(pSrc + n + 24, pDst);
+        GDALStore32FromEpi32AVX2(pDst + n, v0, v1, v2, v3);
+    }
+    for( ; n < nWordCount; n++ )
+    {
+        GDALCopyWord(pSrc[n], pDst[n]);
+    }
+}
+
+template<class Tin>
+void GDALCopyWordsToFloatAVX2( const Tin* CPL_RESTRICT pSrc,
+                               float* CPL_RESTRICT pDst,
+                               int nWordCount )
+{
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        _mm256_storeu_ps(pDst + n, GDALConv8ToPsAVX2(pSrc + n));
+    }
+    for( ; n < nWordCount; n++ )
+    {
+        GDALCopyWord(pSrc[n], pDst[n]);
+    }
+}
+
+template<class Tin>
+void GDALCopyWordsToDoubleAVX2( const Tin* CPL_RESTRICT pSrc,
+                                double* CPL_RESTRICT pDst,
+                                int nWordCount )
+{
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        __m256d lo;
+        __m256d hi;
+        GDALConv8ToPdAVX2(pSrc + n, lo, hi);
+        _mm256_storeu_pd(pDst + n, lo);
+        _mm256_storeu_pd(pDst + n + 4, hi);
+    }
+    for( ; n < nWordCount; n++ )
+    {
+        GDALCopyWord(pSrc[n], pDst[n]);
+    }
+}
+
+template<class Tin>
+bool GDALCopyWordsFromAVX2( const Tin* CPL_RESTRICT pSrc,
+                            void* CPL_RESTRICT pDstData,
+                            GDALDataType eDstType,
+                            int nWordCount )
+{
+    switch( eDstType )
+    {
+        case GDT_Byte:
+            GDALCopyWordsToIntAVX2(pSrc, static_cast<GByte*>(pDstData),
+                                   nWordCount);
+            return true;
+        case GDT_UInt16:
+            GDALCopyWordsToIntAVX2(pSrc, static_cast<GUInt16*>(pDstData),
+                                   nWordCount);
+            return true;
+        case GDT_Int16:
+            GDALCopyWordsToIntAVX2(pSrc, static_cast<GInt16*>(pDstData),
+                                   nWordCount);
+            return true;
+        case GDT_UInt32:
+            GDALCopyWordsToIntAVX2(pSrc, static_cast<GUInt32*>(pDstData),
+                                   nWordCount);
+            return true;
+        case GDT_Int32:
+            GDALCopyWordsToIntAVX2(pSrc, static_cast<GInt32*>(pDstData),
+                                   nWordCount);
+            return true;
+        case GDT_Float32:
+            GDALCopyWordsToFloatAVX2(pSrc, static_cast<float*>(pDstData),
+                                     nWordCount);
+            return true;
+        case GDT_Float64:
+            GDALCopyWordsToDoubleAVX2(pSrc, static_cast<double*>(pDstData),
+                                      nWordCount);
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+/************************************************************************/
+/*                      GDALCopyWordsPacked_AVX2()                      */
+/*                                                                      */
+/*      Convert packed (stride == word size) buffers of non-complex     */
+/*      data types. Returns false if the pair of data types is not      */
+/*      handled.                                                        */
+/************************************************************************/
+
+bool GDALCopyWordsPacked_AVX2( const void* CPL_RESTRICT pSrcData,
+                               GDALDataType eSrcType,
+                               void* CPL_RESTRICT pDstData,
+                               GDALDataType eDstType,
+                               int nWordCount )
+{
+    if( eSrcType == eDstType )
+        return false;
+
+    switch( eSrcType )
+    {
+        case GDT_Byte:
+            return GDALCopyWordsFromAVX2(static_cast<const GByte*>(pSrcData),
+                                         pDstData, eDstType, nWordCount);
+        case GDT_UInt16:
+            return GDALCopyWordsFromAVX2(static_cast<const GUInt16*>(pSrcData),
+                                         pDstData, eDstType, nWordCount);
+        case GDT_Int16:
+            return GDALCopyWordsFromAVX2(static_cast<const GInt16*>(pSrcData),
+                                         pDstData, eDstType, nWordCount);
+        case GDT_UInt32:
+            return GDALCopyWordsFromAVX2(static_cast<const GUInt32*>(pSrcData),
+                                         pDstData, eDstType, nWordCount);
+        case GDT_Int32:
+            return GDALCopyWordsFromAVX2(static_cast<const GInt32*>(pSrcData),
+                                         pDstData, eDstType, nWordCount);
+        case GDT_Float32:
+            return GDALCopyWordsFromAVX2(static_cast<const float*>(pSrcData),
+                                         pDstData, eDstType, nWordCount);
+        case GDT_Float64:
+            return GDALCopyWordsFromAVX2(static_cast<const double*>(pSrcData),
+                                         pDstData, eDstType, nWordCount);
+        default:
+            return false;
+    }
+}
+
+#endif // HAVE_AVX2_AT_COMPILE_TIME
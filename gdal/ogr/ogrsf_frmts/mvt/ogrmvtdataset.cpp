@@ -65,6 +65,7 @@ constexpr int knMAX_FILES_PER_DIR = 10000;
 #include "../sqlite/ogr_sqlite.h"
 
 #include "cpl_worker_thread_pool.h"
+#include "gdal_thread_pool.h"
 
 #include <mutex>
 
@@ -3178,7 +3179,7 @@ class OGRMVTWriterDataset final: public GDALDataset
         int                                    m_nMVTVersion = 2;
         int                                    m_nBuffer = 5 * knDEFAULT_EXTENT / 256;
         bool                                   m_bGZip = true;
-        mutable CPLWorkerThreadPool            m_oThreadPool;
+        std::unique_ptr<CPLJobQueue>           m_poJobQueue{};
         bool                                   m_bThreadPoolOK = false;
         mutable GIntBig                        m_nTempTiles = 0;
         CPLString                              m_osName;
@@ -4335,9 +4336,9 @@ OGRErr OGRMVTWriterDataset::PreGenerateForTile(int nZ, int nTileX, int nTileY,
         poTask->nSerial = nSerial;
         poTask->poGeom = poGeom->clone();
         poTask->sEnvelope = sEnvelope;
-        m_oThreadPool.SubmitJob(OGRMVTWriterDataset::WriterTaskFunc, poTask);
+        m_poJobQueue->SubmitJob(OGRMVTWriterDataset::WriterTaskFunc, poTask);
         // Do not queue more than 1000 jobs to avoid memory exhaustion
-        m_oThreadPool.WaitCompletion(1000);
+        m_poJobQueue->WaitCompletion(1000);
 
         return m_bWriteFeatureError ? OGRERR_FAILURE : OGRERR_NONE;
     }
@@ -5162,7 +5163,7 @@ std::string OGRMVTWriterDataset::RecodeTileLowerResolution(
 bool OGRMVTWriterDataset::CreateOutput()
 {
     if( m_bThreadPoolOK )
-        m_oThreadPool.WaitCompletion();
+        m_poJobQueue->WaitCompletion();
 
     std::map<CPLString, MVTLayerProperties> oMapLayerProps;
     std::set<CPLString> oSetLayers;
@@ -6102,8 +6103,8 @@ GDALDataset* OGRMVTWriterDataset::Create( const char * pszFilename,
     }
     if( nThreads > 1 )
     {
-        poDS->m_bThreadPoolOK =
-            poDS->m_oThreadPool.Setup(nThreads, nullptr, nullptr);
+        poDS->m_poJobQueue = GDALCreateGlobalThreadPoolJobQueue(nThreads);
+        poDS->m_bThreadPoolOK = poDS->m_poJobQueue != nullptr;
     }
 
     poDS->SetDescription(pszFilename);
@@ -46,6 +46,7 @@
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "cpl_worker_thread_pool.h"
+#include "gdal_thread_pool.h"
 
 
 #ifdef HAVE_EXPAT
@@ -152,7 +153,7 @@ struct _OSMContext
 
     GByte         *pabyBlobHeader; // MAX_BLOB_HEADER_SIZE+EXTRA_BYTES large
 
-    CPLWorkerThreadPool* poWTP;
+    CPLJobQueue*   poJobQueue;
 
     GByte         *pabyUncompressed;
     unsigned int   nUncompressedAllocated;
@@ -1644,15 +1645,15 @@ static bool RunDecompressionJobs(OSMContext* psCtxt)
     for( int i = 0; i < psCtxt->nJobs; i++ )
     {
         psCtxt->asJobs[i].pabyDstBase = pabyDstBase;
-        if( psCtxt->poWTP )
+        if( psCtxt->poJobQueue )
             ahJobs.push_back(&psCtxt->asJobs[i]);
         else
             DecompressFunction(&psCtxt->asJobs[i]);
     }
-    if( psCtxt->poWTP )
+    if( psCtxt->poJobQueue )
     {
-        psCtxt->poWTP->SubmitJobs(DecompressFunction, ahJobs);
-        psCtxt->poWTP->WaitCompletion();
+        psCtxt->poJobQueue->SubmitJobs(DecompressFunction, ahJobs);
+        psCtxt->poJobQueue->WaitCompletion();
     }
 
     bool bRet = true;
@@ -1833,7 +1834,7 @@ bool ReadBlob( OSMContext* psCtxt, BlobType eType )
                                                     psCtxt->nTotalUncompressedSize;
                     psCtxt->asJobs[psCtxt->nJobs].nDstSize = nUncompressedSize;
                     psCtxt->nJobs ++;
-                    if( psCtxt->poWTP == nullptr || eType != BLOB_OSMDATA )
+                    if( psCtxt->poJobQueue == nullptr || eType != BLOB_OSMDATA )
                     {
                         if( !RunDecompressionJobsAndProcessAll(psCtxt, eType) )
                         {
@@ -1999,7 +2000,7 @@ static OSMRetCode PBF_ProcessBlock(OSMContext* psCtxt)
 
         nBlobCount ++;
 
-        if( eType == BLOB_OSMDATA && psCtxt->poWTP != nullptr )
+        if( eType == BLOB_OSMDATA && psCtxt->poJobQueue != nullptr )
         {
             // Accumulate BLOB_OSMDATA until we reach either the maximum
             // number of jobs or a threshold in bytes
@@ -2759,12 +2760,8 @@ OSMContext* OSM_Open( const char* pszFilename,
         nNumCPUs = std::min(2 * nNumCPUs, atoi(pszNumThreads));
     if( nNumCPUs > 1 )
     {
-        psCtxt->poWTP = new CPLWorkerThreadPool();
-        if( !psCtxt->poWTP->Setup(nNumCPUs , nullptr, nullptr) )
-        {
-            delete psCtxt->poWTP;
-            psCtxt->poWTP = nullptr;
-        }
+        psCtxt->poJobQueue =
+            GDALCreateGlobalThreadPoolJobQueue(nNumCPUs).release();
     }
 
     return psCtxt;
@@ -2797,7 +2794,7 @@ void OSM_Close(OSMContext* psCtxt)
     VSIFree(psCtxt->pasTags);
     VSIFree(psCtxt->pasMembers);
     VSIFree(psCtxt->panNodeRefs);
-    delete psCtxt->poWTP;
+    delete psCtxt->poJobQueue;
 
     VSIFCloseL(psCtxt->fp);
     VSIFree(psCtxt);
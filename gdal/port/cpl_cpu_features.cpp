@@ -40,6 +40,8 @@ CPL_CVSID("$Id$")
 
 #define CPUID_SSE_EDX_BIT       25
 
+#define CPUID_AVX2_EBX_BIT      5
+
 #define BIT_XMM_STATE           (1 << 1)
 #define BIT_YMM_STATE           (2 << 1)
 
@@ -65,12 +67,30 @@ CPL_CVSID("$Id$")
        : "0" (level))
 #endif
 
+#if defined(__x86_64)
+#define GCC_CPUIDEX(level, subleaf, a, b, c, d) \
+  __asm__ ("xchgq %%rbx, %q1\n"                 \
+           "cpuid\n"                            \
+           "xchgq %%rbx, %q1"                   \
+       : "=a" (a), "=r" (b), "=c" (c), "=d" (d) \
+       : "0" (level), "2" (subleaf))
+#else
+#define GCC_CPUIDEX(level, subleaf, a, b, c, d) \
+  __asm__ ("xchgl %%ebx, %1\n"                  \
+           "cpuid\n"                            \
+           "xchgl %%ebx, %1"                    \
+       : "=a" (a), "=r" (b), "=c" (c), "=d" (d) \
+       : "0" (level), "2" (subleaf))
+#endif
+
 #define CPL_CPUID(level, array) GCC_CPUID(level, array[0], array[1], array[2], array[3])
+#define CPL_CPUIDEX(level, subleaf, array) GCC_CPUIDEX(level, subleaf, array[0], array[1], array[2], array[3])
 
 #elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
 
 #include <intrin.h>
 #define CPL_CPUID(level, array) __cpuid(array, level)
+#define CPL_CPUIDEX(level, subleaf, array) __cpuidex(array, level, subleaf)
 
 #endif
 
@@ -188,4 +208,75 @@ bool CPLHaveRuntimeAVX()
 
 #endif // defined(HAVE_AVX_AT_COMPILE_TIME) && !defined(CPLHaveRuntimeAVX)
 
+#if defined(HAVE_AVX2_AT_COMPILE_TIME) && !defined(HAVE_INLINE_AVX2)
+
+/************************************************************************/
+/*                       CPLDetectRuntimeAVX2()                         */
+/************************************************************************/
+
+#if (defined(__GNUC__) && (defined(__i386__) ||defined(__x86_64))) || \
+    (defined(_MSC_FULL_VER) && (_MSC_FULL_VER >= 160040219) && (defined(_M_IX86) || defined(_M_X64)))
+
+static bool CPLDetectRuntimeAVX2()
+{
+    int cpuinfo[4] = { 0, 0, 0, 0 };
+    CPL_CPUID(0, cpuinfo);
+    if( cpuinfo[REG_EAX] < 7 )
+    {
+        return false;
+    }
+
+    CPL_CPUID(1, cpuinfo);
+
+    // AVX2 requires the same OS support for the YMM state as AVX.
+    if( (cpuinfo[REG_ECX] & (1 << CPUID_OSXSAVE_ECX_BIT)) == 0 ||
+        (cpuinfo[REG_ECX] & (1 << CPUID_AVX_ECX_BIT)) == 0 )
+    {
+        return false;
+    }
+
+#if defined(__GNUC__)
+    unsigned int nXCRLow;
+    unsigned int nXCRHigh;
+    __asm__ ("xgetbv" : "=a" (nXCRLow), "=d" (nXCRHigh) : "c" (0));
+#else
+    const unsigned __int64 nXCRLow = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
+#endif
+    if( (nXCRLow & ( BIT_XMM_STATE | BIT_YMM_STATE )) !=
+                ( BIT_XMM_STATE | BIT_YMM_STATE ) )
+    {
+        return false;
+    }
+
+    // Check AVX2 feature in the extended features leaf.
+    CPL_CPUIDEX(7, 0, cpuinfo);
+    return (cpuinfo[REG_EBX] & (1 << CPUID_AVX2_EBX_BIT)) != 0;
+}
+
+#else
+
+static bool CPLDetectRuntimeAVX2()
+{
+    return false;
+}
+
+#endif
+
+/************************************************************************/
+/*                         CPLHaveRuntimeAVX2()                         */
+/************************************************************************/
+
+bool CPLHaveRuntimeAVX2()
+{
+#ifdef DEBUG
+    if( !CPLTestBool(CPLGetConfigOption("GDAL_USE_AVX2", "YES")) )
+        return false;
+#endif
+    // CPUID is a serializing instruction, so only issue it once.
+    static const bool bHaveAVX2 = CPLDetectRuntimeAVX2();
+    return bHaveAVX2;
+}
+
+#endif // defined(HAVE_AVX2_AT_COMPILE_TIME) && !defined(HAVE_INLINE_AVX2)
+
 //! @endcond
@@ -68,6 +68,22 @@ bool CPLHaveRuntimeAVX();
 #endif
 #endif
 
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+#if __AVX2__
+#define HAVE_INLINE_AVX2
+static bool inline CPLHaveRuntimeAVX2()
+{
+#ifdef DEBUG
+    if( !CPLTestBool(CPLGetConfigOption("GDAL_USE_AVX2", "YES")) )
+        return false;
+#endif
+    return true;
+}
+#else
+bool CPLHaveRuntimeAVX2();
+#endif
+#endif
+
 //! @endcond
 
 #endif // CPL_CPU_FEATURES_H
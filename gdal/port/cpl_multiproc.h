@@ -206,7 +206,7 @@ class CPL_DLL CPLLockHolder
 #define CTLS_GDALDATASET_REC_PROTECT_MAP 6        /* gdaldataset.cpp */
 #define CTLS_PATHBUF                     7         /* cpl_path.cpp */
 #define CTLS_ABSTRACTARCHIVE_SPLIT       8         /* cpl_vsil_abstract_archive.cpp */
-#define CTLS_UNUSED4                     9
+#define CTLS_WORKERTHREADPOOL            9         /* cpl_worker_thread_pool.cpp */
 #define CTLS_CPLSPRINTF                 10         /* cpl_string.h */
 #define CTLS_RESPONSIBLEPID             11         /* gdaldataset.cpp */
 #define CTLS_VERSIONINFO                12         /* gdal_misc.cpp */
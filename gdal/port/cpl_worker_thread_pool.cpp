@@ -29,9 +29,12 @@
 #include "cpl_port.h"
 #include "cpl_worker_thread_pool.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <new>
 
+#include "cpl_atomic_ops.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_vsi.h"
@@ -39,6 +42,18 @@
 
 CPL_CVSID("$Id$")
 
+// Jobs are queued in per-worker deques. A worker pops the most recently
+// queued job of its own deque, and when it is empty, steals the oldest job
+// of the deque of another worker. Jobs submitted from a worker thread of the
+// pool (nested jobs) are queued in the deque of that worker, and other jobs
+// are distributed in a round-robin way. The pool mutex is thus only taken to
+// put idle workers to sleep and to wake them up, and to signal threads
+// waiting for job completion.
+//
+// A worker thread that waits for the completion of jobs (from within a job)
+// runs the queued jobs instead of sleeping, so that nested jobs cannot
+// dead-lock the pool.
+
 /************************************************************************/
 /*                         CPLWorkerThreadPool()                        */
 /************************************************************************/
@@ -51,8 +66,11 @@ CPL_CVSID("$Id$")
 CPLWorkerThreadPool::CPLWorkerThreadPool() :
     hCond(nullptr),
     eState(CPLWTS_OK),
-    psJobQueue(nullptr),
     nPendingJobs(0),
+    nQueuedJobs(0),
+    nNextWorkerThread(0),
+    nCompletionWaiters(0),
+    nWorkerThreadsInWaitCompletion(0),
     psWaitingWorkerThreadsList(nullptr),
     nWaitingWorkerThreads(0)
 {
@@ -86,6 +104,7 @@ CPLWorkerThreadPool::~CPLWorkerThreadPool()
             CPLJoinThread(aWT[i].hThread);
             CPLDestroyCond(aWT[i].hCond);
             CPLDestroyMutex(aWT[i].hMutex);
+            CPLDestroyMutex(aWT[i].hDequeMutex);
         }
 
         CPLListDestroy(psWaitingWorkerThreadsList);
@@ -95,6 +114,21 @@ CPLWorkerThreadPool::~CPLWorkerThreadPool()
     CPLDestroyMutex(hMutex);
 }
 
+/************************************************************************/
+/*                       GetCurrentWorkerThread()                       */
+/************************************************************************/
+
+// Returns the worker structure of the calling thread if it is one of the
+// worker threads of this pool, or nullptr.
+CPLWorkerThread* CPLWorkerThreadPool::GetCurrentWorkerThread()
+{
+    CPLWorkerThread* psWT =
+        static_cast<CPLWorkerThread*>(CPLGetTLS(CTLS_WORKERTHREADPOOL));
+    if( psWT != nullptr && psWT->poTP == this )
+        return psWT;
+    return nullptr;
+}
+
 /************************************************************************/
 /*                       WorkerThreadFunction()                         */
 /************************************************************************/
@@ -104,6 +138,8 @@ void CPLWorkerThreadPool::WorkerThreadFunction(void* user_data)
     CPLWorkerThread* psWT = static_cast<CPLWorkerThread*>(user_data);
     CPLWorkerThreadPool* poTP = psWT->poTP;
 
+    CPLSetTLS(CTLS_WORKERTHREADPOOL, psWT, FALSE);
+
     if( psWT->pfnInitFunc )
         psWT->pfnInitFunc( psWT->pInitData );
 
@@ -113,55 +149,79 @@ void CPLWorkerThreadPool::WorkerThreadFunction(void* user_data)
         if( psJob == nullptr )
             break;
 
-        if( psJob->pfnFunc )
-        {
-            psJob->pfnFunc(psJob->pData);
-        }
-        CPLFree(psJob);
+        poTP->RunJob(psJob);
 #if DEBUG_VERBOSE
         CPLDebug("JOB", "%p finished a job", psWT);
 #endif
-        poTP->DeclareJobFinished();
     }
+
+    CPLSetTLS(CTLS_WORKERTHREADPOOL, nullptr, FALSE);
 }
 
 /************************************************************************/
-/*                             SubmitJob()                              */
+/*                               RunJob()                               */
 /************************************************************************/
 
-/** Queue a new job.
- *
- * @param pfnFunc Function to run for the job.
- * @param pData User data to pass to the job function.
- * @return true in case of success.
- */
-bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
+void CPLWorkerThreadPool::RunJob( CPLWorkerThreadJob* psJob )
 {
-    CPLAssert( !aWT.empty() );
+    if( psJob->pfnFunc )
+    {
+        psJob->pfnFunc(psJob->pData);
+    }
+    CPLJobQueue* poQueue = psJob->poQueue;
+    CPLFree(psJob);
+    if( poQueue && poQueue->m_nMaxRunningJobs > 0 )
+        poQueue->StartNextJob();
+    DeclareJobFinished(poQueue);
+}
 
-    CPLWorkerThreadJob* psJob = static_cast<CPLWorkerThreadJob *>(
-        VSI_MALLOC_VERBOSE(sizeof(CPLWorkerThreadJob)));
-    if( psJob == nullptr )
-        return false;
-    psJob->pfnFunc = pfnFunc;
-    psJob->pData = pData;
+/************************************************************************/
+/*                              QueueJob()                              */
+/************************************************************************/
+
+// Appends a job to the deque of a worker thread. Does not wake up anybody.
+bool CPLWorkerThreadPool::QueueJob( CPLWorkerThread* psWorkerThread,
+                                    CPLWorkerThreadJob* psJob )
+{
+    // The pending counter must be incremented before the job can be
+    // picked up, and thus finished, by another thread. The one of the job
+    // queue, if any, has already been incremented by CPLJobQueue.
+    CPLAtomicInc(&nPendingJobs);
 
-    CPLList* psItem =
-        static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
-    if( psItem == nullptr )
+    CPLAcquireMutex(psWorkerThread->hDequeMutex, 1000.0);
+    try
     {
-        VSIFree(psJob);
+        psWorkerThread->aoJobs.push_back(psJob);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLReleaseMutex(psWorkerThread->hDequeMutex);
+        CPLError(CE_Failure, CPLE_OutOfMemory, "Out of memory");
+        DeclareJobFinished(nullptr);
         return false;
     }
-    psItem->pData = psJob;
+    CPLReleaseMutex(psWorkerThread->hDequeMutex);
 
-    CPLAcquireMutex(hMutex, 1000.0);
+    CPLAtomicInc(&nQueuedJobs);
+    return true;
+}
 
-    psItem->psNext = psJobQueue;
-    psJobQueue = psItem;
-    nPendingJobs++;
+/************************************************************************/
+/*                        WakeUpWaitingThreads()                        */
+/************************************************************************/
 
-    if( psWaitingWorkerThreadsList )
+// Wakes up to nJobs sleeping worker threads, and the threads waiting in
+// WaitCompletion() that could run jobs.
+void CPLWorkerThreadPool::WakeUpWaitingThreads( int nJobs )
+{
+    // The caller has just incremented nQueuedJobs with a full barrier, and
+    // idle threads increment their waiting counter before checking
+    // nQueuedJobs, so at least one side sees the other.
+    if( nWaitingWorkerThreads == 0 && nCompletionWaiters == 0 )
+        return;
+
+    CPLAcquireMutex(hMutex, 1000.0);
+    while( nJobs > 0 && psWaitingWorkerThreadsList != nullptr )
     {
         CPLWorkerThread* psWorkerThread =
             static_cast<CPLWorkerThread *>(psWaitingWorkerThreadsList->pData);
@@ -172,25 +232,69 @@ bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
         CPLList* psNext = psWaitingWorkerThreadsList->psNext;
         CPLList* psToFree = psWaitingWorkerThreadsList;
         psWaitingWorkerThreadsList = psNext;
-        nWaitingWorkerThreads--;
-
-        // CPLAssert(
-        //   CPLListCount(psWaitingWorkerThreadsList) == nWaitingWorkerThreads);
+        CPLAtomicDec(&nWaitingWorkerThreads);
 
 #if DEBUG_VERBOSE
         CPLDebug("JOB", "Waking up %p", psWorkerThread);
 #endif
         CPLAcquireMutex(psWorkerThread->hMutex, 1000.0);
-        CPLReleaseMutex(hMutex);
         CPLCondSignal(psWorkerThread->hCond);
         CPLReleaseMutex(psWorkerThread->hMutex);
 
         CPLFree(psToFree);
+        nJobs--;
     }
-    else
+    if( nCompletionWaiters > 0 )
+        CPLCondBroadcast(hCond);
+    CPLReleaseMutex(hMutex);
+}
+
+/************************************************************************/
+/*                             SubmitJob()                              */
+/************************************************************************/
+
+/** Queue a new job.
+ *
+ * Starting with GDAL 2.4, this method may be called from a job running in
+ * the pool. The job is then queued in the deque of the calling worker
+ * thread.
+ *
+ * @param pfnFunc Function to run for the job.
+ * @param pData User data to pass to the job function.
+ * @return true in case of success.
+ */
+bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
+{
+    return SubmitJob(nullptr, pfnFunc, pData);
+}
+
+bool CPLWorkerThreadPool::SubmitJob( CPLJobQueue* poQueue,
+                                     CPLThreadFunc pfnFunc, void* pData )
+{
+    CPLAssert( !aWT.empty() );
+
+    CPLWorkerThreadJob* psJob = static_cast<CPLWorkerThreadJob *>(
+        VSI_MALLOC_VERBOSE(sizeof(CPLWorkerThreadJob)));
+    if( psJob == nullptr )
+        return false;
+    psJob->pfnFunc = pfnFunc;
+    psJob->pData = pData;
+    psJob->poQueue = poQueue;
+
+    CPLWorkerThread* psWorkerThread = GetCurrentWorkerThread();
+    if( psWorkerThread == nullptr )
     {
-        CPLReleaseMutex(hMutex);
+        const unsigned nIdx =
+            static_cast<unsigned>(CPLAtomicInc(&nNextWorkerThread));
+        psWorkerThread = &aWT[nIdx % aWT.size()];
     }
+    if( !QueueJob(psWorkerThread, psJob) )
+    {
+        VSIFree(psJob);
+        return false;
+    }
+
+    WakeUpWaitingThreads(1);
 
     return true;
 }
@@ -210,10 +314,9 @@ bool CPLWorkerThreadPool::SubmitJobs(CPLThreadFunc pfnFunc,
 {
     CPLAssert( !aWT.empty() );
 
-    CPLAcquireMutex(hMutex, 1000.0);
-
-    CPLList* psJobQueueInit = psJobQueue;
+    CPLWorkerThread* psCurrentWorkerThread = GetCurrentWorkerThread();
     bool bRet = true;
+    int nQueued = 0;
 
     for(size_t i=0;i<apData.size();i++)
     {
@@ -226,87 +329,30 @@ bool CPLWorkerThreadPool::SubmitJobs(CPLThreadFunc pfnFunc,
         }
         psJob->pfnFunc = pfnFunc;
         psJob->pData = apData[i];
+        psJob->poQueue = nullptr;
 
-        CPLList* psItem =
-            static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
-        if( psItem == nullptr )
+        CPLWorkerThread* psWorkerThread = psCurrentWorkerThread;
+        if( psWorkerThread == nullptr )
+        {
+            const unsigned nIdx =
+                static_cast<unsigned>(CPLAtomicInc(&nNextWorkerThread));
+            psWorkerThread = &aWT[nIdx % aWT.size()];
+        }
+        if( !QueueJob(psWorkerThread, psJob) )
         {
             VSIFree(psJob);
             bRet = false;
             break;
         }
-        psItem->pData = psJob;
-
-        psItem->psNext = psJobQueue;
-        psJobQueue = psItem;
-        nPendingJobs++;
-    }
-
-    if( !bRet )
-    {
-        for( CPLList* psIter = psJobQueue; psIter != psJobQueueInit; )
-        {
-            CPLList* psNext = psIter->psNext;
-            VSIFree(psIter->pData);
-            VSIFree(psIter);
-            nPendingJobs--;
-            psIter = psNext;
-        }
+        nQueued++;
     }
 
-    CPLReleaseMutex(hMutex);
-
-    if( !bRet )
-        return false;
-
-    for(size_t i=0;i<apData.size();i++)
-    {
-        CPLAcquireMutex(hMutex, 1000.0);
+    // Jobs already queued cannot be withdrawn since workers may have
+    // started them: let them run.
+    if( nQueued > 0 )
+        WakeUpWaitingThreads(nQueued);
 
-        if( psWaitingWorkerThreadsList && psJobQueue )
-        {
-            CPLWorkerThread* psWorkerThread;
-
-            psWorkerThread = static_cast<CPLWorkerThread*>(psWaitingWorkerThreadsList->pData);
-
-            CPLAssert( psWorkerThread->bMarkedAsWaiting );
-            psWorkerThread->bMarkedAsWaiting = FALSE;
-
-            CPLList* psNext = psWaitingWorkerThreadsList->psNext;
-            CPLList* psToFree = psWaitingWorkerThreadsList;
-            psWaitingWorkerThreadsList = psNext;
-            nWaitingWorkerThreads--;
-
-            // CPLAssert(
-            //    CPLListCount(psWaitingWorkerThreadsList) ==
-            //    nWaitingWorkerThreads);
-
-#if DEBUG_VERBOSE
-            CPLDebug("JOB", "Waking up %p", psWorkerThread);
-#endif
-            CPLAcquireMutex(psWorkerThread->hMutex, 1000.0);
-
-            // CPLAssert(psWorkerThread->psNextJob == nullptr);
-            // psWorkerThread->psNextJob =
-            //     (CPLWorkerThreadJob*)psJobQueue->pData;
-            // psNext = psJobQueue->psNext;
-            // CPLFree(psJobQueue);
-            // psJobQueue = psNext;
-
-            CPLReleaseMutex(hMutex);
-            CPLCondSignal(psWorkerThread->hCond);
-            CPLReleaseMutex(psWorkerThread->hMutex);
-
-            CPLFree(psToFree);
-        }
-        else
-        {
-            CPLReleaseMutex(hMutex);
-            break;
-        }
-    }
-
-    return true;
+    return bRet;
 }
 
 /************************************************************************/
@@ -314,6 +360,12 @@ bool CPLWorkerThreadPool::SubmitJobs(CPLThreadFunc pfnFunc,
 /************************************************************************/
 
 /** Wait for completion of part or whole jobs.
+ *
+ * Starting with GDAL 2.4, this method may be called from a job running in
+ * the pool: the calling job itself (and the ones of the other worker
+ * threads waiting in this method) is not counted as pending, and the
+ * calling thread runs queued jobs while waiting.
+ * CPLJobQueue should generally be preferred to wait for nested jobs.
  *
  * @param nMaxRemainingJobs Maximum number of pendings jobs that are allowed
  *                          in the queue after this method has completed. Might be
@@ -323,18 +375,82 @@ void CPLWorkerThreadPool::WaitCompletion(int nMaxRemainingJobs)
 {
     if( nMaxRemainingJobs < 0 )
         nMaxRemainingJobs = 0;
-    while( true )
+
+    if( GetCurrentWorkerThread() == nullptr )
     {
+        WaitUntil([this, nMaxRemainingJobs]()
+                  { return nPendingJobs <= nMaxRemainingJobs; });
+        return;
+    }
+
+    CPLAtomicInc(&nWorkerThreadsInWaitCompletion);
+    WaitUntil([this, nMaxRemainingJobs]()
+              { return nPendingJobs - nWorkerThreadsInWaitCompletion <=
+                            nMaxRemainingJobs; });
+    CPLAtomicDec(&nWorkerThreadsInWaitCompletion);
+}
+
+/************************************************************************/
+/*                              WaitUntil()                             */
+/************************************************************************/
+
+// Waits until oIsDone() returns true. oIsDone() must only depend on job
+// completion. When called from a worker thread, queued jobs are run while
+// waiting.
+void CPLWorkerThreadPool::WaitUntil( const std::function<bool()>& oIsDone )
+{
+    CPLWorkerThread* psWorkerThread = GetCurrentWorkerThread();
+
+    while( !oIsDone() )
+    {
+        if( psWorkerThread != nullptr )
+        {
+            CPLWorkerThreadJob* psJob = TryGetJob(psWorkerThread);
+            if( psJob != nullptr )
+            {
+                RunJob(psJob);
+                continue;
+            }
+        }
+
         CPLAcquireMutex(hMutex, 1000.0);
-        int nPendingJobsLocal = nPendingJobs;
-        if( nPendingJobsLocal > nMaxRemainingJobs )
+        CPLAtomicInc(&nCompletionWaiters);
+        if( !oIsDone() &&
+            (psWorkerThread == nullptr || nQueuedJobs == 0) )
+        {
             CPLCondWait(hCond, hMutex);
+        }
+        CPLAtomicDec(&nCompletionWaiters);
         CPLReleaseMutex(hMutex);
-        if( nPendingJobsLocal <= nMaxRemainingJobs )
-            break;
     }
 }
 
+/************************************************************************/
+/*                           CreateJobQueue()                           */
+/************************************************************************/
+
+/** Create a new job queue, that is a group of jobs that can be waited for
+ * independently of the other jobs of the pool.
+ *
+ * Job queues may be created and waited for from a job running in the pool.
+ *
+ * When the pool is shared by several operations, nMaxRunningJobs can be
+ * used to bound the number of worker threads used by the jobs of the queue,
+ * so that they do not starve the other users of the pool. The jobs in
+ * excess are started as the running ones finish.
+ *
+ * @param nMaxRunningJobs Maximum number of jobs of the queue that can run
+ *                        concurrently, or 0 for no limit.
+ * @return a new job queue, that must be destroyed before the pool.
+ * @since GDAL 2.4
+ */
+std::unique_ptr<CPLJobQueue>
+CPLWorkerThreadPool::CreateJobQueue( int nMaxRunningJobs )
+{
+    return std::unique_ptr<CPLJobQueue>(
+        new CPLJobQueue(this, std::max(0, nMaxRunningJobs)));
+}
+
 /************************************************************************/
 /*                                Setup()                               */
 /************************************************************************/
@@ -358,6 +474,8 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
         return false;
 
     bool bRet = true;
+    // Threads keep a pointer to their element, so the vector must not be
+    // reallocated once the first thread is started.
     aWT.resize(nThreads);
     for(int i=0;i<nThreads;i++)
     {
@@ -374,10 +492,21 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
             break;
         }
         CPLReleaseMutex(aWT[i].hMutex);
+        aWT[i].hDequeMutex = CPLCreateMutexEx(CPL_MUTEX_REGULAR);
+        if( aWT[i].hDequeMutex == nullptr )
+        {
+            CPLDestroyMutex(aWT[i].hMutex);
+            nThreads = i;
+            aWT.resize(nThreads);
+            bRet = false;
+            break;
+        }
+        CPLReleaseMutex(aWT[i].hDequeMutex);
         aWT[i].hCond = CPLCreateCond();
         if( aWT[i].hCond == nullptr )
         {
             CPLDestroyMutex(aWT[i].hMutex);
+            CPLDestroyMutex(aWT[i].hDequeMutex);
             nThreads = i;
             aWT.resize(nThreads);
             bRet = false;
@@ -385,12 +514,14 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
         }
 
         aWT[i].bMarkedAsWaiting = FALSE;
-        // aWT[i].psNextJob = nullptr;
 
         aWT[i].hThread =
             CPLCreateJoinableThread(WorkerThreadFunction, &(aWT[i]));
         if( aWT[i].hThread == nullptr )
         {
+            CPLDestroyCond(aWT[i].hCond);
+            CPLDestroyMutex(aWT[i].hMutex);
+            CPLDestroyMutex(aWT[i].hDequeMutex);
             nThreads = i;
             aWT.resize(nThreads);
             bRet = false;
@@ -403,10 +534,13 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
     {
         CPLAcquireMutex(hMutex, 1000.0);
         int nWaitingWorkerThreadsLocal = nWaitingWorkerThreads;
-        if( nWaitingWorkerThreadsLocal < nThreads )
+        if( nWaitingWorkerThreadsLocal < nThreads &&
+            eState != CPLWTS_ERROR )
+        {
             CPLCondWait(hCond, hMutex);
+        }
         CPLReleaseMutex(hMutex);
-        if( nWaitingWorkerThreadsLocal == nThreads )
+        if( nWaitingWorkerThreadsLocal == nThreads || eState == CPLWTS_ERROR )
             break;
     }
 
@@ -420,12 +554,73 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
 /*                          DeclareJobFinished()                        */
 /************************************************************************/
 
-void CPLWorkerThreadPool::DeclareJobFinished()
+void CPLWorkerThreadPool::DeclareJobFinished( CPLJobQueue* poQueue )
 {
-    CPLAcquireMutex(hMutex, 1000.0);
-    nPendingJobs--;
-    CPLCondSignal(hCond);
-    CPLReleaseMutex(hMutex);
+    // The queue must not be accessed after its pending counter has been
+    // decremented, since a waiter may destroy it.
+    if( poQueue )
+    {
+        CPLAtomicInc(&(poQueue->m_nFinishedJobs));
+        CPLAtomicDec(&(poQueue->m_nPendingJobs));
+    }
+    CPLAtomicDec(&nPendingJobs);
+
+    // Waiters increment nCompletionWaiters before checking the pending job
+    // counters, so either they see the above decrement, or we see them.
+    if( nCompletionWaiters > 0 )
+    {
+        CPLAcquireMutex(hMutex, 1000.0);
+        CPLCondBroadcast(hCond);
+        CPLReleaseMutex(hMutex);
+    }
+}
+
+/************************************************************************/
+/*                              TryGetJob()                             */
+/************************************************************************/
+
+// Returns the most recent job of the deque of the worker thread, or
+// the oldest job of the deque of another worker thread, or nullptr if there
+// is no queued job.
+CPLWorkerThreadJob *
+CPLWorkerThreadPool::TryGetJob( CPLWorkerThread* psWorkerThread )
+{
+    if( nQueuedJobs == 0 )
+        return nullptr;
+
+    CPLWorkerThreadJob* psJob = nullptr;
+    CPLAcquireMutex(psWorkerThread->hDequeMutex, 1000.0);
+    if( !psWorkerThread->aoJobs.empty() )
+    {
+        psJob = psWorkerThread->aoJobs.back();
+        psWorkerThread->aoJobs.pop_back();
+    }
+    CPLReleaseMutex(psWorkerThread->hDequeMutex);
+
+    if( psJob == nullptr )
+    {
+        const size_t nWorkers = aWT.size();
+        const size_t nSelf = static_cast<size_t>(psWorkerThread - &aWT[0]);
+        for( size_t i = 1; psJob == nullptr && i < nWorkers; i++ )
+        {
+            CPLWorkerThread* psVictim = &aWT[(nSelf + i) % nWorkers];
+            CPLAcquireMutex(psVictim->hDequeMutex, 1000.0);
+            if( !psVictim->aoJobs.empty() )
+            {
+                psJob = psVictim->aoJobs.front();
+                psVictim->aoJobs.pop_front();
+            }
+            CPLReleaseMutex(psVictim->hDequeMutex);
+        }
+#if DEBUG_VERBOSE
+        if( psJob )
+            CPLDebug("JOB", "%p stole a job", psWorkerThread);
+#endif
+    }
+
+    if( psJob != nullptr )
+        CPLAtomicDec(&nQueuedJobs);
+    return psJob;
 }
 
 /************************************************************************/
@@ -437,44 +632,52 @@ CPLWorkerThreadPool::GetNextJob( CPLWorkerThread* psWorkerThread )
 {
     while(true)
     {
-        CPLAcquireMutex(hMutex, 1000.0);
         if( eState == CPLWTS_STOP )
-        {
-            CPLReleaseMutex(hMutex);
             return nullptr;
-        }
-        CPLList* psTopJobIter = psJobQueue;
-        if( psTopJobIter )
-        {
-            psJobQueue = psTopJobIter->psNext;
 
+        CPLWorkerThreadJob* psJob = TryGetJob(psWorkerThread);
+        if( psJob )
+        {
 #if DEBUG_VERBOSE
             CPLDebug("JOB", "%p got a job", psWorkerThread);
 #endif
-            CPLWorkerThreadJob* psJob =
-                static_cast<CPLWorkerThreadJob*>(psTopJobIter->pData);
-            CPLReleaseMutex(hMutex);
-            CPLFree(psTopJobIter);
             return psJob;
         }
 
+        CPLAcquireMutex(hMutex, 1000.0);
+        if( eState == CPLWTS_STOP )
+        {
+            CPLReleaseMutex(hMutex);
+            return nullptr;
+        }
+
         if( !psWorkerThread->bMarkedAsWaiting )
         {
-            psWorkerThread->bMarkedAsWaiting = TRUE;
-            nWaitingWorkerThreads++;
-            CPLAssert(nWaitingWorkerThreads <= static_cast<int>(aWT.size()));
+            // Must be done before checking nQueuedJobs. See
+            // WakeUpWaitingThreads().
+            CPLAtomicInc(&nWaitingWorkerThreads);
+            if( nQueuedJobs > 0 )
+            {
+                CPLAtomicDec(&nWaitingWorkerThreads);
+                CPLReleaseMutex(hMutex);
+                continue;
+            }
 
             CPLList* psItem =
                 static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
             if( psItem == nullptr )
             {
+                CPLAtomicDec(&nWaitingWorkerThreads);
                 eState = CPLWTS_ERROR;
-                CPLCondSignal(hCond);
+                CPLCondBroadcast(hCond);
 
                 CPLReleaseMutex(hMutex);
                 return nullptr;
             }
 
+            psWorkerThread->bMarkedAsWaiting = TRUE;
+            CPLAssert(nWaitingWorkerThreads <= static_cast<int>(aWT.size()));
+
             psItem->pData = psWorkerThread;
             psItem->psNext = psWaitingWorkerThreadsList;
             psWaitingWorkerThreadsList = psItem;
@@ -484,8 +687,16 @@ CPLWorkerThreadPool::GetNextJob( CPLWorkerThread* psWorkerThread )
                       nWaitingWorkerThreads);
 #endif
         }
+        else if( nQueuedJobs > 0 )
+        {
+            // Spurious wake-up while still registered as waiting: we stay
+            // in the waiting list, which is harmless.
+            CPLReleaseMutex(hMutex);
+            continue;
+        }
 
-        CPLCondSignal(hCond);
+        // For Setup()
+        CPLCondBroadcast(hCond);
 
         CPLAcquireMutex(psWorkerThread->hMutex, 1000.0);
 #if DEBUG_VERBOSE
@@ -495,14 +706,198 @@ CPLWorkerThreadPool::GetNextJob( CPLWorkerThread* psWorkerThread )
 
         CPLCondWait( psWorkerThread->hCond, psWorkerThread->hMutex );
 
-        // TODO(rouault): Explain or delete.
-        // CPLWorkerThreadJob* psJob = psWorkerThread->psNextJob;
-        // psWorkerThread->psNextJob = nullptr;
-
         CPLReleaseMutex(psWorkerThread->hMutex);
+    }
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                             CPLJobQueue                              */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                             CPLJobQueue()                            */
+/************************************************************************/
 
-        // TODO(rouault): Explain or delete.
-        // if( psJob )
-        //    return psJob;
+//! @cond Doxygen_Suppress
+CPLJobQueue::CPLJobQueue( CPLWorkerThreadPool* poPool,
+                          int nMaxRunningJobs ) :
+    m_poPool(poPool),
+    m_nPendingJobs(0),
+    m_nFinishedJobs(0),
+    m_nMaxRunningJobs(nMaxRunningJobs),
+    m_nRunningJobs(0),
+    m_hMutex(nullptr),
+    m_aoBacklog()
+{
+    if( m_nMaxRunningJobs > 0 )
+    {
+        m_hMutex = CPLCreateMutexEx(CPL_MUTEX_REGULAR);
+        CPLReleaseMutex(m_hMutex);
     }
 }
+//! @endcond
+
+/************************************************************************/
+/*                            ~CPLJobQueue()                            */
+/************************************************************************/
+
+/** Destroys a job queue.
+ *
+ * Any still pending job of the queue will be completed before the
+ * destructor returns.
+ */
+CPLJobQueue::~CPLJobQueue()
+{
+    WaitCompletion();
+    if( m_hMutex )
+        CPLDestroyMutex(m_hMutex);
+}
+
+/************************************************************************/
+/*                             SubmitJob()                              */
+/************************************************************************/
+
+/** Queue a new job in the queue.
+ *
+ * May be called from a job running in the pool.
+ *
+ * @param pfnFunc Function to run for the job.
+ * @param pData User data to pass to the job function.
+ * @return true in case of success.
+ */
+bool CPLJobQueue::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
+{
+    CPLAtomicInc(&m_nPendingJobs);
+
+    if( m_nMaxRunningJobs > 0 )
+    {
+        CPLAcquireMutex(m_hMutex, 1000.0);
+        if( m_nRunningJobs >= m_nMaxRunningJobs )
+        {
+            try
+            {
+                m_aoBacklog.push_back(
+                    std::pair<CPLThreadFunc, void*>(pfnFunc, pData));
+            }
+            catch( const std::bad_alloc& )
+            {
+                CPLReleaseMutex(m_hMutex);
+                CPLError(CE_Failure, CPLE_OutOfMemory, "Out of memory");
+                CPLAtomicDec(&m_nPendingJobs);
+                return false;
+            }
+            CPLReleaseMutex(m_hMutex);
+            return true;
+        }
+        m_nRunningJobs++;
+        CPLReleaseMutex(m_hMutex);
+    }
+
+    if( !m_poPool->SubmitJob(this, pfnFunc, pData) )
+    {
+        CPLAtomicDec(&m_nPendingJobs);
+        if( m_nMaxRunningJobs > 0 )
+        {
+            // Other threads may have queued jobs in the backlog meanwhile.
+            StartNextJob();
+        }
+        return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                             SubmitJobs()                             */
+/************************************************************************/
+
+/** Queue several jobs in the queue.
+ *
+ * @param pfnFunc Function to run for the job.
+ * @param apData User data instances to pass to the job function.
+ * @return true in case of success.
+ */
+bool CPLJobQueue::SubmitJobs( CPLThreadFunc pfnFunc,
+                              const std::vector<void*>& apData )
+{
+    for( size_t i = 0; i < apData.size(); i++ )
+    {
+        if( !SubmitJob(pfnFunc, apData[i]) )
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                            StartNextJob()                            */
+/************************************************************************/
+
+// Called when a running job of the queue is finished (or could not be
+// started), when the number of running jobs is limited: submits the next
+// job of the backlog to the pool, if any.
+void CPLJobQueue::StartNextJob()
+{
+    while( true )
+    {
+        CPLAcquireMutex(m_hMutex, 1000.0);
+        if( m_aoBacklog.empty() )
+        {
+            m_nRunningJobs--;
+            CPLReleaseMutex(m_hMutex);
+            return;
+        }
+        const std::pair<CPLThreadFunc, void*> oJob = m_aoBacklog.front();
+        m_aoBacklog.pop_front();
+        CPLReleaseMutex(m_hMutex);
+
+        if( m_poPool->SubmitJob(this, oJob.first, oJob.second) )
+            return;
+
+        // Out of memory: run it in this thread.
+        oJob.first(oJob.second);
+        CPLAtomicInc(&m_nFinishedJobs);
+        CPLAtomicDec(&m_nPendingJobs);
+    }
+}
+
+/************************************************************************/
+/*                            WaitCompletion()                          */
+/************************************************************************/
+
+/** Wait for completion of part or whole jobs of the queue.
+ *
+ * When called from a job running in the pool, the calling thread runs
+ * queued jobs while waiting. A job must not wait for the queue it belongs
+ * to.
+ *
+ * @param nMaxRemainingJobs Maximum number of pendings jobs of the queue that
+ *                          are allowed after this method has completed.
+ *                          Might be 0 to wait for all jobs.
+ */
+void CPLJobQueue::WaitCompletion( int nMaxRemainingJobs )
+{
+    if( nMaxRemainingJobs < 0 )
+        nMaxRemainingJobs = 0;
+    m_poPool->WaitUntil([this, nMaxRemainingJobs]()
+                        { return m_nPendingJobs <= nMaxRemainingJobs; });
+}
+
+/************************************************************************/
+/*                             WaitEvent()                              */
+/************************************************************************/
+
+/** Wait for the completion of at least one job of the queue, if there are
+ * any remaining.
+ *
+ * This can be used to wait for a given job, by checking a flag set by the
+ * job function, without blocking the calling thread when it is itself a
+ * worker thread of the pool.
+ */
+void CPLJobQueue::WaitEvent()
+{
+    const int nFinishedJobsStart = m_nFinishedJobs;
+    m_poPool->WaitUntil([this, nFinishedJobsStart]()
+                        { return m_nPendingJobs == 0 ||
+                                 m_nFinishedJobs != nFinishedJobsStart; });
+}
@@ -32,6 +32,10 @@
 
 #include "cpl_multiproc.h"
 #include "cpl_list.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
 #include <vector>
 
 /**
@@ -43,11 +47,13 @@
 
 #ifndef DOXYGEN_SKIP
 class CPLWorkerThreadPool;
+class CPLJobQueue;
 
 typedef struct
 {
     CPLThreadFunc  pfnFunc;
     void          *pData;
+    CPLJobQueue   *poQueue;
 } CPLWorkerThreadJob;
 
 typedef struct
@@ -57,10 +63,14 @@ typedef struct
     CPLWorkerThreadPool *poTP;
     CPLJoinableThread   *hThread;
     int                  bMarkedAsWaiting;
-    // CPLWorkerThreadJob  *psNextJob;
 
     CPLMutex            *hMutex;
     CPLCond             *hCond;
+
+    // Jobs owned by this worker. The owner pops from the back, other
+    // workers steal from the front.
+    CPLMutex            *hDequeMutex;
+    std::deque<CPLWorkerThreadJob*> aoJobs;
 } CPLWorkerThread;
 
 typedef enum
@@ -74,20 +84,34 @@ typedef enum
 /** Pool of worker threads */
 class CPL_DLL CPLWorkerThreadPool
 {
+        friend class CPLJobQueue;
+
         std::vector<CPLWorkerThread> aWT;
         CPLCond* hCond;
         CPLMutex* hMutex;
         volatile CPLWorkerThreadState eState;
-        CPLList* psJobQueue;
         volatile int nPendingJobs;
+        volatile int nQueuedJobs;
+        volatile int nNextWorkerThread;
+        volatile int nCompletionWaiters;
+        volatile int nWorkerThreadsInWaitCompletion;
 
         CPLList* psWaitingWorkerThreadsList;
-        int nWaitingWorkerThreads;
+        volatile int nWaitingWorkerThreads;
 
         static void WorkerThreadFunction(void* user_data);
 
-        void DeclareJobFinished();
+        CPLWorkerThread* GetCurrentWorkerThread();
+        bool QueueJob(CPLWorkerThread* psWorkerThread,
+                      CPLWorkerThreadJob* psJob);
+        void WakeUpWaitingThreads(int nJobs);
+        void RunJob(CPLWorkerThreadJob* psJob);
+        void DeclareJobFinished(CPLJobQueue* poQueue);
+        CPLWorkerThreadJob* TryGetJob(CPLWorkerThread* psWorkerThread);
         CPLWorkerThreadJob* GetNextJob(CPLWorkerThread* psWorkerThread);
+        bool SubmitJob(CPLJobQueue* poQueue, CPLThreadFunc pfnFunc,
+                       void* pData);
+        void WaitUntil(const std::function<bool()>& oIsDone);
 
     public:
         CPLWorkerThreadPool();
@@ -100,8 +124,54 @@ class CPL_DLL CPLWorkerThreadPool
         bool SubmitJobs(CPLThreadFunc pfnFunc, const std::vector<void*>& apData);
         void WaitCompletion(int nMaxRemainingJobs = 0);
 
+        std::unique_ptr<CPLJobQueue> CreateJobQueue(int nMaxRunningJobs = 0);
+
         /** Return the number of threads setup */
         int GetThreadCount() const { return static_cast<int>(aWT.size()); }
 };
 
+/** Group of jobs submitted to a CPLWorkerThreadPool, that can be waited
+ * for independently of the other jobs of the pool.
+ *
+ * Instances are created with CPLWorkerThreadPool::CreateJobQueue().
+ * @since GDAL 2.4
+ */
+class CPL_DLL CPLJobQueue
+{
+        friend class CPLWorkerThreadPool;
+
+        CPLWorkerThreadPool* m_poPool;
+        volatile int m_nPendingJobs;
+        volatile int m_nFinishedJobs;
+
+        // Jobs waiting for a running job of the queue to finish, when the
+        // number of running jobs is limited.
+        const int m_nMaxRunningJobs;
+        int m_nRunningJobs;
+        CPLMutex* m_hMutex;
+        std::deque<std::pair<CPLThreadFunc, void*>> m_aoBacklog;
+
+        CPLJobQueue(CPLWorkerThreadPool* poPool, int nMaxRunningJobs);
+        void StartNextJob();
+
+        CPLJobQueue(const CPLJobQueue&) = delete;
+        CPLJobQueue& operator=(const CPLJobQueue&) = delete;
+
+    public:
+        ~CPLJobQueue();
+
+        /** Return the owning worker thread pool */
+        CPLWorkerThreadPool* GetPool() { return m_poPool; }
+
+        /** Return the maximum number of jobs of the queue that can run
+         * concurrently, or 0 if unlimited */
+        int GetMaxRunningJobs() const { return m_nMaxRunningJobs; }
+
+        bool SubmitJob(CPLThreadFunc pfnFunc, void* pData);
+        bool SubmitJobs(CPLThreadFunc pfnFunc,
+                        const std::vector<void*>& apData);
+        void WaitCompletion(int nMaxRemainingJobs = 0);
+        void WaitEvent();
+};
+
 #endif // CPL_WORKER_THREAD_POOL_H_INCLUDED_
@@ -217,7 +217,8 @@ typedef enum {
   /*! Min (selects minimum of all non-NODATA contributing pixels) */ GRA_Min=9,
   /*! Med (selects median of all non-NODATA contributing pixels) */ GRA_Med=10,
   /*! Q1 (selects first quartile of all non-NODATA contributing pixels) */ GRA_Q1=11,
-  /*! Q3 (selects third quartile of all non-NODATA contributing pixels) */ GRA_Q3=12
+  /*! Q3 (selects third quartile of all non-NODATA contributing pixels) */ GRA_Q3=12,
+  /*! Sum (computes the sum of all non-NODATA contributing pixels) */ GRA_Sum=13
 } GDALResampleAlg;
 
 %rename (AsyncStatusType) GDALAsyncStatusType;
@@ -3672,6 +3672,17 @@ SWIGINTERN PyObject *GRA_Q3_swigconstant(PyObject *SWIGUNUSEDPARM(self), PyObjec
 }
 
 
+SWIGINTERN PyObject *GRA_Sum_swigconstant(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *module;
+  PyObject *d;
+  if (!PyArg_ParseTuple(args,(char*)"O:swigconstant", &module)) return NULL;
+  d = PyModule_GetDict(module);
+  if (!d) return NULL;
+  SWIG_Python_SetConstant(d, "GRA_Sum",SWIG_From_int((int)(GRA_Sum)));
+  return SWIG_Py_Void();
+}
+
+
 SWIGINTERN PyObject *GPI_Gray_swigconstant(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *module;
   PyObject *d;
@@ -4740,6 +4751,7 @@ static PyMethodDef SwigMethods[] = {
 	 { (char *)"GRA_Med_swigconstant", GRA_Med_swigconstant, METH_VARARGS, NULL},
 	 { (char *)"GRA_Q1_swigconstant", GRA_Q1_swigconstant, METH_VARARGS, NULL},
 	 { (char *)"GRA_Q3_swigconstant", GRA_Q3_swigconstant, METH_VARARGS, NULL},
+	 { (char *)"GRA_Sum_swigconstant", GRA_Sum_swigconstant, METH_VARARGS, NULL},
 	 { (char *)"GPI_Gray_swigconstant", GPI_Gray_swigconstant, METH_VARARGS, NULL},
 	 { (char *)"GPI_RGB_swigconstant", GPI_RGB_swigconstant, METH_VARARGS, NULL},
 	 { (char *)"GPI_CMYK_swigconstant", GPI_CMYK_swigconstant, METH_VARARGS, NULL},
@@ -253,6 +253,9 @@ GRA_Q1 = _gdalconst.GRA_Q1
 _gdalconst.GRA_Q3_swigconstant(_gdalconst)
 GRA_Q3 = _gdalconst.GRA_Q3
 
+_gdalconst.GRA_Sum_swigconstant(_gdalconst)
+GRA_Sum = _gdalconst.GRA_Sum
+
 _gdalconst.GPI_Gray_swigconstant(_gdalconst)
 GPI_Gray = _gdalconst.GPI_Gray
 
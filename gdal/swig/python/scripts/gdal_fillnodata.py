@@ -100,6 +100,10 @@ while i < len(argv):
         i = i + 1
         max_distance = float(argv[i])
 
+    elif arg == '-o':
+        i = i + 1
+        options.append(argv[i])
+
     elif arg == '-nomask':
         mask = 'none'
 
@@ -43,7 +43,7 @@ gdal_proximity.py srcfile dstfile [-srcband n] [-dstband n]
                   [-ot Byte/Int16/Int32/Float32/etc]
                   [-values n,n,n] [-distunits PIXEL/GEO]
                   [-maxdist n] [-nodata n] [-use_input_nodata YES/NO]
-                  [-fixed-buf-val n] [-q] """)
+                  [-fixed-buf-val n] [-algorithm APPROXIMATE/EXACT] [-q] """)
     sys.exit(1)
 
 
@@ -156,6 +156,10 @@ while i < len(argv):
         i = i + 1
         options.append('FIXED_BUF_VAL=' + argv[i])
 
+    elif arg == '-algorithm':
+        i = i + 1
+        options.append('ALGORITHM=' + argv[i])
+
     elif arg == '-srcband':
         i = i + 1
         src_band_n = int(argv[i])